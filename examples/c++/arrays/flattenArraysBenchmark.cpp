@@ -0,0 +1,226 @@
+/**
+ * @file    flattenArraysBenchmark.cpp
+ * @brief   Times flattening a model with arrays of compartments, species
+ *          and reactions, 10000 entries long by default, and looking up
+ *          the entries through an ArraysView instead.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ------------------------------------------------------------------------ -->
+ */
+
+#include <iostream>
+#include <cstdlib>
+
+#include <sbml/SBMLTypes.h>
+#include <sbml/conversion/ConversionProperties.h>
+#include <sbml/packages/arrays/common/ArraysExtensionTypes.h>
+#include <sbml/packages/arrays/util/ArraysView.h>
+
+#include "../util.h"
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+/*
+ * Gives the element a single dimension of size n, with the given id.
+ */
+static void
+addDimension(SBase* element, const char* id = NULL)
+{
+  ArraysSBasePlugin* plugin = 
+    static_cast<ArraysSBasePlugin*>(element->getPlugin("arrays"));
+  Dimension* dim = plugin->createDimension();
+  dim->setArrayDimension(0);
+  dim->setSize("n");
+  if (id != NULL)
+  {
+    dim->setId(id);
+  }
+}
+
+
+/*
+ * Gives the element an index d0 into the given attribute.
+ */
+static void
+addIndex(SBase* element, const char* attribute)
+{
+  ArraysSBasePlugin* plugin = 
+    static_cast<ArraysSBasePlugin*>(element->getPlugin("arrays"));
+  Index* index = plugin->createIndex();
+  index->setArrayDimension(0);
+  index->setReferencedAttribute(attribute);
+  ASTNode* math = SBML_parseL3Formula("d0");
+  index->setMath(math);
+  delete math;
+}
+
+
+/*
+ * Returns the selector name[d0].
+ */
+static ASTNode*
+createSelector(const char* name)
+{
+  ASTNode* selector = new ASTNode(AST_LINEAR_ALGEBRA_SELECTOR);
+  ASTNode* array = new ASTNode(AST_NAME);
+  array->setName(name);
+  ASTNode* index = new ASTNode(AST_NAME);
+  index->setName("d0");
+  selector->addChild(array);
+  selector->addChild(index);
+  return selector;
+}
+
+
+/*
+ * Creates a model with n compartments Cell, n species A, B and C and n
+ * reactions turning A[d0] and B[d0] into C[d0].
+ */
+static SBMLDocument*
+createModel(int n)
+{
+  SBMLNamespaces sbmlns(3, 1, "arrays", 1);
+  SBMLDocument* document = new SBMLDocument(&sbmlns);
+  document->setPackageRequired("arrays", true);
+  Model* model = document->createModel();
+
+  Parameter* p = model->createParameter();
+  p->setId("n");
+  p->setConstant(true);
+  p->setValue(n);
+
+  p = model->createParameter();
+  p->setId("k");
+  p->setConstant(true);
+  p->setValue(0.1);
+
+  Compartment* c = model->createCompartment();
+  c->setId("Cell");
+  c->setConstant(true);
+  c->setSize(1);
+  c->setSpatialDimensions(3.0);
+  addDimension(c, "d0");
+
+  const char* names[] = { "A", "B", "C" };
+  for (int i = 0; i < 3; ++i)
+  {
+    Species* s = model->createSpecies();
+    s->setId(names[i]);
+    s->setCompartment("Cell");
+    s->setInitialAmount(0);
+    s->setHasOnlySubstanceUnits(true);
+    s->setBoundaryCondition(false);
+    s->setConstant(false);
+    addDimension(s, "d0");
+  }
+
+  Reaction* r = model->createReaction();
+  r->setId("r");
+  r->setReversible(false);
+  r->setFast(false);
+  r->setCompartment("Cell");
+  addDimension(r, "d0");
+  addIndex(r, "compartment");
+
+  for (int i = 0; i < 3; ++i)
+  {
+    SpeciesReference* sr = (i < 2) ? r->createReactant() : r->createProduct();
+    sr->setSpecies(names[i]);
+    sr->setStoichiometry(1);
+    sr->setConstant(true);
+    addIndex(sr, "species");
+  }
+
+  ASTNode* math = new ASTNode(AST_TIMES);
+  ASTNode* k = new ASTNode(AST_NAME);
+  k->setName("k");
+  math->addChild(k);
+  math->addChild(createSelector("A"));
+  math->addChild(createSelector("B"));
+  r->createKineticLaw()->setMath(math);
+  delete math;
+
+  return document;
+}
+
+
+int
+main (int argc, char* argv[])
+{
+  int n = (argc > 1) ? atoi(argv[1]) : 10000;
+  if (n < 1)
+  {
+    cout << endl << "Usage: flattenArraysBenchmark [entries]" << endl << endl;
+    return 1;
+  }
+
+#ifdef __BORLANDC__
+  unsigned long start, stop;
+#else
+  unsigned long long start, stop;
+#endif
+
+  SBMLDocument* document = createModel(n);
+
+  // resolve the kinetic law of each reaction without flattening
+  const KineticLaw* law = document->getModel()->getReaction(0)->getKineticLaw();
+  unsigned int resolved = 0;
+
+  start = getCurrentMillis();
+  ArraysView view(document->getModel());
+  for (int i = 0; i < n; ++i)
+  {
+    ArraysEntry entry = view.getEntry(law, (unsigned int)(i));
+    if (entry.getMath() != NULL)
+    {
+      ++resolved;
+    }
+  }
+  stop  = getCurrentMillis();
+
+  cout << endl;
+  cout << "              entries: " << n << endl;
+  cout << "    view lookups (ms): " << stop - start << endl;
+  cout << "kinetic laws resolved: " << resolved << endl;
+
+  ConversionProperties props;
+  props.addOption("flatten arrays");
+  props.addOption("performValidation", false);
+
+  start = getCurrentMillis();
+  int result = document->convert(props);
+  stop  = getCurrentMillis();
+
+  Model* model = document->getModel();
+  cout << "      flattening (ms): " << stop - start
+       << (result == LIBSBML_OPERATION_SUCCESS ? "" : " (failed)") << endl;
+  cout << "         compartments: " << model->getNumCompartments() << endl;
+  cout << "              species: " << model->getNumSpecies() << endl;
+  cout << "            reactions: " << model->getNumReactions() << endl;
+  if (model->getNumReactions() > 0)
+  {
+    Reaction* last = model->getReaction(model->getNumReactions() - 1);
+    char* formula = SBML_formulaToL3String(last->getKineticLaw()->getMath());
+    cout << "     last kinetic law: " << formula << endl;
+    safe_free(formula);
+  }
+  cout << endl;
+
+  delete document;
+  return 0;
+}
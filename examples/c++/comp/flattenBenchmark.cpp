@@ -0,0 +1,273 @@
+/**
+ * @file    flattenBenchmark.cpp
+ * @brief   Flattens synthetic deep and wide comp hierarchies
+ *          and reports the time taken.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This sample program is distributed under a different license than the rest
+ * of libSBML.  This program uses the open-source MIT license, as follows:
+ *
+ * Copyright (c) 2013-2018 by the California Institute of Technology
+ * (California, USA), the European Bioinformatics Institute (EMBL-EBI, UK)
+ * and the University of Heidelberg (Germany), with support from the National
+ * Institutes of Health (USA) under grant R01GM070923.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Neither the name of the California Institute of Technology (Caltech), nor
+ * of the European Bioinformatics Institute (EMBL-EBI), nor of the University
+ * of Heidelberg, nor the names of any contributors, may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * ------------------------------------------------------------------------ -->
+ */
+
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+
+#include <sbml/SBMLTypes.h>
+#include <sbml/conversion/ConversionProperties.h>
+#include <sbml/conversion/SBMLConverterRegistry.h>
+#include <sbml/packages/comp/common/CompExtensionTypes.h>
+
+#include "../util.h"
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+static string
+levelName(int level)
+{
+  ostringstream name;
+  name << "level" << level;
+  return name.str();
+}
+
+/*
+ * Adds a compartment, 'numSpecies' species (half of them with a port),
+ * the parameters 'k' and 'unused' and a reaction per species to the given
+ * model.
+ */
+static void
+addContent(Model* model, CompModelPlugin* plugin, int numSpecies)
+{
+  Compartment* c = model->createCompartment();
+  c->setId("C");
+  c->setConstant(true);
+  c->setSize(1);
+  Port* port = plugin->createPort();
+  port->setId("C_port");
+  port->setIdRef("C");
+
+  Parameter* k = model->createParameter();
+  k->setId("k");
+  k->setMetaId("k_meta");
+  k->setConstant(true);
+  k->setValue(0.1);
+
+  Parameter* unused = model->createParameter();
+  unused->setId("unused");
+  unused->setMetaId("unused_meta");
+  unused->setConstant(true);
+
+  for (int s = 0; s < numSpecies; ++s)
+  {
+    ostringstream id;
+    id << "S" << s;
+
+    Species* species = model->createSpecies();
+    species->setId(id.str());
+    species->setMetaId(id.str() + "_meta");
+    species->setCompartment("C");
+    species->setInitialConcentration(1);
+    species->setHasOnlySubstanceUnits(false);
+    species->setBoundaryCondition(false);
+    species->setConstant(false);
+
+    // Only every other species has a port:  the others are referenced 
+    // directly by their id.
+    if (s % 2 == 0)
+    {
+      port = plugin->createPort();
+      port->setId(id.str() + "_port");
+      port->setIdRef(id.str());
+    }
+
+    Reaction* reaction = model->createReaction();
+    reaction->setId("J" + id.str());
+    reaction->setReversible(false);
+    reaction->setFast(false);
+    SpeciesReference* reactant = reaction->createReactant();
+    reactant->setSpecies(id.str());
+    reactant->setStoichiometry(1);
+    reactant->setConstant(true);
+    KineticLaw* kl = reaction->createKineticLaw();
+    kl->setMath(SBML_parseL3Formula(("k * " + id.str()).c_str()));
+  }
+}
+
+/*
+ * Creates a document with the definitions level1 ... level'depth', where
+ * every level contains 'width' instances of the level below, replaces
+ * the shared elements of every instance by its own (through ports, ids and
+ * metaids) and deletes their unused parameter.  The main model instantiates the
+ * top level once.
+ */
+static SBMLDocument*
+createHierarchy(int depth, int width, int numSpecies)
+{
+  CompPkgNamespaces sbmlns(3, 1, 1);
+  SBMLDocument* document = new SBMLDocument(&sbmlns);
+  document->setPackageRequired("comp", true);
+  CompSBMLDocumentPlugin* docPlugin =
+    static_cast<CompSBMLDocumentPlugin*>(document->getPlugin("comp"));
+
+  ModelDefinition* leaf = docPlugin->createModelDefinition();
+  leaf->setId(levelName(0));
+  addContent(leaf, static_cast<CompModelPlugin*>(leaf->getPlugin("comp")),
+             numSpecies);
+
+  for (int level = 1; level <= depth; ++level)
+  {
+    ModelDefinition* definition = docPlugin->createModelDefinition();
+    definition->setId(levelName(level));
+    CompModelPlugin* plugin =
+      static_cast<CompModelPlugin*>(definition->getPlugin("comp"));
+    addContent(definition, plugin, numSpecies);
+
+    for (int w = 0; w < width; ++w)
+    {
+      ostringstream id;
+      id << "sub" << w;
+      Submodel* submodel = plugin->createSubmodel();
+      submodel->setId(id.str());
+      submodel->setModelRef(levelName(level - 1));
+
+      Deletion* deletion = submodel->createDeletion();
+      deletion->setMetaIdRef("unused_meta");
+
+      CompSBasePlugin* cplugin = static_cast<CompSBasePlugin*>
+        (definition->getCompartment("C")->getPlugin("comp"));
+      ReplacedElement* re = cplugin->createReplacedElement();
+      re->setSubmodelRef(id.str());
+      re->setPortRef("C_port");
+
+      CompSBasePlugin* kplugin = static_cast<CompSBasePlugin*>
+        (definition->getParameter("k")->getPlugin("comp"));
+      re = kplugin->createReplacedElement();
+      re->setSubmodelRef(id.str());
+      re->setMetaIdRef("k_meta");
+
+      for (int s = 0; s < numSpecies; ++s)
+      {
+        ostringstream sid;
+        sid << "S" << s;
+        CompSBasePlugin* splugin = static_cast<CompSBasePlugin*>
+          (definition->getSpecies(sid.str())->getPlugin("comp"));
+        re = splugin->createReplacedElement();
+        re->setSubmodelRef(id.str());
+        if (s % 2 == 0)
+        {
+          re->setPortRef(sid.str() + "_port");
+        }
+        else
+        {
+          re->setIdRef(sid.str());
+        }
+      }
+    }
+  }
+
+  Model* model = document->createModel();
+  model->setId("main");
+  CompModelPlugin* plugin =
+    static_cast<CompModelPlugin*>(model->getPlugin("comp"));
+  Submodel* top = plugin->createSubmodel();
+  top->setId("top");
+  top->setModelRef(levelName(depth));
+
+  return document;
+}
+
+static bool
+flatten(SBMLDocument* document)
+{
+  ConversionProperties props;
+  props.addOption("flatten comp");
+  props.addOption("performValidation", false);
+
+  SBMLConverter* converter =
+    SBMLConverterRegistry::getInstance().getConverterFor(props);
+  converter->setDocument(document);
+  int result = converter->convert();
+  delete converter;
+
+  return result == LIBSBML_OPERATION_SUCCESS;
+}
+
+int
+main (int argc, char* argv[])
+{
+  int depth      = (argc > 1) ? atoi(argv[1]) : 3;
+  int width      = (argc > 2) ? atoi(argv[2]) : 6;
+  int numSpecies = (argc > 3) ? atoi(argv[3]) : 40;
+  int repeats    = (argc > 4) ? atoi(argv[4]) : 3;
+  if (depth < 1 || width < 1 || numSpecies < 1 || repeats < 1)
+  {
+    cout << endl << "Usage: flattenBenchmark [depth [width [species [repeats]]]]"
+         << endl << endl;
+    return 1;
+  }
+
+#ifdef __BORLANDC__
+  unsigned long start, stop;
+#else
+  unsigned long long start, stop;
+#endif
+
+  cout << endl;
+  for (int run = 1; run <= repeats; ++run)
+  {
+    SBMLDocument* document = createHierarchy(depth, width, numSpecies);
+
+    start = getCurrentMillis();
+    bool flattened = flatten(document);
+    stop  = getCurrentMillis();
+
+    if (!flattened)
+    {
+      cerr << "Flattening failed:" << endl;
+      document->printErrors(cerr);
+      delete document;
+      return 1;
+    }
+
+    Model* flat = document->getModel();
+    cout << "   flattening " << run << " (ms): " << stop - start
+         << " (" << flat->getNumSpecies() << " species, "
+         << flat->getNumReactions() << " reactions)" << endl;
+
+    delete document;
+  }
+  cout << endl;
+
+  return 0;
+}
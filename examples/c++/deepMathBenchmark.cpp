@@ -0,0 +1,213 @@
+/**
+ * @file    deepMathBenchmark.cpp
+ * @brief   Times the traversal of sums, differences, quotients and
+ *          function calls nested a million levels deep by default.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This sample program is distributed under a different license than the rest
+ * of libSBML.  This program uses the open-source MIT license, as follows:
+ *
+ * Copyright (c) 2013-2018 by the California Institute of Technology
+ * (California, USA), the European Bioinformatics Institute (EMBL-EBI, UK)
+ * and the University of Heidelberg (Germany), with support from the National
+ * Institutes of Health (USA) under grant R01GM070923.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Neither the name of the California Institute of Technology (Caltech), nor
+ * of the European Bioinformatics Institute (EMBL-EBI), nor of the University
+ * of Heidelberg, nor the names of any contributors, may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * ------------------------------------------------------------------------ -->
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include <sbml/SBMLTypes.h>
+#include <sbml/math/ASTNodeVisitor.h>
+
+#include "util.h"
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+/*
+ * Counts the nodes of a tree.
+ */
+class NodeCounter : public ASTNodeVisitor
+{
+public:
+  NodeCounter() : mCount(0) { }
+
+  virtual bool visitPreOrder(const ASTNode*)
+  {
+    ++mCount;
+    return true;
+  }
+
+  unsigned long mCount;
+};
+
+/*
+ * Returns x + 1 + 1 ..., each operation a binary node whose left child is
+ * the previous one, as reduceToBinary() leaves a long sum; or the same
+ * chain of differences or quotients, or f(f(...f(x))) for a function f.
+ */
+static ASTNode*
+createChain(ASTNodeType_t type, unsigned int depth)
+{
+  ASTNode* chain = new ASTNode(AST_NAME);
+  chain->setName("x");
+  for (unsigned int i = 0; i < depth; ++i)
+  {
+    ASTNode* node = new ASTNode(type);
+    node->addChild(chain);
+    if (type == AST_FUNCTION)
+    {
+      node->setName("f");
+    }
+    else
+    {
+      ASTNode* one = new ASTNode(AST_INTEGER);
+      one->setValue(1);
+      node->addChild(one);
+    }
+    chain = node;
+  }
+  return chain;
+}
+
+/*
+ * Times each operation on a chain of the given type.  The model defines
+ * the function f called by the chain of function calls.
+ */
+static void
+runBenchmark(const char* name, ASTNodeType_t type, unsigned int depth,
+             const Model* model)
+{
+#ifdef __BORLANDC__
+  unsigned long start, stop;
+#else
+  unsigned long long start, stop;
+#endif
+
+  start = getCurrentMillis();
+  ASTNode* chain = createChain(type, depth);
+  stop  = getCurrentMillis();
+  cout << endl;
+  cout << "             chain: " << name << endl;
+  cout << "             depth: " << depth << endl;
+  cout << "        build (ms): " << stop - start << endl;
+
+  start = getCurrentMillis();
+  NodeCounter counter;
+  counter.traverse(chain);
+  stop  = getCurrentMillis();
+  cout << "     traverse (ms): " << stop - start 
+       << " (" << counter.mCount << " nodes)" << endl;
+
+  map<string, double> values;
+  values["x"] = 0;
+  start = getCurrentMillis();
+  double value = SBMLTransforms::evaluateASTNode(chain, values, model);
+  stop  = getCurrentMillis();
+  cout << "     evaluate (ms): " << stop - start 
+       << " (value " << value << ")" << endl;
+
+  start = getCurrentMillis();
+  List* names = chain->getListOfNodes((ASTNodePredicate) ASTNode_isName);
+  stop  = getCurrentMillis();
+  cout << "   list nodes (ms): " << stop - start 
+       << " (" << names->getSize() << " names)" << endl;
+  delete names;
+
+  start = getCurrentMillis();
+  ASTNode* copy = chain->deepCopy();
+  stop  = getCurrentMillis();
+  cout << "         copy (ms): " << stop - start << endl;
+
+  start = getCurrentMillis();
+  copy->renameSIdRefs("x", "y");
+  stop  = getCurrentMillis();
+  cout << "       rename (ms): " << stop - start << endl;
+
+  start = getCurrentMillis();
+  char* formula = SBML_formulaToString(chain);
+  stop  = getCurrentMillis();
+  cout << "   L1 formula (ms): " << stop - start 
+       << " (" << strlen(formula) << " characters)" << endl;
+  free(formula);
+
+  start = getCurrentMillis();
+  formula = SBML_formulaToL3String(chain);
+  stop  = getCurrentMillis();
+  cout << "   L3 formula (ms): " << stop - start 
+       << " (" << strlen(formula) << " characters)" << endl;
+  free(formula);
+
+  start = getCurrentMillis();
+  // unindented: the indentation alone is quadratic in the depth
+  ostringstream mathml;
+  XMLOutputStream stream(mathml, "UTF-8", false);
+  stream.setAutoIndent(false);
+  writeMathML(chain, stream);
+  stop  = getCurrentMillis();
+  cout << "       MathML (ms): " << stop - start 
+       << " (" << mathml.str().size() << " characters)" << endl;
+
+  start = getCurrentMillis();
+  delete copy;
+  delete chain;
+  stop  = getCurrentMillis();
+  cout << "       delete (ms): " << stop - start << endl;
+}
+
+int
+main (int argc, char* argv[])
+{
+  int depth = (argc > 1) ? atoi(argv[1]) : 1000000;
+  if (depth < 1)
+  {
+    cout << endl << "Usage: deepMathBenchmark [depth]" << endl << endl;
+    return 1;
+  }
+
+  SBMLDocument document(3, 2);
+  Model* model = document.createModel();
+  FunctionDefinition* f = model->createFunctionDefinition();
+  f->setId("f");
+  ASTNode* lambda = SBML_parseL3Formula("lambda(x, x + 1)");
+  f->setMath(lambda);
+  delete lambda;
+
+  runBenchmark("plus", AST_PLUS, depth, model);
+  runBenchmark("minus", AST_MINUS, depth, model);
+  runBenchmark("divide", AST_DIVIDE, depth, model);
+  runBenchmark("function", AST_FUNCTION, depth, model);
+  cout << endl;
+
+  return 0;
+}
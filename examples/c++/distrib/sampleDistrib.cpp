@@ -0,0 +1,96 @@
+/**
+ * @file    sampleDistrib.cpp
+ * @brief   Draws realizations of the distributions of a model with a
+ *          DistribSampler, and prints their means and the time taken.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ------------------------------------------------------------------------ -->
+ */
+
+#include <iostream>
+#include <cstdlib>
+
+#include <sbml/SBMLTypes.h>
+#include <sbml/packages/distrib/common/DistribExtensionTypes.h>
+#include <sbml/packages/distrib/util/DistribSampler.h>
+
+#include "../util.h"
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+int
+main (int argc, char* argv[])
+{
+  if (argc < 2 || argc > 4)
+  {
+    cout << endl << "Usage: sampleDistrib filename [realizations [seed]]"
+         << endl << endl;
+    return 1;
+  }
+
+  int n = (argc > 2) ? atoi(argv[2]) : 100000;
+  unsigned long seed = (argc > 3) ? strtoul(argv[3], NULL, 10) : 0;
+  if (n < 1)
+  {
+    cout << endl << "Usage: sampleDistrib filename [realizations [seed]]"
+         << endl << endl;
+    return 1;
+  }
+
+  SBMLDocument* document = readSBML(argv[1]);
+  if (document->getNumErrors(LIBSBML_SEV_ERROR) > 0
+    || document->getModel() == NULL)
+  {
+    document->printErrors(cerr);
+    delete document;
+    return 1;
+  }
+
+#ifdef __BORLANDC__
+  unsigned long start, stop;
+#else
+  unsigned long long start, stop;
+#endif
+
+  DistribSampler sampler(document->getModel(), seed);
+
+  start = getCurrentMillis();
+  sampler.sample((unsigned int)(n));
+  stop  = getCurrentMillis();
+
+  cout << endl;
+  cout << "   realizations: " << n << endl;
+  cout << "      variables: " << sampler.getNumVariables() << endl;
+  cout << "  sampling (ms): " << stop - start << endl;
+  cout << endl;
+
+  for (unsigned int v = 0; v < sampler.getNumVariables(); ++v)
+  {
+    double sum = 0;
+    for (unsigned int r = 0; r < sampler.getNumRealizations(); ++r)
+    {
+      sum += sampler.getSample(r, v);
+    }
+    cout << "  mean of " << sampler.getVariable(v) << ": "
+         << sum / sampler.getNumRealizations() << endl;
+  }
+  cout << endl;
+
+  delete document;
+  return 0;
+}
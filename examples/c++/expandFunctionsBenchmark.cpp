@@ -0,0 +1,189 @@
+/**
+ * @file    expandFunctionsBenchmark.cpp
+ * @brief   Times the expansion of function definitions that call each other
+ *          in a chain, 100 deep by default.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This sample program is distributed under a different license than the rest
+ * of libSBML.  This program uses the open-source MIT license, as follows:
+ *
+ * Copyright (c) 2013-2018 by the California Institute of Technology
+ * (California, USA), the European Bioinformatics Institute (EMBL-EBI, UK)
+ * and the University of Heidelberg (Germany), with support from the National
+ * Institutes of Health (USA) under grant R01GM070923.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Neither the name of the California Institute of Technology (Caltech), nor
+ * of the European Bioinformatics Institute (EMBL-EBI), nor of the University
+ * of Heidelberg, nor the names of any contributors, may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * ------------------------------------------------------------------------ -->
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sbml/SBMLTypes.h>
+
+#include "util.h"
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+/*
+ * Returns the given prefix followed by the given number.
+ */
+static string
+getId(const string& prefix, int n)
+{
+  ostringstream id;
+  id << prefix << n;
+  return id.str();
+}
+
+/*
+ * Creates a model with function definitions f0(x) = x + 1 and
+ * fk(x, y) = 2 * f(k-1)(x, y) - y for k up to the given depth, and the
+ * given number of assignment rules that each call the last of them.
+ */
+static SBMLDocument*
+createModel(int depth, int numRules)
+{
+  SBMLDocument* document = new SBMLDocument(3, 1);
+  Model* model = document->createModel();
+
+  for (int k = 0; k <= depth; ++k)
+  {
+    ostringstream formula;
+    if (k == 0)
+    {
+      formula << "lambda(x, y, x + 1)";
+    }
+    else
+    {
+      formula << "lambda(x, y, 2 * " << getId("f", k - 1) << "(x, y) - y)";
+    }
+    FunctionDefinition* fd = model->createFunctionDefinition();
+    fd->setId(getId("f", k));
+    ASTNode* math = SBML_parseL3Formula(formula.str().c_str());
+    fd->setMath(math);
+    delete math;
+  }
+
+  for (int i = 0; i < numRules; ++i)
+  {
+    Parameter* p = model->createParameter();
+    p->setId(getId("p", i));
+    p->setValue(i);
+    p->setConstant(true);
+    p->setUnits("dimensionless");
+
+    Parameter* q = model->createParameter();
+    q->setId(getId("q", i));
+    q->setConstant(false);
+    q->setUnits("dimensionless");
+
+    ostringstream formula;
+    formula << getId("f", depth) << "(" << getId("p", i) << ", 3)";
+    AssignmentRule* rule = model->createAssignmentRule();
+    rule->setVariable(q->getId());
+    ASTNode* math = SBML_parseL3Formula(formula.str().c_str());
+    rule->setMath(math);
+    delete math;
+  }
+
+  return document;
+}
+
+int
+main (int argc, char* argv[])
+{
+  int depth    = (argc > 1) ? atoi(argv[1]) : 100;
+  int numRules = (argc > 2) ? atoi(argv[2]) : 1000;
+  if (depth < 1 || numRules < 1)
+  {
+    cout << endl << "Usage: expandFunctionsBenchmark [depth] [rules]" 
+         << endl << endl;
+    return 1;
+  }
+
+#ifdef __BORLANDC__
+  unsigned long start, stop;
+#else
+  unsigned long long start, stop;
+#endif
+
+  SBMLDocument* document = createModel(depth, numRules);
+  Model* model = document->getModel();
+  cout << endl;
+  cout << "                         depth: " << depth << endl;
+  cout << "                         rules: " << numRules << endl;
+
+  const ListOfFunctionDefinitions* lofd = model->getListOfFunctionDefinitions();
+  vector<ASTNode*> maths;
+  for (int i = 0; i < numRules; ++i)
+  {
+    maths.push_back(model->getRule(i)->getMath()->deepCopy());
+  }
+
+  start = getCurrentMillis();
+  for (int i = 0; i < numRules; ++i)
+  {
+    SBMLTransforms::replaceFD(maths[i], lofd);
+  }
+  stop  = getCurrentMillis();
+  cout << "    replaceFD, one by one (ms): " << stop - start << endl;
+
+  double value = SBMLTransforms::evaluateASTNode(maths[numRules - 1], model);
+  for (int i = 0; i < numRules; ++i)
+  {
+    delete maths[i];
+    maths[i] = model->getRule(i)->getMath()->deepCopy();
+  }
+
+  start = getCurrentMillis();
+  SBMLTransforms::replaceFD(maths, lofd);
+  stop  = getCurrentMillis();
+  cout << "   replaceFD, all at once (ms): " << stop - start << endl;
+
+  if (SBMLTransforms::evaluateASTNode(maths[numRules - 1], model) != value)
+  {
+    cout << "The expanded rules differ." << endl;
+  }
+  for (int i = 0; i < numRules; ++i)
+  {
+    delete maths[i];
+  }
+
+  start = getCurrentMillis();
+  bool expanded = document->expandFunctionDefinitions();
+  stop  = getCurrentMillis();
+  cout << "expandFunctionDefinitions (ms): " << stop - start
+       << (expanded ? "" : " (failed)") << endl;
+  cout << endl;
+
+  delete document;
+  return 0;
+}
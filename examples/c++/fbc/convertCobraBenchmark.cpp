@@ -0,0 +1,217 @@
+/**
+ * @file    convertCobraBenchmark.cpp
+ * @brief   Converts a synthetic genome-scale COBRA model to fbc and reports
+ *          the time taken.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This sample program is distributed under a different license than the rest
+ * of libSBML.  This program uses the open-source MIT license, as follows:
+ *
+ * Copyright (c) 2013-2018 by the California Institute of Technology
+ * (California, USA), the European Bioinformatics Institute (EMBL-EBI, UK)
+ * and the University of Heidelberg (Germany), with support from the National
+ * Institutes of Health (USA) under grant R01GM070923.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Neither the name of the California Institute of Technology (Caltech), nor
+ * of the European Bioinformatics Institute (EMBL-EBI), nor of the University
+ * of Heidelberg, nor the names of any contributors, may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * ------------------------------------------------------------------------ -->
+ */
+
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+
+#include <sbml/SBMLTypes.h>
+#include <sbml/conversion/ConversionProperties.h>
+
+#include "../util.h"
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+/*
+ * Returns a random association in disjunctive form, with up to 'maxComplexes'
+ * alternative complexes of up to 'maxSubunits' genes each.
+ */
+static string
+randomAssociation(int numGenes, int maxComplexes, int maxSubunits)
+{
+  ostringstream association;
+  int complexes = 1 + rand() % maxComplexes;
+  for (int c = 0; c < complexes; ++c)
+  {
+    if (c > 0)
+    {
+      association << " or ";
+    }
+    int subunits = 1 + rand() % maxSubunits;
+    if (subunits > 1)
+    {
+      association << "(";
+    }
+    for (int s = 0; s < subunits; ++s)
+    {
+      if (s > 0)
+      {
+        association << " and ";
+      }
+      association << "b" << rand() % numGenes;
+    }
+    if (subunits > 1)
+    {
+      association << ")";
+    }
+  }
+  return association.str();
+}
+
+/*
+ * Creates a Level 2 model in the style of the COBRA toolbox:  the formula
+ * and charge of the species and the gene association of the reactions are
+ * in their notes, the bounds and objective coefficients in local parameters.
+ */
+static SBMLDocument*
+createCobraModel(int numSpecies, int numReactions, int numGenes)
+{
+  SBMLDocument* document = new SBMLDocument(2, 4);
+  Model* model = document->createModel();
+  model->setId("cobra");
+
+  Compartment* c = model->createCompartment();
+  c->setId("c");
+  c->setSize(1);
+
+  for (int s = 0; s < numSpecies; ++s)
+  {
+    ostringstream id, notes;
+    id << "M_" << s << "_c";
+    notes << "<body xmlns=\"http://www.w3.org/1999/xhtml\">"
+          << "<p>FORMULA: C" << 1 + s % 20 << "H" << 2 + s % 30 << "O" 
+          << 1 + s % 7 << "</p>"
+          << "<p>CHARGE: " << (s % 5) - 2 << "</p>"
+          << "<p>KEGG: C" << 10000 + s << "</p>"
+          << "</body>";
+
+    Species* species = model->createSpecies();
+    species->setId(id.str());
+    species->setCompartment("c");
+    species->setInitialAmount(0);
+    species->setNotes(notes.str(), true);
+  }
+
+  for (int r = 0; r < numReactions; ++r)
+  {
+    ostringstream id, notes;
+    id << "R_" << r;
+    notes << "<body xmlns=\"http://www.w3.org/1999/xhtml\">"
+          << "<p>GENE_ASSOCIATION: " << randomAssociation(numGenes, 3, 4) 
+          << "</p>"
+          << "<p>SUBSYSTEM: subsystem " << r % 50 << "</p>"
+          << "<p>EC Number: 1.1.1." << r % 300 << "</p>"
+          << "</body>";
+
+    Reaction* reaction = model->createReaction();
+    reaction->setId(id.str());
+    reaction->setReversible(r % 3 == 0);
+    reaction->setNotes(notes.str(), true);
+
+    for (int i = 0; i < 3; ++i)
+    {
+      ostringstream species;
+      species << "M_" << rand() % numSpecies << "_c";
+      SpeciesReference* ref = (i < 2) ? reaction->createReactant()
+                                      : reaction->createProduct();
+      ref->setSpecies(species.str());
+      ref->setStoichiometry(1 + i);
+    }
+
+    KineticLaw* kineticLaw = reaction->createKineticLaw();
+    kineticLaw->setMath(SBML_parseFormula("FLUX_VALUE"));
+    Parameter* parameter = kineticLaw->createParameter();
+    parameter->setId("LOWER_BOUND");
+    parameter->setValue(r % 3 == 0 ? -1000 : 0);
+    parameter = kineticLaw->createParameter();
+    parameter->setId("UPPER_BOUND");
+    parameter->setValue(1000);
+    parameter = kineticLaw->createParameter();
+    parameter->setId("OBJECTIVE_COEFFICIENT");
+    parameter->setValue(r == 0 ? 1 : 0);
+    parameter = kineticLaw->createParameter();
+    parameter->setId("FLUX_VALUE");
+    parameter->setValue(0);
+  }
+
+  return document;
+}
+
+int
+main (int argc, char* argv[])
+{
+  int numReactions = (argc > 1) ? atoi(argv[1]) : 10000;
+  int numSpecies   = (argc > 2) ? atoi(argv[2]) : 5000;
+  int numGenes     = (argc > 3) ? atoi(argv[3]) : 2000;
+  if (numReactions < 1 || numSpecies < 1 || numGenes < 1)
+  {
+    cout << endl 
+         << "Usage: convertCobraBenchmark [reactions [species [genes]]]"
+         << endl << endl;
+    return 1;
+  }
+
+#ifdef __BORLANDC__
+  unsigned long start, stop;
+#else
+  unsigned long long start, stop;
+#endif
+
+  srand(42);
+  SBMLDocument* document = createCobraModel(numSpecies, numReactions, 
+                                            numGenes);
+
+  ConversionProperties props;
+  props.addOption("convert cobra", true, "Convert Cobra model to FBC");
+  props.addOption("checkCompatibility", false);
+
+  start = getCurrentMillis();
+  int result = document->convert(props);
+  stop  = getCurrentMillis();
+
+  if (result != LIBSBML_OPERATION_SUCCESS)
+  {
+    cerr << "Conversion failed:" << endl;
+    document->printErrors(cerr);
+    delete document;
+    return 1;
+  }
+
+  cout << endl;
+  cout << "           species: " << numSpecies << endl;
+  cout << "         reactions: " << numReactions << endl;
+  cout << "   conversion (ms): " << stop - start << endl;
+  cout << endl;
+
+  delete document;
+  return 0;
+}
@@ -0,0 +1,181 @@
+/**
+ * @file    parseGeneAssociations.cpp
+ * @brief   Parses and writes back synthetic genome-scale gene associations
+ *          and reports the time taken.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This sample program is distributed under a different license than the rest
+ * of libSBML.  This program uses the open-source MIT license, as follows:
+ *
+ * Copyright (c) 2013-2018 by the California Institute of Technology
+ * (California, USA), the European Bioinformatics Institute (EMBL-EBI, UK)
+ * and the University of Heidelberg (Germany), with support from the National
+ * Institutes of Health (USA) under grant R01GM070923.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Neither the name of the California Institute of Technology (Caltech), nor
+ * of the European Bioinformatics Institute (EMBL-EBI), nor of the University
+ * of Heidelberg, nor the names of any contributors, may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * ------------------------------------------------------------------------ -->
+ */
+
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <vector>
+
+#include <sbml/SBMLTypes.h>
+#include <sbml/packages/fbc/common/FbcExtensionTypes.h>
+
+#include "../util.h"
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+/*
+ * Returns a label in the style of Recon (e.g. '10026.1') or of the E. coli
+ * models (e.g. 'b0241'), depending on the gene number.
+ */
+static string
+geneLabel(int gene)
+{
+  ostringstream label;
+  if (gene % 2 == 0)
+  {
+    label << 1000 + gene << ".1";
+  }
+  else
+  {
+    label << "b" << gene;
+  }
+  return label.str();
+}
+
+/*
+ * Returns a random association in disjunctive form, with up to 'maxComplexes'
+ * alternative complexes of up to 'maxSubunits' genes each.
+ */
+static string
+randomAssociation(int numGenes, int maxComplexes, int maxSubunits)
+{
+  ostringstream association;
+  int complexes = 1 + rand() % maxComplexes;
+  for (int c = 0; c < complexes; ++c)
+  {
+    if (c > 0)
+    {
+      association << " or ";
+    }
+    int subunits = 1 + rand() % maxSubunits;
+    if (subunits > 1)
+    {
+      association << "(";
+    }
+    for (int s = 0; s < subunits; ++s)
+    {
+      if (s > 0)
+      {
+        association << " and ";
+      }
+      association << geneLabel(rand() % numGenes);
+    }
+    if (subunits > 1)
+    {
+      association << ")";
+    }
+  }
+  return association.str();
+}
+
+int
+main (int argc, char* argv[])
+{
+  int numReactions = (argc > 1) ? atoi(argv[1]) : 10000;
+  int numGenes     = (argc > 2) ? atoi(argv[2]) : 2000;
+  if (numReactions < 1 || numGenes < 1)
+  {
+    cout << endl << "Usage: parseGeneAssociations [reactions [genes]]"
+         << endl << endl;
+    return 1;
+  }
+
+#ifdef __BORLANDC__
+  unsigned long start, stop;
+#else
+  unsigned long long start, stop;
+#endif
+
+  srand(42);
+  vector<string> associations;
+  size_t length = 0;
+  for (int r = 0; r < numReactions; ++r)
+  {
+    associations.push_back(randomAssociation(numGenes, 4, 5));
+    length += associations.back().size();
+  }
+
+  FbcPkgNamespaces sbmlns(3, 1, 2);
+  SBMLDocument document(&sbmlns);
+  Model* model = document.createModel();
+  FbcModelPlugin* plugin =
+    static_cast<FbcModelPlugin*>(model->getPlugin("fbc"));
+
+  vector<GeneProductAssociation*> gpas;
+  for (int r = 0; r < numReactions; ++r)
+  {
+    ostringstream id;
+    id << "R" << r;
+    Reaction* reaction = model->createReaction();
+    reaction->setId(id.str());
+    reaction->setReversible(false);
+    FbcReactionPlugin* rplugin =
+      static_cast<FbcReactionPlugin*>(reaction->getPlugin("fbc"));
+    gpas.push_back(rplugin->createGeneProductAssociation());
+  }
+
+  start = getCurrentMillis();
+  for (int r = 0; r < numReactions; ++r)
+  {
+    gpas[r]->setAssociation(associations[r], false, true);
+  }
+  stop  = getCurrentMillis();
+
+  cout << endl;
+  cout << "        associations: " << numReactions
+       << " (" << length << " characters)" << endl;
+  cout << "       gene products: " << plugin->getNumGeneProducts() << endl;
+  cout << "     parse time (ms): " << stop - start << endl;
+
+  size_t written = 0;
+  start = getCurrentMillis();
+  for (int r = 0; r < numReactions; ++r)
+  {
+    written += gpas[r]->getAssociation()->toInfix().size();
+  }
+  stop  = getCurrentMillis();
+  cout << "     write time (ms): " << stop - start
+       << " (" << written << " characters)" << endl;
+  cout << endl;
+
+  return 0;
+}
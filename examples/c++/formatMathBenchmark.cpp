@@ -0,0 +1,139 @@
+/**
+ * @file    formatMathBenchmark.cpp
+ * @brief   Times writing the kinetic laws of a model with many reactions,
+ *          100000 by default, as SBML Level 3 formulas.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This sample program is distributed under a different license than the rest
+ * of libSBML.  This program uses the open-source MIT license, as follows:
+ *
+ * Copyright (c) 2013-2018 by the California Institute of Technology
+ * (California, USA), the European Bioinformatics Institute (EMBL-EBI, UK)
+ * and the University of Heidelberg (Germany), with support from the National
+ * Institutes of Health (USA) under grant R01GM070923.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Neither the name of the California Institute of Technology (Caltech), nor
+ * of the European Bioinformatics Institute (EMBL-EBI), nor of the University
+ * of Heidelberg, nor the names of any contributors, may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * ------------------------------------------------------------------------ -->
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#include <sbml/SBMLTypes.h>
+#include <sbml/math/L3FormulaWriter.h>
+
+#include "util.h"
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+/*
+ * Adds a reaction with a reversible Michaelis-Menten rate law.
+ */
+static void
+addReaction(Model* model, int i)
+{
+  ostringstream formula;
+  formula << "cell * (Vf_" << i << " * S_" << i << " / Km_" << i
+          << " - Vr_" << i << " * P_" << i << " / Kp_" << i << ")"
+          << " / (1 + S_" << i << " / Km_" << i << " + P_" << i
+          << " / Kp_" << i << ") * 0.5^(-h_" << i << ") + 1.25e-3";
+
+  Reaction* reaction = model->createReaction();
+  ostringstream id;
+  id << "r" << i;
+  reaction->setId(id.str());
+  KineticLaw* law = reaction->createKineticLaw();
+  ASTNode* math = SBML_parseL3Formula(formula.str().c_str());
+  law->setMath(math);
+  delete math;
+}
+
+int
+main (int argc, char* argv[])
+{
+  int numReactions = (argc > 1) ? atoi(argv[1]) : 100000;
+  if (numReactions < 1)
+  {
+    cout << endl << "Usage: formatMathBenchmark [reactions]" << endl << endl;
+    return 1;
+  }
+
+#ifdef __BORLANDC__
+  unsigned long start, stop;
+#else
+  unsigned long long start, stop;
+#endif
+
+  SBMLDocument document(3, 2);
+  Model* model = document.createModel();
+  start = getCurrentMillis();
+  for (int i = 0; i < numReactions; ++i)
+  {
+    addReaction(model, i);
+  }
+  stop  = getCurrentMillis();
+  cout << endl;
+  cout << "                 reactions: " << numReactions << endl;
+  cout << "                build (ms): " << stop - start << endl;
+
+  size_t length = 0;
+  start = getCurrentMillis();
+  for (int i = 0; i < numReactions; ++i)
+  {
+    char* formula = SBML_formulaToL3String(
+      model->getReaction(i)->getKineticLaw()->getMath());
+    length += strlen(formula);
+    free(formula);
+  }
+  stop  = getCurrentMillis();
+  cout << "    formulaToL3String (ms): " << stop - start
+       << " (" << length << " characters)" << endl;
+
+  L3FormulaWriter writer;
+  length = 0;
+  start = getCurrentMillis();
+  for (int i = 0; i < numReactions; ++i)
+  {
+    length += strlen(writer.format(
+      model->getReaction(i)->getKineticLaw()->getMath()));
+  }
+  stop  = getCurrentMillis();
+  cout << "        writer format (ms): " << stop - start
+       << " (" << length << " characters)" << endl;
+
+  start = getCurrentMillis();
+  writer.formatAllMath(model);
+  stop  = getCurrentMillis();
+  cout << " writer formatAllMath (ms): " << stop - start
+       << " (" << writer.getNumFormulas() << " formulas)" << endl;
+  cout << endl;
+
+  return 0;
+}
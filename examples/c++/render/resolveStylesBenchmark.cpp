@@ -0,0 +1,198 @@
+/**
+ * @file    resolveStylesBenchmark.cpp
+ * @brief   Times finding the style of each glyph of a layout, 100000
+ *          glyphs and 1000 styles by default, by searching all styles
+ *          for each glyph and with a StyleResolver.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ------------------------------------------------------------------------ -->
+ */
+
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+
+#include <sbml/SBMLTypes.h>
+#include <sbml/packages/layout/common/LayoutExtensionTypes.h>
+#include <sbml/packages/render/common/RenderExtensionTypes.h>
+#include <sbml/packages/render/util/StyleResolver.h>
+
+#include "../util.h"
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+static string
+makeId(const char* prefix, int n)
+{
+  ostringstream id;
+  id << prefix << n;
+  return id.str();
+}
+
+
+/*
+ * Creates a layout with the given number of species glyphs, each with a
+ * role, and local render information with one style for every tenth
+ * role, the rest styled by a single style for their type.
+ */
+static SBMLDocument*
+createModel(int numGlyphs, int numStyles)
+{
+  SBMLNamespaces sbmlns(3, 1, "layout", 1);
+  sbmlns.addPackageNamespace("render", 1);
+  SBMLDocument* document = new SBMLDocument(&sbmlns);
+  Model* model = document->createModel();
+
+  LayoutModelPlugin* plugin =
+    static_cast<LayoutModelPlugin*>(model->getPlugin("layout"));
+  Layout* layout = plugin->createLayout();
+  layout->setId("layout");
+
+  for (int i = 0; i < numGlyphs; ++i)
+  {
+    SpeciesGlyph* glyph = layout->createSpeciesGlyph();
+    glyph->setId(makeId("sg", i));
+    static_cast<RenderGraphicalObjectPlugin*>(glyph->getPlugin("render"))
+      ->setObjectRole(makeId("role", i % (numStyles * 10)));
+  }
+
+  LocalRenderInformation* info =
+    static_cast<RenderLayoutPlugin*>(layout->getPlugin("render"))
+      ->createLocalRenderInformation();
+  info->setId("local");
+
+  ColorDefinition* color = info->createColorDefinition();
+  color->setId("black");
+  color->setValue("#000000");
+
+  for (int i = 0; i < numStyles; ++i)
+  {
+    LocalStyle* style = info->createLocalStyle();
+    style->setId(makeId("style", i));
+    style->addRole(makeId("role", i * 10));
+    style->getGroup()->setStroke("black");
+  }
+
+  LocalStyle* style = info->createLocalStyle();
+  style->setId("species");
+  style->addType("SPECIESGLYPH");
+
+  return document;
+}
+
+
+/*
+ * Finds the style of a glyph by searching all styles, by id, then role,
+ * then type.
+ */
+static const Style*
+findStyle(const LocalRenderInformation* info, const GraphicalObject* glyph)
+{
+  for (unsigned int i = 0; i < info->getNumStyles(); ++i)
+  {
+    if (info->getStyle(i)->isInIdList(glyph->getId()))
+    {
+      return info->getStyle(i);
+    }
+  }
+
+  string role = StyleResolver::getRole(glyph);
+  for (unsigned int i = 0; i < info->getNumStyles(); ++i)
+  {
+    if (info->getStyle(i)->isInRoleList(role))
+    {
+      return info->getStyle(i);
+    }
+  }
+
+  string type = StyleResolver::getType(glyph);
+  for (unsigned int i = 0; i < info->getNumStyles(); ++i)
+  {
+    if (info->getStyle(i)->isInTypeList(type)
+      || info->getStyle(i)->isInTypeList("ANY"))
+    {
+      return info->getStyle(i);
+    }
+  }
+  return NULL;
+}
+
+
+int
+main (int argc, char* argv[])
+{
+  int numGlyphs = (argc > 1) ? atoi(argv[1]) : 100000;
+  int numStyles = (argc > 2) ? atoi(argv[2]) : 1000;
+  if (numGlyphs < 1 || numStyles < 1)
+  {
+    cout << endl << "Usage: resolveStylesBenchmark [glyphs [styles]]"
+         << endl << endl;
+    return 1;
+  }
+
+#ifdef __BORLANDC__
+  unsigned long start, stop;
+#else
+  unsigned long long start, stop;
+#endif
+
+  SBMLDocument* document = createModel(numGlyphs, numStyles);
+  LayoutModelPlugin* plugin = static_cast<LayoutModelPlugin*>(
+    document->getModel()->getPlugin("layout"));
+  const Layout* layout = plugin->getLayout(0);
+  const LocalRenderInformation* info =
+    static_cast<const RenderLayoutPlugin*>(layout->getPlugin("render"))
+      ->getRenderInformation(0);
+
+  start = getCurrentMillis();
+  unsigned int found = 0;
+  for (unsigned int i = 0; i < layout->getNumSpeciesGlyphs(); ++i)
+  {
+    if (findStyle(info, layout->getSpeciesGlyph(i)) != NULL)
+    {
+      ++found;
+    }
+  }
+  stop  = getCurrentMillis();
+
+  cout << endl;
+  cout << "             glyphs: " << numGlyphs << endl;
+  cout << "             styles: " << numStyles + 1 << endl;
+  cout << "    search all (ms): " << stop - start
+       << " (" << found << " styled)" << endl;
+
+  start = getCurrentMillis();
+  StyleResolver resolver(info);
+  vector<ResolvedStyle> styles = resolver.resolveAll(layout);
+  stop  = getCurrentMillis();
+
+  found = 0;
+  for (size_t i = 0; i < styles.size(); ++i)
+  {
+    if (styles[i].isValid())
+    {
+      ++found;
+    }
+  }
+  cout << "      resolver (ms): " << stop - start
+       << " (" << found << " styled)" << endl;
+  cout << endl;
+
+  delete document;
+  return 0;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file    classifyCSGeometry.cpp
+ * @brief   Compiles a synthetic CSGeometry and classifies a grid of
+ *          points against its domains.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This sample program is distributed under a different license than the rest
+ * of libSBML.  This program uses the open-source MIT license, as follows:
+ *
+ * Copyright (c) 2013-2018 by the California Institute of Technology
+ * (California, USA), the European Bioinformatics Institute (EMBL-EBI, UK)
+ * and the University of Heidelberg (Germany), with support from the National
+ * Institutes of Health (USA) under grant R01GM070923.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Neither the name of the California Institute of Technology (Caltech), nor
+ * of the European Bioinformatics Institute (EMBL-EBI), nor of the University
+ * of Heidelberg, nor the names of any contributors, may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * ------------------------------------------------------------------------ -->
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+
+#include <sbml/SBMLTypes.h>
+#include <sbml/packages/spatial/common/SpatialExtensionTypes.h>
+#include <sbml/packages/spatial/common/CompiledCSGeometry.h>
+
+#include "../util.h"
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+/*
+ * Fills the given CSGeometry with a box-shaped extracellular space, an
+ * ellipsoidal cell and a row of spherical vesicles cut out of a nucleus.
+ */
+static void
+createGeometry(CSGeometry* geometry, int numVesicles)
+{
+  CSGObject* object = geometry->createCSGObject();
+  object->setId("extracellular");
+  object->setDomainType("extracellular");
+  object->setOrdinal(0);
+  CSGScale* scale = object->createCSGScale();
+  scale->setScaleX(10);
+  scale->setScaleY(10);
+  scale->setScaleZ(10);
+  scale->createCSGPrimitive()->setPrimitiveType("cube");
+
+  object = geometry->createCSGObject();
+  object->setId("cytosol");
+  object->setDomainType("cytosol");
+  object->setOrdinal(1);
+  CSGRotation* rotation = object->createCSGRotation();
+  rotation->setRotateX(0);
+  rotation->setRotateY(1);
+  rotation->setRotateZ(1);
+  rotation->setRotateAngleInRadians(0.5);
+  scale = rotation->createCSGScale();
+  scale->setScaleX(8);
+  scale->setScaleY(5);
+  scale->setScaleZ(4);
+  scale->createCSGPrimitive()->setPrimitiveType("sphere");
+
+  object = geometry->createCSGObject();
+  object->setId("nucleus");
+  object->setDomainType("nucleus");
+  object->setOrdinal(2);
+  CSGSetOperator* difference = object->createCSGSetOperator();
+  difference->setOperationType("difference");
+  scale = difference->createCSGScale();
+  scale->setId("nucleusBody");
+  scale->setScaleX(3);
+  scale->setScaleY(3);
+  scale->setScaleZ(2);
+  scale->createCSGPrimitive()->setPrimitiveType("sphere");
+  CSGSetOperator* vesicles = difference->createCSGSetOperator();
+  vesicles->setId("vesicles");
+  vesicles->setOperationType("union");
+  difference->setComplementA("nucleusBody");
+  difference->setComplementB("vesicles");
+
+  for (int i = 0; i < numVesicles; ++i)
+  {
+    CSGTranslation* translation = vesicles->createCSGTranslation();
+    translation->setTranslateX(-3 + 6.0 * i / numVesicles);
+    translation->setTranslateY(0.5);
+    translation->setTranslateZ(0);
+    scale = translation->createCSGScale();
+    scale->setScaleX(0.3);
+    scale->setScaleY(0.3);
+    scale->setScaleZ(0.3);
+    scale->createCSGPrimitive()->setPrimitiveType("sphere");
+  }
+}
+
+int
+main (int argc, char* argv[])
+{
+  int resolution = (argc > 1) ? atoi(argv[1]) : 100;
+  int numVesicles = (argc > 2) ? atoi(argv[2]) : 20;
+  if (resolution < 2 || numVesicles < 1)
+  {
+    cout << endl << "Usage: classifyCSGeometry [resolution [vesicles]]"
+         << endl << endl;
+    return 1;
+  }
+
+#ifdef __BORLANDC__
+  unsigned long start, stop;
+#else
+  unsigned long long start, stop;
+#endif
+
+  SpatialPkgNamespaces sbmlns(3, 1, 1);
+  CSGeometry geometry(&sbmlns);
+  createGeometry(&geometry, numVesicles);
+
+  CompiledCSGeometry compiled;
+  start = getCurrentMillis();
+  compiled.compile(&geometry);
+  stop  = getCurrentMillis();
+
+  size_t numPoints = (size_t)resolution * resolution * resolution;
+  vector<double> coords;
+  coords.reserve(3 * numPoints);
+  for (int i = 0; i < resolution; ++i)
+  {
+    for (int j = 0; j < resolution; ++j)
+    {
+      for (int k = 0; k < resolution; ++k)
+      {
+        coords.push_back(-10 + 20.0 * i / (resolution - 1));
+        coords.push_back(-10 + 20.0 * j / (resolution - 1));
+        coords.push_back(-10 + 20.0 * k / (resolution - 1));
+      }
+    }
+  }
+
+  cout << endl;
+  cout << "              points: " << numPoints << endl;
+  cout << "   compile time (ms): " << stop - start << endl;
+
+  vector<int> classes(numPoints);
+  start = getCurrentMillis();
+  compiled.classifyAll(&coords[0], numPoints, &classes[0]);
+  stop  = getCurrentMillis();
+  cout << "  classify time (ms): " << stop - start << endl;
+
+  vector<size_t> counts(compiled.getNumObjects() + 1, 0);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    ++counts[classes[i] + 1];
+  }
+  for (unsigned int n = 0; n < compiled.getNumObjects(); ++n)
+  {
+    cout << "  " << compiled.getDomainType(n) << ": " << counts[n + 1]
+         << " points (" << compiled.getProgramLength(n)
+         << " instructions)" << endl;
+  }
+  cout << endl;
+
+  return 0;
+}
@@ -0,0 +1,210 @@
+/**
+ * @file    indexParametricGeometry.cpp
+ * @brief   Builds a ParametricGeometryIndex over a synthetic sphere mesh
+ *          and times ray, closest-point and point-in-volume queries.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This sample program is distributed under a different license than the rest
+ * of libSBML.  This program uses the open-source MIT license, as follows:
+ *
+ * Copyright (c) 2013-2018 by the California Institute of Technology
+ * (California, USA), the European Bioinformatics Institute (EMBL-EBI, UK)
+ * and the University of Heidelberg (Germany), with support from the National
+ * Institutes of Health (USA) under grant R01GM070923.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ * Neither the name of the California Institute of Technology (Caltech), nor
+ * of the European Bioinformatics Institute (EMBL-EBI), nor of the University
+ * of Heidelberg, nor the names of any contributors, may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * ------------------------------------------------------------------------ -->
+ */
+
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include <sbml/SBMLTypes.h>
+#include <sbml/packages/spatial/common/SpatialExtensionTypes.h>
+#include <sbml/packages/spatial/common/ParametricGeometryIndex.h>
+
+#include "../util.h"
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+/*
+ * Fills the given ParametricGeometry with a latitude/longitude sphere of
+ * unit radius using 2 * rings * (rings - 1) triangles.
+ */
+static void
+createSphere(ParametricGeometry* geometry, int rings)
+{
+  const double pi = 3.14159265358979323846;
+  int segments = 2 * rings;
+
+  vector<double> coords;
+  coords.push_back(0); coords.push_back(0); coords.push_back(1);
+  for (int r = 1; r < rings; ++r)
+  {
+    double theta = pi * r / rings;
+    for (int s = 0; s < segments; ++s)
+    {
+      double phi = 2 * pi * s / segments;
+      coords.push_back(sin(theta) * cos(phi));
+      coords.push_back(sin(theta) * sin(phi));
+      coords.push_back(cos(theta));
+    }
+  }
+  coords.push_back(0); coords.push_back(0); coords.push_back(-1);
+  int south = (int)coords.size() / 3 - 1;
+
+  vector<int> indices;
+  for (int s = 0; s < segments; ++s)
+  {
+    int next = (s + 1) % segments;
+    indices.push_back(0);
+    indices.push_back(1 + s);
+    indices.push_back(1 + next);
+
+    for (int r = 1; r + 1 < rings; ++r)
+    {
+      int a = 1 + (r - 1) * segments + s;
+      int b = 1 + (r - 1) * segments + next;
+      int c = 1 + r * segments + s;
+      int d = 1 + r * segments + next;
+      indices.push_back(a); indices.push_back(c); indices.push_back(b);
+      indices.push_back(b); indices.push_back(c); indices.push_back(d);
+    }
+
+    indices.push_back(south);
+    indices.push_back(1 + (rings - 2) * segments + next);
+    indices.push_back(1 + (rings - 2) * segments + s);
+  }
+
+  SpatialPoints* points = geometry->createSpatialPoints();
+  points->setId("points");
+  points->setCompression("uncompressed");
+  points->setArrayData(coords);
+
+  ParametricObject* sphere = geometry->createParametricObject();
+  sphere->setId("sphere");
+  sphere->setPolygonType("triangle");
+  sphere->setDomainType("cell");
+  sphere->setCompression("uncompressed");
+  sphere->setPointIndex(indices);
+}
+
+static double
+randomCoordinate()
+{
+  return 3.0 * rand() / RAND_MAX - 1.5;
+}
+
+int
+main (int argc, char* argv[])
+{
+  int rings = (argc > 1) ? atoi(argv[1]) : 500;
+  int numQueries = (argc > 2) ? atoi(argv[2]) : 100000;
+  if (rings < 3 || numQueries < 1)
+  {
+    cout << endl << "Usage: indexParametricGeometry [rings [queries]]"
+         << endl << endl;
+    return 1;
+  }
+
+#ifdef __BORLANDC__
+  unsigned long start, stop;
+#else
+  unsigned long long start, stop;
+#endif
+
+  SpatialPkgNamespaces sbmlns(3, 1, 1);
+  ParametricGeometry geometry(&sbmlns);
+  createSphere(&geometry, rings);
+
+  ParametricGeometryIndex index;
+
+  start = getCurrentMillis();
+  index.build(&geometry);
+  stop  = getCurrentMillis();
+
+  cout << endl;
+  cout << "           triangles: " << index.getNumTriangles() << endl;
+  cout << "               nodes: " << index.getNumNodes()     << endl;
+  cout << "     build time (ms): " << stop - start            << endl;
+
+  srand(42);
+  vector<double> queries(3 * numQueries);
+  for (size_t i = 0; i < queries.size(); ++i)
+  {
+    queries[i] = randomCoordinate();
+  }
+
+  ParametricGeometryHit hit;
+  int hits = 0;
+  start = getCurrentMillis();
+  for (int i = 0; i < numQueries; ++i)
+  {
+    const double* q = &queries[3 * i];
+    double length = sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2]);
+    if (index.intersectRay(q[0], q[1], q[2], -q[0] / length,
+                           -q[1] / length, -q[2] / length, hit))
+    {
+      ++hits;
+    }
+  }
+  stop = getCurrentMillis();
+  cout << "       ray time (ms): " << stop - start
+       << " (" << hits << " hits)" << endl;
+
+  double maxError = 0;
+  start = getCurrentMillis();
+  for (int i = 0; i < numQueries; ++i)
+  {
+    const double* q = &queries[3 * i];
+    index.getClosestPoint(q[0], q[1], q[2], hit);
+    double length = sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2]);
+    maxError = max(maxError, fabs(hit.distance - fabs(length - 1.0)));
+  }
+  stop = getCurrentMillis();
+  cout << "   closest time (ms): " << stop - start
+       << " (max deviation from sphere " << maxError << ")" << endl;
+
+  int inside = 0;
+  start = getCurrentMillis();
+  for (int i = 0; i < numQueries; ++i)
+  {
+    const double* q = &queries[3 * i];
+    if (index.isInside(q[0], q[1], q[2], "cell"))
+    {
+      ++inside;
+    }
+  }
+  stop = getCurrentMillis();
+  cout << "    inside time (ms): " << stop - start
+       << " (" << inside << " of " << numQueries << " inside)" << endl;
+  cout << endl;
+
+  return 0;
+}
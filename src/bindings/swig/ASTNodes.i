@@ -7,8 +7,11 @@
 
 #include <sbml/math/ASTNodeType.h>
 #include <sbml/math/ASTNode.h>
+#include <sbml/math/ASTNodeDAG.h>
+#include <sbml/math/ASTNodeVisitor.h>
 #include <sbml/math/MathML.h>
 #include <sbml/math/L3FormulaFormatter.h>
+#include <sbml/math/L3FormulaWriter.h>
 #include <sbml/math/FormulaFormatter.h>
 #include <sbml/math/FormulaParser.h>
 #include <sbml/math/L3Parser.h>
@@ -22,9 +25,12 @@
 
   %include sbml/math/ASTNodeType.h
   %include sbml/math/ASTNode.h
+  %include sbml/math/ASTNodeDAG.h
+  %include sbml/math/ASTNodeVisitor.h
   %include sbml/math/MathML.h
   %include sbml/math/FormulaParser.h
   %include sbml/math/L3FormulaFormatter.h
+  %include sbml/math/L3FormulaWriter.h
   %include sbml/math/FormulaFormatter.h
   %include sbml/math/L3Parser.h
   %include sbml/math/L3ParserSettings.h
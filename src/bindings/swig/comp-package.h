@@ -51,6 +51,7 @@
 #include <sbml/packages/comp/util/SBMLResolver.h>
 #include <sbml/packages/comp/util/SBMLFileResolver.h>
 #include <sbml/packages/comp/util/SBMLResolverRegistry.h>
+#include <sbml/packages/comp/util/SBMLDocumentCache.h>
 #include <sbml/packages/comp/util/CompFlatteningConverter.h>
 
 #include <sbml/packages/comp/sbml/CompBase.h>
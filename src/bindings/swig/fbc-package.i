@@ -55,6 +55,22 @@
 
 %template (FbcPkgNamespaces) SBMLExtensionNamespaces<FbcExtension>;
 
+/**
+ * The arrays of FbcSparseModel would reach the bindings as opaque pointers;
+ * their elements are read one at a time instead.
+ */
+%ignore FbcSparseModel::getColumnStarts;
+%ignore FbcSparseModel::getRowIndices;
+%ignore FbcSparseModel::getValues;
+%ignore FbcSparseModel::getLowerBounds;
+%ignore FbcSparseModel::getUpperBounds;
+%ignore FbcSparseModel::getObjectiveCoefficients;
+%ignore FbcSparseModel::getAssociationStarts;
+%ignore FbcSparseModel::getAssociationTokens;
+%ignore FbcSparseModel::copyMatrix;
+%ignore FbcSparseModel::copyBounds;
+%ignore FbcSparseModel::copyAssociations;
+
 %include <sbml/packages/fbc/extension/FbcExtension.h>
 %include <sbml/packages/fbc/extension/FbcSBasePlugin.h>
 %include <sbml/packages/fbc/extension/FbcModelPlugin.h>
@@ -66,6 +82,8 @@
 %include <sbml/packages/fbc/util/FbcToCobraConverter.h>
 %include <sbml/packages/fbc/util/FbcV1ToV2Converter.h>
 %include <sbml/packages/fbc/util/FbcV2ToV1Converter.h>
+%include <sbml/packages/fbc/util/FbcSparseModel.h>
+%include <sbml/packages/fbc/util/FluxBoundsView.h>
 
 %include <sbml/packages/fbc/sbml/Association.h>
 %include <sbml/packages/fbc/sbml/FluxBound.h>
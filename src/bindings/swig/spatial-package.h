@@ -97,6 +97,8 @@
 #include <sbml/packages/spatial/sbml/ListOfCSGObjects.h>
 #include <sbml/packages/spatial/sbml/ListOfCSGNodes.h>
 #include <sbml/packages/spatial/sbml/ListOfOrdinalMappings.h>
+#include <sbml/packages/spatial/common/ParametricGeometryIndex.h>
+#include <sbml/packages/spatial/common/CompiledCSGeometry.h>
 
 #endif // USE_SPATIAL
 
@@ -138,6 +138,14 @@ AssignmentRule::renameSIdRefs(const std::string& oldid, const std::string& newid
   }
 }
 
+
+void
+AssignmentRule::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  Rule::renameSIdRefs(renames);
+  renameIdRef(mVariable, renames);
+}
+
 /** @cond doxygenLibsbmlInternal */
 
 /*
@@ -280,6 +280,14 @@ public:
   virtual void renameSIdRefs(const std::string& oldid, const std::string& newid);
 
 
+#ifndef SWIG
+  /**
+   * @copydoc SBase::renameSIdRefs(const std::map<std::string, std::string>& renames)
+   */
+  virtual void renameSIdRefs(const std::map<std::string, std::string>& renames);
+#endif
+
+
 
 
   #ifndef SWIG
@@ -684,6 +684,13 @@ Compartment::renameSIdRefs(const std::string& oldid, const std::string& newid)
   if (mOutside==oldid) mOutside= newid; //You know, just in case.
 }
 
+
+void
+Compartment::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mCompartmentType, mOutside);
+}
+
 void 
 Compartment::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
 {
@@ -691,6 +698,13 @@ Compartment::renameUnitSIdRefs(const std::string& oldid, const std::string& newi
   if (mUnits==oldid) mUnits = newid;
 }
 
+
+void 
+Compartment::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameUnitSIdRefs(renames, mUnits);
+}
+
 /*
  * Unsets the name of this SBML object.
  */
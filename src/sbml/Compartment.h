@@ -1094,12 +1094,28 @@ public:
   virtual void renameSIdRefs(const std::string& oldid, const std::string& newid);
 
 
+#ifndef SWIG
+  /**
+   * @copydoc SBase::renameSIdRefs(const std::map<std::string, std::string>& renames)
+   */
+  virtual void renameSIdRefs(const std::map<std::string, std::string>& renames);
+#endif
+
+
   /**
    * @copydoc doc_renameunitsidref_common
    */
   virtual void renameUnitSIdRefs(const std::string& oldid, const std::string& newid);
 
 
+#ifndef SWIG
+  /**
+   * @copydoc SBase::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+   */
+  virtual void renameUnitSIdRefs(const std::map<std::string, std::string>& renames);
+#endif
+
+
   /**
    * Unsets the value of the "name" attribute of this Compartment object.
    *
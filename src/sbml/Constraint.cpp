@@ -418,6 +418,13 @@ Constraint::renameSIdRefs(const std::string& oldid, const std::string& newid)
   }
 }
 
+
+void
+Constraint::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mMath);
+}
+
 void 
 Constraint::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
 {
@@ -427,6 +434,13 @@ Constraint::renameUnitSIdRefs(const std::string& oldid, const std::string& newid
   }
 }
 
+
+void 
+Constraint::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameUnitSIdRefs(renames, mMath);
+}
+
 /** @cond doxygenLibsbmlInternal */
 void 
 Constraint::replaceSIDWithFunction(const std::string& id, const ASTNode* function)
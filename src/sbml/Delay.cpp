@@ -425,6 +425,13 @@ Delay::renameSIdRefs(const std::string& oldid, const std::string& newid)
   }
 }
 
+
+void
+Delay::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mMath);
+}
+
 void 
 Delay::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
 {
@@ -434,6 +441,13 @@ Delay::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
   }
 }
 
+
+void 
+Delay::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameUnitSIdRefs(renames, mMath);
+}
+
 /** @cond doxygenLibsbmlInternal */
 void 
 Delay::replaceSIDWithFunction(const std::string& id, const ASTNode* function)
@@ -505,12 +505,28 @@ public:
   virtual void renameSIdRefs(const std::string& oldid, const std::string& newid);
 
 
+#ifndef SWIG
+  /**
+   * @copydoc SBase::renameSIdRefs(const std::map<std::string, std::string>& renames)
+   */
+  virtual void renameSIdRefs(const std::map<std::string, std::string>& renames);
+#endif
+
+
   /**
    * @copydoc doc_renameunitsidref_common
    */
   virtual void renameUnitSIdRefs(const std::string& oldid, const std::string& newid);
 
 
+#ifndef SWIG
+  /**
+   * @copydoc SBase::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+   */
+  virtual void renameUnitSIdRefs(const std::map<std::string, std::string>& renames);
+#endif
+
+
   /** @cond doxygenLibsbmlInternal */
   /**
    * Replace all nodes with the name 'id' from the child 'math' object with the provided function. 
@@ -2124,7 +2124,9 @@ Event::writeElements (XMLOutputStream& stream) const
   else
   {
     // use original code
-    if ( getNumEventAssignments() > 0 ) mEventAssignments.write(stream);
+    if ( getNumEventAssignments() > 0
+      || mEventAssignments.hasPreservedElements() )
+      mEventAssignments.write(stream);
   }
 
   //
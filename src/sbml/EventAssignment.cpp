@@ -739,6 +739,13 @@ EventAssignment::renameSIdRefs(const std::string& oldid, const std::string& newi
   }
 }
 
+
+void
+EventAssignment::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mVariable, mMath);
+}
+
 void 
 EventAssignment::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
 {
@@ -748,6 +755,13 @@ EventAssignment::renameUnitSIdRefs(const std::string& oldid, const std::string&
   }
 }
 
+
+void 
+EventAssignment::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameUnitSIdRefs(renames, mMath);
+}
+
 /** @cond doxygenLibsbmlInternal */
 void 
 EventAssignment::replaceSIDWithFunction(const std::string& id, const ASTNode* function)
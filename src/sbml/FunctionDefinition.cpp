@@ -624,6 +624,13 @@ FunctionDefinition::renameUnitSIdRefs(const std::string& oldid, const std::strin
   }
 }
 
+
+void 
+FunctionDefinition::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameUnitSIdRefs(renames, mMath);
+}
+
 /** @cond doxygenLibsbmlInternal */
 
 /*
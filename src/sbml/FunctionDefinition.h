@@ -477,6 +477,14 @@ public:
   virtual void renameUnitSIdRefs(const std::string& oldid, const std::string& newid);
 
 
+#ifndef SWIG
+  /**
+   * @copydoc SBase::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+   */
+  virtual void renameUnitSIdRefs(const std::map<std::string, std::string>& renames);
+#endif
+
+
 
 
   #ifndef SWIG
@@ -718,6 +718,13 @@ InitialAssignment::renameSIdRefs(const std::string& oldid, const std::string& ne
   }
 }
 
+
+void
+InitialAssignment::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mSymbol, mMath);
+}
+
 void 
 InitialAssignment::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
 {
@@ -727,6 +734,13 @@ InitialAssignment::renameUnitSIdRefs(const std::string& oldid, const std::string
   }
 }
 
+
+void 
+InitialAssignment::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameUnitSIdRefs(renames, mMath);
+}
+
 /** @cond doxygenLibsbmlInternal */
 void 
 InitialAssignment::replaceSIDWithFunction(const std::string& id, const ASTNode* function)
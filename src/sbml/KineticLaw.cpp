@@ -1563,6 +1563,43 @@ KineticLaw::renameUnitSIdRefs(const std::string& oldid, const std::string& newid
   if (mSubstanceUnits == oldid) mSubstanceUnits = newid;
 }
 
+
+void
+KineticLaw::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames);
+  if (!isSetMath()) return;
+
+  //Local parameters hide the identifiers they share, so those are not renamed.
+  std::map<std::string, std::string> global;
+  bool hidden = false;
+  for (unsigned int n = 0; n < mParameters.size() + mLocalParameters.size(); n++)
+  {
+    const SBase* param = (n < mParameters.size()) ? mParameters.get(n)
+                           : mLocalParameters.get(n - mParameters.size());
+    if (renames.find(param->getId()) == renames.end()) continue;
+    if (!hidden)
+    {
+      global = renames;
+      hidden = true;
+    }
+    global.erase(param->getId());
+  }
+  mMath->renameSIdRefs(hidden ? global : renames);
+}
+
+
+void
+KineticLaw::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameUnitSIdRefs(renames);
+  if (isSetMath()) {
+    mMath->renameUnitSIdRefs(renames);
+  }
+  renameIdRef(mTimeUnits, renames);
+  renameIdRef(mSubstanceUnits, renames);
+}
+
 /** @cond doxygenLibsbmlInternal */
 void 
 KineticLaw::replaceSIDWithFunction(const std::string& id, const ASTNode* function)
@@ -1639,13 +1676,15 @@ KineticLaw::writeElements (XMLOutputStream& stream) const
     writeMathML(getMath(), stream, getSBMLNamespaces());
   }
 
-  if ( getLevel() < 3 && getNumParameters() > 0 ) 
+  if ( getLevel() < 3
+    && (getNumParameters() > 0 || mParameters.hasPreservedElements()) )
   {
     mParameters.write(stream);
   }
   else if (getLevel() == 3)
   { 
-    if ( getVersion() == 1 && getNumLocalParameters() > 0)
+    if ( getVersion() == 1 && (getNumLocalParameters() > 0
+                               || mLocalParameters.hasPreservedElements()))
     {
       mLocalParameters.write(stream);
     }
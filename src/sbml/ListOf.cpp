@@ -613,6 +613,15 @@ ListOf::hasOptionalElements() const
 /** @endcond */
   
 
+/** @cond doxygenLibsbmlInternal */
+bool
+ListOf::hasPreservedElements() const
+{
+  return (mSkippedElements.getNumChildren() > 0);
+}
+/** @endcond */
+
+
 /** @cond doxygenLibsbmlInternal */
 
 
@@ -596,6 +596,17 @@ public:
 
   /** @endcond */
 
+  /** @cond doxygenLibsbmlInternal */
+  /**
+   * Predicate returning @c true if this ListOf holds members that were
+   * skipped by an SBMLReader and preserved as XML.
+   *
+   * Before SBML Level&nbsp;3 Version&nbsp;2 a ListOf is written out only
+   * if it is not empty, which such a ListOf still needs to be.
+   */
+  bool hasPreservedElements() const;
+  /** @endcond */
+
   /** @cond doxygenLibsbmlInternal */
 
 
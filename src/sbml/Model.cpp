@@ -457,10 +457,9 @@ Model::renameIDs(List* elements, IdentifierTransformer* idTransformer)
   if (elements == NULL || elements->getSize() == 0 || idTransformer == NULL)
     return;
 
-  vector<pair<string, string> > renamedSIds;
-  vector<pair<string, string> > renamedUnitSIds;
-  vector<pair<string, string> > renamedMetaIds;
-  vector<pair<string, string> >::iterator it;
+  map<string, string> renamedSIds;
+  map<string, string> renamedUnitSIds;
+  map<string, string> renamedMetaIds;
 
   for (unsigned long el=0; el < elements->getSize(); ++el) 
   {
@@ -480,39 +479,29 @@ Model::renameIDs(List* elements, IdentifierTransformer* idTransformer)
       int type = element->getTypeCode();
       if (type==SBML_UNIT_DEFINITION) 
       {
-        renamedUnitSIds.push_back(make_pair(id, newid));
+        renamedUnitSIds.insert(make_pair(id, newid));
       }
       else 
       {
         //This is a little dangerous, but hey!  What's a little danger between friends!
         //(What we are assuming is that any attribute you can get with 'getId' is of the type 'SId')
-        renamedSIds.push_back(make_pair(id, newid));
+        renamedSIds.insert(make_pair(id, newid));
       }
     }
     if (metaid != newmetaid) 
   {
-      renamedMetaIds.push_back(make_pair(metaid, newmetaid));
+      renamedMetaIds.insert(make_pair(metaid, newmetaid));
     }
   }
 
-  for (unsigned long el = 0; el< elements->getSize(); ++el) 
-  {
-    SBase* element = static_cast<SBase*>(elements->get((unsigned int)el));
-  
-    for (it = renamedSIds.begin(); it != renamedSIds.end(); ++it) 
-  {
-      element->renameSIdRefs((*it).first, (*it).second);
-    }
-  
-    for (it = renamedUnitSIds.begin(); it != renamedUnitSIds.end(); ++it) 
-  {
-      element->renameUnitSIdRefs((*it).first, (*it).second);
-    }
-  
-    for (it = renamedMetaIds.begin(); it != renamedMetaIds.end(); ++it) 
+  if (renamedSIds.empty() && renamedUnitSIds.empty() && renamedMetaIds.empty())
+    return;
+
+  // each element is examined once for all the renames
+  for (ListIterator iter = elements->begin(); iter != elements->end(); ++iter)
   {
-      element->renameMetaIdRefs((*it).first, (*it).second);
-    }
+    SBase* element = static_cast<SBase*>(*iter);
+    element->renameIdRefs(renamedSIds, renamedUnitSIds, renamedMetaIds);
   }
 }
 /** @endcond */
@@ -4519,6 +4508,13 @@ Model::renameSIdRefs(const std::string& oldid, const std::string& newid)
   }
 }
 
+
+void
+Model::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mConversionFactor);
+}
+
 void 
 Model::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
 {
@@ -4531,6 +4527,19 @@ Model::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
   if (mExtentUnits == oldid)    mExtentUnits = newid;
 }
 
+
+void 
+Model::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameUnitSIdRefs(renames);
+  renameIdRef(mSubstanceUnits, renames);
+  renameIdRef(mTimeUnits, renames);
+  renameIdRef(mVolumeUnits, renames);
+  renameIdRef(mAreaUnits, renames);
+  renameIdRef(mLengthUnits, renames);
+  renameIdRef(mExtentUnits, renames);
+}
+
 /** @cond doxygenLibsbmlInternal */
 /*
  * Subclasses should override this method to read (and store) XHTML,
@@ -4549,7 +4558,7 @@ Model::readOtherXML (XMLInputStream& stream)
 
   if (name == "annotation")
   {
-    if (mAnnotation != NULL)
+    if (mAnnotation != NULL || hasDeferredAnnotation())
     {
       if (getLevel() < 3) 
       {
@@ -4565,38 +4574,46 @@ Model::readOtherXML (XMLInputStream& stream)
     }
 
     delete mAnnotation;
-    mAnnotation = new XMLNode(stream);
-    checkAnnotation();
-    if (mCVTerms != NULL)
-    {
-      unsigned int size = mCVTerms->getSize();
-      while (size--) delete static_cast<CVTerm*>( mCVTerms->remove(0) );
-      delete mCVTerms;
-    }
-    mCVTerms = new List();
-    delete mHistory;
-    if (RDFAnnotationParser::hasHistoryRDFAnnotation(mAnnotation))
+    mAnnotation = NULL;
+    if (!readDeferredAnnotation(stream, true))
     {
-      mHistory = RDFAnnotationParser::parseRDFAnnotation(mAnnotation, 
-                                            getMetaId().c_str(), &(stream));
-
-      if (mHistory != NULL && mHistory->hasRequiredAttributes() == false)
+      mAnnotation = new XMLNode(stream);
+      checkAnnotation();
+      if (mCVTerms != NULL)
+      {
+        unsigned int size = mCVTerms->getSize();
+        while (size--) delete static_cast<CVTerm*>( mCVTerms->remove(0) );
+        delete mCVTerms;
+      }
+      mCVTerms = new List();
+      delete mHistory;
+      if (RDFAnnotationParser::hasHistoryRDFAnnotation(mAnnotation))
       {
-        logError(RDFNotCompleteModelHistory, getLevel(), getVersion(),
-          "An invalid ModelHistory element has been stored.");
+        mHistory = RDFAnnotationParser::parseRDFAnnotation(mAnnotation,
+                                              getMetaId().c_str(), &(stream));
+
+        if (mHistory != NULL && mHistory->hasRequiredAttributes() == false)
+        {
+          logError(RDFNotCompleteModelHistory, getLevel(), getVersion(),
+            "An invalid ModelHistory element has been stored.");
+        }
+        setModelHistory(mHistory);
       }
-      setModelHistory(mHistory);
+      else
+        mHistory = NULL;
+      if (RDFAnnotationParser::hasCVTermRDFAnnotation(mAnnotation))
+        RDFAnnotationParser::parseRDFAnnotation(mAnnotation, mCVTerms,
+                                                  getMetaId().c_str(), &(stream));
     }
-    else
-      mHistory = NULL;
-    if (RDFAnnotationParser::hasCVTermRDFAnnotation(mAnnotation))
-      RDFAnnotationParser::parseRDFAnnotation(mAnnotation, mCVTerms, 
-                                                getMetaId().c_str(), &(stream));
 
-    // need to call set annotation
-    for (size_t i=0; i < mPlugins.size(); i++)
+    // need to call set annotation; a deferred annotation has only been
+    // parsed if the plugins need it
+    if (mAnnotation != NULL)
     {
-      mPlugins[i]->parseAnnotation(this, mAnnotation);
+      for (size_t i=0; i < mPlugins.size(); i++)
+      {
+        mPlugins[i]->parseAnnotation(this, mAnnotation);
+      }
     }
   
     read = true;
@@ -5233,6 +5250,7 @@ Model::writeAttributes (XMLOutputStream& stream) const
 void
 Model::writeElements (XMLOutputStream& stream) const
 {
+  loadDeferredNotes();
   if (mNotes != NULL)
   {
     mNotes->writeToStream(stream);
@@ -5322,38 +5340,55 @@ Model::writeElements (XMLOutputStream& stream) const
   else
   {
       // code as before
-    if (level > 1 && getNumFunctionDefinitions() > 0 )
+    // a list whose members were all skipped by the reader and preserved
+    // is not empty once written
+    if (level > 1 && (getNumFunctionDefinitions() > 0
+                      || mFunctionDefinitions.hasPreservedElements()))
     {
       mFunctionDefinitions.write(stream);
     }
 
-    if ( getNumUnitDefinitions() > 0 ) mUnitDefinitions.write(stream);
+    if ( getNumUnitDefinitions() > 0
+      || mUnitDefinitions.hasPreservedElements() )
+      mUnitDefinitions.write(stream);
 
     if (level == 2 && version > 1)
     {
-      if ( getNumCompartmentTypes() > 0 ) mCompartmentTypes.write(stream);
-      if ( getNumSpeciesTypes    () > 0 ) mSpeciesTypes    .write(stream);
+      if ( getNumCompartmentTypes() > 0
+        || mCompartmentTypes.hasPreservedElements() )
+        mCompartmentTypes.write(stream);
+      if ( getNumSpeciesTypes    () > 0
+        || mSpeciesTypes.hasPreservedElements() )
+        mSpeciesTypes    .write(stream);
     }
 
-    if ( getNumCompartments() > 0 ) mCompartments.write(stream);
-    if ( getNumSpecies     () > 0 ) mSpecies     .write(stream);
-    if ( getNumParameters  () > 0 ) mParameters  .write(stream);
+    if ( getNumCompartments() > 0 || mCompartments.hasPreservedElements() )
+      mCompartments.write(stream);
+    if ( getNumSpecies     () > 0 || mSpecies     .hasPreservedElements() )
+      mSpecies     .write(stream);
+    if ( getNumParameters  () > 0 || mParameters  .hasPreservedElements() )
+      mParameters  .write(stream);
 
     if (level > 2 || (level == 2 && version > 1))
     {
-      if ( getNumInitialAssignments() > 0 ) mInitialAssignments.write(stream);
+      if ( getNumInitialAssignments() > 0
+        || mInitialAssignments.hasPreservedElements() )
+        mInitialAssignments.write(stream);
     }
 
-    if ( getNumRules() > 0 ) mRules.write(stream);
+    if ( getNumRules() > 0 || mRules.hasPreservedElements() )
+      mRules.write(stream);
 
     if (level > 2 || (level == 2 && version > 1))
     {
-      if ( getNumConstraints() > 0 ) mConstraints.write(stream);
+      if ( getNumConstraints() > 0 || mConstraints.hasPreservedElements() )
+        mConstraints.write(stream);
     }
 
-    if ( getNumReactions() > 0 ) mReactions.write(stream);
+    if ( getNumReactions() > 0 || mReactions.hasPreservedElements() )
+      mReactions.write(stream);
 
-    if (level > 1 && getNumEvents () > 0 )
+    if (level > 1 && (getNumEvents () > 0 || mEvents.hasPreservedElements()))
     {
       mEvents.write(stream);
     }
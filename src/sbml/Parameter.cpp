@@ -984,6 +984,13 @@ Parameter::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
   if (mUnits == oldid) mUnits= newid;
 }
 
+
+void 
+Parameter::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameUnitSIdRefs(renames, mUnits);
+}
+
 /** @cond doxygenLibsbmlInternal */
 /**
  * Subclasses should override this method to get the list of
@@ -284,6 +284,13 @@ Priority::renameSIdRefs(const std::string& oldid, const std::string& newid)
   }
 }
 
+
+void
+Priority::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mMath);
+}
+
 void 
 Priority::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
 {
@@ -293,6 +300,13 @@ Priority::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
   }
 }
 
+
+void 
+Priority::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameUnitSIdRefs(renames, mMath);
+}
+
 /** @cond doxygenLibsbmlInternal */
 void 
 Priority::replaceSIDWithFunction(const std::string& id, const ASTNode* function)
@@ -433,6 +433,14 @@ RateRule::renameSIdRefs(const std::string& oldid, const std::string& newid)
   }
 }
 
+
+void
+RateRule::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  Rule::renameSIdRefs(renames);
+  renameIdRef(mVariable, renames);
+}
+
 #endif /* __cplusplus */
 
 
@@ -333,6 +333,13 @@ Reaction::renameSIdRefs(const std::string& oldid, const std::string& newid)
   }
 }
 
+
+void
+Reaction::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mCompartment);
+}
+
 /*
  * Initializes the fields of this Reaction to their defaults:
  *
@@ -2434,10 +2441,14 @@ Reaction::writeElements (XMLOutputStream& stream) const
   else
   {
     // use original code
-    if (getNumReactants () > 0) mReactants.write(stream);
-    if (getNumProducts  () > 0) mProducts .write(stream);
+    if (getNumReactants () > 0 || mReactants.hasPreservedElements())
+      mReactants.write(stream);
+    if (getNumProducts  () > 0 || mProducts .hasPreservedElements())
+      mProducts .write(stream);
 
-    if (level > 1 && getNumModifiers () > 0) mModifiers.write(stream);
+    if (level > 1 && (getNumModifiers () > 0
+                      || mModifiers.hasPreservedElements()))
+      mModifiers.write(stream);
   }
 
   if (mKineticLaw != NULL) mKineticLaw->write(stream);
@@ -876,6 +876,42 @@ Rule::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
   }
 }
 
+void 
+Rule::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames);
+  if (isSetMath()) {
+    mMath->renameSIdRefs(renames);
+  }
+  else if (isSetFormula()) {
+    ASTNode* math = SBML_parseFormula(mFormula.c_str());
+    if (math==NULL) return;
+    math->renameSIdRefs(renames);
+    char* formula = SBML_formulaToString(math);
+    setFormula(formula);
+    delete math;
+    delete formula;
+  }
+}
+
+void 
+Rule::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameUnitSIdRefs(renames);
+  if (isSetMath()) {
+    mMath->renameUnitSIdRefs(renames);
+  }
+  else if (isSetFormula()) {
+    ASTNode* math = SBML_parseFormula(mFormula.c_str());
+    if (math==NULL) return;
+    math->renameUnitSIdRefs(renames);
+    char* formula = SBML_formulaToString(math);
+    setFormula(formula);
+    delete math;
+    delete formula;
+  }
+}
+
 /** @cond doxygenLibsbmlInternal */
 void 
 Rule::replaceSIDWithFunction(const std::string& id, const ASTNode* function)
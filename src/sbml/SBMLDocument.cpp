@@ -127,6 +127,7 @@ SBMLDocument::SBMLDocument (unsigned int level, unsigned int version) :
  , mLocationURI     ("")
  , mRequiredAttrOfUnknownPkg()
  , mRequiredAttrOfUnknownDisabledPkg()
+ , mReader (NULL)
 {
   if (mLevel   == 0 && mVersion == 0)  
   {
@@ -161,6 +162,7 @@ SBMLDocument::SBMLDocument (SBMLNamespaces* sbmlns) :
  , mLocationURI ("")
  , mRequiredAttrOfUnknownPkg()
  , mRequiredAttrOfUnknownDisabledPkg()
+ , mReader (NULL)
 {
   if (!hasValidLevelVersionNamespaceCombination())
   {
@@ -255,6 +257,7 @@ SBMLDocument::SBMLDocument (const SBMLDocument& orig)
  , mRequiredAttrOfUnknownPkg(orig.mRequiredAttrOfUnknownPkg)
  , mRequiredAttrOfUnknownDisabledPkg(orig.mRequiredAttrOfUnknownDisabledPkg)
  , mPkgUseDefaultNSMap()
+ , mReader (NULL)
 {
   
   
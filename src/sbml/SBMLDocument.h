@@ -323,6 +323,7 @@ class XMLError;
 class SBMLValidator;
 class SBMLInternalValidator;
 class SBMLLevelVersionConverter;
+class SBMLReader;
 
 /** @cond doxygenLibsbmlInternal */
 /* Internal constants for setting/unsetting particular consistency checks. */
@@ -1708,6 +1709,10 @@ protected:
 
   PkgUseDefaultNSMap       mPkgUseDefaultNSMap;
 
+  /* the SBMLReader reading this document, whose options (e.g. deferred
+   * annotation parsing, skipped elements) apply while it is set */
+  const SBMLReader*        mReader;
+
   friend class SBase;
   friend class SBMLReader;
   friend class SBMLLevelVersionConverter;
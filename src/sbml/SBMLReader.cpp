@@ -63,7 +63,17 @@ LIBSBML_CPP_NAMESPACE_BEGIN
 /*
  * Creates a new SBMLReader and returns it. 
  */
-SBMLReader::SBMLReader ()
+SBMLReader::SBMLReader () :
+   mDeferAnnotationParsing (false)
+ , mSkippedTypes ()
+ , mSkippedMembers ()
+ , mSkippedPackages ()
+ , mSkipNotes (false)
+ , mSkipAnnotations (false)
+ , mSkipMath (false)
+ , mPreserveSkippedElements (false)
+ , mStreamingVisitor (NULL)
+ , mStreamingStopped (false)
 {
 }
 
@@ -143,22 +153,323 @@ SBMLReader::readSBMLFromFile (const std::string& filename)
 SBMLDocument*
 SBMLReader::readSBMLFromString (const std::string& xml)
 {
-  const static string dummy_xml ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");  
-  
-  if (!strncmp(xml.c_str(), dummy_xml.c_str(), 14))
+  return readStringInternal(xml);
+}
+
+
+/*
+ * Reads an SBML document from the given file, handing the components of
+ * its model to the given visitor one at a time.
+ */
+SBMLDocument*
+SBMLReader::readSBMLStreaming (const std::string& filename, 
+                               SBMLVisitor& visitor)
+{
+  mStreamingVisitor = &visitor;
+  mStreamingStopped = false;
+
+  SBMLDocument* d = readInternal(filename.c_str(), true);
+
+  mStreamingVisitor = NULL;
+  return d;
+}
+
+
+/*
+ * Reads an SBML document from the given XML string, handing the
+ * components of its model to the given visitor one at a time.
+ */
+SBMLDocument*
+SBMLReader::readSBMLFromStringStreaming (const std::string& xml, 
+                                         SBMLVisitor& visitor)
+{
+  mStreamingVisitor = &visitor;
+  mStreamingStopped = false;
+
+  SBMLDocument* d = readStringInternal(xml);
+
+  mStreamingVisitor = NULL;
+  return d;
+}
+
+
+/*
+ * Ends the streaming read in progress.
+ */
+void
+SBMLReader::stopStreaming ()
+{
+  if (mStreamingVisitor != NULL)
   {
-    return readInternal(xml.c_str(), false);
+    mStreamingStopped = true;
   }
-  else
+}
+
+
+/*
+ * Sets whether CVTerms and ModelHistory objects are only constructed from
+ * annotations on first access.
+ */
+void
+SBMLReader::setDeferAnnotationParsing (bool defer)
+{
+  mDeferAnnotationParsing = defer;
+}
+
+
+/*
+ * @return @c true if the interpretation of annotations is deferred.
+ */
+bool
+SBMLReader::getDeferAnnotationParsing () const
+{
+  return mDeferAnnotationParsing;
+}
+
+
+/*
+ * Tells this reader to skip elements of the given type.
+ */
+int
+SBMLReader::addSkippedType (int typeCode, const std::string& pkgName)
+{
+  mSkippedTypes.insert(make_pair(typeCode, pkgName));
+  mSkippedMembers.clear();
+  return LIBSBML_OPERATION_SUCCESS;
+}
+
+
+/*
+ * @return @c true if elements of the given type are skipped.
+ */
+bool
+SBMLReader::isSkippedType (int typeCode, const std::string& pkgName) const
+{
+  return mSkippedTypes.find(make_pair(typeCode, pkgName)) 
+         != mSkippedTypes.end();
+}
+
+
+/*
+ * Removes all types added with addSkippedType().
+ */
+void
+SBMLReader::clearSkippedTypes ()
+{
+  mSkippedTypes.clear();
+  mSkippedMembers.clear();
+}
+
+
+/*
+ * Tells this reader to skip the elements of the given package.
+ */
+int
+SBMLReader::addSkippedPackage (const std::string& pkgURI)
+{
+  if (pkgURI.empty())
   {
-    const std::string temp = (dummy_xml + xml);
-    return readInternal(temp.c_str(), false);
+    return LIBSBML_INVALID_ATTRIBUTE_VALUE;
   }
-  
-  
+
+  mSkippedPackages.insert(pkgURI);
+  return LIBSBML_OPERATION_SUCCESS;
+}
+
+
+/*
+ * @return @c true if the elements of the given package are skipped.
+ */
+bool
+SBMLReader::isSkippedPackage (const std::string& pkgURI) const
+{
+  return mSkippedPackages.find(pkgURI) != mSkippedPackages.end();
 }
 
 
+/*
+ * Removes all packages added with addSkippedPackage().
+ */
+void
+SBMLReader::clearSkippedPackages ()
+{
+  mSkippedPackages.clear();
+}
+
+
+void
+SBMLReader::setSkipNotes (bool skip)
+{
+  mSkipNotes = skip;
+}
+
+
+bool
+SBMLReader::getSkipNotes () const
+{
+  return mSkipNotes;
+}
+
+
+void
+SBMLReader::setSkipAnnotations (bool skip)
+{
+  mSkipAnnotations = skip;
+}
+
+
+bool
+SBMLReader::getSkipAnnotations () const
+{
+  return mSkipAnnotations;
+}
+
+
+void
+SBMLReader::setSkipMath (bool skip)
+{
+  mSkipMath = skip;
+}
+
+
+bool
+SBMLReader::getSkipMath () const
+{
+  return mSkipMath;
+}
+
+
+void
+SBMLReader::setPreserveSkippedElements (bool preserve)
+{
+  mPreserveSkippedElements = preserve;
+}
+
+
+bool
+SBMLReader::getPreserveSkippedElements () const
+{
+  return mPreserveSkippedElements;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * @return @c true if the element starting with the given token is to be
+ * skipped because of its name or namespace.
+ */
+bool
+SBMLReader::isSkipped (const XMLToken& element) const
+{
+  if (!mSkippedPackages.empty() && isSkippedPackage(element.getURI()))
+  {
+    return true;
+  }
+
+  const string& name = element.getName();
+
+  if (mSkipNotes && name == "notes")
+  {
+    return true;
+  }
+  else if (mSkipAnnotations && (name == "annotation" || name == "annotations"))
+  {
+    return true;
+  }
+  else if (mSkipMath && name == "math")
+  {
+    return true;
+  }
+
+  return false;
+}
+
+
+/*
+ * @return @c true if the given object is to be skipped because of its type.
+ */
+bool
+SBMLReader::isSkipped (const SBase* object) const
+{
+  if (mSkippedTypes.empty() || object == NULL)
+  {
+    return false;
+  }
+
+  return isSkippedType(object->getTypeCode(), object->getPackageName());
+}
+
+
+/*
+ * @return the key under which it is remembered whether the members named
+ * like the given element are skipped in lists like the given one.
+ */
+static string
+getMemberKey (const XMLToken& element, const SBase* list)
+{
+  return list->getURI() + ' ' + list->getElementName() + ' '
+         + element.getURI() + ' ' + element.getName();
+}
+
+
+/*
+ * @return @c true if the member element of the given list is to be skipped
+ * because an earlier element of its name was of a skipped type.
+ */
+bool
+SBMLReader::isSkipped (const XMLToken& element, const SBase* list) const
+{
+  if (mSkippedTypes.empty() || list == NULL)
+  {
+    return false;
+  }
+
+  map<string, bool>::const_iterator it =
+    mSkippedMembers.find(getMemberKey(element, list));
+
+  return (it != mSkippedMembers.end() && it->second);
+}
+
+
+/*
+ * @return @c true if the given object, created for the member element of
+ * the given list, is to be skipped because of its type.
+ */
+bool
+SBMLReader::isSkipped (const SBase* object, const XMLToken& element,
+                       const SBase* list) const
+{
+  if (mSkippedTypes.empty() || object == NULL || list == NULL)
+  {
+    return false;
+  }
+
+  bool skipped = isSkipped(object);
+  mSkippedMembers[getMemberKey(element, list)] = skipped;
+
+  return skipped;
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+SBMLVisitor*
+SBMLReader::getStreamingVisitor () const
+{
+  return mStreamingVisitor;
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+bool
+SBMLReader::isStreamingStopped () const
+{
+  return mStreamingStopped;
+}
+/** @endcond */
+
+
 /*
  * Predicate returning @c true if
  * libSBML is linked with zlib.
@@ -248,6 +559,32 @@ void sortReportedErrors(SBMLDocument* d)
 
 /** @endcond */
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * If the string does not begin with XML declaration:
+ *
+ *   <?xml version='1.0' encoding='UTF-8'?>
+ *
+ * it will be prepended.
+ */
+SBMLDocument*
+SBMLReader::readStringInternal (const std::string& xml)
+{
+  const static string dummy_xml ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");  
+  
+  if (!strncmp(xml.c_str(), dummy_xml.c_str(), 14))
+  {
+    return readInternal(xml.c_str(), false);
+  }
+  else
+  {
+    const std::string temp = (dummy_xml + xml);
+    return readInternal(temp.c_str(), false);
+  }
+}
+/** @endcond */
+
+
 /** @cond doxygenLibsbmlInternal */
 
 /*
@@ -294,7 +631,9 @@ SBMLReader::readInternal (const char* content, bool isFile)
       return d;
     }
 
+    d->mReader = this;
     d->read(stream);
+    d->mReader = NULL;
 
     if (stream.isError())
     {
@@ -339,9 +678,10 @@ SBMLReader::readInternal (const char* content, bool isFile)
                                      d->getLevel(), d->getVersion());
         }
       }
-      else if (d->getLevel() == 1)
+      else if (d->getLevel() == 1 && mStreamingVisitor == NULL)
       {
 	// In Level 1, some listOfElements were required.
+	// (When streaming, the lists have been emptied deliberately.)
 
         if (d->getModel()->getNumCompartments() == 0)
         {
@@ -425,6 +765,24 @@ SBMLReader_readSBMLFromString (SBMLReader_t *sr, const char *xml)
 }
 
 
+LIBSBML_EXTERN
+void
+SBMLReader_setDeferAnnotationParsing (SBMLReader_t *sr, int defer)
+{
+  if (sr != NULL)
+    sr->setDeferAnnotationParsing(defer != 0);
+}
+
+
+LIBSBML_EXTERN
+int
+SBMLReader_getDeferAnnotationParsing (const SBMLReader_t *sr)
+{
+  return (sr != NULL) ? 
+    static_cast<int>( sr->getDeferAnnotationParsing() ) : 0;
+}
+
+
 LIBSBML_EXTERN
 int
 SBMLReader_hasZlib (void)
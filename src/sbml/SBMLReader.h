@@ -333,10 +333,16 @@ if (doc.getNumErrors() > 0)
 
 
 #include <string>
+#include <map>
+#include <set>
+#include <utility>
 
 LIBSBML_CPP_NAMESPACE_BEGIN
 
 class SBMLDocument;
+class SBase;
+class SBMLVisitor;
+class XMLToken;
 
 
 class LIBSBML_EXTERN SBMLReader
@@ -413,6 +419,335 @@ public:
   SBMLDocument* readSBMLFromString (const std::string& xml);
 
 
+  /**
+   * Reads an SBML document from the given file, handing the components of
+   * its model to a visitor one at a time instead of keeping them.
+   *
+   * Every element of the lists of the model (for example each
+   * FunctionDefinition, Compartment, Species, Parameter, Rule, Reaction or
+   * Event, and the elements of the model-level lists of packages) is read
+   * in full, passed to @p visitor through its @c accept() method while
+   * it is still attached to the model, and deleted again as soon as the
+   * visitor returns.  The memory used therefore depends on the size of the
+   * largest single component rather than on the size of the model, which
+   * makes this method suitable for gathering statistics or building
+   * indexes over very large files.  A visitor that needs to keep a
+   * component must store a clone of it.
+   *
+   * The SBMLDocument returned holds everything read except the components
+   * handed to the visitor: the model with its attributes, notes and
+   * annotation, the (now empty) lists of the model, and the error log.
+   * Reading can be ended early by calling stopStreaming() from within the
+   * visitor.
+   *
+   * All other options of this reader, such as the skipped types and
+   * packages, also apply when streaming.
+   *
+   * @param filename the name or full pathname of the file to be read.
+   *
+   * @param visitor the SBMLVisitor to which the components of the model
+   * are handed.
+   *
+   * @return a pointer to the SBMLDocument holding what remains of the
+   * document.
+   *
+   * @see readSBMLFromStringStreaming(@if java String, SBMLVisitor@endif)
+   * @see stopStreaming()
+   */
+  SBMLDocument* readSBMLStreaming (const std::string& filename, 
+                                   SBMLVisitor& visitor);
+
+
+  /**
+   * Reads an SBML document from the given XML string, handing the
+   * components of its model to a visitor one at a time instead of keeping
+   * them.
+   *
+   * @param xml a string containing a full SBML model.
+   *
+   * @param visitor the SBMLVisitor to which the components of the model
+   * are handed.
+   *
+   * @return a pointer to the SBMLDocument holding what remains of the
+   * document.
+   *
+   * @see readSBMLStreaming(@if java String, SBMLVisitor@endif)
+   */
+  SBMLDocument* readSBMLFromStringStreaming (const std::string& xml, 
+                                             SBMLVisitor& visitor);
+
+
+  /**
+   * Ends the streaming read in progress.
+   *
+   * This method is meant to be called from within the visitor passed to
+   * readSBMLStreaming() or readSBMLFromStringStreaming(); no further
+   * components are read after the current one.  It has no effect when no
+   * streaming read is in progress.
+   */
+  void stopStreaming ();
+
+
+  /**
+   * Sets whether annotations are interpreted lazily by this reader.
+   *
+   * By default, every <code>&lt;annotation&gt;</code> and
+   * <code>&lt;notes&gt;</code> read is immediately turned into an XMLNode
+   * tree, and annotations are scanned for MIRIAM RDF, from which the
+   * CVTerm and ModelHistory objects are constructed.  When deferral is
+   * enabled, annotations and notes are only kept as text while reading.
+   * The XMLNode is built the first time the annotation or notes are
+   * requested from the object (for example through SBase::getAnnotation()
+   * or SBase::getNotes()), and the CVTerm and ModelHistory objects the
+   * first time they are requested (for example through
+   * SBase::getCVTerms(), SBase::getNumCVTerms() or
+   * SBase::getModelHistory()).  An annotation that package extensions
+   * read their own information from is built while reading, unless it
+   * holds nothing but RDF.
+   *
+   * Deferral reduces the time and memory needed to read documents that
+   * carry large amounts of annotation when the application is not
+   * interested in it.  Diagnostics about the annotations and notes (for
+   * example an incomplete ModelHistory or notes that are not XHTML) are
+   * logged to the document error log when they are built rather than when
+   * the document is read.
+   *
+   * @param defer a boolean, @c true to defer the interpretation of
+   * annotations, @c false (the default) to interpret them while reading.
+   *
+   * @see getDeferAnnotationParsing()
+   */
+  void setDeferAnnotationParsing (bool defer);
+
+
+  /**
+   * Returns whether annotations are interpreted lazily by this reader.
+   *
+   * @return @c true if annotations and notes are only parsed on first
+   * access, @c false otherwise.
+   *
+   * @see setDeferAnnotationParsing(bool defer)
+   */
+  bool getDeferAnnotationParsing () const;
+
+
+  /**
+   * Tells this reader to skip elements of the given type.
+   *
+   * Elements are only skipped where they appear as members of a
+   * <code>&lt;listOf<em>Xxx</em>&gt;</code> container, so for example
+   * skipping #SBML_EVENT leaves every
+   * <code>&lt;listOfEvents&gt;</code> empty, while skipping
+   * #SBML_SPECIES_REFERENCE leaves reactions without reactants and
+   * products.  The type of a member is learned from the first element of
+   * its name in a given container; later elements of that name are passed
+   * over at the token level, without an object being created for them or
+   * any of their content being interpreted.
+   *
+   * @param typeCode the libSBML type code of the elements to skip.
+   * @param pkgName the name of the package that defines @p typeCode;
+   * defaults to @c "core".
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBSBML_OPERATION_SUCCESS, OperationReturnValues_t}
+   *
+   * @see isSkippedType(int typeCode, const std::string& pkgName)
+   * @see clearSkippedTypes()
+   */
+  int addSkippedType (int typeCode, const std::string& pkgName = "core");
+
+
+  /**
+   * Predicate returning @c true if this reader skips elements of the
+   * given type.
+   *
+   * @param typeCode the libSBML type code of the elements.
+   * @param pkgName the name of the package that defines @p typeCode;
+   * defaults to @c "core".
+   *
+   * @return @c true if elements of the given type are skipped, @c false
+   * otherwise.
+   */
+  bool isSkippedType (int typeCode, const std::string& pkgName = "core") const;
+
+
+  /**
+   * Removes all types added with addSkippedType().
+   */
+  void clearSkippedTypes ();
+
+
+  /**
+   * Tells this reader to skip every element in the namespace of the given
+   * package.
+   *
+   * This allows, for example, the layout and render information of a
+   * document to be ignored when only the reaction network is of interest.
+   * Matching elements are skipped before any object is constructed for
+   * them.  Attributes in the namespace of the package are still read.
+   *
+   * @param pkgURI the XML namespace URI of the package.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBSBML_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBSBML_INVALID_ATTRIBUTE_VALUE, OperationReturnValues_t}
+   *
+   * @see isSkippedPackage(const std::string& pkgURI)
+   * @see clearSkippedPackages()
+   */
+  int addSkippedPackage (const std::string& pkgURI);
+
+
+  /**
+   * Predicate returning @c true if this reader skips the elements of the
+   * package with the given namespace URI.
+   *
+   * @param pkgURI the XML namespace URI of the package.
+   *
+   * @return @c true if the elements of the package are skipped, @c false
+   * otherwise.
+   */
+  bool isSkippedPackage (const std::string& pkgURI) const;
+
+
+  /**
+   * Removes all packages added with addSkippedPackage().
+   */
+  void clearSkippedPackages ();
+
+
+  /**
+   * Sets whether this reader skips <code>&lt;notes&gt;</code> elements.
+   *
+   * @param skip a boolean, @c true to skip notes.
+   */
+  void setSkipNotes (bool skip);
+
+
+  /**
+   * Returns whether this reader skips <code>&lt;notes&gt;</code> elements.
+   *
+   * @return @c true if notes are skipped, @c false otherwise.
+   */
+  bool getSkipNotes () const;
+
+
+  /**
+   * Sets whether this reader skips <code>&lt;annotation&gt;</code>
+   * elements.
+   *
+   * @param skip a boolean, @c true to skip annotations.
+   */
+  void setSkipAnnotations (bool skip);
+
+
+  /**
+   * Returns whether this reader skips <code>&lt;annotation&gt;</code>
+   * elements.
+   *
+   * @return @c true if annotations are skipped, @c false otherwise.
+   */
+  bool getSkipAnnotations () const;
+
+
+  /**
+   * Sets whether this reader skips MathML <code>&lt;math&gt;</code>
+   * elements.
+   *
+   * Objects whose math is skipped are read as though the math were
+   * absent.
+   *
+   * @param skip a boolean, @c true to skip MathML.
+   */
+  void setSkipMath (bool skip);
+
+
+  /**
+   * Returns whether this reader skips MathML <code>&lt;math&gt;</code>
+   * elements.
+   *
+   * @return @c true if MathML is skipped, @c false otherwise.
+   */
+  bool getSkipMath () const;
+
+
+  /**
+   * Sets whether elements skipped by this reader are kept as XML.
+   *
+   * When enabled, every skipped element is stored, uninterpreted, as an
+   * XMLNode on the object that contained it and written out again when the
+   * document is written, so that a document read with a filter can be
+   * saved without losing content.  Skipped notes and annotations are
+   * stored as the notes and annotation of their object, and skipped math
+   * is written where the math of its object belongs; any other skipped
+   * element is written after the remaining children of its parent.
+   *
+   * Before SBML Level&nbsp;3 Version&nbsp;2 a
+   * <code>&lt;listOf<em>Xxx</em>&gt;</code> container may not be empty.
+   * A container whose members were all skipped and preserved is still
+   * written out, with the preserved members, so the document written is
+   * valid again.
+   *
+   * @param preserve a boolean, @c true to keep skipped elements.
+   */
+  void setPreserveSkippedElements (bool preserve);
+
+
+  /**
+   * Returns whether elements skipped by this reader are kept as XML.
+   *
+   * @return @c true if skipped elements are preserved, @c false otherwise.
+   */
+  bool getPreserveSkippedElements () const;
+
+
+  /** @cond doxygenLibsbmlInternal */
+  /**
+   * Predicate returning @c true if the element starting with the given
+   * token is to be skipped because of its name or namespace.
+   */
+  bool isSkipped (const XMLToken& element) const;
+
+
+  /**
+   * Predicate returning @c true if the given (newly created) object is to
+   * be skipped because of its type.
+   */
+  bool isSkipped (const SBase* object) const;
+
+
+  /**
+   * Predicate returning @c true if the member element of @p list starting
+   * with the given token is to be skipped because an earlier element of
+   * the same name in such a list was of a skipped type.
+   */
+  bool isSkipped (const XMLToken& element, const SBase* list) const;
+
+
+  /**
+   * Predicate returning @c true if the given object, just created for the
+   * member element of @p list starting with the given token, is to be
+   * skipped because of its type.  The answer is remembered for later
+   * elements of the same name in such a list.
+   */
+  bool isSkipped (const SBase* object, const XMLToken& element,
+                  const SBase* list) const;
+
+
+  /**
+   * Returns the visitor of the streaming read in progress, or @c NULL.
+   */
+  SBMLVisitor* getStreamingVisitor () const;
+
+
+  /**
+   * Predicate returning @c true if stopStreaming() was called during the
+   * streaming read in progress.
+   */
+  bool isStreamingStopped () const;
+  /** @endcond */
+
+
   /**
    * Static method; returns @c true if this copy of libSBML supports
    * <i>gzip</I> and <i>zip</i> format compression.
@@ -450,6 +785,31 @@ protected:
    */
   SBMLDocument* readInternal (const char* content, bool isFile = true);
 
+
+  /**
+   * Used by readSBML() and readSBMLFromString() and their streaming
+   * variants; prepends the XML declaration to @p xml if it is missing.
+   */
+  SBMLDocument* readStringInternal (const std::string& xml);
+
+
+  bool mDeferAnnotationParsing;
+
+  std::set< std::pair<int, std::string> > mSkippedTypes;
+
+  // whether the members of a given name in a given list are skipped,
+  // keyed by getMemberKey(); filled while reading
+  mutable std::map<std::string, bool> mSkippedMembers;
+
+  std::set<std::string> mSkippedPackages;
+  bool mSkipNotes;
+  bool mSkipAnnotations;
+  bool mSkipMath;
+  bool mPreserveSkippedElements;
+
+  SBMLVisitor* mStreamingVisitor;
+  bool mStreamingStopped;
+
   /** @endcond */
 };
 
@@ -559,6 +919,39 @@ SBMLDocument_t *
 SBMLReader_readSBMLFromString (SBMLReader_t *sr, const char *xml);
 
 
+/**
+ * Sets whether the given SBMLReader_t structure keeps annotations and
+ * notes as text, and defers the construction of XMLNode_t, CVTerm_t and
+ * ModelHistory_t structures from them until they are first accessed.
+ *
+ * @param sr the SBMLReader_t structure to use.
+ * @param defer an integer, nonzero to defer the parsing of annotations
+ * and notes, zero to parse them while reading.
+ *
+ * @if conly
+ * @memberof SBMLReader_t
+ * @endif
+ */
+LIBSBML_EXTERN
+void
+SBMLReader_setDeferAnnotationParsing (SBMLReader_t *sr, int defer);
+
+
+/**
+ * Returns @c 1 (true) if the given SBMLReader_t structure defers the
+ * parsing of annotations and notes, @c 0 (false) otherwise.
+ *
+ * @param sr the SBMLReader_t structure to use.
+ *
+ * @if conly
+ * @memberof SBMLReader_t
+ * @endif
+ */
+LIBSBML_EXTERN
+int
+SBMLReader_getDeferAnnotationParsing (const SBMLReader_t *sr);
+
+
 /**
  * Returns @c 1 (true) if the underlying libSBML supports @em gzip and @em zlib
  * format compression.
@@ -44,6 +44,8 @@
 #include <sbml/Model.h>
 
 #include <cstring>
+#include <map>
+#include <vector>
 #include <math.h>
 
 #include <sbml/util/IdList.h>
@@ -58,105 +60,477 @@ LIBSBML_CPP_NAMESPACE_BEGIN
 /** @cond doxygenLibsbmlInternal */
 SBMLTransforms::IdValueMap SBMLTransforms::mValues;
 
-void
-SBMLTransforms::replaceFD(ASTNode * node, const ListOfFunctionDefinitions *lofd, const IdList* idsToExclude /*= NULL*/)
+
+static bool
+isArithmetic(const ASTNode* node)
 {
-  if (lofd == NULL) 
-    return;
+  switch (node->getType())
+  {
+  case AST_PLUS:
+  case AST_MINUS:
+  case AST_TIMES:
+  case AST_DIVIDE:
+  case AST_POWER:
+  case AST_FUNCTION_POWER:
+    return true;
+  default:
+    return false;
+  }
+}
 
-  bool replaced = false;
 
-  /* write a list of fd ids */
-  IdList ids;
-  unsigned int i;
-  unsigned int skipped = 0;
-  for (i = 0; i < lofd->size(); i++)
+/*
+ * Returns how many children of an arithmetic node take part in its value;
+ * missing children evaluate to NaN.
+ */
+static unsigned int
+getNumOperands(const ASTNode* node)
+{
+  switch (node->getType())
   {
-    const std::string& id = lofd->get(i)->getId();
-    if (idsToExclude == NULL || !idsToExclude->contains(id))
-    ids.append(id);
-    else ++skipped;
+  case AST_PLUS:
+  case AST_TIMES:
+    return node->getNumChildren();
+  case AST_MINUS:
+    return (node->getNumChildren() == 1) ? 1 : 2;
+  default:
+    return 2;
   }
-  
-  /* if any of these ids exist in the ASTnode replace */
-  /* Need a get out if replace fails - shouldnt happen but as a fail-safe */ 
-  unsigned int count = 0;
-  do 
+}
+
+
+static double
+applyOperator(const ASTNode* node, const vector<double>& operands, 
+              size_t first)
+{
+  size_t num = operands.size() - first;
+  double result = 0.0;
+
+  switch (node->getType())
   {
-    for (i = 0; i < lofd->size(); i++)
+  case AST_PLUS:
+    if (num > 0)
     {
-      replaceFD(node, lofd->get(i), idsToExclude);
+      result = operands[first];
+      for (size_t j = first + 1; j < operands.size(); ++j)
+      {
+        result = result + operands[j];
+      }
     }
+    break;
+
+  case AST_TIMES:
+    result = 1.0;
+    if (num > 0)
+    {
+      result = operands[first];
+      for (size_t j = first + 1; j < operands.size(); ++j)
+      {
+        result = result * operands[j];
+      }
+    }
+    break;
+
+  case AST_MINUS:
+    if (num == 1)
+      result = -(operands[first]);
+    else
+      result = operands[first] - operands[first + 1];
+    break;
+
+  case AST_DIVIDE:
+    result = operands[first] / operands[first + 1];
+    break;
 
-    replaced = !(checkFunctionNodeForIds(node, ids));
-    count++;
-  } 
-  while (!replaced && count < 2*(lofd->size() - skipped));
+  default:
+    result = pow(operands[first], operands[first + 1]);
+    break;
+  }
+
+  return result;
 }
 
-void
-SBMLTransforms::replaceFD(ASTNode * node, const FunctionDefinition *fd, const IdList* idsToExclude /*= NULL*/)
+
+/*
+ * Evaluates a tree of arithmetic operators with an explicit stack, so that
+ * long sums and products nested as binary nodes do not recurse once per
+ * level.  All other operands are passed back to evaluateASTNode().
+ */
+static double
+evaluateArithmetic(const ASTNode* node, 
+                   const SBMLTransforms::IdValueMap& values, const Model* m)
 {
-  if ((node == NULL) || (fd == NULL))
-    return;
-  
-  recurseReplaceFD(node, fd, idsToExclude);
+  // the nodes being evaluated, the number of operands taken so far and
+  // where their operands start on the operand stack
+  vector<const ASTNode*> nodes;
+  vector<unsigned int> taken;
+  vector<size_t> firsts;
+  vector<double> operands;
+
+  nodes.push_back(node);
+  taken.push_back(0);
+  firsts.push_back(0);
+
+  while (!nodes.empty())
+  {
+    const ASTNode* current = nodes.back();
+    unsigned int n = taken.back();
 
-}
+    if (n < getNumOperands(current))
+    {
+      ++taken.back();
+      const ASTNode* child = current->getChild(n);
+      if (child != NULL && isArithmetic(child))
+      {
+        nodes.push_back(child);
+        taken.push_back(0);
+        firsts.push_back(operands.size());
+      }
+      else
+      {
+        operands.push_back(SBMLTransforms::evaluateASTNode(child, values, m));
+      }
+    }
+    else
+    {
+      size_t first = firsts.back();
+      double result = applyOperator(current, operands, first);
+      operands.resize(first);
+      operands.push_back(result);
+      nodes.pop_back();
+      taken.pop_back();
+      firsts.pop_back();
+    }
+  }
 
+  return operands.back();
+}
 
-void
-SBMLTransforms::recurseReplaceFD(ASTNode * node, const FunctionDefinition *fd, const IdList* idsToExclude /*= NULL*/)
+/*
+ * Replaces the bound variables in a copy of the body of a function
+ * definition with the arguments of a call.  All the leaves naming a bound
+ * variable are found before any is replaced, so that names within the
+ * arguments are never replaced in turn.
+ */
+static void
+substituteArguments(ASTNode* body, const FunctionDefinition* fd, 
+                    const ASTNode& args)
 {
-  if ((node == NULL) || (fd == NULL))
+  map<string, unsigned int> bvars;
+  unsigned int numBvars = fd->getNumArguments();
+  for (unsigned int i = 0; i < numBvars && i < args.getNumChildren(); ++i)
+  {
+    const ASTNode* bvar = fd->getArgument(i);
+    if (bvar != NULL && bvar->getName() != NULL)
+    {
+      // as when replacing one after the other, the first one wins
+      bvars.insert(make_pair(string(bvar->getName()), i));
+    }
+  }
+  if (bvars.empty())
     return;
 
-  if (node->isFunction()
-    && node->getName() != NULL
-      && node->getName() == fd->getId()
-      && (idsToExclude == NULL || !idsToExclude->contains(fd->getId())))
+  vector<ASTNode*> leaves;
+  vector<unsigned int> indices;
+  vector<ASTNode*> pending(1, body);
+  while (!pending.empty())
   {
-   replaceBvars(node, fd);
-   for (unsigned int j = 0; j < node->getNumChildren(); j++)
-   {
-     recurseReplaceFD(node->getChild(j), fd, idsToExclude);
-   }
+    ASTNode* node = pending.back();
+    pending.pop_back();
+
+    unsigned int numChildren = node->getNumChildren();
+    if (numChildren == 0 && node->isName() && node->getName() != NULL)
+    {
+      map<string, unsigned int>::const_iterator it = 
+        bvars.find(node->getName());
+      if (it != bvars.end())
+      {
+        leaves.push_back(node);
+        indices.push_back(it->second);
+      }
+    }
+    for (unsigned int i = numChildren; i > 0; --i)
+    {
+      pending.push_back(node->getChild(i - 1));
+    }
   }
-  else
+
+  // the last use of each argument takes its subtree rather than a copy of
+  // it, once the other uses have been copied, so that expanding nested
+  // calls does not copy the inner calls again at every level
+  vector<size_t> lastUse(args.getNumChildren(), leaves.size());
+  for (size_t i = 0; i < leaves.size(); ++i)
+  {
+    lastUse[indices[i]] = i;
+  }
+
+  for (size_t i = 0; i < leaves.size(); ++i)
   {
-    for (unsigned int i = 0; i < node->getNumChildren(); i++)
+    if (lastUse[indices[i]] != i)
     {
-      recurseReplaceFD(node->getChild(i), fd, idsToExclude);
+      *leaves[i] = *args.getChild(indices[i]);
+    }
+  }
+
+  for (size_t i = 0; i < leaves.size(); ++i)
+  {
+    if (lastUse[indices[i]] == i)
+    {
+      ASTNode* arg = args.getChild(indices[i]);
+      ASTNode children;
+      children.swapChildren(arg);
+      *leaves[i] = *arg;
+      leaves[i]->swapChildren(&children);
     }
   }
 }
 
 
-void
-SBMLTransforms::replaceBvars(ASTNode * node, const FunctionDefinition *fd)
+/*
+ * Expands calls of function definitions in any number of expressions.
+ *
+ * The body of each function definition is expanded once, the first time
+ * it is needed, after the bodies of the functions it calls; every call is
+ * then replaced by a copy of the expanded body with the (already expanded)
+ * arguments put in place.  Each expression is thus walked once, however
+ * deeply the functions call each other.  A call that would make a function
+ * expand within itself is left in place.
+ */
+class FunctionDefinitionExpander
 {
-  if (node==NULL) return;
-  if (fd==NULL) return;
+public:
+  FunctionDefinitionExpander(const ListOfFunctionDefinitions* lofd,
+                             const IdList* idsToExclude)
+  {
+    for (unsigned int i = 0; i < lofd->size(); ++i)
+    {
+      addFunction(lofd->get(i), idsToExclude);
+    }
+  }
 
-  ASTNode fdMath(AST_UNKNOWN);
-  unsigned int noBvars;
+  FunctionDefinitionExpander(const FunctionDefinition* fd,
+                             const IdList* idsToExclude)
+  {
+    addFunction(fd, idsToExclude);
+  }
 
-  if (fd->isSetMath() && fd->getBody() != NULL)
+  ~FunctionDefinitionExpander()
   {
-    noBvars = fd->getMath()->getNumBvars();
-    fdMath = *fd->getBody();
+    for (size_t i = 0; i < mBodies.size(); ++i)
+    {
+      delete mBodies[i];
+    }
+  }
 
-    unsigned int nodeCount = 0;
-    for (unsigned int i = 0; i < noBvars; ++i)
+  void expand(ASTNode* math)
+  {
+    if (math == NULL || mIndices.empty())
+      return;
+
+    vector<unsigned int> calls;
+    collectCalls(math, calls);
+    if (calls.empty())
+      return;
+
+    for (size_t i = 0; i < calls.size(); ++i)
     {
-      if (nodeCount < node->getNumChildren())
+      prepare(calls[i]);
+    }
+    substitute(math);
+  }
+
+private:
+  enum State { Unvisited, InProgress, Done };
+
+  void addFunction(const FunctionDefinition* fd, const IdList* idsToExclude)
+  {
+    if (fd == NULL || fd->getBody() == NULL)
+      return;
+
+    const string& id = fd->getId();
+    if (idsToExclude != NULL && idsToExclude->contains(id))
+      return;
+
+    // a function defined twice is expanded with its first definition
+    if (mIndices.insert(make_pair(id, (unsigned int)mFDs.size())).second)
+    {
+      mFDs.push_back(fd);
+      mBodies.push_back(NULL);
+      mStates.push_back(Unvisited);
+    }
+  }
+
+  /*
+   * Returns the index of the function the node calls, or -1.
+   */
+  int getIndex(const ASTNode* node) const
+  {
+    if (!node->isFunction() || node->getName() == NULL)
+      return -1;
+
+    map<string, unsigned int>::const_iterator it = 
+      mIndices.find(node->getName());
+    return (it == mIndices.end()) ? -1 : (int)(it->second);
+  }
+
+  void collectCalls(const ASTNode* math, vector<unsigned int>& calls) const
+  {
+    vector<const ASTNode*> pending(1, math);
+    while (!pending.empty())
+    {
+      const ASTNode* node = pending.back();
+      pending.pop_back();
+
+      int index = getIndex(node);
+      if (index >= 0)
+      {
+        calls.push_back((unsigned int)index);
+      }
+      for (unsigned int i = 0; i < node->getNumChildren(); ++i)
       {
-        fdMath.replaceArgument(fd->getArgument(i)->getName(), 
-          node->getChild(nodeCount));
+        pending.push_back(node->getChild(i));
       }
-      ++nodeCount;
     }
-    (*node) = fdMath;
+  }
+
+  /*
+   * Expands the body of the given function, and before it those of all
+   * the functions it calls, depth first with an explicit stack.
+   */
+  void prepare(unsigned int index)
+  {
+    if (mStates[index] != Unvisited)
+      return;
+
+    vector<unsigned int> functions;
+    vector<vector<unsigned int> > callees;
+    vector<size_t> positions;
+
+    mStates[index] = InProgress;
+    functions.push_back(index);
+    callees.push_back(vector<unsigned int>());
+    collectCalls(mFDs[index]->getBody(), callees.back());
+    positions.push_back(0);
+
+    while (!functions.empty())
+    {
+      if (positions.back() < callees.back().size())
+      {
+        unsigned int callee = callees.back()[positions.back()++];
+        if (mStates[callee] == Unvisited)
+        {
+          mStates[callee] = InProgress;
+          functions.push_back(callee);
+          callees.push_back(vector<unsigned int>());
+          collectCalls(mFDs[callee]->getBody(), callees.back());
+          positions.push_back(0);
+        }
+      }
+      else
+      {
+        unsigned int current = functions.back();
+        mBodies[current] = mFDs[current]->getBody()->deepCopy();
+        substitute(mBodies[current]);
+        mStates[current] = Done;
+
+        functions.pop_back();
+        callees.pop_back();
+        positions.pop_back();
+      }
+    }
+  }
+
+  /*
+   * Replaces, children first, every call of a function whose body has been
+   * expanded.
+   */
+  void substitute(ASTNode* math)
+  {
+    vector<ASTNode*> nodes(1, math);
+    vector<unsigned int> next(1, 0);
+
+    while (!nodes.empty())
+    {
+      ASTNode* node = nodes.back();
+      unsigned int n = next.back();
+
+      if (n < node->getNumChildren())
+      {
+        ++next.back();
+        nodes.push_back(node->getChild(n));
+        next.push_back(0);
+        continue;
+      }
+
+      nodes.pop_back();
+      next.pop_back();
+
+      int index = getIndex(node);
+      if (index >= 0 && mStates[index] == Done)
+      {
+        ASTNode args;
+        args.swapChildren(node);
+        *node = *mBodies[index];
+        substituteArguments(node, mFDs[index], args);
+      }
+    }
+  }
+
+  map<string, unsigned int> mIndices;
+  vector<const FunctionDefinition*> mFDs;
+  vector<ASTNode*> mBodies;
+  vector<State> mStates;
+};
+
+
+void
+SBMLTransforms::replaceFD(ASTNode * node, const ListOfFunctionDefinitions *lofd, const IdList* idsToExclude /*= NULL*/)
+{
+  if ((node == NULL) || (lofd == NULL))
+    return;
+
+  FunctionDefinitionExpander expander(lofd, idsToExclude);
+  expander.expand(node);
+}
+
+
+void
+SBMLTransforms::replaceFD(const std::vector<ASTNode*>& maths, const ListOfFunctionDefinitions *lofd, const IdList* idsToExclude /*= NULL*/)
+{
+  if (lofd == NULL)
+    return;
+
+  FunctionDefinitionExpander expander(lofd, idsToExclude);
+  for (size_t i = 0; i < maths.size(); ++i)
+  {
+    expander.expand(maths[i]);
+  }
+}
+
+
+void
+SBMLTransforms::replaceFD(ASTNode * node, const FunctionDefinition *fd, const IdList* idsToExclude /*= NULL*/)
+{
+  if ((node == NULL) || (fd == NULL))
+    return;
+  
+  FunctionDefinitionExpander expander(fd, idsToExclude);
+  expander.expand(node);
+}
+
+
+void
+SBMLTransforms::replaceBvars(ASTNode * node, const FunctionDefinition *fd)
+{
+  if (node==NULL) return;
+  if (fd==NULL) return;
+
+  if (fd->isSetMath() && fd->getBody() != NULL)
+  {
+    ASTNode args;
+    args.swapChildren(node);
+    *node = *fd->getBody();
+    substituteArguments(node, fd, args);
   }
 
 }
@@ -676,60 +1050,12 @@ SBMLTransforms::evaluateASTNode(const ASTNode * node, const IdValueMap& values,
     }
 
   case AST_PLUS:
-    if (node->getNumChildren() == 0)
-    {
-      result = 0.0;
-    }
-    else if (node->getNumChildren() == 1)
-    {
-      result = evaluateASTNode(node->getChild(0), values, m);
-    }
-    else
-    {
-      result = evaluateASTNode(node->getChild(0), values, m);
-      for (unsigned int j = 1; j < node->getNumChildren(); ++j)
-      {
-        result = result + evaluateASTNode(node->getChild(j), values, m) ;
-      }
-    }
-    break;
-
   case AST_MINUS:
-    if(node->getNumChildren() == 1)
-      result = -(evaluateASTNode(node->getChild(0), values, m));
-    else
-      result = evaluateASTNode(node->getChild(0), values, m) -
-      evaluateASTNode(node->getChild(1), values, m);
-    break;
-
   case AST_TIMES:
-    if (node->getNumChildren() == 0)
-    {
-      result = 1.0;
-    }
-    else if (node->getNumChildren() == 1)
-    {
-      result = evaluateASTNode(node->getChild(0), values, m);
-    }
-    else
-    {
-      result = evaluateASTNode(node->getChild(0), values, m);
-      for (unsigned int j = 1; j < node->getNumChildren(); ++j)
-      {
-        result = result * evaluateASTNode(node->getChild(j), values, m) ;
-      }
-    }
-    break;
-
   case AST_DIVIDE:
-    result = evaluateASTNode(node->getChild(0), values, m) /
-      evaluateASTNode(node->getChild(1), values, m);
-    break;
-
   case AST_POWER:
   case AST_FUNCTION_POWER:
-    result = pow(evaluateASTNode(node->getChild(0), values, m),
-      evaluateASTNode(node->getChild(1), values, m));
+    result = evaluateArithmetic(node, values, m);
     break;
 
   case AST_FUNCTION_ABS:
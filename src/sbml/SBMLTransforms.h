@@ -65,6 +65,7 @@
 
 
 #include <string>
+#include <vector>
 
 LIBSBML_CPP_NAMESPACE_BEGIN
 
@@ -124,6 +125,10 @@ public:
    * The outcome of the function is that the ASTNode now represents
    * the math expression: s * p/q
    *
+   * Calls made within the FunctionDefinitions are expanded as well; a call
+   * that would need a FunctionDefinition to be expanded within itself is
+   * left in place.
+   *
    * @param math ASTNode representing the math to be transformed.
    *
    * @param lofd the ListOfFunctionDefinitions to be expanded.
@@ -136,6 +141,29 @@ public:
                         const IdList* idsToExclude = NULL);
 
 
+#ifndef SWIG
+  /**
+   * Expands the math represented by each of the ASTNodes to implement the
+   * functionality of all the FunctionDefinitions in the list.
+   *
+   * The result is the same as calling replaceFD() on each ASTNode in turn,
+   * but the body of each FunctionDefinition is expanded only once for all
+   * of them.
+   *
+   * @param maths the ASTNodes representing the math to be transformed.
+   *
+   * @param lofd the ListOfFunctionDefinitions to be expanded.
+   * 
+   * @param idsToExclude an optional list of function definition ids to exclude.
+   *
+   * @copydetails doc_note_static_methods
+   */
+  static void replaceFD(const std::vector<ASTNode*>& maths, 
+                        const ListOfFunctionDefinitions * lofd,
+                        const IdList* idsToExclude = NULL);
+#endif
+
+
   static bool expandInitialAssignments(Model * m);
 
 
@@ -179,9 +207,6 @@ protected:
 
   static bool expandIA(Model* m, const InitialAssignment *ia);
 
-  static void recurseReplaceFD(ASTNode * math, const FunctionDefinition * fd,
-                        const IdList* idsToExclude);
-
 
   static IdValueMap mValues;
 
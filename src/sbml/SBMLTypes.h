@@ -99,6 +99,7 @@
 #include <sbml/math/L3Parser.h>
 #include <sbml/math/L3ParserSettings.h>
 #include <sbml/math/L3FormulaFormatter.h>
+#include <sbml/math/ASTNodeDAG.h>
 
 #include <sbml/annotation/ModelHistory.h>
 #include <sbml/annotation/ModelCreator.h>
@@ -56,6 +56,7 @@
 #include <sbml/SBMLError.h>
 #include <sbml/SBMLErrorLog.h>
 #include <sbml/SBMLDocument.h>
+#include <sbml/SBMLReader.h>
 #include <sbml/Model.h>
 #include <sbml/ListOf.h>
 #include <sbml/SBase.h>
@@ -96,6 +97,154 @@ struct ClonePluginEntity
     return sb->clone();
   }
 };
+
+
+/*
+ * The annotation and notes of an object read while the parsing of
+ * annotations is deferred, kept as text together with the namespaces they
+ * use that are declared outside of them.
+ */
+class SBase::DeferredContent
+{
+public:
+  DeferredContent()
+    : annotation ()
+    , annotationNamespaces ()
+    , notes ()
+    , notesNamespaces ()
+    , hasAnnotation (false)
+    , hasNotes (false)
+    , cvTermsPending (false)
+    , historyPending (false)
+  {
+  }
+
+  bool isEmpty() const
+  {
+    return !hasAnnotation && !hasNotes && !cvTermsPending && !historyPending;
+  }
+
+  std::string   annotation;
+  XMLNamespaces annotationNamespaces;
+  std::string   notes;
+  XMLNamespaces notesNamespaces;
+  bool          hasAnnotation;
+  bool          hasNotes;
+  bool          cvTermsPending;
+  bool          historyPending;
+};
+
+
+/*
+ * Adds the namespace of the given prefix to outer unless it is declared
+ * by one of the elements in scope.
+ */
+static void
+addOuterNamespace (const string& prefix, const string& uri,
+                   const vector<XMLNamespaces>& scopes, XMLNamespaces& outer)
+{
+  if (prefix == "xml" || uri.empty())
+  {
+    return;
+  }
+
+  for (size_t i = 0; i < scopes.size(); ++i)
+  {
+    if (scopes[i].hasPrefix(prefix))
+    {
+      return;
+    }
+  }
+
+  if (!outer.hasPrefix(prefix))
+  {
+    outer.add(uri, prefix);
+  }
+}
+
+
+/*
+ * Copies the element at the front of the stream to the output stream
+ * exactly as an XMLNode read from the stream would write itself, without
+ * building the XMLNode.  The namespaces the element uses but that are
+ * declared outside of it are added to outer, so that the text can be
+ * parsed on its own later.  If rdfOnly is given, it is cleared if the
+ * element has children other than an RDF element.
+ */
+static void
+copyElement (XMLInputStream& stream, XMLOutputStream& out,
+             vector<XMLNamespaces>& scopes, XMLNamespaces& outer,
+             bool* rdfOnly)
+{
+  const XMLToken element = stream.next();
+
+  scopes.push_back(element.getNamespaces());
+  addOuterNamespace(element.getPrefix(), element.getURI(), scopes, outer);
+
+  const XMLAttributes& attributes = element.getAttributes();
+  for (int i = 0; i < attributes.getLength(); ++i)
+  {
+    if (!attributes.getPrefix(i).empty())
+    {
+      addOuterNamespace(attributes.getPrefix(i), attributes.getURI(i),
+                        scopes, outer);
+    }
+  }
+
+  out << element;
+
+  if (!element.isEnd())
+  {
+    bool haveChildren = false;
+    bool haveTextNode = false;
+
+    while (stream.isGood())
+    {
+      const XMLToken& next = stream.peek();
+
+      if (next.isStart())
+      {
+        if (rdfOnly != NULL && next.getName() != "RDF")
+        {
+          *rdfOnly = false;
+        }
+        copyElement(stream, out, scopes, outer, NULL);
+        haveChildren = true;
+      }
+      else if (next.isText())
+      {
+        if (next.getCharacters().find_first_not_of(" \t\r\n")
+            != string::npos)
+        {
+          out << stream.next();
+          haveChildren = true;
+          haveTextNode = true;
+        }
+        else
+        {
+          stream.skipText();
+        }
+      }
+      else if (next.isEnd())
+      {
+        stream.next();
+        break;
+      }
+    }
+
+    XMLTriple triple(element.getName(), element.getURI(), element.getPrefix());
+    if (haveChildren)
+    {
+      out.endElement(triple, haveTextNode);
+    }
+    else
+    {
+      out.endElement(triple);
+    }
+  }
+
+  scopes.pop_back();
+}
 /** @endcond */
 
 
@@ -180,6 +329,240 @@ SBase::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
   }
 }
 
+void
+SBase::renameSIdRefs(const map<string, string>& renames)
+{
+  if (!renamesByMap(getPackageName()))
+  {
+    // the single identifier variant also renames the plugins' references
+    vector<pair<string, string> > steps;
+    getSequentialRenames(renames, steps);
+    for (size_t n = 0; n < steps.size(); ++n)
+    {
+      renameSIdRefs(steps[n].first, steps[n].second);
+    }
+    return;
+  }
+
+  for (unsigned int p = 0; p < getNumPlugins(); p++)
+  {
+    getPlugin(p)->renameSIdRefs(renames);
+  }
+}
+
+void
+SBase::renameMetaIdRefs(const map<string, string>& renames)
+{
+  if (!renamesByMap(getPackageName()))
+  {
+    vector<pair<string, string> > steps;
+    getSequentialRenames(renames, steps);
+    for (size_t n = 0; n < steps.size(); ++n)
+    {
+      renameMetaIdRefs(steps[n].first, steps[n].second);
+    }
+    return;
+  }
+
+  for (unsigned int p = 0; p < getNumPlugins(); p++)
+  {
+    getPlugin(p)->renameMetaIdRefs(renames);
+  }
+}
+
+void
+SBase::renameUnitSIdRefs(const map<string, string>& renames)
+{
+  if (!renamesByMap(getPackageName()))
+  {
+    vector<pair<string, string> > steps;
+    getSequentialRenames(renames, steps);
+    for (size_t n = 0; n < steps.size(); ++n)
+    {
+      renameUnitSIdRefs(steps[n].first, steps[n].second);
+    }
+    return;
+  }
+
+  for (unsigned int p = 0; p < getNumPlugins(); p++)
+  {
+    getPlugin(p)->renameUnitSIdRefs(renames);
+  }
+}
+
+
+void
+SBase::renameIdRefs(const map<string, string>& sids,
+                    const map<string, string>& unitSIds,
+                    const map<string, string>& metaIds)
+{
+  if (!sids.empty())     renameSIdRefs(sids);
+  if (!unitSIds.empty()) renameUnitSIdRefs(unitSIds);
+  if (!metaIds.empty())  renameMetaIdRefs(metaIds);
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Applied one at a time, a -> b followed by b -> c would also turn a into
+ * c.  When an identifier is renamed to one that is itself renamed, every
+ * identifier is therefore first renamed to a temporary one.
+ */
+void
+SBase::getSequentialRenames(const map<string, string>& renames,
+                            vector<pair<string, string> >& steps)
+{
+  steps.clear();
+
+  bool chained = false;
+  map<string, string>::const_iterator it;
+  for (it = renames.begin(); it != renames.end(); ++it)
+  {
+    if (it->first == it->second) continue;
+
+    steps.push_back(*it);
+    if (renames.find(it->second) != renames.end())
+    {
+      chained = true;
+    }
+  }
+  if (!chained) return;
+
+  size_t count = steps.size();
+  for (size_t n = 0; n < count; ++n)
+  {
+    ostringstream temp;
+    temp << "_renaming_" << n << "_" << steps[n].first;
+    steps.push_back(make_pair(temp.str(), steps[n].second));
+    steps[n].second = temp.str();
+  }
+}
+
+
+/*
+ * The packages distributed with libSBML, in sorted order.  Their classes
+ * all override the map variants of the rename functions where they hold
+ * references, so the default implementations only need to reach the
+ * plugins.
+ */
+static const char* MAP_RENAMING_PACKAGES[] =
+{
+    "arrays"
+  , "comp"
+  , "core"
+  , "distrib"
+  , "dyn"
+  , "fbc"
+  , "groups"
+  , "l3v2extendedmath"
+  , "layout"
+  , "multi"
+  , "qual"
+  , "render"
+  , "req"
+  , "spatial"
+};
+
+
+static bool
+lessThan(const char* a, const char* b)
+{
+  return strcmp(a, b) < 0;
+}
+
+
+bool
+SBase::renamesByMap(const string& package)
+{
+  static const size_t size = 
+    sizeof(MAP_RENAMING_PACKAGES) / sizeof(MAP_RENAMING_PACKAGES[0]);
+  return binary_search(MAP_RENAMING_PACKAGES, MAP_RENAMING_PACKAGES + size,
+                       package.c_str(), lessThan);
+}
+
+
+void
+SBase::renameIdRef(string& ref, const map<string, string>& renames)
+{
+  if (ref.empty()) return;
+
+  map<string, string>::const_iterator it = renames.find(ref);
+  if (it != renames.end())
+  {
+    ref = it->second;
+  }
+}
+
+
+void
+SBase::renameSIdRefs(const map<string, string>& renames, string& ref)
+{
+  SBase::renameSIdRefs(renames);
+  renameIdRef(ref, renames);
+}
+
+
+void
+SBase::renameSIdRefs(const map<string, string>& renames,
+                     string& ref1, string& ref2)
+{
+  SBase::renameSIdRefs(renames);
+  renameIdRef(ref1, renames);
+  renameIdRef(ref2, renames);
+}
+
+
+void
+SBase::renameSIdRefs(const map<string, string>& renames,
+                     string& ref1, string& ref2, string& ref3)
+{
+  SBase::renameSIdRefs(renames);
+  renameIdRef(ref1, renames);
+  renameIdRef(ref2, renames);
+  renameIdRef(ref3, renames);
+}
+
+
+void
+SBase::renameSIdRefs(const map<string, string>& renames, ASTNode* math)
+{
+  SBase::renameSIdRefs(renames);
+  if (math != NULL)
+  {
+    math->renameSIdRefs(renames);
+  }
+}
+
+
+void
+SBase::renameSIdRefs(const map<string, string>& renames,
+                     string& ref, ASTNode* math)
+{
+  SBase::renameSIdRefs(renames, math);
+  renameIdRef(ref, renames);
+}
+
+
+void
+SBase::renameUnitSIdRefs(const map<string, string>& renames, string& ref)
+{
+  SBase::renameUnitSIdRefs(renames);
+  renameIdRef(ref, renames);
+}
+
+
+void
+SBase::renameUnitSIdRefs(const map<string, string>& renames, ASTNode* math)
+{
+  SBase::renameUnitSIdRefs(renames);
+  if (math != NULL)
+  {
+    math->renameUnitSIdRefs(renames);
+  }
+}
+/** @endcond */
+
+
 /** @cond doxygenLibsbmlInternal */
 SBase*
 SBase::getElementFromPluginsBySId(std::string id)
@@ -331,10 +714,12 @@ SBase::SBase (unsigned int level, unsigned int version) :
  , mURI("")
  , mHistoryChanged (false)
  , mCVTermsChanged (false)
+ , mDeferred (NULL)
  , mAttributesOfUnknownPkg()
  , mAttributesOfUnknownDisabledPkg()
  , mElementsOfUnknownPkg()
  , mElementsOfUnknownDisabledPkg()
+ , mSkippedElements()
 {
   mSBMLNamespaces = new SBMLNamespaces(level, version);
 
@@ -377,10 +762,12 @@ SBase::SBase (const SBMLNamespaces *sbmlns) :
  , mURI("")
  , mHistoryChanged (false)
  , mCVTermsChanged (false)
+ , mDeferred (NULL)
  , mAttributesOfUnknownPkg()
  , mAttributesOfUnknownDisabledPkg()
  , mElementsOfUnknownPkg()
  , mElementsOfUnknownDisabledPkg()
+ , mSkippedElements()
 {
   if (!sbmlns)
   {
@@ -433,17 +820,22 @@ SBase::SBase(const SBase& orig)
   , mURI(orig.mURI)
   , mHistoryChanged(orig.mHistoryChanged)
   , mCVTermsChanged(orig.mCVTermsChanged)
+  , mDeferred(NULL)
   , mAttributesOfUnknownPkg (orig.mAttributesOfUnknownPkg)
   , mAttributesOfUnknownDisabledPkg (orig.mAttributesOfUnknownDisabledPkg)
   , mElementsOfUnknownPkg (orig.mElementsOfUnknownPkg)
   , mElementsOfUnknownDisabledPkg (orig.mElementsOfUnknownDisabledPkg)
+  , mSkippedElements (orig.mSkippedElements)
 {
   if(orig.mNotes != NULL)
-    this->mNotes = new XMLNode(*const_cast<SBase&>(orig).getNotes());
+    this->mNotes = new XMLNode(*orig.mNotes);
 
   if(orig.mAnnotation != NULL)
     this->mAnnotation = new XMLNode(*const_cast<SBase&>(orig).mAnnotation);
 
+  if(orig.mDeferred != NULL)
+    this->mDeferred = new DeferredContent(*orig.mDeferred);
+
   if(orig.getSBMLNamespaces() != NULL)
     this->mSBMLNamespaces =
     new SBMLNamespaces(*const_cast<SBase&>(orig).getSBMLNamespaces());
@@ -482,6 +874,7 @@ SBase::~SBase ()
 {
   if (mNotes != NULL)       delete mNotes;
   if (mAnnotation != NULL)  delete mAnnotation;
+  if (mDeferred != NULL)    delete mDeferred;
   if (mSBMLNamespaces != NULL)  delete mSBMLNamespaces;
   if (mCVTerms != NULL)
   {
@@ -514,7 +907,7 @@ SBase& SBase::operator=(const SBase& rhs)
     delete this->mNotes;
 
     if(rhs.mNotes != NULL)
-      this->mNotes = new XMLNode(*const_cast<SBase&>(rhs).getNotes());
+      this->mNotes = new XMLNode(*rhs.mNotes);
     else
       this->mNotes = NULL;
 
@@ -535,6 +928,7 @@ SBase& SBase::operator=(const SBase& rhs)
     this->mAttributesOfUnknownDisabledPkg = rhs.mAttributesOfUnknownDisabledPkg;
     this->mElementsOfUnknownPkg = rhs.mElementsOfUnknownPkg;
     this->mElementsOfUnknownDisabledPkg = rhs.mElementsOfUnknownDisabledPkg;
+    this->mSkippedElements = rhs.mSkippedElements;
 
     delete this->mSBMLNamespaces;
 
@@ -582,6 +976,12 @@ SBase& SBase::operator=(const SBase& rhs)
     this->mHistoryChanged = rhs.mHistoryChanged;
     this->mCVTermsChanged = rhs.mCVTermsChanged;
 
+    delete this->mDeferred;
+    if (rhs.mDeferred != NULL)
+      this->mDeferred = new DeferredContent(*rhs.mDeferred);
+    else
+      this->mDeferred = NULL;
+
     for_each( mPlugins.begin(), mPlugins.end(), DeletePluginEntity() );
     mPlugins.resize( rhs.mPlugins.size() );
     transform( rhs.mPlugins.begin(), rhs.mPlugins.end(),
@@ -752,6 +1152,7 @@ SBase::getIdAttribute () const
 XMLNode*
 SBase::getNotes()
 {
+  loadDeferredNotes();
   return mNotes;
 }
 
@@ -759,6 +1160,7 @@ SBase::getNotes()
 XMLNode*
 SBase::getNotes() const
 {
+  loadDeferredNotes();
   return mNotes;
 }
 
@@ -769,6 +1171,7 @@ SBase::getNotes() const
 std::string
 SBase::getNotesString()
 {
+  loadDeferredNotes();
   return XMLNode::convertXMLNodeToString(mNotes);
 }
 
@@ -776,6 +1179,7 @@ SBase::getNotesString()
 std::string
 SBase::getNotesString() const
 {
+  loadDeferredNotes();
   return XMLNode::convertXMLNodeToString(mNotes);
 }
 
@@ -1055,12 +1459,14 @@ SBase::getColumn () const
 ModelHistory*
 SBase::getModelHistory() const
 {
+  parsePendingRDFAnnotation();
   return mHistory;
 }
 
 ModelHistory*
 SBase::getModelHistory()
 {
+  parsePendingRDFAnnotation();
   return mHistory;
 }
 
@@ -1116,7 +1522,7 @@ SBase::isSetIdAttribute () const
 bool
 SBase::isSetNotes () const
 {
-  return (mNotes != NULL);
+  return (mNotes != NULL || (mDeferred != NULL && mDeferred->hasNotes));
 }
 
 
@@ -1146,6 +1552,7 @@ SBase::isSetSBOTerm () const
 bool
 SBase::isSetModelHistory() const
 {
+  parsePendingRDFAnnotation();
   return (mHistory != NULL);
 }
 
@@ -1156,6 +1563,9 @@ SBase::isSetModelHistory() const
 int
 SBase::setMetaId (const std::string& metaid)
 {
+  // the RDF must be read against the metaid it was written for
+  parsePendingRDFAnnotation();
+
   if (getLevel() == 1)
   {
     return LIBSBML_UNEXPECTED_ATTRIBUTE;
@@ -1262,6 +1672,8 @@ SBase::setAnnotation (const XMLNode* annotation)
   //
   //
 
+  discardDeferredAnnotation();
+
   if (annotation == NULL)
   {
     delete mAnnotation;
@@ -1423,6 +1835,8 @@ SBase::appendAnnotation (const XMLNode* annotation)
   int success = LIBSBML_OPERATION_FAILED;
   unsigned int duplicates = 0;
 
+  loadDeferredAnnotation();
+
   //
   // (*NOTICE*)
   //
@@ -1573,6 +1987,7 @@ int
 SBase::removeTopLevelAnnotationElement(const std::string& elementName,
     const std::string elementURI, bool removeEmpty)
 {
+  parsePendingRDFAnnotation();
 
   int success = LIBSBML_OPERATION_FAILED;
   if (mAnnotation == NULL)
@@ -1709,6 +2124,8 @@ SBase::replaceTopLevelAnnotationElement(const std::string& annotation)
 int
 SBase::setNotes(const XMLNode* notes)
 {
+  discardDeferredNotes();
+
   if (mNotes == notes)
   {
     return LIBSBML_OPERATION_SUCCESS;
@@ -1863,6 +2280,8 @@ SBase::appendNotes(const XMLNode* notes)
     return LIBSBML_OPERATION_SUCCESS;
   }
 
+  loadDeferredNotes();
+
   const string&  name = notes->getName();
 
   // The content of notes in SBML can consist only of the following
@@ -2229,6 +2648,8 @@ SBase::appendNotes(const std::string& notes)
 int
 SBase::setModelHistory(ModelHistory * history)
 {
+  parsePendingRDFAnnotation();
+
   /* ModelHistory is only allowed on Model in L2
    * but on any element in L3
    */
@@ -2554,6 +2975,7 @@ SBase::unsetName ()
 int
 SBase::unsetNotes ()
 {
+  discardDeferredNotes();
   delete mNotes;
   mNotes = NULL;
   return LIBSBML_OPERATION_SUCCESS;
@@ -2687,6 +3109,7 @@ int SBase::addTermToExistingBag(CVTerm *term, QualifierType_t type ) const
 int
 SBase::addCVTerm(CVTerm * term, bool newBag)
 {
+  parsePendingRDFAnnotation();
   unsigned int added = 0;
   // shouldnt add a CVTerm to an object with no metaid
   if (!isSetMetaId())
@@ -2751,6 +3174,7 @@ SBase::addCVTerm(CVTerm * term, bool newBag)
 List*
 SBase::getCVTerms()
 {
+  parsePendingRDFAnnotation();
   return mCVTerms;
 }
 
@@ -2761,6 +3185,7 @@ SBase::getCVTerms()
 List*
 SBase::getCVTerms() const
 {
+  parsePendingRDFAnnotation();
   return mCVTerms;
 }
 
@@ -2773,6 +3198,7 @@ SBase::getCVTerms() const
 unsigned int
 SBase::getNumCVTerms() const
 {
+  parsePendingRDFAnnotation();
   if (mCVTerms != NULL)
   {
     return mCVTerms->getSize();
@@ -2795,6 +3221,7 @@ SBase::getNumCVTerms() const
 CVTerm*
 SBase::getCVTerm(unsigned int n)
 {
+  parsePendingRDFAnnotation();
   return (mCVTerms) ? static_cast <CVTerm*> (mCVTerms->get(n)) : NULL;
 }
 
@@ -2806,6 +3233,7 @@ SBase::getCVTerm(unsigned int n)
 int
 SBase::unsetCVTerms()
 {
+  parsePendingRDFAnnotation();
   if (mCVTerms != NULL)
   {
     unsigned int size = mCVTerms->getSize();
@@ -2825,6 +3253,7 @@ SBase::unsetCVTerms()
 int
 SBase::unsetModelHistory()
 {
+  parsePendingRDFAnnotation();
   if (mHistory != NULL)
     mHistoryChanged = true;
 
@@ -2862,6 +3291,7 @@ SBase::unsetModelHistory()
 BiolQualifierType_t
 SBase::getResourceBiologicalQualifier(std::string resource) const
 {
+  parsePendingRDFAnnotation();
   if (mCVTerms != NULL)
   {
     for (unsigned int n = 0; n < mCVTerms->getSize(); n++)
@@ -2899,6 +3329,7 @@ SBase::getResourceBiologicalQualifier(std::string resource) const
 ModelQualifierType_t
 SBase::getResourceModelQualifier(std::string resource) const
 {
+  parsePendingRDFAnnotation();
   if (mCVTerms != NULL)
   {
     for (unsigned int n = 0; n < mCVTerms->getSize(); n++)
@@ -4363,6 +4794,11 @@ SBase::read (XMLInputStream& stream)
 
   while ( stream.isGood() )
   {
+    if (isStreamingStopped())
+    {
+      break;
+    }
+
     if (CallbackRegistry::invokeCallbacks(getSBMLDocument()) != LIBSBML_OPERATION_SUCCESS)
     {
       if (getErrorLog() != NULL && !getErrorLog()->contains(OperationInterrupted))
@@ -4396,6 +4832,11 @@ SBase::read (XMLInputStream& stream)
            << stream.peek().getURI() << endl;
 #endif
 
+      if (skipFilteredElement(stream))
+      {
+        continue;
+      }
+
       SBase * object = NULL;
       try
       {
@@ -4411,6 +4852,11 @@ SBase::read (XMLInputStream& stream)
         object = createExtensionObject(stream);
       }
 
+      if (object != NULL && skipFilteredObject(object, stream))
+      {
+        continue;
+      }
+
       if (object != NULL)
       {
         checkOrderAndLogError(object, position);
@@ -4429,6 +4875,9 @@ SBase::read (XMLInputStream& stream)
           static_cast <SpeciesReference *> (object)->sortMath();
         }
         checkListOfPopulated(object);
+        storePreservedListOf(object);
+
+        streamObject(object);
       }
       else if ( !( storeUnknownExtElement(stream)
                    || readOtherXML(stream)
@@ -4496,9 +4945,31 @@ SBase::write (XMLOutputStream& stream) const
  * SBML objects as XML elements.  Be sure to call your parent's
  * implementation of this method as well.
  */
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Writes the elements kept by an SBMLReader that preserves what it skips:
+ * either only the math, or everything but the math.
+ */
+static void
+writeSkippedElements (XMLOutputStream& stream, const XMLNode& skipped,
+                      bool math)
+{
+  for (unsigned int i = 0; i < skipped.getNumChildren(); ++i)
+  {
+    const XMLNode& child = skipped.getChild(i);
+    if ((child.getName() == "math") == math)
+    {
+      stream << child;
+    }
+  }
+}
+/** @endcond */
+
+
 void
 SBase::writeElements (XMLOutputStream& stream) const
 {
+  loadDeferredNotes();
   if (mNotes != NULL)
   {
     mNotes->writeToStream(stream);
@@ -4510,6 +4981,9 @@ SBase::writeElements (XMLOutputStream& stream) const
 
   const_cast <SBase *> (this)->syncAnnotation();
   if (mAnnotation != NULL) stream << *mAnnotation;
+
+  // preserved math precedes the other children of every element with math
+  writeSkippedElements(stream, mSkippedElements, true);
 }
 
 void
@@ -4522,6 +4996,11 @@ SBase::writeExtensionElements (XMLOutputStream& stream) const
    * ----------------------------------------------------------
    */
 
+  //
+  // writes elements skipped and preserved by the SBMLReader
+  //
+  writeSkippedElements(stream, mSkippedElements, false);
+
   for (size_t i=0; i < mPlugins.size(); i++)
   {
     mPlugins[i]->writeElements(stream);
@@ -4666,7 +5145,7 @@ SBase::readAnnotation (XMLInputStream& stream)
     // If an annotation already exists, log it as an error and replace
     // the content of the existing annotation with the new one.
 
-    if (mAnnotation != NULL)
+    if (mAnnotation != NULL || hasDeferredAnnotation())
     {
       string msg = "An SBML <" + getElementName() + "> element ";
       switch(getTypeCode()) {
@@ -4696,6 +5175,21 @@ SBase::readAnnotation (XMLInputStream& stream)
     }
 
     delete mAnnotation;
+    mAnnotation = NULL;
+    if (readDeferredAnnotation(stream,
+                               getLevel() > 2 && getTypeCode() != SBML_MODEL))
+    {
+      // a deferred annotation has only been parsed if the plugins need it
+      if (mAnnotation != NULL)
+      {
+        for (size_t i=0; i < mPlugins.size(); i++)
+        {
+          mPlugins[i]->parseAnnotation(this, mAnnotation);
+        }
+      }
+      return true;
+    }
+
     mAnnotation = new XMLNode(stream);
     checkAnnotation();
     if(mCVTerms != NULL)
@@ -4794,7 +5288,7 @@ SBase::readNotes (XMLInputStream& stream)
     // If an annotation element already exists, then the ordering is wrong.
     // In either case, replace existing content with the new notes read.
 
-    if (mNotes != NULL)
+    if (isSetNotes())
     {
       if (getLevel() < 3)
       {
@@ -4807,7 +5301,7 @@ SBase::readNotes (XMLInputStream& stream)
         logError(OnlyOneNotesElementAllowed, getLevel(), getVersion());
       }
     }
-    else if (mAnnotation != NULL)
+    else if (mAnnotation != NULL || hasDeferredAnnotation())
     {
       logError(NotSchemaConformant, getLevel(), getVersion(),
                "Incorrect ordering of <annotation> and <notes> elements -- "
@@ -4816,27 +5310,54 @@ SBase::readNotes (XMLInputStream& stream)
     }
 
     delete mNotes;
-    mNotes = new XMLNode(stream);
-
-    //
-    // checks if the given default namespace (if any) is a valid
-    // SBML namespace
-    //
-    const XMLNamespaces &xmlns = mNotes->getNamespaces();
-    checkDefaultNamespace(&xmlns,"notes");
+    mNotes = NULL;
 
-    if (getSBMLDocument() != NULL && getSBMLDocument()->getNumErrors() == 0)
+    if (isAnnotationParsingDeferred())
     {
-      checkXHTML(mNotes);
+      ostringstream text;
+      XMLOutputStream out(text, "UTF-8", false);
+      vector<XMLNamespaces> scopes;
+
+      if (mDeferred == NULL)
+      {
+        mDeferred = new DeferredContent();
+      }
+      mDeferred->notesNamespaces.clear();
+      copyElement(stream, out, scopes, mDeferred->notesNamespaces, NULL);
+      mDeferred->notes = text.str();
+      mDeferred->hasNotes = true;
+      return true;
     }
+
+    mNotes = new XMLNode(stream);
+    checkNotes();
     return true;
   }
 
   return false;
 }
 
-bool
-SBase::getHasBeenDeleted() const
+/*
+ * Checks the notes just read.
+ */
+void
+SBase::checkNotes()
+{
+  //
+  // checks if the given default namespace (if any) is a valid
+  // SBML namespace
+  //
+  const XMLNamespaces &xmlns = mNotes->getNamespaces();
+  checkDefaultNamespace(&xmlns,"notes");
+
+  if (getSBMLDocument() != NULL && getSBMLDocument()->getNumErrors() == 0)
+  {
+    checkXHTML(mNotes);
+  }
+}
+
+bool
+SBase::getHasBeenDeleted() const
 {
   return mHasBeenDeleted;
 }
@@ -5859,6 +6380,7 @@ SBase::hasOptionalElements() const
 
   if (isSetNotes() == true)  hasElements = true;
   if (isSetAnnotation() == true) hasElements = true;
+  if (mSkippedElements.getNumChildren() > 0) hasElements = true;
 
   return hasElements;
 }
@@ -5873,16 +6395,28 @@ SBase::hasOptionalElements() const
 void
 SBase::syncAnnotation ()
 {
+  loadDeferredAnnotation();
+
+  // RDF that has not been parsed yet cannot have been modified, in which
+  // case the stored annotation is written as it was read
+  if (mHistoryChanged || mCVTermsChanged)
+  {
+    parsePendingRDFAnnotation();
+  }
+
+  bool historyPending = (mDeferred != NULL && mDeferred->historyPending);
+  bool cvTermsPending = (mDeferred != NULL && mDeferred->cvTermsPending);
+
   // look to see whether an existing history has been altered
-  if (!mHistoryChanged
-      && getModelHistory() != NULL
-      && getModelHistory()->hasBeenModified()
+  if (!mHistoryChanged && !historyPending
+      && mHistory != NULL
+      && mHistory->hasBeenModified()
       )
   {
     mHistoryChanged = true;
   }
   // or an existing CVTerm
-  if (mCVTermsChanged == false)
+  if (mCVTermsChanged == false && cvTermsPending == false)
   {
     for (unsigned int i = 0; i < getNumCVTerms(); i++)
     {
@@ -5933,6 +6467,429 @@ SBase::syncAnnotation ()
 /** @endcond */
 
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * @return @c true if the annotations and notes being read are to be
+ * parsed on first access only.
+ */
+bool
+SBase::isAnnotationParsingDeferred() const
+{
+  const SBMLDocument* doc = getSBMLDocument();
+  return (doc != NULL && doc->mReader != NULL 
+          && doc->mReader->getDeferAnnotationParsing());
+}
+
+
+/*
+ * Reads the annotation at the front of the stream as text if the parsing
+ * of annotations is deferred.
+ */
+bool
+SBase::readDeferredAnnotation(XMLInputStream& stream, bool history)
+{
+  if (!isAnnotationParsingDeferred())
+  {
+    return false;
+  }
+
+  ostringstream text;
+  XMLOutputStream out(text, "UTF-8", false);
+  vector<XMLNamespaces> scopes;
+  bool rdfOnly = true;
+
+  if (mDeferred == NULL)
+  {
+    mDeferred = new DeferredContent();
+  }
+  mDeferred->annotationNamespaces.clear();
+  copyElement(stream, out, scopes, mDeferred->annotationNamespaces, &rdfOnly);
+  mDeferred->annotation = text.str();
+  mDeferred->hasAnnotation = true;
+
+  if (mCVTerms != NULL)
+  {
+    unsigned int size = mCVTerms->getSize();
+    while (size--) delete static_cast<CVTerm*>( mCVTerms->remove(0) );
+    delete mCVTerms;
+  }
+  mCVTerms = new List();
+  mDeferred->cvTermsPending = true;
+
+  if (history)
+  {
+    delete mHistory;
+    mHistory = NULL;
+    mDeferred->historyPending = true;
+  }
+
+  // the plugins look for their own elements in the annotation, so these
+  // cannot wait
+  if (!mPlugins.empty() && !rdfOnly)
+  {
+    loadDeferredAnnotation();
+  }
+
+  return true;
+}
+
+
+bool
+SBase::hasDeferredAnnotation() const
+{
+  return (mDeferred != NULL && mDeferred->hasAnnotation);
+}
+
+
+/*
+ * Turns the annotation read as text into mAnnotation.
+ */
+void
+SBase::loadDeferredAnnotation() const
+{
+  if (!hasDeferredAnnotation()) return;
+
+  SBase* self = const_cast<SBase*>(this);
+  delete mAnnotation;
+  self->mAnnotation = XMLNode::convertStringToXMLNode(mDeferred->annotation,
+                                          &(mDeferred->annotationNamespaces));
+
+  mDeferred->annotation.clear();
+  mDeferred->annotationNamespaces.clear();
+  mDeferred->hasAnnotation = false;
+  if (mDeferred->isEmpty())
+  {
+    delete mDeferred;
+    self->mDeferred = NULL;
+  }
+
+  self->checkAnnotation();
+}
+
+
+/*
+ * Turns the notes read as text into mNotes.
+ */
+void
+SBase::loadDeferredNotes() const
+{
+  if (mDeferred == NULL || !mDeferred->hasNotes) return;
+
+  SBase* self = const_cast<SBase*>(this);
+  delete mNotes;
+  self->mNotes = XMLNode::convertStringToXMLNode(mDeferred->notes,
+                                          &(mDeferred->notesNamespaces));
+
+  mDeferred->notes.clear();
+  mDeferred->notesNamespaces.clear();
+  mDeferred->hasNotes = false;
+  if (mDeferred->isEmpty())
+  {
+    delete mDeferred;
+    self->mDeferred = NULL;
+  }
+
+  if (mNotes != NULL)
+  {
+    self->checkNotes();
+  }
+}
+
+
+void
+SBase::discardDeferredAnnotation()
+{
+  if (mDeferred == NULL) return;
+
+  mDeferred->annotation.clear();
+  mDeferred->annotationNamespaces.clear();
+  mDeferred->hasAnnotation = false;
+  mDeferred->cvTermsPending = false;
+  mDeferred->historyPending = false;
+  if (mDeferred->isEmpty())
+  {
+    delete mDeferred;
+    mDeferred = NULL;
+  }
+}
+
+
+void
+SBase::discardDeferredNotes()
+{
+  if (mDeferred == NULL) return;
+
+  mDeferred->notes.clear();
+  mDeferred->notesNamespaces.clear();
+  mDeferred->hasNotes = false;
+  if (mDeferred->isEmpty())
+  {
+    delete mDeferred;
+    mDeferred = NULL;
+  }
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Skips the next element of the stream if the SBMLReader reading the
+ * document has been told to ignore elements of its name or namespace.
+ */
+bool
+SBase::skipFilteredElement(XMLInputStream& stream)
+{
+  const SBMLDocument* doc = getSBMLDocument();
+  if (doc == NULL || doc->mReader == NULL)
+  {
+    return false;
+  }
+
+  // members of a ListOf whose name is already known to belong to a
+  // skipped type are skipped without creating an object for them
+  if (!doc->mReader->isSkipped(stream.peek())
+    && !(getTypeCode() == SBML_LIST_OF
+         && doc->mReader->isSkipped(stream.peek(), this)))
+  {
+    return false;
+  }
+
+  if (!doc->mReader->getPreserveSkippedElements())
+  {
+    stream.skipPastEnd(stream.next());
+    return true;
+  }
+
+  const string& name = stream.peek().getName();
+  if (name == "notes")
+  {
+    discardDeferredNotes();
+    delete mNotes;
+    mNotes = new XMLNode(stream);
+  }
+  else if (name == "annotation" || name == "annotations")
+  {
+    discardDeferredAnnotation();
+    delete mAnnotation;
+    mAnnotation = new XMLNode(stream);
+  }
+  else
+  {
+    mSkippedElements.addChild(XMLNode(stream));
+  }
+
+  return true;
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Skips the element just created as the given object if the SBMLReader
+ * reading the document has been told to ignore objects of its type.
+ */
+bool
+SBase::skipFilteredObject(SBase* object, XMLInputStream& stream)
+{
+  const SBMLDocument* doc = getSBMLDocument();
+  if (doc == NULL || doc->mReader == NULL)
+  {
+    return false;
+  }
+
+  // only the members of a ListOf are owned by their container and can be
+  // dropped again
+  if (getTypeCode() != SBML_LIST_OF)
+  {
+    return false;
+  }
+
+  ListOf* list = static_cast<ListOf*>(this);
+  if (list->size() == 0 || list->get(list->size() - 1) != object)
+  {
+    return false;
+  }
+
+  if (!doc->mReader->isSkipped(object, stream.peek(), this))
+  {
+    return false;
+  }
+
+  delete list->remove(list->size() - 1);
+
+  if (doc->mReader->getPreserveSkippedElements())
+  {
+    mSkippedElements.addChild(XMLNode(stream));
+  }
+  else
+  {
+    stream.skipPastEnd(stream.next());
+  }
+
+  return true;
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Before L3V2 an empty ListOf is not written out.  A package ListOf whose
+ * members were all skipped and preserved is therefore kept as XML on this
+ * object; the core objects write such lists themselves.
+ */
+void
+SBase::storePreservedListOf(SBase* object)
+{
+  if (object->getTypeCode() != SBML_LIST_OF
+    || object->getPackageName() == "core"
+    || getLevel() > 3 || (getLevel() == 3 && getVersion() > 1))
+  {
+    return;
+  }
+
+  ListOf* list = static_cast<ListOf*>(object);
+  if (list->size() > 0 || !list->hasPreservedElements())
+  {
+    return;
+  }
+
+  XMLNode* node = list->toXMLNode();
+  if (node != NULL)
+  {
+    mSkippedElements.addChild(*node);
+    delete node;
+    object->mSkippedElements.removeChildren();
+  }
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Hands the ListOf member just read to the visitor of the streaming read
+ * in progress and discards it.
+ */
+bool
+SBase::streamObject(SBase* object)
+{
+  const SBMLDocument* doc = getSBMLDocument();
+  if (doc == NULL || doc->mReader == NULL 
+    || doc->mReader->getStreamingVisitor() == NULL)
+  {
+    return false;
+  }
+
+  // only the components of the model itself are streamed; anything below
+  // them is handed over as part of its component
+  if (getTypeCode() != SBML_LIST_OF || getParentSBMLObject() == NULL
+    || getParentSBMLObject() != doc->getModel())
+  {
+    return false;
+  }
+
+  ListOf* list = static_cast<ListOf*>(this);
+  if (list->size() == 0 || list->get(list->size() - 1) != object)
+  {
+    return false;
+  }
+
+  object->accept(*doc->mReader->getStreamingVisitor());
+
+  delete list->remove(list->size() - 1);
+
+  return true;
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * @return @c true if stopStreaming() was called on the SBMLReader reading
+ * the document.
+ */
+bool
+SBase::isStreamingStopped() const
+{
+  const SBMLDocument* doc = getSBMLDocument();
+  return (doc != NULL && doc->mReader != NULL 
+          && doc->mReader->isStreamingStopped());
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Parses the CVTerms and ModelHistory of the annotation if this was
+ * deferred when the annotation was read.
+ */
+void
+SBase::parsePendingRDFAnnotation() const
+{
+  if (mDeferred == NULL
+    || (!mDeferred->cvTermsPending && !mDeferred->historyPending)) return;
+
+  loadDeferredAnnotation();
+
+  SBase* self = const_cast<SBase*>(this);
+  bool parseHistory = mDeferred->historyPending;
+  bool parseCVTerms = mDeferred->cvTermsPending;
+  mDeferred->historyPending = false;
+  mDeferred->cvTermsPending = false;
+  if (mDeferred->isEmpty())
+  {
+    delete mDeferred;
+    self->mDeferred = NULL;
+  }
+
+  if (mAnnotation == NULL) return;
+
+  if (parseHistory
+    && RDFAnnotationParser::hasHistoryRDFAnnotation(mAnnotation))
+  {
+    delete mHistory;
+    self->mHistory = RDFAnnotationParser::parseRDFAnnotation(mAnnotation,
+                                                    getMetaId().c_str());
+    if (mHistory != NULL && mHistory->hasRequiredAttributes() == false)
+    {
+      self->logError(RDFNotCompleteModelHistory, getLevel(), getVersion(),
+        "An invalid ModelHistory element has been stored.");
+    }
+  }
+
+  if (parseCVTerms
+    && RDFAnnotationParser::hasCVTermRDFAnnotation(mAnnotation))
+  {
+    if (mCVTerms == NULL)
+    {
+      self->mCVTerms = new List();
+    }
+    RDFAnnotationParser::parseRDFAnnotation(mAnnotation, mCVTerms,
+                                            getMetaId().c_str());
+
+    bool hasNestedTerms = false;
+    for (unsigned int cv = 0; cv < mCVTerms->getSize(); cv++)
+    {
+      CVTerm * term = (CVTerm *)(mCVTerms->get(cv));
+      if (term->getNumNestedCVTerms() > 0)
+      {
+        hasNestedTerms = true;
+        term->setHasBeenModifiedFlag();
+      }
+    }
+
+    unsigned int level = getLevel();
+    unsigned int version = getVersion();
+    if (hasNestedTerms == true
+      && (level < 2 || (level == 2 && version < 5) || level == 3))
+    {
+      self->logError(NestedAnnotationNotAllowed, level, version,
+        "The nested annotation has been stored but will not be written out.");
+    }
+  }
+}
+/** @endcond */
+
+
 /** @cond doxygenLibsbmlInternal */
 void
 SBase::reconstructRDFAnnotation()
@@ -6311,6 +7268,23 @@ SBase::checkListOfPopulated(SBase* object)
   //        This function may need to be extented for other elements
   //        defined in each package extension.
   //
+  if (object->getTypeCode() == SBML_LIST_OF &&
+    static_cast <ListOf*> (object)->size() == 0)
+  {
+    // a list emptied because the reader skips its members, or hands them
+    // to the visitor of a streaming read, is not an error
+    SBMLDocument* doc = getSBMLDocument();
+    if (doc != NULL && doc->mReader != NULL &&
+      (doc->mReader->isSkippedType(
+        static_cast <ListOf*> (object)->getItemTypeCode(),
+        object->getPackageName()) ||
+      (doc->mReader->getStreamingVisitor() != NULL &&
+        this == doc->getModel())))
+    {
+      return;
+    }
+  }
+
   if (object->getPackageName() != "core" &&
     object->getTypeCode() == SBML_LIST_OF)
   {
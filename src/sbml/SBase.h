@@ -167,6 +167,9 @@
 #include <string>
 #include <stdexcept>
 #include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
 
 LIBSBML_CPP_NAMESPACE_BEGIN
 
@@ -306,6 +309,84 @@ public:
   virtual void renameUnitSIdRefs(const std::string& oldid, const std::string& newid);
 
 
+#ifndef SWIG
+  /**
+   * Replaces all uses of a set of SId values in this object at once.
+   *
+   * Every SIdRef of this object (and of its plugins) is looked up in
+   * @p renames and replaced by the value it maps to, if any.  The renames
+   * are applied simultaneously, so an identifier that is renamed to an
+   * identifier that is itself being renamed is not renamed twice.
+   *
+   * The libSBML classes override this function to look each of their
+   * references up once.  For objects of packages that are not part of
+   * libSBML, the default implementation instead calls
+   * renameSIdRefs(const std::string& oldid, const std::string& newid)
+   * once for each rename, so classes that only override that function
+   * are still renamed correctly, only more slowly.
+   *
+   * @param renames a map from old to new SId values.
+   */
+  virtual void renameSIdRefs(const std::map<std::string, std::string>& renames);
+
+
+  /**
+   * Replaces all uses of a set of meta identifiers in this object at once.
+   *
+   * @param renames a map from old to new meta identifiers.
+   *
+   * @see renameSIdRefs(const std::map<std::string, std::string>& renames)
+   */
+  virtual void renameMetaIdRefs(const std::map<std::string, std::string>& renames);
+
+
+  /**
+   * Replaces all uses of a set of UnitSId values in this object at once.
+   *
+   * @param renames a map from old to new UnitSId values.
+   *
+   * @see renameSIdRefs(const std::map<std::string, std::string>& renames)
+   */
+  virtual void renameUnitSIdRefs(const std::map<std::string, std::string>& renames);
+
+
+  /**
+   * Replaces all uses of a set of identifiers in this object at once.
+   *
+   * This calls the map variants of renameSIdRefs(), renameUnitSIdRefs()
+   * and renameMetaIdRefs(), each of which examines this object once,
+   * whatever the number of renames.
+   *
+   * @param sids a map from old to new SId values.
+   * @param unitSIds a map from old to new UnitSId values.
+   * @param metaIds a map from old to new meta identifiers.
+   */
+  void renameIdRefs(const std::map<std::string, std::string>& sids,
+                    const std::map<std::string, std::string>& unitSIds,
+                    const std::map<std::string, std::string>& metaIds);
+
+
+  /** @cond doxygenLibsbmlInternal */
+  /**
+   * Lists the single renames that have the effect of @p renames when they
+   * are applied one after the other; used by the map variants of
+   * renameSIdRefs() and its siblings for objects that only override the
+   * single identifier variants.
+   */
+  static void getSequentialRenames(
+    const std::map<std::string, std::string>& renames,
+    std::vector<std::pair<std::string, std::string> >& steps);
+
+
+  /**
+   * Returns @c true if the objects and plugins of @p package rename their
+   * references with the map variants of renameSIdRefs() and its siblings.
+   */
+  static bool renamesByMap(const std::string& package);
+  /** @endcond */
+#endif
+
+
   /** @cond doxygenLibsbmlInternal */
   /**
    * If this object has a child 'math' object (or anything with ASTNodes in
@@ -3273,6 +3354,48 @@ protected:
   bool matchesCoreSBMLNamespace(const SBase * sb);
 
   bool matchesCoreSBMLNamespace(const SBase * sb) const;
+
+#ifndef SWIG
+  /**
+   * Replaces the identifier reference @p ref by the value @p renames maps
+   * it to, if any; used by the map variants of renameSIdRefs() and its
+   * siblings.
+   */
+  static void renameIdRef(std::string& ref,
+                          const std::map<std::string, std::string>& renames);
+
+
+  /**
+   * Renames the references of the plugins of this object and then the
+   * given references of the object itself:  the body of most overrides of
+   * the map variant of renameSIdRefs().
+   */
+  void renameSIdRefs(const std::map<std::string, std::string>& renames,
+                     std::string& ref);
+
+  void renameSIdRefs(const std::map<std::string, std::string>& renames,
+                     std::string& ref1, std::string& ref2);
+
+  void renameSIdRefs(const std::map<std::string, std::string>& renames,
+                     std::string& ref1, std::string& ref2, std::string& ref3);
+
+  void renameSIdRefs(const std::map<std::string, std::string>& renames,
+                     ASTNode* math);
+
+  void renameSIdRefs(const std::map<std::string, std::string>& renames,
+                     std::string& ref, ASTNode* math);
+
+
+  /**
+   * Renames the unit references of the plugins of this object and then the
+   * given references of the object itself.
+   */
+  void renameUnitSIdRefs(const std::map<std::string, std::string>& renames,
+                         std::string& ref);
+
+  void renameUnitSIdRefs(const std::map<std::string, std::string>& renames,
+                         ASTNode* math);
+#endif
   
   /**
    * Creates a new SBase object with the given SBML level, version.
@@ -3466,6 +3589,106 @@ protected:
   void reconstructRDFAnnotation();
 
 
+  /**
+   * Returns @c true if the document this object is being read into has
+   * been told to keep annotations and notes unparsed until they are first
+   * accessed (see SBMLReader::setDeferAnnotationParsing()).
+   */
+  bool isAnnotationParsingDeferred() const;
+
+
+  /**
+   * Reads the annotation at the front of the stream as text, to be turned
+   * into an XMLNode on first access, if the document this object is being
+   * read into defers the parsing of annotations.  The CVTerms, and the
+   * ModelHistory if @p history is @c true, are then parsed on first access
+   * as well.
+   *
+   * @return @c true if the annotation was read, @c false if the parsing
+   * of annotations is not deferred, in which case nothing is read.
+   */
+  bool readDeferredAnnotation(XMLInputStream& stream, bool history);
+
+
+  /**
+   * Predicate returning @c true if this object holds an annotation read as
+   * text that has not been turned into an XMLNode yet.
+   */
+  bool hasDeferredAnnotation() const;
+
+
+  /**
+   * Turns the annotation read as text into mAnnotation, and checks it as
+   * it would have been checked while reading.  Every method that accesses
+   * mAnnotation calls this first.
+   */
+  void loadDeferredAnnotation() const;
+
+
+  /**
+   * Turns the notes read as text into mNotes, and checks them as they
+   * would have been checked while reading.  Every method that accesses
+   * mNotes calls this first.
+   */
+  void loadDeferredNotes() const;
+
+
+  /**
+   * Parses the CVTerms and ModelHistory of the annotation of this object
+   * if this was deferred when the annotation was read.  Every method
+   * that accesses mCVTerms or mHistory calls this first.
+   */
+  void parsePendingRDFAnnotation() const;
+
+
+  /**
+   * Skips (or stores, if requested) the next element of the stream if the
+   * SBMLReader reading the document has been told to ignore it because of
+   * its name or namespace.
+   *
+   * @return @c true if the element was consumed.
+   */
+  bool skipFilteredElement(XMLInputStream& stream);
+
+
+  /**
+   * Skips (or stores, if requested) the element for which the given
+   * ListOf member has just been created if the SBMLReader reading the
+   * document has been told to ignore objects of its type.  The object is
+   * removed from this ListOf and deleted.
+   *
+   * @return @c true if the element was consumed.
+   */
+  bool skipFilteredObject(SBase* object, XMLInputStream& stream);
+
+
+  /**
+   * Stores the given package ListOf, which has just been read, as XML on
+   * this object if all its members were skipped and preserved and the
+   * document is of a level and version before SBML Level&nbsp;3
+   * Version&nbsp;2, where an empty ListOf is not written out.
+   */
+  void storePreservedListOf(SBase* object);
+
+
+  /**
+   * Hands the given ListOf member, which has just been read, to the visitor
+   * of the streaming read in progress if this ListOf belongs to the model
+   * of the document.  The object is removed from this ListOf and deleted
+   * afterwards.
+   *
+   * @return @c true if the object was handed to the visitor.
+   */
+  bool streamObject(SBase* object);
+
+
+  /**
+   * Predicate returning @c true if the streaming read of the document has
+   * been ended from within its visitor.
+   */
+  bool isStreamingStopped() const;
+
+
   /**
    * Checks that the SBML element appears in the expected order.
    *
@@ -3752,6 +3975,14 @@ SBase.readExtensionAttributes(attributes, expectedAttributes);
   bool            mHistoryChanged;
   bool            mCVTermsChanged;
 
+  //
+  // the annotation and notes read as text, and whether the CVTerms and
+  // ModelHistory have still to be parsed from the annotation (see
+  // SBMLReader::setDeferAnnotationParsing); NULL when nothing is pending
+  //
+  class DeferredContent;
+  DeferredContent* mDeferred;
+
   //
   // XMLAttributes object containing attributes of unknown packages
   //
@@ -3764,6 +3995,12 @@ SBase.readExtensionAttributes(attributes, expectedAttributes);
   XMLNode       mElementsOfUnknownPkg;
   XMLNode       mElementsOfUnknownDisabledPkg;
 
+  //
+  // XMLNode object containing elements skipped while reading
+  // (see SBMLReader::setPreserveSkippedElements)
+  //
+  XMLNode       mSkippedElements;
+
   //-----------------------------------------------------------------------------
 
   
@@ -3806,6 +4043,26 @@ private:
   bool readNotes (XMLInputStream& stream);
 
 
+  /**
+   * Checks the namespace and XHTML content of the notes just read (or
+   * just built from the text they were read as).
+   */
+  void checkNotes();
+
+
+  /**
+   * Drops the annotation read as text, and the CVTerms and ModelHistory
+   * still to be parsed from it, when the annotation is replaced.
+   */
+  void discardDeferredAnnotation();
+
+
+  /**
+   * Drops the notes read as text when the notes are replaced.
+   */
+  void discardDeferredNotes();
+
+
   /** @endcond */
 };
 
@@ -376,6 +376,13 @@ SimpleSpeciesReference::renameSIdRefs(const std::string& oldid, const std::strin
   }
 }
 
+
+void
+SimpleSpeciesReference::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mSpecies);
+}
+
 /** @cond doxygenLibsbmlInternal */
 bool 
 SimpleSpeciesReference::hasRequiredAttributes() const
@@ -1734,6 +1734,13 @@ Species::renameSIdRefs(const std::string& oldid, const std::string& newid)
   }
 }
 
+
+void
+Species::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mSpeciesType, mCompartment, mConversionFactor);
+}
+
 void 
 Species::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
 {
@@ -1746,6 +1753,15 @@ Species::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
   }
 }
 
+
+void 
+Species::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameUnitSIdRefs(renames);
+  renameIdRef(mSubstanceUnits, renames);
+  renameIdRef(mSpatialSizeUnits, renames);
+}
+
 /** @cond doxygenLibsbmlInternal */
 /**
  * Subclasses should override this method to get the list of
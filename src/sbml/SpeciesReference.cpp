@@ -1181,7 +1181,7 @@ SpeciesReference::readOtherXML (XMLInputStream& stream)
   if (name == "annotation")
   {
     // if annotation already exists then it is an error 
-    if (mAnnotation != NULL)
+    if (mAnnotation != NULL || hasDeferredAnnotation())
     {
       if (getLevel() < 3) 
       {
@@ -1200,33 +1200,37 @@ SpeciesReference::readOtherXML (XMLInputStream& stream)
       }
     }
     delete mAnnotation;
-    mAnnotation = new XMLNode(stream);
-    checkAnnotation();
-    if (mCVTerms != NULL)
+    mAnnotation = NULL;
+    if (!readDeferredAnnotation(stream, true))
     {
-      unsigned int size = mCVTerms->getSize();
-      while (size--) delete static_cast<CVTerm*>( mCVTerms->remove(0) );
-      delete mCVTerms;
-    }
-    mCVTerms = new List();
-    delete mHistory;
-    if (RDFAnnotationParser::hasHistoryRDFAnnotation(mAnnotation))
-    {
-      mHistory = RDFAnnotationParser::parseRDFAnnotation(mAnnotation, 
-                                            getMetaId().c_str(), &(stream));
-
-      if (mHistory != NULL && mHistory->hasRequiredAttributes() == false)
+      mAnnotation = new XMLNode(stream);
+      checkAnnotation();
+      if (mCVTerms != NULL)
       {
-        logError(RDFNotCompleteModelHistory, getLevel(), getVersion(),
-          "An invalid ModelHistory element has been stored.");
+        unsigned int size = mCVTerms->getSize();
+        while (size--) delete static_cast<CVTerm*>( mCVTerms->remove(0) );
+        delete mCVTerms;
       }
-      setModelHistory(mHistory);
+      mCVTerms = new List();
+      delete mHistory;
+      if (RDFAnnotationParser::hasHistoryRDFAnnotation(mAnnotation))
+      {
+        mHistory = RDFAnnotationParser::parseRDFAnnotation(mAnnotation,
+                                              getMetaId().c_str(), &(stream));
+
+        if (mHistory != NULL && mHistory->hasRequiredAttributes() == false)
+        {
+          logError(RDFNotCompleteModelHistory, getLevel(), getVersion(),
+            "An invalid ModelHistory element has been stored.");
+        }
+        setModelHistory(mHistory);
+      }
+      else
+        mHistory = NULL;
+      if (RDFAnnotationParser::hasCVTermRDFAnnotation(mAnnotation))
+        RDFAnnotationParser::parseRDFAnnotation(mAnnotation, mCVTerms,
+                                                 getMetaId().c_str(), &(stream));
     }
-    else
-      mHistory = NULL;
-    if (RDFAnnotationParser::hasCVTermRDFAnnotation(mAnnotation))
-      RDFAnnotationParser::parseRDFAnnotation(mAnnotation, mCVTerms, 
-                                               getMetaId().c_str(), &(stream));
 
     read = true;
   }
@@ -1452,6 +1456,7 @@ SpeciesReference::writeAttributes (XMLOutputStream& stream) const
 void
 SpeciesReference::writeElements (XMLOutputStream& stream) const
 {
+  loadDeferredNotes();
   if (mNotes != NULL)
   {
     mNotes->writeToStream(stream);
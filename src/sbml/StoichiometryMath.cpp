@@ -278,6 +278,13 @@ StoichiometryMath::renameSIdRefs(const std::string& oldid, const std::string& ne
   }
 }
 
+
+void
+StoichiometryMath::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mMath);
+}
+
 void 
 StoichiometryMath::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
 {
@@ -287,6 +294,13 @@ StoichiometryMath::renameUnitSIdRefs(const std::string& oldid, const std::string
   }
 }
 
+
+void 
+StoichiometryMath::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameUnitSIdRefs(renames, mMath);
+}
+
 /** @cond doxygenLibsbmlInternal */
 void 
 StoichiometryMath::replaceSIDWithFunction(const std::string& id, const ASTNode* function)
@@ -686,6 +686,13 @@ Trigger::renameSIdRefs(const std::string& oldid, const std::string& newid)
   }
 }
 
+
+void
+Trigger::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mMath);
+}
+
 void 
 Trigger::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
 {
@@ -695,6 +702,13 @@ Trigger::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
   }
 }
 
+
+void 
+Trigger::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameUnitSIdRefs(renames, mMath);
+}
+
 /** @cond doxygenLibsbmlInternal */
 void 
 Trigger::replaceSIDWithFunction(const std::string& id, const ASTNode* function)
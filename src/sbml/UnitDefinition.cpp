@@ -2141,7 +2141,8 @@ UnitDefinition::writeElements (XMLOutputStream& stream) const
   else
   {
     // use original code
-    if ( getNumUnits() > 0 ) mUnits.write(stream);
+    if ( getNumUnits() > 0 || mUnits.hasPreservedElements() )
+      mUnits.write(stream);
   }
 
   //
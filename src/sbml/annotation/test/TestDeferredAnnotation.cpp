@@ -0,0 +1,369 @@
+/**
+ * @file TestDeferredAnnotation.cpp
+ * @brief Tests for reading annotations with deferred RDF parsing
+ * @author SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML. Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ * 3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ * Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation. A copy of the license agreement is provided in the
+ * file named "LICENSE.txt" included with this software distribution and also
+ * available online as http://sbml.org/software/libsbml/license.html
+ * ------------------------------------------------------------------------ -->
+ */
+
+#include <sbml/common/common.h>
+#include <sbml/common/extern.h>
+
+#include <sbml/SBMLReader.h>
+#include <sbml/SBMLWriter.h>
+#include <sbml/SBMLTypes.h>
+
+#include <sbml/annotation/CVTerm.h>
+#include <sbml/annotation/ModelHistory.h>
+
+#include <string>
+
+#include <check.h>
+
+LIBSBML_CPP_NAMESPACE_USE
+
+CK_CPPSTART
+
+
+static SBMLDocument* eager;
+static SBMLDocument* deferred;
+
+extern char *TestDataDirectory;
+
+
+void
+DeferredAnnotation_setup (void)
+{
+  char *filename = safe_strcat(TestDataDirectory, "annotationL3.xml");
+
+  SBMLReader reader;
+  eager = reader.readSBML(filename);
+
+  reader.setDeferAnnotationParsing(true);
+  deferred = reader.readSBML(filename);
+
+  free(filename);
+}
+
+
+void
+DeferredAnnotation_teardown (void)
+{
+  delete eager;
+  delete deferred;
+}
+
+
+static std::string
+toString (SBMLDocument* doc)
+{
+  char* str = writeSBMLToString(doc);
+  std::string result(str);
+  free(str);
+  return result;
+}
+
+
+/*
+ * compartment c has well-formed notes and an annotation using a prefix
+ * declared on the document, d has notes outside of the XHTML namespace
+ * and e an annotation with two elements in the same namespace
+ */
+static const char* notesDoc =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<sbml xmlns=\"http://www.sbml.org/sbml/level3/version1/core\" "
+  "xmlns:jd=\"http://www.sys-bio.org/sbml\" level=\"3\" version=\"1\">\n"
+  "  <model id=\"m\">\n"
+  "    <listOfCompartments>\n"
+  "      <compartment id=\"c\" constant=\"true\">\n"
+  "        <notes>\n"
+  "          <body xmlns=\"http://www.w3.org/1999/xhtml\">\n"
+  "            <p>A &lt;compartment&gt; with <b>notes</b>.</p>\n"
+  "          </body>\n"
+  "        </notes>\n"
+  "        <annotation>\n"
+  "          <jd:foo jd:bar=\"1\">text</jd:foo>\n"
+  "        </annotation>\n"
+  "      </compartment>\n"
+  "      <compartment id=\"d\" constant=\"true\">\n"
+  "        <notes>\n"
+  "          <p>not XHTML</p>\n"
+  "        </notes>\n"
+  "      </compartment>\n"
+  "      <compartment id=\"e\" constant=\"true\">\n"
+  "        <annotation>\n"
+  "          <jd:foo/><jd:bar/>\n"
+  "        </annotation>\n"
+  "      </compartment>\n"
+  "    </listOfCompartments>\n"
+  "  </model>\n"
+  "</sbml>\n";
+
+
+START_TEST (test_DeferredAnnotation_option)
+{
+  SBMLReader reader;
+
+  fail_unless(reader.getDeferAnnotationParsing() == false);
+
+  reader.setDeferAnnotationParsing(true);
+  fail_unless(reader.getDeferAnnotationParsing() == true);
+
+  SBMLReader_t* sr = SBMLReader_create();
+  fail_unless(SBMLReader_getDeferAnnotationParsing(sr) == 0);
+  SBMLReader_setDeferAnnotationParsing(sr, 1);
+  fail_unless(SBMLReader_getDeferAnnotationParsing(sr) == 1);
+  SBMLReader_free(sr);
+}
+END_TEST
+
+
+START_TEST (test_DeferredAnnotation_access)
+{
+  Model* me = eager->getModel();
+  Model* md = deferred->getModel();
+
+  fail_unless(deferred->getNumErrors() == eager->getNumErrors());
+
+  fail_unless(md->getNumCVTerms() == me->getNumCVTerms());
+  fail_unless(md->getNumCVTerms() == 1);
+  fail_unless(md->getCVTerm(0)->getResources()->getLength() == 4);
+  fail_unless(md->isSetModelHistory() == true);
+  fail_unless(md->getModelHistory()->getNumCreators() == 1);
+
+  for (unsigned int i = 0; i < me->getNumCompartments(); i++)
+  {
+    Compartment* ce = me->getCompartment(i);
+    Compartment* cd = md->getCompartment(i);
+
+    fail_unless(cd->getNumCVTerms() == ce->getNumCVTerms());
+    fail_unless(cd->isSetModelHistory() == ce->isSetModelHistory());
+    fail_unless(cd->getResourceBiologicalQualifier(
+      "http://www.geneontology.org/#GO:0007274") ==
+      ce->getResourceBiologicalQualifier(
+      "http://www.geneontology.org/#GO:0007274"));
+  }
+}
+END_TEST
+
+
+START_TEST (test_DeferredAnnotation_write)
+{
+  // nothing has been parsed, so the annotations are written as read
+  fail_unless(toString(deferred) == toString(eager));
+
+  // and parsing them does not alter them either
+  fail_unless(deferred->getModel()->getNumCVTerms() == 1);
+  fail_unless(deferred->getModel()->getCompartment(0)->getNumCVTerms() == 1);
+  fail_unless(toString(deferred) == toString(eager));
+}
+END_TEST
+
+
+START_TEST (test_DeferredAnnotation_modify)
+{
+  CVTerm term(BIOLOGICAL_QUALIFIER);
+  term.setBiologicalQualifierType(BQB_IS_PART_OF);
+  term.addResource("http://identifiers.org/go/GO:0005623");
+
+  Compartment* ce = eager->getModel()->getCompartment("A");
+  Compartment* cd = deferred->getModel()->getCompartment("A");
+
+  fail_unless(ce->addCVTerm(&term) == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(cd->addCVTerm(&term) == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(cd->getNumCVTerms() == 2);
+
+  ModelHistory* history = deferred->getModel()->getModelHistory();
+  fail_unless(history != NULL);
+  history->getCreator(0)->setEmail("someone@example.org");
+  eager->getModel()->getModelHistory()->getCreator(0)
+                                      ->setEmail("someone@example.org");
+
+  std::string written = toString(deferred);
+  fail_unless(written == toString(eager));
+  fail_unless(written.find("GO:0005623") != std::string::npos);
+  fail_unless(written.find("someone@example.org") != std::string::npos);
+}
+END_TEST
+
+
+START_TEST (test_DeferredAnnotation_unset)
+{
+  Compartment* cd = deferred->getModel()->getCompartment("C");
+
+  fail_unless(cd->unsetCVTerms() == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(cd->getNumCVTerms() == 0);
+  fail_unless(cd->unsetModelHistory() == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(cd->isSetModelHistory() == false);
+
+  // the annotation held nothing but RDF
+  fail_unless(cd->isSetAnnotation() == false);
+
+  // setting a new annotation replaces the pending one
+  Compartment* ca = deferred->getModel()->getCompartment("A");
+  fail_unless(ca->setAnnotation("<jd2:foo xmlns:jd2=\"http://www.sys-bio.org/sbml\"/>")
+    == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(ca->getNumCVTerms() == 0);
+  fail_unless(ca->isSetModelHistory() == false);
+}
+END_TEST
+
+
+START_TEST (test_DeferredAnnotation_copy)
+{
+  SBMLDocument* copy = deferred->clone();
+  Model* md = deferred->getModel();
+
+  fail_unless(copy->getModel()->getNumCVTerms() == 1);
+  fail_unless(copy->getModel()->isSetModelHistory() == true);
+  fail_unless(copy->getModel()->getCompartment(0)->getNumCVTerms() == 1);
+
+  // the original is not affected by parsing the copy
+  fail_unless(md->getNumCVTerms() == 1);
+  fail_unless(toString(copy) == toString(deferred));
+
+  delete copy;
+}
+END_TEST
+
+
+START_TEST (test_DeferredAnnotation_setMetaId)
+{
+  Compartment* cd = deferred->getModel()->getCompartment("comp1");
+
+  // the RDF was read for the original metaid
+  fail_unless(cd->setMetaId("_new") == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(cd->getNumCVTerms() == 1);
+
+  fail_unless(eager->getModel()->getCompartment("comp1")->setMetaId("_new")
+    == LIBSBML_OPERATION_SUCCESS);
+
+  fail_unless(toString(deferred) == toString(eager));
+}
+END_TEST
+
+
+START_TEST (test_DeferredAnnotation_notes)
+{
+  SBMLReader reader;
+  SBMLDocument* e = reader.readSBMLFromString(notesDoc);
+  reader.setDeferAnnotationParsing(true);
+  SBMLDocument* d = reader.readSBMLFromString(notesDoc);
+
+  Compartment* ce = e->getModel()->getCompartment("c");
+  Compartment* cd = d->getModel()->getCompartment("c");
+
+  fail_unless(cd->isSetNotes() == true);
+  fail_unless(cd->getNotesString() == ce->getNotesString());
+  fail_unless(cd->isSetAnnotation() == true);
+  fail_unless(cd->getAnnotationString() == ce->getAnnotationString());
+
+  // the prefix is declared outside of the annotation
+  const XMLNode& foo = cd->getAnnotation()->getChild(0);
+  fail_unless(foo.getURI() == "http://www.sys-bio.org/sbml");
+  fail_unless(foo.getAttrValue("bar", "http://www.sys-bio.org/sbml") == "1");
+  fail_unless(foo.getChild(0).getCharacters() == "text");
+
+  fail_unless(toString(d) == toString(e));
+
+  // notes that are replaced are never parsed
+  Compartment* dd = d->getModel()->getCompartment("d");
+  fail_unless(dd->unsetNotes() == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(dd->isSetNotes() == false);
+  fail_unless(dd->getNotes() == NULL);
+
+  delete e;
+  delete d;
+}
+END_TEST
+
+
+START_TEST (test_DeferredAnnotation_checks)
+{
+  SBMLReader reader;
+  SBMLDocument* e = reader.readSBMLFromString(notesDoc);
+  reader.setDeferAnnotationParsing(true);
+  SBMLDocument* d = reader.readSBMLFromString(notesDoc);
+
+  fail_unless(e->getNumErrors() == 2);
+  fail_unless(e->getError(0)->getErrorId() == NotesNotInXHTMLNamespace);
+  fail_unless(e->getError(1)->getErrorId() == DuplicateAnnotationNamespaces);
+
+  // the notes and annotations are checked when they are built
+  fail_unless(d->getNumErrors() == 0);
+
+  fail_unless(d->getModel()->getCompartment("d")->getNotes() != NULL);
+  fail_unless(d->getNumErrors() == 1);
+  fail_unless(d->getError(0)->getErrorId() == NotesNotInXHTMLNamespace);
+
+  fail_unless(d->getModel()->getCompartment("e")->isSetAnnotation() == true);
+  fail_unless(d->getNumErrors() == 2);
+  fail_unless(d->getError(1)->getErrorId() == DuplicateAnnotationNamespaces);
+
+  delete e;
+  delete d;
+}
+END_TEST
+
+
+Suite *
+create_suite_DeferredAnnotation (void)
+{
+  Suite *suite = suite_create("DeferredAnnotation");
+  TCase *tcase = tcase_create("DeferredAnnotation");
+
+  tcase_add_checked_fixture(tcase,
+                            DeferredAnnotation_setup,
+                            DeferredAnnotation_teardown);
+
+  tcase_add_test(tcase, test_DeferredAnnotation_option   );
+  tcase_add_test(tcase, test_DeferredAnnotation_access   );
+  tcase_add_test(tcase, test_DeferredAnnotation_write    );
+  tcase_add_test(tcase, test_DeferredAnnotation_modify   );
+  tcase_add_test(tcase, test_DeferredAnnotation_unset    );
+  tcase_add_test(tcase, test_DeferredAnnotation_copy     );
+  tcase_add_test(tcase, test_DeferredAnnotation_setMetaId);
+  tcase_add_test(tcase, test_DeferredAnnotation_notes    );
+  tcase_add_test(tcase, test_DeferredAnnotation_checks   );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+CK_CPPEND
@@ -78,6 +78,7 @@ Suite *create_suite_L3ModelHistory (void);
 Suite *create_suite_SyncAnnotation (void);
 Suite *create_suite_RDFAnnotationMetaid (void);
 Suite *create_suite_RDFAnnotationNestedCVTerm (void);
+Suite *create_suite_DeferredAnnotation (void);
 
 /**
  * Global.
@@ -138,6 +139,7 @@ main (int argc, char* argv[])
   srunner_add_suite( runner, create_suite_RDFAnnotationMetaid () );
   srunner_add_suite( runner, create_suite_RDFAnnotationNestedCVTerm () );
   srunner_add_suite( runner, create_suite_RDFAnnotationV4() );
+  srunner_add_suite( runner, create_suite_DeferredAnnotation () );
 
   if (argc > 1 && !strcmp(argv[1], "-nofork"))
   {
@@ -54,11 +54,28 @@
 #include <algorithm>
 #include <string>
 #include <iterator>
+#include <vector>
 
 using namespace std;
 LIBSBML_CPP_NAMESPACE_BEGIN
 
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Adds the given math, if any, to the math whose function definitions to
+ * replace.
+ */
+static void
+addMath(vector<ASTNode*>& maths, const ASTNode* math)
+{
+  if (math != NULL)
+  {
+    maths.push_back(const_cast<ASTNode*>(math));
+  }
+}
+/** @endcond */
+
+
 /** @cond doxygenLibsbmlInternal */
 void SBMLFunctionDefinitionConverter::init()
 {
@@ -180,112 +197,69 @@ SBMLFunctionDefinitionConverter::convert()
     idsToSkip = IdList(mProps->getOption("skipIds")->getValue());    
   }
 
-  // for any math in document replace each function def
+  // collect all math in document and replace each function def in one go,
+  // so that each function definition is expanded only once
+  vector<ASTNode*> maths;
   for (i = 0; i < mModel->getNumRules(); i++)
   {
-    if (mModel->getRule(i)->isSetMath())
-    {
-      SBMLTransforms::replaceFD(const_cast <ASTNode *>(mModel->getRule(i)
-        ->getMath()), mModel->getListOfFunctionDefinitions(), &idsToSkip);
-    }
+    addMath(maths, mModel->getRule(i)->getMath());
   }
   for (i = 0; i < mModel->getNumInitialAssignments(); i++)
   {
-    if (mModel->getInitialAssignment(i)->isSetMath())
-    {
-      SBMLTransforms::replaceFD(const_cast <ASTNode *>(mModel
-        ->getInitialAssignment(i)->getMath()), 
-        mModel->getListOfFunctionDefinitions(), &idsToSkip);
-    }
+    addMath(maths, mModel->getInitialAssignment(i)->getMath());
   }
   for (i = 0; i < mModel->getNumConstraints(); i++)
   {
-    if (mModel->getConstraint(i)->isSetMath())
-    {
-      SBMLTransforms::replaceFD(const_cast <ASTNode *>(mModel
-        ->getConstraint(i)->getMath()), 
-        mModel->getListOfFunctionDefinitions(), &idsToSkip);
-    }
+    addMath(maths, mModel->getConstraint(i)->getMath());
   }
   for (i = 0; i < mModel->getNumReactions(); i++)
   {
-    if (mModel->getReaction(i)->isSetKineticLaw())
+    Reaction* reaction = mModel->getReaction(i);
+    if (reaction->isSetKineticLaw())
     {
-      if (mModel->getReaction(i)->getKineticLaw()->isSetMath())
-      {
-        SBMLTransforms::replaceFD(const_cast <ASTNode *> (mModel
-          ->getReaction(i)->getKineticLaw()->getMath()), 
-          mModel->getListOfFunctionDefinitions(), &idsToSkip);
-      }
+      addMath(maths, reaction->getKineticLaw()->getMath());
     }
-    for (j = 0; j < mModel->getReaction(i)->getNumReactants(); j++)
+    for (j = 0; j < reaction->getNumReactants(); j++)
     {
-      if (mModel->getReaction(i)->getReactant(j)->isSetStoichiometryMath())
+      if (reaction->getReactant(j)->isSetStoichiometryMath())
       {
-        if (mModel->getReaction(i)->getReactant(j)->getStoichiometryMath()
-          ->isSetMath())
-        {
-          SBMLTransforms::replaceFD(const_cast <ASTNode *> (mModel
-            ->getReaction(i)->getReactant(j)->getStoichiometryMath()->getMath()), 
-            mModel->getListOfFunctionDefinitions(), &idsToSkip);
-        }
+        addMath(maths, 
+          reaction->getReactant(j)->getStoichiometryMath()->getMath());
       }
     }
-    for (j = 0; j < mModel->getReaction(i)->getNumProducts(); j++)
+    for (j = 0; j < reaction->getNumProducts(); j++)
     {
-      if (mModel->getReaction(i)->getProduct(j)->isSetStoichiometryMath())
+      if (reaction->getProduct(j)->isSetStoichiometryMath())
       {
-        if (mModel->getReaction(i)->getProduct(j)->getStoichiometryMath()
-          ->isSetMath())
-        {
-          SBMLTransforms::replaceFD(const_cast <ASTNode *> (mModel
-            ->getReaction(i)->getProduct(j)->getStoichiometryMath()->getMath()), 
-            mModel->getListOfFunctionDefinitions(), &idsToSkip);
-        }
+        addMath(maths, 
+          reaction->getProduct(j)->getStoichiometryMath()->getMath());
       }
     }
   }
   for (i = 0; i < mModel->getNumEvents(); i++)
   {
-    if (mModel->getEvent(i)->isSetTrigger())
+    Event* event = mModel->getEvent(i);
+    if (event->isSetTrigger())
     {
-      if (mModel->getEvent(i)->getTrigger()->isSetMath())
-      {
-        SBMLTransforms::replaceFD(const_cast <ASTNode *> (mModel
-          ->getEvent(i)->getTrigger()->getMath()),
-          mModel->getListOfFunctionDefinitions(), &idsToSkip);
-      }
+      addMath(maths, event->getTrigger()->getMath());
     }
-    if (mModel->getEvent(i)->isSetDelay())
+    if (event->isSetDelay())
     {
-      if (mModel->getEvent(i)->getDelay()->isSetMath())
-      {
-        SBMLTransforms::replaceFD(const_cast <ASTNode *> (mModel
-          ->getEvent(i)->getDelay()->getMath()),
-          mModel->getListOfFunctionDefinitions(), &idsToSkip);
-      }
+      addMath(maths, event->getDelay()->getMath());
     }
-    if (mModel->getEvent(i)->isSetPriority())
+    if (event->isSetPriority())
     {
-      if (mModel->getEvent(i)->getPriority()->isSetMath())
-      {
-        SBMLTransforms::replaceFD(const_cast <ASTNode *> (mModel
-          ->getEvent(i)->getPriority()->getMath()),
-          mModel->getListOfFunctionDefinitions(), &idsToSkip);
-      }
+      addMath(maths, event->getPriority()->getMath());
     }
-
-    for(j = 0; j < mModel->getEvent(i)->getNumEventAssignments(); j++)
+    for(j = 0; j < event->getNumEventAssignments(); j++)
     {
-      if (mModel->getEvent(i)->getEventAssignment(j)->isSetMath())
-      {
-        SBMLTransforms::replaceFD(const_cast <ASTNode *> (mModel
-          ->getEvent(i)->getEventAssignment(j)->getMath()),
-          mModel->getListOfFunctionDefinitions(), &idsToSkip);
-      }
+      addMath(maths, event->getEventAssignment(j)->getMath());
     }
   }
 
+  SBMLTransforms::replaceFD(maths, mModel->getListOfFunctionDefinitions(), 
+                            &idsToSkip);
+
   /* replace original consistency checks */
   mDocument->setApplicableValidators(origValidators);
 
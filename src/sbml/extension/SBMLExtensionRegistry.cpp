@@ -46,6 +46,7 @@
 #include <sbml/SBMLDocument.h>
 #include <sbml/extension/SBasePlugin.h>
 #include <algorithm>
+#include <cctype>
 #include <iostream>
 #include <string>
 
@@ -212,6 +213,7 @@ SBMLExtensionRegistry::addExtension (const SBMLExtension* sbmlExt)
     astPlugin->setSBMLExtension(sbmlExtClone);
 
     mASTPluginsVector.push_back(astPlugin);
+    indexASTPlugin(astPlugin);
   }
 
   return LIBSBML_OPERATION_SUCCESS;
@@ -608,6 +610,101 @@ SBMLExtensionRegistry::getASTPlugin(unsigned int i)
 }
 
 
+/** @cond doxygenLibsbmlInternal */
+static string
+toLowerCase(const string& value)
+{
+  string lower(value);
+  for (size_t i = 0; i < lower.size(); ++i)
+  {
+    lower[i] = (char)tolower((unsigned char)lower[i]);
+  }
+  return lower;
+}
+
+
+/*
+ * Adds the node types, names and csymbol URLs defined by the given plugin
+ * to the lookup tables, unless a plugin registered earlier defines them.
+ * Names and URLs are matched ignoring case, as ASTBasePlugin does.
+ */
+void
+SBMLExtensionRegistry::indexASTPlugin(const ASTBasePlugin* astPlugin)
+{
+  const ASTNodeValues_t* values = NULL;
+  for (unsigned int n = 0; (values = astPlugin->getASTNodeValue(n)) != NULL; ++n)
+  {
+    if (values->type >= 0)
+    {
+      size_t index = (size_t)values->type;
+      if (index >= mASTPluginsByType.size())
+      {
+        mASTPluginsByType.resize(index + 1, NULL);
+      }
+      if (mASTPluginsByType[index] == NULL)
+      {
+        mASTPluginsByType[index] = astPlugin;
+      }
+    }
+
+    mASTPluginsByName.insert(make_pair(values->name, astPlugin));
+    mASTPluginsByLowerCaseName.insert(
+      make_pair(toLowerCase(values->name), astPlugin));
+    mASTPluginsByCSymbolURL.insert(
+      make_pair(toLowerCase(values->csymbolURL), astPlugin));
+  }
+}
+
+
+const ASTBasePlugin *
+SBMLExtensionRegistry::getASTPluginForType(int type) const
+{
+  if (type < 0 || (size_t)type >= mASTPluginsByType.size())
+  {
+    return NULL;
+  }
+  return mASTPluginsByType[(size_t)type];
+}
+
+
+const ASTBasePlugin *
+SBMLExtensionRegistry::getASTPluginForName(const string& name,
+                                           bool strCmpIsCaseSensitive) const
+{
+  ASTPluginMap::const_iterator it;
+  if (strCmpIsCaseSensitive)
+  {
+    it = mASTPluginsByName.find(name);
+    return it != mASTPluginsByName.end() ? it->second : NULL;
+  }
+
+  it = mASTPluginsByLowerCaseName.find(toLowerCase(name));
+  return it != mASTPluginsByLowerCaseName.end() ? it->second : NULL;
+}
+
+
+const ASTBasePlugin *
+SBMLExtensionRegistry::getASTPluginForCSymbolURL(const string& url) const
+{
+  ASTPluginMap::const_iterator it =
+    mASTPluginsByCSymbolURL.find(toLowerCase(url));
+  return it != mASTPluginsByCSymbolURL.end() ? it->second : NULL;
+}
+
+
+const ASTBasePlugin *
+SBMLExtensionRegistry::getASTPluginForURI(const string& uri) const
+{
+  SBMLExtensionMap::const_iterator it = mSBMLExtensionMap.find(uri);
+  if (it == mSBMLExtensionMap.end() || !it->second->isSetASTBasePlugin())
+  {
+    return NULL;
+  }
+  return it->second->getASTBasePlugin();
+}
+/** @endcond */
+
+
 
 #endif /* __cplusplus */
 /** @cond doxygenIgnored */
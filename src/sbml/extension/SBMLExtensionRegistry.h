@@ -390,6 +390,26 @@ public:
   unsigned int getNumASTPlugins();
   const ASTBasePlugin * getASTPlugin(unsigned int i);
 
+  /** @cond doxygenLibsbmlInternal */
+  /*
+   * Lookups of the registered ASTBasePlugin objects by the node types,
+   * names and csymbol definitionURLs they define.  The tables are built
+   * when the plugins are registered; where several plugins define the same
+   * value, the first one registered is returned, as a search of the
+   * plugins in order would.
+   */
+  const ASTBasePlugin * getASTPluginForType(int type) const;
+  const ASTBasePlugin * getASTPluginForName(const std::string& name,
+                                            bool strCmpIsCaseSensitive) const;
+  const ASTBasePlugin * getASTPluginForCSymbolURL(const std::string& url) const;
+
+  /*
+   * Returns the ASTBasePlugin of the extension with the given package URI
+   * or name, or NULL if there is none.
+   */
+  const ASTBasePlugin * getASTPluginForURI(const std::string& uri) const;
+  /** @endcond */
+
 private:
 
   //
@@ -408,6 +428,15 @@ private:
   SBasePluginMap    mSBasePluginMap;
   std::vector<ASTBasePlugin*>  mASTPluginsVector;
 
+  void indexASTPlugin(const ASTBasePlugin* astPlugin);
+
+  typedef std::map<std::string, const ASTBasePlugin*> ASTPluginMap;
+
+  std::vector<const ASTBasePlugin*>  mASTPluginsByType;
+  ASTPluginMap  mASTPluginsByName;
+  ASTPluginMap  mASTPluginsByLowerCaseName;
+  ASTPluginMap  mASTPluginsByCSymbolURL;
+
   static SBMLExtensionRegistry* mInstance;
 
   //
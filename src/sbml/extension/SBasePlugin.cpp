@@ -426,6 +426,54 @@ SBasePlugin::renameUnitSIdRefs(const std::string& , const std::string& )
 }
 /** @endcond */
 
+/** @cond doxygenLibsbmlInternal */
+//The plugins of libSBML's own packages override these where they hold
+//references; the plugins of other packages are renamed one identifier at
+//a time, through the variants above.
+void 
+SBasePlugin::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  if (SBase::renamesByMap(getPackageName())) return;
+
+  std::vector<std::pair<std::string, std::string> > steps;
+  SBase::getSequentialRenames(renames, steps);
+  for (size_t n = 0; n < steps.size(); ++n)
+  {
+    renameSIdRefs(steps[n].first, steps[n].second);
+  }
+}
+/** @endcond */
+
+/** @cond doxygenLibsbmlInternal */
+void 
+SBasePlugin::renameMetaIdRefs(const std::map<std::string, std::string>& renames)
+{
+  if (SBase::renamesByMap(getPackageName())) return;
+
+  std::vector<std::pair<std::string, std::string> > steps;
+  SBase::getSequentialRenames(renames, steps);
+  for (size_t n = 0; n < steps.size(); ++n)
+  {
+    renameMetaIdRefs(steps[n].first, steps[n].second);
+  }
+}
+/** @endcond */
+
+/** @cond doxygenLibsbmlInternal */
+void 
+SBasePlugin::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  if (SBase::renamesByMap(getPackageName())) return;
+
+  std::vector<std::pair<std::string, std::string> > steps;
+  SBase::getSequentialRenames(renames, steps);
+  for (size_t n = 0; n < steps.size(); ++n)
+  {
+    renameUnitSIdRefs(steps[n].first, steps[n].second);
+  }
+}
+/** @endcond */
+
 /** @cond doxygenLibsbmlInternal */
 int 
 SBasePlugin::transformIdentifiers(IdentifierTransformer* )
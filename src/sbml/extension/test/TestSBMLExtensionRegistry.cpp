@@ -191,6 +191,55 @@ START_TEST (test_SBMLExtensionRegistry_c_api)
 }
 END_TEST
 
+START_TEST (test_SBMLExtensionRegistry_astPluginLookup)
+{
+  SBMLExtensionRegistry& registry = SBMLExtensionRegistry::getInstance();
+
+  fail_unless(registry.getASTPluginForType(AST_PLUS) == NULL);
+  fail_unless(registry.getASTPluginForType(AST_UNKNOWN) == NULL);
+  fail_unless(registry.getASTPluginForType(-1) == NULL);
+  fail_unless(registry.getASTPluginForName("no such function", false) == NULL);
+  fail_unless(registry.getASTPluginForCSymbolURL("http://no.such/url") == NULL);
+
+  // every value of every plugin is found in the first plugin defining it
+  for (unsigned int i = 0; i < registry.getNumASTPlugins(); ++i)
+  {
+    const ASTBasePlugin* plugin = registry.getASTPlugin(i);
+    const ASTNodeValues_t* values = NULL;
+    for (unsigned int n = 0; (values = plugin->getASTNodeValue(n)) != NULL; ++n)
+    {
+      const ASTBasePlugin* first = NULL;
+      const ASTBasePlugin* firstUpper = NULL;
+      string upper(values->name);
+      for (size_t c = 0; c < upper.size(); ++c)
+        upper[c] = (char)toupper(upper[c]);
+
+      for (unsigned int j = 0; j <= i && first == NULL; ++j)
+      {
+        if (registry.getASTPlugin(j)->defines(values->type))
+          first = registry.getASTPlugin(j);
+      }
+      for (unsigned int j = 0; j <= i && firstUpper == NULL; ++j)
+      {
+        if (registry.getASTPlugin(j)->defines(upper, false))
+          firstUpper = registry.getASTPlugin(j);
+      }
+
+      fail_unless(registry.getASTPluginForType(values->type) == first);
+      fail_unless(registry.getASTPluginForName(upper, false) == firstUpper);
+      fail_unless(registry.getASTPluginForName(values->name, true)->
+                  getASTNodeTypeFor(values->name) != AST_UNKNOWN);
+      if (!values->csymbolURL.empty())
+      {
+        fail_unless(registry.getASTPluginForCSymbolURL(values->csymbolURL)->
+                    getASTNodeTypeForCSymbolURL(values->csymbolURL)
+                    != AST_UNKNOWN);
+      }
+    }
+  }
+}
+END_TEST
+
 Suite *
 create_suite_SBMLExtensionRegistry (void)
 {
@@ -200,6 +249,7 @@ create_suite_SBMLExtensionRegistry (void)
   tcase_add_test( tcase, test_SBMLExtensionRegistry_addExtension );
   tcase_add_test( tcase, test_SBMLExtensionRegistry_getExtension );
   tcase_add_test( tcase, test_SBMLExtensionRegistry_c_api        );
+  tcase_add_test( tcase, test_SBMLExtensionRegistry_astPluginLookup );
   
   suite_add_tcase(suite, tcase);
 
@@ -42,11 +42,14 @@
 #include <new>
 #include <stdlib.h>
 #include <limits.h>
+#include <vector>
+#include <utility>
 
 #include <sbml/common/common.h>
 #include <sbml/util/List.h>
 
 #include <sbml/math/ASTNode.h>
+#include <sbml/math/ASTNodeVisitor.h>
 #include <sbml/xml/XMLAttributes.h>
 #include <sbml/xml/XMLNode.h>
 #include <sbml/Model.h>
@@ -234,6 +237,63 @@ static const char *AST_OPERATOR_STRINGS[] =
 
 #ifdef __cplusplus
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Adds the nodes matching a predicate to a List, in the order
+ * fillListOfNodes() has always used.
+ */
+class NodeCollector : public ASTNodeVisitor
+{
+public:
+  NodeCollector(ASTNodePredicate predicate, List* lst)
+    : mPredicate(predicate)
+    , mList(lst)
+  {
+  }
+
+  virtual bool visitPreOrder(const ASTNode* node)
+  {
+    if (mPredicate(node) != 0)
+    {
+      mList->add( const_cast<ASTNode*>(node) );
+    }
+    return true;
+  }
+
+private:
+  ASTNodePredicate mPredicate;
+  List* mList;
+};
+
+
+/*
+ * Ends the traversal at the first node with units.
+ */
+class UnitsFinder : public ASTNodeVisitor
+{
+public:
+  virtual bool visitPreOrder(const ASTNode* node)
+  {
+    return !node->isSetUnits();
+  }
+};
+
+
+/*
+ * Pushes the children of the given node so that they are popped in order.
+ */
+static void
+pushChildren(ASTNode* node, vector<ASTNode*>& pending)
+{
+  for (unsigned int n = node->getNumChildren(); n > 0; --n)
+  {
+    ASTNode* child = node->getChild(n - 1);
+    if (child != NULL) pending.push_back(child);
+  }
+}
+/** @endcond */
+
+
 /*
  * Creates a new ASTNode.
  *
@@ -382,11 +442,6 @@ ASTNode::ASTNode (const ASTNode& orig) :
     mName = safe_strdup(orig.mName);
   }
 
-  for (unsigned int c = 0; c < orig.getNumChildren(); ++c)
-  {
-    addChild( orig.getChild(c)->deepCopy() );
-  }
-
   for (unsigned int c = 0; c < orig.getNumSemanticsAnnotations(); ++c)
   {
     addSemanticsAnnotation( orig.getSemanticsAnnotation(c)->clone() );
@@ -398,6 +453,8 @@ ASTNode::ASTNode (const ASTNode& orig) :
   {
     getPlugin((unsigned int)i)->connectToParent(this);
   }
+
+  copyChildren(orig);
 }
 
 /*
@@ -410,59 +467,102 @@ ASTNode& ASTNode::operator=(const ASTNode& rhs)
 {
   if(&rhs!=this)
   {
-    mType                 = rhs.mType;
-    mChar                 = rhs.mChar;
-    mInteger              = rhs.mInteger;
-    mReal                 = rhs.mReal;
-    mDenominator          = rhs.mDenominator;
-    mExponent             = rhs.mExponent;
-    hasSemantics          = rhs.hasSemantics;
-    mParentSBMLObject     = rhs.mParentSBMLObject;
-    mUnits                = rhs.mUnits;
-    mId                   = rhs.mId;
-    mClass                = rhs.mClass;
-    mStyle                = rhs.mStyle;
-    mIsBvar               = rhs.mIsBvar;
-    mUserData             = rhs.mUserData;
-    freeName();
-    if (rhs.mName)
-    {
-      mName = safe_strdup(rhs.mName);
-    }
-    else
-    {
-      mName = NULL;
-    }
+    copyNode(rhs);
 
     unsigned int size = mChildren->getSize();
     while (size--) delete static_cast<ASTNode*>( mChildren->remove(0) );
     delete mChildren;
     mChildren = new List();
 
-    for (unsigned int c = 0; c < rhs.getNumChildren(); ++c)
-    {
-      addChild( rhs.getChild(c)->deepCopy() );
-    }
+    copyChildren(rhs);
+  }
+  return *this;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Copies everything but the children of the given ASTNode to this one.
+ */
+void
+ASTNode::copyNode (const ASTNode& orig)
+{
+  mType                 = orig.mType;
+  mChar                 = orig.mChar;
+  mInteger              = orig.mInteger;
+  mReal                 = orig.mReal;
+  mDenominator          = orig.mDenominator;
+  mExponent             = orig.mExponent;
+  hasSemantics          = orig.hasSemantics;
+  mParentSBMLObject     = orig.mParentSBMLObject;
+  mUnits                = orig.mUnits;
+  mId                   = orig.mId;
+  mClass                = orig.mClass;
+  mStyle                = orig.mStyle;
+  mIsBvar               = orig.mIsBvar;
+  mUserData             = orig.mUserData;
+  freeName();
+  if (orig.mName)
+  {
+    mName = safe_strdup(orig.mName);
+  }
+  else
+  {
+    mName = NULL;
+  }
 
-    size = mSemanticsAnnotations->getSize();
-    while (size--)  delete static_cast<XMLNode*>(mSemanticsAnnotations->remove(0) );
-    delete mSemanticsAnnotations;
-    mSemanticsAnnotations = new List();
+  unsigned int size = mSemanticsAnnotations->getSize();
+  while (size--)  delete static_cast<XMLNode*>(mSemanticsAnnotations->remove(0) );
+  delete mSemanticsAnnotations;
+  mSemanticsAnnotations = new List();
 
-    for (unsigned int c = 0; c < rhs.getNumSemanticsAnnotations(); ++c)
+  for (unsigned int c = 0; c < orig.getNumSemanticsAnnotations(); ++c)
+  {
+    addSemanticsAnnotation( orig.getSemanticsAnnotation(c)->clone() );
+  }
+  
+  delete mDefinitionURL;
+  mDefinitionURL        = orig.mDefinitionURL->clone();	
+  clearPlugins();
+  mPlugins.resize(orig.mPlugins.size());
+  transform(orig.mPlugins.begin(), orig.mPlugins.end(),
+    mPlugins.begin(), CloneASTPluginEntity());
+  for (size_t i = 0; i < mPlugins.size(); i++)
+  {
+    getPlugin((unsigned int)i)->connectToParent(this);
+  }
+}
+
+
+/*
+ * Appends copies of the descendants of the given ASTNode to this one,
+ * which has no children yet.  The copies are made level by level from a
+ * list of pending nodes, so that copying a deeply nested tree does not
+ * recurse once for every level.
+ */
+void
+ASTNode::copyChildren (const ASTNode& orig)
+{
+  vector< pair<ASTNode*, const ASTNode*> > pending;
+  pending.push_back(make_pair(this, &orig));
+
+  while (!pending.empty())
+  {
+    ASTNode* copy = pending.back().first;
+    const ASTNode* source = pending.back().second;
+    pending.pop_back();
+
+    for (unsigned int c = 0; c < source->getNumChildren(); ++c)
     {
-      addSemanticsAnnotation( rhs.getSemanticsAnnotation(c)->clone() );
+      const ASTNode* child = source->getChild(c);
+      ASTNode* childCopy = new ASTNode(AST_UNKNOWN);
+      childCopy->copyNode(*child);
+      copy->addChild(childCopy);
+      pending.push_back(make_pair(childCopy, child));
     }
-    
-    delete mDefinitionURL;
-    mDefinitionURL        = rhs.mDefinitionURL->clone();	
-    clearPlugins();
-    mPlugins.resize(rhs.mPlugins.size());
-    transform(rhs.mPlugins.begin(), rhs.mPlugins.end(),
-      mPlugins.begin(), CloneASTPluginEntity());
   }
-  return *this;
 }
+/** @endcond */
 
 /*
  * Destroys this ASTNode including any child nodes.
@@ -470,12 +570,31 @@ ASTNode& ASTNode::operator=(const ASTNode& rhs)
 LIBSBML_EXTERN
 ASTNode::~ASTNode ()
 {
-  unsigned int size = getNumChildren();
-
+  /*
+   * Descendants are detached before they are deleted, so that deleting a
+   * deeply nested tree does not recurse once for every level.
+   */
+  vector<ASTNode*> detached;
+  while (mChildren->getSize() > 0)
+  {
+    detached.push_back(static_cast<ASTNode*>( mChildren->remove(0) ));
+  }
+  while (!detached.empty())
+  {
+    ASTNode* child = detached.back();
+    detached.pop_back();
+    if (child == NULL) continue;
 
-  while (size--) delete static_cast<ASTNode*>( mChildren->remove(0) );
+    while (child->mChildren->getSize() > 0)
+    {
+      detached.push_back(static_cast<ASTNode*>( child->mChildren->remove(0) ));
+    }
+    delete child;
+  }
   delete mChildren;
 
+  unsigned int size;
+
   size = mSemanticsAnnotations->getSize();
   while (size--)  delete static_cast<XMLNode*>(mSemanticsAnnotations->remove(0) );
   delete mSemanticsAnnotations;
@@ -1121,22 +1240,8 @@ ASTNode::fillListOfNodes (ASTNodePredicate predicate, List* lst) const
 {
   if (lst == NULL || predicate == NULL) return;
 
-  ASTNode*     child;
-  unsigned int c;
-  unsigned int numChildren = getNumChildren();
-
-
-
-  if (predicate(this) != 0)
-  {
-    lst->add( const_cast<ASTNode*>(this) );
-  }
-
-  for (c = 0; c < numChildren; c++)
-  {
-    child = getChild(c);
-    child->fillListOfNodes(predicate, lst);
-  }
+  NodeCollector collector(predicate, lst);
+  collector.traverse(this);
 }
 
 
@@ -2026,16 +2131,8 @@ LIBSBML_EXTERN
 bool 
 ASTNode::hasUnits() const
 {
-  bool hasUnits = isSetUnits();
-
-  unsigned int n = 0;
-  while(!hasUnits && n < getNumChildren())
-  {
-    hasUnits = getChild(n)->hasUnits();
-    n++;
-  }
-
-  return hasUnits;
+  UnitsFinder finder;
+  return !finder.traverse(this);
 }
 
   
@@ -2353,15 +2450,20 @@ LIBSBML_EXTERN
 void 
 ASTNode::renameSIdRefs(const std::string& oldid, const std::string& newid)
 {
-  if (getType() == AST_NAME ||
-      getType() == AST_FUNCTION ||
-      getType() == AST_UNKNOWN) {
-    if (getName() == oldid) {
-      setName(newid.c_str());
+  vector<ASTNode*> pending(1, this);
+  while (!pending.empty())
+  {
+    ASTNode* node = pending.back();
+    pending.pop_back();
+
+    ASTNodeType_t type = node->getType();
+    if (type == AST_NAME || type == AST_FUNCTION || type == AST_UNKNOWN) {
+      const char* name = node->getName();
+      if (name != NULL && oldid == name) {
+        node->setName(newid.c_str());
+      }
     }
-  }
-  for (unsigned int child=0; child<getNumChildren(); child++) {
-    getChild(child)->renameSIdRefs(oldid, newid);
+    pushChildren(node, pending);
   }
 }
 
@@ -2369,13 +2471,60 @@ LIBSBML_EXTERN
 void 
 ASTNode::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
 {
-  if (isSetUnits()) {
-    if (getUnits() == oldid) {
-      setUnits(newid);
+  vector<ASTNode*> pending(1, this);
+  while (!pending.empty())
+  {
+    ASTNode* node = pending.back();
+    pending.pop_back();
+
+    if (node->isSetUnits() && node->getUnits() == oldid) {
+      node->setUnits(newid);
     }
+    pushChildren(node, pending);
   }
-  for (unsigned int child=0; child<getNumChildren(); child++) {
-    getChild(child)->renameUnitSIdRefs(oldid, newid);
+}
+
+LIBSBML_EXTERN
+void 
+ASTNode::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  vector<ASTNode*> pending(1, this);
+  while (!pending.empty())
+  {
+    ASTNode* node = pending.back();
+    pending.pop_back();
+
+    ASTNodeType_t type = node->getType();
+    if (type == AST_NAME || type == AST_FUNCTION || type == AST_UNKNOWN) {
+      const char* name = node->getName();
+      if (name != NULL) {
+        map<string, string>::const_iterator it = renames.find(name);
+        if (it != renames.end()) {
+          node->setName(it->second.c_str());
+        }
+      }
+    }
+    pushChildren(node, pending);
+  }
+}
+
+LIBSBML_EXTERN
+void 
+ASTNode::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  vector<ASTNode*> pending(1, this);
+  while (!pending.empty())
+  {
+    ASTNode* node = pending.back();
+    pending.pop_back();
+
+    if (node->isSetUnits()) {
+      map<string, string>::const_iterator it = renames.find(node->getUnits());
+      if (it != renames.end()) {
+        node->setUnits(it->second);
+      }
+    }
+    pushChildren(node, pending);
   }
 }
 
@@ -3202,44 +3351,17 @@ LIBSBML_EXTERN
 ASTBasePlugin * 
 ASTNode::getASTPlugin(ASTNodeType_t type)
 {
-  unsigned int numPkgs = SBMLExtensionRegistry::getInstance().getNumASTPlugins();
-
-  for (unsigned int i = 0; i < numPkgs; i++)
-  {
-    const ASTBasePlugin* baseplugin = SBMLExtensionRegistry::getInstance().getASTPlugin(i);
-    if (baseplugin->defines(type))
-    {
-      return const_cast<ASTBasePlugin*>(baseplugin);
-    }
-  }
-  return NULL;
+  return const_cast<ASTBasePlugin*>(
+    SBMLExtensionRegistry::getInstance().getASTPluginForType(type));
 }
 
 LIBSBML_EXTERN
 ASTBasePlugin * 
 ASTNode::getASTPlugin(const std::string& name, bool isCsymbol, bool strCmpIsCaseSensitive)
 {
-  unsigned int numPkgs = SBMLExtensionRegistry::getInstance().getNumASTPlugins();
-
-  for (unsigned int i = 0; i < numPkgs; i++)
-  {
-    const ASTBasePlugin* baseplugin = SBMLExtensionRegistry::getInstance().getASTPlugin(i);
-    if (isCsymbol)
-    {
-      if (baseplugin->getASTNodeTypeForCSymbolURL(name) != AST_UNKNOWN)
-      {
-        return const_cast<ASTBasePlugin*>(baseplugin);
-      }
-    }
-    else
-    {
-      if (baseplugin->defines(name, strCmpIsCaseSensitive))
-      {
-        return const_cast<ASTBasePlugin*>(baseplugin);
-      }
-    }
-  }
-  return NULL;
+  const ASTNode* self = this;
+  return const_cast<ASTBasePlugin*>(
+    self->getASTPlugin(name, isCsymbol, strCmpIsCaseSensitive));
 }
 
 
@@ -3277,44 +3399,19 @@ LIBSBML_EXTERN
 const ASTBasePlugin * 
 ASTNode::getASTPlugin(ASTNodeType_t type) const
 {
-  unsigned int numPkgs = SBMLExtensionRegistry::getInstance().getNumASTPlugins();
-
-  for (unsigned int i = 0; i < numPkgs; i++)
-  {
-    const ASTBasePlugin* baseplugin = SBMLExtensionRegistry::getInstance().getASTPlugin(i);
-    if (baseplugin->defines(type))
-    {
-      return baseplugin;
-    }
-  }
-  return NULL;
+  return SBMLExtensionRegistry::getInstance().getASTPluginForType(type);
 }
 
 LIBSBML_EXTERN
 const ASTBasePlugin * 
 ASTNode::getASTPlugin(const std::string& name, bool isCsymbol, bool strCmpIsCaseSensitive) const
 {
-  unsigned int numPkgs = SBMLExtensionRegistry::getInstance().getNumASTPlugins();
-
-  for (unsigned int i = 0; i < numPkgs; i++)
+  const SBMLExtensionRegistry& registry = SBMLExtensionRegistry::getInstance();
+  if (isCsymbol)
   {
-    const ASTBasePlugin* baseplugin = SBMLExtensionRegistry::getInstance().getASTPlugin(i);
-    if (isCsymbol)
-    {
-      if (baseplugin->getASTNodeTypeForCSymbolURL(name) != AST_UNKNOWN)
-      {
-        return baseplugin;
-      }
-    }
-    else
-    {
-      if (baseplugin->defines(name, strCmpIsCaseSensitive))
-      {
-        return const_cast<ASTBasePlugin*>(baseplugin);
-      }
-    }
+    return registry.getASTPluginForCSymbolURL(name);
   }
-  return NULL;
+  return registry.getASTPluginForName(name, strCmpIsCaseSensitive);
 }
 
 
@@ -211,6 +211,8 @@ LIBSBML_CPP_NAMESPACE_END
 
 #ifdef __cplusplus
 
+#include <map>
+
 LIBSBML_CPP_NAMESPACE_BEGIN
 
 class List;
@@ -1634,6 +1636,28 @@ setValue(value, 0);
   virtual void renameUnitSIdRefs(const std::string& oldid, const std::string& newid);
 
 
+#ifndef SWIG
+  /**
+   * Renames all the SIdRef attributes on this node and any child node
+   * that appear in the given map, all at once.
+   *
+   * @param renames a map from old to new identifiers.
+   */
+  LIBSBML_EXTERN
+  void renameSIdRefs(const std::map<std::string, std::string>& renames);
+
+
+  /**
+   * Renames all the UnitSIdRef attributes on this node and any child node
+   * that appear in the given map, all at once.
+   *
+   * @param renames a map from old to new identifiers.
+   */
+  LIBSBML_EXTERN
+  void renameUnitSIdRefs(const std::map<std::string, std::string>& renames);
+#endif
+
+
   /** @cond doxygenLibsbmlInternal */
   /**
    * Replace any nodes of type AST_NAME with the name 'id' from the child 'math' object with the provided ASTNode. 
@@ -2332,6 +2356,9 @@ protected:
 
 private:
   void clearPlugins();
+
+  void copyNode(const ASTNode& orig);
+  void copyChildren(const ASTNode& orig);
 };
 
 LIBSBML_CPP_NAMESPACE_END
@@ -0,0 +1,626 @@
+/**
+ * @file    ASTNodeDAG.cpp
+ * @brief   Implementation of ASTNodeDAG, a table of the distinct
+ *          subexpressions of a set of abstract syntax trees.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sbml/math/ASTNodeDAG.h>
+#include <sbml/math/ASTNode.h>
+#include <sbml/math/L3FormulaFormatter.h>
+#include <sbml/SBase.h>
+#include <sbml/SBMLTransforms.h>
+#include <sbml/util/List.h>
+#include <sbml/util/util.h>
+#include <sbml/xml/XMLAttributes.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+/** @cond doxygenLibsbmlInternal */
+
+static const unsigned int INITIAL_SLOTS = 64;
+
+/*
+ * FNV-1a over the given bytes.
+ */
+static unsigned long
+hashBytes(unsigned long hash, const void* data, size_t length)
+{
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < length; ++i)
+  {
+    hash ^= bytes[i];
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
+
+static unsigned long
+hashString(unsigned long hash, const std::string& value)
+{
+  return hashBytes(hash, value.c_str(), value.size());
+}
+
+
+static bool
+isRealType(int type)
+{
+  return type == AST_REAL || type == AST_REAL_E;
+}
+
+
+/*
+ * Numbers and the arithmetic operators never carry a name of their own.
+ */
+static bool
+mayHaveName(int type)
+{
+  switch (type)
+  {
+  case AST_PLUS:
+  case AST_MINUS:
+  case AST_TIMES:
+  case AST_DIVIDE:
+  case AST_POWER:
+  case AST_INTEGER:
+  case AST_REAL:
+  case AST_REAL_E:
+  case AST_RATIONAL:
+    return false;
+  default:
+    return true;
+  }
+}
+
+
+static bool
+hasDefinitionURL(const ASTNode* node)
+{
+  const XMLAttributes* url = node->getDefinitionURL();
+  return url != NULL && !url->isEmpty();
+}
+
+/** @endcond */
+
+
+ASTNodeDAG::ASTNodeDAG()
+  : mSlots(INITIAL_SLOTS, -1)
+  , mNumNodesAdded(0)
+{
+  mChildStarts.push_back(0);
+}
+
+
+ASTNodeDAG::~ASTNodeDAG()
+{
+}
+
+
+int
+ASTNodeDAG::add(const ASTNode* node)
+{
+  if (node == NULL)
+  {
+    return -1;
+  }
+
+  unsigned long hash = hashNode(node);
+  std::vector<unsigned int> children;
+  children.reserve(node->getNumChildren());
+  for (unsigned int i = 0; i < node->getNumChildren(); ++i)
+  {
+    int child = add(node->getChild(i));
+    if (child < 0)
+    {
+      continue;
+    }
+    children.push_back((unsigned int)child);
+    hash = combineHash(hash, mHashes[child]);
+  }
+
+  ++mNumNodesAdded;
+
+  int id = lookup(node, hash, children);
+  if (id < 0)
+  {
+    id = (int)mNodes.size();
+    mNodes.push_back(node);
+    mHashes.push_back(hash);
+    mChildren.insert(mChildren.end(), children.begin(), children.end());
+    mChildStarts.push_back((unsigned int)mChildren.size());
+    mOccurrences.push_back(0);
+    mValues.push_back(numeric_limits<double>::quiet_NaN());
+    mEvaluated.push_back(false);
+    mFormulas.push_back(std::string());
+    mFormatted.push_back(false);
+
+    if (2 * mNodes.size() > mSlots.size())
+    {
+      grow();
+    }
+    else
+    {
+      size_t mask = mSlots.size() - 1;
+      size_t slot = hash & mask;
+      while (mSlots[slot] != -1)
+      {
+        slot = (slot + 1) & mask;
+      }
+      mSlots[slot] = id;
+    }
+  }
+
+  ++mOccurrences[id];
+  return id;
+}
+
+
+int
+ASTNodeDAG::addAllMath(SBase* element)
+{
+  if (element == NULL)
+  {
+    return LIBSBML_INVALID_OBJECT;
+  }
+
+  add(element->getMath());
+
+  List* elements = element->getAllElements();
+  for (ListIterator iter = elements->begin(); iter != elements->end(); ++iter)
+  {
+    add(static_cast<SBase*>(*iter)->getMath());
+  }
+  delete elements;
+
+  return LIBSBML_OPERATION_SUCCESS;
+}
+
+
+int
+ASTNodeDAG::find(const ASTNode* node) const
+{
+  if (node == NULL)
+  {
+    return -1;
+  }
+
+  unsigned long hash = hashNode(node);
+  std::vector<unsigned int> children;
+  children.reserve(node->getNumChildren());
+  for (unsigned int i = 0; i < node->getNumChildren(); ++i)
+  {
+    int child = find(node->getChild(i));
+    if (child < 0)
+    {
+      return -1;
+    }
+    children.push_back((unsigned int)child);
+    hash = combineHash(hash, mHashes[child]);
+  }
+
+  return lookup(node, hash, children);
+}
+
+
+void
+ASTNodeDAG::clear()
+{
+  mNodes.clear();
+  mHashes.clear();
+  mChildStarts.clear();
+  mChildStarts.push_back(0);
+  mChildren.clear();
+  mOccurrences.clear();
+  mSlots.assign(INITIAL_SLOTS, -1);
+  mNumNodesAdded = 0;
+  mValues.clear();
+  mEvaluated.clear();
+  mFormulas.clear();
+  mFormatted.clear();
+}
+
+
+unsigned int
+ASTNodeDAG::getNumExpressions() const
+{
+  return (unsigned int)mNodes.size();
+}
+
+
+unsigned int
+ASTNodeDAG::getNumNodesAdded() const
+{
+  return mNumNodesAdded;
+}
+
+
+const ASTNode*
+ASTNodeDAG::getExpression(unsigned int id) const
+{
+  return id < mNodes.size() ? mNodes[id] : NULL;
+}
+
+
+unsigned int
+ASTNodeDAG::getNumChildren(unsigned int id) const
+{
+  if (id >= mNodes.size())
+  {
+    return 0;
+  }
+  return mChildStarts[id + 1] - mChildStarts[id];
+}
+
+
+int
+ASTNodeDAG::getChild(unsigned int id, unsigned int n) const
+{
+  if (n >= getNumChildren(id))
+  {
+    return -1;
+  }
+  return (int)mChildren[mChildStarts[id] + n];
+}
+
+
+unsigned int
+ASTNodeDAG::getNumOccurrences(unsigned int id) const
+{
+  return id < mNodes.size() ? mOccurrences[id] : 0;
+}
+
+
+unsigned long
+ASTNodeDAG::getHash(unsigned int id) const
+{
+  return id < mNodes.size() ? mHashes[id] : 0;
+}
+
+
+double
+ASTNodeDAG::evaluate(unsigned int id, const Model* m)
+{
+  if (id >= mNodes.size())
+  {
+    return numeric_limits<double>::quiet_NaN();
+  }
+  if (mEvaluated[id])
+  {
+    return mValues[id];
+  }
+
+  const ASTNode* node = mNodes[id];
+  unsigned int numChildren = getNumChildren(id);
+  const unsigned int* children =
+    numChildren > 0 ? &mChildren[mChildStarts[id]] : NULL;
+  bool arithmetic = numChildren == node->getNumChildren();
+  double result = 0;
+
+  switch (arithmetic ? node->getType() : AST_UNKNOWN)
+  {
+  case AST_PLUS:
+    for (unsigned int i = 0; i < numChildren; ++i)
+    {
+      result = (i == 0) ? evaluate(children[i], m)
+                        : result + evaluate(children[i], m);
+    }
+    break;
+
+  case AST_TIMES:
+    result = 1.0;
+    for (unsigned int i = 0; i < numChildren; ++i)
+    {
+      result = (i == 0) ? evaluate(children[i], m)
+                        : result * evaluate(children[i], m);
+    }
+    break;
+
+  case AST_MINUS:
+    if (numChildren == 1)
+    {
+      result = -evaluate(children[0], m);
+    }
+    else if (numChildren == 2)
+    {
+      result = evaluate(children[0], m) - evaluate(children[1], m);
+    }
+    else
+    {
+      result = SBMLTransforms::evaluateASTNode(node, m);
+    }
+    break;
+
+  case AST_DIVIDE:
+    if (numChildren == 2)
+    {
+      result = evaluate(children[0], m) / evaluate(children[1], m);
+    }
+    else
+    {
+      result = SBMLTransforms::evaluateASTNode(node, m);
+    }
+    break;
+
+  case AST_POWER:
+  case AST_FUNCTION_POWER:
+    if (numChildren == 2)
+    {
+      result = pow(evaluate(children[0], m), evaluate(children[1], m));
+    }
+    else
+    {
+      result = SBMLTransforms::evaluateASTNode(node, m);
+    }
+    break;
+
+  default:
+    result = SBMLTransforms::evaluateASTNode(node, m);
+    break;
+  }
+
+  mValues[id] = result;
+  mEvaluated[id] = true;
+  return result;
+}
+
+
+void
+ASTNodeDAG::clearValues()
+{
+  mEvaluated.assign(mEvaluated.size(), false);
+}
+
+
+const std::string&
+ASTNodeDAG::getFormula(unsigned int id)
+{
+  static const std::string empty;
+  if (id >= mNodes.size())
+  {
+    return empty;
+  }
+
+  if (!mFormatted[id])
+  {
+    char* formula = SBML_formulaToL3String(mNodes[id]);
+    if (formula != NULL)
+    {
+      mFormulas[id] = formula;
+    }
+    safe_free(formula);
+    mFormatted[id] = true;
+  }
+  return mFormulas[id];
+}
+
+
+unsigned long
+ASTNodeDAG::getStructuralHash(const ASTNode* node)
+{
+  if (node == NULL)
+  {
+    return 0;
+  }
+
+  unsigned long hash = hashNode(node);
+  for (unsigned int i = 0; i < node->getNumChildren(); ++i)
+  {
+    const ASTNode* child = node->getChild(i);
+    if (child != NULL)
+    {
+      hash = combineHash(hash, getStructuralHash(child));
+    }
+  }
+  return hash;
+}
+
+
+bool
+ASTNodeDAG::equals(const ASTNode* node1, const ASTNode* node2)
+{
+  if (node1 == NULL || node2 == NULL)
+  {
+    return node1 == node2;
+  }
+  if (node1 == node2)
+  {
+    return true;
+  }
+  if (node1->getNumChildren() != node2->getNumChildren() ||
+      !haveEqualValues(node1, node2))
+  {
+    return false;
+  }
+
+  for (unsigned int i = 0; i < node1->getNumChildren(); ++i)
+  {
+    if (!equals(node1->getChild(i), node2->getChild(i)))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+
+int
+ASTNodeDAG::lookup(const ASTNode* node, unsigned long hash,
+                   const std::vector<unsigned int>& children) const
+{
+  size_t mask = mSlots.size() - 1;
+  size_t slot = hash & mask;
+  while (mSlots[slot] != -1)
+  {
+    unsigned int id = (unsigned int)mSlots[slot];
+    if (mHashes[id] == hash &&
+        getNumChildren(id) == children.size() &&
+        std::equal(children.begin(), children.end(),
+                   mChildren.begin() + mChildStarts[id]) &&
+        haveEqualValues(mNodes[id], node))
+    {
+      return (int)id;
+    }
+    slot = (slot + 1) & mask;
+  }
+  return -1;
+}
+
+
+void
+ASTNodeDAG::grow()
+{
+  mSlots.assign(2 * mSlots.size(), -1);
+  size_t mask = mSlots.size() - 1;
+  for (unsigned int id = 0; id < mNodes.size(); ++id)
+  {
+    size_t slot = mHashes[id] & mask;
+    while (mSlots[slot] != -1)
+    {
+      slot = (slot + 1) & mask;
+    }
+    mSlots[slot] = (int)id;
+  }
+}
+
+
+/*
+ * Hashes everything haveEqualValues() compares, so that nodes with equal
+ * values have equal hashes.
+ */
+unsigned long
+ASTNodeDAG::hashNode(const ASTNode* node)
+{
+  unsigned long hash = 2166136261UL;
+  int type = node->getType();
+  hash = hashBytes(hash, &type, sizeof(type));
+
+  if (type == AST_INTEGER)
+  {
+    long value = node->getInteger();
+    hash = hashBytes(hash, &value, sizeof(value));
+  }
+  else if (type == AST_RATIONAL)
+  {
+    long value = node->getNumerator();
+    hash = hashBytes(hash, &value, sizeof(value));
+    value = node->getDenominator();
+    hash = hashBytes(hash, &value, sizeof(value));
+  }
+  else if (isRealType(type))
+  {
+    double mantissa = node->getMantissa();
+    long exponent = node->getExponent();
+    hash = hashBytes(hash, &mantissa, sizeof(mantissa));
+    hash = hashBytes(hash, &exponent, sizeof(exponent));
+  }
+
+  const char* name = mayHaveName(type) ? node->getName() : NULL;
+  if (name != NULL)
+  {
+    hash = hashBytes(hash, name, strlen(name));
+  }
+  if (node->isSetUnits())
+  {
+    hash = hashString(hash, node->getUnits());
+  }
+  if (node->isBvar())
+  {
+    hash = combineHash(hash, 1);
+  }
+  if (hasDefinitionURL(node))
+  {
+    hash = hashString(hash, node->getDefinitionURLString());
+  }
+  return hash;
+}
+
+
+unsigned long
+ASTNodeDAG::combineHash(unsigned long hash, unsigned long value)
+{
+  return hash ^ (value + 0x9e3779b9UL + (hash << 6) + (hash >> 2));
+}
+
+
+/*
+ * Compares the nodes themselves, without their children.  Reals are
+ * compared bitwise, so that NaN equals NaN and 0 differs from -0.
+ */
+bool
+ASTNodeDAG::haveEqualValues(const ASTNode* node1, const ASTNode* node2)
+{
+  int type = node1->getType();
+  if (type != node2->getType() || node1->isBvar() != node2->isBvar())
+  {
+    return false;
+  }
+
+  if (type == AST_INTEGER)
+  {
+    if (node1->getInteger() != node2->getInteger())
+      return false;
+  }
+  else if (type == AST_RATIONAL)
+  {
+    if (node1->getNumerator() != node2->getNumerator() ||
+        node1->getDenominator() != node2->getDenominator())
+      return false;
+  }
+  else if (isRealType(type))
+  {
+    double mantissa1 = node1->getMantissa();
+    double mantissa2 = node2->getMantissa();
+    if (memcmp(&mantissa1, &mantissa2, sizeof(double)) != 0 ||
+        node1->getExponent() != node2->getExponent())
+      return false;
+  }
+
+  const char* name1 = mayHaveName(type) ? node1->getName() : NULL;
+  const char* name2 = mayHaveName(type) ? node2->getName() : NULL;
+  if (name1 != name2 &&
+      (name1 == NULL || name2 == NULL || strcmp(name1, name2) != 0))
+  {
+    return false;
+  }
+
+  if ((node1->isSetUnits() || node2->isSetUnits()) &&
+      node1->getUnits() != node2->getUnits())
+  {
+    return false;
+  }
+
+  return (!hasDefinitionURL(node1) && !hasDefinitionURL(node2)) ||
+         node1->getDefinitionURLString() == node2->getDefinitionURLString();
+}
+
+/** @endcond */
+
+
+LIBSBML_CPP_NAMESPACE_END
@@ -0,0 +1,307 @@
+/**
+ * @file    ASTNodeDAG.h
+ * @brief   Definition of ASTNodeDAG, a table of the distinct subexpressions
+ *          of a set of abstract syntax trees.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class ASTNodeDAG
+ * @sbmlbrief{core} The distinct subexpressions of a set of ASTNode trees.
+ *
+ * @htmlinclude libsbml-facility-only-warning.html
+ *
+ * Large models tend to repeat the same subexpressions, such as the
+ * <code>compartment * k * S</code> of mass-action rate laws, many times
+ * over.  An ASTNodeDAG merges the trees added to it into a directed acyclic
+ * graph in which every structurally distinct subexpression appears once and
+ * is identified by a small integer.  Two subtrees are structurally equal when
+ * they have the same type, name, value, units, definitionURL and bvar flag,
+ * and their children are pairwise equal in order; the 'id', 'class' and
+ * 'style' attributes and any semantic annotations are ignored.
+ *
+ * Each subtree is hashed and looked up once, using the identifiers already
+ * found for its children, so adding a tree takes time linear in its size.
+ * The trees added are not copied: every distinct subexpression refers to the
+ * first ASTNode found for it, and the trees have to outlive the ASTNodeDAG
+ * or the next call to clear().
+ *
+ * Results of evaluate() and getFormula() are kept for each distinct
+ * subexpression, so that they are computed once however often it occurs.
+ */
+
+#ifndef ASTNodeDAG_h
+#define ASTNodeDAG_h
+
+#include <sbml/common/extern.h>
+#include <sbml/common/operationReturnValues.h>
+
+#ifdef __cplusplus
+
+#include <string>
+#include <vector>
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+class ASTNode;
+class Model;
+class SBase;
+
+
+class LIBSBML_EXTERN ASTNodeDAG
+{
+public:
+
+  /**
+   * Creates a new, empty ASTNodeDAG.
+   */
+  ASTNodeDAG();
+
+
+  /**
+   * Destroys this ASTNodeDAG.  The trees added to it are left untouched.
+   */
+  virtual ~ASTNodeDAG();
+
+
+  /**
+   * Adds the tree rooted at the given node.
+   *
+   * @param node the root of the tree to add; it has to outlive this
+   * ASTNodeDAG.
+   *
+   * @return the identifier of the subexpression @p node stands for, or
+   * @c -1 if @p node is @c NULL.
+   */
+  int add(const ASTNode* node);
+
+
+  /**
+   * Adds the math of the given element and of all its descendants,
+   * including those of package plugins.
+   *
+   * @param element the SBase object whose math to add.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBSBML_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBSBML_INVALID_OBJECT, OperationReturnValues_t}
+   */
+  int addAllMath(SBase* element);
+
+
+  /**
+   * Returns the identifier of the subexpression the tree rooted at the
+   * given node stands for, without adding it.
+   *
+   * @param node the root of the tree to look up.
+   *
+   * @return the identifier of the subexpression, or @c -1 if it has not
+   * been added.
+   */
+  int find(const ASTNode* node) const;
+
+
+  /**
+   * Removes all subexpressions and cached results from this ASTNodeDAG.
+   */
+  void clear();
+
+
+  /**
+   * Returns the number of distinct subexpressions.
+   *
+   * @return the number of subexpressions; identifiers run from @c 0 to one
+   * less than this number.
+   */
+  unsigned int getNumExpressions() const;
+
+
+  /**
+   * Returns the number of nodes in all trees added so far.
+   *
+   * @return the number of nodes added, counting each occurrence.
+   */
+  unsigned int getNumNodesAdded() const;
+
+
+  /**
+   * Returns the first node added for the subexpression with the given
+   * identifier.
+   *
+   * @param id the identifier of the subexpression.
+   *
+   * @return the ASTNode, or @c NULL if there is no such subexpression.
+   */
+  const ASTNode* getExpression(unsigned int id) const;
+
+
+  /**
+   * Returns the number of children of the subexpression with the given
+   * identifier.
+   *
+   * @param id the identifier of the subexpression.
+   *
+   * @return the number of children, or @c 0 if there is no such
+   * subexpression.
+   */
+  unsigned int getNumChildren(unsigned int id) const;
+
+
+  /**
+   * Returns the identifier of the @p n-th child of the subexpression with
+   * the given identifier.
+   *
+   * @param id the identifier of the subexpression.
+   * @param n the index of the child.
+   *
+   * @return the identifier of the child, or @c -1 if there is no such
+   * child.
+   */
+  int getChild(unsigned int id, unsigned int n) const;
+
+
+  /**
+   * Returns how often the subexpression with the given identifier occurs in
+   * the trees added so far.
+   *
+   * @param id the identifier of the subexpression.
+   *
+   * @return the number of occurrences.
+   */
+  unsigned int getNumOccurrences(unsigned int id) const;
+
+
+  /**
+   * Returns the structural hash of the subexpression with the given
+   * identifier, which is the value getStructuralHash() returns for any
+   * of its occurrences.
+   *
+   * @param id the identifier of the subexpression.
+   *
+   * @return the hash, or @c 0 if there is no such subexpression.
+   */
+  unsigned long getHash(unsigned int id) const;
+
+
+  /**
+   * Evaluates the subexpression with the given identifier.
+   *
+   * Sums, differences, products, quotients and powers are computed from the
+   * cached values of their children; all other subexpressions are evaluated
+   * by SBMLTransforms::evaluateASTNode(const ASTNode*, const Model*).  The
+   * values are kept until clearValues() is called, which has to be done
+   * whenever the values of the model change.
+   *
+   * @param id the identifier of the subexpression.
+   * @param m the Model supplying the values of names, or @c NULL.
+   *
+   * @return the value, or NaN if there is no such subexpression.
+   */
+  double evaluate(unsigned int id, const Model* m = NULL);
+
+
+  /**
+   * Forgets the values computed by evaluate().
+   */
+  void clearValues();
+
+
+  /**
+   * Returns the subexpression with the given identifier as an
+   * SBML Level&nbsp;3 text-string formula.
+   *
+   * @param id the identifier of the subexpression.
+   *
+   * @return the formula, as SBML_formulaToL3String() would write it, or an
+   * empty string if there is no such subexpression.
+   */
+  const std::string& getFormula(unsigned int id);
+
+
+  /**
+   * Returns a hash of the tree rooted at the given node such that
+   * structurally equal trees have equal hashes.
+   *
+   * @param node the root of the tree.
+   *
+   * @return the hash, or @c 0 if @p node is @c NULL.
+   */
+  static unsigned long getStructuralHash(const ASTNode* node);
+
+
+  /**
+   * Returns whether the trees rooted at the given nodes are structurally
+   * equal.
+   *
+   * @param node1 the root of the first tree.
+   * @param node2 the root of the second tree.
+   *
+   * @return @c true if both trees are equal or both nodes are @c NULL,
+   * @c false otherwise.
+   */
+  static bool equals(const ASTNode* node1, const ASTNode* node2);
+
+
+protected:
+  /** @cond doxygenLibsbmlInternal */
+
+  int lookup(const ASTNode* node, unsigned long hash,
+             const std::vector<unsigned int>& children) const;
+
+  void grow();
+
+  static unsigned long hashNode(const ASTNode* node);
+
+  static unsigned long combineHash(unsigned long hash, unsigned long value);
+
+  static bool haveEqualValues(const ASTNode* node1, const ASTNode* node2);
+
+  // the first node, hash, children and count of each subexpression
+  std::vector<const ASTNode*> mNodes;
+  std::vector<unsigned long> mHashes;
+  std::vector<unsigned int> mChildStarts;
+  std::vector<unsigned int> mChildren;
+  std::vector<unsigned int> mOccurrences;
+
+  // open addressing table of subexpression identifiers, -1 marks a free slot
+  std::vector<int> mSlots;
+
+  unsigned int mNumNodesAdded;
+
+  std::vector<double> mValues;
+  std::vector<bool> mEvaluated;
+
+  std::vector<std::string> mFormulas;
+  std::vector<bool> mFormatted;
+
+  /** @endcond */
+
+private:
+  /** @cond doxygenLibsbmlInternal */
+
+  ASTNodeDAG(const ASTNodeDAG&);
+  ASTNodeDAG& operator=(const ASTNodeDAG&);
+
+  /** @endcond */
+};
+
+
+LIBSBML_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+#endif  /* ASTNodeDAG_h */
@@ -0,0 +1,110 @@
+/**
+ * @file    ASTNodeVisitor.cpp
+ * @brief   Implementation of ASTNodeVisitor, a depth-first traversal of an
+ *          abstract syntax tree that does not recurse.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sbml/math/ASTNodeVisitor.h>
+#include <sbml/math/ASTNode.h>
+
+#include <utility>
+#include <vector>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+
+ASTNodeVisitor::ASTNodeVisitor()
+{
+}
+
+
+ASTNodeVisitor::~ASTNodeVisitor()
+{
+}
+
+
+bool
+ASTNodeVisitor::traverse(const ASTNode* node)
+{
+  if (node == NULL)
+  {
+    return true;
+  }
+  if (!visitPreOrder(node))
+  {
+    return false;
+  }
+
+  // each entry holds a node whose children are being visited and the index
+  // of the next child to visit
+  vector< pair<const ASTNode*, unsigned int> > stack;
+  stack.push_back(make_pair(node, 0u));
+
+  while (!stack.empty())
+  {
+    const ASTNode* current = stack.back().first;
+    unsigned int n = stack.back().second;
+
+    if (n < current->getNumChildren())
+    {
+      ++stack.back().second;
+      const ASTNode* child = current->getChild(n);
+      if (child == NULL)
+      {
+        continue;
+      }
+      if (!visitPreOrder(child))
+      {
+        return false;
+      }
+      stack.push_back(make_pair(child, 0u));
+    }
+    else
+    {
+      stack.pop_back();
+      if (!visitPostOrder(current))
+      {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+
+bool
+ASTNodeVisitor::visitPreOrder(const ASTNode*)
+{
+  return true;
+}
+
+
+bool
+ASTNodeVisitor::visitPostOrder(const ASTNode*)
+{
+  return true;
+}
+
+
+LIBSBML_CPP_NAMESPACE_END
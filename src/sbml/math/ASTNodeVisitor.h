@@ -0,0 +1,107 @@
+/**
+ * @file    ASTNodeVisitor.h
+ * @brief   Definition of ASTNodeVisitor, a depth-first traversal of an
+ *          abstract syntax tree that does not recurse.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class ASTNodeVisitor
+ * @sbmlbrief{core} Depth-first traversal of an ASTNode tree.
+ *
+ * @htmlinclude libsbml-facility-only-warning.html
+ *
+ * Machine-generated models can contain expressions nested many thousands
+ * of levels deep, for instance long sums converted to binary operators.
+ * Functions that walk such trees by calling themselves on each child run
+ * out of stack.  An ASTNodeVisitor walks a tree with an explicit stack
+ * instead, calling visitPreOrder() for each node before its children and
+ * visitPostOrder() after them.  Either method can end the traversal early
+ * by returning @c false.
+ *
+ * Subclasses override the methods they need; the default implementations
+ * do nothing and continue the traversal.  The tree must not be changed
+ * while it is being traversed, except for the node being visited in
+ * visitPostOrder().
+ */
+
+#ifndef ASTNodeVisitor_h
+#define ASTNodeVisitor_h
+
+#include <sbml/common/extern.h>
+
+#ifdef __cplusplus
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+class ASTNode;
+
+
+class LIBSBML_EXTERN ASTNodeVisitor
+{
+public:
+
+  /**
+   * Creates a new ASTNodeVisitor.
+   */
+  ASTNodeVisitor();
+
+
+  /**
+   * Destroys this ASTNodeVisitor.
+   */
+  virtual ~ASTNodeVisitor();
+
+
+  /**
+   * Visits the nodes of the tree rooted at the given node, depth first and
+   * children in order.
+   *
+   * @param node the root of the tree to traverse.
+   *
+   * @return @c true if all nodes were visited, @c false if a visit method
+   * ended the traversal early.
+   */
+  bool traverse(const ASTNode* node);
+
+
+  /**
+   * Called for each node before its children are visited.
+   *
+   * @param node the node being visited.
+   *
+   * @return @c true to continue the traversal, @c false to end it.
+   */
+  virtual bool visitPreOrder(const ASTNode* node);
+
+
+  /**
+   * Called for each node after its children have been visited.
+   *
+   * @param node the node being visited.
+   *
+   * @return @c true to continue the traversal, @c false to end it.
+   */
+  virtual bool visitPostOrder(const ASTNode* node);
+};
+
+
+LIBSBML_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+#endif  /* ASTNodeVisitor_h */
@@ -44,6 +44,9 @@
 #include <sbml/math/ASTNodeType.h>
 
 #include <sbml/util/util.h>
+
+#include <vector>
+
 LIBSBML_CPP_NAMESPACE_BEGIN
 
 /**
@@ -310,36 +313,186 @@ FormulaFormatter_formatReal (StringBuffer_t *sb, const ASTNode_t *node)
   }
 }
 
-/**
- * Visits the given ASTNode node.  This function is really just a
- * dispatcher to either SBML_formulaToString_visitFunction() or
- * SBML_formulaToString_visitOther().
+/*
+ * The visit functions do not call FormulaFormatter_visit() for the
+ * children of a node, as the calls would nest as deep as the tree.  Each
+ * writes what precedes the first child and pushes what follows on a stack
+ * of tasks, last to first, that FormulaFormatter_visit() carries out.
  */
-void
-FormulaFormatter_visit ( const ASTNode_t *parent,
+struct FormatterTask
+{
+  enum Kind { VISIT, TEXT, FORMAT };
+
+  Kind             kind;
+  const ASTNode_t* parent;
+  const ASTNode_t* node;
+  const char*      text;
+};
+
+typedef std::vector<FormatterTask> FormatterTasks;
+
+
+static void
+pushVisit (FormatterTasks& tasks, const ASTNode_t* parent, const ASTNode_t* node)
+{
+  FormatterTask task = { FormatterTask::VISIT, parent, node, NULL };
+  tasks.push_back(task);
+}
+
+
+static void
+pushText (FormatterTasks& tasks, const char* text)
+{
+  FormatterTask task = { FormatterTask::TEXT, NULL, NULL, text };
+  tasks.push_back(task);
+}
+
+
+/*
+ * Pushes the formatting of the given node as an operator between two of
+ * its children.
+ */
+static void
+pushFormat (FormatterTasks& tasks, const ASTNode_t* node)
+{
+  FormatterTask task = { FormatterTask::FORMAT, NULL, node, NULL };
+  tasks.push_back(task);
+}
+
+
+static void
+FormulaFormatter_startFunction ( const ASTNode_t *parent,
+                                 const ASTNode_t *node,
+                                 StringBuffer_t  *sb,
+                                 FormatterTasks& tasks )
+{
+  unsigned int numChildren = ASTNode_getNumChildren(node);
+  unsigned int n;
+
+
+  FormulaFormatter_format(sb, node);
+  StringBuffer_appendChar(sb, '(');
+
+  pushText(tasks, ")");
+  for (n = numChildren; n > 0; n--)
+  {
+    pushVisit(tasks, node, ASTNode_getChild(node, n - 1));
+    if (n > 1)
+    {
+      pushText(tasks, ", ");
+    }
+  }
+}
+
+
+static void
+FormulaFormatter_startLog10 ( const ASTNode_t *parent,
+                              const ASTNode_t *node,
+                              StringBuffer_t  *sb,
+                              FormatterTasks& tasks )
+{
+  StringBuffer_append(sb, "log10(");
+  pushText(tasks, ")");
+  pushVisit(tasks, node, ASTNode_getChild(node, 1));
+}
+
+
+static void
+FormulaFormatter_startSqrt ( const ASTNode_t *parent,
+                             const ASTNode_t *node,
+                             StringBuffer_t  *sb,
+                             FormatterTasks& tasks )
+{
+  StringBuffer_append(sb, "sqrt(");
+  pushText(tasks, ")");
+  pushVisit(tasks, node, ASTNode_getChild(node, 1));
+}
+
+
+static void
+FormulaFormatter_startUMinus ( const ASTNode_t *parent,
+                               const ASTNode_t *node,
+                               StringBuffer_t  *sb,
+                               FormatterTasks& tasks )
+{
+  StringBuffer_appendChar(sb, '-');
+  pushVisit(tasks, node, ASTNode_getLeftChild(node));
+}
+
+
+static void
+FormulaFormatter_startOther ( const ASTNode_t *parent,
+                              const ASTNode_t *node,
+                              StringBuffer_t  *sb,
+                              FormatterTasks& tasks )
+{
+  unsigned int numChildren = ASTNode_getNumChildren(node);
+  int group       = FormulaFormatter_isGrouped(parent, node);
+  unsigned int n;
+
+
+  if (group)
+  {
+    StringBuffer_appendChar(sb, '(');
+    pushText(tasks, ")");
+  }
+
+  if (numChildren == 0) {
+    FormulaFormatter_format(sb, node);
+  }
+
+  else if (numChildren == 1)
+  {
+    //I believe this would only be called for invalid ASTNode setups,
+    // but this could in theory occur.  This is the safest 
+    // behavior I can think of.
+    FormulaFormatter_format(sb, node);
+    StringBuffer_appendChar(sb, '(');
+    pushText(tasks, ")");
+    pushVisit(tasks, node, ASTNode_getChild(node, 0));
+  }
+
+  else {
+    for (n = numChildren - 1; n > 0; n--)
+    {
+      pushVisit(tasks, node, ASTNode_getChild(node, n));
+      pushFormat(tasks, node);
+    }
+    pushVisit(tasks, node, ASTNode_getChild(node, 0));
+  }
+}
+
+
+/*
+ * Writes what precedes the first child of the given node, and pushes the
+ * tasks that write the rest of it.
+ */
+static void
+FormulaFormatter_start ( const ASTNode_t *parent,
                          const ASTNode_t *node,
-                         StringBuffer_t  *sb )
+                         StringBuffer_t  *sb,
+                         FormatterTasks& tasks )
 {
 
   if (ASTNode_isLog10(node))
   {
-    FormulaFormatter_visitLog10(parent, node, sb);
+    FormulaFormatter_startLog10(parent, node, sb, tasks);
   }
   else if (ASTNode_isSqrt(node))
   {
-    FormulaFormatter_visitSqrt(parent, node, sb);
+    FormulaFormatter_startSqrt(parent, node, sb, tasks);
   }
   else if (FormulaFormatter_isFunction(node))
   {
-    FormulaFormatter_visitFunction(parent, node, sb);
+    FormulaFormatter_startFunction(parent, node, sb, tasks);
   }
   else if (ASTNode_hasTypeAndNumChildren(node, AST_MINUS, 1))
   {
-    FormulaFormatter_visitUMinus(parent, node, sb);
+    FormulaFormatter_startUMinus(parent, node, sb, tasks);
   }
   else if (ASTNode_hasTypeAndNumChildren(node, AST_PLUS, 1) || ASTNode_hasTypeAndNumChildren(node, AST_TIMES, 1))
   {
-    FormulaFormatter_visit(node, ASTNode_getChild(node, 0), sb);
+    pushVisit(tasks, node, ASTNode_getChild(node, 0));
   }
   else if (ASTNode_hasTypeAndNumChildren(node, AST_PLUS, 0))
   {
@@ -351,11 +504,56 @@ FormulaFormatter_visit ( const ASTNode_t *parent,
   }
   else
   {
-    FormulaFormatter_visitOther(parent, node, sb);
+    FormulaFormatter_startOther(parent, node, sb, tasks);
+  }
+}
+
+
+/*
+ * Carries out the tasks, the next one last, until none is left.
+ */
+static void
+FormulaFormatter_run (StringBuffer_t *sb, FormatterTasks& tasks)
+{
+  while (!tasks.empty())
+  {
+    FormatterTask task = tasks.back();
+    tasks.pop_back();
+
+    switch (task.kind)
+    {
+    case FormatterTask::VISIT:
+      FormulaFormatter_start(task.parent, task.node, sb, tasks);
+      break;
+
+    case FormatterTask::TEXT:
+      StringBuffer_append(sb, task.text);
+      break;
+
+    case FormatterTask::FORMAT:
+      FormulaFormatter_format(sb, task.node);
+      break;
+    }
   }
 }
 
 
+/**
+ * Visits the given ASTNode node.  This function is really just a
+ * dispatcher to either SBML_formulaToString_visitFunction() or
+ * SBML_formulaToString_visitOther().
+ */
+void
+FormulaFormatter_visit ( const ASTNode_t *parent,
+                         const ASTNode_t *node,
+                         StringBuffer_t  *sb )
+{
+  FormatterTasks tasks;
+  pushVisit(tasks, parent, node);
+  FormulaFormatter_run(sb, tasks);
+}
+
+
 /**
  * Visits the given ASTNode as a function.  For this node only the
  * traversal is preorder.
@@ -365,26 +563,9 @@ FormulaFormatter_visitFunction ( const ASTNode_t *parent,
                                  const ASTNode_t *node,
                                  StringBuffer_t  *sb )
 {
-  unsigned int numChildren = ASTNode_getNumChildren(node);
-  unsigned int n;
-
-
-  FormulaFormatter_format(sb, node);
-  StringBuffer_appendChar(sb, '(');
-
-  if (numChildren > 0)
-  {
-    FormulaFormatter_visit( node, ASTNode_getChild(node, 0), sb );
-  }
-
-  for (n = 1; n < numChildren; n++)
-  {
-    StringBuffer_appendChar(sb, ',');
-    StringBuffer_appendChar(sb, ' ');
-    FormulaFormatter_visit( node, ASTNode_getChild(node, n), sb );
-  }
-
-  StringBuffer_appendChar(sb, ')');
+  FormatterTasks tasks;
+  FormulaFormatter_startFunction(parent, node, sb, tasks);
+  FormulaFormatter_run(sb, tasks);
 }
 
 
@@ -397,9 +578,9 @@ FormulaFormatter_visitLog10 ( const ASTNode_t *parent,
                               const ASTNode_t *node,
                               StringBuffer_t  *sb )
 {
-  StringBuffer_append(sb, "log10(");
-  FormulaFormatter_visit(node, ASTNode_getChild(node, 1), sb);
-  StringBuffer_appendChar(sb, ')');
+  FormatterTasks tasks;
+  FormulaFormatter_startLog10(parent, node, sb, tasks);
+  FormulaFormatter_run(sb, tasks);
 }
 
 
@@ -412,9 +593,9 @@ FormulaFormatter_visitSqrt ( const ASTNode_t *parent,
                              const ASTNode_t *node,
                              StringBuffer_t  *sb )
 {
-  StringBuffer_append(sb, "sqrt(");
-  FormulaFormatter_visit(node, ASTNode_getChild(node, 1), sb);
-  StringBuffer_appendChar(sb, ')');
+  FormatterTasks tasks;
+  FormulaFormatter_startSqrt(parent, node, sb, tasks);
+  FormulaFormatter_run(sb, tasks);
 }
 
 
@@ -427,8 +608,9 @@ FormulaFormatter_visitUMinus ( const ASTNode_t *parent,
                                const ASTNode_t *node,
                                StringBuffer_t  *sb )
 {
-  StringBuffer_appendChar(sb, '-');
-  FormulaFormatter_visit ( node, ASTNode_getLeftChild(node), sb );
+  FormatterTasks tasks;
+  FormulaFormatter_startUMinus(parent, node, sb, tasks);
+  FormulaFormatter_run(sb, tasks);
 }
 
 
@@ -440,45 +622,9 @@ FormulaFormatter_visitOther ( const ASTNode_t *parent,
                               const ASTNode_t *node,
                               StringBuffer_t  *sb )
 {
-  unsigned int numChildren = ASTNode_getNumChildren(node);
-  int group       = FormulaFormatter_isGrouped(parent, node);
-  unsigned int n;
-
-
-  if (group)
-  {
-    StringBuffer_appendChar(sb, '(');
-  }
-
-  if (numChildren == 0) {
-    FormulaFormatter_format(sb, node);
-  }
-
-  else if (numChildren == 1)
-  {
-    //I believe this would only be called for invalid ASTNode setups,
-    // but this could in theory occur.  This is the safest 
-    // behavior I can think of.
-    FormulaFormatter_format(sb, node);
-    StringBuffer_appendChar(sb, '(');
-    FormulaFormatter_visit( node, ASTNode_getChild(node, 0), sb );
-    StringBuffer_appendChar(sb, ')');
-  }
-
-  else {
-    FormulaFormatter_visit( node, ASTNode_getChild(node, 0), sb );
-
-    for (n = 1; n < numChildren; n++)
-    {
-      FormulaFormatter_format(sb, node);
-      FormulaFormatter_visit( node, ASTNode_getChild(node, n), sb );
-    }
-  }
-
-  if (group)
-  {
-    StringBuffer_appendChar(sb, ')');
-  }
+  FormatterTasks tasks;
+  FormulaFormatter_startOther(parent, node, sb, tasks);
+  FormulaFormatter_run(sb, tasks);
 }
 /** @endcond */
 
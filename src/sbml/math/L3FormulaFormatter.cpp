@@ -53,6 +53,8 @@
 #include <sbml/extension/ASTBasePlugin.h>
 #include <assert.h>
 
+#include <vector>
+
 #include <sbml/util/util.h>
 
 LIBSBML_CPP_NAMESPACE_BEGIN
@@ -690,41 +692,257 @@ L3FormulaFormatter_formatLogicalRelational (StringBuffer_t *sb, const ASTNode_t
 }
 
 
-/**
- * Visits the given ASTNode node.  This function is really just a
- * dispatcher to either SBML_formulaToL3String_visitFunction() or
- * SBML_formulaToL3String_visitOther().
+/*
+ * The visit functions do not call L3FormulaFormatter_visit() for the
+ * children of a node, as the calls would nest as deep as the tree.  Each
+ * writes what precedes the first child and pushes what follows on a stack
+ * of tasks, last to first, that L3FormulaFormatter_visit() carries out.
  */
-void
-L3FormulaFormatter_visit ( const ASTNode_t *parent,
+struct L3FormatterTask
+{
+  enum Kind { VISIT, TEXT, FORMAT };
+
+  Kind             kind;
+  const ASTNode_t* parent;
+  const ASTNode_t* node;
+  const char*      text;
+};
+
+typedef std::vector<L3FormatterTask> L3FormatterTasks;
+
+
+static void
+pushVisit (L3FormatterTasks& tasks, const ASTNode_t* parent, const ASTNode_t* node)
+{
+  L3FormatterTask task = { L3FormatterTask::VISIT, parent, node, NULL };
+  tasks.push_back(task);
+}
+
+
+static void
+pushText (L3FormatterTasks& tasks, const char* text)
+{
+  L3FormatterTask task = { L3FormatterTask::TEXT, NULL, NULL, text };
+  tasks.push_back(task);
+}
+
+
+/*
+ * Pushes the formatting of the given node as an operator between two of
+ * its children.
+ */
+static void
+pushFormat (L3FormatterTasks& tasks, const ASTNode_t* node)
+{
+  L3FormatterTask task = { L3FormatterTask::FORMAT, NULL, node, NULL };
+  tasks.push_back(task);
+}
+
+
+static void
+L3FormulaFormatter_startFunction ( const ASTNode_t *parent,
+                                   const ASTNode_t *node,
+                                   StringBuffer_t  *sb, 
+                                   const L3ParserSettings_t *settings,
+                                   L3FormatterTasks& tasks )
+{
+  unsigned int numChildren = ASTNode_getNumChildren(node);
+  unsigned int n;
+
+
+  L3FormulaFormatter_format(sb, node, settings);
+  StringBuffer_appendChar(sb, '(');
+
+  pushText(tasks, ")");
+  for (n = numChildren; n > 0; n--)
+  {
+    pushVisit(tasks, node, ASTNode_getChild(node, n - 1));
+    if (n > 1)
+    {
+      pushText(tasks, ", ");
+    }
+  }
+}
+
+
+static void
+L3FormulaFormatter_startLog10 ( const ASTNode_t *parent,
+                                const ASTNode_t *node,
+                                StringBuffer_t  *sb, 
+                                L3FormatterTasks& tasks )
+{
+  StringBuffer_append(sb, "log10(");
+  pushText(tasks, ")");
+  pushVisit(tasks, node, ASTNode_getChild(node, 1));
+}
+
+
+static void
+L3FormulaFormatter_startSqrt ( const ASTNode_t *parent,
+                               const ASTNode_t *node,
+                               StringBuffer_t  *sb, 
+                               L3FormatterTasks& tasks )
+{
+  StringBuffer_append(sb, "sqrt(");
+  pushText(tasks, ")");
+  pushVisit(tasks, node, ASTNode_getChild(node, 1));
+}
+
+
+static void
+L3FormulaFormatter_startUMinus ( const ASTNode_t *parent,
+                                 const ASTNode_t *node,
+                                 StringBuffer_t  *sb, 
+                                 const L3ParserSettings_t *settings,
+                                 L3FormatterTasks& tasks )
+{
+  //Unary minus is *not* the highest precedence, since it is superceded by 'power'
+  unsigned int group;
+  
+  //If we are supposed to collapse minuses, do so.
+  if (L3ParserSettings_getParseCollapseMinus(settings)) {
+    if (ASTNode_getNumChildren(node) == 1 &&
+        ASTNode_isUMinus(ASTNode_getLeftChild(node))) {
+      pushVisit(tasks, parent, ASTNode_getLeftChild(ASTNode_getLeftChild(node)));
+      return;
+    }
+  }
+  
+  group = L3FormulaFormatter_isGrouped(parent, node, settings);
+
+  if (group)
+  {
+    StringBuffer_appendChar(sb, '(');
+    pushText(tasks, ")");
+  }
+  StringBuffer_appendChar(sb, '-');
+  pushVisit(tasks, node, ASTNode_getLeftChild(node));
+}
+
+
+static void
+L3FormulaFormatter_startUNot ( const ASTNode_t *parent,
+                               const ASTNode_t *node,
+                               StringBuffer_t  *sb, 
+                               const L3ParserSettings_t *settings,
+                               L3FormatterTasks& tasks )
+{
+  //Unary not is also not the highest precedence, since it is superceded by 'power'
+  unsigned int group       = L3FormulaFormatter_isGrouped(parent, node, settings);
+
+  if (group)
+  {
+    StringBuffer_appendChar(sb, '(');
+    pushText(tasks, ")");
+  }
+  StringBuffer_appendChar(sb, '!');
+  pushVisit(tasks, node, ASTNode_getLeftChild(node));
+}
+
+
+static void
+L3FormulaFormatter_startModulo ( const ASTNode_t *parent,
+                                 const ASTNode_t *node,
+                                 StringBuffer_t  *sb, 
+                                 const L3ParserSettings_t *settings,
+                                 L3FormatterTasks& tasks )
+{
+  unsigned int group       = L3FormulaFormatter_isGrouped(parent, node, settings);
+  const ASTNode_t* subnode = ASTNode_getLeftChild(node);
+  if (group)
+  {
+    StringBuffer_appendChar(sb, '(');
+    pushText(tasks, ")");
+  }
+
+  //Get x and y from the first child of the piecewise function, 
+  // then the first child of that (times), and the first child
+  // of that (minus).
+  pushVisit(tasks, node, ASTNode_getLeftChild(ASTNode_getRightChild(subnode)));
+  pushText(tasks, " % ");
+  pushVisit(tasks, node, ASTNode_getLeftChild(subnode));
+}
+
+
+static void
+L3FormulaFormatter_startOther ( const ASTNode_t *parent,
+                                const ASTNode_t *node,
+                                StringBuffer_t  *sb, 
+                                const L3ParserSettings_t *settings,
+                                L3FormatterTasks& tasks )
+{
+  unsigned int numChildren = ASTNode_getNumChildren(node);
+  unsigned int group       = L3FormulaFormatter_isGrouped(parent, node, settings);
+  unsigned int n;
+
+
+  if (group)
+  {
+    StringBuffer_appendChar(sb, '(');
+    pushText(tasks, ")");
+  }
+
+  if (numChildren == 0) {
+    L3FormulaFormatter_format(sb, node, settings);
+  }
+
+  else if (numChildren == 1)
+  {
+    //I believe this would only be called for invalid ASTNode setups,
+    // but this could in theory occur.  This is the safest 
+    // behavior I can think of.
+    L3FormulaFormatter_format(sb, node, settings);
+    StringBuffer_appendChar(sb, '(');
+    pushText(tasks, ")");
+    pushVisit(tasks, node, ASTNode_getChild(node, 0));
+  }
+
+  else {
+    for (n = numChildren - 1; n > 0; n--)
+    {
+      pushVisit(tasks, node, ASTNode_getChild(node, n));
+      pushFormat(tasks, node);
+    }
+    pushVisit(tasks, node, ASTNode_getChild(node, 0));
+  }
+}
+
+
+/*
+ * Writes what precedes the first child of the given node, and pushes the
+ * tasks that write the rest of it.
+ */
+static void
+L3FormulaFormatter_start ( const ASTNode_t *parent,
                            const ASTNode_t *node,
                            StringBuffer_t  *sb, 
-                           const L3ParserSettings_t *settings )
+                           const L3ParserSettings_t *settings,
+                           L3FormatterTasks& tasks )
 {
 
   if (ASTNode_isLog10(node))
   {
-    L3FormulaFormatter_visitLog10(parent, node, sb, settings);
+    L3FormulaFormatter_startLog10(parent, node, sb, tasks);
   }
   else if (ASTNode_isSqrt(node))
   {
-    L3FormulaFormatter_visitSqrt(parent, node, sb, settings);
+    L3FormulaFormatter_startSqrt(parent, node, sb, tasks);
   }
   else if (isTranslatedModulo(node))
   {
-    L3FormulaFormatter_visitModulo(parent, node, sb, settings);
+    L3FormulaFormatter_startModulo(parent, node, sb, settings, tasks);
   }
   else if (L3FormulaFormatter_isFunction(node, settings))
   {
-    L3FormulaFormatter_visitFunction(parent, node, sb, settings);
+    L3FormulaFormatter_startFunction(parent, node, sb, settings, tasks);
   }
   else if (ASTNode_isUMinus(node))
   {
-    L3FormulaFormatter_visitUMinus(parent, node, sb, settings);
+    L3FormulaFormatter_startUMinus(parent, node, sb, settings, tasks);
   }
   else if (ASTNode_hasTypeAndNumChildren(node, AST_LOGICAL_NOT, 1))
   {
-    L3FormulaFormatter_visitUNot(parent, node, sb, settings);
+    L3FormulaFormatter_startUNot(parent, node, sb, settings, tasks);
   }
   else
   {
@@ -748,12 +966,60 @@ L3FormulaFormatter_visit ( const ASTNode_t *parent,
     }
     if (!foundInPackage)
     {
-      L3FormulaFormatter_visitOther(parent, node, sb, settings);
+      L3FormulaFormatter_startOther(parent, node, sb, settings, tasks);
+    }
+  }
+}
+
+
+/*
+ * Carries out the tasks, the next one last, until none is left.
+ */
+static void
+L3FormulaFormatter_run ( StringBuffer_t  *sb, 
+                         const L3ParserSettings_t *settings,
+                         L3FormatterTasks& tasks )
+{
+  while (!tasks.empty())
+  {
+    L3FormatterTask task = tasks.back();
+    tasks.pop_back();
+
+    switch (task.kind)
+    {
+    case L3FormatterTask::VISIT:
+      L3FormulaFormatter_start(task.parent, task.node, sb, settings, tasks);
+      break;
+
+    case L3FormatterTask::TEXT:
+      StringBuffer_append(sb, task.text);
+      break;
+
+    case L3FormatterTask::FORMAT:
+      L3FormulaFormatter_format(sb, task.node, settings);
+      break;
     }
   }
 }
 
 
+/**
+ * Visits the given ASTNode node.  This function is really just a
+ * dispatcher to either SBML_formulaToL3String_visitFunction() or
+ * SBML_formulaToL3String_visitOther().
+ */
+void
+L3FormulaFormatter_visit ( const ASTNode_t *parent,
+                           const ASTNode_t *node,
+                           StringBuffer_t  *sb, 
+                           const L3ParserSettings_t *settings )
+{
+  L3FormatterTasks tasks;
+  pushVisit(tasks, parent, node);
+  L3FormulaFormatter_run(sb, settings, tasks);
+}
+
+
 /**
  * Visits the given ASTNode as a function.  For this node only the
  * traversal is preorder.
@@ -764,26 +1030,9 @@ L3FormulaFormatter_visitFunction ( const ASTNode_t *parent,
                                    StringBuffer_t  *sb, 
                                    const L3ParserSettings_t *settings )
 {
-  unsigned int numChildren = ASTNode_getNumChildren(node);
-  unsigned int n;
-
-
-  L3FormulaFormatter_format(sb, node, settings);
-  StringBuffer_appendChar(sb, '(');
-
-  if (numChildren > 0)
-  {
-    L3FormulaFormatter_visit( node, ASTNode_getChild(node, 0), sb, settings);
-  }
-
-  for (n = 1; n < numChildren; n++)
-  {
-    StringBuffer_appendChar(sb, ',');
-    StringBuffer_appendChar(sb, ' ');
-    L3FormulaFormatter_visit( node, ASTNode_getChild(node, n), sb, settings);
-  }
-
-  StringBuffer_appendChar(sb, ')');
+  L3FormatterTasks tasks;
+  L3FormulaFormatter_startFunction(parent, node, sb, settings, tasks);
+  L3FormulaFormatter_run(sb, settings, tasks);
 }
 
 
@@ -797,9 +1046,9 @@ L3FormulaFormatter_visitLog10 ( const ASTNode_t *parent,
                                 StringBuffer_t  *sb, 
                                 const L3ParserSettings_t *settings )
 {
-  StringBuffer_append(sb, "log10(");
-  L3FormulaFormatter_visit(node, ASTNode_getChild(node, 1), sb, settings);
-  StringBuffer_appendChar(sb, ')');
+  L3FormatterTasks tasks;
+  L3FormulaFormatter_startLog10(parent, node, sb, tasks);
+  L3FormulaFormatter_run(sb, settings, tasks);
 }
 
 
@@ -813,9 +1062,9 @@ L3FormulaFormatter_visitSqrt ( const ASTNode_t *parent,
                                StringBuffer_t  *sb, 
                                const L3ParserSettings_t *settings )
 {
-  StringBuffer_append(sb, "sqrt(");
-  L3FormulaFormatter_visit(node, ASTNode_getChild(node, 1), sb, settings);
-  StringBuffer_appendChar(sb, ')');
+  L3FormatterTasks tasks;
+  L3FormulaFormatter_startSqrt(parent, node, sb, tasks);
+  L3FormulaFormatter_run(sb, settings, tasks);
 }
 
 
@@ -829,30 +1078,9 @@ L3FormulaFormatter_visitUMinus ( const ASTNode_t *parent,
                                  StringBuffer_t  *sb, 
                                  const L3ParserSettings_t *settings )
 {
-  //Unary minus is *not* the highest precedence, since it is superceded by 'power'
-  unsigned int group;
-  
-  //If we are supposed to collapse minuses, do so.
-  if (L3ParserSettings_getParseCollapseMinus(settings)) {
-    if (ASTNode_getNumChildren(node) == 1 &&
-        ASTNode_isUMinus(ASTNode_getLeftChild(node))) {
-      L3FormulaFormatter_visit(parent, ASTNode_getLeftChild(ASTNode_getLeftChild(node)), sb, settings);
-      return;
-    }
-  }
-  
-  group = L3FormulaFormatter_isGrouped(parent, node, settings);
-
-  if (group)
-  {
-    StringBuffer_appendChar(sb, '(');
-  }
-  StringBuffer_appendChar(sb, '-');
-  L3FormulaFormatter_visit ( node, ASTNode_getLeftChild(node), sb, settings);
-  if (group)
-  {
-    StringBuffer_appendChar(sb, ')');
-  }
+  L3FormatterTasks tasks;
+  L3FormulaFormatter_startUMinus(parent, node, sb, settings, tasks);
+  L3FormulaFormatter_run(sb, settings, tasks);
 }
 
 
@@ -865,19 +1093,9 @@ L3FormulaFormatter_visitUNot ( const ASTNode_t *parent,
                                StringBuffer_t  *sb, 
                                const L3ParserSettings_t *settings )
 {
-  //Unary not is also not the highest precedence, since it is superceded by 'power'
-  unsigned int group       = L3FormulaFormatter_isGrouped(parent, node, settings);
-
-  if (group)
-  {
-    StringBuffer_appendChar(sb, '(');
-  }
-  StringBuffer_appendChar(sb, '!');
-  L3FormulaFormatter_visit ( node, ASTNode_getLeftChild(node), sb, settings);
-  if (group)
-  {
-    StringBuffer_appendChar(sb, ')');
-  }
+  L3FormatterTasks tasks;
+  L3FormulaFormatter_startUNot(parent, node, sb, settings, tasks);
+  L3FormulaFormatter_run(sb, settings, tasks);
 }
 
 
@@ -891,27 +1109,9 @@ L3FormulaFormatter_visitModulo ( const ASTNode_t *parent,
                                  StringBuffer_t  *sb, 
                                  const L3ParserSettings_t *settings )
 {
-  unsigned int group       = L3FormulaFormatter_isGrouped(parent, node, settings);
-  const ASTNode_t* subnode = ASTNode_getLeftChild(node);
-  if (group)
-  {
-    StringBuffer_appendChar(sb, '(');
-  }
-
-  //Get x and y from the first child of the piecewise function, 
-  // then the first child of that (times), and the first child
-  // of that (minus).
-  L3FormulaFormatter_visit ( node, ASTNode_getLeftChild(subnode), sb, settings);
-  StringBuffer_appendChar(sb, ' ');
-  StringBuffer_appendChar(sb, '%');
-  StringBuffer_appendChar(sb, ' ');
-  subnode = ASTNode_getRightChild(subnode);
-  L3FormulaFormatter_visit ( node, ASTNode_getLeftChild(subnode), sb, settings);
-
-  if (group)
-  {
-    StringBuffer_appendChar(sb, ')');
-  }
+  L3FormatterTasks tasks;
+  L3FormulaFormatter_startModulo(parent, node, sb, settings, tasks);
+  L3FormulaFormatter_run(sb, settings, tasks);
 }
 
 
@@ -924,45 +1124,9 @@ L3FormulaFormatter_visitOther ( const ASTNode_t *parent,
                                 StringBuffer_t  *sb, 
                                 const L3ParserSettings_t *settings )
 {
-  unsigned int numChildren = ASTNode_getNumChildren(node);
-  unsigned int group       = L3FormulaFormatter_isGrouped(parent, node, settings);
-  unsigned int n;
-
-
-  if (group)
-  {
-    StringBuffer_appendChar(sb, '(');
-  }
-
-  if (numChildren == 0) {
-    L3FormulaFormatter_format(sb, node, settings);
-  }
-
-  else if (numChildren == 1)
-  {
-    //I believe this would only be called for invalid ASTNode setups,
-    // but this could in theory occur.  This is the safest 
-    // behavior I can think of.
-    L3FormulaFormatter_format(sb, node, settings);
-    StringBuffer_appendChar(sb, '(');
-    L3FormulaFormatter_visit( node, ASTNode_getChild(node, 0), sb, settings);
-    StringBuffer_appendChar(sb, ')');
-  }
-
-  else {
-    L3FormulaFormatter_visit( node, ASTNode_getChild(node, 0), sb, settings);
-
-    for (n = 1; n < numChildren; n++)
-    {
-      L3FormulaFormatter_format(sb, node, settings);
-      L3FormulaFormatter_visit( node, ASTNode_getChild(node, n), sb, settings);
-    }
-  }
-
-  if (group)
-  {
-    StringBuffer_appendChar(sb, ')');
-  }
+  L3FormatterTasks tasks;
+  L3FormulaFormatter_startOther(parent, node, sb, settings, tasks);
+  L3FormulaFormatter_run(sb, settings, tasks);
 }
 
 
@@ -0,0 +1,697 @@
+/**
+ * @file    L3FormulaWriter.cpp
+ * @brief   Implementation of L3FormulaWriter, which writes abstract syntax
+ *          trees as SBML Level 3 text-string formulas into a reusable buffer.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sbml/math/L3FormulaWriter.h>
+#include <sbml/math/L3FormulaFormatter.h>
+#include <sbml/math/ASTNode.h>
+#include <sbml/SBase.h>
+#include <sbml/util/List.h>
+#include <sbml/util/StringBuffer.h>
+#include <sbml/util/util.h>
+
+#include <clocale>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+/** @cond doxygenLibsbmlInternal */
+
+int isTranslatedModulo (const ASTNode_t* node);
+
+
+/*
+ * How a core node type is written.  Nodes with a number of children between
+ * minInfix and maxInfix are written as their children separated by the infix
+ * text, all other nodes as a function call, except for unary minus and not
+ * which are written as prefix operators.  These choices and precedences are
+ * the ones made by L3FormulaFormatter_isFunction() and getL3Precedence().
+ */
+struct L3TypeInfo
+{
+  bool         core;
+  bool         leaf;
+  const char*  infix;
+  unsigned int minInfix;
+  unsigned int maxInfix;
+  int          precedence;
+  const char*  function;
+};
+
+
+static void
+setInfix(L3TypeInfo& info, const char* infix, unsigned int minInfix,
+         unsigned int maxInfix, int precedence)
+{
+  info.infix      = infix;
+  info.minInfix   = minInfix;
+  info.maxInfix   = maxInfix;
+  info.precedence = precedence;
+}
+
+
+static L3TypeInfo table[AST_END_OF_CORE + 2];
+
+
+static bool
+fillTypeInfo()
+{
+  const unsigned int any = (unsigned int)-1;
+  for (int t = 0; t <= AST_END_OF_CORE + 1; ++t)
+  {
+    L3TypeInfo& info = table[t];
+    info.core       = (t >= AST_INTEGER && t <= AST_RELATIONAL_NEQ);
+    info.leaf       = (t >= AST_INTEGER && t <= AST_CONSTANT_TRUE);
+    info.infix      = NULL;
+    info.minInfix   = 1;
+    info.maxInfix   = 0;
+    info.precedence = 8;
+    info.function   = NULL;
+  }
+
+  table[AST_PLUS].core   = true;
+  table[AST_MINUS].core  = true;
+  table[AST_TIMES].core  = true;
+  table[AST_DIVIDE].core = true;
+  table[AST_POWER].core  = true;
+
+  setInfix(table[AST_PLUS],           " + ",  2, any, 4);
+  setInfix(table[AST_MINUS],          " - ",  2, 2,   4);
+  setInfix(table[AST_TIMES],          " * ",  2, any, 5);
+  setInfix(table[AST_DIVIDE],         " / ",  2, 2,   5);
+  setInfix(table[AST_POWER],          "^",    2, 2,   7);
+  setInfix(table[AST_FUNCTION_POWER], "^",    2, 2,   7);
+  setInfix(table[AST_LOGICAL_AND],    " && ", 2, any, 2);
+  setInfix(table[AST_LOGICAL_OR],     " || ", 2, any, 2);
+  setInfix(table[AST_RELATIONAL_EQ],  " == ", 2, any, 3);
+  setInfix(table[AST_RELATIONAL_GEQ], " >= ", 2, any, 3);
+  setInfix(table[AST_RELATIONAL_GT],  " > ",  2, any, 3);
+  setInfix(table[AST_RELATIONAL_LEQ], " <= ", 2, any, 3);
+  setInfix(table[AST_RELATIONAL_LT],  " < ",  2, any, 3);
+  setInfix(table[AST_RELATIONAL_NEQ], " != ", 2, 2,   3);
+
+  table[AST_PLUS].function             = "plus";
+  table[AST_TIMES].function            = "times";
+  table[AST_MINUS].function            = "minus";
+  table[AST_DIVIDE].function           = "divide";
+  table[AST_POWER].function            = "pow";
+  table[AST_FUNCTION_POWER].function   = "pow";
+  table[AST_FUNCTION_LN].function      = "ln";
+  table[AST_FUNCTION_DELAY].function   = "delay";
+  table[AST_FUNCTION_ARCCOS].function  = "acos";
+  table[AST_FUNCTION_ARCSIN].function  = "asin";
+  table[AST_FUNCTION_ARCTAN].function  = "atan";
+  table[AST_FUNCTION_CEILING].function = "ceil";
+
+  return true;
+}
+
+
+/*
+ * The table is filled when the library is loaded rather than on first use,
+ * so that writers on separate threads never fill it at the same time.
+ */
+static const bool tableFilled = fillTypeInfo();
+
+
+static const L3TypeInfo&
+getTypeInfo(int type)
+{
+  if (type < 0 || type > AST_END_OF_CORE)
+  {
+    return table[AST_END_OF_CORE + 1];
+  }
+  return table[type];
+}
+
+
+static bool
+isUnary(const ASTNode* node)
+{
+  ASTNodeType_t type = node->getType();
+  return (type == AST_MINUS || type == AST_LOGICAL_NOT)
+    && node->getNumChildren() == 1;
+}
+
+
+static bool
+isUnaryMinusNode(const ASTNode* node)
+{
+  return node != NULL && node->getType() == AST_MINUS
+    && node->getNumChildren() == 1;
+}
+
+
+static bool
+isUnaryNotNode(const ASTNode* node)
+{
+  return node != NULL && node->getType() == AST_LOGICAL_NOT
+    && node->getNumChildren() == 1;
+}
+
+
+static bool
+isInfix(const ASTNode* node)
+{
+  const L3TypeInfo& info = getTypeInfo(node->getType());
+  unsigned int numChildren = node->getNumChildren();
+  return info.infix != NULL
+    && numChildren >= info.minInfix && numChildren <= info.maxInfix;
+}
+
+
+static bool
+isFunctionCall(const ASTNode* node)
+{
+  return !getTypeInfo(node->getType()).leaf && !isUnary(node)
+    && !isInfix(node);
+}
+
+
+static int
+getPrecedence(const ASTNode* node)
+{
+  if (isUnary(node))
+  {
+    return 6;
+  }
+  return isInfix(node) ? getTypeInfo(node->getType()).precedence : 8;
+}
+
+
+static bool
+isLogicalOrRelational(const ASTNode* node)
+{
+  ASTNodeType_t type = node->getType();
+  return (type >= AST_LOGICAL_AND && type <= AST_RELATIONAL_NEQ);
+}
+
+
+/*
+ * Returns whether the given core child of the given core parent is put in
+ * parentheses, deciding as L3FormulaFormatter_isGrouped() does.
+ */
+static bool
+isGrouped(const ASTNode* parent, const ASTNode* child)
+{
+  if (parent == NULL)
+  {
+    return false;
+  }
+
+  if (isUnaryMinusNode(parent) && isUnaryNotNode(child))
+  {
+    return true;
+  }
+  if (isUnaryNotNode(parent) && isUnaryMinusNode(child))
+  {
+    return true;
+  }
+
+  int cp = getPrecedence(child);
+
+  if (isLogicalOrRelational(parent))
+  {
+    if (cp == 8)
+    {
+      return false;
+    }
+    const ASTNode* right = isUnary(parent) ? parent->getChild(0)
+                                           : parent->getRightChild();
+    return !(child == right && isUnary(child));
+  }
+
+  if (isFunctionCall(parent) || cp == 8)
+  {
+    return false;
+  }
+  if (isLogicalOrRelational(child) && !isUnary(child))
+  {
+    return true;
+  }
+
+  int pp = getPrecedence(parent);
+  if (pp < cp)
+  {
+    return false;
+  }
+  if (pp == cp)
+  {
+    if (parent->getChild(0) != child)
+    {
+      return true;
+    }
+    ASTNodeType_t pt = parent->getType();
+    return !(pt == child->getType() || pt == AST_DIVIDE || pt == AST_MINUS);
+  }
+  if (pp == 7 && cp == 6)
+  {
+    return parent->getChild(0) == child;
+  }
+  return true;
+}
+
+
+/*
+ * Returns whether the given node and its children are written here rather
+ * than by L3FormulaFormatter_visit().
+ */
+static bool
+isWrittenHere(const ASTNode* node)
+{
+  if (node == NULL)
+  {
+    return false;
+  }
+
+  const L3TypeInfo& info = getTypeInfo(node->getType());
+  if (!info.core)
+  {
+    return false;
+  }
+  if (info.leaf)
+  {
+    return node->getNumChildren() == 0;
+  }
+  if (node->getType() == AST_FUNCTION_PIECEWISE)
+  {
+    return isTranslatedModulo(node) == 0;
+  }
+  return true;
+}
+
+/** @endcond */
+
+
+L3FormulaWriter::L3FormulaWriter(const L3ParserSettings* settings)
+{
+  if (settings != NULL)
+  {
+    mSettings = *settings;
+  }
+}
+
+
+L3FormulaWriter::~L3FormulaWriter()
+{
+}
+
+
+const L3ParserSettings&
+L3FormulaWriter::getSettings() const
+{
+  return mSettings;
+}
+
+
+void
+L3FormulaWriter::setSettings(const L3ParserSettings& settings)
+{
+  mSettings = settings;
+}
+
+
+const char*
+L3FormulaWriter::format(const ASTNode* node)
+{
+  clear();
+  if (node == NULL)
+  {
+    return NULL;
+  }
+
+  mStarts.push_back(0);
+  mElements.push_back(NULL);
+  write(node);
+  return mBuffer.c_str();
+}
+
+
+int
+L3FormulaWriter::formatAllMath(SBase* element)
+{
+  clear();
+  if (element == NULL)
+  {
+    return LIBSBML_INVALID_OBJECT;
+  }
+
+  List* elements = element->getAllElements();
+  elements->prepend(element);
+  for (ListIterator iter = elements->begin(); iter != elements->end(); ++iter)
+  {
+    const SBase* current = static_cast<const SBase*>(*iter);
+    const ASTNode* math = current->getMath();
+    if (math == NULL)
+    {
+      continue;
+    }
+
+    mStarts.push_back(mBuffer.size());
+    mElements.push_back(current);
+    write(math);
+    mBuffer += '\0';
+  }
+  delete elements;
+
+  return LIBSBML_OPERATION_SUCCESS;
+}
+
+
+unsigned int
+L3FormulaWriter::getNumFormulas() const
+{
+  return (unsigned int)mStarts.size();
+}
+
+
+const char*
+L3FormulaWriter::getFormula(unsigned int n) const
+{
+  return n < mStarts.size() ? mBuffer.c_str() + mStarts[n] : NULL;
+}
+
+
+const SBase*
+L3FormulaWriter::getElement(unsigned int n) const
+{
+  return n < mElements.size() ? mElements[n] : NULL;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+
+void
+L3FormulaWriter::clear()
+{
+  // clear() keeps the capacity of the buffer for the next formulas
+  mBuffer.clear();
+  mStarts.clear();
+  mElements.clear();
+}
+
+
+void
+L3FormulaWriter::write(const ASTNode* node)
+{
+  mTasks.clear();
+  pushNode(node, NULL);
+
+  while (!mTasks.empty())
+  {
+    Task task = mTasks.back();
+    mTasks.pop_back();
+
+    if (task.text != NULL)
+    {
+      mBuffer += task.text;
+    }
+    else if (isWrittenHere(task.node))
+    {
+      writeNode(task.node, task.parent);
+    }
+    else
+    {
+      StringBuffer_t* sb = StringBuffer_create(64);
+      L3FormulaFormatter_visit(task.parent, task.node, sb, &mSettings);
+      mBuffer += StringBuffer_getBuffer(sb);
+      StringBuffer_free(sb);
+    }
+  }
+}
+
+
+/*
+ * Writes a node whose type is in the table.  The parts are pushed on the
+ * task stack last to first.
+ */
+void
+L3FormulaWriter::writeNode(const ASTNode* node, const ASTNode* parent)
+{
+  unsigned int numChildren = node->getNumChildren();
+
+  if (numChildren == 2 && node->getChild(0)->getType() == AST_INTEGER
+    && ((node->getType() == AST_FUNCTION_LOG
+         && node->getChild(0)->getInteger() == 10)
+     || (node->getType() == AST_FUNCTION_ROOT
+         && node->getChild(0)->getInteger() == 2)))
+  {
+    mBuffer += (node->getType() == AST_FUNCTION_LOG) ? "log10(" : "sqrt(";
+    pushText(")");
+    pushNode(node->getChild(1), node);
+  }
+  else if (isFunctionCall(node))
+  {
+    const char* name = getTypeInfo(node->getType()).function;
+    if (name == NULL)
+    {
+      name = node->getName();
+    }
+    if (name != NULL)
+    {
+      mBuffer += name;
+    }
+    mBuffer += '(';
+    pushText(")");
+    for (unsigned int n = numChildren; n > 0; --n)
+    {
+      pushNode(node->getChild(n - 1), node);
+      if (n > 1)
+      {
+        pushText(", ");
+      }
+    }
+  }
+  else if (isUnary(node))
+  {
+    const ASTNode* child = node->getChild(0);
+    if (node->getType() == AST_MINUS && mSettings.getParseCollapseMinus()
+      && isUnaryMinusNode(child))
+    {
+      pushNode(child->getChild(0), parent);
+      return;
+    }
+
+    bool group = isGrouped(parent, node);
+    if (group)
+    {
+      mBuffer += '(';
+      pushText(")");
+    }
+    mBuffer += (node->getType() == AST_MINUS) ? '-' : '!';
+    pushNode(child, node);
+  }
+  else
+  {
+    writeOther(node, parent);
+  }
+}
+
+
+void
+L3FormulaWriter::writeOther(const ASTNode* node, const ASTNode* parent)
+{
+  bool group = isGrouped(parent, node);
+  if (group)
+  {
+    mBuffer += '(';
+  }
+
+  if (getTypeInfo(node->getType()).leaf)
+  {
+    writeLeaf(node);
+    if (group)
+    {
+      mBuffer += ')';
+    }
+    return;
+  }
+
+  if (group)
+  {
+    pushText(")");
+  }
+  const char* infix = getTypeInfo(node->getType()).infix;
+  for (unsigned int n = node->getNumChildren(); n > 0; --n)
+  {
+    pushNode(node->getChild(n - 1), node);
+    if (n > 1)
+    {
+      pushText(infix);
+    }
+  }
+}
+
+
+void
+L3FormulaWriter::writeLeaf(const ASTNode* node)
+{
+  char number[64];
+
+  switch (node->getType())
+  {
+  case AST_INTEGER:
+    // integers below 10^15 are written in full by "%.15g" as well
+    if (node->getInteger() < 1000000000000000L
+      && node->getInteger() > -1000000000000000L)
+    {
+      sprintf(number, "%ld", node->getInteger());
+      mBuffer += number;
+    }
+    else
+    {
+      appendReal((double)node->getInteger());
+    }
+    appendUnits(node);
+    break;
+
+  case AST_REAL:
+  case AST_REAL_E:
+  {
+    double value = node->getReal();
+    if (util_isNaN(value))
+    {
+      mBuffer += "NaN";
+    }
+    else if (util_isInf(value) != 0)
+    {
+      mBuffer += (util_isInf(value) < 0) ? "-INF" : "INF";
+    }
+    else if (util_isNegZero(value))
+    {
+      mBuffer += "-0";
+    }
+    else if (node->getType() == AST_REAL_E
+      && node->getMantissa() < 1e14 && node->getMantissa() > -1e14
+      && (node->getMantissa() >= 1e-4 || node->getMantissa() <= -1e-4))
+    {
+      appendReal(node->getMantissa());
+      sprintf(number, "e%ld", node->getExponent());
+      mBuffer += number;
+    }
+    else
+    {
+      appendReal(value);
+    }
+    appendUnits(node);
+    break;
+  }
+
+  case AST_RATIONAL:
+    sprintf(number, "(%ld/%ld)", node->getNumerator(),
+            node->getDenominator());
+    mBuffer += number;
+    appendUnits(node);
+    break;
+
+  case AST_NAME_AVOGADRO:
+    mBuffer += "avogadro";
+    break;
+
+  case AST_NAME_TIME:
+    mBuffer += "time";
+    break;
+
+  default:
+    if (node->getName() != NULL)
+    {
+      mBuffer += node->getName();
+    }
+    break;
+  }
+}
+
+
+/*
+ * Appends the given finite value with the fewest significant digits that
+ * are read back as the same value.  The number is written and read back in
+ * the current locale, which saves switching to the C locale for each number
+ * as c_locale_snprintf() does, and its decimal point is then made a period.
+ */
+void
+L3FormulaWriter::appendReal(double value)
+{
+  char number[40];
+
+  for (int precision = 15; precision <= 17; ++precision)
+  {
+    sprintf(number, "%.*g", precision, value);
+    if (precision == 17 || strtod(number, NULL) == value)
+    {
+      break;
+    }
+  }
+
+  const char* point = localeconv()->decimal_point;
+  char* found = NULL;
+  if (point != NULL && strcmp(point, ".") != 0)
+  {
+    found = strstr(number, point);
+  }
+  if (found == NULL)
+  {
+    mBuffer += number;
+  }
+  else
+  {
+    mBuffer.append(number, found - number);
+    mBuffer += '.';
+    mBuffer += found + strlen(point);
+  }
+}
+
+
+void
+L3FormulaWriter::appendUnits(const ASTNode* node)
+{
+  if (mSettings.getParseUnits() && node->isSetUnits())
+  {
+    mBuffer += ' ';
+    mBuffer += node->getUnits();
+  }
+}
+
+
+void
+L3FormulaWriter::pushText(const char* text)
+{
+  Task task = { text, NULL, NULL };
+  mTasks.push_back(task);
+}
+
+
+void
+L3FormulaWriter::pushNode(const ASTNode* node, const ASTNode* parent)
+{
+  Task task = { NULL, node, parent };
+  mTasks.push_back(task);
+}
+
+/** @endcond */
+
+
+LIBSBML_CPP_NAMESPACE_END
@@ -0,0 +1,229 @@
+/**
+ * @file    L3FormulaWriter.h
+ * @brief   Definition of L3FormulaWriter, which writes abstract syntax trees
+ *          as SBML Level 3 text-string formulas into a reusable buffer.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class L3FormulaWriter
+ * @sbmlbrief{core} Writes ASTNode trees as SBML Level&nbsp;3 formulas.
+ *
+ * @htmlinclude libsbml-facility-only-warning.html
+ *
+ * An L3FormulaWriter produces the same text as
+ * @sbmlfunction{formulaToL3StringWithSettings, ASTNode\, L3ParserSettings},
+ * but is meant for writing many formulas in a row, such as all the kinetic
+ * laws of a large model.  The text is written into a single buffer that is
+ * kept from one call to the next, so that after the first few formulas no
+ * memory needs to be allocated.  The way each core node type is written
+ * and its operator precedence are looked up in a table built once, and
+ * the tree is walked with an explicit stack, so that deeply nested
+ * expressions can be written as well.  Nodes of package types, and
+ * piecewise functions that stand for the modulo operator, are handed to
+ * the general formatter.
+ *
+ * Real numbers are the one difference: they are written with the fewest
+ * significant digits (at most 17) that read back as the same value,
+ * where the general formatter always rounds them to 15 digits.  Numbers
+ * that have 15 significant digits or fewer are written the same way by
+ * both.
+ *
+ * formatAllMath() writes the math of an element and all its descendants
+ * in one pass, one after the other into the same buffer.
+ *
+ * Writers share no state, so several threads may each write formulas with
+ * their own L3FormulaWriter while the math is not being changed.  The
+ * exception is math handed to the general formatter, which switches the
+ * locale of the whole process while it writes real numbers.
+ * formatAllMath() runs on the calling thread, so that the formulas of a
+ * model come out in document order in a single buffer.
+ */
+
+#ifndef L3FormulaWriter_h
+#define L3FormulaWriter_h
+
+#include <sbml/common/extern.h>
+#include <sbml/common/operationReturnValues.h>
+#include <sbml/math/L3ParserSettings.h>
+
+#ifdef __cplusplus
+
+#include <string>
+#include <vector>
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+class ASTNode;
+class SBase;
+
+
+class LIBSBML_EXTERN L3FormulaWriter
+{
+public:
+
+  /**
+   * Creates a new L3FormulaWriter.
+   *
+   * @param settings the L3ParserSettings whose units and minus collapsing
+   * settings to follow; the default settings are used if @c NULL.
+   */
+  L3FormulaWriter(const L3ParserSettings* settings = NULL);
+
+
+  /**
+   * Destroys this L3FormulaWriter.
+   */
+  virtual ~L3FormulaWriter();
+
+
+  /**
+   * Returns the settings this L3FormulaWriter follows.
+   *
+   * @return the L3ParserSettings used.
+   */
+  const L3ParserSettings& getSettings() const;
+
+
+  /**
+   * Sets the settings this L3FormulaWriter follows.
+   *
+   * @param settings the L3ParserSettings to copy.
+   */
+  void setSettings(const L3ParserSettings& settings);
+
+
+  /**
+   * Writes the tree rooted at the given node as an SBML Level&nbsp;3
+   * text-string formula.
+   *
+   * @param node the root of the tree to write.
+   *
+   * @return the formula, or @c NULL if @p node is @c NULL.  The string is
+   * owned by this L3FormulaWriter and stays valid until the next call to
+   * format() or formatAllMath().
+   */
+  const char* format(const ASTNode* node);
+
+
+  /**
+   * Writes the math of the given element and of all its descendants,
+   * including those of package plugins.
+   *
+   * The formulas are retrieved with getFormula() and the elements they
+   * belong to with getElement(), in the order the elements appear in the
+   * document.
+   *
+   * @param element the SBase object whose math to write.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBSBML_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBSBML_INVALID_OBJECT, OperationReturnValues_t}
+   */
+  int formatAllMath(SBase* element);
+
+
+  /**
+   * Returns the number of formulas written by the last call to
+   * formatAllMath() or format().
+   *
+   * @return the number of formulas.
+   */
+  unsigned int getNumFormulas() const;
+
+
+  /**
+   * Returns the @p n-th formula written by the last call to
+   * formatAllMath() or format().
+   *
+   * @param n the index of the formula.
+   *
+   * @return the formula, or @c NULL if there is no such formula.  The
+   * string is owned by this L3FormulaWriter and stays valid until the next
+   * call to format() or formatAllMath().
+   */
+  const char* getFormula(unsigned int n) const;
+
+
+  /**
+   * Returns the element whose math is the @p n-th formula written by the
+   * last call to formatAllMath().
+   *
+   * @param n the index of the formula.
+   *
+   * @return the element, or @c NULL if there is no such formula or it was
+   * written by format().
+   */
+  const SBase* getElement(unsigned int n) const;
+
+
+protected:
+  /** @cond doxygenLibsbmlInternal */
+
+  void clear();
+
+  void write(const ASTNode* node);
+
+  void writeNode(const ASTNode* node, const ASTNode* parent);
+
+  void writeLeaf(const ASTNode* node);
+
+  void writeOther(const ASTNode* node, const ASTNode* parent);
+
+  void appendReal(double value);
+
+  void appendUnits(const ASTNode* node);
+
+  void pushText(const char* text);
+
+  void pushNode(const ASTNode* node, const ASTNode* parent);
+
+  // the text to write, or the node to write with its parent
+  struct Task
+  {
+    const char* text;
+    const ASTNode* node;
+    const ASTNode* parent;
+  };
+
+  L3ParserSettings mSettings;
+
+  // all formulas, each followed by a null character
+  std::string mBuffer;
+
+  std::vector<size_t> mStarts;
+  std::vector<const SBase*> mElements;
+
+  std::vector<Task> mTasks;
+
+  /** @endcond */
+
+private:
+  /** @cond doxygenLibsbmlInternal */
+
+  L3FormulaWriter(const L3FormulaWriter&);
+  L3FormulaWriter& operator=(const L3FormulaWriter&);
+
+  /** @endcond */
+};
+
+
+LIBSBML_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+#endif  /* L3FormulaWriter_h */
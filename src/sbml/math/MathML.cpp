@@ -53,8 +53,12 @@
 #include <sbml/math/ASTNode.h>
 #include <sbml/math/MathML.h>
 #include <sbml/math/DefinitionURLRegistry.h>
+#include <sbml/extension/SBMLExtensionRegistry.h>
 
 #include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
 
 #ifdef USE_MULTI
 #include <sbml/packages/multi/common/MultiExtensionTypes.h>
@@ -273,6 +277,101 @@ static const ASTNodeType_t MATHML_TYPES[] =
   , AST_CONSTANT_TRUE
   , AST_LOGICAL_XOR
 };
+
+
+/*
+ * The elements the reader handles itself rather than by setting a node
+ * type.  Their names are in MATHML_TAG_NAMES in the same order, sorted and
+ * matched with case, so that an element name is looked up once and the
+ * reader then branches on the tag.
+ */
+typedef enum
+{
+    MATHML_TAG_ANNOTATION
+  , MATHML_TAG_ANNOTATION_XML
+  , MATHML_TAG_APPLY
+  , MATHML_TAG_BVAR
+  , MATHML_TAG_CI
+  , MATHML_TAG_CN
+  , MATHML_TAG_CSYMBOL
+  , MATHML_TAG_DEGREE
+  , MATHML_TAG_EXPONENTIALE
+  , MATHML_TAG_FALSE
+  , MATHML_TAG_INFINITY
+  , MATHML_TAG_LAMBDA
+  , MATHML_TAG_LOGBASE
+  , MATHML_TAG_MATH
+  , MATHML_TAG_NOTANUMBER
+  , MATHML_TAG_OTHERWISE
+  , MATHML_TAG_PI
+  , MATHML_TAG_PIECE
+  , MATHML_TAG_PIECEWISE
+  , MATHML_TAG_SEMANTICS
+  , MATHML_TAG_SEP
+  , MATHML_TAG_TRUE
+  , MATHML_TAG_OTHER
+} MathMLTag_t;
+
+
+static const char* MATHML_TAG_NAMES[] =
+{
+    "annotation"
+  , "annotation-xml"
+  , "apply"
+  , "bvar"
+  , "ci"
+  , "cn"
+  , "csymbol"
+  , "degree"
+  , "exponentiale"
+  , "false"
+  , "infinity"
+  , "lambda"
+  , "logbase"
+  , "math"
+  , "notanumber"
+  , "otherwise"
+  , "pi"
+  , "piece"
+  , "piecewise"
+  , "semantics"
+  , "sep"
+  , "true"
+};
+
+
+/*
+ * @return the MathMLTag_t for the given element name, or MATHML_TAG_OTHER
+ * if the reader has no special handling for it.
+ */
+static MathMLTag_t
+getMathMLTag (const string& name)
+{
+  const char* cname = name.c_str();
+  int lo = 0;
+  int hi = (int)(sizeof(MATHML_TAG_NAMES) / sizeof(MATHML_TAG_NAMES[0])) - 1;
+
+  while (lo <= hi)
+  {
+    int mid = (lo + hi) / 2;
+    int cmp = strcmp(cname, MATHML_TAG_NAMES[mid]);
+
+    if (cmp == 0)
+    {
+      return (MathMLTag_t)(mid);
+    }
+    else if (cmp < 0)
+    {
+      hi = mid - 1;
+    }
+    else
+    {
+      lo = mid + 1;
+    }
+  }
+
+  return MATHML_TAG_OTHER;
+}
 /** @endcond */
 
 /** @cond doxygenLibsbmlInternal */
@@ -418,15 +517,13 @@ isValidCSymbol(SBMLNamespaces* sbmlns, ASTNodeType_t type)
  * Errors will be logged in the stream's SBMLErrorLog object.
  */
 static void
-setTypeCI (ASTNode& node, const XMLToken& element, XMLInputStream& stream)
+setTypeCI (ASTNode& node, MathMLTag_t tag, const XMLToken& element,
+           XMLInputStream& stream)
 {
 
-  unsigned int n = DefinitionURLRegistry::getInstance().getNumDefinitionURLs();
-  if (element.getName() == "csymbol")
+  if (tag == MATHML_TAG_CSYMBOL)
   {
-
-    ////////////////////
-    // new
+    // the registry holds the core and the package csymbol urls
     string url;
     element.getAttributes().readInto("definitionURL", url);
 
@@ -453,84 +550,8 @@ setTypeCI (ASTNode& node, const XMLToken& element, XMLInputStream& stream)
         }
       }
     }
-
-    // original
-    /////////////////////
-    //string url;
-    //element.getAttributes().readInto("definitionURL", url);
-
-    //if (stream.getSBMLNamespaces() == NULL)
-    //{
-    //  // non sbml
-    //  if (url == URL_DELAY) 
-    //    node.setType(AST_FUNCTION_DELAY);
-    //  else if (url == URL_TIME) 
-    //    node.setType(AST_NAME_TIME);
-    //  else if (url == URL_AVOGADRO) 
-    //    node.setType(AST_NAME_AVOGADRO);
-    //  else {
-    //    ASTNodeType_t type = AST_UNKNOWN;
-    //    const ASTBasePlugin* baseplugin = node.getASTPlugin(url, true, true);
-    //    if (baseplugin != NULL)
-    //    {
-    //      type = baseplugin->getASTNodeTypeForCSymbolURL(url);
-    //      if (type != AST_UNKNOWN)
-    //      {
-    //        node.setType(type);
-    //      }
-    //    }
-    //    if (type == AST_UNKNOWN)
-    //    {
-    //      node.setType(AST_CSYMBOL_FUNCTION);
-    //    }
-    //    node.setDefinitionURL(url);
-    //  }
-
-    //}
-    //else if (stream.getSBMLNamespaces()->getLevel() < 3)
-    //{
-    //  if ( url == URL_DELAY ) 
-    //    node.setType(AST_FUNCTION_DELAY);
-    //  else if ( url == URL_TIME  ) 
-    //    node.setType(AST_NAME_TIME);
-    //  else 
-    //  {
-    //    logError(stream, element, BadCsymbolDefinitionURLValue);      
-    //  }
-    //}
-    //else
-    //{
-    //  /* level 3 */
-    //  if (url == URL_DELAY) 
-    //    node.setType(AST_FUNCTION_DELAY);
-    //  else if (url == URL_TIME) 
-    //    node.setType(AST_NAME_TIME);
-    //  else if (url == URL_AVOGADRO) 
-    //    node.setType(AST_NAME_AVOGADRO);
-    //  else
-    //  {
-    //    ASTNodeType_t type = AST_UNKNOWN;
-    //    const ASTBasePlugin* baseplugin = node.getASTPlugin(url, true, true);
-    //    if (baseplugin != NULL)
-    //    {
-    //      if (baseplugin->hasCorrectNamespace(stream.getSBMLNamespaces()))
-    //      {
-    //        type = baseplugin->getASTNodeTypeForCSymbolURL(url);
-    //        if (type != AST_UNKNOWN)
-    //        {
-    //          node.setType(type);
-    //        }
-    //      }
-    //    }
-    //    if (type == AST_UNKNOWN)
-    //    {
-    //      node.setType(AST_FUNCTION);
-    //      logError(stream, element, BadCsymbolDefinitionURLValue);
-    //    }
-    //  }
-    //}
   }
-  else if (element.getName() == "ci")
+  else if (tag == MATHML_TAG_CI)
   {
     if (element.getAttributes().hasAttribute("definitionURL") == true)
     {
@@ -750,31 +771,32 @@ setTypeOther (ASTNode& node, const XMLToken& element, XMLInputStream& stream)
  * Sets the type of an ASTNode based on the given MathML element.
  */
 static void
-setType (ASTNode& node, const XMLToken& element, XMLInputStream& stream)
+setType (ASTNode& node, MathMLTag_t tag, const XMLToken& element,
+         XMLInputStream& stream)
 {
 
-  const string& name = element.getName();
-
-  if (name == "ci" || name == "csymbol")
-  {
-    setTypeCI(node, element, stream);
-  }
-  else if (name == "cn")
+  switch (tag)
   {
+  case MATHML_TAG_CI:
+  case MATHML_TAG_CSYMBOL:
+    setTypeCI(node, tag, element, stream);
+    break;
+
+  case MATHML_TAG_CN:
     setTypeCN(node, element, stream);
-  }
-  else if (name == "notanumber")
-  {
+    break;
+
+  case MATHML_TAG_NOTANUMBER:
     node.setValue( numeric_limits<double>::quiet_NaN() );
-  }
+    break;
 
-  else if (name == "infinity")
-  {
+  case MATHML_TAG_INFINITY:
     node.setValue( numeric_limits<double>::infinity() );
-  }
-  else
-  {
+    break;
+
+  default:
     setTypeOther(node, element, stream);
+    break;
   }
 }
 /** @endcond */
@@ -784,40 +806,42 @@ setType (ASTNode& node, const XMLToken& element, XMLInputStream& stream)
  * this function returns true if the name represents 
  * these tags called Node within the mathML schema
  */
-bool
-isMathMLNodeTag(const string& name)
+static bool
+isMathMLNodeTag(MathMLTag_t tag, const string& name)
 {
 
-  if ( name == "apply"
-    || name == "cn"
-    || name == "ci"
-    || name == "csymbol"
-    || name == "true"
-    || name == "false"
-    || name == "notanumber"
-    || name == "pi"
-    || name == "infinity"
-    || name == "exponentiale"
-    || name == "semantics"
-    || name == "piecewise")
-  {
+  switch (tag)
+  {
+  case MATHML_TAG_APPLY:
+  case MATHML_TAG_CN:
+  case MATHML_TAG_CI:
+  case MATHML_TAG_CSYMBOL:
+  case MATHML_TAG_TRUE:
+  case MATHML_TAG_FALSE:
+  case MATHML_TAG_NOTANUMBER:
+  case MATHML_TAG_PI:
+  case MATHML_TAG_INFINITY:
+  case MATHML_TAG_EXPONENTIALE:
+  case MATHML_TAG_SEMANTICS:
+  case MATHML_TAG_PIECEWISE:
     return true;
+
+  default:
+    break;
   }
-  else
-  {
-    ASTNode astn;
-    //astn.loadASTPlugins(NULL);
-    //for (unsigned int p = 0; p < astn.getNumPlugins(); p++)
-    //{
-    //  const ASTBasePlugin* plugin = astn.getPlugin(p);
-      if (astn.getASTPlugin(name, false, true) != NULL && astn.getASTPlugin(name, false, true)->isMathMLNodeTag(name))
-      {
-        return true;
-      }
-    //}
-  }
 
-  return false;
+  // otherwise a package may define the element
+  ASTNode astn;
+  const ASTBasePlugin* plugin = astn.getASTPlugin(name, false, true);
+
+  return (plugin != NULL && plugin->isMathMLNodeTag(name));
+}
+
+
+bool
+isMathMLNodeTag(const string& name)
+{
+  return isMathMLNodeTag(getMathMLTag(name), name);
 }
 /** @endcond */
 
@@ -865,8 +889,9 @@ readMathML (ASTNode& node, XMLInputStream& stream, std::string reqd_prefix,
     return;
   }
  
-  const XMLToken elem = stream.next ();
-  const string&  name = elem.getName();
+  const XMLToken    elem = stream.next ();
+  const string&     name = elem.getName();
+  const MathMLTag_t tag  = getMathMLTag(name);
 
   static const int size = sizeof(MATHML_ELEMENTS) / sizeof(MATHML_ELEMENTS[0]);
 
@@ -957,13 +982,18 @@ readMathML (ASTNode& node, XMLInputStream& stream, std::string reqd_prefix,
   string className;
   string style;
 
-  elem.getAttributes().readInto( "encoding"     , encoding  );
-  elem.getAttributes().readInto( "type"         , type      );
-  elem.getAttributes().readInto( "definitionURL", url       );
-  elem.getAttributes().readInto( "units"        , units     );
-  elem.getAttributes().readInto( "id"           , id        );
-  elem.getAttributes().readInto( "class"        , className );
-  elem.getAttributes().readInto( "style"        , style     );
+  // most elements have no attributes at all
+  const XMLAttributes& attributes = elem.getAttributes();
+  if (!attributes.isEmpty())
+  {
+    attributes.readInto( "encoding"     , encoding  );
+    attributes.readInto( "type"         , type      );
+    attributes.readInto( "definitionURL", url       );
+    attributes.readInto( "units"        , units     );
+    attributes.readInto( "id"           , id        );
+    attributes.readInto( "class"        , className );
+    attributes.readInto( "style"        , style     );
+  }
 
   if (!id.empty())
     node.setId(id);
@@ -974,12 +1004,12 @@ readMathML (ASTNode& node, XMLInputStream& stream, std::string reqd_prefix,
   if (!style.empty())
     node.setStyle(style);
 
-  if ( !type.empty() && name != "cn")
+  if ( !type.empty() && tag != MATHML_TAG_CN)
   {
     logError(stream, elem, DisallowedMathTypeAttributeUse);    
   }
 
-  if ( !encoding.empty() && name != "csymbol")
+  if ( !encoding.empty() && tag != MATHML_TAG_CSYMBOL)
   {
     logError(stream, elem, DisallowedMathMLEncodingUse);    
   }
@@ -990,21 +1020,23 @@ readMathML (ASTNode& node, XMLInputStream& stream, std::string reqd_prefix,
   {      
     if (level > 2)
     {
-      if (name != "csymbol" && name != "semantics" && name != "ci")
+      if (tag != MATHML_TAG_CSYMBOL && tag != MATHML_TAG_SEMANTICS
+        && tag != MATHML_TAG_CI)
       {
         logError(stream, elem, DisallowedDefinitionURLUse);
       }
     }
     else if (level == 2 && version == 5)
     {
-      if (name != "csymbol" && name != "semantics" && name != "ci")
+      if (tag != MATHML_TAG_CSYMBOL && tag != MATHML_TAG_SEMANTICS
+        && tag != MATHML_TAG_CI)
       {
         logError(stream, elem, DisallowedDefinitionURLUse);
       }
     }
     else
     {
-      if (name != "csymbol" && name != "semantics")
+      if (tag != MATHML_TAG_CSYMBOL && tag != MATHML_TAG_SEMANTICS)
       {
         logError(stream, elem, DisallowedDefinitionURLUse);
       }
@@ -1016,7 +1048,7 @@ readMathML (ASTNode& node, XMLInputStream& stream, std::string reqd_prefix,
   {
     if (level > 2)
     {
-      if (name != "cn")
+      if (tag != MATHML_TAG_CN)
       {
         logError(stream, elem, DisallowedMathUnitsUse);    
       }
@@ -1027,10 +1059,11 @@ readMathML (ASTNode& node, XMLInputStream& stream, std::string reqd_prefix,
     }
   }
 
-  if (name == "apply" || name == "lambda" || name == "piecewise"
+  if (tag == MATHML_TAG_APPLY || tag == MATHML_TAG_LAMBDA
+    || tag == MATHML_TAG_PIECEWISE
     || (thisPlugin != NULL && thisPlugin->isMathMLNodeTag(name)))
   {
-    if (name == "apply")
+    if (tag == MATHML_TAG_APPLY)
     {
       /* catch case where user has used <apply/> */
       if (elem.isStart() && elem.isEnd()) return;
@@ -1045,9 +1078,11 @@ readMathML (ASTNode& node, XMLInputStream& stream, std::string reqd_prefix,
       // always incorrect
       stream.skipText();
       std::string nextName = stream.peek().getName();
-      if (nextName == "bvar" || nextName == "piece" || nextName == "otherwise"
-        || nextName == "logbase" || nextName == "degree" 
-        || nextName == "lambda" || nextName == "semantics")
+      MathMLTag_t nextTag  = getMathMLTag(nextName);
+      if (nextTag == MATHML_TAG_BVAR || nextTag == MATHML_TAG_PIECE
+        || nextTag == MATHML_TAG_OTHERWISE || nextTag == MATHML_TAG_LOGBASE
+        || nextTag == MATHML_TAG_DEGREE || nextTag == MATHML_TAG_LAMBDA
+        || nextTag == MATHML_TAG_SEMANTICS)
       {
         std::string message = "<";
         message += nextName;
@@ -1107,11 +1142,11 @@ readMathML (ASTNode& node, XMLInputStream& stream, std::string reqd_prefix,
 
       }
    }
-    else if (name == "lambda")
+    else if (tag == MATHML_TAG_LAMBDA)
     {
       node.setType(AST_LAMBDA);
     }
-    else if (name == "piecewise")
+    else if (tag == MATHML_TAG_PIECEWISE)
     {
       /* catch case where there is no otherwise
        * BUT do not return if we are dealing with <piecewise/>
@@ -1126,7 +1161,7 @@ readMathML (ASTNode& node, XMLInputStream& stream, std::string reqd_prefix,
     else
     {
       // in plugin
-      setType(node, elem, stream);
+      setType(node, tag, elem, stream);
     }
 
     while (stream.isGood() && stream.peek().isEndFor(elem) == false)
@@ -1166,11 +1201,12 @@ readMathML (ASTNode& node, XMLInputStream& stream, std::string reqd_prefix,
        * appropriate tag
        */
       std::string nextName = stream.peek().getName();
-      if (elem.getName() == "lambda" 
-        && nextName != "lambda"
-        && nextName != "bvar")
+      MathMLTag_t nextTag  = getMathMLTag(nextName);
+      if (tag == MATHML_TAG_LAMBDA
+        && nextTag != MATHML_TAG_LAMBDA
+        && nextTag != MATHML_TAG_BVAR)
       {
-        if ( !isMathMLNodeTag(nextName))
+        if ( !isMathMLNodeTag(nextTag, nextName))
         {
           std::string message = "<";
           message += nextName;
@@ -1187,7 +1223,7 @@ readMathML (ASTNode& node, XMLInputStream& stream, std::string reqd_prefix,
        * dont want to add the child since this makes it look like
        * it has a bvar
        */
-      if (nextName == "math") 
+      if (nextTag == MATHML_TAG_MATH) 
       {
         delete child;
         break;
@@ -1201,7 +1237,7 @@ readMathML (ASTNode& node, XMLInputStream& stream, std::string reqd_prefix,
       // one argument; which will be difficult in legacy math as it throws 
       // the information away when reading ie here
       // so we have to look here 
-      if (nextName == "piece")
+      if (nextTag == MATHML_TAG_PIECE)
       {
         // we should have added two children to the piecewise node
         if (node.getNumChildren() % 2 != 0)
@@ -1214,7 +1250,7 @@ readMathML (ASTNode& node, XMLInputStream& stream, std::string reqd_prefix,
       // only ever read one child for the otherwise and throw
       // everything else away
       // catch at end of function
-      else if (nextName == "otherwise")
+      else if (nextTag == MATHML_TAG_OTHERWISE)
       {
         // we should have added one child to the piecewise node
         if (node.getNumChildren() % 2 != 1)
@@ -1223,25 +1259,25 @@ readMathML (ASTNode& node, XMLInputStream& stream, std::string reqd_prefix,
             "The <otherwise> element should have one child element.");
         }
       }
-      if (nextName == "piece" && stream.isGood()) 
+      if (nextTag == MATHML_TAG_PIECE && stream.isGood()) 
         stream.next();
     }
   }
 
-  else if (name == "bvar")
+  else if (tag == MATHML_TAG_BVAR)
   {
     node.setBvar();
     readMathML(node, stream, reqd_prefix, inRead);
   }
 
-  else if (name == "degree" || name == "logbase" ||
-           name == "piece" || name == "otherwise" )
+  else if (tag == MATHML_TAG_DEGREE || tag == MATHML_TAG_LOGBASE ||
+           tag == MATHML_TAG_PIECE || tag == MATHML_TAG_OTHERWISE )
   {
     readMathML(node, stream, reqd_prefix, inRead);
-    if (name == "piece") return;
+    if (tag == MATHML_TAG_PIECE) return;
   }
 
-  else if (name == "semantics")
+  else if (tag == MATHML_TAG_SEMANTICS)
   {
     /* read in attributes */
     XMLAttributes tempAtt = elem.getAttributes();
@@ -1257,9 +1293,10 @@ readMathML (ASTNode& node, XMLInputStream& stream, std::string reqd_prefix,
     while ( stream.isGood() && !stream.peek().isEndFor(elem))
     {
       // here need to check that there is not an incorrect top-level tag
-      const XMLToken element1 = stream.peek();
-      const string&  name = element1.getName();
-      if (isMathMLNodeTag(name) && element1.isStart())
+      const XMLToken    element1 = stream.peek();
+      const string&     name     = element1.getName();
+      const MathMLTag_t nextTag  = getMathMLTag(name);
+      if (isMathMLNodeTag(nextTag, name) && element1.isStart())
       {
         std::string message = "Unexpected element encountered. The element <" +
           name + "> should not be encountered here.";
@@ -1267,8 +1304,9 @@ readMathML (ASTNode& node, XMLInputStream& stream, std::string reqd_prefix,
 
         stream.skipPastEnd(element1);
       }
-      if (stream.peek().getName() == "annotation"
-        || stream.peek().getName() == "annotation-xml")
+      const MathMLTag_t peekTag = getMathMLTag(stream.peek().getName());
+      if (peekTag == MATHML_TAG_ANNOTATION
+        || peekTag == MATHML_TAG_ANNOTATION_XML)
       {
         XMLNode semanticAnnotation = XMLNode(stream);
         node.addSemanticsAnnotation(semanticAnnotation.clone());
@@ -1281,7 +1319,7 @@ readMathML (ASTNode& node, XMLInputStream& stream, std::string reqd_prefix,
   }
   else
   {
-    setType(node, elem, stream);
+    setType(node, tag, elem, stream);
   }
 
   checkFunctionArgs(node);
@@ -1290,7 +1328,7 @@ readMathML (ASTNode& node, XMLInputStream& stream, std::string reqd_prefix,
   // one argument; which will be difficult in legacy math as it throws 
   // the information away when reading
   // and here is where we can catch an otherwise with too many children
-  if (name == "otherwise")
+  if (tag == MATHML_TAG_OTHERWISE)
   {
     while (stream.peek().isText())
     {
@@ -1365,6 +1403,7 @@ writeCI (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbmlns)
   else if (type == AST_NAME || type == AST_FUNCTION)
   {
     stream.startElement("ci");
+    const bool indent = stream.getAutoIndent();
     stream.setAutoIndent(false);
     writeAttributes(node, stream);
 #ifdef USE_MULTI
@@ -1388,7 +1427,7 @@ writeCI (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbmlns)
     }
 
     stream.endElement("ci");
-    stream.setAutoIndent(true);
+    stream.setAutoIndent(indent);
   }
   else
   {
@@ -1426,6 +1465,7 @@ writeCN (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbmlns=NU
   else if ( node.isNegInfinity() )
   {
     stream.startElement("apply");
+    const bool indent = stream.getAutoIndent();
     stream.setAutoIndent(false);
     stream << " ";
     stream.startEndElement("minus");
@@ -1433,7 +1473,7 @@ writeCN (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbmlns=NU
     writeStartEndElement("infinity", node, stream);
     stream << " ";
     stream.endElement("apply");
-    stream.setAutoIndent(true);
+    stream.setAutoIndent(indent);
   }
   else
   {
@@ -1447,6 +1487,7 @@ writeCN (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbmlns=NU
       stream.writeAttribute("sbml:units", node.getUnits());
     }
     
+    const bool indent = stream.getAutoIndent();
     stream.setAutoIndent(false);
 
     if ( node.isInteger() )
@@ -1475,7 +1516,7 @@ writeCN (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbmlns=NU
     }
 
     stream.endElement("cn");
-    stream.setAutoIndent(true);
+    stream.setAutoIndent(indent);
   }
 }
 /** @endcond */
@@ -1539,6 +1580,7 @@ writeCSymbol(const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbmln
   }
 
   stream.startElement("csymbol");
+  const bool indent = stream.getAutoIndent();
   stream.setAutoIndent(false);
   writeAttributes(node, stream);
   static const string text = "text";
@@ -1549,7 +1591,7 @@ writeCSymbol(const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbmln
     stream << " " << node.getName() << " ";
 
   stream.endElement("csymbol");
-  stream.setAutoIndent(true);
+  stream.setAutoIndent(indent);
 }
 /** @endcond */
 
@@ -1643,22 +1685,67 @@ writeENotation (  const string&    mantissa
 }
 /** @endcond */
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * The writers below do not call writeNode() for the children of a node:
+ * a long sum converted to binary nodes nests as deep as it has terms, and
+ * so would the calls.  Each writer writes what precedes the first child
+ * and appends what follows, in order, to a list of steps that writeNode()
+ * carries out with an explicit stack.
+ */
+struct MathMLStep
+{
+  enum Kind { NODE, START, END, END_SEMANTICS };
+
+  Kind            kind;
+  const ASTNode*  node;
+  const char*     name;
+  SBMLNamespaces* sbmlns;
+};
+
+typedef vector<MathMLStep> MathMLSteps;
+
+
+static void
+addNode (MathMLSteps& steps, const ASTNode* node, SBMLNamespaces* sbmlns)
+{
+  MathMLStep step = { MathMLStep::NODE, node, NULL, sbmlns };
+  steps.push_back(step);
+}
+
+
+static void
+addStart (MathMLSteps& steps, const char* name)
+{
+  MathMLStep step = { MathMLStep::START, NULL, name, NULL };
+  steps.push_back(step);
+}
+
+
+static void
+addEnd (MathMLSteps& steps, const char* name)
+{
+  MathMLStep step = { MathMLStep::END, NULL, name, NULL };
+  steps.push_back(step);
+}
+/** @endcond */
+
 /** @cond doxygenLibsbmlInternal */
 /*
  * Writes the two children of the given ASTNode.  The first child is
  * wrapped in a <logbase> element.
  */
 static void
-writeFunctionLog (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbmlns)
+writeFunctionLog (const ASTNode& node, MathMLSteps& steps, SBMLNamespaces *sbmlns)
 {
 
   if ( node.getNumChildren() > 1 )
   {
-    stream.startElement("logbase");
+    addStart(steps, "logbase");
 
-    if ( node.getLeftChild() )  writeNode(*node.getLeftChild(), stream, sbmlns);
+    if ( node.getLeftChild() )  addNode(steps, node.getLeftChild(), sbmlns);
 
-    stream.endElement("logbase");
+    addEnd(steps, "logbase");
   }
   /* I wanted to add this as a log can have a default logbase
    * however the rest of the code relating to log assumes it
@@ -1666,12 +1753,12 @@ writeFunctionLog (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *
    */
   //else if (node.getNumChildren() == 1)
   //{
-  //  writeNode(*node.getChild(0), stream, sbmlns);
+  //  addNode(steps, node.getChild(0), sbmlns);
   //}
 
   if ( node.getRightChild() ) 
   {
-    writeNode(*node.getRightChild(), stream, sbmlns);
+    addNode(steps, node.getRightChild(), sbmlns);
   }
 }
 /** @endcond */
@@ -1682,24 +1769,24 @@ writeFunctionLog (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *
  * in a <degree> element.
  */
 static void
-writeFunctionRoot (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbmlns)
+writeFunctionRoot (const ASTNode& node, MathMLSteps& steps, SBMLNamespaces *sbmlns)
 {
 
   if ( node.getNumChildren() > 1 )
   {
-    stream.startElement("degree");
+    addStart(steps, "degree");
 
-    if ( node.getLeftChild() )  writeNode(*node.getLeftChild(), stream, sbmlns);
+    if ( node.getLeftChild() )  addNode(steps, node.getLeftChild(), sbmlns);
 
-    stream.endElement("degree");
+    addEnd(steps, "degree");
   }
   else if (node.getNumChildren() == 1)
   {
     /* case where degree is not specified and defaults to 2 */
-    writeNode(*node.getChild(0), stream);
+    addNode(steps, node.getChild(0), NULL);
   }
 
-  if ( node.getRightChild() ) writeNode(*node.getRightChild(), stream, sbmlns);
+  if ( node.getRightChild() ) addNode(steps, node.getRightChild(), sbmlns);
 }
 /** @endcond */
 
@@ -1708,7 +1795,8 @@ writeFunctionRoot (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces
  * Writes the given ASTNode as <apply> <fn/> ... </apply>.
  */
 static void
-writeFunction (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbmlns)
+writeFunction (const ASTNode& node, XMLOutputStream& stream, MathMLSteps& steps,
+               SBMLNamespaces *sbmlns)
 {
 
   ASTNodeType_t type        = node.getType();
@@ -1767,22 +1855,22 @@ writeFunction (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbm
     //
     if (type == AST_FUNCTION_LOG)
     {
-      writeFunctionLog(node, stream, sbmlns);
+      writeFunctionLog(node, steps, sbmlns);
     }
     else if (type == AST_FUNCTION_ROOT)
     {
-      writeFunctionRoot(node, stream, sbmlns);
+      writeFunctionRoot(node, steps, sbmlns);
     }
     else
     {
       for (unsigned int c = 0; c < numChildren; c++)
       {
-        writeNode(*node.getChild(c), stream, sbmlns);
+        addNode(steps, node.getChild(c), sbmlns);
       }
     }
   }
 
-  stream.endElement("apply");
+  addEnd(steps, "apply");
 }
 /** @endcond */
 
@@ -1791,7 +1879,8 @@ writeFunction (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbm
  * Writes the given ASTNode as a <lambda> element.
  */
 static void
-writeLambda (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbmlns)
+writeLambda (const ASTNode& node, XMLOutputStream& stream, MathMLSteps& steps,
+             SBMLNamespaces *sbmlns)
 {
 
   bool bodyPresent = true;
@@ -1811,16 +1900,16 @@ writeLambda (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbmln
 
   for (n = 0; n < bvars; n++)
   {
-    stream.startElement("bvar");
-    writeNode(*node.getChild(n), stream, sbmlns);
-    stream.endElement("bvar");
+    addStart(steps, "bvar");
+    addNode(steps, node.getChild(n), sbmlns);
+    addEnd(steps, "bvar");
   }
   if (bodyPresent == true)
   {
-    writeNode( *node.getChild(n), stream, sbmlns);
+    addNode(steps, node.getChild(n), sbmlns);
   }
 
-  stream.endElement("lambda");
+  addEnd(steps, "lambda");
 }
 /** @endcond */
 
@@ -1830,7 +1919,7 @@ writeLambda (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbmln
  * doOperator().
  */
 static void
-writeOperatorArgs (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbmlns)
+writeOperatorArgs (const ASTNode& node, MathMLSteps& steps, SBMLNamespaces *sbmlns)
 {
 
   ASTNodeType_t type  = node.getType();
@@ -1853,38 +1942,57 @@ writeOperatorArgs (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces
   // more than 2 children - need to deal with this as the function
   // loses a child when written out
 
+  // The nested nodes are unrolled with an explicit stack rather than by
+  // recursion.  Each entry holds a node and whether to write its arguments
+  // (true) or the node itself (false).
+
   if (type == AST_PLUS || type == AST_TIMES)
   {
-    if (num <= 2)
+    vector< pair<const ASTNode*, bool> > pending;
+    pending.push_back(make_pair(&node, true));
+
+    while (!pending.empty())
     {
-      // two or less children - do what we always did
-      if (left != NULL)
+      const ASTNode* current = pending.back().first;
+      bool unroll = pending.back().second;
+      pending.pop_back();
+
+      if (!unroll)
       {
-        if (left->getType() == type) writeOperatorArgs(*left, stream, sbmlns);
-        else writeNode(*left, stream, sbmlns);
+        addNode(steps, current, sbmlns);
+        continue;
       }
 
-      if (right != NULL)
+      left  = current->getLeftChild();
+      right = current->getRightChild();
+      num   = current->getNumChildren();
+
+      if (num <= 2)
       {
-        if (right->getType() == type) writeOperatorArgs(*right, stream, sbmlns);
-        else writeNode(*right, stream, sbmlns);
+        // two or less children - do what we always did
+        if (right != NULL)
+        {
+          pending.push_back(make_pair(right, right->getType() == type));
+        }
+        if (left != NULL)
+        {
+          pending.push_back(make_pair(left, left->getType() == type));
+        }
       }
-    }
-    else
-    {
-      // more than two children that might or might not be functions
-      for (unsigned int n = 0; n < num; n++)
+      else
       {
-        writeNode(*(node.getChild(n)), stream, sbmlns);
+        // more than two children that might or might not be functions
+        for (unsigned int n = num; n > 0; n--)
+        {
+          pending.push_back(make_pair(current->getChild(n - 1), false));
+        }
       }
-
     }
-
   }
   else
   {
-    if (left != NULL)  writeNode(*left , stream, sbmlns);
-    if (right != NULL) writeNode(*right, stream, sbmlns);
+    if (left != NULL)  addNode(steps, left , sbmlns);
+    if (right != NULL) addNode(steps, right, sbmlns);
   }
 }
 /** @endcond */
@@ -1894,7 +2002,8 @@ writeOperatorArgs (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces
  * Writes the given ASTNode as a <apply> <op/> ... </apply>.
  */
 static void
-writeOperator (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbmlns)
+writeOperator (const ASTNode& node, XMLOutputStream& stream, MathMLSteps& steps,
+               SBMLNamespaces *sbmlns)
 {
 
   stream.startElement("apply");
@@ -1915,9 +2024,9 @@ writeOperator (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbm
     default:  break;
   }
 
-  writeOperatorArgs(node, stream, sbmlns);
+  writeOperatorArgs(node, steps, sbmlns);
 
-  stream.endElement("apply");
+  addEnd(steps, "apply");
 }
 /** @endcond */
 
@@ -1926,7 +2035,8 @@ writeOperator (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbm
  * Formats the given ASTNode as a <piecewise> element.
  */
 static void
-writePiecewise (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbmlns)
+writePiecewise (const ASTNode& node, XMLOutputStream& stream, MathMLSteps& steps,
+                SBMLNamespaces *sbmlns)
 {
 
   unsigned int numChildren = node.getNumChildren();
@@ -1942,68 +2052,90 @@ writePiecewise (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sb
 
   for (unsigned int n = 0; n < numPieces; n += 2)
   {
-    stream.startElement("piece");
+    addStart(steps, "piece");
 
-    writeNode( *node.getChild(n)    , stream, sbmlns );
-    writeNode( *node.getChild(n + 1), stream, sbmlns );
+    addNode(steps, node.getChild(n)    , sbmlns);
+    addNode(steps, node.getChild(n + 1), sbmlns);
 
-    stream.endElement("piece");
+    addEnd(steps, "piece");
   }
 
   if (numPieces < numChildren)
   {
-    stream.startElement("otherwise");
+    addStart(steps, "otherwise");
 
-    writeNode( *node.getChild(numPieces), stream, sbmlns );
+    addNode(steps, node.getChild(numPieces), sbmlns);
 
-    stream.endElement("otherwise");
+    addEnd(steps, "otherwise");
   }
 
-  stream.endElement("piecewise");
+  addEnd(steps, "piecewise");
 }
 /** @endcond */
 
 /** @cond doxygenLibsbmlInternal */
-/*
- * Formats the given ASTNode as a <semantics> element.
- */
 static void
-writeSemantics(const ASTNode& node, XMLOutputStream& stream, bool &inSemantics, SBMLNamespaces *sbmlns)
+writeTopLevelNode(const ASTNode& node, XMLOutputStream& stream, MathMLSteps& steps,
+  SBMLNamespaces *sbmlns, const char *name)
 {
-
-  inSemantics = true;
-  stream.startElement("semantics");
-  writeAttributes(node, stream);
-  if (node.getDefinitionURL())
-    stream.writeAttribute("definitionURL", 
-                            node.getDefinitionURL()->getValue(0));
-  writeNode(node, stream, sbmlns);
-
-  for (unsigned int n = 0; n < node.getNumSemanticsAnnotations(); n++)
+  stream.startElement(name);
+  for (unsigned int i = 0; i < node.getNumChildren(); ++i)
   {
-    stream << *node.getSemanticsAnnotation(n);
+    addNode(steps, node.getChild(i), sbmlns);
   }
-  stream.endElement("semantics");
-  inSemantics = false;
+  addEnd(steps, name);
+
 }
 /** @endcond */
 
 /** @cond doxygenLibsbmlInternal */
+/*
+ * True while the content of a <semantics> element is written, so that the
+ * node it wraps is not wrapped again.
+ */
+static bool inSemantics = false;
+
+
+/*
+ * Writes what precedes the first child of the given ASTNode, and appends
+ * the steps that write the rest of it.
+ */
 static void
-writeTopLevelNode(const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbmlns,
-  const char *name)
+writeNodeStart (const ASTNode& node, XMLOutputStream& stream, MathMLSteps& steps,
+                SBMLNamespaces *sbmlns)
 {
-  stream.startElement(name);
-  for (unsigned int i = 0; i < node.getNumChildren(); ++i)
+
+  const ASTBasePlugin* thisPlugin = node.getASTPlugin(node.getType());
+
+  if (node.getSemanticsFlag() && !inSemantics)
   {
-    writeNode(*node.getChild(i), stream, sbmlns);
+    inSemantics = true;
+    stream.startElement("semantics");
+    writeAttributes(node, stream);
+    if (node.getDefinitionURL())
+      stream.writeAttribute("definitionURL", 
+                              node.getDefinitionURL()->getValue(0));
+    writeNodeStart(node, stream, steps, sbmlns);
+
+    MathMLStep step = { MathMLStep::END_SEMANTICS, &node, NULL, NULL };
+    steps.push_back(step);
   }
-  stream.endElement(name);
 
+  else if (  node.isNumber   () ) writeCN       (node, stream, sbmlns);
+  else if (  node.isName     () ) writeCI       (node, stream, sbmlns);
+  else if (  node.isConstant () ) writeConstant (node, stream);
+  else if (  node.isOperator () ) writeOperator (node, stream, steps, sbmlns);
+  else if (  node.isLambda   () ) writeLambda   (node, stream, steps, sbmlns);
+  else if (  node.isPiecewise() ) writePiecewise(node, stream, steps, sbmlns);
+  else if (thisPlugin != NULL && thisPlugin->isMathMLNodeTag(node.getType()))
+  {
+    writeTopLevelNode(node, stream, steps, sbmlns,
+                      thisPlugin->getConstCharFor(node.getType()));
+  }
+  else if ( !node.isUnknown  () ) writeFunction (node, stream, steps, sbmlns);
 }
-/** @endcond */
 
-/** @cond doxygenLibsbmlInternal */
+
 /*
  * Writes the given ASTNode (and its children) to the XMLOutputStream as
  * MathML.
@@ -2011,49 +2143,73 @@ writeTopLevelNode(const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *
 static void
 writeNode (const ASTNode& node, XMLOutputStream& stream, SBMLNamespaces *sbmlns)
 {
+  // steps still to carry out, the next one last
+  MathMLSteps pending;
+  MathMLSteps steps;
+  addNode(pending, &node, sbmlns);
 
-  const ASTBasePlugin* thisPlugin = node.getASTPlugin(node.getType());
-  //if (node.getNumPlugins() == 0)
-  //{
-  //  const_cast<ASTNode&>(node).loadASTPlugins(NULL);
-  //}
+  while (!pending.empty())
+  {
+    MathMLStep step = pending.back();
+    pending.pop_back();
 
-  //unsigned int i = 0;
-  //bool found = false;
-  //while (!found && i < node.getNumPlugins())
-  //{
-  //  const ASTBasePlugin* plugin = node.getPlugin(i);
-  //  SBMLNamespaces* ns = stream.getSBMLNamespaces();
-  //  if ((ns == NULL || plugin->hasCorrectNamespace(ns)) && plugin->defines(node.getType()))
-  //  {
-  //    found = true;
-  //    thisPlugin = const_cast<ASTBasePlugin*>(plugin);
-  //  }
-  //  i++;
+    switch (step.kind)
+    {
+    case MathMLStep::NODE:
+      steps.clear();
+      writeNodeStart(*step.node, stream, steps, step.sbmlns);
+      pending.insert(pending.end(), steps.rbegin(), steps.rend());
+      break;
 
-  //}
-  static bool inSemantics = false;
-  
-  if (node.getSemanticsFlag() && !inSemantics)
-                     writeSemantics(node, stream, inSemantics, sbmlns);
+    case MathMLStep::START:
+      stream.startElement(step.name);
+      break;
 
-  else if (  node.isNumber   () ) writeCN       (node, stream, sbmlns);
-  else if (  node.isName     () ) writeCI       (node, stream, sbmlns);
-  else if (  node.isConstant () ) writeConstant (node, stream);
-  else if (  node.isOperator () ) writeOperator (node, stream, sbmlns);
-  else if (  node.isLambda   () ) writeLambda   (node, stream, sbmlns);
-  else if (  node.isPiecewise() ) writePiecewise(node, stream, sbmlns);
-  else if (thisPlugin != NULL && thisPlugin->isMathMLNodeTag(node.getType()))
-  {
-    writeTopLevelNode(node, stream, sbmlns, thisPlugin->getConstCharFor(node.getType()));
+    case MathMLStep::END:
+      stream.endElement(step.name);
+      break;
+
+    case MathMLStep::END_SEMANTICS:
+      for (unsigned int n = 0; n < step.node->getNumSemanticsAnnotations(); n++)
+      {
+        stream << *step.node->getSemanticsAnnotation(n);
+      }
+      stream.endElement("semantics");
+      inSemantics = false;
+      break;
+    }
   }
-  else if ( !node.isUnknown  () ) writeFunction (node, stream, sbmlns);
 }
 /** @endcond */
 
 
 #endif /* __cplusplus */
 
+static void
+addDefinitionURLs(const ASTBasePlugin* astPlugin)
+{
+  // already added as this can be a core package
+  if (astPlugin == NULL || astPlugin->getPackageName() == "l3v2extendedmath")
+    return;
+
+  unsigned int i = 0;
+  const ASTNodeValues_t* values = astPlugin->getASTNodeValue(i);
+  while (values != NULL)
+  {
+    if (!values->csymbolURL.empty())
+    {
+      DefinitionURLRegistry::addDefinitionURL(values->csymbolURL, values->type);
+    }
+    i++;
+    values = astPlugin->getASTNodeValue(i);
+  }
+}
+
+
+/*
+ * Adds the csymbol definitionURLs of the packages enabled for the stream,
+ * taken from the plugins held by the SBMLExtensionRegistry.
+ */
 void
 setSBMLDefinitionURLs(XMLInputStream& stream)
 {
@@ -2061,28 +2217,32 @@ setSBMLDefinitionURLs(XMLInputStream& stream)
   {
     DefinitionURLRegistry::addSBMLDefinitions();
   }
-  ASTNode*      temp = new ASTNode;
-  temp->loadASTPlugins(stream.getSBMLNamespaces());
-  for (unsigned int n = 0; n < temp->getNumPlugins(); ++n)
-  {
-    ASTBasePlugin * astPlug = temp->getPlugin(n);
-    // already added as this can be a core package
-    if (astPlug->getPackageName() == "l3v2extendedmath")
-      continue;
 
-    unsigned int i = 0;
-    const ASTNodeValues_t* values = astPlug->getASTNodeValue(i);
-    while (values != NULL)
+  SBMLExtensionRegistry& registry = SBMLExtensionRegistry::getInstance();
+  const SBMLNamespaces* sbmlns = stream.getSBMLNamespaces();
+  if (sbmlns == NULL)
+  {
+    for (unsigned int n = 0; n < registry.getNumASTPlugins(); ++n)
     {
-      if (!values->csymbolURL.empty())
+      const ASTBasePlugin* astPlugin = registry.getASTPlugin(n);
+      if (SBMLExtensionRegistry::isPackageEnabled(astPlugin->getPackageName()))
       {
-        DefinitionURLRegistry::addDefinitionURL(values->csymbolURL, values->type);
+        addDefinitionURLs(astPlugin);
       }
-      i++;
-      values = astPlug->getASTNodeValue(i);
+    }
+    return;
+  }
+
+  const XMLNamespaces* xmlns = sbmlns->getNamespaces();
+  for (int n = 0; xmlns != NULL && n < xmlns->getLength(); ++n)
+  {
+    const std::string& uri = xmlns->getURI(n);
+    const ASTBasePlugin* astPlugin = registry.getASTPluginForURI(uri);
+    if (astPlugin != NULL && registry.isEnabled(uri))
+    {
+      addDefinitionURLs(astPlugin);
     }
   }
-  delete temp;
 }
 
 
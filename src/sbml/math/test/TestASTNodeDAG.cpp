@@ -0,0 +1,187 @@
+/**
+ * \file    TestASTNodeDAG.cpp
+ * \brief   ASTNodeDAG unit tests
+ * \author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sbml/SBMLTypes.h>
+#include <sbml/SBMLTransforms.h>
+#include <sbml/math/ASTNodeDAG.h>
+#include <sbml/util/util.h>
+
+#include <check.h>
+
+/** @cond doxygenIgnored */
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+/** @endcond */
+
+
+CK_CPPSTART
+
+
+START_TEST (test_ASTNodeDAG_add)
+{
+  ASTNode* math = SBML_parseL3Formula("c * k * S + c * k * S");
+  ASTNodeDAG dag;
+
+  int id = dag.add(math);
+  fail_unless(id == 4);
+  fail_unless(dag.getExpression(id) == math);
+  fail_unless(dag.getNumNodesAdded() == 9);
+
+  // c, k, S, c * k * S and the sum
+  fail_unless(dag.getNumExpressions() == 5);
+  fail_unless(dag.getNumChildren(id) == 2);
+  fail_unless(dag.getChild(id, 0) == 3);
+  fail_unless(dag.getChild(id, 1) == 3);
+  fail_unless(dag.getChild(id, 2) == -1);
+  fail_unless(dag.getNumOccurrences(3) == 2);
+  fail_unless(dag.getNumOccurrences(id) == 1);
+  fail_unless(dag.getExpression(3) == math->getChild(0));
+  fail_unless(dag.getExpression(5) == NULL);
+
+  fail_unless(dag.add(NULL) == -1);
+  fail_unless(dag.find(math->getChild(1)) == 3);
+
+  ASTNode* other = SBML_parseL3Formula("k * S * c");
+  fail_unless(dag.find(other) == -1);
+  fail_unless(dag.add(other) == 5);
+  fail_unless(dag.getNumExpressions() == 6);
+  fail_unless(dag.getNumOccurrences(0) == 3);
+
+  dag.clear();
+  fail_unless(dag.getNumExpressions() == 0);
+  fail_unless(dag.getNumNodesAdded() == 0);
+  fail_unless(dag.find(other) == -1);
+
+  delete math;
+  delete other;
+}
+END_TEST
+
+
+START_TEST (test_ASTNodeDAG_equals)
+{
+  ASTNode* math1 = SBML_parseL3Formula("2 * x / (y + 0.5) + f(x)");
+  ASTNode* math2 = SBML_parseL3Formula("2 * x / (y + 0.5) + f(x)");
+  ASTNode* math3 = SBML_parseL3Formula("2 * x / (y + 5e-1) + f(x)");
+  ASTNode* math4 = SBML_parseL3Formula("2 * x / (y + 0.5) + f(y)");
+  ASTNode* math5 = SBML_parseL3Formula("2 mole * x / (y + 0.5) + f(x)");
+
+  fail_unless(ASTNodeDAG::equals(math1, math2));
+  fail_unless(ASTNodeDAG::getStructuralHash(math1) ==
+              ASTNodeDAG::getStructuralHash(math2));
+  fail_unless(!ASTNodeDAG::equals(math1, math3));
+  fail_unless(!ASTNodeDAG::equals(math1, math4));
+  fail_unless(!ASTNodeDAG::equals(math1, math5));
+  fail_unless(!ASTNodeDAG::equals(math1, NULL));
+  fail_unless(ASTNodeDAG::equals(NULL, NULL));
+  fail_unless(ASTNodeDAG::getStructuralHash(NULL) == 0);
+
+  ASTNodeDAG dag;
+  int id = dag.add(math1);
+  fail_unless(dag.getHash(id) == ASTNodeDAG::getStructuralHash(math1));
+  fail_unless(dag.add(math2) == id);
+  fail_unless(dag.add(math3) != id);
+  fail_unless(dag.add(math4) != id);
+  fail_unless(dag.add(math5) != id);
+
+  delete math1;
+  delete math2;
+  delete math3;
+  delete math4;
+  delete math5;
+}
+END_TEST
+
+
+START_TEST (test_ASTNodeDAG_memoize)
+{
+  SBMLDocument doc(3, 1);
+  Model* model = doc.createModel();
+  Parameter* p = model->createParameter();
+  p->setId("k");
+  p->setValue(2);
+  p->setConstant(true);
+  p = model->createParameter();
+  p->setId("S");
+  p->setValue(3);
+  p->setConstant(true);
+
+  AssignmentRule* rule = model->createAssignmentRule();
+  rule->setVariable("x");
+  rule->setMath(SBML_parseL3Formula("k * S + 1"));
+  rule = model->createAssignmentRule();
+  rule->setVariable("y");
+  rule->setMath(SBML_parseL3Formula("(k * S)^2 / -k"));
+  rule = model->createAssignmentRule();
+  rule->setVariable("z");
+  rule->setMath(SBML_parseL3Formula("max(k * S, 1)"));
+
+  ASTNodeDAG dag;
+  fail_unless(dag.addAllMath(model) == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(dag.addAllMath(NULL) == LIBSBML_INVALID_OBJECT);
+
+  int product = dag.find(model->getRule(0)->getMath()->getChild(0));
+  fail_unless(product >= 0);
+  fail_unless(dag.getNumOccurrences(product) == 3);
+
+  SBMLTransforms::clearComponentValues();
+  int x = dag.find(model->getRule(0)->getMath());
+  int y = dag.find(model->getRule(1)->getMath());
+  int z = dag.find(model->getRule(2)->getMath());
+  fail_unless(dag.evaluate(x, model) == 7);
+  fail_unless(dag.evaluate(y, model) == -18);
+  fail_unless(dag.evaluate(z, model) == 6);
+  fail_unless(util_isNaN(dag.evaluate(100, model)));
+
+  // values are kept until cleared
+  model->getParameter("k")->setValue(1);
+  SBMLTransforms::clearComponentValues();
+  fail_unless(dag.evaluate(x, model) == 7);
+  dag.clearValues();
+  fail_unless(dag.evaluate(x, model) == 4);
+  SBMLTransforms::clearComponentValues();
+
+  fail_unless(dag.getFormula(y) == "(k * S)^2 / -k");
+  fail_unless(dag.getFormula(product) == "k * S");
+  fail_unless(dag.getFormula(100).empty());
+}
+END_TEST
+
+
+Suite *
+create_suite_ASTNodeDAG (void)
+{
+  Suite *suite = suite_create("ASTNodeDAG");
+  TCase *tcase = tcase_create("ASTNodeDAG");
+
+  tcase_add_test( tcase, test_ASTNodeDAG_add      );
+  tcase_add_test( tcase, test_ASTNodeDAG_equals   );
+  tcase_add_test( tcase, test_ASTNodeDAG_memoize  );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+CK_CPPEND
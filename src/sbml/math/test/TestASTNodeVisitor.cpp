@@ -0,0 +1,318 @@
+/**
+ * \file    TestASTNodeVisitor.cpp
+ * \brief   ASTNodeVisitor unit tests, and traversal of deeply nested trees
+ * \author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include <sbml/SBMLDocument.h>
+#include <sbml/Model.h>
+#include <sbml/SBMLTransforms.h>
+#include <sbml/math/ASTNode.h>
+#include <sbml/math/ASTNodeVisitor.h>
+#include <sbml/math/FormulaFormatter.h>
+#include <sbml/math/L3FormulaFormatter.h>
+#include <sbml/math/L3Parser.h>
+#include <sbml/math/MathML.h>
+#include <sbml/util/List.h>
+#include <sbml/xml/XMLOutputStream.h>
+#include <sbml/util/util.h>
+
+#include <check.h>
+
+/** @cond doxygenIgnored */
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+/** @endcond */
+
+
+/*
+ * Records the names of the nodes it visits, and stops at a given name.
+ */
+class NameRecorder : public ASTNodeVisitor
+{
+public:
+  NameRecorder(const string& stopAt = "") : mStopAt(stopAt) { }
+
+  virtual bool visitPreOrder(const ASTNode* node)
+  {
+    mPre += getLabel(node);
+    return mStopAt != getLabel(node);
+  }
+
+  virtual bool visitPostOrder(const ASTNode* node)
+  {
+    mPost += getLabel(node);
+    return true;
+  }
+
+  static string getLabel(const ASTNode* node)
+  {
+    bool named = node->isName() || node->getType() == AST_FUNCTION;
+    return named ? node->getName() : "_";
+  }
+
+  string mStopAt;
+  string mPre;
+  string mPost;
+};
+
+
+/*
+ * Returns x + 1 + 1 ... nested as 'depth' binary sums, or the same chain
+ * of another binary operator, or f(f(...f(x))) for AST_FUNCTION.
+ */
+static ASTNode*
+createChain(unsigned int depth, ASTNodeType_t type = AST_PLUS)
+{
+  ASTNode* chain = new ASTNode(AST_NAME);
+  chain->setName("x");
+  for (unsigned int i = 0; i < depth; ++i)
+  {
+    ASTNode* node = new ASTNode(type);
+    node->addChild(chain);
+    if (type == AST_FUNCTION)
+    {
+      node->setName("f");
+    }
+    else
+    {
+      ASTNode* one = new ASTNode(AST_INTEGER);
+      one->setValue(1);
+      node->addChild(one);
+    }
+    chain = node;
+  }
+  return chain;
+}
+
+
+/*
+ * Returns the number of times a string occurs in another.
+ */
+static size_t
+countOccurrences(const string& text, const string& pattern)
+{
+  size_t count = 0;
+  for (size_t pos = text.find(pattern); pos != string::npos; 
+       pos = text.find(pattern, pos + pattern.size()))
+  {
+    ++count;
+  }
+  return count;
+}
+
+
+/*
+ * Returns the MathML of a tree without indentation, which would make the
+ * text quadratic in the depth of a chain.
+ */
+static string
+writeUnindentedMathML(const ASTNode* node)
+{
+  ostringstream os;
+  XMLOutputStream stream(os, "UTF-8", false);
+  stream.setAutoIndent(false);
+  writeMathML(node, stream);
+  return os.str();
+}
+
+
+/*
+ * Checks that a deep chain is copied, formatted and written in full.
+ */
+static void
+checkDeepChain(const ASTNode* chain, const string& formula, 
+               const string& element, size_t numElements)
+{
+  ASTNode* copy = chain->deepCopy();
+  fail_unless(copy->getNumChildren() == chain->getNumChildren());
+
+  char* l1 = SBML_formulaToString(copy);
+  fail_unless(l1 != NULL);
+  fail_unless(string(l1) == formula);
+  safe_free(l1);
+
+  char* l3 = SBML_formulaToL3String(copy);
+  fail_unless(l3 != NULL);
+  fail_unless(string(l3) == formula);
+  safe_free(l3);
+
+  string mathml = writeUnindentedMathML(copy);
+  fail_unless(mathml.find('\n') == string::npos);
+  fail_unless(countOccurrences(mathml, element) == numElements);
+
+  delete copy;
+}
+
+
+CK_CPPSTART
+
+
+START_TEST (test_ASTNodeVisitor_order)
+{
+  ASTNode* math = SBML_parseL3Formula("f(a * b, c) + d");
+
+  NameRecorder recorder;
+  fail_unless(recorder.traverse(math) == true);
+  fail_unless(recorder.mPre == "_f_abcd");
+  fail_unless(recorder.mPost == "ab_cfd_");
+
+  NameRecorder stopping("b");
+  fail_unless(stopping.traverse(math) == false);
+  fail_unless(stopping.mPre == "_f_ab");
+  fail_unless(stopping.mPost == "a");
+
+  fail_unless(recorder.traverse(NULL) == true);
+
+  delete math;
+}
+END_TEST
+
+
+START_TEST (test_ASTNodeVisitor_deepChain)
+{
+  const unsigned int depth = 200000;
+  ASTNode* chain = createChain(depth);
+
+  map<string, double> values;
+  values["x"] = 1;
+  fail_unless(SBMLTransforms::evaluateASTNode(chain, values) == depth + 1);
+
+  chain->renameSIdRefs("x", "y");
+  List* names = chain->getListOfNodes((ASTNodePredicate) ASTNode_isName);
+  fail_unless(names->getSize() == 1);
+  fail_unless(!strcmp(static_cast<ASTNode*>(names->get(0))->getName(), "y"));
+  delete names;
+
+  chain->getChild(1)->setUnits("dimensionless");
+  chain->renameUnitSIdRefs("dimensionless", "item");
+  fail_unless(chain->getChild(1)->getUnits() == "item");
+
+  // the sum is written as a single n-ary <plus/>
+  char* mathml = writeMathMLToString(chain);
+  fail_unless(mathml != NULL);
+  string written(mathml);
+  fail_unless(written.find("<plus/>") == written.rfind("<plus/>"));
+  safe_free(mathml);
+
+  delete chain;
+}
+END_TEST
+
+
+START_TEST (test_ASTNodeVisitor_deepMinus)
+{
+  const unsigned int depth = 200000;
+  ASTNode* chain = createChain(depth, AST_MINUS);
+
+  map<string, double> values;
+  values["x"] = 1;
+  fail_unless(SBMLTransforms::evaluateASTNode(chain, values) 
+              == 1.0 - depth);
+
+  string formula = "x";
+  for (unsigned int i = 0; i < depth; ++i)
+  {
+    formula += " - 1";
+  }
+  checkDeepChain(chain, formula, "<minus/>", depth);
+
+  delete chain;
+}
+END_TEST
+
+
+START_TEST (test_ASTNodeVisitor_deepDivide)
+{
+  const unsigned int depth = 200000;
+  ASTNode* chain = createChain(depth, AST_DIVIDE);
+
+  map<string, double> values;
+  values["x"] = 2;
+  fail_unless(SBMLTransforms::evaluateASTNode(chain, values) == 2);
+
+  string formula = "x";
+  for (unsigned int i = 0; i < depth; ++i)
+  {
+    formula += " / 1";
+  }
+  checkDeepChain(chain, formula, "<divide/>", depth);
+
+  delete chain;
+}
+END_TEST
+
+
+START_TEST (test_ASTNodeVisitor_deepFunction)
+{
+  const unsigned int depth = 200000;
+  ASTNode* chain = createChain(depth, AST_FUNCTION);
+
+  SBMLDocument document(3, 2);
+  Model* model = document.createModel();
+  FunctionDefinition* f = model->createFunctionDefinition();
+  f->setId("f");
+  ASTNode* lambda = SBML_parseL3Formula("lambda(x, x + 1)");
+  f->setMath(lambda);
+  delete lambda;
+
+  map<string, double> values;
+  values["x"] = 1;
+  fail_unless(SBMLTransforms::evaluateASTNode(chain, values, model) 
+              == depth + 1);
+
+  string formula;
+  for (unsigned int i = 0; i < depth; ++i)
+  {
+    formula += "f(";
+  }
+  formula += "x";
+  formula += string(depth, ')');
+  checkDeepChain(chain, formula, "<ci> f </ci>", depth);
+
+  delete chain;
+}
+END_TEST
+
+
+Suite *
+create_suite_ASTNodeVisitor (void)
+{
+  Suite *suite = suite_create("ASTNodeVisitor");
+  TCase *tcase = tcase_create("ASTNodeVisitor");
+
+  tcase_add_test( tcase, test_ASTNodeVisitor_order      );
+  tcase_add_test( tcase, test_ASTNodeVisitor_deepChain  );
+  tcase_add_test( tcase, test_ASTNodeVisitor_deepMinus  );
+  tcase_add_test( tcase, test_ASTNodeVisitor_deepDivide );
+  tcase_add_test( tcase, test_ASTNodeVisitor_deepFunction );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+CK_CPPEND
@@ -0,0 +1,209 @@
+/**
+ * \file    TestL3FormulaWriter.cpp
+ * \brief   L3FormulaWriter unit tests
+ * \author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <cstring>
+#include <string>
+
+#include <sbml/SBMLTypes.h>
+#include <sbml/math/L3FormulaWriter.h>
+#include <sbml/util/util.h>
+
+#include <check.h>
+
+/** @cond doxygenIgnored */
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+/** @endcond */
+
+
+/*
+ * Returns whether the writer and SBML_formulaToL3StringWithSettings() write
+ * the given formula the same way.
+ */
+static bool
+writesAsFormatter(const char* formula, L3ParserSettings* settings)
+{
+  ASTNode* math = SBML_parseL3FormulaWithSettings(formula, settings);
+  if (math == NULL)
+  {
+    return false;
+  }
+
+  L3FormulaWriter writer(settings);
+  char* expected = SBML_formulaToL3StringWithSettings(math, settings);
+  bool same = !strcmp(writer.format(math), expected);
+
+  safe_free(expected);
+  delete math;
+  return same;
+}
+
+
+CK_CPPSTART
+
+
+START_TEST (test_L3FormulaWriter_sameAsFormatter)
+{
+  const char* formulas[] =
+  {
+    "a + b * c", "(a + b) * c", "a - (b - c)", "a - b - c", "a / (b / c)",
+    "a / b / c", "a * b / c", "a^b^c", "(a^b)^c", "-x^2", "(-x)^2",
+    "x^-y", "-(a + b)", "-(-x)", "!(-a)", "-(!a)", "!a && b",
+    "!(a && b)", "a && b || c", "(a || b) && c", "x < y == z",
+    "x < y && y <= z", "x != y", "a + (b < c)", "(a && b) * c",
+    "piecewise(1, x > 2, 0)", "piecewise(x, y)", "x % y", "(x % y) * z",
+    "x % (y + z)", "log10(x)", "log(2, x)", "sqrt(y)", "root(3, y)",
+    "ln(x)", "exp(-x)", "ceil(x)", "floor(x / 2)", "acos(x) + asin(y)",
+    "atan(x)", "abs(-x)", "factorial(n)", "f(a, b + c)", "g()",
+    "delay(x, 2)", "pow(x, 2)", "xor(a + b, c)", "and(a)", "or()",
+    "plus()", "plus(a)", "times(a)", "geq(a, b, c)", "lambda(x, y, x^y)",
+    "avogadro * time", "true || false", "pi * exponentiale",
+    "3/4", "0.5 + 1e-10", "2.5e30 * x", "1e300", "INF - -INF", "NaN",
+    "-0", "123456789012345", "compartment * k1 * S1 - k2 * S2",
+    "Vmax * S / (Km + S)", "k * (A / (1 + (B / Ki)^n))",
+  };
+  L3ParserSettings settings;
+
+  for (size_t i = 0; i < sizeof(formulas) / sizeof(formulas[0]); ++i)
+  {
+    fail_unless(writesAsFormatter(formulas[i], &settings), formulas[i]);
+  }
+
+  settings.setParseCollapseMinus(true);
+  fail_unless(writesAsFormatter("-(-x) + -(-(-y))", &settings));
+
+  settings.setParseUnits(true);
+  fail_unless(writesAsFormatter("3 mole + 2.5 litre * x", &settings));
+  settings.setParseUnits(false);
+  fail_unless(writesAsFormatter("3 + 2.5 * x", &settings));
+}
+END_TEST
+
+
+START_TEST (test_L3FormulaWriter_numbers)
+{
+  L3FormulaWriter writer;
+  ASTNode value(AST_REAL);
+
+  value.setValue(0.1);
+  fail_unless(!strcmp(writer.format(&value), "0.1"));
+
+  value.setValue(0.1 + 0.2);
+  fail_unless(!strcmp(writer.format(&value), "0.30000000000000004"));
+  fail_unless(strtod(writer.format(&value), NULL) == 0.1 + 0.2);
+
+  value.setValue(1.0 / 3.0);
+  ASTNode* read = SBML_parseL3Formula(writer.format(&value));
+  fail_unless(read->getReal() == 1.0 / 3.0);
+  delete read;
+
+  value.setValue(1.5, 10);
+  fail_unless(!strcmp(writer.format(&value), "1.5e10"));
+
+  value.setValue(1L, 3L);
+  fail_unless(!strcmp(writer.format(&value), "(1/3)"));
+
+  fail_unless(writer.format(NULL) == NULL);
+  fail_unless(writer.getNumFormulas() == 0);
+}
+END_TEST
+
+
+START_TEST (test_L3FormulaWriter_formatAllMath)
+{
+  SBMLDocument doc(3, 1);
+  Model* model = doc.createModel();
+
+  Reaction* r1 = model->createReaction();
+  r1->setId("r1");
+  r1->createKineticLaw()->setMath(SBML_parseL3Formula("k1 * S"));
+  Reaction* r2 = model->createReaction();
+  r2->setId("r2");
+  r2->createKineticLaw();
+  AssignmentRule* rule = model->createAssignmentRule();
+  rule->setVariable("x");
+  rule->setMath(SBML_parseL3Formula("y^2 / (1 + y)"));
+
+  L3FormulaWriter writer;
+  fail_unless(writer.formatAllMath(model) == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(writer.getNumFormulas() == 2);
+  fail_unless(!strcmp(writer.getFormula(0), "y^2 / (1 + y)"));
+  fail_unless(writer.getElement(0) == rule);
+  fail_unless(!strcmp(writer.getFormula(1), "k1 * S"));
+  fail_unless(writer.getElement(1) == r1->getKineticLaw());
+  fail_unless(writer.getFormula(2) == NULL);
+  fail_unless(writer.getElement(2) == NULL);
+
+  fail_unless(writer.formatAllMath(rule) == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(writer.getNumFormulas() == 1);
+  fail_unless(writer.getElement(0) == rule);
+
+  fail_unless(writer.formatAllMath(NULL) == LIBSBML_INVALID_OBJECT);
+  fail_unless(writer.getNumFormulas() == 0);
+}
+END_TEST
+
+
+START_TEST (test_L3FormulaWriter_deepChain)
+{
+  const unsigned int depth = 200000;
+  ASTNode* chain = new ASTNode(AST_NAME);
+  chain->setName("x");
+  for (unsigned int i = 0; i < depth; ++i)
+  {
+    ASTNode* sum = new ASTNode(AST_PLUS);
+    ASTNode* one = new ASTNode(AST_INTEGER);
+    one->setValue(1);
+    sum->addChild(chain);
+    sum->addChild(one);
+    chain = sum;
+  }
+
+  L3FormulaWriter writer;
+  string formula = writer.format(chain);
+  fail_unless(formula.size() == 1 + 4 * depth);
+  fail_unless(formula.compare(0, 9, "x + 1 + 1") == 0);
+
+  delete chain;
+}
+END_TEST
+
+
+Suite *
+create_suite_L3FormulaWriter (void)
+{
+  Suite *suite = suite_create("L3FormulaWriter");
+  TCase *tcase = tcase_create("L3FormulaWriter");
+
+  tcase_add_test( tcase, test_L3FormulaWriter_sameAsFormatter );
+  tcase_add_test( tcase, test_L3FormulaWriter_numbers         );
+  tcase_add_test( tcase, test_L3FormulaWriter_formatAllMath   );
+  tcase_add_test( tcase, test_L3FormulaWriter_deepChain       );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+CK_CPPEND
@@ -63,6 +63,9 @@ CK_CPPSTART
 #endif
 
 Suite *create_suite_ASTNode          (void);
+Suite *create_suite_ASTNodeDAG       (void);
+Suite *create_suite_ASTNodeVisitor   (void);
+Suite *create_suite_L3FormulaWriter  (void);
 Suite *create_suite_FormulaFormatter (void);
 Suite *create_suite_FormulaParser    (void);
 Suite *create_suite_L3FormulaFormatter(void);
@@ -129,6 +132,9 @@ main (void)
 
   SRunner *runner = srunner_create( create_suite_ASTNode() );
 
+  srunner_add_suite( runner, create_suite_ASTNodeDAG           () );
+  srunner_add_suite( runner, create_suite_ASTNodeVisitor       () );
+  srunner_add_suite( runner, create_suite_L3FormulaWriter      () );
   srunner_add_suite( runner, create_suite_FormulaFormatter     () );
   srunner_add_suite( runner, create_suite_FormulaParser        () );
   srunner_add_suite( runner, create_suite_L3FormulaFormatter   () );
@@ -356,6 +356,16 @@ Dimension::renameSIdRefs(const std::string& oldid, const std::string& newid)
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+Dimension::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mSize, renames);
+}
+
+
 /*
  * Returns the XML element name of this Dimension object.
  */
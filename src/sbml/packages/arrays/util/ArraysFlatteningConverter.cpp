@@ -41,10 +41,14 @@
 #include <sbml/SpeciesReference.h>
 #include <sbml/Model.h>
 #include <sbml/Parameter.h>
+#include <sbml/util/util.h>
 
 #ifdef __cplusplus
 
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
 #include <string>
 
 using namespace std;
@@ -146,6 +150,7 @@ void ArraysFlatteningConverter::init()
 
 ArraysFlatteningConverter::ArraysFlatteningConverter() 
   : SBMLConverter("SBML Arrays Flattening Converter")
+  , mFromPrototype(false)
 {
 }
 
@@ -153,6 +158,7 @@ ArraysFlatteningConverter::ArraysFlatteningConverter()
 ArraysFlatteningConverter::ArraysFlatteningConverter
                          (const ArraysFlatteningConverter& orig) :
 SBMLConverter(orig)
+  , mFromPrototype(false)
 {
 }
 
@@ -220,6 +226,7 @@ ArraysFlatteningConverter::performConversion()
   }
 
   populateValueMap();
+  mKeys.clear();
 
   // go through the model and expand all variable type objects
   VariableFilter* filter = new VariableFilter(mDocument->getModel());
@@ -235,22 +242,31 @@ ArraysFlatteningConverter::performConversion()
   }
 
   // go through the model and expand all math type objects
+  // (this needs a second pass as these may be among the new elements)
   ArraysMathFilter* m_filter = new ArraysMathFilter();
-  List * mathchildren = mDocument->getAllElements(m_filter);
-  for (ListIterator it = mathchildren->begin(); it != mathchildren->end(); ++it)
+  List * mathchildren = NULL;
+  if (success)
   {
-    const SBase* obj = (const SBase*)(*it);
+    mathchildren = mDocument->getAllElements(m_filter);
+    for (ListIterator it = mathchildren->begin(); 
+         it != mathchildren->end(); ++it)
+    {
+      const SBase* obj = (const SBase*)(*it);
 
-    //cout << "Obj is " << obj->getElementName() << endl;
-    success = expandVariableElement(obj, false);
-    if (!success)
-      break;
+      //cout << "Obj is " << obj->getElementName() << endl;
+      success = expandVariableElement(obj, false);
+      if (!success)
+        break;
+    }
   }
 
   // check we are done and remove arrays ns
   mDocument->disablePackage("http://www.sbml.org/sbml/level3/version1/arrays/version1", "arrays");
   delete filter;
   delete m_filter;
+  delete variables;
+  delete mathchildren;
+  mKeys.clear();
 
   if (success)
     return LIBSBML_OPERATION_SUCCESS;
@@ -261,16 +277,50 @@ ArraysFlatteningConverter::performConversion()
 
 /** @cond doxygenLibsbmlInternal */
 std::string
-getNewId(std::vector<unsigned int> arrayEntry, const std::string& id)
+getNewId(const std::vector<unsigned int>& arrayEntry, const std::string& id)
 {
-  ostringstream oss;
-  oss << id;
-  for (std::vector<unsigned int>::iterator it = arrayEntry.begin(); 
-                                           it != arrayEntry.end(); ++it)
+  std::string newId;
+  newId.reserve(id.size() + 8 * arrayEntry.size());
+  newId += id;
+
+  char number[16];
+  for (std::vector<unsigned int>::const_iterator it = arrayEntry.begin(); 
+                                                 it != arrayEntry.end(); ++it)
   {
-    oss << "_" << *it;
+    sprintf(number, "_%u", *it);
+    newId += number;
+  }
+  return newId;
+}
+
+
+/*
+ * Returns the key under which the list the element belongs to refuses a
+ * second element, as the add functions of Model do; returns false if the
+ * list takes any number of such elements.
+ */
+static bool
+getDuplicateKey(const SBase* element, std::string& key)
+{
+  switch (element->getTypeCode())
+  {
+  case SBML_INITIAL_ASSIGNMENT:
+    key = static_cast<const InitialAssignment*>(element)->getSymbol();
+    return true;
+  case SBML_ASSIGNMENT_RULE:
+  case SBML_RATE_RULE:
+    key = static_cast<const Rule*>(element)->getVariable();
+    return true;
+  case SBML_ALGEBRAIC_RULE:
+  case SBML_CONSTRAINT:
+    return false;
+  case SBML_EVENT:
+    key = element->getId();
+    return element->isSetId();
+  default:
+    key = element->getId();
+    return true;
   }
-  return oss.str();
 }
 
 
@@ -283,36 +333,16 @@ getNewId(std::vector<unsigned int> arrayEntry, const std::string& id)
 // [1, 0] -> [1, 1] -> [2, 0] -> [2, 1]
 // 
 // slightly confusing as the indexing of the vectors does not correspond to arrayDimension
+//
+// entry number j is found from the strides mArrayStride = [2, 1] as
+// mArrayEntry[i] = (j / mArrayStride[i]) % mArraySize[i]
 
 void
-ArraysFlatteningConverter::updateArrayEntry(unsigned int index)
+ArraysFlatteningConverter::setArrayEntry(unsigned int entry)
 {
-  if (index == 0)
-    return;
- // viewArray(mArrayEntry);
-  //viewArray(mArraySize);
-  unsigned int current = mArrayEntry.at(index - 1) + 1;
-  unsigned int columnSize = mArraySize.at(index - 1);
-  std::vector<unsigned int> returnArray;
-
-  if (current < columnSize)
-  {
-    size_t final = mArraySize.size() - 1;
-    size_t i = 0;
-    for (i = 0; i < index - 1; i++)
-    {
-      returnArray.push_back(mArrayEntry.at(i));
-    }
-    returnArray.push_back(mArrayEntry.at(index - 1) + 1);
-
-    for (; i < final; i++)
-      returnArray.push_back(0);
-
-    mArrayEntry.swap(returnArray);
-  }
-  else
+  for (size_t i = 0; i < mArrayEntry.size() && i < mArrayStride.size(); i++)
   {
-    updateArrayEntry(index - 1);
+    mArrayEntry[i] = (entry / mArrayStride[i]) % mArraySize.at(i);
   }
 }
 
@@ -343,7 +373,6 @@ ArraysFlatteningConverter::adjustMath(SBase* newElement, const Index* index)
   {
     return true;
   }
-  addDimensionToModelValues();
 
   unsigned int count = mArrayEntry.at(0); 
   // SK this is used to index a vector but may not be the correct value
@@ -369,7 +398,7 @@ ArraysFlatteningConverter::adjustMath(SBase* newElement, const Index* index)
       if (count < n)
       {
         ASTNode* value = (ASTNode*)(child->getChild(count));
-        double calc = SBMLTransforms::evaluateASTNode(value, mValues);
+        double calc = evaluateMath(value, false);
         ASTNode* newAST = new ASTNode(AST_REAL);
         newAST->setValue(calc);
         newElement->setMath(newAST);
@@ -380,7 +409,7 @@ ArraysFlatteningConverter::adjustMath(SBase* newElement, const Index* index)
     {
       std::string varName = child->getName();
       // SK what if index is null
-      unsigned int calc = (unsigned int)(SBMLTransforms::evaluateASTNode(index->getMath(), mValues));
+      unsigned int calc = (unsigned int)(evaluateMath(index->getMath(), true));
       std::vector<unsigned int> indexArray;
       indexArray.push_back(calc);
       ASTNode* newAST = new ASTNode(AST_NAME);
@@ -394,24 +423,22 @@ ArraysFlatteningConverter::adjustMath(SBase* newElement, const Index* index)
   {
     // SK TO DO expand for all dimensions
     // what if index is null
-    double calc = SBMLTransforms::evaluateASTNode(index->getMath(), mValues);
+    double calc = evaluateMath(index->getMath(), true);
     ASTNode * newAST = new ASTNode(AST_INTEGER);
     newAST->setValue((int)(calc));
     math->replaceArgument(mDimensionIndex.at(0), newAST);
     adjusted = true;
   }
 
-  removeDimensionFromModelValues();
-
   return adjusted;
 }
 
 bool
-ArraysFlatteningConverter::adjustReferencedAttribute(SBase* newElement, bool calcIndex)
+ArraysFlatteningConverter::adjustReferencedAttribute(SBase* newElement, 
+                                                     const ArraysSBasePlugin* plugin,
+                                                     bool calcIndex)
 {
   std::string refAtt = "";
-  const ArraysSBasePlugin * plugin =
-    static_cast<const ArraysSBasePlugin*>(newElement->getPlugin("arrays"));
   // SK current dimension is never updated; 
   // also may need to looking there being two reference attribs
   const Index* index = plugin->getIndexByArrayDimension(mCurrentDimension);
@@ -515,6 +542,12 @@ ArraysFlatteningConverter::getNumEntries(const ArraysSBasePlugin* plugin, const
       numEntries *= mArraySize.at(i);
       mDimensionIndex.append(plugin->getDimensionByArrayDimension(i)->getId());
     }
+
+    mArrayStride.assign(mNoDimensions, 1);
+    for (unsigned int i = mNoDimensions - 1; i > 0; i--)
+    {
+      mArrayStride[i - 1] = mArrayStride[i] * mArraySize.at(i);
+    }
   }
 
   return numEntries;
@@ -541,12 +574,21 @@ ArraysFlatteningConverter::expandVariableElement(const SBase* element, bool notM
   unsigned int numEntries = getNumEntries(plugin);
   if (mArraySize.size() >= 1 && mArraySize.at(0) >= 1)
   {
+    SBase* prototype = createPrototype(element);
+    mFromPrototype = (prototype != NULL);
+
     unsigned int j = 0;
     while (success && j < numEntries)
     {
-      success = expandVariable(element, notMath);
+      setArrayEntry(j);
+      success = expandVariable(element, notMath, prototype);
       j++;
     }
+
+    delete prototype;
+    mFromPrototype = false;
+    mChildPlugins.clear();
+    mIndexPrograms.clear();
   }
 
   if (success)
@@ -568,7 +610,11 @@ ArraysFlatteningConverter::expandVariableElement(const SBase* element, bool notM
     if (parent != NULL)
     {
       SBase *obj = parent->removeChildObject(elementName, id);
-      if (obj != NULL)  delete obj;
+      if (obj != NULL)
+      {
+        forgetKey(obj);
+        delete obj;
+      }
     }
   }
 
@@ -576,7 +622,8 @@ ArraysFlatteningConverter::expandVariableElement(const SBase* element, bool notM
 }
 
 bool
-ArraysFlatteningConverter::expandNonDimensionedVariable(SBase* element)
+ArraysFlatteningConverter::expandNonDimensionedVariable(SBase* element, 
+                                                        const ArraysSBasePlugin* plugin)
 {
   if (element->getPackageName() == "arrays")
   {
@@ -584,8 +631,6 @@ ArraysFlatteningConverter::expandNonDimensionedVariable(SBase* element)
   }
 //  cout << "processing " << element->getElementName() << endl;
   std::string refAtt = "";
-  const ArraysSBasePlugin * plugin =
-    static_cast<const ArraysSBasePlugin*>(element->getPlugin("arrays"));
   const Index* index = NULL;
   // SK current dimension is never updated; 
   // also may need to looking there being two reference attribs
@@ -605,7 +650,7 @@ ArraysFlatteningConverter::expandNonDimensionedVariable(SBase* element)
   {
     return false;
   }
-  if (!refAtt.empty() && !adjustReferencedAttribute(element))
+  if (!refAtt.empty() && !adjustReferencedAttribute(element, plugin))
   {
     return false;
   }
@@ -614,8 +659,58 @@ ArraysFlatteningConverter::expandNonDimensionedVariable(SBase* element)
 }
 
 
+/*
+ * Returns a copy of the element without its arrays plugins, from which
+ * its entries are copied in turn.  Copying the Dimension and Index objects
+ * into each entry takes most of the time of the conversion, and they are
+ * all removed from the flat model in the end; the entries read them from
+ * the element and its descendants instead, whose plugins are collected in
+ * mChildPlugins.  Returns NULL if a descendant has dimensions of its own,
+ * since these are expanded in each entry.
+ */
+SBase*
+ArraysFlatteningConverter::createPrototype(const SBase* element)
+{
+  const ArraysSBasePlugin * plugin =
+    static_cast<const ArraysSBasePlugin*>(element->getPlugin("arrays"));
+  if (plugin == NULL)
+  {
+    return NULL;
+  }
+
+  mChildPlugins.clear();
+  bool dimensioned = false;
+  ArraysChildFilter filter;
+  List * children = const_cast<SBase*>(element)->getAllElements(&filter);
+  for (ListIterator it = children->begin(); it != children->end(); ++it)
+  {
+    const SBase* child = (const SBase*)(*it);
+    const ArraysSBasePlugin * childPlugin =
+      static_cast<const ArraysSBasePlugin*>(child->getPlugin("arrays"));
+    if (childPlugin != NULL && childPlugin->getNumDimensions() > 0)
+    {
+      dimensioned = true;
+    }
+    mChildPlugins.push_back(childPlugin);
+  }
+  delete children;
+
+  if (dimensioned)
+  {
+    mChildPlugins.clear();
+    return NULL;
+  }
+
+  SBase* prototype = element->clone();
+  prototype->disablePackage(plugin->getURI(), plugin->getPrefix());
+  prototype->deleteDisabledPlugins();
+  return prototype;
+}
+
+
 bool
-ArraysFlatteningConverter::expandVariable(const SBase* element, bool notMath)
+ArraysFlatteningConverter::expandVariable(const SBase* element, bool notMath, 
+                                          const SBase* prototype)
 {
   std::string elementName = element->getElementName();
   std::string refAtt = "";
@@ -629,7 +724,8 @@ ArraysFlatteningConverter::expandVariable(const SBase* element, bool notMath)
     refAtt = index->getReferencedAttribute();
   }
 
-  SBase* newElement = element->clone();
+  SBase* newElement = 
+    (prototype != NULL) ? prototype->clone() : element->clone();
   if (!adjustMath(newElement, index))
   {
     return false;
@@ -639,7 +735,7 @@ ArraysFlatteningConverter::expandVariable(const SBase* element, bool notMath)
     return false;
   }
 
-  if (!refAtt.empty() && !adjustReferencedAttribute(newElement, notMath))
+  if (!refAtt.empty() && !adjustReferencedAttribute(newElement, plugin, notMath))
   {
     return false;
   }
@@ -663,31 +759,131 @@ ArraysFlatteningConverter::expandVariable(const SBase* element, bool notMath)
       }
     }
   }
-  if (parent == NULL || parent->addChildObject(elementName, newElement)
+  if (parent == NULL || !addNewElement(element, parent, elementName, newElement))
+  {
+    return false;
+  }
+
+  return true;
+}
+
+
+/*
+ * Adds the new element next to the one it was expanded from.
+ *
+ * The elements of a model go straight into their list, which thus need not
+ * be searched through for each one to refuse duplicates: the keys of each
+ * list are kept in a set for the whole of the conversion.  The new element
+ * is owned by the parent or deleted.
+ */
+bool
+ArraysFlatteningConverter::addNewElement(const SBase* element, SBase* parent,
+                                         const std::string& elementName, 
+                                         SBase* newElement)
+{
+  SBase* list = const_cast<SBase*>(element->getParentSBMLObject());
+  if (parent->getTypeCode() != SBML_MODEL || list == NULL 
+    || list->getTypeCode() != SBML_LIST_OF)
+  {
+    int result = parent->addChildObject(elementName, newElement);
+    delete newElement;
+    return (result == LIBSBML_OPERATION_SUCCESS);
+  }
+
+  if (!newElement->hasRequiredAttributes() 
+    || !newElement->hasRequiredElements())
+  {
+    delete newElement;
+    return false;
+  }
+
+  std::string key;
+  if (getDuplicateKey(newElement, key))
+  {
+    std::set<std::string>& keys = getKeys(static_cast<ListOf*>(list));
+    if (!keys.insert(key).second)
+    {
+      delete newElement;
+      return false;
+    }
+  }
+
+  if (static_cast<ListOf*>(list)->appendAndOwn(newElement) 
     != LIBSBML_OPERATION_SUCCESS)
   {
+    delete newElement;
     return false;
   }
-  updateArrayEntry(mNoDimensions);
 
   return true;
 }
 
 
+/*
+ * Returns the keys of the elements in the list, collecting them the first
+ * time.
+ */
+std::set<std::string>&
+ArraysFlatteningConverter::getKeys(const ListOf* list)
+{
+  std::map<const ListOf*, std::set<std::string> >::iterator it = 
+    mKeys.find(list);
+  if (it != mKeys.end())
+  {
+    return it->second;
+  }
+
+  std::set<std::string>& keys = mKeys[list];
+  std::string key;
+  for (unsigned int i = 0; i < list->size(); ++i)
+  {
+    if (getDuplicateKey(list->get(i), key))
+    {
+      keys.insert(key);
+    }
+  }
+  return keys;
+}
+
+
+/*
+ * Removes the key of an element taken out of its list.
+ */
+void
+ArraysFlatteningConverter::forgetKey(const SBase* element)
+{
+  std::map<const ListOf*, std::set<std::string> >::iterator it = 
+    mKeys.find(static_cast<const ListOf*>(element->getParentSBMLObject()));
+  std::string key;
+  if (it != mKeys.end() && getDuplicateKey(element, key))
+  {
+    it->second.erase(key);
+  }
+}
+
+
 bool
 ArraysFlatteningConverter::dealWithChildObjects(SBase* parent, SBase* element, const Index* index)
 {
   bool success = true;
-  ArraysChildFilter* filter = new ArraysChildFilter();
-  List * variables = element->getAllElements(filter);
-  for (ListIterator it = variables->begin(); it != variables->end(); ++it)
+  ArraysChildFilter filter;
+  List * variables = element->getAllElements(&filter);
+  if (mFromPrototype && variables->getSize() != mChildPlugins.size())
+  {
+    delete variables;
+    return false;
+  }
+
+  size_t n = 0;
+  for (ListIterator it = variables->begin(); it != variables->end(); ++it, ++n)
   {
     bool removeObject = false;
     SBase* obj = (SBase*)(*it);
 
     //cout << "Obj is " << obj->getElementName() << endl;
     
-    ArraysSBasePlugin *plugin = static_cast<ArraysSBasePlugin*>(obj->getPlugin("arrays"));
+    const ArraysSBasePlugin *plugin = mFromPrototype ? mChildPlugins[n] :
+      static_cast<const ArraysSBasePlugin*>(obj->getPlugin("arrays"));
     if (plugin != NULL && plugin->getNumDimensions() > 1)
     {
       unsigned int numEntries = 0;
@@ -704,6 +900,7 @@ ArraysFlatteningConverter::dealWithChildObjects(SBase* parent, SBase* element, c
         unsigned int j = 0;
         while (success && j < numEntries)
         {
+          setArrayEntry(j);
           success = expandVariable(obj, true);
           j++;
         }
@@ -716,7 +913,7 @@ ArraysFlatteningConverter::dealWithChildObjects(SBase* parent, SBase* element, c
     }
     else
     {
-      success = expandNonDimensionedVariable(obj);
+      success = expandNonDimensionedVariable(obj, plugin);
     }
 
     if (!success)
@@ -770,6 +967,7 @@ ArraysFlatteningConverter::dealWithChildObjects(SBase* parent, SBase* element, c
     }
 
   }
+  delete variables;
   return success;
 }
 
@@ -780,16 +978,228 @@ ArraysFlatteningConverter::evaluateIndex(const Index* index)
 {
   if (index == NULL) return 0;
 
-  unsigned int value = 0;
-  addDimensionToModelValues();
+  return (unsigned int)(evaluateMath(index->getMath(), true));
+}
 
-  value = (unsigned int)(SBMLTransforms::evaluateASTNode(index->getMath(), mValues));
 
-  removeDimensionFromModelValues();
+/*
+ * Evaluates math at the current array entry.  Math made of numbers, 
+ * values of the model, dimension ids and the operators runProgram() 
+ * knows is compiled, and the index math of an element whose entries are
+ * copied from a prototype only once; anything else is left to 
+ * evaluateASTNode() with the dimension ids added to the values.
+ */
+double
+ArraysFlatteningConverter::evaluateMath(const ASTNode* math, bool indexMath)
+{
+  IndexProgram* program = &mProgram;
+  if (indexMath && mFromPrototype)
+  {
+    std::map<const ASTNode*, IndexProgram>::iterator it = 
+      mIndexPrograms.find(math);
+    if (it == mIndexPrograms.end())
+    {
+      it = mIndexPrograms.insert(make_pair(math, IndexProgram())).first;
+      if (!compileMath(math, it->second))
+      {
+        it->second.clear();
+      }
+    }
+    program = &(it->second);
+  }
+  else
+  {
+    mProgram.clear();
+    if (!compileMath(math, mProgram))
+    {
+      mProgram.clear();
+    }
+  }
+
+  if (!program->empty())
+  {
+    return runProgram(*program);
+  }
 
+  addDimensionToModelValues();
+  double value = SBMLTransforms::evaluateASTNode(math, mValues);
+  removeDimensionFromModelValues();
   return value;
 }
 
+
+/*
+ * Appends the operations of the math in postfix order; returns false if
+ * it has a node that is not compiled.  A name that is not a dimension id
+ * is looked up in the values of the model once, as evaluateASTNode() would
+ * look it up for each entry.
+ */
+bool
+ArraysFlatteningConverter::compileMath(const ASTNode* math, IndexProgram& program)
+{
+  if (math == NULL)
+  {
+    return false;
+  }
+
+  IndexOperation operation;
+  operation.type = math->getType();
+  operation.operand = math->getNumChildren();
+  operation.value = 0;
+
+  switch (math->getType())
+  {
+  case AST_INTEGER:
+    operation.type = AST_REAL;
+    operation.value = (double)(math->getInteger());
+    program.push_back(operation);
+    return true;
+
+  case AST_REAL:
+  case AST_REAL_E:
+  case AST_RATIONAL:
+    operation.type = AST_REAL;
+    operation.value = math->getReal();
+    program.push_back(operation);
+    return true;
+
+  case AST_NAME:
+    if (math->getName() == NULL)
+    {
+      return false;
+    }
+    operation.operand = 0;
+    for (IdList::const_iterator it = mDimensionIndex.begin(); 
+         it != mDimensionIndex.end() && operation.operand < mNoDimensions; 
+         ++it, ++operation.operand)
+    {
+      if (*it == math->getName())
+      {
+        program.push_back(operation);
+        return true;
+      }
+    }
+    {
+      SBMLTransforms::IdValueIter it = mValues.find(math->getName());
+      operation.type = AST_REAL;
+      operation.value = (it != mValues.end()) ? (it->second).first
+                               : numeric_limits<double>::quiet_NaN();
+      // a value set by a rule is only known by evaluating the rule
+      if (it != mValues.end() && util_isNaN(operation.value)
+        && (it->second).second)
+      {
+        return false;
+      }
+    }
+    program.push_back(operation);
+    return true;
+
+  case AST_PLUS:
+  case AST_TIMES:
+    break;
+
+  case AST_MINUS:
+    if (operation.operand != 1 && operation.operand != 2)
+    {
+      return false;
+    }
+    break;
+
+  case AST_DIVIDE:
+    if (operation.operand != 2)
+    {
+      return false;
+    }
+    break;
+
+  case AST_FUNCTION_ABS:
+  case AST_FUNCTION_CEILING:
+  case AST_FUNCTION_FLOOR:
+    if (operation.operand != 1)
+    {
+      return false;
+    }
+    break;
+
+  default:
+    return false;
+  }
+
+  for (unsigned int i = 0; i < math->getNumChildren(); i++)
+  {
+    if (!compileMath(math->getChild(i), program))
+    {
+      return false;
+    }
+  }
+  program.push_back(operation);
+  return true;
+}
+
+
+/*
+ * Runs compiled math with the values of the dimensions at the current
+ * array entry.
+ */
+double
+ArraysFlatteningConverter::runProgram(const IndexProgram& program)
+{
+  mStack.clear();
+  for (IndexProgram::const_iterator op = program.begin(); 
+       op != program.end(); ++op)
+  {
+    if (op->type == AST_REAL)
+    {
+      mStack.push_back(op->value);
+      continue;
+    }
+    if (op->type == AST_NAME)
+    {
+      mStack.push_back(mArrayEntry.at(mNoDimensions - 1 - op->operand));
+      continue;
+    }
+
+    size_t first = mStack.size() - op->operand;
+    double result = 0;
+    switch (op->type)
+    {
+    case AST_PLUS:
+      for (size_t i = first; i < mStack.size(); i++)
+      {
+        result = (i == first) ? mStack[i] : result + mStack[i];
+      }
+      break;
+    case AST_TIMES:
+      result = 1.0;
+      for (size_t i = first; i < mStack.size(); i++)
+      {
+        result = (i == first) ? mStack[i] : result * mStack[i];
+      }
+      break;
+    case AST_MINUS:
+      result = (op->operand == 1) ? -mStack[first] 
+                                  : mStack[first] - mStack[first + 1];
+      break;
+    case AST_DIVIDE:
+      result = mStack[first] / mStack[first + 1];
+      break;
+    case AST_FUNCTION_ABS:
+      result = fabs(mStack[first]);
+      break;
+    case AST_FUNCTION_CEILING:
+      result = ceil(mStack[first]);
+      break;
+    default:
+      result = floor(mStack[first]);
+      break;
+    }
+    mStack.resize(first);
+    mStack.push_back(result);
+  }
+
+  return mStack.back();
+}
+
 bool
 ArraysFlatteningConverter::dealWithMathChild(SBase* element)
 {
@@ -832,11 +1242,11 @@ ArraysFlatteningConverter::replaceSelector(ASTNode* math, bool &adjusted, const
       unsigned int calc = 0;
       if (index != NULL)
       {
-        calc = (unsigned int)(SBMLTransforms::evaluateASTNode(index->getMath(), mValues));
+        calc = (unsigned int)(evaluateMath(index->getMath(), true));
       }
       else
       {
-        calc = (unsigned int)(SBMLTransforms::evaluateASTNode(child->getChild(1), mValues));
+        calc = (unsigned int)(evaluateMath(child->getChild(1), false));
       }
 
       if (child0->getType() == AST_LINEAR_ALGEBRA_VECTOR)
@@ -845,7 +1255,7 @@ ArraysFlatteningConverter::replaceSelector(ASTNode* math, bool &adjusted, const
         if (calc < n)
         {
           ASTNode* value = (ASTNode*)(child0->getChild(calc));
-          double calc = SBMLTransforms::evaluateASTNode(value, mValues);
+          double calc = evaluateMath(value, false);
           newAST = new ASTNode(AST_REAL);
           newAST->setValue(calc);
         }
@@ -966,7 +1376,7 @@ ArraysFlatteningConverter::removeDimensionFromModelValues()
 bool
 ArraysFlatteningConverter::isPopulatedValueMap()
 {
-  return (getValueMap().size() != 0);
+  return !mValues.empty();
 }
 
 SBMLTransforms::IdValueMap 
@@ -54,6 +54,10 @@
 
 #ifdef __cplusplus
 
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
 
 LIBSBML_CPP_NAMESPACE_BEGIN
 
@@ -247,9 +251,20 @@ private:
 
   bool expandVariableElement(const SBase* element, bool notMath);
 
-  bool expandVariable(const SBase* element, bool notMath);
+  bool expandVariable(const SBase* element, bool notMath, 
+                      const SBase* prototype = NULL);
 
-  bool expandNonDimensionedVariable(SBase* element);
+  SBase* createPrototype(const SBase* element);
+
+  bool addNewElement(const SBase* element, SBase* parent, 
+                     const std::string& elementName, SBase* newElement);
+
+  std::set<std::string>& getKeys(const ListOf* list);
+
+  void forgetKey(const SBase* element);
+
+  bool expandNonDimensionedVariable(SBase* element, 
+                                    const ArraysSBasePlugin* plugin);
 
   bool dealWithMathChild(SBase* element);
 
@@ -263,7 +278,9 @@ private:
 
   bool adjustIdentifiers(SBase* newElement);
 
-  bool adjustReferencedAttribute(SBase* newElement, bool calcIndex=true);
+  bool adjustReferencedAttribute(SBase* newElement, 
+                                 const ArraysSBasePlugin* plugin, 
+                                 bool calcIndex=true);
 
   unsigned int getNumElements(const Dimension* dim);
 
@@ -278,18 +295,53 @@ private:
 
   bool getArraySize(const SBase* element);
 
-  void updateArrayEntry(unsigned int index);
+  void setArrayEntry(unsigned int entry);
+
+  // an operation of index math compiled to postfix: a constant (AST_REAL),
+  // the value of a dimension (AST_NAME) or an operator applied to the
+  // given number of operands
+  struct IndexOperation
+  {
+    ASTNodeType_t type;
+    unsigned int  operand;
+    double        value;
+  };
+
+  typedef std::vector<IndexOperation> IndexProgram;
+
+  double evaluateMath(const ASTNode* math, bool indexMath);
+
+  bool compileMath(const ASTNode* math, IndexProgram& program);
+
+  double runProgram(const IndexProgram& program);
 
   std::vector<unsigned int> mArraySize;
   unsigned int mNoDimensions;
   unsigned int mCurrentDimension;
   std::vector<unsigned int> mArrayEntry;
 
+  // the number of entries that one step in each dimension spans
+  std::vector<unsigned int> mArrayStride;
+
+  // while the entries of an element are copied from a prototype without
+  // arrays plugins, the plugins of the descendants of the element, in the
+  // order in which getAllElements() lists them, and its index math compiled
+  bool mFromPrototype;
+  std::vector<const ArraysSBasePlugin*> mChildPlugins;
+  std::map<const ASTNode*, IndexProgram> mIndexPrograms;
+
+  IndexProgram mProgram;
+  std::vector<double> mStack;
+
   IdList mDimensionIndex;
 
   SBMLTransforms::IdValueMap mValues;
   unsigned int mValuesSize;
 
+  // the keys of the elements in each list of the model that elements have
+  // been added to
+  std::map<const ListOf*, std::set<std::string> > mKeys;
+
   bool isPopulatedValueMap();
 
   SBMLTransforms::IdValueMap getValueMap();
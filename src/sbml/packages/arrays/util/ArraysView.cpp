@@ -0,0 +1,572 @@
+/**
+ * @file    ArraysView.cpp
+ * @brief   Implementation of ArraysView and ArraysEntry, which give access
+ *          to single entries of arrays without flattening the model.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ */
+
+
+#include <sbml/packages/arrays/util/ArraysView.h>
+#include <sbml/packages/arrays/common/ArraysExtensionTypes.h>
+#include <sbml/math/ASTNode.h>
+#include <sbml/util/util.h>
+#include <sbml/Model.h>
+
+#ifdef __cplusplus
+
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+/** @cond doxygenLibsbmlInternal */
+
+/*
+ * Returns the id with the indices appended, as the flattening converter
+ * names the entries of an array.
+ */
+static string
+appendIndices(const string& id, const vector<unsigned int>& indices)
+{
+  string newId;
+  newId.reserve(id.size() + 8 * indices.size());
+  newId += id;
+
+  char number[16];
+  for (vector<unsigned int>::const_iterator it = indices.begin();
+                                            it != indices.end(); ++it)
+  {
+    sprintf(number, "_%u", *it);
+    newId += number;
+  }
+  return newId;
+}
+
+
+static const ArraysSBasePlugin*
+getArraysPlugin(const SBase* element)
+{
+  return static_cast<const ArraysSBasePlugin*>(element->getPlugin("arrays"));
+}
+
+/** @endcond */
+
+
+ArraysEntry::ArraysEntry()
+  : mElement(NULL)
+  , mIndices()
+  , mId()
+  , mMetaId()
+  , mReferences()
+  , mMath(NULL)
+{
+}
+
+
+ArraysEntry::ArraysEntry(const ArraysEntry& orig)
+  : mElement(orig.mElement)
+  , mIndices(orig.mIndices)
+  , mId(orig.mId)
+  , mMetaId(orig.mMetaId)
+  , mReferences(orig.mReferences)
+  , mMath(NULL)
+{
+  if (orig.mMath != NULL)
+  {
+    mMath = orig.mMath->deepCopy();
+  }
+}
+
+
+ArraysEntry&
+ArraysEntry::operator=(const ArraysEntry& rhs)
+{
+  if (&rhs != this)
+  {
+    mElement = rhs.mElement;
+    mIndices = rhs.mIndices;
+    mId = rhs.mId;
+    mMetaId = rhs.mMetaId;
+    mReferences = rhs.mReferences;
+
+    delete mMath;
+    mMath = NULL;
+    if (rhs.mMath != NULL)
+    {
+      mMath = rhs.mMath->deepCopy();
+    }
+  }
+  return *this;
+}
+
+
+ArraysEntry::~ArraysEntry()
+{
+  delete mMath;
+}
+
+
+bool
+ArraysEntry::isValid() const
+{
+  return mElement != NULL;
+}
+
+
+const SBase*
+ArraysEntry::getElement() const
+{
+  return mElement;
+}
+
+
+const std::vector<unsigned int>&
+ArraysEntry::getIndices() const
+{
+  return mIndices;
+}
+
+
+const std::string&
+ArraysEntry::getId() const
+{
+  return mId;
+}
+
+
+const std::string&
+ArraysEntry::getMetaId() const
+{
+  return mMetaId;
+}
+
+
+std::string
+ArraysEntry::getAttribute(const std::string& attributeName) const
+{
+  std::string value;
+  std::map<std::string, std::string>::const_iterator it =
+    mReferences.find(attributeName);
+  if (it != mReferences.end())
+  {
+    value = it->second;
+  }
+  else if (attributeName == "id")
+  {
+    value = mId;
+  }
+  else if (attributeName == "metaid")
+  {
+    value = mMetaId;
+  }
+  else if (mElement != NULL)
+  {
+    mElement->getAttribute(attributeName, value);
+  }
+  return value;
+}
+
+
+const ASTNode*
+ArraysEntry::getMath() const
+{
+  return mMath;
+}
+
+
+ArraysView::ArraysView(const Model* model)
+  : mModel(model)
+  , mValues()
+  , mBound()
+{
+  if (mModel != NULL)
+  {
+    SBMLTransforms::getComponentValuesForModel(mModel, mValues);
+  }
+}
+
+
+ArraysView::~ArraysView()
+{
+}
+
+
+const Model*
+ArraysView::getModel() const
+{
+  return mModel;
+}
+
+
+const SBase*
+ArraysView::getDimensionedElement(const SBase* element) const
+{
+  while (element != NULL && element->getTypeCode() != SBML_MODEL)
+  {
+    const ArraysSBasePlugin* plugin = getArraysPlugin(element);
+    if (plugin != NULL && plugin->getNumDimensions() > 0)
+    {
+      return element;
+    }
+    element = element->getParentSBMLObject();
+  }
+  return NULL;
+}
+
+
+std::vector<unsigned int>
+ArraysView::getArraySize(const SBase* element) const
+{
+  std::vector<unsigned int> sizes;
+  const SBase* dimensioned = getDimensionedElement(element);
+  if (dimensioned == NULL)
+  {
+    return sizes;
+  }
+
+  const ArraysSBasePlugin* plugin = getArraysPlugin(dimensioned);
+  for (unsigned int i = plugin->getNumDimensions(); i > 0; i--)
+  {
+    unsigned int size = 0;
+    const Dimension* dim = plugin->getDimensionByArrayDimension(i - 1);
+    if (dim != NULL && dim->isSetSize())
+    {
+      SBMLTransforms::IdValueMap::const_iterator it =
+        mValues.find(dim->getSize());
+      if (it != mValues.end() && it->second.first >= 0)
+      {
+        size = (unsigned int)(it->second.first);
+      }
+    }
+    sizes.push_back(size);
+  }
+  return sizes;
+}
+
+
+unsigned int
+ArraysView::getNumEntries(const SBase* element) const
+{
+  std::vector<unsigned int> sizes = getArraySize(element);
+  unsigned int numEntries = 1;
+  for (size_t i = 0; i < sizes.size(); ++i)
+  {
+    numEntries *= sizes[i];
+  }
+  return numEntries;
+}
+
+
+ArraysEntry
+ArraysView::getEntry(const SBase* element,
+                     const std::vector<unsigned int>& indices)
+{
+  ArraysEntry entry;
+  if (element == NULL || mModel == NULL)
+  {
+    return entry;
+  }
+
+  std::vector<unsigned int> sizes = getArraySize(element);
+  if (sizes.size() != indices.size())
+  {
+    return entry;
+  }
+  for (size_t i = 0; i < sizes.size(); ++i)
+  {
+    if (indices[i] >= sizes[i])
+    {
+      return entry;
+    }
+  }
+
+  entry.mElement = element;
+  entry.mIndices = indices;
+
+  bindDimensions(getDimensionedElement(element), indices);
+
+  if (element->isSetIdAttribute())
+  {
+    entry.mId = appendIndices(element->getIdAttribute(), indices);
+  }
+  if (element->isSetMetaId())
+  {
+    entry.mMetaId = appendIndices(element->getMetaId(), indices);
+  }
+
+  resolveReferences(element, entry);
+
+  if (element->getMath() != NULL)
+  {
+    entry.mMath = resolveMath(element->getMath());
+  }
+
+  unbindDimensions();
+
+  return entry;
+}
+
+
+ArraysEntry
+ArraysView::getEntry(const SBase* element, unsigned int index)
+{
+  return getEntry(element, std::vector<unsigned int>(1, index));
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+
+/*
+ * Gives each Dimension id of the element the value of its index.
+ */
+void
+ArraysView::bindDimensions(const SBase* dimensioned,
+                           const std::vector<unsigned int>& indices)
+{
+  if (dimensioned == NULL)
+  {
+    return;
+  }
+
+  const ArraysSBasePlugin* plugin = getArraysPlugin(dimensioned);
+  unsigned int numDimensions = (unsigned int)(indices.size());
+  for (unsigned int i = 0; i < numDimensions; i++)
+  {
+    const Dimension* dim = plugin->getDimensionByArrayDimension(i);
+    if (dim == NULL || !dim->isSetId())
+    {
+      continue;
+    }
+
+    SBMLTransforms::ValueSet v =
+      make_pair((double)(indices[numDimensions - 1 - i]), true);
+    if (mValues.insert(make_pair(dim->getId(), v)).second)
+    {
+      mBound.push_back(dim->getId());
+    }
+  }
+}
+
+
+void
+ArraysView::unbindDimensions()
+{
+  for (size_t i = 0; i < mBound.size(); ++i)
+  {
+    mValues.erase(mBound[i]);
+  }
+  mBound.clear();
+}
+
+
+/*
+ * Evaluates math that selects an entry; returns false unless it gives a
+ * non-negative number.
+ */
+bool
+ArraysView::evaluateIndex(const ASTNode* math, unsigned int& value) const
+{
+  if (math == NULL)
+  {
+    return false;
+  }
+
+  double calc = SBMLTransforms::evaluateASTNode(math, mValues, mModel);
+  if (util_isNaN(calc) || util_isInf(calc) || calc < 0)
+  {
+    return false;
+  }
+
+  value = (unsigned int)(calc);
+  return true;
+}
+
+
+/*
+ * Sets the attributes that Index objects of the element refer to the
+ * entries they select, the index of the highest arrayDimension first.
+ */
+void
+ArraysView::resolveReferences(const SBase* element, ArraysEntry& entry) const
+{
+  const ArraysSBasePlugin* plugin = getArraysPlugin(element);
+  if (plugin == NULL || plugin->getNumIndices() == 0)
+  {
+    return;
+  }
+
+  std::map<std::string, std::vector<std::pair<unsigned int, unsigned int> > >
+    selected;
+  for (unsigned int n = 0; n < plugin->getNumIndices(); ++n)
+  {
+    const Index* index = plugin->getIndex(n);
+    unsigned int value = 0;
+    if (!index->isSetReferencedAttribute() || !index->isSetArrayDimension()
+      || !evaluateIndex(index->getMath(), value))
+    {
+      continue;
+    }
+
+    selected[index->getReferencedAttribute()].push_back(
+      make_pair(index->getArrayDimension(), value));
+  }
+
+  std::map<std::string, std::vector<std::pair<unsigned int,
+    unsigned int> > >::iterator it;
+  for (it = selected.begin(); it != selected.end(); ++it)
+  {
+    std::vector<std::pair<unsigned int, unsigned int> >& values = it->second;
+    std::sort(values.rbegin(), values.rend());
+
+    std::vector<unsigned int> indices;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      indices.push_back(values[i].second);
+    }
+
+    std::string id;
+    element->getAttribute(it->first, id);
+    entry.mReferences[it->first] = appendIndices(id, indices);
+  }
+}
+
+
+/*
+ * Returns a copy of the math with its selectors and Dimension ids
+ * resolved.  The copy is walked with an explicit stack.
+ */
+ASTNode*
+ArraysView::resolveMath(const ASTNode* math) const
+{
+  ASTNode* root = math->deepCopy();
+  ASTNode* resolved = NULL;
+  while ((resolved = createResolved(root)) != NULL)
+  {
+    delete root;
+    root = resolved;
+  }
+
+  std::vector<ASTNode*> stack;
+  stack.push_back(root);
+  while (!stack.empty())
+  {
+    ASTNode* node = stack.back();
+    stack.pop_back();
+
+    for (unsigned int i = 0; i < node->getNumChildren(); ++i)
+    {
+      ASTNode* child = node->getChild(i);
+      while ((resolved = createResolved(child)) != NULL)
+      {
+        node->replaceChild(i, resolved, true);
+        child = resolved;
+      }
+      stack.push_back(child);
+    }
+  }
+
+  return root;
+}
+
+
+/*
+ * Returns what the node resolves to: the value of a Dimension id, the name
+ * of the entry a selector of a name selects, or a copy of the component a
+ * selector of a vector selects.  Returns NULL if the node stays as it is.
+ */
+ASTNode*
+ArraysView::createResolved(const ASTNode* node) const
+{
+  ASTNodeType_t type = node->getType();
+  if (type == AST_NAME)
+  {
+    if (std::find(mBound.begin(), mBound.end(), node->getName())
+      == mBound.end())
+    {
+      return NULL;
+    }
+
+    ASTNode* value = new ASTNode(AST_INTEGER);
+    value->setValue((long)(mValues.find(node->getName())->second.first));
+    return value;
+  }
+
+  if (type != AST_LINEAR_ALGEBRA_SELECTOR || node->getNumChildren() < 2)
+  {
+    return NULL;
+  }
+
+  std::vector<unsigned int> indices;
+  for (unsigned int i = 1; i < node->getNumChildren(); ++i)
+  {
+    unsigned int value = 0;
+    if (!evaluateIndex(node->getChild(i), value))
+    {
+      return NULL;
+    }
+    indices.push_back(value);
+  }
+
+  // a selector of a selector, as in a[x][y], selects from what the inner
+  // one selects
+  const ASTNode* selected = node->getChild(0);
+  ASTNode* inner = NULL;
+  if (selected->getType() == AST_LINEAR_ALGEBRA_SELECTOR)
+  {
+    inner = createResolved(selected);
+    if (inner == NULL)
+    {
+      return NULL;
+    }
+    selected = inner;
+  }
+
+  ASTNode* resolved = NULL;
+  if (selected->getType() == AST_NAME)
+  {
+    resolved = new ASTNode(AST_NAME);
+    resolved->setName(appendIndices(selected->getName(), indices).c_str());
+  }
+  else
+  {
+    size_t i = 0;
+    while (i < indices.size()
+      && selected->getType() == AST_LINEAR_ALGEBRA_VECTOR
+      && indices[i] < selected->getNumChildren())
+    {
+      selected = selected->getChild(indices[i]);
+      ++i;
+    }
+    if (i == indices.size())
+    {
+      resolved = selected->deepCopy();
+    }
+  }
+
+  delete inner;
+  return resolved;
+}
+
+/** @endcond */
+
+
+LIBSBML_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
@@ -0,0 +1,334 @@
+/**
+ * @file    ArraysView.h
+ * @brief   Definition of ArraysView and ArraysEntry, which give access to
+ *          single entries of arrays without flattening the model.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class ArraysView
+ * @sbmlbrief{arrays} Looks up single entries of arrays.
+ *
+ * @htmlinclude libsbml-facility-only-warning.html
+ *
+ * An ArraysView answers questions such as "what is the kinetic law of
+ * reaction <code>r[5]</code>" about a model that uses the arrays package,
+ * without flattening it.  Where the ArraysFlatteningConverter creates a
+ * copy of every element for every entry of its array, getEntry() returns
+ * an ArraysEntry for one entry only, in time that does not depend on the
+ * size of the array.
+ *
+ * The element asked about is either an element with dimensions, such as
+ * the reaction <code>r</code>, or an element within one, such as its
+ * kinetic law or one of its species references.  Its entry is given by
+ * one index per dimension, in the order of a selector: the first index is
+ * that into the highest arrayDimension and the last that into
+ * arrayDimension&nbsp;0.  For the entry, each Dimension id has the value
+ * of its index, and:
+ *
+ * @li the id and metaid of the element have the indices appended, as in
+ * <code>r_5</code>;
+ * @li an attribute that is the referencedAttribute of an Index of the
+ * element names the entry of the array it refers to, as in
+ * <code>A_5</code>;
+ * @li in the math, each selector of an array name is replaced by the name
+ * of the entry it selects, each selector of a vector by the component it
+ * selects, and each Dimension id by the value of its index.
+ *
+ * The ids are those the ArraysFlatteningConverter gives the elements it
+ * creates.  Sizes and indices are calculated with the values the
+ * parameters, compartments and species of the model have when the view
+ * is created.
+ */
+
+
+#ifndef ArraysView_h
+#define ArraysView_h
+
+#include <sbml/common/extern.h>
+#include <sbml/SBMLTransforms.h>
+
+#ifdef __cplusplus
+
+#include <map>
+#include <string>
+#include <vector>
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+class ASTNode;
+class Model;
+class SBase;
+
+
+/**
+ * @class ArraysEntry
+ * @sbmlbrief{arrays} One entry of an array, as returned by an ArraysView.
+ *
+ * An ArraysEntry holds the element it is an entry of, its indices, and the
+ * ids, attributes and math resolved for these indices.  It is a copy:
+ * changing the model afterwards does not change it.
+ */
+class LIBSBML_EXTERN ArraysEntry
+{
+public:
+
+  /**
+   * Creates a new ArraysEntry that is not valid.
+   */
+  ArraysEntry();
+
+
+  /**
+   * Copy constructor; creates a copy of an ArraysEntry.
+   *
+   * @param orig the ArraysEntry instance to copy.
+   */
+  ArraysEntry(const ArraysEntry& orig);
+
+
+  /**
+   * Assignment operator for ArraysEntry.
+   *
+   * @param rhs the object whose values are used as the basis of the
+   * assignment.
+   */
+  ArraysEntry& operator=(const ArraysEntry& rhs);
+
+
+  /**
+   * Destroys this ArraysEntry.
+   */
+  virtual ~ArraysEntry();
+
+
+  /**
+   * Returns whether this ArraysEntry is an entry of an element.
+   *
+   * @return @c true if the element and indices it was asked for exist,
+   * @c false otherwise.
+   */
+  bool isValid() const;
+
+
+  /**
+   * Returns the element this ArraysEntry is an entry of.
+   *
+   * @return the element, or @c NULL if this ArraysEntry is not valid.
+   */
+  const SBase* getElement() const;
+
+
+  /**
+   * Returns the indices of this ArraysEntry.
+   *
+   * @return the indices, the first into the highest arrayDimension.
+   */
+  const std::vector<unsigned int>& getIndices() const;
+
+
+  /**
+   * Returns the id of this ArraysEntry.
+   *
+   * @return the id of the element with the indices appended, or an empty
+   * string if the element has no id.
+   */
+  const std::string& getId() const;
+
+
+  /**
+   * Returns the metaid of this ArraysEntry.
+   *
+   * @return the metaid of the element with the indices appended, or an
+   * empty string if the element has no metaid.
+   */
+  const std::string& getMetaId() const;
+
+
+  /**
+   * Returns the value of an attribute of this ArraysEntry.
+   *
+   * @param attributeName the name of the attribute.
+   *
+   * @return the id of the entry referred to if the attribute is the
+   * referencedAttribute of an Index of the element, the id or metaid of
+   * this entry for "id" and "metaid", or else the value of the attribute
+   * of the element; an empty string if the element has no such attribute.
+   */
+  std::string getAttribute(const std::string& attributeName) const;
+
+
+  /**
+   * Returns the math of this ArraysEntry.
+   *
+   * A selector whose indices do not evaluate to an entry of what they
+   * select is left in place.
+   *
+   * @return the math of the element with its selectors and Dimension ids
+   * resolved, or @c NULL if the element has no math.
+   */
+  const ASTNode* getMath() const;
+
+
+protected:
+  /** @cond doxygenLibsbmlInternal */
+
+  friend class ArraysView;
+
+  const SBase* mElement;
+  std::vector<unsigned int> mIndices;
+
+  std::string mId;
+  std::string mMetaId;
+
+  // the resolved values of the referenced attributes
+  std::map<std::string, std::string> mReferences;
+
+  ASTNode* mMath;
+
+  /** @endcond */
+};
+
+
+class LIBSBML_EXTERN ArraysView
+{
+public:
+
+  /**
+   * Creates a new ArraysView of the given Model.
+   *
+   * @param model the Model to look up entries in.
+   */
+  ArraysView(const Model* model);
+
+
+  /**
+   * Destroys this ArraysView.
+   */
+  virtual ~ArraysView();
+
+
+  /**
+   * Returns the Model this ArraysView looks up entries in.
+   *
+   * @return the Model.
+   */
+  const Model* getModel() const;
+
+
+  /**
+   * Returns the element whose dimensions give the entries of an element.
+   *
+   * @param element the element to look up.
+   *
+   * @return @p element if it has dimensions, or else its closest ancestor
+   * with dimensions; @c NULL if there is none.
+   */
+  const SBase* getDimensionedElement(const SBase* element) const;
+
+
+  /**
+   * Returns the size of each dimension of an element.
+   *
+   * @param element the element to look up.
+   *
+   * @return the sizes, the first that of the highest arrayDimension; empty
+   * if the element is not within an array.
+   */
+  std::vector<unsigned int> getArraySize(const SBase* element) const;
+
+
+  /**
+   * Returns the number of entries of an element.
+   *
+   * @param element the element to look up.
+   *
+   * @return the product of the sizes of its dimensions, or 1 if the
+   * element is not within an array.
+   */
+  unsigned int getNumEntries(const SBase* element) const;
+
+
+  /**
+   * Returns an entry of an element.
+   *
+   * @param element the element, or an element within the element, with
+   * dimensions.
+   * @param indices the index into each dimension, the first into the
+   * highest arrayDimension; empty if the element is not within an array.
+   *
+   * @return the entry, which is not valid if there is no element or the
+   * indices are not those of an entry.
+   */
+  ArraysEntry getEntry(const SBase* element,
+                       const std::vector<unsigned int>& indices);
+
+
+  /**
+   * Returns an entry of an element with a single dimension.
+   *
+   * @param element the element, or an element within the element, with
+   * dimensions.
+   * @param index the index into the dimension.
+   *
+   * @return the entry, which is not valid if there is no element or the
+   * index is not that of an entry.
+   */
+  ArraysEntry getEntry(const SBase* element, unsigned int index);
+
+
+protected:
+  /** @cond doxygenLibsbmlInternal */
+
+  void bindDimensions(const SBase* dimensioned,
+                      const std::vector<unsigned int>& indices);
+
+  void unbindDimensions();
+
+  bool evaluateIndex(const ASTNode* math, unsigned int& value) const;
+
+  void resolveReferences(const SBase* element, ArraysEntry& entry) const;
+
+  ASTNode* resolveMath(const ASTNode* math) const;
+
+  ASTNode* createResolved(const ASTNode* node) const;
+
+  const Model* mModel;
+
+  // the values of the model, and those of the dimension ids while an
+  // entry is being resolved
+  SBMLTransforms::IdValueMap mValues;
+
+  std::vector<std::string> mBound;
+
+  /** @endcond */
+
+private:
+  /** @cond doxygenLibsbmlInternal */
+
+  ArraysView(const ArraysView&);
+  ArraysView& operator=(const ArraysView&);
+
+  /** @endcond */
+};
+
+
+LIBSBML_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+#endif  /* ArraysView_h */
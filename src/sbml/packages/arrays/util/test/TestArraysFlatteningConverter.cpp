@@ -793,6 +793,136 @@ START_TEST(test_arrays_flattening_converter_reaction_sr_noRefAtt)
 END_TEST
 
 
+START_TEST(test_arrays_flattening_converter_1D_reaction_large)
+{
+  string filename(TestDataDirectory);
+
+  ConversionProperties props;
+
+  props.addOption("flatten arrays");
+
+  SBMLConverter* converter = SBMLConverterRegistry::getInstance().getConverterFor(props);
+
+  // load document and make the arrays 1000 entries long
+  string cfile = filename + "arrays_1D_reaction.xml";
+  SBMLDocument* doc = readSBMLFromFile(cfile.c_str());
+  fail_unless(doc->getModel() != NULL);
+  doc->getModel()->getParameter("n")->setValue(1000);
+
+  converter->setDocument(doc);
+  int result = converter->convert();
+
+  fail_unless(result == LIBSBML_OPERATION_SUCCESS);
+
+  Model* model = doc->getModel();
+  fail_unless(model->getNumCompartments() == 1000);
+  fail_unless(model->getNumSpecies() == 3000);
+  fail_unless(model->getNumReactions() == 1000);
+  fail_unless(model->getSpecies(999)->getId() == "A_999");
+  fail_unless(model->getSpecies(1000)->getId() == "B_0");
+
+  Reaction* r = model->getReaction(999);
+  fail_unless(r->getId() == "r_999");
+  fail_unless(r->getCompartment() == "Cell_999");
+  fail_unless(r->getReactant(1)->getSpecies() == "B_999");
+  fail_unless(r->getProduct(0)->getSpecies() == "C_999");
+
+  char* formula = SBML_formulaToL3String(r->getKineticLaw()->getMath());
+  fail_unless(!strcmp(formula, "k * A_999 * B_999"));
+  safe_free(formula);
+
+  delete doc;
+  delete converter;
+}
+END_TEST
+
+
+START_TEST(test_arrays_flattening_converter_1D_reaction_index_math)
+{
+  string filename(TestDataDirectory);
+
+  ConversionProperties props;
+
+  props.addOption("flatten arrays");
+
+  SBMLConverter* converter = SBMLConverterRegistry::getInstance().getConverterFor(props);
+
+  // species A is indexed by math that is compiled and species B by math
+  // that is left to evaluateASTNode()
+  string cfile = filename + "arrays_1D_reaction.xml";
+  SBMLDocument* doc = readSBMLFromFile(cfile.c_str());
+  fail_unless(doc->getModel() != NULL);
+  doc->getModel()->getParameter("n")->setValue(4);
+
+  Reaction* r = doc->getModel()->getReaction(0);
+  const char* formulas[] = { "floor(d0 / 2)", "piecewise(d0 - 1, d0 > 0, 0)" };
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    ArraysSBasePlugin* plugin = 
+      static_cast<ArraysSBasePlugin*>(r->getReactant(i)->getPlugin("arrays"));
+    ASTNode* math = SBML_parseL3Formula(formulas[i]);
+    plugin->getIndexByArrayDimension(0)->setMath(math);
+    delete math;
+  }
+
+  converter->setDocument(doc);
+  int result = converter->convert();
+
+  fail_unless(result == LIBSBML_OPERATION_SUCCESS);
+
+  Model* model = doc->getModel();
+  fail_unless(model->getNumReactions() == 4);
+
+  r = model->getReaction(0);
+  fail_unless(r->getReactant(0)->getSpecies() == "A_0");
+  fail_unless(r->getReactant(1)->getSpecies() == "B_0");
+  fail_unless(r->getProduct(0)->getSpecies() == "C_0");
+
+  r = model->getReaction(3);
+  fail_unless(r->getId() == "r_3");
+  fail_unless(r->getCompartment() == "Cell_3");
+  fail_unless(r->getReactant(0)->getSpecies() == "A_1");
+  fail_unless(r->getReactant(1)->getSpecies() == "B_2");
+  fail_unless(r->getProduct(0)->getSpecies() == "C_3");
+
+  delete doc;
+  delete converter;
+}
+END_TEST
+
+
+START_TEST(test_arrays_flattening_converter_duplicate_id)
+{
+  string filename(TestDataDirectory);
+
+  ConversionProperties props;
+
+  props.addOption("flatten arrays");
+
+  SBMLConverter* converter = SBMLConverterRegistry::getInstance().getConverterFor(props);
+
+  // an entry of the array of species B would take the id of this one
+  string cfile = filename + "arrays_1D_reaction.xml";
+  SBMLDocument* doc = readSBMLFromFile(cfile.c_str());
+  fail_unless(doc->getModel() != NULL);
+  Species* s = doc->getModel()->createSpecies();
+  s->setId("B_1");
+  s->setCompartment("Cell");
+  s->setHasOnlySubstanceUnits(false);
+  s->setBoundaryCondition(false);
+  s->setConstant(false);
+
+  converter->setDocument(doc);
+  int result = converter->convert();
+
+  fail_unless(result == LIBSBML_OPERATION_FAILED);
+
+  delete doc;
+  delete converter;
+}
+END_TEST
+
+
 Suite *
 create_suite_TestFlatteningConverter (void)
 { 
@@ -819,6 +949,9 @@ create_suite_TestFlatteningConverter (void)
   tcase_add_test(tcase, test_arrays_flattening_converter_1D_event);
   tcase_add_test(tcase, test_arrays_flattening_converter_2D_species_compartment_from_file);
   tcase_add_test(tcase, test_arrays_flattening_converter_reaction_sr_noRefAtt);
+  tcase_add_test(tcase, test_arrays_flattening_converter_1D_reaction_large);
+  tcase_add_test(tcase, test_arrays_flattening_converter_1D_reaction_index_math);
+  tcase_add_test(tcase, test_arrays_flattening_converter_duplicate_id);
 
   suite_add_tcase(suite, tcase);
 
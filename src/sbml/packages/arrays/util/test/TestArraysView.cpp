@@ -0,0 +1,204 @@
+/**
+ * \file    TestArraysView.cpp
+ * \brief   Implementation of the Tests for the ArraysView
+ * \author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sbml/common/common.h>
+
+#include <sbml/packages/arrays/common/ArraysExtensionTypes.h>
+#include <sbml/packages/arrays/util/ArraysView.h>
+
+#include <sbml/SBMLReader.h>
+#include <sbml/SBMLTypes.h>
+
+#include <string>
+#include <vector>
+
+#include <check.h>
+
+using namespace std;
+
+LIBSBML_CPP_NAMESPACE_USE
+
+BEGIN_C_DECLS
+
+
+extern char *TestDataDirectory;
+
+
+static string
+getFormula(const ArraysEntry& entry)
+{
+  string formula;
+  char* text = SBML_formulaToL3String(entry.getMath());
+  if (text != NULL)
+  {
+    formula = text;
+    safe_free(text);
+  }
+  return formula;
+}
+
+
+START_TEST(test_arrays_view_1D_reaction)
+{
+  string filename(TestDataDirectory);
+  string cfile = filename + "arrays_1D_reaction.xml";
+  SBMLDocument* doc = readSBMLFromFile(cfile.c_str());
+  Model* model = doc->getModel();
+  fail_unless(model != NULL);
+
+  // an array far too long to be flattened
+  model->getParameter("n")->setValue(5000000);
+
+  ArraysView view(model);
+  fail_unless(view.getModel() == model);
+
+  Reaction* r = model->getReaction(0);
+  fail_unless(view.getNumEntries(r) == 5000000);
+  fail_unless(view.getDimensionedElement(r->getKineticLaw()) == r);
+  fail_unless(view.getDimensionedElement(model->getParameter("k")) == NULL);
+
+  ArraysEntry entry = view.getEntry(r, 4999999);
+  fail_unless(entry.isValid());
+  fail_unless(entry.getElement() == r);
+  fail_unless(entry.getId() == "r_4999999");
+  fail_unless(entry.getMetaId() == "iBioSim5_4999999");
+  fail_unless(entry.getAttribute("compartment") == "Cell_4999999");
+  fail_unless(entry.getMath() == NULL);
+
+  entry = view.getEntry(r->getKineticLaw(), 1234567);
+  fail_unless(entry.isValid());
+  fail_unless(getFormula(entry) == "k * A_1234567 * B_1234567");
+  fail_unless(getFormula(ArraysEntry(entry)) == "k * A_1234567 * B_1234567");
+
+  entry = view.getEntry(r->getReactant(1), 7);
+  fail_unless(entry.getAttribute("species") == "B_7");
+  entry = view.getEntry(r->getProduct(0), 7);
+  fail_unless(entry.getAttribute("species") == "C_7");
+
+  // the model is left as it is
+  fail_unless(r->getId() == "r");
+  fail_unless(r->getReactant(1)->getSpecies() == "B");
+  fail_unless(model->getNumReactions() == 1);
+
+  fail_unless(view.getEntry(r, 5000000).isValid() == false);
+  fail_unless(view.getEntry(r, vector<unsigned int>()).isValid() == false);
+  fail_unless(view.getEntry(NULL, 0).isValid() == false);
+
+  delete doc;
+}
+END_TEST
+
+
+START_TEST(test_arrays_view_2D)
+{
+  string filename(TestDataDirectory);
+  string cfile = filename + "arrays_2D_species_compartment.xml";
+  SBMLDocument* doc = readSBMLFromFile(cfile.c_str());
+  Model* model = doc->getModel();
+  fail_unless(model != NULL);
+  model->getParameter("m")->setValue(3);
+
+  ArraysView view(model);
+  Species* s = model->getSpecies(0);
+
+  vector<unsigned int> sizes = view.getArraySize(s);
+  fail_unless(sizes.size() == 2);
+  fail_unless(sizes[0] == 3);
+  fail_unless(sizes[1] == 2);
+  fail_unless(view.getNumEntries(s) == 6);
+
+  // the same ids as the flattening converter gives
+  vector<unsigned int> indices;
+  indices.push_back(2);
+  indices.push_back(1);
+  ArraysEntry entry = view.getEntry(s, indices);
+  fail_unless(entry.isValid());
+  fail_unless(entry.getIndices() == indices);
+  fail_unless(entry.getId() == "A_2_1");
+  fail_unless(entry.getAttribute("compartment") == "Cell_1_2");
+
+  indices[1] = 2;
+  fail_unless(view.getEntry(s, indices).isValid() == false);
+
+  delete doc;
+}
+END_TEST
+
+
+START_TEST(test_arrays_view_math)
+{
+  string filename(TestDataDirectory);
+  string cfile = filename + "arrays_1D_reverse.xml";
+  SBMLDocument* doc = readSBMLFromFile(cfile.c_str());
+  Model* model = doc->getModel();
+  fail_unless(model != NULL);
+
+  ArraysView view(model);
+  Rule* rule = model->getRule(0);
+
+  // Y[n - 1 - d0] := X[d0]
+  ArraysEntry entry = view.getEntry(rule, 2);
+  fail_unless(entry.getAttribute("variable") == "Y_7");
+  fail_unless(entry.getMetaId() == "rule0_2");
+  fail_unless(getFormula(entry) == "X_2");
+
+  // an element that is not within an array has a single entry
+  Parameter* n = model->getParameter("n");
+  fail_unless(view.getNumEntries(n) == 1);
+  entry = view.getEntry(n, vector<unsigned int>());
+  fail_unless(entry.isValid());
+  fail_unless(entry.getId() == "n");
+
+  // selectors of vectors and of selectors, and dimension ids
+  ASTNode* math = SBML_parseL3Formula(
+    "{1, d0 * 2, X[d0 + 1]}[d0] + Z[d0][n - d0] + d0 + Q[d0 - 5]");
+  rule->setMath(math);
+  delete math;
+
+  entry = view.getEntry(rule, 0);
+  fail_unless(getFormula(entry) == "1 + Z_0_10 + 0 + Q[0 - 5]");
+  entry = view.getEntry(rule, 1);
+  fail_unless(getFormula(entry) == "1 * 2 + Z_1_9 + 1 + Q[1 - 5]");
+  entry = view.getEntry(rule, 2);
+  fail_unless(getFormula(entry) == "X_3 + Z_2_8 + 2 + Q[2 - 5]");
+
+  delete doc;
+}
+END_TEST
+
+
+Suite *
+create_suite_TestArraysView (void)
+{
+  Suite *suite = suite_create("ArraysView");
+  TCase *tcase = tcase_create("ArraysView");
+
+  tcase_add_test(tcase, test_arrays_view_1D_reaction);
+  tcase_add_test(tcase, test_arrays_view_2D);
+  tcase_add_test(tcase, test_arrays_view_math);
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+END_C_DECLS
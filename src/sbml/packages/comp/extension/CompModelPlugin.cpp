@@ -38,6 +38,7 @@
 #include <iostream>
 #include <vector>
 #include <set>
+#include <map>
 
 #include <sbml/common/libsbml-version.h>
 #include <sbml/packages/comp/common/compfwd.h>
@@ -66,6 +67,10 @@ CompModelPlugin::CompModelPlugin (const std::string &uri, const std::string &pre
   , mDivider("__")
   , mRemoved()
   , mTransformer(NULL)
+  , mUseReferenceIndex(false)
+  , mReferenceIndexBuilt(false)
+  , mDeferIdRefRenames(false)
+  , mInstantiateSubmodelsIndependently(false)
 {
   connectToChild();
 }
@@ -78,6 +83,10 @@ CompModelPlugin::CompModelPlugin(const CompModelPlugin& orig)
   , mDivider("__")
   , mRemoved() //If we're making a copy, the list of things we've removed is new.
   , mTransformer(orig.mTransformer)
+  , mUseReferenceIndex(false) //The index is only valid for the original.
+  , mReferenceIndexBuilt(false)
+  , mDeferIdRefRenames(false) //So are the pending renames.
+  , mInstantiateSubmodelsIndependently(orig.mInstantiateSubmodelsIndependently)
 {
   connectToChild();
 }
@@ -98,6 +107,13 @@ CompModelPlugin::operator=(const CompModelPlugin& orig)
     mDivider = orig.mDivider;
     mRemoved.clear(); //If we're making a copy, the list of things we've removed is new.
     mTransformer = orig.mTransformer;
+    mUseReferenceIndex = false; //The index is only valid for the original.
+    clearReferenceIndex();
+    mDeferIdRefRenames = false; //So are the pending renames.
+    mInstantiateSubmodelsIndependently = orig.mInstantiateSubmodelsIndependently;
+    mPendingSIdRenames.clear();
+    mPendingUnitSIdRenames.clear();
+    mPendingMetaIdRenames.clear();
     connectToChild();
   }
   return *this;
@@ -515,6 +531,98 @@ CompModelPlugin::enablePackageInternal(const std::string& pkgURI,
 /** @endcond */
 
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Moves the items of one list to the end of another.
+ */
+static int
+moveItems(ListOf* from, ListOf* to)
+{
+  vector<SBase*> items;
+  for (unsigned int n = 0; n < from->size(); n++)
+  {
+    items.push_back(from->get(n));
+  }
+  from->clear(false);
+
+  int ret = LIBSBML_OPERATION_SUCCESS;
+  for (size_t n = 0; n < items.size(); n++)
+  {
+    if (ret == LIBSBML_OPERATION_SUCCESS)
+    {
+      ret = to->appendAndOwn(items[n]);
+    }
+    if (ret != LIBSBML_OPERATION_SUCCESS)
+    {
+      delete items[n];
+    }
+  }
+  return ret;
+}
+
+
+/*
+ * Moves the core elements of an instantiated submodel, and of the submodels
+ * instantiated within it, to the end of the lists of 'flat', in the order
+ * in which Model::appendFrom would copy them.
+ */
+static int
+moveCoreElements(Model* instance, Model* flat, const string& prefix)
+{
+  ListOf* from[] = {
+    instance->getListOfFunctionDefinitions(),
+    instance->getListOfUnitDefinitions(),
+    instance->getListOfCompartmentTypes(),
+    instance->getListOfSpeciesTypes(),
+    instance->getListOfCompartments(),
+    instance->getListOfSpecies(),
+    instance->getListOfParameters(),
+    instance->getListOfInitialAssignments(),
+    instance->getListOfRules(),
+    instance->getListOfConstraints(),
+    instance->getListOfReactions(),
+    instance->getListOfEvents() };
+  ListOf* to[] = {
+    flat->getListOfFunctionDefinitions(),
+    flat->getListOfUnitDefinitions(),
+    flat->getListOfCompartmentTypes(),
+    flat->getListOfSpeciesTypes(),
+    flat->getListOfCompartments(),
+    flat->getListOfSpecies(),
+    flat->getListOfParameters(),
+    flat->getListOfInitialAssignments(),
+    flat->getListOfRules(),
+    flat->getListOfConstraints(),
+    flat->getListOfReactions(),
+    flat->getListOfEvents() };
+
+  for (size_t list = 0; list < sizeof(from) / sizeof(from[0]); list++)
+  {
+    int ret = moveItems(from[list], to[list]);
+    if (ret != LIBSBML_OPERATION_SUCCESS)
+      return ret;
+  }
+
+  CompModelPlugin* plugin =
+    static_cast<CompModelPlugin*>(instance->getPlugin(prefix));
+  if (plugin == NULL)
+    return LIBSBML_OPERATION_SUCCESS;
+
+  for (unsigned int sm = 0; sm < plugin->getNumSubmodels(); sm++)
+  {
+    Model* nested = plugin->getSubmodel(sm)->getInstantiation();
+    if (nested == NULL)
+      return LIBSBML_OPERATION_FAILED;
+
+    int ret = moveCoreElements(nested, flat, prefix);
+    if (ret != LIBSBML_OPERATION_SUCCESS)
+      return ret;
+  }
+  return LIBSBML_OPERATION_SUCCESS;
+}
+/** @endcond */
+
+
 Model* CompModelPlugin::flattenModel() const
 {
   //First make a copy of our parent (the model to be flattened):
@@ -568,7 +676,13 @@ Model* CompModelPlugin::flattenModel() const
         delete submodplug->removePort(0);
       }
     }
-    success = flat->appendFrom(submodel);
+    // The instances are deleted with the submodels of 'flat' once they are
+    // appended, so their core elements are moved rather than copied;
+    // appendFrom copies what the packages hold.
+    success = moveCoreElements(submodel, flat, getPrefix());
+    if (success == LIBSBML_OPERATION_SUCCESS) {
+      success = flat->appendFrom(submodel);
+    }
     if (success != LIBSBML_OPERATION_SUCCESS) {
       string error = "Unable to flatten model in CompModelPlugin::flattenModel: appending elements from the submodel '" + submodel->getId() + "' to the elements of the parent model failed.";
       doc->getErrorLog()->logPackageError("comp", CompModelFlatteningFailed, 
@@ -730,6 +844,13 @@ CompModelPlugin::instantiateSubmodels()
 
   // First we instantiate all the submodels.  
   // This acts recursively downward through the stack.
+  if (mInstantiateSubmodelsIndependently)
+  {
+    ret = instantiateSubmodelTasks();
+    if (ret != LIBSBML_OPERATION_SUCCESS) {
+      return ret;
+    }
+  }
   for (unsigned int sub=0; sub<mListOfSubmodels.size(); sub++) 
   {
     Submodel* submodel = mListOfSubmodels.get(sub);
@@ -782,7 +903,10 @@ CompModelPlugin::instantiateSubmodels()
   }
 
   //Perform replacements and conversions (top-down) and collect them.
+  // The references to replaced elements are renamed model by model.
+  setDeferIdRefRenames(true);
   ret = collectRenameAndConvertReplacements(&mRemoved, &toremove);
+  setDeferIdRefRenames(false);
 
   if (ret != LIBSBML_OPERATION_SUCCESS) {
     return ret;
@@ -800,10 +924,71 @@ CompModelPlugin::instantiateSubmodels()
   return LIBSBML_OPERATION_SUCCESS;
 }
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Appends the errors of one log to another, and clears the first.
+ */
+static void
+moveErrors(SBMLErrorLog* from, SBMLErrorLog* to)
+{
+  for (unsigned int n = 0; n < from->getNumErrors(); n++)
+  {
+    to->add(*(from->getError(n)));
+  }
+  from->clearLog();
+}
+
+
+int
+CompModelPlugin::instantiateSubmodelTasks()
+{
+  SBMLDocument* doc = getSBMLDocument();
+  if (doc == NULL)
+    return LIBSBML_INVALID_OBJECT;
+
+  // The submodels log their errors to the document, so the errors logged
+  // so far are set aside and the log is emptied after every submodel.
+  SBMLErrorLog* log = doc->getErrorLog();
+  SBMLErrorLog earlier;
+  moveErrors(log, &earlier);
+
+  int ret = LIBSBML_OPERATION_SUCCESS;
+  vector<SBMLErrorLog> taskLogs(mListOfSubmodels.size());
+  for (unsigned int sub=0; sub<mListOfSubmodels.size(); sub++)
+  {
+    Submodel* submodel = mListOfSubmodels.get(sub);
+    if (submodel->getInstantiation() == NULL) {
+      //'getInstantiation' already sets any errors that might have occurred.
+      ret = LIBSBML_OPERATION_FAILED;
+    }
+    moveErrors(log, &taskLogs[sub]);
+  }
+
+  // The errors were already adjusted to the severity override when they
+  // were logged.
+  XMLErrorSeverityOverride_t severity = log->getSeverityOverride();
+  log->setSeverityOverride(LIBSBML_OVERRIDE_DISABLED);
+  moveErrors(&earlier, log);
+  for (size_t sub=0; sub<taskLogs.size(); sub++)
+  {
+    moveErrors(&taskLogs[sub], log);
+  }
+  log->setSeverityOverride(severity);
+
+  return ret;
+}
+/** @endcond */
+
+
 int CompModelPlugin::saveAllReferencedElements()
 {
   set<SBase*> norefs;
-  return saveAllReferencedElements(norefs, norefs, getSBMLDocument());
+  // Nothing is renamed while the references are saved, so every model 
+  // instance in the hierarchy only needs to be indexed once.
+  setUseReferenceIndex(true);
+  int ret = saveAllReferencedElements(norefs, norefs, getSBMLDocument());
+  setUseReferenceIndex(false);
+  return ret;
 }
 
 int CompModelPlugin::saveAllReferencedElements(set<SBase*> uniqueRefs, set<SBase*> replacedBys, SBMLDocument* doc)
@@ -955,6 +1140,10 @@ int CompModelPlugin::saveAllReferencedElements(set<SBase*> uniqueRefs, set<SBase
     (*el)->removeFromParentAndDelete();
   }
   delete allElements;
+  if (!todelete.empty()) {
+    //The index may point to the elements just deleted.
+    clearReferenceIndex();
+  }
 
   //Now call saveAllReferencedElements for all instantiated submodels.
   for (unsigned long sm=0; sm<getNumSubmodels(); ++sm) {
@@ -1132,9 +1321,9 @@ void CompModelPlugin::findUniqueSubmodPrefixes(vector<string>& submodids, List*
 void CompModelPlugin::renameIDs(List* allElements, const string& prefix)
 {
   if (prefix=="") return; //Nothing to prepend.
-  vector<pair<string, string> > renamedSIds;
-  vector<pair<string, string> > renamedUnitSIds;
-  vector<pair<string, string> > renamedMetaIds;
+  map<string, string> renamedSIds;
+  map<string, string> renamedUnitSIds;
+  map<string, string> renamedMetaIds;
   
   // if a custom prefix transformer was specified, then set the 
   // current prefix
@@ -1162,7 +1351,7 @@ void CompModelPlugin::renameIDs(List* allElements, const string& prefix)
     if (id != newid) {
       int type = element->getTypeCode();
       if (type==SBML_UNIT_DEFINITION) {
-        renamedUnitSIds.push_back(make_pair(id, newid));
+        renamedUnitSIds.insert(make_pair(id, newid));
       }
       else if (type==SBML_COMP_PORT) {
         //Do nothing--these can only be referenced from outside the Model, so they need to be handled specially.
@@ -1171,32 +1360,22 @@ void CompModelPlugin::renameIDs(List* allElements, const string& prefix)
       else {
         //This is a little dangerous, but hey!  What's a little danger between friends!
         //(What we are assuming is that any attribute you can get with 'getId' is of the type 'SId')
-        renamedSIds.push_back(make_pair(id, newid));
+        renamedSIds.insert(make_pair(id, newid));
       }
     }
     if (metaid != newmetaid) {
-      renamedMetaIds.push_back(make_pair(metaid, newmetaid));
+      renamedMetaIds.insert(make_pair(metaid, newmetaid));
     }
   }
 
-  //for (unsigned long el=0; el<allElements->getSize(); el++) {
-  //  SBase* element = static_cast<SBase*>(allElements->get((unsigned int)el));
-  // Using ListIterator is faster
+  if (renamedSIds.empty() && renamedUnitSIds.empty() && renamedMetaIds.empty())
+    return;
+
+  // each element is examined once for all the renames
   for (ListIterator iter = allElements->begin(); iter != allElements->end(); ++iter)
   {
     SBase* element = static_cast<SBase*>(*iter);
-    for (size_t id=0; id<renamedSIds.size(); id++)
-    {
-      element->renameSIdRefs(renamedSIds[id].first, renamedSIds[id].second);
-    }
-    for (size_t uid=0; uid<renamedUnitSIds.size(); uid++) 
-    {
-      element->renameUnitSIdRefs(renamedUnitSIds[uid].first, renamedUnitSIds[uid].second);
-    }
-    for (size_t mid=0; mid<renamedMetaIds.size(); mid++) 
-    {
-      element->renameMetaIdRefs(renamedMetaIds[mid].first, renamedMetaIds[mid].second);
-    }
+    element->renameIdRefs(renamedSIds, renamedUnitSIds, renamedMetaIds);
   }
 }
 /** @endcond */
@@ -1294,6 +1473,9 @@ int CompModelPlugin::collectRenameAndConvertReplacements(set<SBase*>* removed, s
     }
     return LIBSBML_OPERATION_FAILED;
   }
+  // Any renames from the parent model have to be in place before the
+  // replacements of this model read their own attributes.
+  applyPendingIdRefRenames();
   List* allElements = model->getAllElements();
   vector<ReplacedElement*> res;
   vector<ReplacedBy*> rbs;
@@ -1332,6 +1514,7 @@ int CompModelPlugin::collectRenameAndConvertReplacements(set<SBase*>* removed, s
     CompModelPlugin* modplug = static_cast<CompModelPlugin*>(mod->getPlugin(getPrefix()));
     if (modplug==NULL) return LIBSBML_OPERATION_FAILED;
     //'left behind' converions (not LaHaye-style)
+    modplug->applyPendingIdRefRenames();
     ret = submodel->convertTimeAndExtent();
     if (ret != LIBSBML_OPERATION_SUCCESS) return ret;
     ret = modplug->collectRenameAndConvertReplacements(removed, toremove);
@@ -1441,6 +1624,302 @@ CompModelPlugin::unsetTransformer()
 
 
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Adds the element to the index under the given key, or marks the key as
+ * ambiguous (with NULL) if another element is already indexed under it.
+ */
+template <class T>
+static void
+addToReferenceIndex(map<string, T*>& index, const string& key, T* element)
+{
+  pair<typename map<string, T*>::iterator, bool> added = 
+    index.insert(make_pair(key, element));
+  if (!added.second && added.first->second != element) {
+    added.first->second = NULL;
+  }
+}
+
+
+SBase* 
+CompModelPlugin::findElementBySId(const std::string& id)
+{
+  Model* model = static_cast<Model*>(getParentSBMLObject());
+  if (model == NULL) return NULL;
+
+  if (mUseReferenceIndex && !id.empty()) {
+    if (!mReferenceIndexBuilt) {
+      buildReferenceIndex();
+    }
+    // Elements whose 'id' attribute is the id take precedence over those 
+    // that only report it (such as rules reporting their variable).
+    map<string, SBase*>::iterator found = mSIdIndex.find(id);
+    if (found == mSIdIndex.end()) {
+      found = mOtherSIdIndex.find(id);
+      if (found != mOtherSIdIndex.end() && found->second != NULL) {
+        return found->second;
+      }
+    }
+    else if (found->second != NULL) {
+      return found->second;
+    }
+  }
+
+  //Not indexed, ambiguous, or not found:  let the model decide.
+  return model->getElementBySId(id);
+}
+
+
+SBase* 
+CompModelPlugin::findElementByMetaId(const std::string& metaid)
+{
+  Model* model = static_cast<Model*>(getParentSBMLObject());
+  if (model == NULL) return NULL;
+
+  if (mUseReferenceIndex && !metaid.empty()) {
+    if (!mReferenceIndexBuilt) {
+      buildReferenceIndex();
+    }
+    map<string, SBase*>::iterator found = mMetaIdIndex.find(metaid);
+    if (found != mMetaIdIndex.end() && found->second != NULL) {
+      return found->second;
+    }
+  }
+
+  return model->getElementByMetaId(metaid);
+}
+
+
+Port* 
+CompModelPlugin::findPort(const std::string& id)
+{
+  if (mUseReferenceIndex && !id.empty()) {
+    if (!mReferenceIndexBuilt) {
+      buildReferenceIndex();
+    }
+    map<string, Port*>::iterator found = mPortIndex.find(id);
+    if (found != mPortIndex.end() && found->second != NULL) {
+      return found->second;
+    }
+  }
+
+  return getPort(id);
+}
+
+
+void 
+CompModelPlugin::setUseReferenceIndex(bool useIndex)
+{
+  mUseReferenceIndex = useIndex;
+  clearReferenceIndex();
+  for (unsigned int sm=0; sm<getNumSubmodels(); sm++) {
+    const Submodel* submodel = getSubmodel(sm);
+    // Only models that were already instantiated:  this must not 
+    // instantiate anything.
+    Model* inst = const_cast<Model*>(submodel->getInstantiation());
+    if (inst == NULL) continue;
+    CompModelPlugin* instplug = 
+      static_cast<CompModelPlugin*>(inst->getPlugin(getPrefix()));
+    if (instplug != NULL) {
+      instplug->setUseReferenceIndex(useIndex);
+    }
+  }
+}
+
+
+void 
+CompModelPlugin::buildReferenceIndex()
+{
+  clearReferenceIndex();
+  Model* model = static_cast<Model*>(getParentSBMLObject());
+  if (model == NULL) return;
+
+  List* allElements = model->getAllElements();
+  for (ListIterator iter = allElements->begin(); iter != allElements->end(); ++iter)
+  {
+    SBase* element = static_cast<SBase*>(*iter);
+    // The model never finds a ListOf by its id, only by its metaid.
+    if (element->getTypeCode() != SBML_LIST_OF && element->isSetId()) {
+      if (element->getIdAttribute() == element->getId()) {
+        addToReferenceIndex(mSIdIndex, element->getId(), element);
+      }
+      else {
+        addToReferenceIndex(mOtherSIdIndex, element->getId(), element);
+      }
+    }
+    if (element->isSetMetaId()) {
+      addToReferenceIndex(mMetaIdIndex, element->getMetaId(), element);
+    }
+  }
+  delete allElements;
+
+  for (unsigned int p=0; p<getNumPorts(); p++) {
+    Port* port = getPort(p);
+    addToReferenceIndex(mPortIndex, port->getId(), port);
+  }
+  mReferenceIndexBuilt = true;
+}
+
+
+void 
+CompModelPlugin::clearReferenceIndex()
+{
+  mSIdIndex.clear();
+  mOtherSIdIndex.clear();
+  mMetaIdIndex.clear();
+  mPortIndex.clear();
+  mReferenceIndexBuilt = false;
+}
+
+
+/*
+ * Adds the rename of 'oldid' to 'newid':  earlier renames that led to
+ * 'oldid' now lead to 'newid', and if 'oldid' itself was renamed already,
+ * there is nothing left to rename.  The smaller of the groups is moved, so
+ * that every rename is moved a logarithmic number of times at most.
+ */
+void
+CompModelPlugin::PendingRenames::add(const string& oldid, const string& newid)
+{
+  if (oldid != newid) {
+    map<string, vector<string> >::iterator moved = mByNewId.find(oldid);
+    if (moved != mByNewId.end()) {
+      vector<string>& target = mByNewId[newid];
+      if (target.size() < moved->second.size()) {
+        target.swap(moved->second);
+      }
+      target.insert(target.end(), moved->second.begin(), moved->second.end());
+      mByNewId.erase(moved);
+    }
+  }
+  if (mRenamed.insert(oldid).second) {
+    mByNewId[newid].push_back(oldid);
+  }
+}
+
+
+void
+CompModelPlugin::PendingRenames::getRenames(map<string, string>& renames) const
+{
+  for (map<string, vector<string> >::const_iterator it = mByNewId.begin();
+       it != mByNewId.end(); ++it)
+  {
+    for (size_t i = 0; i < it->second.size(); ++i) {
+      renames.insert(make_pair(it->second[i], it->first));
+    }
+  }
+}
+
+
+bool
+CompModelPlugin::PendingRenames::empty() const
+{
+  return mRenamed.empty();
+}
+
+
+void
+CompModelPlugin::PendingRenames::clear()
+{
+  mByNewId.clear();
+  mRenamed.clear();
+}
+
+
+void 
+CompModelPlugin::setDeferIdRefRenames(bool defer)
+{
+  if (!defer) {
+    applyPendingIdRefRenames();
+  }
+  mDeferIdRefRenames = defer;
+  for (unsigned int sm=0; sm<getNumSubmodels(); sm++) {
+    const Submodel* submodel = getSubmodel(sm);
+    Model* inst = const_cast<Model*>(submodel->getInstantiation());
+    if (inst == NULL) continue;
+    CompModelPlugin* instplug = 
+      static_cast<CompModelPlugin*>(inst->getPlugin(getPrefix()));
+    if (instplug != NULL) {
+      instplug->setDeferIdRefRenames(defer);
+    }
+  }
+}
+
+
+bool 
+CompModelPlugin::deferSIdRefRename(const std::string& oldid, 
+                                   const std::string& newid)
+{
+  if (!mDeferIdRefRenames) return false;
+  mPendingSIdRenames.add(oldid, newid);
+  return true;
+}
+
+
+bool 
+CompModelPlugin::deferUnitSIdRefRename(const std::string& oldid, 
+                                       const std::string& newid)
+{
+  if (!mDeferIdRefRenames) return false;
+  mPendingUnitSIdRenames.add(oldid, newid);
+  return true;
+}
+
+
+bool 
+CompModelPlugin::deferMetaIdRefRename(const std::string& oldid, 
+                                      const std::string& newid)
+{
+  if (!mDeferIdRefRenames) return false;
+  mPendingMetaIdRenames.add(oldid, newid);
+  return true;
+}
+
+
+void 
+CompModelPlugin::applyPendingIdRefRenames()
+{
+  if (mPendingSIdRenames.empty() && mPendingUnitSIdRenames.empty() 
+    && mPendingMetaIdRenames.empty()) {
+    return;
+  }
+  Model* model = static_cast<Model*>(getParentSBMLObject());
+  if (model == NULL) return;
+
+  map<string, string> sids, unitSIds, metaIds;
+  mPendingSIdRenames.getRenames(sids);
+  mPendingUnitSIdRenames.getRenames(unitSIds);
+  mPendingMetaIdRenames.getRenames(metaIds);
+  mPendingSIdRenames.clear();
+  mPendingUnitSIdRenames.clear();
+  mPendingMetaIdRenames.clear();
+
+  model->renameIdRefs(sids, unitSIds, metaIds);
+  List* allElements = model->getAllElements();
+  for (ListIterator iter = allElements->begin(); iter != allElements->end(); ++iter)
+  {
+    SBase* element = static_cast<SBase*>(*iter);
+    element->renameIdRefs(sids, unitSIds, metaIds);
+  }
+  delete allElements;
+}
+
+
+void
+CompModelPlugin::setInstantiateSubmodelsIndependently(bool independent)
+{
+  mInstantiateSubmodelsIndependently = independent;
+}
+
+
+bool
+CompModelPlugin::getInstantiateSubmodelsIndependently() const
+{
+  return mInstantiateSubmodelsIndependently;
+}
+/** @endcond */
+
+
 /** @cond doxygenLibsbmlInternal */
 std::set<SBase*>* 
 CompModelPlugin::getRemovedSet() 
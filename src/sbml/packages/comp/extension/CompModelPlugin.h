@@ -72,6 +72,8 @@
 #include <iostream>
 #include <string>
 #include <set>
+#include <map>
+#include <vector>
 
 #include <sbml/packages/comp/extension/CompExtension.h>
 #include <sbml/packages/comp/extension/CompSBasePlugin.h>
@@ -759,6 +761,108 @@ virtual int collectDeletionsAndDeleteSome(std::set<SBase*>* removed,
   virtual int saveAllReferencedElements(std::set<SBase*> uniqueRefs, std::set<SBase*> replacedBys, SBMLDocument* doc);
   /** @endcond */
 
+
+  public:
+  /** @cond doxygenLibsbmlInternal */
+  /*
+   * Find elements of the parent Model the way Model::getElementBySId,
+   * Model::getElementByMetaId and getPort(id) do.  While the referenced
+   * elements of a hierarchy are being saved, these use an index of the
+   * Model (and of its ports) built once for every model instance, instead
+   * of walking the Model for every single reference.
+   */
+  SBase* findElementBySId(const std::string& id);
+  SBase* findElementByMetaId(const std::string& metaid);
+  Port* findPort(const std::string& id);
+
+  /*
+   * Turns the reference index of this Model and of all its instantiated
+   * submodels (recursively) on or off.  Either way, any index built so
+   * far is discarded.
+   */
+  void setUseReferenceIndex(bool useIndex);
+
+  void buildReferenceIndex();
+  void clearReferenceIndex();
+
+  /*
+   * While the replacements of a hierarchy are performed, the references to
+   * the identifiers of a replaced element are not renamed right away:  the
+   * renames for every model instance are collected and applied to the
+   * whole Model at once, before anything reads the references again.
+   * Turning the deferral off (recursively, like setUseReferenceIndex)
+   * applies whatever is still pending.
+   */
+  void setDeferIdRefRenames(bool defer);
+
+  /*
+   * Record a rename of the references to 'oldid' in the parent Model.
+   * Return false (recording nothing) if renames are not being deferred,
+   * in which case the caller has to rename the references itself.
+   */
+  bool deferSIdRefRename(const std::string& oldid, const std::string& newid);
+  bool deferUnitSIdRefRename(const std::string& oldid, const std::string& newid);
+  bool deferMetaIdRefRename(const std::string& oldid, const std::string& newid);
+
+  void applyPendingIdRefRenames();
+
+  /*
+   * When set, instantiateSubmodels() instantiates the submodels of this
+   * Model as independent tasks (see instantiateSubmodelTasks).
+   */
+  void setInstantiateSubmodelsIndependently(bool independent);
+  bool getInstantiateSubmodelsIndependently() const;
+  /** @endcond */
+
+
+  protected:
+  /** @cond doxygenLibsbmlInternal */
+  /*
+   * Instantiates every submodel of this Model, whatever happens to its
+   * siblings.  Each submodel is instantiated with an error log of its own;
+   * the logs are appended to the log of the document in the order of the
+   * submodels once all of them are done.
+   */
+  int instantiateSubmodelTasks();
+  /** @endcond */
+
+
+  /** @cond doxygenLibsbmlInternal */
+  /*
+   * The renames of one kind of identifier recorded while renames are
+   * deferred, composed so that applying them all at once has the effect of
+   * applying them one after the other.  They are kept by the identifier
+   * they finally lead to, so that renaming that identifier again moves all
+   * of them at once.
+   */
+  class PendingRenames
+  {
+  public:
+    void add(const std::string& oldid, const std::string& newid);
+    void getRenames(std::map<std::string, std::string>& renames) const;
+    bool empty() const;
+    void clear();
+
+  private:
+    std::map<std::string, std::vector<std::string> > mByNewId;
+    std::set<std::string> mRenamed;
+  };
+
+  bool mUseReferenceIndex;
+  bool mReferenceIndexBuilt;
+  std::map<std::string, SBase*> mSIdIndex;
+  std::map<std::string, SBase*> mOtherSIdIndex;
+  std::map<std::string, SBase*> mMetaIdIndex;
+  std::map<std::string, Port*>  mPortIndex;
+
+  bool mDeferIdRefRenames;
+  PendingRenames mPendingSIdRenames;
+  PendingRenames mPendingUnitSIdRenames;
+  PendingRenames mPendingMetaIdRenames;
+
+  bool mInstantiateSubmodelsIndependently;
+  /** @endcond */
+
 };
 
 LIBSBML_CPP_NAMESPACE_END
@@ -39,6 +39,7 @@
 #include <sbml/common/libsbml-version.h>
 #include <sbml/packages/comp/common/compfwd.h>
 #include <sbml/packages/comp/util/SBMLResolverRegistry.h>
+#include <sbml/packages/comp/util/SBMLDocumentCache.h>
 #include <sbml/packages/comp/util/SBMLUri.h>
 #include <sbml/packages/comp/extension/CompSBMLDocumentPlugin.h>
 #include <sbml/packages/comp/extension/CompModelPlugin.h>
@@ -687,7 +688,8 @@ CompSBMLDocumentPlugin::getSBMLDocumentFromURI(const std::string& uri)
   map<string, SBMLDocument*>::iterator stored = mURIToDocumentMap.find(resolvedURI);
   if (stored == mURIToDocumentMap.end()) 
   {
-    SBMLDocument* doc = registry.resolve(uri, mSBML->getLocationURI());
+    SBMLDocument* doc = SBMLDocumentCache::getInstance().resolve(
+      uri, mSBML->getLocationURI(), resolvedURI);
 
     if (doc==NULL) 
       return NULL;
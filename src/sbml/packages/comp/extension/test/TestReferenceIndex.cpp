@@ -0,0 +1,263 @@
+/**
+ * \file    TestReferenceIndex.cpp
+ * \brief   Tests for the reference index and the deferred renames of
+ *          CompModelPlugin.
+ * \author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sbml/common/common.h>
+
+#include <sbml/packages/comp/common/CompExtensionTypes.h>
+
+#include <sbml/SBMLTypes.h>
+#include <sbml/math/L3FormulaFormatter.h>
+#include <sbml/math/L3Parser.h>
+
+#include <string>
+
+#include <check.h>
+
+using namespace std;
+
+LIBSBML_CPP_NAMESPACE_USE
+
+BEGIN_C_DECLS
+
+
+static Parameter*
+addParameter(Model* model, const string& id)
+{
+  Parameter* p = model->createParameter();
+  p->setId(id);
+  p->setConstant(false);
+  return p;
+}
+
+
+/*
+ * Creates a model with species s1, parameter p1 set by an assignment rule,
+ * a reaction whose local parameter shares its id with the species x, and
+ * the port port1.
+ */
+static SBMLDocument*
+createModel()
+{
+  CompPkgNamespaces ns(3, 1, 1);
+  SBMLDocument* doc = new SBMLDocument(&ns);
+  Model* model = doc->createModel();
+
+  Compartment* c = model->createCompartment();
+  c->setId("c");
+  c->setConstant(true);
+
+  Species* s = model->createSpecies();
+  s->setId("s1");
+  s->setMetaId("meta_s1");
+  s->setCompartment("c");
+  s->setHasOnlySubstanceUnits(false);
+  s->setBoundaryCondition(false);
+  s->setConstant(false);
+
+  s = model->createSpecies();
+  s->setId("x");
+  s->setCompartment("c");
+  s->setHasOnlySubstanceUnits(false);
+  s->setBoundaryCondition(false);
+  s->setConstant(false);
+
+  addParameter(model, "p1");
+  AssignmentRule* rule = model->createAssignmentRule();
+  rule->setVariable("p1");
+  rule->setMetaId("meta_rule");
+  ASTNode* math = SBML_parseL3Formula("2");
+  rule->setMath(math);
+  delete math;
+
+  Reaction* r = model->createReaction();
+  r->setId("r");
+  r->setReversible(false);
+  r->setFast(false);
+  KineticLaw* kl = r->createKineticLaw();
+  LocalParameter* lp = kl->createLocalParameter();
+  lp->setId("x");
+  math = SBML_parseL3Formula("x");
+  kl->setMath(math);
+  delete math;
+
+  CompModelPlugin* plugin =
+    static_cast<CompModelPlugin*>(model->getPlugin("comp"));
+  Port* port = plugin->createPort();
+  port->setId("port1");
+  port->setIdRef("s1");
+
+  return doc;
+}
+
+
+START_TEST (test_comp_referenceindex_find)
+{
+  SBMLDocument* doc = createModel();
+  Model* model = doc->getModel();
+  CompModelPlugin* plugin =
+    static_cast<CompModelPlugin*>(model->getPlugin("comp"));
+
+  plugin->setUseReferenceIndex(true);
+
+  fail_unless(plugin->findElementBySId("s1") == model->getSpecies("s1"));
+  fail_unless(plugin->findElementBySId("r") == model->getReaction("r"));
+  fail_unless(plugin->findElementBySId("none") == NULL);
+  fail_unless(plugin->findElementBySId("") == NULL);
+
+  // the parameter, not the rule reporting its variable as its id
+  fail_unless(plugin->findElementBySId("p1") == model->getParameter("p1"));
+
+  // an ambiguous id is found the way the model finds it
+  fail_unless(plugin->findElementBySId("x") == model->getElementBySId("x"));
+
+  fail_unless(plugin->findElementByMetaId("meta_s1")
+              == model->getSpecies("s1"));
+  fail_unless(plugin->findElementByMetaId("meta_rule")
+              == model->getRule("p1"));
+  fail_unless(plugin->findElementByMetaId("none") == NULL);
+
+  fail_unless(plugin->findPort("port1") == plugin->getPort("port1"));
+  fail_unless(plugin->findPort("none") == NULL);
+
+  // without the index, the same elements are found
+  plugin->setUseReferenceIndex(false);
+  fail_unless(plugin->findElementBySId("s1") == model->getSpecies("s1"));
+  fail_unless(plugin->findElementBySId("p1") == model->getParameter("p1"));
+  fail_unless(plugin->findElementByMetaId("meta_s1")
+              == model->getSpecies("s1"));
+  fail_unless(plugin->findPort("port1") == plugin->getPort("port1"));
+
+  delete doc;
+}
+END_TEST
+
+
+START_TEST (test_comp_referenceindex_invalidate)
+{
+  SBMLDocument* doc = createModel();
+  Model* model = doc->getModel();
+  CompModelPlugin* plugin =
+    static_cast<CompModelPlugin*>(model->getPlugin("comp"));
+
+  plugin->setUseReferenceIndex(true);
+  fail_unless(plugin->findElementBySId("s1") == model->getSpecies("s1"));
+  fail_unless(plugin->findPort("port1") == plugin->getPort("port1"));
+
+  // replace the indexed elements with new ones under the same ids
+  delete model->removeSpecies("s1");
+  delete plugin->removePort(0);
+
+  Species* s = model->createSpecies();
+  s->setId("s1");
+  s->setMetaId("meta_s1");
+  Port* port = plugin->createPort();
+  port->setId("port1");
+
+  plugin->clearReferenceIndex();
+  fail_unless(plugin->findElementBySId("s1") == s);
+  fail_unless(plugin->findElementByMetaId("meta_s1") == s);
+  fail_unless(plugin->findPort("port1") == port);
+
+  // turning the index on again discards it as well
+  delete model->removeSpecies("s1");
+  s = model->createSpecies();
+  s->setId("s1");
+
+  plugin->setUseReferenceIndex(true);
+  fail_unless(plugin->findElementBySId("s1") == s);
+  fail_unless(plugin->findElementByMetaId("meta_s1") == NULL);
+
+  plugin->setUseReferenceIndex(false);
+  delete doc;
+}
+END_TEST
+
+
+START_TEST (test_comp_referenceindex_deferred_renames)
+{
+  CompPkgNamespaces ns(3, 1, 1);
+  SBMLDocument doc(&ns);
+  Model* model = doc.createModel();
+  CompModelPlugin* plugin =
+    static_cast<CompModelPlugin*>(model->getPlugin("comp"));
+
+  addParameter(model, "z");
+  AssignmentRule* rule = model->createAssignmentRule();
+  rule->setVariable("z");
+  ASTNode* math = SBML_parseL3Formula("a + b + c + x * y + e");
+  rule->setMath(math);
+  delete math;
+
+  fail_unless(plugin->deferSIdRefRename("a", "b") == false);
+
+  plugin->setDeferIdRefRenames(true);
+
+  // a chain:  a -> b -> c -> d
+  fail_unless(plugin->deferSIdRefRename("a", "b") == true);
+  fail_unless(plugin->deferSIdRefRename("b", "c") == true);
+  fail_unless(plugin->deferSIdRefRename("c", "d") == true);
+
+  // a cycle:  x -> y -> x
+  fail_unless(plugin->deferSIdRefRename("x", "y") == true);
+  fail_unless(plugin->deferSIdRefRename("y", "x") == true);
+
+  // once e is renamed, there is no e left to rename
+  fail_unless(plugin->deferSIdRefRename("e", "f") == true);
+  fail_unless(plugin->deferSIdRefRename("e", "g") == true);
+
+  // nothing is renamed until the deferral ends
+  char* formula = SBML_formulaToL3String(rule->getMath());
+  fail_unless(string(formula) == "a + b + c + x * y + e");
+  safe_free(formula);
+
+  plugin->setDeferIdRefRenames(false);
+
+  formula = SBML_formulaToL3String(rule->getMath());
+  fail_unless(string(formula) == "d + d + d + x * x + f");
+  safe_free(formula);
+
+  // and the renames are gone
+  plugin->setDeferIdRefRenames(true);
+  plugin->setDeferIdRefRenames(false);
+  formula = SBML_formulaToL3String(rule->getMath());
+  fail_unless(string(formula) == "d + d + d + x * x + f");
+  safe_free(formula);
+}
+END_TEST
+
+
+Suite *
+create_suite_TestReferenceIndex(void)
+{
+  TCase *tcase = tcase_create("TestReferenceIndex");
+  Suite *suite = suite_create("TestReferenceIndex");
+
+  tcase_add_test(tcase, test_comp_referenceindex_find);
+  tcase_add_test(tcase, test_comp_referenceindex_invalidate);
+  tcase_add_test(tcase, test_comp_referenceindex_deferred_renames);
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+END_C_DECLS
@@ -59,6 +59,7 @@ CK_CPPSTART
 Suite *create_suite_TestExtensionObjects(void);
 Suite *create_suite_TestMultipleNamespaces(void);
 Suite *create_suite_TestCheckConsistency(void);
+Suite *create_suite_TestReferenceIndex(void);
 
 
 /**
@@ -107,6 +108,7 @@ main (void)
   SRunner *runner = srunner_create( create_suite_TestExtensionObjects() );
   srunner_add_suite( runner, create_suite_TestMultipleNamespaces() );
   srunner_add_suite( runner, create_suite_TestCheckConsistency() );
+  srunner_add_suite( runner, create_suite_TestReferenceIndex() );
 
   /* srunner_set_fork_status(runner, CK_NOFORK); */
 
@@ -329,6 +329,14 @@ Port::renameSIdRefs(const std::string& oldid, const std::string& newid)
 }
 
 
+void
+Port::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  // the idRef is renamed by SBaseRef, and must not be renamed twice
+  SBaseRef::renameSIdRefs(renames);
+}
+
+
 void
 Port::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
 {
@@ -337,6 +345,14 @@ Port::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
 }
 
 
+void
+Port::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mUnitRef, renames);
+  SBaseRef::renameUnitSIdRefs(renames);
+}
+
+
 void
 Port::renameMetaIdRefs(const std::string& oldid, const std::string& newid)
 {
@@ -345,6 +361,14 @@ Port::renameMetaIdRefs(const std::string& oldid, const std::string& newid)
 }
 
 
+void
+Port::renameMetaIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mMetaIdRef, renames);
+  SBaseRef::renameMetaIdRefs(renames);
+}
+
+
 /** @cond doxygenLibsbmlInternal */
 bool
 Port::accept (SBMLVisitor& v) const
@@ -336,6 +336,14 @@ ReplacedElement::renameSIdRefs(const std::string& oldid, const std::string& newi
 }
 
 
+void
+ReplacedElement::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mDeletion, renames);
+  Replacing::renameSIdRefs(renames);
+}
+
+
 int ReplacedElement::performReplacementAndCollect(set<SBase*>* removed, set<SBase*>* toremove)
 {
   SBMLDocument* doc = getSBMLDocument();
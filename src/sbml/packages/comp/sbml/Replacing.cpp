@@ -240,6 +240,15 @@ Replacing::renameSIdRefs(const std::string& oldid, const std::string& newid)
   SBaseRef::renameSIdRefs(oldid, newid);
 }
 
+
+void
+Replacing::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mSubmodelRef, renames);
+  renameIdRef(mConversionFactor, renames);
+  SBaseRef::renameSIdRefs(renames);
+}
+
 /** @cond doxygenLibsbmlInternal */
 void
 Replacing::addExpectedAttributes(ExpectedAttributes& attributes)
@@ -404,13 +413,21 @@ Replacing::updateIDs(SBase* oldnames, SBase* newnames)
     }
     return LIBSBML_INVALID_OBJECT;
   }
-  List* allElements = replacedmod->getAllElements();
+  // During flattening, the renames are collected by the plugin of the
+  // replaced model and applied to all of its elements at once.
+  CompModelPlugin* replacedplug = 
+    static_cast<CompModelPlugin*>(replacedmod->getPlugin(getPrefix()));
+  List* allElements = NULL;
   string oldid = oldnames->getId();
   string newid = newnames->getId();
   if (!oldid.empty()) {
     switch(oldnames->getTypeCode()) {
     case SBML_UNIT_DEFINITION:
+      if (replacedplug != NULL && replacedplug->deferUnitSIdRefRename(oldid, newid)) {
+        break;
+      }
       replacedmod->renameUnitSIdRefs(oldid, newid);
+      allElements = replacedmod->getAllElements();
       //for (unsigned int e=0; e<allElements->getSize(); e++) {
       //  SBase* element = static_cast<SBase*>(allElements->get(e));
       // Using ListIterator is faster
@@ -421,6 +438,10 @@ Replacing::updateIDs(SBase* oldnames, SBase* newnames)
       }
       break;
     case SBML_LOCAL_PARAMETER:
+      // The kinetic law has to see the renames made before this one.
+      if (replacedplug != NULL) {
+        replacedplug->applyPendingIdRefRenames();
+      }
       replacedkl = static_cast<KineticLaw*>(oldnames->getAncestorOfType(SBML_KINETIC_LAW));
       if (replacedkl->isSetMath()) {
         newkl = *replacedkl->getMath();
@@ -432,7 +453,11 @@ Replacing::updateIDs(SBase* oldnames, SBase* newnames)
       break;
       //LS DEBUG And here is where we would need some sort of way to check if the id wasn't an SId for some objects.
     default:
+      if (replacedplug != NULL && replacedplug->deferSIdRefRename(oldid, newid)) {
+        break;
+      }
       replacedmod->renameSIdRefs(oldnames->getId(), newnames->getId());
+      allElements = replacedmod->getAllElements();
       //for (unsigned int e=0; e<allElements->getSize(); e++) {
       //  SBase* element = static_cast<SBase*>(allElements->get(e));
       // Using ListIterator is faster
@@ -445,8 +470,12 @@ Replacing::updateIDs(SBase* oldnames, SBase* newnames)
   }
   string oldmetaid = oldnames->getMetaId();
   string newmetaid = newnames->getMetaId();
-  if (oldnames->isSetMetaId()) {
+  if (oldnames->isSetMetaId() && 
+      (replacedplug == NULL || !replacedplug->deferMetaIdRefRename(oldmetaid, newmetaid))) {
     replacedmod->renameMetaIdRefs(oldmetaid, newmetaid);
+    if (allElements == NULL) {
+      allElements = replacedmod->getAllElements();
+    }
     //for (unsigned int e=0; e<allElements->getSize(); e++) {
     //  SBase* element = static_cast<SBase*>(allElements->get(e));
     // Using ListIterator is faster
@@ -467,6 +496,16 @@ Replacing::updateIDs(SBase* oldnames, SBase* newnames)
 int Replacing::performConversions(SBase* replacement, ASTNode** conversionFactor)
 {
   SBMLDocument* doc = getSBMLDocument();
+  // The conversion factor is an attribute of this element, and the
+  // conversion walks the replaced model:  both need their renames done.
+  Model* parentmod = const_cast<Model*>(CompBase::getParentModel(this));
+  if (!mConversionFactor.empty() && parentmod != NULL) {
+    CompModelPlugin* parentplug = 
+      static_cast<CompModelPlugin*>(parentmod->getPlugin(getPrefix()));
+    if (parentplug != NULL) {
+      parentplug->applyPendingIdRefRenames();
+    }
+  }
   int ret = convertConversionFactor(conversionFactor);
   if (ret != LIBSBML_OPERATION_SUCCESS) {
     //convertConversionFactor sets its own error messages.
@@ -510,6 +549,11 @@ int Replacing::performConversions(SBase* replacement, ASTNode** conversionFactor
   ASTNode divide(AST_DIVIDE);
   divide.addChild(replacementAST.deepCopy());
   divide.addChild((*conversionFactor)->deepCopy());
+  CompModelPlugin* replacedplug = 
+    static_cast<CompModelPlugin*>(replacedmod->getPlugin(getPrefix()));
+  if (replacedplug != NULL) {
+    replacedplug->applyPendingIdRefRenames();
+  }
   List* allElements = replacedmod->getAllElements();
   //for (unsigned int e=0; e<allElements->getSize(); e++) {
   //  SBase* element = static_cast<SBase*>(allElements->get(e));
@@ -542,6 +542,17 @@ SBaseRef::renameSIdRefs(const std::string& oldid, const std::string& newid)
   SBase::renameSIdRefs(oldid, newid);
 }
 
+
+void
+SBaseRef::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mPortRef, renames);
+  renameIdRef(mIdRef, renames);
+  renameIdRef(mUnitRef, renames);
+  renameIdRef(mMetaIdRef, renames);
+  SBase::renameSIdRefs(renames);
+}
+
 /*
  * Creates a new SBaseRef, adds it to this SBaseRef
  * and returns it.
@@ -813,7 +824,7 @@ SBaseRef::getReferencedElementFrom(Model* model)
   SBase* referent = NULL;
   if (isSetPortRef()) {
     CompModelPlugin* mplugin = static_cast<CompModelPlugin*>(model->getPlugin(getPrefix()));
-    Port* port = mplugin->getPort(getPortRef());
+    Port* port = mplugin->findPort(getPortRef());
     if (port==NULL) {
       if (doc) {
         string error = "In SBaseRef::getReferencedElementFrom, unable to find referenced element from SBase reference ";
@@ -829,7 +840,9 @@ SBaseRef::getReferencedElementFrom(Model* model)
     referent = port->getReferencedElementFrom(model);
   }
   else if (isSetIdRef()) {
-    referent = model->getElementBySId(getIdRef());
+    CompModelPlugin* mplugin = static_cast<CompModelPlugin*>(model->getPlugin(getPrefix()));
+    referent = (mplugin != NULL) ? mplugin->findElementBySId(getIdRef()) 
+                                 : model->getElementBySId(getIdRef());
     if (referent == NULL && doc) {
       string error = "In SBaseRef::getReferencedElementFrom, unable to find referenced element: no such SId in the model: '" + getIdRef() + "'.";
       if (doc->getErrorLog()->contains(UnrequiredPackagePresent) 
@@ -857,7 +870,9 @@ SBaseRef::getReferencedElementFrom(Model* model)
     }
   }
   else if (isSetMetaIdRef()) {
-    referent = model->getElementByMetaId(getMetaIdRef());
+    CompModelPlugin* mplugin = static_cast<CompModelPlugin*>(model->getPlugin(getPrefix()));
+    referent = (mplugin != NULL) ? mplugin->findElementByMetaId(getMetaIdRef()) 
+                                 : model->getElementByMetaId(getMetaIdRef());
     if (referent == NULL && doc) {
       string error = "In SBaseRef::getReferencedElementFrom, unable to find referenced element: no such metaid in the model: '" + getMetaIdRef() + "'.";
       if (doc->getErrorLog()->contains(UnrequiredPackagePresent) 
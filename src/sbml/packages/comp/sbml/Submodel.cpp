@@ -721,6 +721,15 @@ Submodel::renameSIdRefs(const std::string& oldid, const std::string& newid)
 }
 
 
+void
+Submodel::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mTimeConversionFactor, renames);
+  renameIdRef(mExtentConversionFactor, renames);
+  CompBase::renameSIdRefs(renames);
+}
+
+
 int
 Submodel::getTypeCode () const
 {
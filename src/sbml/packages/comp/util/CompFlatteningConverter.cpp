@@ -132,6 +132,8 @@ CompFlatteningConverter::getDefaultProperties() const
     "specify whether to strip any unflattenable packages ignored by 'abortIfUnflattenable'");
   prop.addOption("stripPackages", "", 
     "comma separated list of packages to be stripped before flattening is attempted");
+  prop.addOption("instantiateSubmodelsIndependently", false, 
+    "instantiate every submodel even if one of its siblings cannot be instantiated, so that all errors are reported");
   return prop;
 }
 
@@ -394,7 +396,10 @@ CompFlatteningConverter::performConversion()
   mainDoc.abortForRequiredOnly = getAbortForRequired(); 
  
   Submodel::addProcessingCallback(&EnablePackageOnParentDocument, &(mainDoc));
+  modelPlugin->setInstantiateSubmodelsIndependently(
+    getInstantiateSubmodelsIndependently());
   Model* flatmodel = modelPlugin->flattenModel();
+  modelPlugin->setInstantiateSubmodelsIndependently(false);
   
 
   if (flatmodel == NULL) 
@@ -802,6 +807,25 @@ CompFlatteningConverter::getLeavePorts() const
 }
 /** @endcond */
 
+/** @cond doxygenLibsbmlInternal */
+bool
+CompFlatteningConverter::getInstantiateSubmodelsIndependently() const
+{
+  if (getProperties() == NULL)
+  {
+    return false;
+  }
+  else if (getProperties()->hasOption("instantiateSubmodelsIndependently") == false)
+  {
+    return false;
+  }
+  else
+  {
+    return getProperties()->getBoolValue("instantiateSubmodelsIndependently");
+  }
+}
+/** @endcond */
+
 /** @cond doxygenLibsbmlInternal */
 bool
 CompFlatteningConverter::getLeaveDefinitions() const
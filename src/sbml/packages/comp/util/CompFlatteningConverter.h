@@ -182,6 +182,17 @@
  *     "leavePorts" is set to @c "true", any Port objects not referenced by any
  *     Replacement or Deletion will be left in the resulting flattened Model.
  *
+ * @li @em "instantiateSubmodelsIndependently": if this option is set to
+ *     @c "false" (the default), flattening stops at the first Submodel that
+ *     cannot be instantiated.  If it is set to @c "true", the Submodel
+ *     objects of the main Model are instantiated as independent tasks:
+ *     every one of them is instantiated whatever happens to the others,
+ *     each with an error log of its own, and the logs are appended to the
+ *     log of the document in the order of the submodels.  The errors of
+ *     every submodel that fails are then reported before the conversion
+ *     returns failure.  This is mostly useful together with
+ *     @em "performValidation" set to @c "false".
+ *
  * @li @em "listModelDefinitions": If this option is set to @c "false" (the
  *     default), no ModelDefinition or ExternalModelDefinition objects will
  *     be present in the flattened SBMLDocument.  If @em "listModelDefinitions"
@@ -480,6 +491,10 @@ writer.writeSBML(doc, args[1]);
  * <li> @em "performValidation": Possible values are @c "true" (the default)
  * or @c "false".  Controls whether whether libSBML validates the model
  * before attempting to flatten it.
+ *
+ * <li> @em "instantiateSubmodelsIndependently": Possible values are
+ * @c "true" or @c "false" (the default).  Controls whether all sibling
+ * submodels are instantiated even if one of them fails.
  * </ul>
  */
 
@@ -636,6 +651,8 @@ private:
 
   bool getLeavePorts() const;
 
+  bool getInstantiateSubmodelsIndependently() const;
+
   bool getLeaveDefinitions() const;
 
   bool getIgnorePackages() const;
@@ -0,0 +1,334 @@
+/**
+ * @file SBMLDocumentCache.cpp
+ * @brief Implementation of SBMLDocumentCache, a cache of resolved external documents.
+ * @author SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML. Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ * 3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ * Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation. A copy of the license agreement is provided in the
+ * file named "LICENSE.txt" included with this software distribution and also
+ * available online as http://sbml.org/software/libsbml/license.html
+ * ------------------------------------------------------------------------ -->
+ */
+
+#ifdef __cplusplus
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined (WIN32) && !defined (CYGWIN)
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+
+#include <windows.h>
+
+#else
+
+#include <pthread.h>
+
+#endif
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#include <sbml/SBMLDocument.h>
+#include <sbml/packages/comp/util/SBMLDocumentCache.h>
+#include <sbml/packages/comp/util/SBMLResolverRegistry.h>
+#include <sbml/packages/comp/util/SBMLUri.h>
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+/** @cond doxygenLibsbmlInternal */
+SBMLDocumentCache* SBMLDocumentCache::mInstance = NULL;
+
+
+/*
+ * Documents on different threads may resolve their external model
+ * definitions through the cache at the same time, so its entries, use
+ * order and statistics, as well as the creation of the cache itself, are
+ * only done with this lock held.  The lock is initialized statically,
+ * since it has to exist before the cache does.
+ */
+#if defined (WIN32) && !defined (CYGWIN)
+static SRWLOCK sCacheLock = SRWLOCK_INIT;
+#else
+static pthread_mutex_t sCacheLock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+
+/*
+ * Holds the lock of the cache for as long as it exists.
+ */
+class CacheLock
+{
+public:
+  CacheLock()
+  {
+#if defined (WIN32) && !defined (CYGWIN)
+    AcquireSRWLockExclusive(&sCacheLock);
+#else
+    pthread_mutex_lock(&sCacheLock);
+#endif
+  }
+
+  ~CacheLock()
+  {
+#if defined (WIN32) && !defined (CYGWIN)
+    ReleaseSRWLockExclusive(&sCacheLock);
+#else
+    pthread_mutex_unlock(&sCacheLock);
+#endif
+  }
+
+private:
+  CacheLock(const CacheLock&);
+  CacheLock& operator=(const CacheLock&);
+};
+/** @endcond */
+
+void 
+SBMLDocumentCache::deleteDocumentCacheInstance()
+{
+  delete SBMLDocumentCache::mInstance;
+  SBMLDocumentCache::mInstance = NULL;
+}
+
+SBMLDocumentCache&
+SBMLDocumentCache::getInstance()
+{
+  CacheLock lock;
+  if (SBMLDocumentCache::mInstance == NULL) 
+  {
+    mInstance = new SBMLDocumentCache();
+    std::atexit(&SBMLDocumentCache::deleteDocumentCacheInstance);
+  }
+  return *mInstance;
+}
+
+
+void
+SBMLDocumentCache::setMaxDocuments(unsigned int maxDocuments)
+{
+  CacheLock lock;
+  mMaxDocuments = maxDocuments;
+  evict(mMaxDocuments);
+}
+
+
+unsigned int
+SBMLDocumentCache::getMaxDocuments() const
+{
+  CacheLock lock;
+  return mMaxDocuments;
+}
+
+
+unsigned int
+SBMLDocumentCache::getNumDocuments() const
+{
+  CacheLock lock;
+  return (unsigned int)mEntries.size();
+}
+
+
+bool
+SBMLDocumentCache::containsDocument(const std::string& resolvedUri) const
+{
+  CacheLock lock;
+  return mEntries.find(resolvedUri) != mEntries.end();
+}
+
+
+void
+SBMLDocumentCache::clear()
+{
+  CacheLock lock;
+  evict(0);
+  mNumHits = 0;
+  mNumMisses = 0;
+}
+
+
+unsigned int
+SBMLDocumentCache::getNumHits() const
+{
+  CacheLock lock;
+  return mNumHits;
+}
+
+
+unsigned int
+SBMLDocumentCache::getNumMisses() const
+{
+  CacheLock lock;
+  return mNumMisses;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+SBMLDocument*
+SBMLDocumentCache::resolve(const std::string& uri, const std::string& baseUri,
+                           const std::string& resolvedUri)
+{
+  const SBMLResolverRegistry& registry = SBMLResolverRegistry::getInstance();
+
+  string stamp;
+  bool enabled;
+  {
+    CacheLock lock;
+
+    enabled = (mMaxDocuments != 0);
+    if (enabled)
+    {
+      stamp = getStamp(resolvedUri);
+
+      map<string, CacheEntry>::iterator it = mEntries.find(resolvedUri);
+      if (it != mEntries.end())
+      {
+        if (it->second.stamp == stamp)
+        {
+          ++mNumHits;
+          mUseOrder.splice(mUseOrder.begin(), mUseOrder, it->second.use);
+          return it->second.document->clone();
+        }
+
+        // the file has changed since it was read
+        remove(resolvedUri);
+      }
+
+      ++mNumMisses;
+    }
+  }
+
+  // the document is read without the lock, so that other threads are not
+  // held up meanwhile
+  SBMLDocument* doc = registry.resolve(uri, baseUri);
+  if (doc == NULL || !enabled)
+  {
+    return doc;
+  }
+
+  // keep a pristine copy, since the caller is free to modify its own
+  SBMLDocument* copy = doc->clone();
+
+  CacheLock lock;
+
+  // the cache may have been disabled, or another thread may have cached
+  // the document, while it was being read
+  if (mMaxDocuments == 0 || mEntries.find(resolvedUri) != mEntries.end())
+  {
+    delete copy;
+    return doc;
+  }
+
+  evict(mMaxDocuments - 1);
+
+  mUseOrder.push_front(resolvedUri);
+
+  CacheEntry entry;
+  entry.document = copy;
+  entry.stamp = stamp;
+  entry.use = mUseOrder.begin();
+  mEntries.insert(make_pair(resolvedUri, entry));
+
+  return doc;
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+SBMLDocumentCache::SBMLDocumentCache()
+  : mEntries()
+  , mUseOrder()
+  , mMaxDocuments(0)
+  , mNumHits(0)
+  , mNumMisses(0)
+{
+}
+
+
+SBMLDocumentCache::~SBMLDocumentCache()
+{
+  evict(0);
+}
+
+
+std::string
+SBMLDocumentCache::getStamp(const std::string& resolvedUri)
+{
+  SBMLUri uri(resolvedUri);
+  if (uri.getScheme() != "file")
+  {
+    return "";
+  }
+
+  struct stat info;
+  if (stat(uri.getPath().c_str(), &info) != 0)
+  {
+    return "";
+  }
+
+  stringstream stamp;
+  stamp << (long)info.st_mtime << ":" << (long)info.st_size;
+  return stamp.str();
+}
+
+
+void
+SBMLDocumentCache::remove(const std::string& resolvedUri)
+{
+  map<string, CacheEntry>::iterator it = mEntries.find(resolvedUri);
+  delete it->second.document;
+  mUseOrder.erase(it->second.use);
+  mEntries.erase(it);
+}
+
+
+void
+SBMLDocumentCache::evict(unsigned int maxDocuments)
+{
+  // the least recently used document is at the back of the use order
+  while (mEntries.size() > maxDocuments)
+  {
+    remove(mUseOrder.back());
+  }
+}
+/** @endcond */
+
+
+LIBSBML_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
@@ -0,0 +1,252 @@
+/**
+ * @file SBMLDocumentCache.h
+ * @brief Definition of SBMLDocumentCache, a cache of resolved external documents.
+ * @author SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML. Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ * 3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ * Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation. A copy of the license agreement is provided in the
+ * file named "LICENSE.txt" included with this software distribution and also
+ * available online as http://sbml.org/software/libsbml/license.html
+ * ------------------------------------------------------------------------ -->
+ *
+ * @class SBMLDocumentCache
+ * @sbmlbrief{comp} Process-wide cache of externally referenced documents.
+ *
+ * @htmlinclude libsbml-facility-only-warning.html
+ *
+ * Every SBMLDocument keeps the documents referenced by its
+ * ExternalModelDefinition objects for as long as it exists, but a new
+ * document has to resolve and read them again, even if another document
+ * already did.  When many composed models refer to the same library of
+ * modules, the same files end up being read over and over.
+ *
+ * The document cache keeps a pristine copy of every document resolved
+ * through the SBMLResolverRegistry for ExternalModelDefinition objects,
+ * keyed by its resolved URI.  A later request for the same URI, from any
+ * document, is answered with a clone of the cached copy instead of reading
+ * the document again; the clone belongs to the requesting document exactly
+ * as a freshly read document would.  For local files the modification time
+ * and size of the file are recorded, and a cached copy of a file that has
+ * changed since it was read is replaced.
+ *
+ * The cache is disabled by default.  It is enabled by giving it a maximum
+ * number of documents with SBMLDocumentCache::setMaxDocuments(@if java
+ * unsigned int@endif); when it is full, the document used least recently
+ * is dropped.  The cache is synchronized, so documents on different
+ * threads may resolve their external model definitions through it at the
+ * same time; a document is read without holding up the other threads.
+ * The SBMLResolverRegistry itself must not be changed meanwhile.
+ *
+ * @see SBMLResolverRegistry
+ */
+
+#ifndef SBMLDocumentCache_h
+#define SBMLDocumentCache_h
+
+
+#include <sbml/common/sbmlfwd.h>
+
+
+#ifdef __cplusplus
+
+#include <list>
+#include <map>
+#include <string>
+
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+
+class LIBSBML_EXTERN SBMLDocumentCache
+{
+public:
+
+  /**
+   * Returns the singleton instance of the document cache.
+   *
+   * @return the singleton for the document cache.
+   */
+  static SBMLDocumentCache& getInstance();
+
+
+  /**
+   * Deletes the static document cache instance, and with it all cached
+   * documents.
+   */
+  static void deleteDocumentCacheInstance();
+
+
+  /**
+   * Sets the maximum number of documents kept by the cache.
+   *
+   * Setting the maximum to @c 0 (the default) disables the cache.  If the
+   * cache holds more documents than the new maximum, the documents used
+   * least recently are dropped.
+   *
+   * @param maxDocuments the maximum number of documents to keep.
+   */
+  void setMaxDocuments(unsigned int maxDocuments);
+
+
+  /**
+   * Returns the maximum number of documents kept by the cache.
+   *
+   * @return the maximum number of documents, @c 0 if the cache is
+   * disabled.
+   */
+  unsigned int getMaxDocuments() const;
+
+
+  /**
+   * Returns the number of documents currently held by the cache.
+   *
+   * @return the number of cached documents.
+   */
+  unsigned int getNumDocuments() const;
+
+
+  /**
+   * Predicate returning @c true if the cache holds a document for the
+   * given resolved URI.
+   *
+   * @param resolvedUri the resolved URI of the document.
+   *
+   * @return @c true if a document is cached for the URI, @c false
+   * otherwise.
+   */
+  bool containsDocument(const std::string& resolvedUri) const;
+
+
+  /**
+   * Drops all cached documents and resets the statistics of the cache.
+   */
+  void clear();
+
+
+  /**
+   * Returns the number of requests answered from the cache since it was
+   * last cleared.
+   *
+   * @return the number of cache hits.
+   */
+  unsigned int getNumHits() const;
+
+
+  /**
+   * Returns the number of requests for which the document had to be read
+   * since the cache was last cleared.
+   *
+   * @return the number of cache misses.
+   */
+  unsigned int getNumMisses() const;
+
+
+  /** @cond doxygenLibsbmlInternal */
+  /**
+   * Resolves the document for the given URI through the
+   * SBMLResolverRegistry, or from the cache if a current copy is held.
+   *
+   * @param uri the URI to the target document.
+   * @param baseUri base URI, in case the URI is a relative one.
+   * @param resolvedUri the resolved form of @p uri.
+   *
+   * @return a new document owned by the caller, or @c NULL if the
+   * document could not be resolved.
+   */
+  SBMLDocument* resolve(const std::string& uri, const std::string& baseUri,
+                        const std::string& resolvedUri);
+  /** @endcond */
+
+
+  /**
+   * Destructor.
+   */
+  virtual ~SBMLDocumentCache();
+
+
+protected:
+
+  /** @cond doxygenLibsbmlInternal */
+  /**
+   * protected constructor, use the getInstance() method to access the cache.
+   */
+  SBMLDocumentCache();
+
+
+  /*
+   * Returns a string identifying the current state of the file behind the
+   * given resolved URI (its modification time and size), or an empty
+   * string if the URI does not refer to a readable local file.
+   */
+  static std::string getStamp(const std::string& resolvedUri);
+
+
+  /*
+   * Drops the least recently used documents until at most the given
+   * number remain.
+   */
+  void evict(unsigned int maxDocuments);
+
+
+  /*
+   * Each entry records its position in mUseOrder, the resolved URIs of
+   * the cached documents from the most to the least recently used.
+   */
+  struct CacheEntry
+  {
+    SBMLDocument* document;
+    std::string stamp;
+    std::list<std::string>::iterator use;
+  };
+
+
+  /*
+   * Deletes the document for the given resolved URI and removes it from
+   * the cache.
+   */
+  void remove(const std::string& resolvedUri);
+
+  std::map<std::string, CacheEntry> mEntries;
+  std::list<std::string> mUseOrder;
+  unsigned int mMaxDocuments;
+  unsigned int mNumHits;
+  unsigned int mNumMisses;
+
+  static SBMLDocumentCache* mInstance;
+  /** @endcond */
+};
+
+LIBSBML_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+#endif  /* SBMLDocumentCache_h */
@@ -130,6 +130,93 @@ START_TEST(test_comp_flatten_invalid2)
 }
 END_TEST
 
+static SBMLDocument*
+createDocumentWithTwoMissingModels()
+{
+  SBMLNamespaces sbmlns(3,1,"comp",1);
+  SBMLDocument *document = new SBMLDocument(&sbmlns);
+  CompSBMLDocumentPlugin* compdoc = 
+           static_cast<CompSBMLDocumentPlugin*>(document->getPlugin("comp"));
+  compdoc->setRequired(true);
+
+  Model* model=document->createModel();
+  CompModelPlugin* mplugin = 
+           static_cast<CompModelPlugin*>(model->getPlugin("comp"));
+
+  Submodel* submod = mplugin->createSubmodel();
+  submod->setId("submod1");
+  submod->setModelRef("Mod1");
+
+  submod = mplugin->createSubmodel();
+  submod->setId("submod2");
+  submod->setModelRef("Mod2");
+
+  return document;
+}
+
+START_TEST(test_comp_flatten_independent_submodels)
+{
+  ConversionProperties props;
+  props.addOption("flatten comp");
+  props.addOption("performValidation", false);
+  SBMLConverter* converter = 
+    SBMLConverterRegistry::getInstance().getConverterFor(props);
+
+  // by default, flattening stops at the first failure
+  SBMLDocument* document = createDocumentWithTwoMissingModels();
+  converter->setDocument(document);
+  fail_unless(converter->convert() == LIBSBML_OPERATION_FAILED);
+  fail_unless(document->getErrorLog()->getNumErrors() == 2);
+  fail_unless(document->getModel()->getNumPlugins() > 0);
+  delete document;
+  delete converter;
+
+  props.addOption("instantiateSubmodelsIndependently", true);
+  converter = SBMLConverterRegistry::getInstance().getConverterFor(props);
+
+  // with independent instantiation, both failures are reported after the
+  // errors logged before, in the order of the submodels
+  document = createDocumentWithTwoMissingModels();
+  converter->setDocument(document);
+  fail_unless(converter->convert() == LIBSBML_OPERATION_FAILED);
+
+  SBMLErrorLog* errors = document->getErrorLog();
+  fail_unless(errors->getNumErrors() == 3);
+  fail_unless(errors->getError(0)->getErrorId() == CompModelFlatteningFailed);
+  fail_unless(errors->getError(1)->getErrorId() == CompSubmodelMustReferenceModel);
+  fail_unless(errors->getError(1)->getMessage().find("'submod1'") != string::npos);
+  fail_unless(errors->getError(2)->getErrorId() == CompSubmodelMustReferenceModel);
+  fail_unless(errors->getError(2)->getMessage().find("'submod2'") != string::npos);
+
+  // the option does not stick to the document
+  CompModelPlugin* mplugin = 
+    static_cast<CompModelPlugin*>(document->getModel()->getPlugin("comp"));
+  fail_unless(mplugin->getInstantiateSubmodelsIndependently() == false);
+  delete document;
+
+  // once the models exist, the document is flattened as usual
+  document = createDocumentWithTwoMissingModels();
+  CompSBMLDocumentPlugin* compdoc =
+    static_cast<CompSBMLDocumentPlugin*>(document->getPlugin("comp"));
+  for (unsigned int n = 1; n <= 2; n++)
+  {
+    ModelDefinition* definition = compdoc->createModelDefinition();
+    definition->setId(n == 1 ? "Mod1" : "Mod2");
+    Parameter* parameter = definition->createParameter();
+    parameter->setId("p");
+    parameter->setConstant(true);
+  }
+  converter->setDocument(document);
+  fail_unless(converter->convert() == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(document->getModel()->getNumParameters() == 2);
+  fail_unless(document->getModel()->getParameter("submod1__p") != NULL);
+  fail_unless(document->getModel()->getParameter("submod2__p") != NULL);
+
+  delete document;
+  delete converter;
+}
+END_TEST
+
 START_TEST(test_comp_flatten_invalid3)
 {
   ConversionProperties props;
@@ -3837,6 +3924,7 @@ create_suite_TestFlatteningErrorMessages (void)
 
   tcase_add_test(tcase, test_comp_flatten_invalid);
   tcase_add_test(tcase, test_comp_flatten_invalid2);
+  tcase_add_test(tcase, test_comp_flatten_independent_submodels);
   tcase_add_test(tcase, test_comp_flatten_invalid3);
   tcase_add_test(tcase, test_comp_flatten_invalid4);
   tcase_add_test(tcase, test_comp_flatten_invalid5);
@@ -37,6 +37,9 @@
 #include <sbml/packages/comp/extension/CompSBMLDocumentPlugin.h>
 #include <sbml/packages/comp/validator/CompSBMLErrorTable.h>
 #include <sbml/packages/comp/sbml/ExternalModelDefinition.h>
+#include <sbml/packages/comp/util/SBMLDocumentCache.h>
+#include <sbml/conversion/ConversionProperties.h>
+#include <sbml/conversion/SBMLConverterRegistry.h>
 #include <sbml/SBMLReader.h>
 
 #include <check.h>
@@ -115,6 +118,142 @@ START_TEST (test_comp_externalmodelresolving_files)
 END_TEST
 
 
+static string
+flattenToString(const string& fileName)
+{
+  SBMLDocument* document = readSBMLFromFile(fileName.c_str());
+
+  ConversionProperties props;
+  props.addOption("flatten comp");
+  props.addOption("performValidation", false);
+  document->convert(props);
+
+  char* str = writeSBMLToString(document);
+  string result(str);
+  safe_free(str);
+  delete document;
+  return result;
+}
+
+
+static Model*
+resolveSource(SBMLDocument* document, const string& source)
+{
+  CompSBMLDocumentPlugin* compdoc = 
+    static_cast<CompSBMLDocumentPlugin*>(document->getPlugin("comp"));
+  ExternalModelDefinition* extdef = compdoc->createExternalModelDefinition();
+  extdef->setId("ext");
+  extdef->setSource(source);
+  return extdef->getReferencedModel();
+}
+
+
+/*
+ * Returns the directory for files written by the tests, so that they do
+ * not end up among the test data.
+ */
+static string
+getTempDirectory()
+{
+  const char* names[] = { "TMPDIR", "TMP", "TEMP" };
+  for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+  {
+    const char* dir = getenv(names[i]);
+    if (dir != NULL && *dir != '\0')
+    {
+      return string(dir) + "/";
+    }
+  }
+  return "/tmp/";
+}
+
+
+static void
+writeModule(const string& fileName, unsigned int numParameters)
+{
+  SBMLDocument module(3, 1);
+  Model* model = module.createModel();
+  model->setId("module");
+  for (unsigned int i = 0; i < numParameters; ++i)
+  {
+    Parameter* p = model->createParameter();
+    p->setId("p" + string(1, (char)('a' + i)));
+    p->setConstant(true);
+  }
+  writeSBMLToFile(&module, fileName.c_str());
+}
+
+
+START_TEST (test_comp_externalmodelresolving_cache)
+{ 
+  string dir(TestDataDirectory);
+  SBMLDocumentCache& cache = SBMLDocumentCache::getInstance();
+  cache.clear();
+  fail_unless(cache.getMaxDocuments() == 0);
+
+  // disabled by default
+  string uncached = flattenToString(dir + "eg-import-external.xml");
+  fail_unless(cache.getNumDocuments() == 0);
+  fail_unless(cache.getNumMisses() == 0);
+
+  cache.setMaxDocuments(4);
+
+  // the second document is served from the cache, with the same result
+  fail_unless(flattenToString(dir + "eg-import-external.xml") == uncached);
+  unsigned int misses = cache.getNumMisses();
+  fail_unless(misses > 0);
+  fail_unless(cache.getNumHits() == 0);
+  fail_unless(flattenToString(dir + "eg-import-external.xml") == uncached);
+  fail_unless(cache.getNumMisses() == misses);
+  fail_unless(cache.getNumHits() == misses);
+
+  // a file changed since it was cached is read again
+  string tempDir = getTempDirectory();
+  string moduleFile = tempDir + "cache_module_temp.xml";
+  writeModule(moduleFile, 1);
+
+  SBMLNamespaces sbmlns(3,1,"comp",1);
+  SBMLDocument* document = new SBMLDocument(&sbmlns);
+  document->setLocationURI("file:" + tempDir + "test.xml");
+  Model* model = resolveSource(document, "cache_module_temp.xml");
+  fail_unless(model != NULL);
+  fail_unless(model->getNumParameters() == 1);
+  delete document;
+
+  misses = cache.getNumMisses();
+  writeModule(moduleFile, 3);
+
+  document = new SBMLDocument(&sbmlns);
+  document->setLocationURI("file:" + tempDir + "test.xml");
+  model = resolveSource(document, "cache_module_temp.xml");
+  fail_unless(model != NULL);
+  fail_unless(model->getNumParameters() == 3);
+  fail_unless(cache.getNumMisses() == misses + 1);
+
+  // the copy handed out is independent of the cached one
+  model->removeParameter(0);
+  delete document;
+
+  document = new SBMLDocument(&sbmlns);
+  document->setLocationURI("file:" + tempDir + "test.xml");
+  model = resolveSource(document, "cache_module_temp.xml");
+  fail_unless(model->getNumParameters() == 3);
+  fail_unless(cache.getNumMisses() == misses + 1);
+  delete document;
+
+  // shrinking the cache drops documents
+  fail_unless(cache.getNumDocuments() > 1);
+  cache.setMaxDocuments(1);
+  fail_unless(cache.getNumDocuments() == 1);
+
+  cache.setMaxDocuments(0);
+  cache.clear();
+  fail_unless(cache.getNumDocuments() == 0);
+  remove(moduleFile.c_str());
+}
+END_TEST
+
+
 Suite *
 create_suite_TestExternalModelResolving (void)
 { 
@@ -123,6 +262,7 @@ create_suite_TestExternalModelResolving (void)
   
   tcase_add_test(tcase, test_comp_externalmodelresolving_);
   tcase_add_test(tcase, test_comp_externalmodelresolving_files);
+  tcase_add_test(tcase, test_comp_externalmodelresolving_cache);
   suite_add_tcase(suite, tcase);
 
   return suite;
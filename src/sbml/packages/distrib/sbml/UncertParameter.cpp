@@ -790,6 +790,18 @@ UncertParameter::renameSIdRefs(const std::string& oldid,
   }
 }
 
+
+void
+UncertParameter::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  DistribBase::renameSIdRefs(renames);
+  renameIdRef(mVar, renames);
+  if (isSetMath())
+  {
+    mMath->renameSIdRefs(renames);
+  }
+}
+
 void
 UncertParameter::renameUnitSIdRefs(const std::string& oldid, const std::string& newid)
 {
@@ -806,6 +818,18 @@ UncertParameter::renameUnitSIdRefs(const std::string& oldid, const std::string&
     }
 }
 
+
+void
+UncertParameter::renameUnitSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  DistribBase::renameUnitSIdRefs(renames);
+  renameIdRef(mUnits, renames);
+  if (isSetMath())
+  {
+    mMath->renameUnitSIdRefs(renames);
+  }
+}
+
 /** @cond doxygenLibsbmlInternal */
 void
 UncertParameter::replaceSIDWithFunction(const std::string& id, const ASTNode* function)
@@ -387,6 +387,18 @@ UncertSpan::renameSIdRefs(const std::string& oldid, const std::string& newid)
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+UncertSpan::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  UncertParameter::renameSIdRefs(renames);
+  renameIdRef(mVarLower, renames);
+  renameIdRef(mVarUpper, renames);
+}
+
+
 /*
  * Returns the XML element name of this UncertSpan object.
  */
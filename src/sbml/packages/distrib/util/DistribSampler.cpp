@@ -0,0 +1,924 @@
+/**
+ * @file    DistribSampler.cpp
+ * @brief   Implementation of DistribSampler, which draws realizations of the
+ *          values that distrib distributions give a model.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ */
+
+#include <sbml/packages/distrib/util/DistribSampler.h>
+#include <sbml/packages/distrib/extension/DistribSBasePlugin.h>
+#include <sbml/packages/distrib/sbml/Uncertainty.h>
+#include <sbml/packages/distrib/sbml/UncertParameter.h>
+
+#include <sbml/Model.h>
+#include <sbml/InitialAssignment.h>
+#include <sbml/math/ASTNode.h>
+#include <sbml/util/ElementFilter.h>
+#include <sbml/util/List.h>
+#include <sbml/util/util.h>
+
+#ifdef __cplusplus
+
+#include <cmath>
+#include <set>
+
+using namespace std;
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+/** @cond doxygenLibsbmlInternal */
+
+// the number of draws of a truncated distribution before giving up
+static const unsigned int MAX_TRUNCATED_DRAWS = 10000;
+
+static const double PI = 3.14159265358979323846;
+
+
+static bool
+isDistribution(ASTNodeType_t type)
+{
+  return type >= AST_DISTRIB_FUNCTION_NORMAL
+      && type <= AST_DISTRIB_FUNCTION_RAYLEIGH;
+}
+
+
+static bool
+containsDistribution(const ASTNode* math)
+{
+  if (math == NULL)
+  {
+    return false;
+  }
+
+  vector<const ASTNode*> stack;
+  stack.push_back(math);
+  while (!stack.empty())
+  {
+    const ASTNode* node = stack.back();
+    stack.pop_back();
+    if (isDistribution(node->getType()))
+    {
+      return true;
+    }
+    for (unsigned int i = 0; i < node->getNumChildren(); ++i)
+    {
+      stack.push_back(node->getChild(i));
+    }
+  }
+  return false;
+}
+
+
+/*
+ * The number of arguments of a distribution that is not truncated.
+ */
+static unsigned int
+getNumBaseArguments(ASTNodeType_t type, unsigned int numChildren)
+{
+  switch (type)
+  {
+  case AST_DISTRIB_FUNCTION_BERNOULLI:
+  case AST_DISTRIB_FUNCTION_CHISQUARE:
+  case AST_DISTRIB_FUNCTION_EXPONENTIAL:
+  case AST_DISTRIB_FUNCTION_POISSON:
+  case AST_DISTRIB_FUNCTION_RAYLEIGH:
+    return 1;
+  case AST_DISTRIB_FUNCTION_CAUCHY:
+  case AST_DISTRIB_FUNCTION_LAPLACE:
+    // the form with only a scale
+    return (numChildren == 1) ? 1 : 2;
+  default:
+    return 2;
+  }
+}
+
+
+/*
+ * The random numbers of one variable in one realization, generated by
+ * Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2,
+ * 3", 2011) from the counter (realization, variable, block, 0).
+ */
+class PhiloxStream
+{
+public:
+
+  PhiloxStream(unsigned long seed, unsigned int realization,
+               unsigned int variable)
+    : mRealization(realization)
+    , mVariable(variable)
+    , mBlock(0)
+    , mNumBuffered(0)
+  {
+    mKey[0] = (unsigned int)(seed & 0xFFFFFFFFUL);
+    // in two steps, as unsigned long may be 32 bits wide
+    mKey[1] = (unsigned int)(((seed >> 16) >> 16) & 0xFFFFFFFFUL);
+  }
+
+
+  static void generate(const unsigned int counter[4], const unsigned int key[2],
+                       unsigned int result[4])
+  {
+    unsigned int c[4] = { counter[0], counter[1], counter[2], counter[3] };
+    unsigned int k0 = key[0];
+    unsigned int k1 = key[1];
+
+    for (unsigned int round = 0; round < 10; ++round)
+    {
+      if (round > 0)
+      {
+        k0 += 0x9E3779B9U;
+        k1 += 0xBB67AE85U;
+      }
+      unsigned long long p0 = (unsigned long long)(0xD2511F53U) * c[0];
+      unsigned long long p1 = (unsigned long long)(0xCD9E8D57U) * c[2];
+      unsigned int hi0 = (unsigned int)(p0 >> 32);
+      unsigned int lo0 = (unsigned int)(p0);
+      unsigned int hi1 = (unsigned int)(p1 >> 32);
+      unsigned int lo1 = (unsigned int)(p1);
+
+      c[0] = hi1 ^ c[1] ^ k0;
+      c[1] = lo1;
+      c[2] = hi0 ^ c[3] ^ k1;
+      c[3] = lo0;
+    }
+
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+      result[i] = c[i];
+    }
+  }
+
+
+  /*
+   * Returns a uniform number in (0, 1), with 53 random bits.
+   */
+  double uniform()
+  {
+    if (mNumBuffered == 0)
+    {
+      unsigned int counter[4] = { mRealization, mVariable, mBlock, 0 };
+      unsigned int words[4];
+      generate(counter, mKey, words);
+      ++mBlock;
+
+      for (unsigned int i = 0; i < 2; ++i)
+      {
+        double high = (double)(words[2 * i] >> 5);
+        double low = (double)(words[2 * i + 1] >> 6);
+        mBuffer[1 - i] = (high * 67108864.0 + low + 0.5) / 9007199254740992.0;
+      }
+      mNumBuffered = 2;
+    }
+    return mBuffer[--mNumBuffered];
+  }
+
+
+  double normal()
+  {
+    double u1 = uniform();
+    double u2 = uniform();
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * PI * u2);
+  }
+
+
+  /*
+   * Marsaglia and Tsang, "A simple method for generating gamma variables",
+   * 2000, with scale 1.
+   */
+  double gamma(double shape)
+  {
+    if (shape < 1.0)
+    {
+      double boost = pow(uniform(), 1.0 / shape);
+      return gamma(shape + 1.0) * boost;
+    }
+
+    double d = shape - 1.0 / 3.0;
+    double c = 1.0 / sqrt(9.0 * d);
+    while (true)
+    {
+      double x = normal();
+      double v = 1.0 + c * x;
+      if (v <= 0.0)
+      {
+        continue;
+      }
+      v = v * v * v;
+      double u = uniform();
+      if (u < 1.0 - 0.0331 * x * x * x * x
+        || log(u) < 0.5 * x * x + d * (1.0 - v + log(v)))
+      {
+        return d * v;
+      }
+    }
+  }
+
+
+  /*
+   * Knuth, The Art of Computer Programming, volume 2, 3.4.1 F: the number of
+   * successes among n is split with a beta variate until few are left.
+   */
+  double binomial(double n, double p)
+  {
+    double result = 0;
+    while (n > 16)
+    {
+      double a = 1.0 + floor(n / 2.0);
+      double b = n + 1.0 - a;
+      double ga = gamma(a);
+      double x = ga / (ga + gamma(b));
+      if (x >= p)
+      {
+        n = a - 1.0;
+        p = p / x;
+      }
+      else
+      {
+        result += a;
+        n = b - 1.0;
+        p = (p - x) / (1.0 - x);
+      }
+    }
+    for (unsigned int i = 0; i < (unsigned int)(n); ++i)
+    {
+      if (uniform() < p)
+      {
+        result += 1;
+      }
+    }
+    return result;
+  }
+
+
+  /*
+   * Knuth, The Art of Computer Programming, volume 2, 3.4.1 F: large means
+   * are reduced with gamma and binomial variates.
+   */
+  double poisson(double mean)
+  {
+    double result = 0;
+    while (mean > 16)
+    {
+      double m = floor(mean * 7.0 / 8.0);
+      double x = gamma(m);
+      if (x >= mean)
+      {
+        return result + binomial(m - 1.0, mean / x);
+      }
+      result += m;
+      mean -= x;
+    }
+
+    double limit = exp(-mean);
+    double product = uniform();
+    while (product > limit)
+    {
+      result += 1;
+      product *= uniform();
+    }
+    return result;
+  }
+
+
+protected:
+
+  unsigned int mKey[2];
+  unsigned int mRealization;
+  unsigned int mVariable;
+  unsigned int mBlock;
+
+  double mBuffer[2];
+  unsigned int mNumBuffered;
+};
+
+
+/*
+ * Draws a value of a distribution that is not truncated; NaN if its
+ * arguments are not valid.
+ */
+static double
+drawDistribution(PhiloxStream& stream, ASTNodeType_t type,
+                 const double* args, unsigned int numArgs)
+{
+  for (unsigned int i = 0; i < numArgs; ++i)
+  {
+    if (util_isNaN(args[i]) || util_isInf(args[i]) != 0)
+    {
+      return util_NaN();
+    }
+  }
+
+  switch (type)
+  {
+  case AST_DISTRIB_FUNCTION_NORMAL:
+    if (args[1] < 0) break;
+    return args[0] + args[1] * stream.normal();
+
+  case AST_DISTRIB_FUNCTION_UNIFORM:
+    if (args[1] < args[0]) break;
+    return args[0] + (args[1] - args[0]) * stream.uniform();
+
+  case AST_DISTRIB_FUNCTION_BERNOULLI:
+    if (args[0] < 0 || args[0] > 1) break;
+    return (stream.uniform() < args[0]) ? 1 : 0;
+
+  case AST_DISTRIB_FUNCTION_BINOMIAL:
+    if (args[0] < 0 || args[1] < 0 || args[1] > 1) break;
+    return stream.binomial(floor(args[0]), args[1]);
+
+  case AST_DISTRIB_FUNCTION_CAUCHY:
+  {
+    double location = (numArgs == 1) ? 0 : args[0];
+    double scale = args[numArgs - 1];
+    if (scale <= 0) break;
+    return location + scale * tan(PI * (stream.uniform() - 0.5));
+  }
+
+  case AST_DISTRIB_FUNCTION_CHISQUARE:
+    if (args[0] <= 0) break;
+    return 2.0 * stream.gamma(args[0] / 2.0);
+
+  case AST_DISTRIB_FUNCTION_EXPONENTIAL:
+    if (args[0] <= 0) break;
+    return -log(stream.uniform()) / args[0];
+
+  case AST_DISTRIB_FUNCTION_GAMMA:
+    if (args[0] <= 0 || args[1] <= 0) break;
+    return args[1] * stream.gamma(args[0]);
+
+  case AST_DISTRIB_FUNCTION_LAPLACE:
+  {
+    double location = (numArgs == 1) ? 0 : args[0];
+    double scale = args[numArgs - 1];
+    if (scale <= 0) break;
+    double u = stream.uniform() - 0.5;
+    return (u < 0) ? location + scale * log(1.0 + 2.0 * u)
+                   : location - scale * log(1.0 - 2.0 * u);
+  }
+
+  case AST_DISTRIB_FUNCTION_LOGNORMAL:
+    if (args[1] < 0) break;
+    return exp(args[0] + args[1] * stream.normal());
+
+  case AST_DISTRIB_FUNCTION_POISSON:
+    if (args[0] < 0) break;
+    return stream.poisson(args[0]);
+
+  case AST_DISTRIB_FUNCTION_RAYLEIGH:
+    if (args[0] <= 0) break;
+    return args[0] * sqrt(-2.0 * log(stream.uniform()));
+
+  default:
+    break;
+  }
+
+  return util_NaN();
+}
+
+
+/*
+ * Draws a value of a distribution, truncated to the last two of the
+ * arguments if it has them.
+ */
+static double
+drawTruncated(PhiloxStream& stream, ASTNodeType_t type,
+              const vector<double>& args)
+{
+  unsigned int numArgs = (unsigned int)(args.size());
+  unsigned int numBase = getNumBaseArguments(type, numArgs);
+  if (numArgs == 0 || numArgs < numBase)
+  {
+    return util_NaN();
+  }
+
+  if (numArgs < numBase + 2)
+  {
+    return drawDistribution(stream, type, &args[0], numBase);
+  }
+
+  double min = args[numBase];
+  double max = args[numBase + 1];
+  if (util_isNaN(min) || util_isNaN(max) || max < min)
+  {
+    return util_NaN();
+  }
+
+  for (unsigned int i = 0; i < MAX_TRUNCATED_DRAWS; ++i)
+  {
+    double value = drawDistribution(stream, type, &args[0], numBase);
+    if (util_isNaN(value))
+    {
+      return value;
+    }
+    if (value >= min && value <= max)
+    {
+      return value;
+    }
+  }
+  return util_NaN();
+}
+
+
+/*
+ * Selects the elements with an id that have an uncertainty.
+ */
+class UncertaintyFilter : public ElementFilter
+{
+public:
+
+  UncertaintyFilter() : ElementFilter() {}
+
+  virtual bool filter(const SBase* element)
+  {
+    if (element == NULL || !element->isSetIdAttribute())
+    {
+      return false;
+    }
+    const DistribSBasePlugin* plugin =
+      dynamic_cast<const DistribSBasePlugin*>(element->getPlugin("distrib"));
+    return plugin != NULL && plugin->getNumUncertainties() > 0;
+  }
+};
+
+/** @endcond */
+
+
+DistribSampler::DistribSampler(const Model* model, unsigned long seed)
+  : mModel(model)
+  , mSeed(seed)
+  , mNumRealizations(0)
+{
+  if (mModel == NULL)
+  {
+    return;
+  }
+
+  SBMLTransforms::getComponentValuesForModel(mModel, mValues);
+
+  for (unsigned int i = 0; i < mModel->getNumInitialAssignments(); ++i)
+  {
+    const InitialAssignment* ia = mModel->getInitialAssignment(i);
+    if (ia->isSetSymbol() && containsDistribution(ia->getMath()))
+    {
+      addVariable(ia->getSymbol(), ia->getMath());
+    }
+  }
+
+  UncertaintyFilter filter;
+  List* elements = const_cast<Model*>(mModel)->getAllElements(&filter);
+  for (ListIterator it = elements->begin(); it != elements->end(); ++it)
+  {
+    const SBase* element = static_cast<const SBase*>(*it);
+    const DistribSBasePlugin* plugin =
+      static_cast<const DistribSBasePlugin*>(element->getPlugin("distrib"));
+
+    for (unsigned int n = 0; n < plugin->getNumUncertainties(); ++n)
+    {
+      const UncertParameter* param = plugin->getUncertainty(n)
+        ->getUncertParameterByType(DISTRIB_UNCERTTYPE_DISTRIBUTION);
+      if (param != NULL && containsDistribution(param->getMath()))
+      {
+        addVariable(element->getIdAttribute(), param->getMath());
+        break;
+      }
+    }
+  }
+  delete elements;
+
+  orderVariables();
+}
+
+
+DistribSampler::~DistribSampler()
+{
+  for (unsigned int i = 0; i < mVariables.size(); ++i)
+  {
+    Variable& variable = mVariables[i];
+    for (unsigned int n = 0; n < variable.draws.size(); ++n)
+    {
+      delete variable.draws[n].call;
+    }
+    delete variable.math;
+  }
+}
+
+
+const Model*
+DistribSampler::getModel() const
+{
+  return mModel;
+}
+
+
+unsigned long
+DistribSampler::getSeed() const
+{
+  return mSeed;
+}
+
+
+void
+DistribSampler::setSeed(unsigned long seed)
+{
+  mSeed = seed;
+}
+
+
+unsigned int
+DistribSampler::getNumVariables() const
+{
+  return (unsigned int)(mVariables.size());
+}
+
+
+std::string
+DistribSampler::getVariable(unsigned int n) const
+{
+  if (n >= mVariables.size())
+  {
+    return "";
+  }
+  return mVariables[n].id;
+}
+
+
+int
+DistribSampler::getVariableIndex(const std::string& id) const
+{
+  map<string, unsigned int>::const_iterator it = mIndices.find(id);
+  if (it == mIndices.end())
+  {
+    return -1;
+  }
+  return (int)(it->second);
+}
+
+
+int
+DistribSampler::sample(unsigned int numRealizations,
+                       unsigned int firstRealization)
+{
+  if (mModel == NULL)
+  {
+    return LIBSBML_INVALID_OBJECT;
+  }
+
+  unsigned int numVariables = getNumVariables();
+  mSamples.assign((size_t)(numRealizations) * numVariables, util_NaN());
+  mNumRealizations = numRealizations;
+
+  // the variables that depend on no other are drawn a column at a time,
+  // those that do a realization at a time, after their dependencies
+  vector<unsigned int> dependent;
+  for (unsigned int v = 0; v < numVariables; ++v)
+  {
+    Variable& variable = mVariables[v];
+    if (!variable.dependencies.empty())
+    {
+      dependent.push_back(v);
+      continue;
+    }
+
+    double* column = mSamples.empty() ? NULL : &mSamples[v];
+    for (unsigned int r = 0; r < numRealizations; ++r)
+    {
+      column[(size_t)(r) * numVariables] =
+        drawValue(variable, firstRealization + r, v);
+    }
+  }
+
+  if (dependent.empty())
+  {
+    return LIBSBML_OPERATION_SUCCESS;
+  }
+
+  for (unsigned int r = 0; r < numRealizations; ++r)
+  {
+    double* row = &mSamples[(size_t)(r) * numVariables];
+    for (unsigned int i = 0; i < dependent.size(); ++i)
+    {
+      unsigned int v = dependent[i];
+      Variable& variable = mVariables[v];
+      for (unsigned int d = 0; d < variable.dependencies.size(); ++d)
+      {
+        unsigned int dependency = variable.dependencies[d];
+        mValues[mVariables[dependency].id] =
+          make_pair(row[dependency], true);
+      }
+      row[v] = drawValue(variable, firstRealization + r, v);
+    }
+  }
+
+  return LIBSBML_OPERATION_SUCCESS;
+}
+
+
+unsigned int
+DistribSampler::getNumRealizations() const
+{
+  return mNumRealizations;
+}
+
+
+const double*
+DistribSampler::getSamples() const
+{
+  if (mSamples.empty())
+  {
+    return NULL;
+  }
+  return &mSamples[0];
+}
+
+
+double
+DistribSampler::getSample(unsigned int realization,
+                          unsigned int variable) const
+{
+  if (realization >= mNumRealizations || variable >= mVariables.size())
+  {
+    return util_NaN();
+  }
+  return mSamples[(size_t)(realization) * mVariables.size() + variable];
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+
+void
+DistribSampler::addVariable(const std::string& id, const ASTNode* math)
+{
+  // an initial assignment comes first and wins over an uncertainty
+  for (unsigned int i = 0; i < mVariables.size(); ++i)
+  {
+    if (mVariables[i].id == id)
+    {
+      return;
+    }
+  }
+
+  mVariables.push_back(Variable());
+  Variable& variable = mVariables.back();
+  variable.id = id;
+  variable.math = math->deepCopy();
+  prepareDraws(variable);
+}
+
+
+/*
+ * Takes each call of a distribution out of the math of the variable,
+ * innermost first, and records the names the math refers to.
+ */
+void
+DistribSampler::prepareDraws(Variable& variable)
+{
+  set<string> names;
+
+  // pairs of a node and the number of its children already visited
+  vector<pair<ASTNode*, unsigned int> > stack;
+  stack.push_back(make_pair(variable.math, 0U));
+  while (!stack.empty())
+  {
+    ASTNode* node = stack.back().first;
+    unsigned int next = stack.back().second;
+    if (next < node->getNumChildren())
+    {
+      ++stack.back().second;
+      stack.push_back(make_pair(node->getChild(next), 0U));
+      continue;
+    }
+    stack.pop_back();
+
+    if (node->getType() == AST_NAME && node->getName() != NULL)
+    {
+      names.insert(node->getName());
+    }
+
+    if (!isDistribution(node->getType()))
+    {
+      continue;
+    }
+
+    Draw draw;
+    draw.type = node->getType();
+    draw.call = node;
+    draw.value = new ASTNode(AST_REAL);
+    draw.value->setValue(0.0);
+    draw.constantArgs = false;
+
+    if (stack.empty())
+    {
+      variable.math = draw.value;
+    }
+    else
+    {
+      ASTNode* parent = stack.back().first;
+      // the child just visited
+      parent->replaceChild(stack.back().second - 1, draw.value, false);
+    }
+    variable.draws.push_back(draw);
+  }
+
+  variable.names.assign(names.begin(), names.end());
+}
+
+
+/*
+ * Orders the variables so that each comes after those its math refers to;
+ * the variables of a cycle keep the order of the model.
+ */
+void
+DistribSampler::orderVariables()
+{
+  unsigned int numVariables = getNumVariables();
+
+  map<string, unsigned int> indices;
+  for (unsigned int i = 0; i < numVariables; ++i)
+  {
+    indices[mVariables[i].id] = i;
+  }
+
+  vector<vector<unsigned int> > uses(numVariables);
+  vector<unsigned int> numPending(numVariables, 0);
+  for (unsigned int i = 0; i < numVariables; ++i)
+  {
+    const vector<string>& names = mVariables[i].names;
+    for (unsigned int n = 0; n < names.size(); ++n)
+    {
+      map<string, unsigned int>::const_iterator it = indices.find(names[n]);
+      if (it != indices.end() && it->second != i)
+      {
+        uses[it->second].push_back(i);
+        ++numPending[i];
+      }
+    }
+  }
+
+  // the variables ready to be drawn, taken in the order of the model
+  set<unsigned int> ready;
+  for (unsigned int i = 0; i < numVariables; ++i)
+  {
+    if (numPending[i] == 0)
+    {
+      ready.insert(i);
+    }
+  }
+
+  vector<unsigned int> order;
+  vector<bool> placed(numVariables, false);
+  unsigned int firstUnplaced = 0;
+  while (order.size() < numVariables)
+  {
+    unsigned int next;
+    if (!ready.empty())
+    {
+      next = *ready.begin();
+      ready.erase(ready.begin());
+    }
+    else
+    {
+      // all variables left are in a cycle
+      while (placed[firstUnplaced])
+      {
+        ++firstUnplaced;
+      }
+      next = firstUnplaced;
+    }
+
+    placed[next] = true;
+    order.push_back(next);
+
+    const vector<unsigned int>& users = uses[next];
+    for (unsigned int u = 0; u < users.size(); ++u)
+    {
+      unsigned int user = users[u];
+      if (!placed[user] && numPending[user] > 0 && --numPending[user] == 0)
+      {
+        ready.insert(user);
+      }
+    }
+  }
+
+  vector<Variable> ordered(numVariables);
+  for (unsigned int i = 0; i < numVariables; ++i)
+  {
+    ordered[i] = mVariables[order[i]];
+  }
+  mVariables.swap(ordered);
+
+  mIndices.clear();
+  for (unsigned int i = 0; i < numVariables; ++i)
+  {
+    mIndices[mVariables[i].id] = i;
+  }
+
+  for (unsigned int i = 0; i < numVariables; ++i)
+  {
+    Variable& variable = mVariables[i];
+    const vector<string>& names = variable.names;
+    for (unsigned int n = 0; n < names.size(); ++n)
+    {
+      map<string, unsigned int>::const_iterator it = mIndices.find(names[n]);
+      if (it != mIndices.end() && it->second != i)
+      {
+        variable.dependencies.push_back(it->second);
+      }
+    }
+
+    // arguments without variables or earlier draws are evaluated once
+    set<const ASTNode*> values;
+    for (unsigned int d = 0; d < variable.draws.size(); ++d)
+    {
+      Draw& draw = variable.draws[d];
+      bool constant = true;
+
+      vector<const ASTNode*> stack;
+      stack.push_back(draw.call);
+      while (constant && !stack.empty())
+      {
+        const ASTNode* node = stack.back();
+        stack.pop_back();
+        if (values.find(node) != values.end()
+          || node->getType() == AST_NAME_TIME
+          || (node->getType() == AST_NAME && node->getName() != NULL
+            && mIndices.find(node->getName()) != mIndices.end()))
+        {
+          constant = false;
+        }
+        for (unsigned int c = 0; c < node->getNumChildren(); ++c)
+        {
+          stack.push_back(node->getChild(c));
+        }
+      }
+      values.insert(draw.value);
+
+      draw.constantArgs = constant;
+      if (constant)
+      {
+        for (unsigned int c = 0; c < draw.call->getNumChildren(); ++c)
+        {
+          draw.args.push_back(SBMLTransforms::evaluateASTNode(
+            draw.call->getChild(c), mValues, mModel));
+        }
+      }
+    }
+  }
+}
+
+
+double
+DistribSampler::drawValue(Variable& variable, unsigned int realization,
+                          unsigned int index)
+{
+  PhiloxStream stream(mSeed, realization, index);
+
+  double value = util_NaN();
+  for (unsigned int d = 0; d < variable.draws.size(); ++d)
+  {
+    Draw& draw = variable.draws[d];
+    if (draw.constantArgs)
+    {
+      value = drawTruncated(stream, draw.type, draw.args);
+    }
+    else
+    {
+      mArgs.clear();
+      for (unsigned int c = 0; c < draw.call->getNumChildren(); ++c)
+      {
+        mArgs.push_back(SBMLTransforms::evaluateASTNode(
+          draw.call->getChild(c), mValues, mModel));
+      }
+      value = drawTruncated(stream, draw.type, mArgs);
+    }
+    draw.value->setValue(value);
+  }
+
+  if (variable.math == variable.draws.back().value)
+  {
+    return value;
+  }
+  return SBMLTransforms::evaluateASTNode(variable.math, mValues, mModel);
+}
+
+/** @endcond */
+
+
+LIBSBML_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
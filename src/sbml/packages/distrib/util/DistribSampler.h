@@ -0,0 +1,263 @@
+/**
+ * @file    DistribSampler.h
+ * @brief   Definition of DistribSampler, which draws realizations of the
+ *          values that distrib distributions give a model.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class DistribSampler
+ * @sbmlbrief{distrib} Draws random values for the distributions of a model.
+ *
+ * @htmlinclude libsbml-facility-only-warning.html
+ *
+ * A DistribSampler draws realizations of the values that the distrib
+ * package leaves random, as needed to simulate an ensemble of a model.
+ * Its variables are:
+ *
+ * @li the symbol of each InitialAssignment whose math calls a distribution
+ * function, such as <code>normal(mu, sigma)</code>;
+ * @li any other element with an id that has an Uncertainty with an
+ * UncertParameter of type "distribution" whose math calls one.
+ *
+ * sample() draws the values of all variables for a number of
+ * realizations into a single matrix, one row per realization.  The
+ * arguments of the distributions are evaluated with
+ * SBMLTransforms::evaluateASTNode(), using the values of the model, so
+ * that they may refer to parameters and to other variables: a variable is
+ * drawn after those its math refers to.  The math is read when the
+ * DistribSampler is created.
+ *
+ * The random numbers come from a counter-based generator (Philox4x32-10):
+ * the numbers for a variable in a realization depend only on the seed,
+ * the number of the realization and the variable.  Realizations can
+ * therefore be drawn in any number of separate blocks and come out the
+ * same as when drawn at once.
+ *
+ * A DistribSampler writes each value it draws into its own copy of the
+ * math, and keeps the values of the variables drawn so far, so that it
+ * draws on one thread at a time.  Separate samplers of the same model
+ * share nothing but the model: they may draw separate blocks on separate
+ * threads, as long as the model is not changed meanwhile.
+ *
+ * Truncated distributions, with a minimum and a maximum, are drawn by
+ * drawing again until the value falls within the bounds; a value that
+ * does not after 10000 draws, or of a distribution whose arguments are
+ * not valid, is NaN.
+ */
+
+
+#ifndef DistribSampler_h
+#define DistribSampler_h
+
+#include <sbml/common/extern.h>
+#include <sbml/common/operationReturnValues.h>
+#include <sbml/math/ASTNodeType.h>
+#include <sbml/SBMLTransforms.h>
+
+#ifdef __cplusplus
+
+#include <map>
+#include <string>
+#include <vector>
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+class ASTNode;
+class Model;
+class SBase;
+
+
+class LIBSBML_EXTERN DistribSampler
+{
+public:
+
+  /**
+   * Creates a new DistribSampler for the given Model.
+   *
+   * @param model the Model whose distributions to draw from.
+   * @param seed the seed of the random numbers.
+   */
+  DistribSampler(const Model* model, unsigned long seed = 0);
+
+
+  /**
+   * Destroys this DistribSampler.
+   */
+  virtual ~DistribSampler();
+
+
+  /**
+   * Returns the Model this DistribSampler draws values for.
+   *
+   * @return the Model.
+   */
+  const Model* getModel() const;
+
+
+  /**
+   * Returns the seed of the random numbers.
+   *
+   * @return the seed.
+   */
+  unsigned long getSeed() const;
+
+
+  /**
+   * Sets the seed of the random numbers used by the next call to sample().
+   *
+   * @param seed the seed.
+   */
+  void setSeed(unsigned long seed);
+
+
+  /**
+   * Returns the number of variables, that is the number of columns of
+   * the samples.
+   *
+   * @return the number of variables.
+   */
+  unsigned int getNumVariables() const;
+
+
+  /**
+   * Returns the id of the @p n-th variable.
+   *
+   * @param n the index of the variable.
+   *
+   * @return the id, or an empty string if there is no such variable.
+   */
+  std::string getVariable(unsigned int n) const;
+
+
+  /**
+   * Returns the index of the variable with the given id.
+   *
+   * @param id the id of the variable.
+   *
+   * @return the index, or @c -1 if there is no such variable.
+   */
+  int getVariableIndex(const std::string& id) const;
+
+
+  /**
+   * Draws the values of all variables for a number of realizations.
+   *
+   * @param numRealizations the number of realizations to draw.
+   * @param firstRealization the number of the first realization; drawing
+   * realizations 0 to 999 at once gives the same values as drawing 0 to
+   * 499 and then 500 to 999.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBSBML_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBSBML_INVALID_OBJECT, OperationReturnValues_t}
+   */
+  int sample(unsigned int numRealizations, unsigned int firstRealization = 0);
+
+
+  /**
+   * Returns the number of realizations drawn by the last call to sample().
+   *
+   * @return the number of realizations, that is the number of rows of the
+   * samples.
+   */
+  unsigned int getNumRealizations() const;
+
+
+  /**
+   * Returns the values drawn by the last call to sample().
+   *
+   * @return the values, row by row: the value of variable @c v in the
+   * realization @c r is at <code>r * getNumVariables() + v</code>; @c NULL
+   * if there are none.  The values are owned by this DistribSampler and
+   * stay valid until the next call to sample().
+   */
+  const double* getSamples() const;
+
+
+  /**
+   * Returns a value drawn by the last call to sample().
+   *
+   * @param realization the row, counted from the first realization drawn.
+   * @param variable the index of the variable.
+   *
+   * @return the value, or NaN if there is no such value.
+   */
+  double getSample(unsigned int realization, unsigned int variable) const;
+
+
+protected:
+  /** @cond doxygenLibsbmlInternal */
+
+  // a call of a distribution function, taken out of the math of its
+  // variable and replaced by a number set to each value drawn
+  struct Draw
+  {
+    ASTNodeType_t type;
+    ASTNode* call;
+    ASTNode* value;
+    std::vector<double> args;
+    bool constantArgs;
+  };
+
+  struct Variable
+  {
+    std::string id;
+    ASTNode* math;
+    std::vector<Draw> draws;
+    std::vector<std::string> names;
+    std::vector<unsigned int> dependencies;
+  };
+
+  void addVariable(const std::string& id, const ASTNode* math);
+
+  void prepareDraws(Variable& variable);
+
+  void orderVariables();
+
+  double drawValue(Variable& variable, unsigned int realization,
+                   unsigned int index);
+
+  const Model* mModel;
+  unsigned long mSeed;
+
+  std::vector<Variable> mVariables;
+  std::map<std::string, unsigned int> mIndices;
+
+  SBMLTransforms::IdValueMap mValues;
+  std::vector<double> mArgs;
+
+  std::vector<double> mSamples;
+  unsigned int mNumRealizations;
+
+  /** @endcond */
+
+private:
+  /** @cond doxygenLibsbmlInternal */
+
+  DistribSampler(const DistribSampler&);
+  DistribSampler& operator=(const DistribSampler&);
+
+  /** @endcond */
+};
+
+
+LIBSBML_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+#endif  /* DistribSampler_h */
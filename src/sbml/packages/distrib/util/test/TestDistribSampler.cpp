@@ -0,0 +1,353 @@
+/**
+ * \file    TestDistribSampler.cpp
+ * \brief   Implementation of the Tests for the DistribSampler
+ * \author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sbml/common/common.h>
+
+#include <sbml/packages/distrib/common/DistribExtensionTypes.h>
+#include <sbml/packages/distrib/util/DistribSampler.h>
+
+#include <sbml/SBMLReader.h>
+#include <sbml/SBMLTypes.h>
+#include <sbml/util/util.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <check.h>
+
+using namespace std;
+
+LIBSBML_CPP_NAMESPACE_USE
+
+BEGIN_C_DECLS
+
+
+extern char *TestDataDirectory;
+
+
+static SBMLDocument*
+readTestFile(const char* name)
+{
+  string filename(TestDataDirectory);
+  filename += name;
+  return readSBMLFromFile(filename.c_str());
+}
+
+
+/*
+ * Creates an empty model that uses distrib.
+ */
+static SBMLDocument*
+createDocument()
+{
+  SBMLNamespaces sbmlns(3, 1, "distrib", 1);
+  SBMLDocument* doc = new SBMLDocument(&sbmlns);
+  doc->setPackageRequired("distrib", true);
+  doc->createModel();
+  return doc;
+}
+
+
+/*
+ * Adds a parameter id with an initial assignment of the given formula.
+ */
+static void
+addAssignment(Model* model, const char* id, const char* formula)
+{
+  Parameter* p = model->createParameter();
+  p->setId(id);
+  p->setConstant(true);
+
+  InitialAssignment* ia = model->createInitialAssignment();
+  ia->setSymbol(id);
+  ASTNode* math = SBML_parseL3FormulaWithModel(formula, model);
+  fail_unless(math != NULL);
+  ia->setMath(math);
+  delete math;
+}
+
+
+static double
+getMean(const DistribSampler& sampler, unsigned int variable)
+{
+  double sum = 0;
+  for (unsigned int r = 0; r < sampler.getNumRealizations(); ++r)
+  {
+    sum += sampler.getSample(r, variable);
+  }
+  return sum / sampler.getNumRealizations();
+}
+
+
+static double
+getVariance(const DistribSampler& sampler, unsigned int variable)
+{
+  double mean = getMean(sampler, variable);
+  double sum = 0;
+  for (unsigned int r = 0; r < sampler.getNumRealizations(); ++r)
+  {
+    double d = sampler.getSample(r, variable) - mean;
+    sum += d * d;
+  }
+  return sum / (sampler.getNumRealizations() - 1);
+}
+
+
+START_TEST(test_distrib_sampler_normal)
+{
+  SBMLDocument* doc = readTestFile("normal_l3v2_distrib.xml");
+  Model* model = doc->getModel();
+  fail_unless(model != NULL);
+
+  DistribSampler sampler(model, 42);
+  fail_unless(sampler.getModel() == model);
+  fail_unless(sampler.getSeed() == 42);
+  fail_unless(sampler.getNumVariables() == 1);
+  fail_unless(sampler.getVariable(0) == "a");
+  fail_unless(sampler.getVariableIndex("a") == 0);
+  fail_unless(sampler.getVariableIndex("b") == -1);
+  fail_unless(sampler.getVariable(1).empty());
+
+  fail_unless(sampler.getSamples() == NULL);
+  fail_unless(sampler.sample(100000) == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(sampler.getNumRealizations() == 100000);
+  fail_unless(sampler.getSamples() != NULL);
+
+  // normal(1, 2)
+  fail_unless(fabs(getMean(sampler, 0) - 1.0) < 0.05);
+  fail_unless(fabs(getVariance(sampler, 0) - 4.0) < 0.1);
+  fail_unless(util_isNaN(sampler.getSample(100000, 0)));
+  fail_unless(util_isNaN(sampler.getSample(0, 1)));
+
+  delete doc;
+}
+END_TEST
+
+
+START_TEST(test_distrib_sampler_distributions)
+{
+  SBMLDocument* doc = createDocument();
+  Model* model = doc->getModel();
+  fail_unless(model != NULL);
+
+  addAssignment(model, "u", "uniform(2, 4)");
+  addAssignment(model, "be", "bernoulli(0.25)");
+  addAssignment(model, "bi", "binomial(1000, 0.3)");
+  addAssignment(model, "ch", "chisquare(3)");
+  addAssignment(model, "ex", "exponential(2)");
+  addAssignment(model, "ga", "gamma(0.5, 2)");
+  addAssignment(model, "la", "laplace(1, 2)");
+  addAssignment(model, "lo", "lognormal(0, 0.5)");
+  addAssignment(model, "po", "poisson(200)");
+  addAssignment(model, "ps", "poisson(3)");
+  addAssignment(model, "ra", "rayleigh(1)");
+  addAssignment(model, "bad", "gamma(-1, 2)");
+
+  DistribSampler sampler(model, 7);
+  fail_unless(sampler.getNumVariables() == 12);
+  fail_unless(sampler.sample(100000) == LIBSBML_OPERATION_SUCCESS);
+
+  fail_unless(fabs(getMean(sampler, 0) - 3.0) < 0.02);
+  fail_unless(fabs(getVariance(sampler, 0) - 1.0 / 3.0) < 0.01);
+  fail_unless(fabs(getMean(sampler, 1) - 0.25) < 0.01);
+  fail_unless(fabs(getMean(sampler, 2) - 300.0) < 0.5);
+  fail_unless(fabs(getVariance(sampler, 2) - 210.0) < 6.0);
+  fail_unless(fabs(getMean(sampler, 3) - 3.0) < 0.05);
+  fail_unless(fabs(getMean(sampler, 4) - 0.5) < 0.01);
+  fail_unless(fabs(getMean(sampler, 5) - 1.0) < 0.03);
+  fail_unless(fabs(getVariance(sampler, 5) - 2.0) < 0.1);
+  fail_unless(fabs(getMean(sampler, 6) - 1.0) < 0.03);
+  fail_unless(fabs(getVariance(sampler, 6) - 8.0) < 0.3);
+  fail_unless(fabs(getMean(sampler, 7) - exp(0.125)) < 0.01);
+  fail_unless(fabs(getMean(sampler, 8) - 200.0) < 0.3);
+  fail_unless(fabs(getVariance(sampler, 8) - 200.0) < 6.0);
+  fail_unless(fabs(getMean(sampler, 9) - 3.0) < 0.03);
+  fail_unless(fabs(getMean(sampler, 10) - sqrt(3.14159265358979 / 2)) < 0.01);
+  fail_unless(util_isNaN(sampler.getSample(0, 11)));
+
+  for (unsigned int r = 0; r < sampler.getNumRealizations(); ++r)
+  {
+    double be = sampler.getSample(r, 1);
+    fail_unless(be == 0 || be == 1);
+    fail_unless(sampler.getSample(r, 9) == floor(sampler.getSample(r, 9)));
+  }
+
+  delete doc;
+}
+END_TEST
+
+
+START_TEST(test_distrib_sampler_blocks)
+{
+  SBMLDocument* doc = createDocument();
+  Model* model = doc->getModel();
+  fail_unless(model != NULL);
+
+  addAssignment(model, "x", "normal(0, 1)");
+  addAssignment(model, "y", "poisson(40) + x");
+
+  DistribSampler sampler(model, 12345);
+  fail_unless(sampler.sample(1000) == LIBSBML_OPERATION_SUCCESS);
+  vector<double> all(sampler.getSamples(), sampler.getSamples() + 2000);
+
+  fail_unless(sampler.sample(500, 0) == LIBSBML_OPERATION_SUCCESS);
+  for (unsigned int i = 0; i < 1000; ++i)
+  {
+    fail_unless(sampler.getSamples()[i] == all[i]);
+  }
+  fail_unless(sampler.sample(500, 500) == LIBSBML_OPERATION_SUCCESS);
+  for (unsigned int i = 0; i < 1000; ++i)
+  {
+    fail_unless(sampler.getSamples()[i] == all[1000 + i]);
+  }
+
+  // another seed draws other values
+  sampler.setSeed(54321);
+  fail_unless(sampler.sample(1) == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(sampler.getSample(0, 0) != all[0]);
+
+  delete doc;
+}
+END_TEST
+
+
+START_TEST(test_distrib_sampler_dependencies)
+{
+  SBMLDocument* doc = createDocument();
+  Model* model = doc->getModel();
+  fail_unless(model != NULL);
+
+  // y refers to x, which is drawn later in the model
+  addAssignment(model, "y", "normal(x, 0.001) * 2");
+  addAssignment(model, "x", "uniform(0, 10)");
+  addAssignment(model, "z", "normal(normal(5, 1), 0.001)");
+
+  DistribSampler sampler(model);
+  fail_unless(sampler.getNumVariables() == 3);
+  fail_unless(sampler.getVariable(0) == "x");
+  fail_unless(sampler.getVariable(1) == "y");
+  fail_unless(sampler.getVariable(2) == "z");
+  fail_unless(sampler.sample(1000) == LIBSBML_OPERATION_SUCCESS);
+
+  for (unsigned int r = 0; r < 1000; ++r)
+  {
+    double x = sampler.getSample(r, 0);
+    double y = sampler.getSample(r, 1);
+    fail_unless(x > 0 && x < 10);
+    fail_unless(fabs(y - 2 * x) < 0.01);
+  }
+  fail_unless(fabs(getMean(sampler, 2) - 5.0) < 0.15);
+  fail_unless(getVariance(sampler, 2) > 0.8);
+
+  delete doc;
+}
+END_TEST
+
+
+START_TEST(test_distrib_sampler_truncated)
+{
+  SBMLDocument* doc = readTestFile("truncated_normal_distrib.xml");
+  Model* model = doc->getModel();
+  fail_unless(model != NULL);
+
+  // normal(3, 2) truncated to [0, 5]; and bounds that are never met
+  addAssignment(model, "never", "normal(0, 1, 100, 101)");
+
+  DistribSampler sampler(model);
+  fail_unless(sampler.getNumVariables() == 2);
+  fail_unless(sampler.sample(1000) == LIBSBML_OPERATION_SUCCESS);
+
+  for (unsigned int r = 0; r < 1000; ++r)
+  {
+    double value = sampler.getSample(r, 0);
+    fail_unless(value >= 0 && value <= 5);
+  }
+  fail_unless(util_isNaN(sampler.getSample(0, 1)));
+
+  delete doc;
+}
+END_TEST
+
+
+START_TEST(test_distrib_sampler_uncertainty)
+{
+  SBMLDocument* doc = createDocument();
+  Model* model = doc->getModel();
+  fail_unless(model != NULL);
+
+  Parameter* p = model->createParameter();
+  p->setId("k");
+  p->setConstant(true);
+  p->setValue(3);
+
+  DistribSBasePlugin* plugin =
+    static_cast<DistribSBasePlugin*>(p->getPlugin("distrib"));
+  fail_unless(plugin != NULL);
+  Uncertainty* uncertainty = plugin->createUncertainty();
+  UncertParameter* param = uncertainty->createUncertParameter();
+  param->setType(DISTRIB_UNCERTTYPE_DISTRIBUTION);
+  ASTNode* math = SBML_parseL3FormulaWithModel("exponential(1 / k)", model);
+  param->setMath(math);
+  delete math;
+
+  DistribSampler sampler(model);
+  fail_unless(sampler.getNumVariables() == 1);
+  fail_unless(sampler.getVariable(0) == "k");
+  fail_unless(sampler.sample(100000) == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(fabs(getMean(sampler, 0) - 3.0) < 0.05);
+
+  delete doc;
+}
+END_TEST
+
+
+START_TEST(test_distrib_sampler_no_model)
+{
+  DistribSampler sampler(NULL);
+  fail_unless(sampler.getNumVariables() == 0);
+  fail_unless(sampler.sample(10) == LIBSBML_INVALID_OBJECT);
+  fail_unless(sampler.getSamples() == NULL);
+}
+END_TEST
+
+
+Suite *
+create_suite_TestDistribSampler (void)
+{
+  Suite *suite = suite_create("DistribSampler");
+  TCase *tcase = tcase_create("DistribSampler");
+
+  tcase_add_test(tcase, test_distrib_sampler_normal);
+  tcase_add_test(tcase, test_distrib_sampler_distributions);
+  tcase_add_test(tcase, test_distrib_sampler_blocks);
+  tcase_add_test(tcase, test_distrib_sampler_dependencies);
+  tcase_add_test(tcase, test_distrib_sampler_truncated);
+  tcase_add_test(tcase, test_distrib_sampler_uncertainty);
+  tcase_add_test(tcase, test_distrib_sampler_no_model);
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+END_C_DECLS
@@ -128,6 +128,7 @@ CK_CPPSTART
 #endif
 
 Suite *create_suite_TestDistribAnnotationConverter  (void);
+Suite *create_suite_TestDistribSampler  (void);
 
 /**
  * Global.
@@ -173,6 +174,7 @@ main (void)
   setTestDataDirectory();
 
   SRunner *runner = srunner_create( create_suite_TestDistribAnnotationConverter() );
+  srunner_add_suite( runner, create_suite_TestDistribSampler() );
 
   /* srunner_set_fork_status(runner, CK_NOFORK); */
 
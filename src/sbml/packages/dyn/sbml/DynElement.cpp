@@ -359,6 +359,16 @@ DynElement::renameSIdRefs(const std::string& oldid, const std::string& newid)
 }
 
 
+/*
+ * rename attributes that are SIdRefs or instances in math
+ */
+void
+DynElement::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mIdRef);
+}
+
+
 /*
  * Returns the XML element name of this object
  */
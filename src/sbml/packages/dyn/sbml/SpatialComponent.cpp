@@ -360,6 +360,16 @@ SpatialComponent::renameSIdRefs(const std::string& oldid, const std::string& new
 }
 
 
+/*
+ * rename attributes that are SIdRefs or instances in math
+ */
+void
+SpatialComponent::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mVariable);
+}
+
+
 /*
  * Returns the XML element name of this object
  */
@@ -345,6 +345,14 @@ public:
    virtual void renameSIdRefs(const std::string& oldid, const std::string& newid);
 
 
+#ifndef SWIG
+   /**
+    * @copydoc SBase::renameSIdRefs(const std::map<std::string, std::string>& renames)
+    */
+   virtual void renameSIdRefs(const std::map<std::string, std::string>& renames);
+#endif
+
+
   /**
    * Returns the XML element name of this object, which for SpatialComponent, is
    * always @c "spatialComponent".
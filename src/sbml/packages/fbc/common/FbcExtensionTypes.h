@@ -59,5 +59,8 @@
 #include <sbml/packages/fbc/sbml/UserDefinedConstraint.h>
 #include <sbml/packages/fbc/sbml/KeyValuePair.h>
 
+#include <sbml/packages/fbc/util/FbcSparseModel.h>
+#include <sbml/packages/fbc/util/FluxBoundsView.h>
+
 #endif  /* FbcExtensionTypes_H */
 
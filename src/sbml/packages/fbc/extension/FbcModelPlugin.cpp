@@ -39,6 +39,7 @@
 #include <sbml/packages/fbc/extension/FbcModelPlugin.h>
 #include <sbml/packages/fbc/extension/FbcExtension.h>
 #include <sbml/packages/fbc/validator/FbcSBMLError.h>
+#include <sbml/packages/fbc/util/FluxBoundsView.h>
 #include <sbml/util/ElementFilter.h>
 #include <sbml/Model.h>
 
@@ -67,6 +68,11 @@ FbcModelPlugin::FbcModelPlugin(const std::string& uri,
   , mBounds(fbcns)
   , mAssociations(fbcns)
   , mUserDefinedConstraints (fbcns)
+  , mGeneProductIndexValid (false)
+  , mIndexedGeneProducts (0)
+  , mFluxBoundIndexValid (false)
+  , mIndexedFluxBounds (0)
+  , mFluxBoundsView (NULL)
 {
   // connect child elements to this element.
   connectToChild();
@@ -85,9 +91,22 @@ FbcModelPlugin::FbcModelPlugin(const FbcModelPlugin& orig)
   , mBounds(orig.mBounds)
   , mAssociations(orig.mAssociations)
   , mUserDefinedConstraints ( orig.mUserDefinedConstraints )
+  , mGeneProductIndexValid (false)
+  , mIndexedGeneProducts (0)
+  , mFluxBoundIndexValid (false)
+  , mIndexedFluxBounds (0)
+  , mFluxBoundsView (NULL)
 {
   // connect child elements to this element.
   connectToChild();
+
+  // changes not yet committed belong to the copy as well; the view is
+  // moved to the copied model when it is next asked for
+  if (orig.mFluxBoundsView != NULL &&
+      orig.mFluxBoundsView->getNumChangedReactions() > 0)
+  {
+    mFluxBoundsView = orig.mFluxBoundsView->clone();
+  }
 }
 
 
@@ -107,6 +126,15 @@ FbcModelPlugin::operator=(const FbcModelPlugin& rhs)
     mAssociations = rhs.mAssociations;
     mGeneProducts  = rhs.mGeneProducts;
     mUserDefinedConstraints = rhs.mUserDefinedConstraints;
+    mGeneProductIndexValid = false;
+    mFluxBoundIndexValid = false;
+    delete mFluxBoundsView;
+    mFluxBoundsView = NULL;
+    if (rhs.mFluxBoundsView != NULL &&
+        rhs.mFluxBoundsView->getNumChangedReactions() > 0)
+    {
+      mFluxBoundsView = rhs.mFluxBoundsView->clone();
+    }
     connectToChild();
   }
 
@@ -129,6 +157,7 @@ FbcModelPlugin::clone () const
  */
 FbcModelPlugin::~FbcModelPlugin()
 {
+  delete mFluxBoundsView;
 }
 
 //---------------------------------------------------------------
@@ -1011,6 +1040,110 @@ FbcModelPlugin::removeGeneProduct(const std::string& sid)
 }
 
 
+/** @cond doxygenLibsbmlInternal */
+void
+FbcModelPlugin::invalidateIndexes(const SBase* element)
+{
+  // the element, its list and the model containing them
+  const SBase* parent = element;
+  for (int level = 0; level < 3 && parent != NULL; ++level)
+  {
+    const FbcModelPlugin* plugin = 
+      dynamic_cast<const FbcModelPlugin*>(parent->getPlugin("fbc"));
+    if (plugin != NULL)
+    {
+      plugin->invalidateIndexesUnlessAppended(element);
+      return;
+    }
+    parent = parent->getParentSBMLObject();
+  }
+}
+
+
+/*
+ * Elements appended since the indexes were last updated are not indexed
+ * yet, so changing them (typically right after they were created) does
+ * not invalidate anything:  they are indexed when the indexes are next
+ * used.  The lists are searched from the end, where such elements are.
+ */
+void
+FbcModelPlugin::invalidateIndexesUnlessAppended(const SBase* element) const
+{
+  if (mGeneProductIndexValid)
+  {
+    bool appended = false;
+    for (unsigned int i = mGeneProducts.size(); i > mIndexedGeneProducts; --i)
+    {
+      if (mGeneProducts.get(i - 1) == element)
+      {
+        appended = true;
+        break;
+      }
+    }
+    mGeneProductIndexValid = appended;
+  }
+
+  if (mFluxBoundIndexValid)
+  {
+    bool appended = false;
+    for (unsigned int i = mBounds.size(); i > mIndexedFluxBounds; --i)
+    {
+      if (mBounds.get(i - 1) == element)
+      {
+        appended = true;
+        break;
+      }
+    }
+    mFluxBoundIndexValid = appended;
+  }
+}
+
+
+void
+FbcModelPlugin::updateGeneProductIndex() const
+{
+  if (!mGeneProductIndexValid || mIndexedGeneProducts > mGeneProducts.size())
+  {
+    mGeneProductIdIndex.clear();
+    mGeneProductLabelIndex.clear();
+    mIndexedGeneProducts = 0;
+  }
+
+  // the first of several gene products with the same key is the one found
+  for (unsigned int i = mIndexedGeneProducts; i < mGeneProducts.size(); ++i)
+  {
+    const GeneProduct* current = mGeneProducts.get(i);
+    if (current == NULL) continue;
+    if (current->isSetId())
+      mGeneProductIdIndex.insert(make_pair(current->getId(), i));
+    mGeneProductLabelIndex.insert(make_pair(current->getLabel(), i));
+  }
+  mIndexedGeneProducts = mGeneProducts.size();
+  mGeneProductIndexValid = true;
+}
+
+
+void
+FbcModelPlugin::updateFluxBoundIndex() const
+{
+  if (!mFluxBoundIndexValid || mIndexedFluxBounds > mBounds.size())
+  {
+    mFluxBoundReactionIndex.clear();
+    mIndexedFluxBounds = 0;
+  }
+
+  for (unsigned int i = mIndexedFluxBounds; i < mBounds.size(); ++i)
+  {
+    const FluxBound* current = mBounds.get(i);
+    if (current == NULL) continue;
+    mFluxBoundReactionIndex[current->getReaction()].push_back(i);
+  }
+  mIndexedFluxBounds = mBounds.size();
+  mFluxBoundIndexValid = true;
+}
+/** @endcond */
+
+
 /*
  * Return the nth GeneProduct in the ListOfGeneProducts within this FbcModelPlugin.
  */
@@ -1037,15 +1170,28 @@ FbcModelPlugin::getGeneProduct(unsigned int n) const
 GeneProduct*
 FbcModelPlugin::getGeneProduct(const std::string& sid)
 {
-  return mGeneProducts.get(sid);
+  const FbcModelPlugin* self = this;
+  return const_cast<GeneProduct*>(self->getGeneProduct(sid));
 }
 
 GeneProduct* 
 FbcModelPlugin::getGeneProductByLabel(const std::string& label)
 {
+  updateGeneProductIndex();
+  map<string, unsigned int>::const_iterator it = 
+    mGeneProductLabelIndex.find(label);
+  if (it == mGeneProductLabelIndex.end())
+    return NULL;
+
+  GeneProduct* current = mGeneProducts.get(it->second);
+  if (current != NULL && current->getLabel() == label)
+    return current;
+
+  // the index is out of date after all
+  mGeneProductIndexValid = false;
   for (unsigned int i = 0; i < mGeneProducts.size(); ++i)
   {
-    GeneProduct* current = mGeneProducts.get(i);
+    current = mGeneProducts.get(i);
     if (current != NULL && current->getLabel() == label)
       return current;
   }
@@ -1059,6 +1205,21 @@ FbcModelPlugin::getGeneProductByLabel(const std::string& label)
 const GeneProduct*
 FbcModelPlugin::getGeneProduct(const std::string& sid) const
 {
+  if (sid.empty())
+    return mGeneProducts.get(sid);
+
+  updateGeneProductIndex();
+  map<string, unsigned int>::const_iterator it = 
+    mGeneProductIdIndex.find(sid);
+  if (it == mGeneProductIdIndex.end())
+    return NULL;
+
+  const GeneProduct* current = mGeneProducts.get(it->second);
+  if (current != NULL && current->getId() == sid)
+    return current;
+
+  // the index is out of date after all
+  mGeneProductIndexValid = false;
   return mGeneProducts.get(sid);
 }
 
@@ -1198,6 +1359,33 @@ FbcModelPlugin::unsetActiveObjectiveId()
   return LIBSBML_OPERATION_SUCCESS;
 }
 
+/*
+ * Returns the flux bounds and objective coefficients of the parent model
+ * as arrays, creating the view on first use.
+ */
+FluxBoundsView*
+FbcModelPlugin::getFluxBoundsView()
+{
+  Model* parent = static_cast<Model*>(getParentSBMLObject());
+  if (parent == NULL)
+  {
+    return NULL;
+  }
+
+  // a view copied with this plugin still views the original model
+  if (mFluxBoundsView != NULL && mFluxBoundsView->getModel() != parent)
+  {
+    mFluxBoundsView->setModel(parent);
+  }
+
+  if (mFluxBoundsView == NULL)
+  {
+    mFluxBoundsView = new FluxBoundsView(parent);
+  }
+
+  return mFluxBoundsView;
+}
+
 /*
  * Returns the ListOfObjectives in this plugin object.
  *
@@ -2498,12 +2686,30 @@ FbcModelPlugin::getFluxBoundsForReaction(const std::string& reaction) const
   ListOfFluxBounds * loFB = new ListOfFluxBounds(getLevel(), getVersion(),
     getPackageVersion());
                                                 
-
-  for (unsigned int i = 0; i < getNumFluxBounds(); i++)
+  updateFluxBoundIndex();
+  map<string, vector<unsigned int> >::const_iterator it = 
+    mFluxBoundReactionIndex.find(reaction);
+  if (it != mFluxBoundReactionIndex.end())
   {
-    if (getFluxBound(i)->getReaction() == reaction)
+    const vector<unsigned int>& positions = it->second;
+    for (size_t i = 0; i < positions.size(); i++)
     {
-      loFB->append(getFluxBound(i));
+      const FluxBound* bound = getFluxBound(positions[i]);
+      if (bound == NULL || bound->getReaction() != reaction)
+      {
+        // the index is out of date after all
+        mFluxBoundIndexValid = false;
+        loFB->clear();
+        for (unsigned int n = 0; n < getNumFluxBounds(); n++)
+        {
+          if (getFluxBound(n)->getReaction() == reaction)
+          {
+            loFB->append(getFluxBound(n));
+          }
+        }
+        break;
+      }
+      loFB->append(bound);
     }
   }
 
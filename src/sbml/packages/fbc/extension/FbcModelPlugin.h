@@ -157,9 +157,14 @@
 #include <sbml/packages/fbc/sbml/ListOfUserDefinedConstraints.h>
 #include <sbml/packages/fbc/sbml/UserDefinedConstraint.h>
 
+#include <map>
+#include <vector>
+
 
 LIBSBML_CPP_NAMESPACE_BEGIN
 
+class FluxBoundsView;
+
 
 class LIBSBML_EXTERN FbcModelPlugin : public FbcSBasePlugin
 {
@@ -718,6 +723,22 @@ public:
    */
   int unsetActiveObjectiveId();
 
+  /**
+   * Returns the flux bounds and objective coefficients of the parent Model
+   * of this FbcModelPlugin as arrays.
+   *
+   * The FluxBoundsView is created on first use and owned by this
+   * FbcModelPlugin.  Changes made to its arrays are only written back to
+   * the model by FluxBoundsView::commit(); a copy of the model keeps those
+   * not yet committed.
+   *
+   * @return the FluxBoundsView of the parent Model, or @c NULL if this
+   * FbcModelPlugin is not attached to a Model.
+   *
+   * @see FluxBoundsView
+   */
+  FluxBoundsView* getFluxBoundsView();
+
   /**
    * Returns the ListOfGeneProducts in this FbcModelPlugin object.
    *
@@ -1753,6 +1774,20 @@ public:
   /** @endcond */
 
 
+  /** @cond doxygenLibsbmlInternal */
+  /**
+   * Marks the indexes of gene products and flux bounds of the
+   * FbcModelPlugin of the Model containing the given element (a
+   * GeneProduct, a FluxBound or one of their lists) as out of date.
+   *
+   * GeneProduct and FluxBound call this whenever an indexed attribute
+   * changes or they are added to a list, and their lists whenever
+   * elements are removed.
+   */
+  static void invalidateIndexes(const SBase* element);
+  /** @endcond */
+
+
 protected:
 
   /** @cond doxygenLibsbmlInternal */
@@ -1774,6 +1809,29 @@ protected:
 
   /** @endcond */
 
+  /** @cond doxygenLibsbmlInternal */
+  /*
+   * Indexes of gene products by id and label, and of flux bounds by 
+   * reaction, holding positions in the lists.  They are built on first 
+   * use, extended when elements are appended and rebuilt whenever they
+   * are out of date.
+   */
+  void updateGeneProductIndex() const;
+  void updateFluxBoundIndex() const;
+  void invalidateIndexesUnlessAppended(const SBase* element) const;
+
+  mutable bool          mGeneProductIndexValid;
+  mutable unsigned int  mIndexedGeneProducts;
+  mutable std::map<std::string, unsigned int> mGeneProductIdIndex;
+  mutable std::map<std::string, unsigned int> mGeneProductLabelIndex;
+
+  mutable bool          mFluxBoundIndexValid;
+  mutable unsigned int  mIndexedFluxBounds;
+  mutable std::map<std::string, std::vector<unsigned int> > mFluxBoundReactionIndex;
+
+  FluxBoundsView* mFluxBoundsView;
+  /** @endcond */
+
 
 };
 
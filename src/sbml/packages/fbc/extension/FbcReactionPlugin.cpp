@@ -334,6 +334,25 @@ FbcReactionPlugin::renameSIdRefs(const std::string& oldid, const std::string& ne
 }
 /** @endcond */
 
+/** @cond doxygenLibsbmlInternal */
+void
+FbcReactionPlugin::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  FbcSBasePlugin::renameSIdRefs(renames);
+  std::map<std::string, std::string>::const_iterator it;
+  if (isSetLowerFluxBound()
+    && (it = renames.find(mLowerFluxBound)) != renames.end())
+  {
+    mLowerFluxBound = it->second;
+  }
+  if (isSetUpperFluxBound()
+    && (it = renames.find(mUpperFluxBound)) != renames.end())
+  {
+    mUpperFluxBound = it->second;
+  }
+}
+/** @endcond */
+
 
 /** @cond doxygenLibsbmlInternal */
 /*
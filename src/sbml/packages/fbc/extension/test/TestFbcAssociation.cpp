@@ -1263,6 +1263,52 @@ START_TEST(test_FbcAssociation_parseFbcInfixIdAssociation_product_ref_noAdd)
 END_TEST
 
 
+START_TEST(test_FbcAssociation_parseFbcInfixAssociation_grouping)
+{
+  FbcPkgNamespaces sbmlns(3, 1, 2);
+  SBMLDocument doc(&sbmlns);
+  Model* model = doc.createModel();
+  FbcModelPlugin* fbc = dynamic_cast<FbcModelPlugin*>(model->getPlugin("fbc"));
+  fail_unless(fbc != NULL);
+
+  // nested groups of the same operator are merged, and 'and' binds tighter
+  FbcAssociation * fa = 
+    FbcAssociation::parseFbcInfixAssociation("a or (b OR c) or d and e", fbc, true);
+  fail_unless(fa != NULL);
+  fail_unless(fa->isFbcOr() == true);
+  FbcOr* fo = dynamic_cast<FbcOr*>(fa);
+  fail_unless(fo->getNumAssociations() == 4);
+  fail_unless(fo->getAssociation(3)->isFbcAnd() == true);
+  fail_unless(fbc->getNumGeneProducts() == 5);
+  delete fa;
+
+  fa = FbcAssociation::parseFbcInfixAssociation("((a))", fbc, true);
+  fail_unless(fa != NULL);
+  fail_unless(fa->isGeneProductRef() == true);
+  delete fa;
+
+  fa = FbcAssociation::parseFbcInfixAssociation("(a  AND\tf)or(b)", fbc, true);
+  fail_unless(fa != NULL);
+  fail_unless(fa->isFbcOr() == true);
+  fail_unless(fbc->getNumGeneProducts() == 6);
+  delete fa;
+
+  // nothing is created for associations that do not parse
+  fail_unless(FbcAssociation::parseFbcInfixAssociation("g and (h", fbc, true) == NULL);
+  fail_unless(FbcAssociation::parseFbcInfixAssociation("g h", fbc, true) == NULL);
+  fail_unless(FbcAssociation::parseFbcInfixAssociation("g or", fbc, true) == NULL);
+  fail_unless(FbcAssociation::parseFbcInfixAssociation("", fbc, true) == NULL);
+  fail_unless(fbc->getNumGeneProducts() == 6);
+
+  Reaction* r = model->createReaction();
+  FbcReactionPlugin * rplug = dynamic_cast<FbcReactionPlugin*>(r->getPlugin("fbc"));
+  GeneProductAssociation* gpa = rplug->createGeneProductAssociation();
+  fail_unless(gpa->setAssociation("a or (b or c) or d and e", true) 
+              == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(gpa->getAssociation()->toInfix(true) == "(a or b or c or (d and e))");
+}
+END_TEST
+
 
 Suite *
 create_suite_FbcAssociation (void)
@@ -1287,6 +1333,7 @@ create_suite_FbcAssociation (void)
   
   tcase_add_test(tcase, test_FbcAssociation_parseFbcInfixAssociation_product_ref_noAdd);
   tcase_add_test(tcase, test_FbcAssociation_parseFbcInfixIdAssociation_product_ref_noAdd);
+  tcase_add_test(tcase, test_FbcAssociation_parseFbcInfixAssociation_grouping);
 
   suite_add_tcase(suite, tcase);
 
@@ -18,6 +18,7 @@
 #include <sbml/extension/SBMLExtensionRegistry.h>
 #include <sbml/SBMLTypeCodes.h>
 #include <sbml/SBMLReader.h>
+#include <sbml/util/PrefixTransformer.h>
 #include <string>
 
 /** @cond doxygenIgnored */
@@ -369,6 +370,137 @@ START_TEST(test_FbcExtension_parseGeneAssociation)
 }
 END_TEST
 
+START_TEST(test_FbcExtension_geneProductIndex)
+{
+  FbcPkgNamespaces sbmlns(3, 1, 2);
+  SBMLDocument doc(&sbmlns);
+  Model* model = doc.createModel();
+  FbcModelPlugin* plugin = static_cast<FbcModelPlugin*>(model->getPlugin("fbc"));
+
+  GeneProduct* gp1 = plugin->createGeneProduct();
+  gp1->setId("g1");
+  gp1->setLabel("b0001");
+  GeneProduct* gp2 = plugin->createGeneProduct();
+  gp2->setId("g2");
+  gp2->setLabel("b0002");
+
+  fail_unless(plugin->getGeneProduct("g2") == gp2);
+  fail_unless(plugin->getGeneProductByLabel("b0001") == gp1);
+  fail_unless(plugin->getGeneProductByLabel("b0003") == NULL);
+
+  // additions, changes and removals are all noticed
+  GeneProduct* gp3 = plugin->createGeneProduct();
+  gp3->setId("g3");
+  gp3->setLabel("b0003");
+  fail_unless(plugin->getGeneProductByLabel("b0003") == gp3);
+
+  gp1->setLabel("b0004");
+  gp2->setId("g4");
+  fail_unless(plugin->getGeneProductByLabel("b0001") == NULL);
+  fail_unless(plugin->getGeneProductByLabel("b0004") == gp1);
+  fail_unless(plugin->getGeneProduct("g2") == NULL);
+  fail_unless(plugin->getGeneProduct("g4") == gp2);
+
+  delete plugin->removeGeneProduct("g4");
+  GeneProduct* gp5 = plugin->createGeneProduct();
+  gp5->setId("g5");
+  gp5->setLabel("b0005");
+  fail_unless(plugin->getGeneProduct("g4") == NULL);
+  fail_unless(plugin->getGeneProduct("g5") == gp5);
+  fail_unless(plugin->getGeneProductByLabel("b0003") == gp3);
+
+  // the first of several gene products with the same label is found
+  gp5->setLabel("b0003");
+  fail_unless(plugin->getGeneProductByLabel("b0003") == gp3);
+  gp3->removeFromParentAndDelete();
+  fail_unless(plugin->getGeneProductByLabel("b0003") == gp5);
+}
+END_TEST
+
+
+START_TEST(test_FbcExtension_fluxBoundIndex)
+{
+  FbcPkgNamespaces sbmlns(3, 1, 1);
+  SBMLDocument doc(&sbmlns);
+  Model* model = doc.createModel();
+  FbcModelPlugin* plugin = static_cast<FbcModelPlugin*>(model->getPlugin("fbc"));
+
+  FluxBound* lower = plugin->createFluxBound();
+  lower->setId("lower");
+  lower->setReaction("R1");
+  lower->setOperation(FLUXBOUND_OPERATION_GREATER_EQUAL);
+  FluxBound* upper = plugin->createFluxBound();
+  upper->setId("upper");
+  upper->setReaction("R2");
+  upper->setOperation(FLUXBOUND_OPERATION_LESS_EQUAL);
+
+  ListOfFluxBounds* bounds = plugin->getFluxBoundsForReaction("R1");
+  fail_unless(bounds != NULL);
+  fail_unless(bounds->size() == 1);
+  fail_unless(bounds->get(0)->getId() == "lower");
+  delete bounds;
+  fail_unless(plugin->getFluxBoundsForReaction("R3") == NULL);
+
+  upper->setReaction("R1");
+  bounds = plugin->getFluxBoundsForReaction("R1");
+  fail_unless(bounds != NULL);
+  fail_unless(bounds->size() == 2);
+  fail_unless(bounds->get(0)->getId() == "lower");
+  fail_unless(bounds->get(1)->getId() == "upper");
+  delete bounds;
+
+  delete plugin->removeFluxBound(0);
+  FluxBound* other = plugin->createFluxBound();
+  other->setId("other");
+  other->setReaction("R3");
+  bounds = plugin->getFluxBoundsForReaction("R1");
+  fail_unless(bounds != NULL);
+  fail_unless(bounds->size() == 1);
+  fail_unless(bounds->get(0)->getId() == "upper");
+  delete bounds;
+  bounds = plugin->getFluxBoundsForReaction("R3");
+  fail_unless(bounds != NULL);
+  fail_unless(bounds->size() == 1);
+  delete bounds;
+}
+END_TEST
+
+
+START_TEST(test_FbcExtension_fluxBoundIndex_renameIds)
+{
+  FbcPkgNamespaces sbmlns(3, 1, 1);
+  SBMLDocument doc(&sbmlns);
+  Model* model = doc.createModel();
+  FbcModelPlugin* plugin = static_cast<FbcModelPlugin*>(model->getPlugin("fbc"));
+
+  Reaction* reaction = model->createReaction();
+  reaction->setId("R1");
+  reaction->setReversible(false);
+  reaction->setFast(false);
+  FluxBound* bound = plugin->createFluxBound();
+  bound->setId("lower");
+  bound->setReaction("R1");
+  bound->setOperation(FLUXBOUND_OPERATION_GREATER_EQUAL);
+
+  ListOfFluxBounds* bounds = plugin->getFluxBoundsForReaction("R1");
+  fail_unless(bounds != NULL);
+  delete bounds;
+
+  PrefixTransformer transformer("p_");
+  model->renameAllIds(&transformer);
+  fail_unless(bound->getReaction() == "p_R1");
+
+  fail_unless(plugin->getFluxBoundsForReaction("R1") == NULL);
+  bounds = plugin->getFluxBoundsForReaction("p_R1");
+  fail_unless(bounds != NULL);
+  fail_unless(bounds->size() == 1);
+  fail_unless(bounds->get(0) != NULL);
+  fail_unless(bounds->get(0)->getId() == "p_lower");
+  delete bounds;
+}
+END_TEST
+
+
 Suite *
 create_suite_FbcExtension (void)
 {
@@ -388,6 +520,9 @@ create_suite_FbcExtension (void)
   tcase_add_test( tcase, test_FbcExtension_registry        );
   tcase_add_test( tcase, test_FbcExtension_typecode        );
   tcase_add_test( tcase, test_FbcExtension_SBMLtypecode    );
+  tcase_add_test( tcase, test_FbcExtension_geneProductIndex);
+  tcase_add_test( tcase, test_FbcExtension_fluxBoundIndex  );
+  tcase_add_test( tcase, test_FbcExtension_fluxBoundIndex_renameIds);
 
   suite_add_tcase(suite, tcase);
 
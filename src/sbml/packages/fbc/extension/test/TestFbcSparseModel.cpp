@@ -0,0 +1,351 @@
+/**
+ * @file    TestFbcSparseModel.cpp
+ * @brief   TestFbcSparseModel unit tests
+ * @author  SBMLTeam
+ *
+ * $Id: $
+ * $HeadURL: $
+ */
+
+#include <iostream>
+#include <check.h>
+#include <sbml/SBMLTypes.h>
+#include <sbml/util/util.h>
+#include <sbml/packages/fbc/common/FbcExtensionTypes.h>
+#include <string>
+
+/** @cond doxygenIgnored */
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+/** @endcond doxygenIgnored */
+
+
+CK_CPPSTART
+
+static Species*
+addSpecies(Model* model, const string& id)
+{
+  Species* species = model->createSpecies();
+  species->setId(id);
+  species->setCompartment("c");
+  species->setHasOnlySubstanceUnits(false);
+  species->setBoundaryCondition(false);
+  species->setConstant(false);
+  return species;
+}
+
+
+static Reaction*
+addReaction(Model* model, const string& id,
+            const string& reactant, const string& product)
+{
+  Reaction* reaction = model->createReaction();
+  reaction->setId(id);
+  reaction->setReversible(false);
+  reaction->setFast(false);
+  if (!reactant.empty())
+  {
+    SpeciesReference* ref = reaction->createReactant();
+    ref->setSpecies(reactant);
+    ref->setStoichiometry(1);
+    ref->setConstant(true);
+  }
+  if (!product.empty())
+  {
+    SpeciesReference* ref = reaction->createProduct();
+    ref->setSpecies(product);
+    ref->setStoichiometry(2);
+    ref->setConstant(true);
+  }
+  return reaction;
+}
+
+
+static void
+addBound(Model* model, const string& id, double value)
+{
+  Parameter* parameter = model->createParameter();
+  parameter->setId(id);
+  parameter->setValue(value);
+  parameter->setConstant(true);
+}
+
+
+START_TEST(test_FbcSparseModel_v2)
+{
+  FbcPkgNamespaces sbmlns(3, 1, 2);
+  SBMLDocument doc(&sbmlns);
+  Model* model = doc.createModel();
+  FbcModelPlugin* mplugin =
+    static_cast<FbcModelPlugin*>(model->getPlugin("fbc"));
+
+  Compartment* c = model->createCompartment();
+  c->setId("c");
+  c->setConstant(true);
+  addSpecies(model, "A");
+  addSpecies(model, "B");
+  addSpecies(model, "C");
+
+  addBound(model, "zero", 0);
+  addBound(model, "thousand", 1000);
+
+  GeneProduct* gene = mplugin->createGeneProduct();
+  gene->setId("g1");
+  gene->setLabel("g1");
+  gene = mplugin->createGeneProduct();
+  gene->setId("g2");
+  gene->setLabel("g2");
+
+  // R0: -> 2 A, R1: A -> 2 B, R2: B -> 2 B (a single entry of +1), R3: C ->
+  Reaction* reaction = addReaction(model, "R0", "", "A");
+  FbcReactionPlugin* rplugin =
+    static_cast<FbcReactionPlugin*>(reaction->getPlugin("fbc"));
+  rplugin->setLowerFluxBound("zero");
+  rplugin->setUpperFluxBound("thousand");
+  rplugin->createGeneProductAssociation()->setAssociation("g1 and (g2 or g3)",
+                                                          true, true);
+
+  reaction = addReaction(model, "R1", "A", "B");
+  rplugin = static_cast<FbcReactionPlugin*>(reaction->getPlugin("fbc"));
+  rplugin->setLowerFluxBound("zero");
+  rplugin->createGeneProductAssociation()->setAssociation("g2", true, false);
+
+  addReaction(model, "R2", "B", "B");
+  addReaction(model, "R3", "C", "");
+
+  Objective* objective = mplugin->createObjective();
+  objective->setId("obj");
+  objective->setType(OBJECTIVE_TYPE_MAXIMIZE);
+  FluxObjective* flux = objective->createFluxObjective();
+  flux->setReaction("R1");
+  flux->setCoefficient(2);
+  mplugin->setActiveObjectiveId("obj");
+
+  FbcSparseModel sparse;
+  fail_unless(sparse.populate(model) == LIBSBML_OPERATION_SUCCESS);
+
+  fail_unless(sparse.getNumSpecies() == 3);
+  fail_unless(sparse.getNumReactions() == 4);
+  fail_unless(sparse.getNumEntries() == 5);
+  fail_unless(sparse.getSpeciesId(2) == "C");
+  fail_unless(sparse.getReactionId(1) == "R1");
+  fail_unless(sparse.getReactionId(4).empty());
+
+  const int expectedStarts[] = { 0, 1, 3, 4, 5 };
+  const int expectedRows[] = { 0, 0, 1, 1, 2 };
+  const double expectedValues[] = { 2, -1, 2, 1, -1 };
+  for (unsigned int i = 0; i < 5; ++i)
+  {
+    fail_unless(sparse.getColumnStarts()[i] == expectedStarts[i]);
+    fail_unless(sparse.getRowIndices()[i] == expectedRows[i]);
+    fail_unless(sparse.getValues()[i] == expectedValues[i]);
+  }
+
+  fail_unless(sparse.getLowerBounds()[0] == 0);
+  fail_unless(sparse.getUpperBounds()[0] == 1000);
+  fail_unless(sparse.getLowerBounds()[1] == 0);
+  fail_unless(util_isInf(sparse.getUpperBounds()[1]) == 1);
+  fail_unless(util_isInf(sparse.getLowerBounds()[2]) == -1);
+
+  fail_unless(sparse.getMaximize() == true);
+  fail_unless(sparse.getObjectiveCoefficients()[0] == 0);
+  fail_unless(sparse.getObjectiveCoefficients()[1] == 2);
+
+  // g1 g2 g3 or 2 and 2 | g2
+  fail_unless(sparse.getNumGeneProducts() == 3);
+  fail_unless(sparse.getGeneProductId(2) == "g3");
+  fail_unless(sparse.getNumAssociationTokens() == 8);
+  const int expectedTokens[] = { 0, 1, 2, FBC_GPR_TOKEN_OR, 2,
+                                 FBC_GPR_TOKEN_AND, 2, 1 };
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    fail_unless(sparse.getAssociationTokens()[i] == expectedTokens[i]);
+  }
+  fail_unless(sparse.getAssociationStarts()[1] == 7);
+  fail_unless(sparse.getAssociationStarts()[2] == 8);
+  fail_unless(sparse.getAssociationStarts()[4] == 8);
+
+  int starts[5];
+  int rows[5];
+  double values[5];
+  fail_unless(sparse.copyMatrix(starts, rows, values)
+              == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(starts[4] == 5);
+  fail_unless(rows[4] == 2);
+  fail_unless(values[1] == -1);
+  fail_unless(sparse.copyMatrix(NULL, rows, values)
+              == LIBSBML_INVALID_OBJECT);
+
+  double lower[4];
+  double upper[4];
+  double coefficients[4];
+  fail_unless(sparse.copyBounds(lower, upper, coefficients)
+              == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(upper[0] == 1000);
+  fail_unless(coefficients[1] == 2);
+}
+END_TEST
+
+
+START_TEST(test_FbcSparseModel_canonical)
+{
+  FbcPkgNamespaces sbmlns(3, 1, 2);
+  SBMLDocument doc(&sbmlns);
+  Model* model = doc.createModel();
+
+  Compartment* c = model->createCompartment();
+  c->setId("c");
+  c->setConstant(true);
+  addSpecies(model, "A");
+  addSpecies(model, "B");
+  addSpecies(model, "C");
+
+  // R0: C -> 2 A, listed against the order of the rows; R1: B -> B, whose
+  // entries cancel
+  addReaction(model, "R0", "C", "A");
+  Reaction* reaction = addReaction(model, "R1", "B", "");
+  SpeciesReference* ref = reaction->createProduct();
+  ref->setSpecies("B");
+  ref->setStoichiometry(1);
+  ref->setConstant(true);
+
+  FbcSparseModel sparse;
+  fail_unless(sparse.populate(model) == LIBSBML_OPERATION_SUCCESS);
+
+  fail_unless(sparse.getNumEntries() == 2);
+  fail_unless(sparse.getColumnStarts()[1] == 2);
+  fail_unless(sparse.getColumnStarts()[2] == 2);
+  fail_unless(sparse.getRowIndices()[0] == 0);
+  fail_unless(sparse.getValues()[0] == 2);
+  fail_unless(sparse.getRowIndices()[1] == 2);
+  fail_unless(sparse.getValues()[1] == -1);
+}
+END_TEST
+
+
+START_TEST(test_FbcSparseModel_elements)
+{
+  FbcPkgNamespaces sbmlns(3, 1, 2);
+  SBMLDocument doc(&sbmlns);
+  Model* model = doc.createModel();
+
+  Compartment* c = model->createCompartment();
+  c->setId("c");
+  c->setConstant(true);
+  addSpecies(model, "A");
+  addSpecies(model, "B");
+  addBound(model, "zero", 0);
+
+  // R0: A -> 2 B, where A has no stoichiometry and counts as 1
+  Reaction* reaction = addReaction(model, "R0", "A", "B");
+  reaction->getReactant(0)->unsetStoichiometry();
+  FbcReactionPlugin* rplugin =
+    static_cast<FbcReactionPlugin*>(reaction->getPlugin("fbc"));
+  rplugin->setLowerFluxBound("zero");
+  rplugin->createGeneProductAssociation()->setAssociation("g1", true, true);
+
+  FbcSparseModel sparse;
+  fail_unless(sparse.populate(model) == LIBSBML_OPERATION_SUCCESS);
+
+  fail_unless(sparse.getNumEntries() == 2);
+  fail_unless(sparse.getColumnStart(0) == 0);
+  fail_unless(sparse.getColumnStart(1) == 2);
+  fail_unless(sparse.getColumnStart(2) == -1);
+  fail_unless(sparse.getRowIndex(0) == 0);
+  fail_unless(sparse.getRowIndex(1) == 1);
+  fail_unless(sparse.getRowIndex(2) == -1);
+  fail_unless(sparse.getValue(0) == -1);
+  fail_unless(sparse.getValue(1) == 2);
+  fail_unless(util_isNaN(sparse.getValue(2)));
+
+  fail_unless(sparse.getLowerBound(0) == 0);
+  fail_unless(util_isInf(sparse.getUpperBound(0)) == 1);
+  fail_unless(util_isNaN(sparse.getLowerBound(1)));
+  fail_unless(util_isNaN(sparse.getUpperBound(1)));
+  fail_unless(sparse.getObjectiveCoefficient(0) == 0);
+  fail_unless(util_isNaN(sparse.getObjectiveCoefficient(1)));
+
+  fail_unless(sparse.getAssociationStart(0) == 0);
+  fail_unless(sparse.getAssociationStart(1) == 1);
+  fail_unless(sparse.getAssociationStart(2) == -1);
+  fail_unless(sparse.getAssociationToken(0) == 0);
+  fail_unless(sparse.getAssociationToken(1) == FBC_GPR_TOKEN_UNKNOWN_GENE);
+}
+END_TEST
+
+
+START_TEST(test_FbcSparseModel_v1)
+{
+  FbcPkgNamespaces sbmlns(3, 1, 1);
+  SBMLDocument doc(&sbmlns);
+  Model* model = doc.createModel();
+  FbcModelPlugin* mplugin =
+    static_cast<FbcModelPlugin*>(model->getPlugin("fbc"));
+
+  Compartment* c = model->createCompartment();
+  c->setId("c");
+  c->setConstant(true);
+  addSpecies(model, "A");
+  addReaction(model, "R0", "", "A");
+  addReaction(model, "R1", "A", "");
+
+  FluxBound* bound = mplugin->createFluxBound();
+  bound->setReaction("R0");
+  bound->setOperation(FLUXBOUND_OPERATION_GREATER_EQUAL);
+  bound->setValue(-5);
+  bound = mplugin->createFluxBound();
+  bound->setReaction("R0");
+  bound->setOperation(FLUXBOUND_OPERATION_LESS_EQUAL);
+  bound->setValue(10);
+  bound = mplugin->createFluxBound();
+  bound->setReaction("R1");
+  bound->setOperation(FLUXBOUND_OPERATION_EQUAL);
+  bound->setValue(3);
+
+  Objective* objective = mplugin->createObjective();
+  objective->setId("obj");
+  objective->setType(OBJECTIVE_TYPE_MINIMIZE);
+  FluxObjective* flux = objective->createFluxObjective();
+  flux->setReaction("R0");
+  flux->setCoefficient(1);
+  mplugin->setActiveObjectiveId("obj");
+
+  FbcSparseModel sparse;
+  fail_unless(sparse.populate(model) == LIBSBML_OPERATION_SUCCESS);
+
+  fail_unless(sparse.getLowerBounds()[0] == -5);
+  fail_unless(sparse.getUpperBounds()[0] == 10);
+  fail_unless(sparse.getLowerBounds()[1] == 3);
+  fail_unless(sparse.getUpperBounds()[1] == 3);
+  fail_unless(sparse.getMaximize() == false);
+  fail_unless(sparse.getObjectiveCoefficients()[0] == 1);
+  fail_unless(sparse.getNumAssociationTokens() == 0);
+  fail_unless(sparse.getAssociationTokens() == NULL);
+
+  fail_unless(sparse.populate(NULL) == LIBSBML_INVALID_OBJECT);
+  fail_unless(sparse.getNumReactions() == 0);
+  fail_unless(sparse.getColumnStarts()[0] == 0);
+}
+END_TEST
+
+
+Suite *
+create_suite_FbcSparseModel (void)
+{
+  Suite *suite = suite_create("FbcSparseModel");
+  TCase *tcase = tcase_create("FbcSparseModel");
+
+  tcase_add_test( tcase, test_FbcSparseModel_v2 );
+  tcase_add_test( tcase, test_FbcSparseModel_v1 );
+  tcase_add_test( tcase, test_FbcSparseModel_canonical );
+  tcase_add_test( tcase, test_FbcSparseModel_elements );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+CK_CPPEND
@@ -0,0 +1,297 @@
+/**
+ * @file    TestFluxBoundsView.cpp
+ * @brief   TestFluxBoundsView unit tests
+ * @author  SBMLTeam
+ *
+ * $Id: $
+ * $HeadURL: $
+ */
+
+#include <iostream>
+#include <check.h>
+#include <sbml/SBMLTypes.h>
+#include <sbml/util/util.h>
+#include <sbml/packages/fbc/common/FbcExtensionTypes.h>
+#include <string>
+
+/** @cond doxygenIgnored */
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+/** @endcond doxygenIgnored */
+
+
+CK_CPPSTART
+
+static Reaction*
+addReaction(Model* model, const string& id)
+{
+  Reaction* reaction = model->createReaction();
+  reaction->setId(id);
+  reaction->setReversible(false);
+  reaction->setFast(false);
+  return reaction;
+}
+
+
+static void
+addBound(Model* model, const string& id, double value)
+{
+  Parameter* parameter = model->createParameter();
+  parameter->setId(id);
+  parameter->setValue(value);
+  parameter->setConstant(true);
+  parameter->setUnits("mmol_per_gDW_per_hr");
+}
+
+
+START_TEST(test_FluxBoundsView_v2)
+{
+  FbcPkgNamespaces sbmlns(3, 1, 2);
+  SBMLDocument doc(&sbmlns);
+  Model* model = doc.createModel();
+  FbcModelPlugin* mplugin =
+    static_cast<FbcModelPlugin*>(model->getPlugin("fbc"));
+
+  addBound(model, "zero", 0);
+  addBound(model, "thousand", 1000);
+  addBound(model, "R1_max", 5);
+
+  // R0 and R1 share 'zero', R1 alone uses 'R1_max', R2 is unbounded
+  Reaction* reaction = addReaction(model, "R0");
+  FbcReactionPlugin* rplugin =
+    static_cast<FbcReactionPlugin*>(reaction->getPlugin("fbc"));
+  rplugin->setLowerFluxBound("zero");
+  rplugin->setUpperFluxBound("thousand");
+  reaction = addReaction(model, "R1");
+  rplugin = static_cast<FbcReactionPlugin*>(reaction->getPlugin("fbc"));
+  rplugin->setLowerFluxBound("zero");
+  rplugin->setUpperFluxBound("R1_max");
+  addReaction(model, "R2");
+
+  FluxBoundsView* view = mplugin->getFluxBoundsView();
+  fail_unless(view != NULL);
+  fail_unless(view == mplugin->getFluxBoundsView());
+  fail_unless(view->getModel() == model);
+  fail_unless(view->getNumReactions() == 3);
+  fail_unless(view->getReactionId(1) == "R1");
+  fail_unless(view->getReactionId(3).empty());
+  fail_unless(view->getReactionIndex("R2") == 2);
+  fail_unless(view->getReactionIndex("R3") == -1);
+
+  double* lower = view->getLowerBounds();
+  double* upper = view->getUpperBounds();
+  double* coefficients = view->getObjectiveCoefficients();
+  fail_unless(lower[0] == 0);
+  fail_unless(upper[0] == 1000);
+  fail_unless(upper[1] == 5);
+  fail_unless(util_isInf(lower[2]) == -1);
+  fail_unless(util_isInf(upper[2]) == 1);
+  fail_unless(coefficients[1] == 0);
+  fail_unless(view->getNumChangedReactions() == 0);
+
+  upper[1] = 8;
+  lower[1] = -2;
+  fail_unless(view->setBounds(2, 1, 2) == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(view->setBounds(3, 1, 2) == LIBSBML_INDEX_EXCEEDS_SIZE);
+  fail_unless(view->setObjectiveCoefficient(1, 1)
+              == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(view->setObjectiveCoefficient(3, 1)
+              == LIBSBML_INDEX_EXCEEDS_SIZE);
+  fail_unless(view->getNumChangedReactions() == 2);
+
+  // nothing reaches the model before the view is committed
+  fail_unless(model->getParameter("R1_max")->getValue() == 5);
+
+  fail_unless(view->commit() == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(view->getNumChangedReactions() == 0);
+
+  // an unshared parameter is set in place
+  fail_unless(model->getParameter("R1_max")->getValue() == 8);
+
+  // a shared parameter is left alone and the reaction given its own
+  fail_unless(model->getParameter("zero")->getValue() == 0);
+  rplugin = static_cast<FbcReactionPlugin*>(
+    model->getReaction("R1")->getPlugin("fbc"));
+  fail_unless(rplugin->getLowerFluxBound() == "R1_lower_bound");
+  Parameter* parameter = model->getParameter("R1_lower_bound");
+  fail_unless(parameter != NULL);
+  fail_unless(parameter->getValue() == -2);
+  fail_unless(parameter->getSBOTerm() == 625);
+  fail_unless(parameter->getUnits() == "mmol_per_gDW_per_hr");
+
+  // unbounded reactions are given new parameters
+  rplugin = static_cast<FbcReactionPlugin*>(
+    model->getReaction("R2")->getPlugin("fbc"));
+  fail_unless(rplugin->getLowerFluxBound() == "R2_lower_bound");
+  fail_unless(rplugin->getUpperFluxBound() == "R2_upper_bound");
+  fail_unless(model->getParameter("R2_upper_bound")->getValue() == 2);
+
+  // an objective is created for the first coefficient
+  fail_unless(mplugin->getNumObjectives() == 1);
+  Objective* objective = mplugin->getActiveObjective();
+  fail_unless(objective != NULL);
+  fail_unless(objective->getId() == "obj");
+  fail_unless(objective->getNumFluxObjectives() == 1);
+  fail_unless(objective->getFluxObjective(0)->getReaction() == "R1");
+  fail_unless(objective->getFluxObjective(0)->getCoefficient() == 1);
+
+  // writing the document leaves the model alone
+  view->getLowerBounds()[0] = -10;
+  view->getObjectiveCoefficients()[1] = 3;
+  unsigned int numParameters = model->getNumParameters();
+  char* sbml = writeSBMLToString(&doc);
+  safe_free(sbml);
+  fail_unless(view->getNumChangedReactions() == 2);
+  fail_unless(model->getParameter("zero")->getValue() == 0);
+  fail_unless(objective->getFluxObjective(0)->getCoefficient() == 1);
+
+  // a copy of the model keeps the changes not yet committed
+  Model* copy = model->clone();
+  FbcModelPlugin* cplugin =
+    static_cast<FbcModelPlugin*>(copy->getPlugin("fbc"));
+  FluxBoundsView* cview = cplugin->getFluxBoundsView();
+  fail_unless(cview != view);
+  fail_unless(cview->getModel() == copy);
+  fail_unless(cview->getNumChangedReactions() == 2);
+  fail_unless(cview->commit() == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(copy->getParameter("zero")->getValue() == -10);
+  fail_unless(model->getParameter("zero")->getValue() == 0);
+  delete copy;
+
+  // the parameter now used only by R0 is set in place
+  fail_unless(view->commit() == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(view->getNumChangedReactions() == 0);
+  fail_unless(model->getNumParameters() == numParameters);
+  fail_unless(model->getParameter("zero")->getValue() == -10);
+  fail_unless(objective->getFluxObjective(0)->getCoefficient() == 3);
+
+  // after refreshing, the view reflects reactions added through the model,
+  // and keeps the changes not yet committed
+  view->getUpperBounds()[0] = 500;
+  reaction = addReaction(model, "R3");
+  fail_unless(view->refresh() == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(view->getNumReactions() == 4);
+  fail_unless(view->getLowerBounds()[1] == -2);
+  fail_unless(view->getObjectiveCoefficients()[1] == 3);
+  fail_unless(view->getUpperBounds()[0] == 500);
+  fail_unless(view->getNumChangedReactions() == 1);
+
+  // a parameter shared through the model since the view was read is not
+  // set in place
+  rplugin = static_cast<FbcReactionPlugin*>(reaction->getPlugin("fbc"));
+  rplugin->setUpperFluxBound("R1_max");
+  view->getUpperBounds()[1] = 9;
+  fail_unless(view->commit() == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(model->getParameter("R1_max")->getValue() == 8);
+  fail_unless(model->getParameter("thousand")->getValue() == 500);
+  rplugin = static_cast<FbcReactionPlugin*>(
+    model->getReaction("R1")->getPlugin("fbc"));
+  fail_unless(rplugin->getUpperFluxBound() == "R1_upper_bound");
+  fail_unless(model->getParameter("R1_upper_bound")->getValue() == 9);
+
+  // the coefficients of several flux objectives of a reaction add up, and
+  // are committed as one
+  FluxObjective* flux = objective->createFluxObjective();
+  flux->setReaction("R1");
+  flux->setCoefficient(2);
+  fail_unless(view->refresh() == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(view->getObjectiveCoefficients()[1] == 5);
+  view->getObjectiveCoefficients()[1] = 4;
+  fail_unless(view->commit() == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(objective->getNumFluxObjectives() == 1);
+  fail_unless(objective->getFluxObjective(0)->getCoefficient() == 4);
+  fail_unless(view->refresh() == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(view->getObjectiveCoefficients()[1] == 4);
+}
+END_TEST
+
+
+START_TEST(test_FluxBoundsView_v1)
+{
+  FbcPkgNamespaces sbmlns(3, 1, 1);
+  SBMLDocument doc(&sbmlns);
+  Model* model = doc.createModel();
+  FbcModelPlugin* mplugin =
+    static_cast<FbcModelPlugin*>(model->getPlugin("fbc"));
+
+  addReaction(model, "R0");
+  addReaction(model, "R1");
+  addReaction(model, "R2");
+
+  FluxBound* bound = mplugin->createFluxBound();
+  bound->setReaction("R0");
+  bound->setOperation(FLUXBOUND_OPERATION_GREATER_EQUAL);
+  bound->setValue(-5);
+  bound = mplugin->createFluxBound();
+  bound->setReaction("R0");
+  bound->setOperation(FLUXBOUND_OPERATION_LESS_EQUAL);
+  bound->setValue(10);
+  bound = mplugin->createFluxBound();
+  bound->setReaction("R1");
+  bound->setOperation(FLUXBOUND_OPERATION_EQUAL);
+  bound->setValue(3);
+
+  FluxBoundsView* view = mplugin->getFluxBoundsView();
+  fail_unless(view->getLowerBounds()[0] == -5);
+  fail_unless(view->getUpperBounds()[0] == 10);
+  fail_unless(view->getLowerBounds()[1] == 3);
+  fail_unless(view->getUpperBounds()[1] == 3);
+
+  // R0 loses its lower bound, R1 is split, R2 is fixed
+  view->setBounds(0, util_NegInf(), 20);
+  view->setBounds(1, 1, 4);
+  view->setBounds(2, 7, 7);
+  fail_unless(view->commit() == LIBSBML_OPERATION_SUCCESS);
+
+  fail_unless(mplugin->getNumFluxBounds() == 4);
+  fail_unless(mplugin->getFluxBound(0)->getReaction() == "R0");
+  fail_unless(mplugin->getFluxBound(0)->getFluxBoundOperation()
+              == FLUXBOUND_OPERATION_LESS_EQUAL);
+  fail_unless(mplugin->getFluxBound(0)->getValue() == 20);
+  fail_unless(mplugin->getFluxBound(1)->getReaction() == "R1");
+  fail_unless(mplugin->getFluxBound(1)->getFluxBoundOperation()
+              == FLUXBOUND_OPERATION_GREATER_EQUAL);
+  fail_unless(mplugin->getFluxBound(1)->getValue() == 1);
+  fail_unless(mplugin->getFluxBound(2)->getReaction() == "R1");
+  fail_unless(mplugin->getFluxBound(2)->getFluxBoundOperation()
+              == FLUXBOUND_OPERATION_LESS_EQUAL);
+  fail_unless(mplugin->getFluxBound(2)->getValue() == 4);
+  fail_unless(mplugin->getFluxBound(3)->getReaction() == "R2");
+  fail_unless(mplugin->getFluxBound(3)->getFluxBoundOperation()
+              == FLUXBOUND_OPERATION_EQUAL);
+  fail_unless(mplugin->getFluxBound(3)->getValue() == 7);
+
+  view->refresh();
+  fail_unless(util_isInf(view->getLowerBounds()[0]) == -1);
+  fail_unless(view->getUpperBounds()[1] == 4);
+  fail_unless(view->getLowerBounds()[2] == 7);
+
+  // a copy of the model gets a view of its own
+  Model* copy = model->clone();
+  FbcModelPlugin* cplugin =
+    static_cast<FbcModelPlugin*>(copy->getPlugin("fbc"));
+  fail_unless(cplugin->getFluxBoundsView() != view);
+  fail_unless(cplugin->getFluxBoundsView()->getModel() == copy);
+  delete copy;
+}
+END_TEST
+
+
+Suite *
+create_suite_FluxBoundsView (void)
+{
+  Suite *suite = suite_create("FluxBoundsView");
+  TCase *tcase = tcase_create("FluxBoundsView");
+
+  tcase_add_test( tcase, test_FluxBoundsView_v2 );
+  tcase_add_test( tcase, test_FluxBoundsView_v1 );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+CK_CPPEND
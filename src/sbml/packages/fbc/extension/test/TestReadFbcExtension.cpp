@@ -453,6 +453,84 @@ START_TEST(test_FbcExtension_read_and_convert)
 END_TEST
 
 
+START_TEST(test_FbcExtension_convert_cobra_notes)
+{
+  SBMLDocument document(2, 4);
+  Model* model = document.createModel();
+  Compartment* c = model->createCompartment();
+  c->setId("c");
+
+  Species* species = model->createSpecies();
+  species->setId("A");
+  species->setCompartment("c");
+  species->setNotes(
+    "<body xmlns='http://www.w3.org/1999/xhtml'>"
+    "  <p>Formula: C6H12O6</p>"
+    "  <p>charge: -2</p>"
+    "</body>", true);
+
+  species = model->createSpecies();
+  species->setId("B");
+  species->setCompartment("c");
+  species->setNotes(
+    "<body xmlns='http://www.w3.org/1999/xhtml'>"
+    "  <p>FORMULA: </p>"
+    "  <p>CHARGE: none</p>"
+    "</body>", true);
+
+  Reaction* reaction = model->createReaction();
+  reaction->setId("R1");
+  reaction->setNotes(
+    "<body xmlns='http://www.w3.org/1999/xhtml'>"
+    "  <p>SUBSYSTEM: S &amp; T</p>"
+    "  <p>Gene_Association: (b0001 and b0002) or 10026.1</p>"
+    "</body>", true);
+  SpeciesReference* ref = reaction->createReactant();
+  ref->setSpecies("A");
+  KineticLaw* kineticLaw = reaction->createKineticLaw();
+  kineticLaw->setMath(SBML_parseFormula("FLUX_VALUE"));
+  kineticLaw->createParameter()->setId("FLUX_VALUE");
+
+  reaction = model->createReaction();
+  reaction->setId("R2");
+  reaction->setNotes(
+    "<body xmlns='http://www.w3.org/1999/xhtml'>"
+    "  <p>GENE_ASSOCIATION: </p>"
+    "</body>", true);
+  kineticLaw = reaction->createKineticLaw();
+  kineticLaw->setMath(SBML_parseFormula("FLUX_VALUE"));
+  kineticLaw->createParameter()->setId("FLUX_VALUE");
+
+  ConversionProperties props;
+  props.addOption("convert cobra", true);
+  props.addOption("checkCompatibility", false);
+  fail_unless(document.convert(props) == LIBSBML_OPERATION_SUCCESS);
+
+  FbcSpeciesPlugin* splug = 
+    dynamic_cast<FbcSpeciesPlugin*>(model->getSpecies("A")->getPlugin("fbc"));
+  fail_unless(splug != NULL);
+  fail_unless(splug->getChemicalFormula() == "C6H12O6");
+  fail_unless(splug->isSetCharge());
+  fail_unless(splug->getCharge() == -2);
+
+  splug = 
+    dynamic_cast<FbcSpeciesPlugin*>(model->getSpecies("B")->getPlugin("fbc"));
+  fail_unless(splug != NULL);
+  fail_unless(!splug->isSetChemicalFormula());
+  fail_unless(!splug->isSetCharge());
+
+  FbcModelPlugin* mplug = 
+    dynamic_cast<FbcModelPlugin*>(model->getPlugin("fbc"));
+  fail_unless(mplug != NULL);
+  fail_unless(mplug->getNumGeneAssociations() == 1);
+  GeneAssociation* ga = mplug->getGeneAssociation(0);
+  fail_unless(ga->getReaction() == "R1");
+  fail_unless(ga->getAssociation()->toInfix() == 
+              "((b0001 and b0002) or 10026.1)");
+}
+END_TEST
+
+
 START_TEST(test_FbcExtension_read_and_convert_V1ToV2)
 {
   // part 1 ... convert cobra to v1
@@ -618,6 +696,7 @@ create_suite_ReadFbcExtension(void)
   tcase_add_test(tcase, test_FbcExtension_read_L3V1V1_with_wonky_chemicals);
   tcase_add_test(tcase, test_FbcExtension_read_and_validate_chemicals);
   tcase_add_test(tcase, test_FbcExtension_read_and_convert);
+  tcase_add_test(tcase, test_FbcExtension_convert_cobra_notes);
   tcase_add_test(tcase, test_FbcExtension_read_and_convert_V1ToV2);
   tcase_add_test(tcase, test_FbcExtension_read_L3V2V1_check_id);
   tcase_add_test(tcase, test_FbcExtension_read_L3V1V3);
@@ -28,6 +28,8 @@ Suite *create_suite_FbcExtension (void);
 Suite *create_suite_WriteFbcExtension (void);
 Suite *create_suite_ReadFbcExtension (void);
 Suite *create_suite_FbcAssociation (void);
+Suite *create_suite_FbcSparseModel (void);
+Suite *create_suite_FluxBoundsView (void);
 
 
 /**
@@ -74,6 +76,8 @@ main (int argc, char* argv[])
   srunner_add_suite(runner, create_suite_WriteFbcExtension());
   srunner_add_suite(runner, create_suite_ReadFbcExtension());
   srunner_add_suite(runner, create_suite_FbcAssociation());
+  srunner_add_suite(runner, create_suite_FbcSparseModel());
+  srunner_add_suite(runner, create_suite_FluxBoundsView());
 
   if (argc > 1 && !strcmp(argv[1], "-nofork"))
   {
@@ -50,6 +50,7 @@
 #include <sbml/packages/fbc/sbml/FbcAnd.h>
 #include <sbml/packages/fbc/sbml/FbcOr.h>
 #include <sbml/packages/fbc/sbml/GeneProductRef.h>
+#include <sbml/packages/fbc/util/InfixAssociationReader.h>
 #include <sbml/math/FormulaParser.h>
 #include <sbml/util/util.h>
 
@@ -369,6 +370,53 @@ Association* toAssociation(const ASTNode* node)
 
 Association*
 Association::parseInfixAssociation(const std::string& association)
+{
+  // only names and operators the formula parser reads the same way are
+  // read directly, so that the results of both agree
+  InfixAssociationReader reader(association, true);
+  size_t root = reader.read();
+  if (root == string::npos)
+    return parseInfixAssociationWithFormulaParser(association);
+
+  // build the associations top down, so that no subtree is copied, from
+  // copies of an empty association, which are cheaper to make than new ones
+  Association prototype;
+  Association* result = prototype.clone();
+  vector<pair<Association*, size_t> > pending;
+  pending.push_back(make_pair(result, root));
+  while (!pending.empty())
+  {
+    Association* current = pending.back().first;
+    const InfixAssociationReader::Node& node = 
+      reader.getNode(pending.back().second);
+    pending.pop_back();
+
+    if (node.type == InfixAssociationReader::NAME)
+    {
+      current->mType = GENE_ASSOCIATION;
+      current->mReference = reader.getName(node);
+      continue;
+    }
+
+    current->mType = (node.type == InfixAssociationReader::AND)
+                   ? AND_ASSOCIATION : OR_ASSOCIATION;
+
+    for (size_t i = 0; i < node.children.size(); ++i)
+    {
+      Association* child = prototype.clone();
+      current->mAssociations.push_back(child);
+      pending.push_back(make_pair(child, node.children[i]));
+    }
+  }
+
+  return result;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+Association*
+Association::parseInfixAssociationWithFormulaParser(
+  const std::string& association)
 {
   std::string tweaked(association);
   replaceAllSubStrings(tweaked, " and ", " * ");
@@ -400,6 +448,7 @@ Association::parseInfixAssociation(const std::string& association)
   
   return result;
 }
+/** @endcond */
 
 
 
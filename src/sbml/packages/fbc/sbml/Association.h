@@ -711,6 +711,17 @@ public:
   #endif /* !SWIG */
 
 protected:
+  /** @cond doxygenLibsbmlInternal */
+  /**
+   * Parses the gene association by converting it into a formula and
+   * reading that with SBML_parseFormula().  Used for the associations
+   * that parseInfixAssociation() does not read directly.
+   */
+  static Association* 
+  parseInfixAssociationWithFormulaParser(const std::string& association);
+  /** @endcond */
+
+
   /** @cond doxygenLibsbmlInternal */
   /**
    * Create and return an SBML object of this class, if present.
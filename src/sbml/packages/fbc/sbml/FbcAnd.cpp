@@ -271,19 +271,27 @@ FbcAnd::getNumAssociations() const
 std::string 
 FbcAnd::toInfix(bool usingId) const
 {
-  if (mAssociations.size() == 0) return "";
+  return FbcAssociation::toInfix(usingId);
+}
+
 
-  stringstream str;
-  str << "(";
-  str << mAssociations.get(0)->toInfix(usingId);
-  for (size_t pos = 1; pos < mAssociations.size(); ++pos)
+/** @cond doxygenLibsbmlInternal */
+void
+FbcAnd::writeInfix(std::string& infix, bool usingId,
+                   const FbcModelPlugin* plugin) const
+{
+  if (mAssociations.size() == 0) return;
+
+  infix += "(";
+  mAssociations.get(0)->writeInfix(infix, usingId, plugin);
+  for (unsigned int pos = 1; pos < mAssociations.size(); ++pos)
   {
-    str << " and ";
-    str << mAssociations.get((unsigned int)pos)->toInfix(usingId);
+    infix += " and ";
+    mAssociations.get(pos)->writeInfix(infix, usingId, plugin);
   }
-  str << ")";
-  return str.str();
+  infix += ")";
 }
+/** @endcond */
 
 
 
@@ -49,10 +49,16 @@
 #include <sbml/packages/fbc/sbml/FbcAnd.h>
 #include <sbml/packages/fbc/sbml/FbcOr.h>
 #include <sbml/packages/fbc/sbml/GeneProductRef.h>
+#include <sbml/packages/fbc/util/InfixAssociationReader.h>
 
-#include <sbml/math/FormulaParser.h>
 #include <sbml/util/util.h>
 
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
 using namespace std;
 
 
@@ -236,208 +242,296 @@ FbcAssociation::accept (SBMLVisitor& v) const
   /** @endcond */
 
 
-FbcAssociation* toAssociation(const ASTNode* node, FbcModelPlugin* plugin, bool usingId, bool addMissingGP);
+/** @cond doxygenLibsbmlInternal */
 
-void addChildren(FbcAssociation* association, const ASTNode* node, 
-                 const ASTNode *current, FbcModelPlugin* plugin, 
-                 bool usingId, bool addMissingGP)
+/*
+ * The digits and punctuation of a gene product label are spelled out when
+ * the label is used to build an id; the id of a new gene product is 'gp_'
+ * followed by the label spelled out this way.
+ */
+static const char* 
+spelledOutLabelChar(char c)
 {
-
-  if (node->getType() == AST_TIMES || node->getType() == AST_PLUS)
+  switch (c)
   {
-    for (unsigned int i = 0; i < node->getNumChildren(); ++i)
-    {
-      ASTNode* astChild = node->getChild(i);
-      if (astChild->getType() == current->getType())
-      {
-        addChildren(association, astChild, node, plugin, usingId, addMissingGP);
-        continue;
-      }
+  case '-': return "__MINUS__";
+  case ':': return "__COLON__";
+  case '.': return "__DOT__";
+  case '1': return "__ONE__";
+  case '2': return "__TWO__";
+  case '3': return "__THREE__";
+  case '4': return "__FOUR__";
+  case '5': return "__FIVE__";
+  case '6': return "__SIX__";
+  case '7': return "__SEVEN__";
+  case '8': return "__EIGHT__";
+  case '9': return "__NINE__";
+  case '0': return "__ZERO__";
+  default:  return NULL;
+  }
+}
 
-      FbcAssociation* child = toAssociation(astChild, plugin, usingId, addMissingGP);
-      if (child == NULL)
-        continue;
 
-      FbcAnd* andAssociation = dynamic_cast<FbcAnd*>(association);
-      if (andAssociation != NULL)
-      {
-        andAssociation->addAssociation(child);
-      }
-      else
-      {
-        FbcOr* orAssociation = dynamic_cast<FbcOr*>(association);
-        if (orAssociation != NULL)
-          orAssociation->addAssociation(child);
-      }
-      delete child;
-    }
+static string
+spellOutLabel(const string& label)
+{
+  string result;
+  result.reserve(label.size() * 2);
+  for (size_t i = 0; i < label.size(); ++i)
+  {
+    const char* spelled = spelledOutLabelChar(label[i]);
+    if (spelled != NULL)
+      result += spelled;
+    else
+      result += label[i];
   }
-  else{
-    FbcAssociation* child = toAssociation(node, plugin, usingId, addMissingGP);
-    if (child == NULL)
-      return;
+  return result;
+}
+
+
+static string
+unspellLabel(const string& spelled)
+{
+  static const char* characters = "-:.1234567890";
 
-    FbcAnd* andAssociation = dynamic_cast<FbcAnd*>(association);    
-    if (andAssociation != NULL)
+  string result;
+  result.reserve(spelled.size());
+  size_t pos = 0;
+  while (pos < spelled.size())
+  {
+    bool replaced = false;
+    if (spelled.compare(pos, 2, "__") == 0)
     {
-      andAssociation->addAssociation(child);
+      for (const char* c = characters; *c != '\0'; ++c)
+      {
+        const char* word = spelledOutLabelChar(*c);
+        size_t length = strlen(word);
+        if (spelled.compare(pos, length, word) == 0)
+        {
+          result += *c;
+          pos += length;
+          replaced = true;
+          break;
+        }
+      }
     }
-    else
+    if (!replaced)
     {
-      FbcOr* orAssociation = dynamic_cast<FbcOr*>(association);
-      if (orAssociation != NULL)
-        orAssociation->addAssociation(child);
+      result += spelled[pos++];
     }
-
-    delete child;
-
   }
+  return result;
 }
 
 
-FbcAssociation* toAssociation(const ASTNode* node, FbcModelPlugin* plugin, 
-                               bool usingId, bool addMissingGP)
+/*
+ * Builds the association read from an infix string by an
+ * InfixAssociationReader that accepts any name.  Gene products are only
+ * looked up (and created) once the whole string has been read
+ * successfully.
+ */
+class InfixAssociationParser
 {
-  if (node == NULL)
-    return NULL;
+public:
+
+  InfixAssociationParser(const string& infix)
+    : mReader(infix, false)
+    , mAndPrototype(NULL)
+    , mOrPrototype(NULL)
+    , mRefPrototype(NULL)
+  {
+  }
+
+
+  ~InfixAssociationParser()
+  {
+    delete mAndPrototype;
+    delete mOrPrototype;
+    delete mRefPrototype;
+  }
+
+
+  /*
+   * Parses the string and returns the resulting association, or NULL if
+   * the string is not a valid association.
+   */
+  FbcAssociation* parse(FbcModelPlugin* plugin, bool usingId, 
+                        bool addMissingGP)
+  {
+    size_t root = mReader.read();
+    if (root == string::npos)
+      return NULL;
+
+    FbcAssociation* result = createAssociation(mReader.getNode(root).type);
+    build(root, result, plugin, usingId, addMissingGP);
+    return result;
+  }
 
-  if (node->getType() == AST_NAME)
+private:
+
+  typedef InfixAssociationReader::NodeType NodeType;
+
+
+  /*
+   * Returns the id of the gene product with the given name (a label, or
+   * an id if 'usingId' is true), creating the gene product if asked to.
+   */
+  static string resolveGeneProduct(const string& name, FbcModelPlugin* plugin,
+                                   bool usingId, bool addMissingGP)
   {
-    std::string name = node->getName();
-    if (!usingId)
+    if (usingId)
     {
-      replaceAllSubStrings(name, "__MINUS__", "-");
-      replaceAllSubStrings(name, "__COLON__", ":");
-      replaceAllSubStrings(name, "__DOT__", ".");
-      replaceAllSubStrings(name, "__ONE__", "1");
-      replaceAllSubStrings(name, "__TWO__", "2");
-      replaceAllSubStrings(name, "__THREE__", "3");
-      replaceAllSubStrings(name, "__FOUR__", "4");
-      replaceAllSubStrings(name, "__FIVE__", "5");
-      replaceAllSubStrings(name, "__SIX__", "6");
-      replaceAllSubStrings(name, "__SEVEN__", "7");
-      replaceAllSubStrings(name, "__EIGHT__", "8");
-      replaceAllSubStrings(name, "__NINE__", "9");
-      replaceAllSubStrings(name, "__ZERO__", "0");
+      if (plugin->getGeneProduct(name) == NULL && addMissingGP)
+      {
+        GeneProduct* prod = plugin->createGeneProduct();
+        prod->setId(name);
+        prod->setLabel(name);
+      }
+      return name;
     }
 
-    GeneProduct* prod = NULL;
-    if (usingId)
+    string spelled = spellOutLabel(name);
+    string label = unspellLabel(spelled);
+
+    GeneProduct* prod = plugin->getGeneProductByLabel(spelled);
+    if (prod == NULL)
+      prod = plugin->getGeneProductByLabel(label);
+    if (prod != NULL)
+      return prod->getId();
+
+    string base("gp_");
+    base += spelled;
+    string id = base;
+    int count = 0;
+    while (plugin->getGeneProduct(id))
     {
-      prod = plugin->getGeneProduct(name);
+      stringstream str;  str << base << "_" << ++count;
+      id = str.str();
     }
-    else
+    if (addMissingGP)
     {
-      prod = plugin->getGeneProductByLabel(node->getName());
-      if (prod == NULL)
-        prod = plugin->getGeneProductByLabel(name);
+      prod = plugin->createGeneProduct();
+      prod->setId(id);
+      prod->setLabel(label);
     }
-    string id;
-    if (prod == NULL)
+    return id;
+  }
+
+
+  /*
+   * Returns a new, empty association of the given type.  Children are
+   * copied from a prototype, which is much cheaper than constructing them
+   * with the namespaces of their parent.
+   */
+  FbcAssociation* createAssociation(NodeType type)
+  {
+    FbcAssociation*& prototype = (type == InfixAssociationReader::OR) 
+                               ? mOrPrototype
+                               : (type == InfixAssociationReader::AND) 
+                               ? mAndPrototype
+                               : mRefPrototype;
+    if (prototype == NULL)
     {
-      if (usingId)
-      {
-        id = name;
-      }
+      if (type == InfixAssociationReader::OR)
+        prototype = new FbcOr();
+      else if (type == InfixAssociationReader::AND)
+        prototype = new FbcAnd();
       else
+        prototype = new GeneProductRef();
+    }
+    return prototype->clone();
+  }
+
+
+  /*
+   * Builds the association top down from the nodes, with an explicit stack
+   * of the associations still to be filled in.
+   */
+  void build(size_t root, FbcAssociation* result, 
+             FbcModelPlugin* plugin, bool usingId, bool addMissingGP)
+  {
+    vector<pair<FbcAssociation*, size_t> > pending;
+    pending.push_back(make_pair(result, root));
+    while (!pending.empty())
+    {
+      FbcAssociation* association = pending.back().first;
+      const InfixAssociationReader::Node& node = 
+        mReader.getNode(pending.back().second);
+      pending.pop_back();
+
+      if (node.type == InfixAssociationReader::NAME)
       {
-        string base("gp_");
-        base += node->getName();
-        id = base;
-        int count = 0;
-        while (plugin->getGeneProduct(id))
-        {
-          stringstream str;  str << base << "_" << ++count;
-          id = str.str();
-        }
+        static_cast<GeneProductRef*>(association)->setGeneProduct(
+          resolveGeneProduct(mReader.getName(node), 
+                             plugin, usingId, addMissingGP));
+        continue;
       }
-      if (addMissingGP)
+
+      ListOfFbcAssociations* children = 
+        (node.type == InfixAssociationReader::AND)
+        ? static_cast<FbcAnd*>(association)->getListOfAssociations()
+        : static_cast<FbcOr*>(association)->getListOfAssociations();
+      size_t first = pending.size();
+      for (size_t i = 0; i < node.children.size(); ++i)
       {
-        prod = plugin->createGeneProduct();
-        if (usingId)
-        {
-          prod->setId(name);
-          prod->setLabel(name);
-        }
-        else
-        {
-          prod->setId(id);
-          prod->setLabel(name);
-        }
+        size_t child = node.children[i];
+        FbcAssociation* created = 
+          createAssociation(mReader.getNode(child).type);
+        children->appendAndOwn(created);
+        pending.push_back(make_pair(created, child));
       }
-    }
-    else
-    {
-      id = prod->getId();
-    }
 
-    GeneProductRef* a = new GeneProductRef();
-    a->setGeneProduct(id);
-    return a;
-  }
-  else if (node->getType() == AST_PLUS)
-  {
-    FbcOr* a = new FbcOr();
-    addChildren(a, node, node, plugin, usingId, addMissingGP);
-    return a;
-  }
-  else if (node->getType() == AST_TIMES)
-  {
-    FbcAnd* a = new FbcAnd();
-    addChildren(a, node, node, plugin, usingId, addMissingGP);
-    return a;
+      // gene products are created in the order of their names
+      reverse(pending.begin() + first, pending.end());
+    }
   }
-  return NULL;
-}
 
 
+  InfixAssociationReader mReader;
+
+  FbcAssociation* mAndPrototype;
+  FbcAssociation* mOrPrototype;
+  FbcAssociation* mRefPrototype;
+};
+
+/** @endcond */
 
 
 FbcAssociation* 
 FbcAssociation::parseFbcInfixAssociation(const std::string& association, FbcModelPlugin* plugin,
                                           bool usingId, bool addMissingGP)
 {
-  std::string tweaked(association);
-  replaceAllSubStrings(tweaked, " and ", " * ");
-  replaceAllSubStrings(tweaked, " AND ", " * ");
-  replaceAllSubStrings(tweaked, " or ", " + ");
-  replaceAllSubStrings(tweaked, " OR ", " + ");
-  if (!usingId)
-  {
-    replaceAllSubStrings(tweaked, "-", "__MINUS__");
-    replaceAllSubStrings(tweaked, ":", "__COLON__");
-    replaceAllSubStrings(tweaked, ".", "__DOT__");
-    replaceAllSubStrings(tweaked, "1", "__ONE__");
-    replaceAllSubStrings(tweaked, "2", "__TWO__");
-    replaceAllSubStrings(tweaked, "3", "__THREE__");
-    replaceAllSubStrings(tweaked, "4", "__FOUR__");
-    replaceAllSubStrings(tweaked, "5", "__FIVE__");
-    replaceAllSubStrings(tweaked, "6", "__SIX__");
-    replaceAllSubStrings(tweaked, "7", "__SEVEN__");
-    replaceAllSubStrings(tweaked, "8", "__EIGHT__");
-    replaceAllSubStrings(tweaked, "9", "__NINE__");
-    replaceAllSubStrings(tweaked, "0", "__ZERO__");
-  }
-
-  ASTNode* node = SBML_parseFormula(tweaked.c_str());
-
-  if (node == NULL)
+  if (plugin == NULL)
     return NULL;
 
-  FbcAssociation* result = toAssociation(node, plugin, usingId, addMissingGP);
-
-  delete node;
+  InfixAssociationParser parser(association);
+  return parser.parse(plugin, usingId, addMissingGP);
+}
 
-  return result;
 
+std::string
+FbcAssociation::toInfix(bool usingId) const
+{
+  // the gene products are looked up in the plugin of the main model
+  const FbcModelPlugin* plugin = NULL;
+  const SBMLDocument* doc = getSBMLDocument();
+  if (doc != NULL && doc->getModel() != NULL)
+  {
+    plugin = dynamic_cast<const FbcModelPlugin*>(doc->getModel()->getPlugin("fbc"));
+  }
 
+  std::string infix;
+  writeInfix(infix, usingId, plugin);
+  return infix;
 }
 
-std::string
-FbcAssociation::toInfix(bool usingId) const
+
+/** @cond doxygenLibsbmlInternal */
+void
+FbcAssociation::writeInfix(std::string&, bool, const FbcModelPlugin*) const
 {
-  return "";
 }
+/** @endcond */
 
 
 /** @cond doxygenLibsbmlInternal */
@@ -325,6 +325,17 @@ public:
   virtual std::string toInfix(bool usingId=false) const;
 
 
+  /** @cond doxygenLibsbmlInternal */
+  /**
+   * Appends the infix representation of this association to 'infix'.
+   * The gene products are looked up in the given plugin, which may be
+   * @c NULL.
+   */
+  virtual void writeInfix(std::string& infix, bool usingId,
+                          const FbcModelPlugin* plugin) const;
+  /** @endcond */
+
+
   /** @cond doxygenLibsbmlInternal */
 
   /**
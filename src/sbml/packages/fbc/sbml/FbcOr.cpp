@@ -283,20 +283,27 @@ FbcOr::getNumAssociations() const
 std::string 
 FbcOr::toInfix(bool usingId) const
 {
-  if (mAssociations.size() == 0) return "";
+  return FbcAssociation::toInfix(usingId);
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+void
+FbcOr::writeInfix(std::string& infix, bool usingId,
+                  const FbcModelPlugin* plugin) const
+{
+  if (mAssociations.size() == 0) return;
 
-  stringstream str;
-  str << "(";
-  str << mAssociations.get(0)->toInfix(usingId);
-  for (size_t pos = 1; pos < mAssociations.size(); ++pos)
+  infix += "(";
+  mAssociations.get(0)->writeInfix(infix, usingId, plugin);
+  for (unsigned int pos = 1; pos < mAssociations.size(); ++pos)
   {
-    str << " or ";
-    str << mAssociations.get((unsigned int)pos)->toInfix(usingId);
+    infix += " or ";
+    mAssociations.get(pos)->writeInfix(infix, usingId, plugin);
   }
-  str << ")";
-  return str.str();
-
+  infix += ")";
 }
+/** @endcond */
 
 
 /*
@@ -267,6 +267,12 @@ public:
   */
   virtual std::string toInfix(bool usingId=false) const;
 
+
+  /** @cond doxygenLibsbmlInternal */
+  virtual void writeInfix(std::string& infix, bool usingId,
+                          const FbcModelPlugin* plugin) const;
+  /** @endcond */
+
   /**
    * Creates a new FbcAnd object, adds it to this FbcOr's
    * ListOfFbcAssociations and returns the FbcAnd object created. 
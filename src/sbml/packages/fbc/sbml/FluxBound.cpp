@@ -44,6 +44,7 @@
 
 #include <sbml/packages/fbc/sbml/FluxBound.h>
 #include <sbml/packages/fbc/extension//FbcExtension.h>
+#include <sbml/packages/fbc/extension/FbcModelPlugin.h>
 #include <sbml/packages/fbc/validator/FbcSBMLError.h>
 
 #include <sbml/util/util.h>
@@ -129,6 +130,7 @@ FluxBound& FluxBound::operator=(const FluxBound& source)
     this->mOperation=source.mOperation;
     this->mOperationString=source.mOperationString;
     this->mValue=source.mValue;
+    FbcModelPlugin::invalidateIndexes(this);
 
     // connect child elements to this element.
     connectToChild();
@@ -251,6 +253,7 @@ FluxBound::unsetName ()
 int
 FluxBound::setReaction (const std::string& reaction)
 {
+  FbcModelPlugin::invalidateIndexes(this);
   mReaction = reaction;
   return LIBSBML_OPERATION_SUCCESS;
 }
@@ -434,6 +437,26 @@ FluxBound::renameSIdRefs(const std::string& oldid, const std::string& newid)
 }
 
 
+/*
+ * rename attributes that are SIdRefs or instances in math
+ */
+void
+FluxBound::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames);
+  if (isSetReaction() == true)
+  {
+    // through setReaction, which keeps the flux bound index up to date
+    std::map<std::string, std::string>::const_iterator it = 
+      renames.find(mReaction);
+    if (it != renames.end())
+    {
+      setReaction(it->second);
+    }
+  }
+}
+
+
 /*
  * Returns the XML element name of
  * this SBML object.
@@ -1027,6 +1050,16 @@ FluxBound::accept (SBMLVisitor& v) const
 /** @endcond */
 
 
+/** @cond doxygenLibsbmlInternal */
+void
+FluxBound::connectToParent(SBase* parent)
+{
+  SBase::connectToParent(parent);
+  FbcModelPlugin::invalidateIndexes(this);
+}
+/** @endcond */
+
+
 /** @cond doxygenLibsbmlInternal */
 /*
  * Sets the parent SBMLDocument of this SBML object.
@@ -1128,6 +1161,7 @@ ListOfFluxBounds::get (const std::string& sid) const
 FluxBound*
 ListOfFluxBounds::remove (unsigned int n)
 {
+   FbcModelPlugin::invalidateIndexes(this);
    return static_cast<FluxBound*>(ListOf::remove(n));
 }
 
@@ -1143,6 +1177,7 @@ ListOfFluxBounds::remove (const std::string& sid)
 
   if (result != mItems.end())
   {
+    FbcModelPlugin::invalidateIndexes(this);
     item = *result;
     mItems.erase(result);
   }
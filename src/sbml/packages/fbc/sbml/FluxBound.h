@@ -414,6 +414,14 @@ public:
    virtual void renameSIdRefs(const std::string& oldid, const std::string& newid);
 
 
+#ifndef SWIG
+   /**
+    * @copydoc SBase::renameSIdRefs(const std::map<std::string, std::string>& renames)
+    */
+   virtual void renameSIdRefs(const std::map<std::string, std::string>& renames);
+#endif
+
+
   /**
    * Returns the XML element name of this object.
    *
@@ -475,6 +483,15 @@ public:
   /** @endcond */
 
 
+  /** @cond doxygenLibsbmlInternal */
+  /*
+   * Overridden so that the model plugin notices flux bounds inserted into
+   * its list.
+   */
+  virtual void connectToParent (SBase* parent);
+  /** @endcond */
+
+
   /** @cond doxygenLibsbmlInternal */
   /**
    * Sets the parent SBMLDocument of this SBML object.
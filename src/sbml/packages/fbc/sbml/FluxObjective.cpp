@@ -464,6 +464,16 @@ FluxObjective::renameSIdRefs(const std::string& oldid, const std::string& newid)
 }
 
 
+/*
+ * rename attributes that are SIdRefs or instances in math
+ */
+void
+FluxObjective::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mReaction);
+}
+
+
 /*
  * Returns the XML element name of this object
  */
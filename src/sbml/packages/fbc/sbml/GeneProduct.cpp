@@ -42,6 +42,7 @@
 
 
 #include <sbml/packages/fbc/sbml/GeneProduct.h>
+#include <sbml/packages/fbc/extension/FbcModelPlugin.h>
 #include <sbml/packages/fbc/validator/FbcSBMLError.h>
 #include <sbml/util/ElementFilter.h>
 
@@ -113,6 +114,7 @@ GeneProduct::operator=(const GeneProduct& rhs)
     mName  = rhs.mName;
     mLabel  = rhs.mLabel;
     mAssociatedSpecies  = rhs.mAssociatedSpecies;
+    FbcModelPlugin::invalidateIndexes(this);
   }
   return *this;
 }
@@ -222,10 +224,31 @@ GeneProduct::isSetAssociatedSpecies() const
 int
 GeneProduct::setId(const std::string& id)
 {
+  FbcModelPlugin::invalidateIndexes(this);
   return SyntaxChecker::checkAndSetSId(id, mId);
 }
 
 
+/** @cond doxygenLibsbmlInternal */
+int
+GeneProduct::setIdAttribute(const std::string& id)
+{
+  FbcModelPlugin::invalidateIndexes(this);
+  return SBase::setIdAttribute(id);
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+void
+GeneProduct::connectToParent(SBase* parent)
+{
+  SBase::connectToParent(parent);
+  FbcModelPlugin::invalidateIndexes(this);
+}
+/** @endcond */
+
+
 /*
  * Sets name and returns value indicating success.
  */
@@ -246,6 +269,7 @@ int
 GeneProduct::setLabel(const std::string& label)
 {
   {
+    FbcModelPlugin::invalidateIndexes(this);
     mLabel = label;
     return LIBSBML_OPERATION_SUCCESS;
   }
@@ -276,6 +300,7 @@ GeneProduct::setAssociatedSpecies(const std::string& associatedSpecies)
 int
 GeneProduct::unsetId()
 {
+  FbcModelPlugin::invalidateIndexes(this);
   mId.erase();
 
   if (mId.empty() == true)
@@ -314,6 +339,7 @@ GeneProduct::unsetName()
 int
 GeneProduct::unsetLabel()
 {
+  FbcModelPlugin::invalidateIndexes(this);
   mLabel.erase();
 
   if (mLabel.empty() == true)
@@ -361,6 +387,16 @@ GeneProduct::renameSIdRefs(const std::string& oldid, const std::string& newid)
 }
 
 
+/*
+ * rename attributes that are SIdRefs or instances in math
+ */
+void
+GeneProduct::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mAssociatedSpecies);
+}
+
+
 /*
  * Returns the XML element name of this object
  */
@@ -1140,6 +1176,7 @@ ListOfGeneProducts::createGeneProduct()
 GeneProduct*
 ListOfGeneProducts::remove(unsigned int n)
 {
+  FbcModelPlugin::invalidateIndexes(this);
   return static_cast<GeneProduct*>(ListOf::remove(n));
 }
 
@@ -1157,6 +1194,7 @@ ListOfGeneProducts::remove(const std::string& sid)
 
   if (result != mItems.end())
   {
+    FbcModelPlugin::invalidateIndexes(this);
     item = *result;
     mItems.erase(result);
   }
@@ -263,6 +263,22 @@ public:
   virtual int setId(const std::string& sid);
 
 
+  /** @cond doxygenLibsbmlInternal */
+  /*
+   * Overridden so that the model plugin notices the change of id.
+   */
+  virtual int setIdAttribute(const std::string& sid);
+  /** @endcond */
+
+  /** @cond doxygenLibsbmlInternal */
+  /*
+   * Overridden so that the model plugin notices gene products inserted
+   * into its list.
+   */
+  virtual void connectToParent (SBase* parent);
+  /** @endcond */
+
+
   /**
    * Sets the value of the "name" attribute of this GeneProduct.
    *
@@ -340,6 +356,14 @@ public:
    virtual void renameSIdRefs(const std::string& oldid, const std::string& newid);
 
 
+#ifndef SWIG
+   /**
+    * @copydoc SBase::renameSIdRefs(const std::map<std::string, std::string>& renames)
+    */
+   virtual void renameSIdRefs(const std::map<std::string, std::string>& renames);
+#endif
+
+
   /**
    * Returns the XML element name of this object.
    *
@@ -155,26 +155,31 @@ GeneProductRef::getGeneProduct() const
 std::string 
 GeneProductRef::toInfix(bool usingId) const
 {
-  const SBMLDocument* doc = getSBMLDocument();
-  if (doc == NULL) return mGeneProduct;
-
-  const Model* model = doc->getModel();
-  if (model == NULL) return mGeneProduct;
+  return FbcAssociation::toInfix(usingId);
+}
 
-  const FbcModelPlugin* plug = dynamic_cast<const FbcModelPlugin*>(model->getPlugin("fbc"));
-  if (plug == NULL) return mGeneProduct;
-  const GeneProduct* product = plug->getGeneProduct(mGeneProduct);
-  if (product == NULL) return mGeneProduct;
 
-  if (usingId)
+/** @cond doxygenLibsbmlInternal */
+void
+GeneProductRef::writeInfix(std::string& infix, bool usingId,
+                           const FbcModelPlugin* plugin) const
+{
+  const GeneProduct* product = 
+    (plugin != NULL) ? plugin->getGeneProduct(mGeneProduct) : NULL;
+  if (product == NULL)
+  {
+    infix += mGeneProduct;
+  }
+  else if (usingId)
   {
-    return product->getId();
+    infix += product->getId();
   }
   else
   {
-    return product->getLabel();
+    infix += product->getLabel();
   }
 }
+/** @endcond */
 
 
 
@@ -331,6 +336,17 @@ GeneProductRef::renameSIdRefs(const std::string& oldid, const std::string& newid
 }
 
 
+/*
+ * rename attributes that are SIdRefs or instances in math
+ */
+void
+GeneProductRef::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  FbcAssociation::renameSIdRefs(renames);
+  renameIdRef(mGeneProduct, renames);
+}
+
+
 /*
  * Returns the XML element name of this object
  */
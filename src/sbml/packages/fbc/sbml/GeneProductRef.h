@@ -191,6 +191,12 @@ public:
   */
   virtual std::string toInfix(bool usingId=false) const;
 
+
+  /** @cond doxygenLibsbmlInternal */
+  virtual void writeInfix(std::string& infix, bool usingId,
+                          const FbcModelPlugin* plugin) const;
+  /** @endcond */
+
   /**
    * Returns the value of the "name" attribute of this GeneProductRef object.
    *
@@ -287,6 +293,14 @@ public:
    virtual void renameSIdRefs(const std::string& oldid, const std::string& newid);
 
 
+#ifndef SWIG
+   /**
+    * @copydoc SBase::renameSIdRefs(const std::map<std::string, std::string>& renames)
+    */
+   virtual void renameSIdRefs(const std::map<std::string, std::string>& renames);
+#endif
+
+
   /**
    * Returns the XML element name of this object.
    *
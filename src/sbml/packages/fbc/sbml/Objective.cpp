@@ -1548,6 +1548,14 @@ ListOfObjectives::renameSIdRefs(const std::string& oldid, const std::string& new
 }
 
 
+void
+ListOfObjectives::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mActiveObjective, renames);
+  ListOf::renameSIdRefs(renames);
+}
+
+
 /*
  * Creates a new Objective in this ListOfObjectives
  */
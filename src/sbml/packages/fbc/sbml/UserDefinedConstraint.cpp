@@ -613,6 +613,17 @@ UserDefinedConstraint::renameSIdRefs(const std::string& oldid,
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+UserDefinedConstraint::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mLowerBound, renames);
+  renameIdRef(mUpperBound, renames);
+}
+
+
 /*
  * Returns the XML element name of this UserDefinedConstraint object.
  */
@@ -533,6 +533,16 @@ UserDefinedConstraintComponent::renameSIdRefs(const std::string& oldid,
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+UserDefinedConstraintComponent::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mVariable, renames);
+}
+
+
 /*
  * Returns the XML element name of this UserDefinedConstraintComponent object.
  */
@@ -49,12 +49,119 @@
 #ifdef __cplusplus
 
 #include <algorithm>
+#include <cctype>
+#include <cstring>
 #include <string>
 #include <sstream>
+#include <vector>
 
 using namespace std;
 LIBSBML_CPP_NAMESPACE_BEGIN
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * The fields of the COBRA notes read by the converter.  The value of a field
+ * starts 'skip' characters after the start of its key.
+ */
+struct CobraNotesField
+{
+  const char* key;
+  size_t      skip;
+};
+
+static const CobraNotesField FORMULA_FIELD = { "FORMULA:", 9 };
+static const CobraNotesField CHARGE_FIELD = { "CHARGE:", 8 };
+static const CobraNotesField ASSOCIATION_FIELD = { "ASSOCIATION:", 12 };
+
+
+/*
+ * Returns the position of 'key', which is in upper case, in 'text'
+ * ignoring case, or string::npos.
+ */
+static size_t
+findIgnoringCase(const string& text, const char* key)
+{
+  size_t length = strlen(key);
+  if (length > text.size())
+    return string::npos;
+
+  for (size_t pos = 0; pos + length <= text.size(); ++pos)
+  {
+    size_t i = 0;
+    while (i < length &&
+           toupper((unsigned char)text[pos + i]) == (unsigned char)key[i])
+    {
+      ++i;
+    }
+    if (i == length)
+      return pos;
+  }
+  return string::npos;
+}
+
+
+/*
+ * Walks the text of the given notes in document order and sets 'values[i]'
+ * to the text following the first occurrence of 'fields[i]', up to the end
+ * of the text it occurs in.  Returns the number of fields still missing.
+ */
+static size_t
+extractNotesFields(const XMLNode& node, const CobraNotesField* fields,
+                   size_t numFields, vector<string>& values,
+                   vector<bool>& found, size_t missing)
+{
+  if (node.isText())
+  {
+    const string& text = node.getCharacters();
+    for (size_t i = 0; i < numFields; ++i)
+    {
+      if (found[i])
+        continue;
+      size_t pos = findIgnoringCase(text, fields[i].key);
+      if (pos == string::npos)
+        continue;
+      found[i] = true;
+      --missing;
+      if (pos + fields[i].skip < text.size())
+        values[i] = text.substr(pos + fields[i].skip);
+    }
+    return missing;
+  }
+
+  for (unsigned int n = 0; n < node.getNumChildren() && missing > 0; ++n)
+  {
+    missing = extractNotesFields(node.getChild(n), fields, numFields,
+                                 values, found, missing);
+  }
+  return missing;
+}
+
+
+/*
+ * Returns the values of the given fields in the notes of 'element'; fields
+ * that are missing, or whose value is blank, are returned empty.
+ */
+static void
+getNotesFields(const SBase* element, const CobraNotesField* fields,
+               size_t numFields, vector<string>& values)
+{
+  values.assign(numFields, string());
+  const XMLNode* notes = element->getNotes();
+  if (notes == NULL)
+    return;
+
+  vector<bool> found(numFields, false);
+  extractNotesFields(*notes, fields, numFields, values, found, numFields);
+
+  for (size_t i = 0; i < numFields; ++i)
+  {
+    if (values[i].find_first_not_of(" \n\t\r") == string::npos)
+      values[i].clear();
+  }
+}
+/** @endcond */
+
+
 /** @cond doxygenLibsbmlInternal */
 /*
  * SBML Converter stuff below
@@ -151,6 +258,9 @@ CobraToFbcConverter::convert()
   std::map<const string, string> formulaMap;
   Model* model = mDocument->getModel();
 
+  const CobraNotesField speciesFields[] = { FORMULA_FIELD, CHARGE_FIELD };
+  vector<string> values;
+
   for (unsigned int i = 0; i < model->getNumSpecies(); ++i)
   {
     Species* current = model->getSpecies(i);
@@ -166,48 +276,22 @@ CobraToFbcConverter::convert()
     }
     if (current->isSetNotes())
     {
-      string originalNotes = current->getNotesString();
-      string notes(originalNotes);
-      std::transform(notes.begin(), notes.end(), notes.begin(), ::toupper);
-      size_t pos = notes.find("FORMULA:");
-      if (pos != string::npos)
+      getNotesFields(current, speciesFields, 2, values);
+      if (!values[0].empty())
       {
-        size_t end = notes.find("</", pos + 9);
-        if (end != string::npos)
-        {
-          string formula = originalNotes.substr(pos + 9, end - (pos + 9));
-          if (formula[0] != '<' &&  formula[0] != '/')
-          {
-            size_t pos1 = formula.find_first_not_of(" \n\t\r");
-            if (pos1 != std::string::npos)
-              formulaMap[current->getId()] = formula;
-          }
-        }
+        formulaMap[current->getId()] = values[0];
       } // added chemical formula if present 
 
-      pos = notes.find("CHARGE:");
-      if (pos != string::npos && !haveCharge)
+      if (!values[1].empty() && !haveCharge)
       {
-        size_t end = notes.find("</", pos + 8);
-        if (end != string::npos)
+        int charge;
+        stringstream str;
+        str << values[1];
+        str >> charge;
+        if (charge != 0 || values[1].find("0") != std::string::npos)
         {
-          string formula = originalNotes.substr(pos + 8, end - (pos + 8));
-          if (formula[0] != '<' &&  formula[0] != '/')
-          {
-            size_t pos1 = formula.find_first_not_of(" \n\t\r");
-            if (pos1 != std::string::npos)
-            {
-              int charge;
-              stringstream str;
-              str << formula;
-              str >> charge;
-              if (charge != 0 || formula.find("0") != std::string::npos)
-              {
-                chargeMap[current->getId()] = charge;
-                haveChargeMap[current->getId()] = true;
-              }
-            }
-          }
+          chargeMap[current->getId()] = charge;
+          haveChargeMap[current->getId()] = true;
         }
       } // added charge if present
     } // handled notes
@@ -289,27 +373,17 @@ CobraToFbcConverter::convert()
 
     if (reaction->isSetNotes())
     {
-      string originalNotes = reaction->getNotesString();
-      string notes(originalNotes);
-      std::transform(notes.begin(), notes.end(), notes.begin(), ::toupper);
-      size_t pos = notes.find("ASSOCIATION:");
-      if (pos != string::npos)
+      getNotesFields(reaction, &ASSOCIATION_FIELD, 1, values);
+      Association* association = values[0].empty() ? NULL :
+        Association::parseInfixAssociation(values[0]);
+      if (association != NULL)
       {
-        size_t end = notes.find("</", pos + 12);
-        if (end != string::npos)
-        {
-          string geneAssociation = originalNotes.substr(pos + 12, end - (pos + 12));
-          Association* association = Association::parseInfixAssociation(geneAssociation);
-          if (association != NULL)
-          {
-            GeneAssociation* ga = fbcPlugin->createGeneAssociation();
-            stringstream temp; temp << "ga_" << (fbcPlugin->getNumGeneAssociations());
-            ga->setId(temp.str());
-            ga->setReaction(rID);
-            ga->setAssociation(association);
-            delete association;
-          }
-        }
+        GeneAssociation* ga = fbcPlugin->createGeneAssociation();
+        stringstream temp; temp << "ga_" << (fbcPlugin->getNumGeneAssociations());
+        ga->setId(temp.str());
+        ga->setReaction(rID);
+        ga->setAssociation(association);
+        delete association;
       }
     }
 
@@ -0,0 +1,598 @@
+/**
+ * @file    FbcSparseModel.cpp
+ * @brief   Implementation of FbcSparseModel, a contiguous array export of an
+ *          fbc model.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ */
+
+#include <sbml/packages/fbc/util/FbcSparseModel.h>
+
+#include <sbml/Model.h>
+#include <sbml/util/util.h>
+#include <sbml/packages/fbc/common/FbcExtensionTypes.h>
+
+#include <algorithm>
+
+using namespace std;
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+#ifdef __cplusplus
+
+static const string EMPTY_STRING;
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Returns a pointer to the elements of the vector, or NULL if it is empty.
+ */
+template <class T>
+static const T*
+arrayOf(const vector<T>& elements)
+{
+  return elements.empty() ? NULL : &elements[0];
+}
+
+
+/*
+ * Returns element n of the vector, or the given value if there is none.
+ */
+template <class T>
+static T
+elementOf(const vector<T>& elements, unsigned int n, T missing)
+{
+  return n < elements.size() ? elements[n] : missing;
+}
+
+
+template <class T>
+static void
+copyArray(const vector<T>& elements, T* target)
+{
+  std::copy(elements.begin(), elements.end(), target);
+}
+
+
+/*
+ * Adds the stoichiometry of the given species references to the entries of
+ * the current column, which start at position 'columnStart'.
+ */
+static void
+addEntries(const ListOf* references, double sign,
+           const map<string, int>& rows, size_t columnStart,
+           vector<int>& rowIndices, vector<double>& values)
+{
+  for (unsigned int i = 0; i < references->size(); ++i)
+  {
+    const SpeciesReference* reference =
+      static_cast<const SpeciesReference*>(references->get(i));
+    map<string, int>::const_iterator row = rows.find(reference->getSpecies());
+    if (row == rows.end())
+    {
+      continue;
+    }
+
+    // Level 3 leaves the stoichiometry undefined when it is not set; it
+    // counts as 1, the default of the other Levels
+    double value = sign;
+    if (reference->isSetStoichiometry())
+    {
+      value *= reference->getStoichiometry();
+    }
+
+    // a species rarely occurs more than once in a reaction, and columns are
+    // short, so a linear search for an existing entry is cheapest
+    size_t entry = columnStart;
+    while (entry < rowIndices.size() && rowIndices[entry] != row->second)
+    {
+      ++entry;
+    }
+
+    if (entry < rowIndices.size())
+    {
+      values[entry] += value;
+    }
+    else
+    {
+      rowIndices.push_back(row->second);
+      values.push_back(value);
+    }
+  }
+}
+
+
+/*
+ * Puts the entries of the current column, which start at position
+ * 'columnStart', in the order of their rows and drops those that are zero.
+ * Columns are short, so an insertion sort is cheapest.
+ */
+static void
+finishColumn(size_t columnStart,
+             vector<int>& rowIndices, vector<double>& values)
+{
+  size_t end = columnStart;
+  for (size_t entry = columnStart; entry < rowIndices.size(); ++entry)
+  {
+    if (values[entry] == 0)
+    {
+      continue;
+    }
+
+    int row = rowIndices[entry];
+    double value = values[entry];
+    size_t position = end;
+    while (position > columnStart && rowIndices[position - 1] > row)
+    {
+      rowIndices[position] = rowIndices[position - 1];
+      values[position] = values[position - 1];
+      --position;
+    }
+    rowIndices[position] = row;
+    values[position] = value;
+    ++end;
+  }
+
+  rowIndices.resize(end);
+  values.resize(end);
+}
+/** @endcond */
+
+
+FbcSparseModel::FbcSparseModel()
+  : mMaximize(false)
+{
+  clear();
+}
+
+
+FbcSparseModel::~FbcSparseModel()
+{
+}
+
+
+void
+FbcSparseModel::clear()
+{
+  mSpeciesIds.clear();
+  mReactionIds.clear();
+  mGeneProductIds.clear();
+  mColumnStarts.assign(1, 0);
+  mRowIndices.clear();
+  mValues.clear();
+  mLowerBounds.clear();
+  mUpperBounds.clear();
+  mObjectiveCoefficients.clear();
+  mMaximize = false;
+  mAssociationStarts.assign(1, 0);
+  mAssociationTokens.clear();
+}
+
+
+int
+FbcSparseModel::populate(const Model* model)
+{
+  clear();
+  if (model == NULL)
+  {
+    return LIBSBML_INVALID_OBJECT;
+  }
+
+  const FbcModelPlugin* plugin =
+    dynamic_cast<const FbcModelPlugin*>(model->getPlugin("fbc"));
+
+  map<string, int> rows;
+  unsigned int numSpecies = model->getNumSpecies();
+  mSpeciesIds.reserve(numSpecies);
+  for (unsigned int i = 0; i < numSpecies; ++i)
+  {
+    const string& id = model->getSpecies(i)->getId();
+    mSpeciesIds.push_back(id);
+    rows.insert(make_pair(id, (int)i));
+  }
+
+  map<string, int> geneProducts;
+  if (plugin != NULL)
+  {
+    unsigned int numGeneProducts = plugin->getNumGeneProducts();
+    mGeneProductIds.reserve(numGeneProducts);
+    for (unsigned int i = 0; i < numGeneProducts; ++i)
+    {
+      const string& id = plugin->getGeneProduct(i)->getId();
+      mGeneProductIds.push_back(id);
+      geneProducts.insert(make_pair(id, (int)i));
+    }
+  }
+
+  unsigned int numReactions = model->getNumReactions();
+  mReactionIds.reserve(numReactions);
+  mColumnStarts.reserve(numReactions + 1);
+  mLowerBounds.assign(numReactions, util_NegInf());
+  mUpperBounds.assign(numReactions, util_PosInf());
+  mObjectiveCoefficients.assign(numReactions, 0.0);
+  mAssociationStarts.reserve(numReactions + 1);
+
+  map<string, int> columns;
+  for (unsigned int j = 0; j < numReactions; ++j)
+  {
+    const Reaction* reaction = model->getReaction(j);
+    mReactionIds.push_back(reaction->getId());
+    columns.insert(make_pair(reaction->getId(), (int)j));
+
+    size_t columnStart = mRowIndices.size();
+    addEntries(reaction->getListOfReactants(), -1.0, rows, columnStart,
+               mRowIndices, mValues);
+    addEntries(reaction->getListOfProducts(), 1.0, rows, columnStart,
+               mRowIndices, mValues);
+    finishColumn(columnStart, mRowIndices, mValues);
+    mColumnStarts.push_back((int)mRowIndices.size());
+
+    const FbcReactionPlugin* rplugin =
+      dynamic_cast<const FbcReactionPlugin*>(reaction->getPlugin("fbc"));
+    if (rplugin != NULL)
+    {
+      if (rplugin->isSetLowerFluxBound())
+      {
+        const Parameter* bound =
+          model->getParameter(rplugin->getLowerFluxBound());
+        if (bound != NULL)
+        {
+          mLowerBounds[j] = bound->getValue();
+        }
+      }
+      if (rplugin->isSetUpperFluxBound())
+      {
+        const Parameter* bound =
+          model->getParameter(rplugin->getUpperFluxBound());
+        if (bound != NULL)
+        {
+          mUpperBounds[j] = bound->getValue();
+        }
+      }
+      if (rplugin->isSetGeneProductAssociation() &&
+          rplugin->getGeneProductAssociation()->isSetAssociation())
+      {
+        addAssociationTokens(
+          rplugin->getGeneProductAssociation()->getAssociation(),
+          geneProducts);
+      }
+    }
+    mAssociationStarts.push_back((int)mAssociationTokens.size());
+  }
+
+  if (plugin == NULL)
+  {
+    return LIBSBML_OPERATION_SUCCESS;
+  }
+
+  // fbc version 1 keeps the bounds in a list of their own
+  for (unsigned int i = 0; i < plugin->getNumFluxBounds(); ++i)
+  {
+    const FluxBound* bound = plugin->getFluxBound(i);
+    map<string, int>::const_iterator column =
+      columns.find(bound->getReaction());
+    if (column == columns.end())
+    {
+      continue;
+    }
+
+    switch (bound->getFluxBoundOperation())
+    {
+    case FLUXBOUND_OPERATION_LESS_EQUAL:
+    case FLUXBOUND_OPERATION_LESS:
+      mUpperBounds[column->second] = bound->getValue();
+      break;
+    case FLUXBOUND_OPERATION_GREATER_EQUAL:
+    case FLUXBOUND_OPERATION_GREATER:
+      mLowerBounds[column->second] = bound->getValue();
+      break;
+    case FLUXBOUND_OPERATION_EQUAL:
+      mLowerBounds[column->second] = bound->getValue();
+      mUpperBounds[column->second] = bound->getValue();
+      break;
+    default:
+      break;
+    }
+  }
+
+  const Objective* objective = plugin->getActiveObjective();
+  if (objective != NULL)
+  {
+    mMaximize = objective->getObjectiveType() == OBJECTIVE_TYPE_MAXIMIZE;
+    for (unsigned int i = 0; i < objective->getNumFluxObjectives(); ++i)
+    {
+      const FluxObjective* flux = objective->getFluxObjective(i);
+      map<string, int>::const_iterator column =
+        columns.find(flux->getReaction());
+      if (column != columns.end())
+      {
+        mObjectiveCoefficients[column->second] += flux->getCoefficient();
+      }
+    }
+  }
+
+  return LIBSBML_OPERATION_SUCCESS;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+void
+FbcSparseModel::addAssociationTokens(const FbcAssociation* association,
+                                     const map<string, int>& geneProducts)
+{
+  if (association->isGeneProductRef())
+  {
+    const GeneProductRef* ref =
+      static_cast<const GeneProductRef*>(association);
+    map<string, int>::const_iterator index =
+      geneProducts.find(ref->getGeneProduct());
+    mAssociationTokens.push_back(index != geneProducts.end()
+      ? index->second : (int)FBC_GPR_TOKEN_UNKNOWN_GENE);
+  }
+  else if (association->isFbcAnd())
+  {
+    const FbcAnd* fbcAnd = static_cast<const FbcAnd*>(association);
+    for (unsigned int i = 0; i < fbcAnd->getNumAssociations(); ++i)
+    {
+      addAssociationTokens(fbcAnd->getAssociation(i), geneProducts);
+    }
+    mAssociationTokens.push_back(FBC_GPR_TOKEN_AND);
+    mAssociationTokens.push_back((int)fbcAnd->getNumAssociations());
+  }
+  else if (association->isFbcOr())
+  {
+    const FbcOr* fbcOr = static_cast<const FbcOr*>(association);
+    for (unsigned int i = 0; i < fbcOr->getNumAssociations(); ++i)
+    {
+      addAssociationTokens(fbcOr->getAssociation(i), geneProducts);
+    }
+    mAssociationTokens.push_back(FBC_GPR_TOKEN_OR);
+    mAssociationTokens.push_back((int)fbcOr->getNumAssociations());
+  }
+}
+/** @endcond */
+
+
+unsigned int
+FbcSparseModel::getNumSpecies() const
+{
+  return (unsigned int)mSpeciesIds.size();
+}
+
+
+unsigned int
+FbcSparseModel::getNumReactions() const
+{
+  return (unsigned int)mReactionIds.size();
+}
+
+
+unsigned int
+FbcSparseModel::getNumEntries() const
+{
+  return (unsigned int)mValues.size();
+}
+
+
+unsigned int
+FbcSparseModel::getNumGeneProducts() const
+{
+  return (unsigned int)mGeneProductIds.size();
+}
+
+
+unsigned int
+FbcSparseModel::getNumAssociationTokens() const
+{
+  return (unsigned int)mAssociationTokens.size();
+}
+
+
+const string&
+FbcSparseModel::getSpeciesId(unsigned int n) const
+{
+  return n < mSpeciesIds.size() ? mSpeciesIds[n] : EMPTY_STRING;
+}
+
+
+const string&
+FbcSparseModel::getReactionId(unsigned int n) const
+{
+  return n < mReactionIds.size() ? mReactionIds[n] : EMPTY_STRING;
+}
+
+
+const string&
+FbcSparseModel::getGeneProductId(unsigned int n) const
+{
+  return n < mGeneProductIds.size() ? mGeneProductIds[n] : EMPTY_STRING;
+}
+
+
+const int*
+FbcSparseModel::getColumnStarts() const
+{
+  return arrayOf(mColumnStarts);
+}
+
+
+const int*
+FbcSparseModel::getRowIndices() const
+{
+  return arrayOf(mRowIndices);
+}
+
+
+const double*
+FbcSparseModel::getValues() const
+{
+  return arrayOf(mValues);
+}
+
+
+const double*
+FbcSparseModel::getLowerBounds() const
+{
+  return arrayOf(mLowerBounds);
+}
+
+
+const double*
+FbcSparseModel::getUpperBounds() const
+{
+  return arrayOf(mUpperBounds);
+}
+
+
+const double*
+FbcSparseModel::getObjectiveCoefficients() const
+{
+  return arrayOf(mObjectiveCoefficients);
+}
+
+
+bool
+FbcSparseModel::getMaximize() const
+{
+  return mMaximize;
+}
+
+
+const int*
+FbcSparseModel::getAssociationStarts() const
+{
+  return arrayOf(mAssociationStarts);
+}
+
+
+const int*
+FbcSparseModel::getAssociationTokens() const
+{
+  return arrayOf(mAssociationTokens);
+}
+
+
+int
+FbcSparseModel::getColumnStart(unsigned int n) const
+{
+  return elementOf(mColumnStarts, n, -1);
+}
+
+
+int
+FbcSparseModel::getRowIndex(unsigned int n) const
+{
+  return elementOf(mRowIndices, n, -1);
+}
+
+
+double
+FbcSparseModel::getValue(unsigned int n) const
+{
+  return elementOf(mValues, n, util_NaN());
+}
+
+
+double
+FbcSparseModel::getLowerBound(unsigned int n) const
+{
+  return elementOf(mLowerBounds, n, util_NaN());
+}
+
+
+double
+FbcSparseModel::getUpperBound(unsigned int n) const
+{
+  return elementOf(mUpperBounds, n, util_NaN());
+}
+
+
+double
+FbcSparseModel::getObjectiveCoefficient(unsigned int n) const
+{
+  return elementOf(mObjectiveCoefficients, n, util_NaN());
+}
+
+
+int
+FbcSparseModel::getAssociationStart(unsigned int n) const
+{
+  return elementOf(mAssociationStarts, n, -1);
+}
+
+
+int
+FbcSparseModel::getAssociationToken(unsigned int n) const
+{
+  return elementOf(mAssociationTokens, n, (int)FBC_GPR_TOKEN_UNKNOWN_GENE);
+}
+
+
+int
+FbcSparseModel::copyMatrix(int* columnStarts, int* rowIndices,
+                           double* values) const
+{
+  if (columnStarts == NULL ||
+     ((rowIndices == NULL || values == NULL) && !mValues.empty()))
+  {
+    return LIBSBML_INVALID_OBJECT;
+  }
+
+  copyArray(mColumnStarts, columnStarts);
+  copyArray(mRowIndices, rowIndices);
+  copyArray(mValues, values);
+  return LIBSBML_OPERATION_SUCCESS;
+}
+
+
+int
+FbcSparseModel::copyBounds(double* lowerBounds, double* upperBounds,
+                           double* objectiveCoefficients) const
+{
+  if ((lowerBounds == NULL || upperBounds == NULL ||
+       objectiveCoefficients == NULL) && !mReactionIds.empty())
+  {
+    return LIBSBML_INVALID_OBJECT;
+  }
+
+  copyArray(mLowerBounds, lowerBounds);
+  copyArray(mUpperBounds, upperBounds);
+  copyArray(mObjectiveCoefficients, objectiveCoefficients);
+  return LIBSBML_OPERATION_SUCCESS;
+}
+
+
+int
+FbcSparseModel::copyAssociations(int* associationStarts,
+                                 int* associationTokens) const
+{
+  if (associationStarts == NULL ||
+     (associationTokens == NULL && !mAssociationTokens.empty()))
+  {
+    return LIBSBML_INVALID_OBJECT;
+  }
+
+  copyArray(mAssociationStarts, associationStarts);
+  copyArray(mAssociationTokens, associationTokens);
+  return LIBSBML_OPERATION_SUCCESS;
+}
+
+
+#endif  /* __cplusplus */
+
+LIBSBML_CPP_NAMESPACE_END
@@ -0,0 +1,454 @@
+/**
+ * @file    FbcSparseModel.h
+ * @brief   Definition of FbcSparseModel, a contiguous array export of an
+ *          fbc model.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class FbcSparseModel
+ * @sbmlbrief{fbc} The constraint-based view of a model as contiguous arrays.
+ *
+ * @htmlinclude libsbml-facility-only-warning.html
+ *
+ * Flux balance analysis needs the stoichiometric matrix of a model, the
+ * bounds on the flux of every reaction, the coefficients of the objective
+ * and the gene associations of the reactions.  Collecting these by walking
+ * the Reaction, SpeciesReference and &ldquo;fbc&rdquo; objects one at a
+ * time is slow, especially through the language bindings.  FbcSparseModel
+ * collects them in a single pass over a Model and keeps them in contiguous
+ * arrays:
+ *
+ * @li the stoichiometric matrix, with one row per Species and one column
+ * per Reaction of the model (in the order of the model), in compressed
+ * sparse column form:  the entries of column @em j are at the positions
+ * <code>getColumnStarts()[j]</code> up to (not including)
+ * <code>getColumnStarts()[j + 1]</code> of getRowIndices() and getValues().
+ * Reactants have negative and products positive coefficients; a species
+ * that is both a reactant and a product of a reaction has a single entry.
+ * The matrix is in canonical form:  the row indices of every column are
+ * sorted, and entries that are zero (including those where a reactant
+ * and product cancel) are not stored.
+ * A SpeciesReference of Level&nbsp;3 without a 'stoichiometry' counts
+ * with a stoichiometry of 1, as in the other SBML Levels.
+ *
+ * @li the lower and upper bounds of every reaction, taken from the values
+ * of the Parameter objects referenced by the &ldquo;fbc&rdquo; Version&nbsp;2
+ * attributes 'lowerFluxBound' and 'upperFluxBound', or from the FluxBound
+ * objects of &ldquo;fbc&rdquo; Version&nbsp;1.  Unbounded reactions have
+ * bounds of minus and plus infinity.
+ *
+ * @li the coefficient of every reaction in the active Objective, and the
+ * sense of that objective.
+ *
+ * @li the GeneProductAssociation of every reaction, as a sequence of tokens
+ * in postfix order:  the index of a GeneProduct of the model is pushed
+ * as itself; #FBC_GPR_TOKEN_AND and #FBC_GPR_TOKEN_OR are followed by the
+ * number of operands they combine.  Tokens of reaction @em j are at the
+ * positions <code>getAssociationStarts()[j]</code> up to (not including)
+ * <code>getAssociationStarts()[j + 1]</code> of getAssociationTokens().
+ *
+ * The arrays are owned by the FbcSparseModel and remain valid until it is
+ * populated again or deleted.  Callers that manage their own memory can have
+ * them copied into buffers of their own instead, sized by the getNum
+ * methods.  Each element of the arrays can also be read on its own, as in
+ * getLowerBound(@if java unsigned int@endif); the language bindings offer
+ * only these accessors, since they cannot map the arrays themselves.
+ */
+
+#ifndef FbcSparseModel_h
+#define FbcSparseModel_h
+
+#include <sbml/common/extern.h>
+#include <sbml/common/operationReturnValues.h>
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+  /**
+   * @enum FbcGprToken_t
+   * @brief Tokens other than gene product indexes in the gene associations
+   * exported by FbcSparseModel.
+   */
+typedef enum
+{
+    FBC_GPR_TOKEN_AND          = -1 /*!< Conjunction, followed by its number of operands. */
+  , FBC_GPR_TOKEN_OR           = -2 /*!< Disjunction, followed by its number of operands. */
+  , FBC_GPR_TOKEN_UNKNOWN_GENE = -3 /*!< Reference to a gene product not in the model. */
+} FbcGprToken_t;
+
+LIBSBML_CPP_NAMESPACE_END
+
+
+#ifdef __cplusplus
+
+#include <map>
+#include <string>
+#include <vector>
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+class Model;
+class FbcAssociation;
+
+
+class LIBSBML_EXTERN FbcSparseModel
+{
+public:
+
+  /**
+   * Creates a new, empty FbcSparseModel.
+   */
+  FbcSparseModel();
+
+
+  /**
+   * Destroys this FbcSparseModel.
+   */
+  virtual ~FbcSparseModel();
+
+
+  /**
+   * Replaces the contents of this FbcSparseModel with the constraint-based
+   * view of the given model.
+   *
+   * @param model the Model to export.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBSBML_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBSBML_INVALID_OBJECT, OperationReturnValues_t}
+   */
+  int populate(const Model* model);
+
+
+  /**
+   * Returns the number of rows (species) of the stoichiometric matrix.
+   *
+   * @return the number of species.
+   */
+  unsigned int getNumSpecies() const;
+
+
+  /**
+   * Returns the number of columns (reactions) of the stoichiometric matrix.
+   *
+   * @return the number of reactions.
+   */
+  unsigned int getNumReactions() const;
+
+
+  /**
+   * Returns the number of stored entries of the stoichiometric matrix.
+   *
+   * @return the number of entries.
+   */
+  unsigned int getNumEntries() const;
+
+
+  /**
+   * Returns the number of gene products of the model.
+   *
+   * @return the number of gene products.
+   */
+  unsigned int getNumGeneProducts() const;
+
+
+  /**
+   * Returns the number of tokens of all gene associations.
+   *
+   * @return the number of gene association tokens.
+   */
+  unsigned int getNumAssociationTokens() const;
+
+
+  /**
+   * Returns the id of the species of row @p n.
+   *
+   * @param n the row.
+   *
+   * @return the id of the species, or the empty string if there is no such
+   * row.
+   */
+  const std::string& getSpeciesId(unsigned int n) const;
+
+
+  /**
+   * Returns the id of the reaction of column @p n.
+   *
+   * @param n the column.
+   *
+   * @return the id of the reaction, or the empty string if there is no such
+   * column.
+   */
+  const std::string& getReactionId(unsigned int n) const;
+
+
+  /**
+   * Returns the id of the gene product with index @p n.
+   *
+   * @param n the index used in the gene association tokens.
+   *
+   * @return the id of the gene product, or the empty string if there is no
+   * such gene product.
+   */
+  const std::string& getGeneProductId(unsigned int n) const;
+
+
+  /**
+   * Returns the start of every column, and the end of the last one.
+   *
+   * @return an array of getNumReactions() + 1 positions.
+   */
+  const int* getColumnStarts() const;
+
+
+  /**
+   * Returns the row of every entry of the stoichiometric matrix.
+   *
+   * @return an array of getNumEntries() rows.
+   */
+  const int* getRowIndices() const;
+
+
+  /**
+   * Returns the value of every entry of the stoichiometric matrix.
+   *
+   * @return an array of getNumEntries() stoichiometries.
+   */
+  const double* getValues() const;
+
+
+  /**
+   * Returns the lower flux bound of every reaction.
+   *
+   * @return an array of getNumReactions() bounds.
+   */
+  const double* getLowerBounds() const;
+
+
+  /**
+   * Returns the upper flux bound of every reaction.
+   *
+   * @return an array of getNumReactions() bounds.
+   */
+  const double* getUpperBounds() const;
+
+
+  /**
+   * Returns the coefficient of every reaction in the active objective.
+   *
+   * @return an array of getNumReactions() coefficients, zero for reactions
+   * not in the objective.
+   */
+  const double* getObjectiveCoefficients() const;
+
+
+  /**
+   * Returns whether the active objective is maximized.
+   *
+   * @return @c true if the active objective is to be maximized, @c false
+   * if it is to be minimized or if there is no active objective.
+   */
+  bool getMaximize() const;
+
+
+  /**
+   * Returns the start of the gene association of every reaction, and the
+   * end of the last one.
+   *
+   * @return an array of getNumReactions() + 1 positions; reactions without
+   * gene association start and end at the same position.
+   */
+  const int* getAssociationStarts() const;
+
+
+  /**
+   * Returns the gene association tokens of all reactions.
+   *
+   * @return an array of getNumAssociationTokens() tokens.
+   */
+  const int* getAssociationTokens() const;
+
+
+  /**
+   * Returns the start of column @p n, or the end of the last column for
+   * @p n equal to getNumReactions().
+   *
+   * @param n the column.
+   *
+   * @return the position of the first entry of the column, or @c -1 if
+   * there is no such column.
+   */
+  int getColumnStart(unsigned int n) const;
+
+
+  /**
+   * Returns the row of entry @p n of the stoichiometric matrix.
+   *
+   * @param n the position of the entry.
+   *
+   * @return the row, or @c -1 if there is no such entry.
+   */
+  int getRowIndex(unsigned int n) const;
+
+
+  /**
+   * Returns the value of entry @p n of the stoichiometric matrix.
+   *
+   * @param n the position of the entry.
+   *
+   * @return the stoichiometry, or @c NaN if there is no such entry.
+   */
+  double getValue(unsigned int n) const;
+
+
+  /**
+   * Returns the lower flux bound of the reaction of column @p n.
+   *
+   * @param n the column.
+   *
+   * @return the bound, or @c NaN if there is no such column.
+   */
+  double getLowerBound(unsigned int n) const;
+
+
+  /**
+   * Returns the upper flux bound of the reaction of column @p n.
+   *
+   * @param n the column.
+   *
+   * @return the bound, or @c NaN if there is no such column.
+   */
+  double getUpperBound(unsigned int n) const;
+
+
+  /**
+   * Returns the coefficient in the active objective of the reaction of
+   * column @p n.
+   *
+   * @param n the column.
+   *
+   * @return the coefficient, or @c NaN if there is no such column.
+   */
+  double getObjectiveCoefficient(unsigned int n) const;
+
+
+  /**
+   * Returns the start of the gene association of the reaction of column
+   * @p n, or the end of the last one for @p n equal to getNumReactions().
+   *
+   * @param n the column.
+   *
+   * @return the position of the first token of the association, or @c -1
+   * if there is no such column.
+   */
+  int getAssociationStart(unsigned int n) const;
+
+
+  /**
+   * Returns gene association token @p n.
+   *
+   * @param n the position of the token.
+   *
+   * @return the token, or #FBC_GPR_TOKEN_UNKNOWN_GENE if there is no such
+   * token.
+   */
+  int getAssociationToken(unsigned int n) const;
+
+
+  /**
+   * Copies the stoichiometric matrix into the given buffers.
+   *
+   * @param columnStarts an array of at least getNumReactions() + 1 elements.
+   * @param rowIndices an array of at least getNumEntries() elements.
+   * @param values an array of at least getNumEntries() elements.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBSBML_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBSBML_INVALID_OBJECT, OperationReturnValues_t}
+   */
+  int copyMatrix(int* columnStarts, int* rowIndices, double* values) const;
+
+
+  /**
+   * Copies the flux bounds and objective coefficients into the given
+   * buffers.
+   *
+   * @param lowerBounds an array of at least getNumReactions() elements.
+   * @param upperBounds an array of at least getNumReactions() elements.
+   * @param objectiveCoefficients an array of at least getNumReactions()
+   * elements.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBSBML_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBSBML_INVALID_OBJECT, OperationReturnValues_t}
+   */
+  int copyBounds(double* lowerBounds, double* upperBounds,
+                 double* objectiveCoefficients) const;
+
+
+  /**
+   * Copies the gene associations into the given buffers.
+   *
+   * @param associationStarts an array of at least getNumReactions() + 1
+   * elements.
+   * @param associationTokens an array of at least getNumAssociationTokens()
+   * elements.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBSBML_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBSBML_INVALID_OBJECT, OperationReturnValues_t}
+   */
+  int copyAssociations(int* associationStarts, int* associationTokens) const;
+
+
+  /**
+   * Removes all contents of this FbcSparseModel.
+   */
+  void clear();
+
+
+protected:
+  /** @cond doxygenLibsbmlInternal */
+
+  void addAssociationTokens(const FbcAssociation* association,
+                            const std::map<std::string, int>& geneProducts);
+
+  std::vector<std::string> mSpeciesIds;
+  std::vector<std::string> mReactionIds;
+  std::vector<std::string> mGeneProductIds;
+
+  std::vector<int> mColumnStarts;
+  std::vector<int> mRowIndices;
+  std::vector<double> mValues;
+
+  std::vector<double> mLowerBounds;
+  std::vector<double> mUpperBounds;
+  std::vector<double> mObjectiveCoefficients;
+  bool mMaximize;
+
+  std::vector<int> mAssociationStarts;
+  std::vector<int> mAssociationTokens;
+
+  /** @endcond */
+};
+
+
+LIBSBML_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+#endif  /* FbcSparseModel_h */
@@ -0,0 +1,738 @@
+/**
+ * @file    FluxBoundsView.cpp
+ * @brief   Implementation of FluxBoundsView, the flux bounds and objective
+ *          coefficients of an fbc model as arrays.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ */
+
+#include <sbml/packages/fbc/util/FluxBoundsView.h>
+
+#include <sbml/Model.h>
+#include <sbml/util/util.h>
+#include <sbml/packages/fbc/common/FbcExtensionTypes.h>
+
+#include <set>
+#include <sstream>
+
+using namespace std;
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+#ifdef __cplusplus
+
+static const string EMPTY_STRING;
+
+/* SBO term of flux bound parameters */
+static const int FLUX_BOUND_SBO_TERM = 625;
+
+
+/** @cond doxygenLibsbmlInternal */
+static bool
+differs(double a, double b)
+{
+  return a != b && !(util_isNaN(a) && util_isNaN(b));
+}
+
+
+static double*
+arrayOf(vector<double>& elements)
+{
+  return elements.empty() ? NULL : &elements[0];
+}
+/** @endcond */
+
+
+FluxBoundsView::FluxBoundsView(Model* model)
+  : mModel(model)
+{
+  read();
+}
+
+
+FluxBoundsView::~FluxBoundsView()
+{
+}
+
+
+Model*
+FluxBoundsView::getModel() const
+{
+  return mModel;
+}
+
+
+FluxBoundsView::FluxBoundsView(const FluxBoundsView& orig)
+  : mModel(orig.mModel)
+  , mReactionIds(orig.mReactionIds)
+  , mReactionIndexes(orig.mReactionIndexes)
+  , mLowerBounds(orig.mLowerBounds)
+  , mUpperBounds(orig.mUpperBounds)
+  , mObjectiveCoefficients(orig.mObjectiveCoefficients)
+  , mModelLowerBounds(orig.mModelLowerBounds)
+  , mModelUpperBounds(orig.mModelUpperBounds)
+  , mModelObjectiveCoefficients(orig.mModelObjectiveCoefficients)
+  , mParameterIndexes(orig.mParameterIndexes)
+{
+}
+
+
+FluxBoundsView&
+FluxBoundsView::operator=(const FluxBoundsView& rhs)
+{
+  if (&rhs != this)
+  {
+    mModel = rhs.mModel;
+    mReactionIds = rhs.mReactionIds;
+    mReactionIndexes = rhs.mReactionIndexes;
+    mLowerBounds = rhs.mLowerBounds;
+    mUpperBounds = rhs.mUpperBounds;
+    mObjectiveCoefficients = rhs.mObjectiveCoefficients;
+    mModelLowerBounds = rhs.mModelLowerBounds;
+    mModelUpperBounds = rhs.mModelUpperBounds;
+    mModelObjectiveCoefficients = rhs.mModelObjectiveCoefficients;
+    mParameterIndexes = rhs.mParameterIndexes;
+  }
+  return *this;
+}
+
+
+FluxBoundsView*
+FluxBoundsView::clone() const
+{
+  return new FluxBoundsView(*this);
+}
+
+
+int
+FluxBoundsView::setModel(Model* model)
+{
+  mModel = model;
+  return refresh();
+}
+
+
+int
+FluxBoundsView::refresh()
+{
+  if (mModel == NULL)
+  {
+    return LIBSBML_INVALID_OBJECT;
+  }
+
+  // the changes not yet committed, by reaction id, and the values they
+  // replace
+  vector<string> ids;
+  vector<double> changes;
+  for (unsigned int n = 0; n < mReactionIds.size(); ++n)
+  {
+    if (isChanged(n))
+    {
+      ids.push_back(mReactionIds[n]);
+      changes.push_back(mLowerBounds[n]);
+      changes.push_back(mModelLowerBounds[n]);
+      changes.push_back(mUpperBounds[n]);
+      changes.push_back(mModelUpperBounds[n]);
+      changes.push_back(mObjectiveCoefficients[n]);
+      changes.push_back(mModelObjectiveCoefficients[n]);
+    }
+  }
+
+  read();
+
+  for (size_t i = 0; i < ids.size(); ++i)
+  {
+    int n = getReactionIndex(ids[i]);
+    if (n < 0)
+      continue;
+
+    // only the values changed in the view replace those of the model
+    const double* change = &changes[6 * i];
+    if (differs(change[0], change[1]))
+      mLowerBounds[n] = change[0];
+    if (differs(change[2], change[3]))
+      mUpperBounds[n] = change[2];
+    if (differs(change[4], change[5]))
+      mObjectiveCoefficients[n] = change[4];
+  }
+
+  return LIBSBML_OPERATION_SUCCESS;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+void
+FluxBoundsView::read()
+{
+  mReactionIds.clear();
+  mReactionIndexes.clear();
+  mLowerBounds.clear();
+  mUpperBounds.clear();
+  mObjectiveCoefficients.clear();
+  mParameterIndexes.clear();
+
+  if (mModel != NULL)
+  {
+    for (unsigned int i = 0; i < mModel->getNumParameters(); ++i)
+    {
+      mParameterIndexes.insert(make_pair(mModel->getParameter(i)->getId(), i));
+    }
+
+    const FbcModelPlugin* plugin =
+      dynamic_cast<const FbcModelPlugin*>(mModel->getPlugin("fbc"));
+
+    unsigned int numReactions = mModel->getNumReactions();
+    mReactionIds.reserve(numReactions);
+    mLowerBounds.assign(numReactions, util_NegInf());
+    mUpperBounds.assign(numReactions, util_PosInf());
+    mObjectiveCoefficients.assign(numReactions, 0.0);
+
+    for (unsigned int n = 0; n < numReactions; ++n)
+    {
+      const Reaction* reaction = mModel->getReaction(n);
+      mReactionIds.push_back(reaction->getId());
+      mReactionIndexes.insert(make_pair(reaction->getId(), (int)n));
+
+      const FbcReactionPlugin* rplugin =
+        dynamic_cast<const FbcReactionPlugin*>(reaction->getPlugin("fbc"));
+      if (rplugin == NULL)
+        continue;
+
+      if (rplugin->isSetLowerFluxBound())
+      {
+        const Parameter* bound = getParameter(rplugin->getLowerFluxBound());
+        if (bound != NULL)
+          mLowerBounds[n] = bound->getValue();
+      }
+      if (rplugin->isSetUpperFluxBound())
+      {
+        const Parameter* bound = getParameter(rplugin->getUpperFluxBound());
+        if (bound != NULL)
+          mUpperBounds[n] = bound->getValue();
+      }
+    }
+
+    if (plugin != NULL)
+    {
+      for (unsigned int i = 0; i < plugin->getNumFluxBounds(); ++i)
+      {
+        const FluxBound* bound = plugin->getFluxBound(i);
+        int n = getReactionIndex(bound->getReaction());
+        if (n < 0)
+          continue;
+
+        switch (bound->getFluxBoundOperation())
+        {
+        case FLUXBOUND_OPERATION_LESS_EQUAL:
+        case FLUXBOUND_OPERATION_LESS:
+          mUpperBounds[n] = bound->getValue();
+          break;
+        case FLUXBOUND_OPERATION_GREATER_EQUAL:
+        case FLUXBOUND_OPERATION_GREATER:
+          mLowerBounds[n] = bound->getValue();
+          break;
+        case FLUXBOUND_OPERATION_EQUAL:
+          mLowerBounds[n] = bound->getValue();
+          mUpperBounds[n] = bound->getValue();
+          break;
+        default:
+          break;
+        }
+      }
+
+      const Objective* objective = plugin->getActiveObjective();
+      for (unsigned int i = 0;
+           objective != NULL && i < objective->getNumFluxObjectives(); ++i)
+      {
+        const FluxObjective* flux = objective->getFluxObjective(i);
+        int n = getReactionIndex(flux->getReaction());
+        if (n >= 0)
+          mObjectiveCoefficients[n] += flux->getCoefficient();
+      }
+    }
+  }
+
+  mModelLowerBounds = mLowerBounds;
+  mModelUpperBounds = mUpperBounds;
+  mModelObjectiveCoefficients = mObjectiveCoefficients;
+}
+/** @endcond */
+
+
+unsigned int
+FluxBoundsView::getNumReactions() const
+{
+  return (unsigned int)mReactionIds.size();
+}
+
+
+const string&
+FluxBoundsView::getReactionId(unsigned int n) const
+{
+  return n < mReactionIds.size() ? mReactionIds[n] : EMPTY_STRING;
+}
+
+
+int
+FluxBoundsView::getReactionIndex(const string& sid) const
+{
+  map<string, int>::const_iterator it = mReactionIndexes.find(sid);
+  return it != mReactionIndexes.end() ? it->second : -1;
+}
+
+
+double*
+FluxBoundsView::getLowerBounds()
+{
+  return arrayOf(mLowerBounds);
+}
+
+
+double*
+FluxBoundsView::getUpperBounds()
+{
+  return arrayOf(mUpperBounds);
+}
+
+
+double*
+FluxBoundsView::getObjectiveCoefficients()
+{
+  return arrayOf(mObjectiveCoefficients);
+}
+
+
+int
+FluxBoundsView::setBounds(unsigned int n, double lower, double upper)
+{
+  if (n >= mReactionIds.size())
+  {
+    return LIBSBML_INDEX_EXCEEDS_SIZE;
+  }
+
+  mLowerBounds[n] = lower;
+  mUpperBounds[n] = upper;
+  return LIBSBML_OPERATION_SUCCESS;
+}
+
+
+int
+FluxBoundsView::setObjectiveCoefficient(unsigned int n, double coefficient)
+{
+  if (n >= mReactionIds.size())
+  {
+    return LIBSBML_INDEX_EXCEEDS_SIZE;
+  }
+
+  mObjectiveCoefficients[n] = coefficient;
+  return LIBSBML_OPERATION_SUCCESS;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+bool
+FluxBoundsView::isChanged(unsigned int n) const
+{
+  return differs(mLowerBounds[n], mModelLowerBounds[n]) ||
+         differs(mUpperBounds[n], mModelUpperBounds[n]) ||
+         differs(mObjectiveCoefficients[n], mModelObjectiveCoefficients[n]);
+}
+/** @endcond */
+
+
+unsigned int
+FluxBoundsView::getNumChangedReactions() const
+{
+  unsigned int count = 0;
+  for (unsigned int n = 0; n < mReactionIds.size(); ++n)
+  {
+    if (isChanged(n))
+      ++count;
+  }
+  return count;
+}
+
+
+int
+FluxBoundsView::commit()
+{
+  if (mModel == NULL)
+  {
+    return LIBSBML_INVALID_OBJECT;
+  }
+
+  if (getNumChangedReactions() == 0)
+  {
+    return LIBSBML_OPERATION_SUCCESS;
+  }
+
+  FbcModelPlugin* plugin =
+    dynamic_cast<FbcModelPlugin*>(mModel->getPlugin("fbc"));
+  if (plugin == NULL)
+  {
+    return LIBSBML_INVALID_OBJECT;
+  }
+
+  bool fluxBounds = plugin->getPackageVersion() == 1;
+  vector<bool> changedBounds(mReactionIds.size(), false);
+  mUsedIds.clear();
+  if (!fluxBounds)
+  {
+    countParameterUses();
+  }
+
+  for (unsigned int n = 0; n < mReactionIds.size(); ++n)
+  {
+    bool lowerChanged = differs(mLowerBounds[n], mModelLowerBounds[n]);
+    bool upperChanged = differs(mUpperBounds[n], mModelUpperBounds[n]);
+    if (fluxBounds)
+    {
+      changedBounds[n] = lowerChanged || upperChanged;
+    }
+    else
+    {
+      if (lowerChanged)
+        writeBoundParameter(n, true);
+      if (upperChanged)
+        writeBoundParameter(n, false);
+    }
+
+    if (differs(mObjectiveCoefficients[n], mModelObjectiveCoefficients[n]))
+    {
+      writeObjectiveCoefficient(n);
+    }
+  }
+
+  if (fluxBounds)
+  {
+    writeFluxBounds(changedBounds);
+  }
+
+  mUsedIds.clear();
+  mParameterUses.clear();
+  mModelLowerBounds = mLowerBounds;
+  mModelUpperBounds = mUpperBounds;
+  mModelObjectiveCoefficients = mObjectiveCoefficients;
+  return LIBSBML_OPERATION_SUCCESS;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Returns the reaction of the view with index 'n', if it is still in the
+ * model.
+ */
+Reaction*
+FluxBoundsView::getReaction(unsigned int n) const
+{
+  Reaction* reaction = mModel->getReaction(n);
+  if (reaction == NULL || reaction->getId() != mReactionIds[n])
+  {
+    reaction = mModel->getReaction(mReactionIds[n]);
+  }
+  return reaction;
+}
+
+
+/*
+ * Returns the parameter with the given id, found through the positions
+ * recorded when the view was read.
+ */
+Parameter*
+FluxBoundsView::getParameter(const string& sid) const
+{
+  map<string, unsigned int>::const_iterator it = mParameterIndexes.find(sid);
+  if (it != mParameterIndexes.end())
+  {
+    Parameter* parameter = mModel->getParameter(it->second);
+    if (parameter != NULL && parameter->getId() == sid)
+      return parameter;
+  }
+  return mModel->getParameter(sid);
+}
+
+
+/*
+ * Counts how many bounds of the reactions of the model reference each
+ * parameter.  The count is taken when committing rather than when the
+ * view is read, as bounds may have been changed through the model since.
+ */
+void
+FluxBoundsView::countParameterUses()
+{
+  mParameterUses.clear();
+  for (unsigned int n = 0; n < mModel->getNumReactions(); ++n)
+  {
+    const FbcReactionPlugin* rplugin = dynamic_cast<const FbcReactionPlugin*>
+      (mModel->getReaction(n)->getPlugin("fbc"));
+    if (rplugin == NULL)
+      continue;
+
+    if (rplugin->isSetLowerFluxBound())
+      ++mParameterUses[rplugin->getLowerFluxBound()];
+    if (rplugin->isSetUpperFluxBound())
+      ++mParameterUses[rplugin->getUpperFluxBound()];
+  }
+}
+
+
+void
+FluxBoundsView::writeBoundParameter(unsigned int n, bool lower)
+{
+  Reaction* reaction = getReaction(n);
+  FbcReactionPlugin* rplugin = reaction == NULL ? NULL :
+    dynamic_cast<FbcReactionPlugin*>(reaction->getPlugin("fbc"));
+  if (rplugin == NULL)
+    return;
+
+  double value = lower ? mLowerBounds[n] : mUpperBounds[n];
+  string id = lower ? rplugin->getLowerFluxBound()
+                    : rplugin->getUpperFluxBound();
+  Parameter* parameter = id.empty() ? NULL : getParameter(id);
+
+  if (parameter != NULL && mParameterUses[id] == 1)
+  {
+    parameter->setValue(value);
+    return;
+  }
+
+  // the parameter is shared with other bounds (or missing):  give the
+  // reaction one of its own
+  string newId = getUniqueId(mReactionIds[n] +
+                             (lower ? "_lower_bound" : "_upper_bound"));
+  Parameter* newParameter = mModel->createParameter();
+  newParameter->setId(newId);
+  newParameter->setValue(value);
+  newParameter->setConstant(true);
+  newParameter->setSBOTerm(FLUX_BOUND_SBO_TERM);
+  mParameterIndexes[newId] = mModel->getNumParameters() - 1;
+  if (parameter != NULL && parameter->isSetUnits())
+  {
+    newParameter->setUnits(parameter->getUnits());
+  }
+
+  if (lower)
+    rplugin->setLowerFluxBound(newId);
+  else
+    rplugin->setUpperFluxBound(newId);
+
+  if (!id.empty())
+    --mParameterUses[id];
+  mParameterUses[newId] = 1;
+}
+
+
+/*
+ * Updates, removes and creates the FluxBound objects of the reactions whose
+ * bounds changed, for fbc version 1.
+ */
+void
+FluxBoundsView::writeFluxBounds(const vector<bool>& changed)
+{
+  FbcModelPlugin* plugin =
+    static_cast<FbcModelPlugin*>(mModel->getPlugin("fbc"));
+
+  vector<bool> lowerWritten(changed.size(), false);
+  vector<bool> upperWritten(changed.size(), false);
+  vector<unsigned int> obsolete;
+
+  for (unsigned int i = 0; i < plugin->getNumFluxBounds(); ++i)
+  {
+    FluxBound* bound = plugin->getFluxBound(i);
+    int n = getReactionIndex(bound->getReaction());
+    if (n < 0 || !changed[n])
+      continue;
+
+    double lower = mLowerBounds[n];
+    double upper = mUpperBounds[n];
+    bool hasLower = !lowerWritten[n] && util_isInf(lower) != -1;
+    bool hasUpper = !upperWritten[n] && util_isInf(upper) != 1;
+
+    switch (bound->getFluxBoundOperation())
+    {
+    case FLUXBOUND_OPERATION_EQUAL:
+      if (hasLower && hasUpper && lower == upper)
+      {
+        bound->setValue(lower);
+        lowerWritten[n] = upperWritten[n] = true;
+        break;
+      }
+      // otherwise reuse the bound for either side
+      // fall through
+    case FLUXBOUND_OPERATION_GREATER_EQUAL:
+    case FLUXBOUND_OPERATION_GREATER:
+      if (hasLower)
+      {
+        bound->setOperation(FLUXBOUND_OPERATION_GREATER_EQUAL);
+        bound->setValue(lower);
+        lowerWritten[n] = true;
+        break;
+      }
+      if (hasUpper &&
+          bound->getFluxBoundOperation() == FLUXBOUND_OPERATION_EQUAL)
+      {
+        bound->setOperation(FLUXBOUND_OPERATION_LESS_EQUAL);
+        bound->setValue(upper);
+        upperWritten[n] = true;
+        break;
+      }
+      obsolete.push_back(i);
+      break;
+    case FLUXBOUND_OPERATION_LESS_EQUAL:
+    case FLUXBOUND_OPERATION_LESS:
+      if (hasUpper)
+      {
+        bound->setOperation(FLUXBOUND_OPERATION_LESS_EQUAL);
+        bound->setValue(upper);
+        upperWritten[n] = true;
+        break;
+      }
+      obsolete.push_back(i);
+      break;
+    default:
+      break;
+    }
+  }
+
+  for (size_t i = obsolete.size(); i > 0; --i)
+  {
+    delete plugin->removeFluxBound(obsolete[i - 1]);
+  }
+
+  for (unsigned int n = 0; n < changed.size(); ++n)
+  {
+    if (!changed[n])
+      continue;
+
+    double lower = mLowerBounds[n];
+    double upper = mUpperBounds[n];
+    bool needLower = !lowerWritten[n] && util_isInf(lower) != -1;
+    bool needUpper = !upperWritten[n] && util_isInf(upper) != 1;
+
+    if (needLower && needUpper && lower == upper)
+    {
+      FluxBound* bound = plugin->createFluxBound();
+      bound->setReaction(mReactionIds[n]);
+      bound->setOperation(FLUXBOUND_OPERATION_EQUAL);
+      bound->setValue(lower);
+      continue;
+    }
+    if (needLower)
+    {
+      FluxBound* bound = plugin->createFluxBound();
+      bound->setReaction(mReactionIds[n]);
+      bound->setOperation(FLUXBOUND_OPERATION_GREATER_EQUAL);
+      bound->setValue(lower);
+    }
+    if (needUpper)
+    {
+      FluxBound* bound = plugin->createFluxBound();
+      bound->setReaction(mReactionIds[n]);
+      bound->setOperation(FLUXBOUND_OPERATION_LESS_EQUAL);
+      bound->setValue(upper);
+    }
+  }
+}
+
+
+void
+FluxBoundsView::writeObjectiveCoefficient(unsigned int n)
+{
+  FbcModelPlugin* plugin =
+    static_cast<FbcModelPlugin*>(mModel->getPlugin("fbc"));
+  double coefficient = mObjectiveCoefficients[n];
+
+  Objective* objective = plugin->getActiveObjective();
+  if (objective == NULL)
+  {
+    if (coefficient == 0)
+      return;
+
+    objective = plugin->createObjective();
+    objective->setId(getUniqueId("obj"));
+    objective->setType(OBJECTIVE_TYPE_MAXIMIZE);
+    plugin->setActiveObjectiveId(objective->getId());
+  }
+
+  // read() adds up the coefficients of all flux objectives of a reaction,
+  // so the first one is given the total and the others are removed
+  bool written = false;
+  for (unsigned int i = 0; i < objective->getNumFluxObjectives(); )
+  {
+    FluxObjective* flux = objective->getFluxObjective(i);
+    if (flux->getReaction() != mReactionIds[n])
+    {
+      ++i;
+    }
+    else if (!written)
+    {
+      flux->setCoefficient(coefficient);
+      written = true;
+      ++i;
+    }
+    else
+    {
+      delete objective->removeFluxObjective(i);
+    }
+  }
+
+  if (!written && coefficient != 0)
+  {
+    FluxObjective* flux = objective->createFluxObjective();
+    flux->setReaction(mReactionIds[n]);
+    flux->setCoefficient(coefficient);
+  }
+}
+
+
+/*
+ * Returns 'base', or 'base' followed by a number, whichever is not yet
+ * the id of an element of the model.
+ */
+string
+FluxBoundsView::getUniqueId(const string& base)
+{
+  if (mUsedIds.empty())
+  {
+    List* elements = mModel->getAllElements();
+    for (unsigned int i = 0; i < elements->getSize(); ++i)
+    {
+      const SBase* element = static_cast<const SBase*>(elements->get(i));
+      if (element->isSetIdAttribute())
+        mUsedIds.insert(element->getIdAttribute());
+    }
+    delete elements;
+    mUsedIds.insert(mModel->getId());
+  }
+
+  string id = base;
+  for (unsigned int suffix = 1; mUsedIds.find(id) != mUsedIds.end(); ++suffix)
+  {
+    ostringstream candidate;
+    candidate << base << "_" << suffix;
+    id = candidate.str();
+  }
+  mUsedIds.insert(id);
+  return id;
+}
+/** @endcond */
+
+
+#endif  /* __cplusplus */
+
+LIBSBML_CPP_NAMESPACE_END
@@ -0,0 +1,315 @@
+/**
+ * @file    FluxBoundsView.h
+ * @brief   Definition of FluxBoundsView, the flux bounds and objective
+ *          coefficients of an fbc model as arrays.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class FluxBoundsView
+ * @sbmlbrief{fbc} The flux bounds and objective coefficients of a model as
+ * arrays that can be changed in place.
+ *
+ * @htmlinclude libsbml-facility-only-warning.html
+ *
+ * Solvers that change the bounds of many reactions between runs spend most
+ * of their time looking up the Parameter objects referenced by the
+ * &ldquo;fbc&rdquo; attributes 'lowerFluxBound' and 'upperFluxBound' and
+ * setting their values one at a time.  A FluxBoundsView holds the lower and
+ * upper bound and the coefficient in the active Objective of every Reaction
+ * of a model in contiguous arrays, indexed like the reactions of the model,
+ * that can be changed directly.
+ *
+ * Changes are only written back to the model by commit(), which compares
+ * the arrays with the values last read from or written to the model and
+ * updates the model for the entries that differ.  Nothing else writes them
+ * back; in particular, writing out the model leaves it as it is.  When
+ * committing
+ *
+ * @li a Parameter referenced by the bound of only one reaction is set to the
+ * new value;  a reaction that shares its Parameter with other bounds, or has
+ * none, is given a new Parameter of its own;
+ *
+ * @li the FluxBound objects of the reaction are updated, created or removed
+ * for models using &ldquo;fbc&rdquo; Version&nbsp;1;
+ *
+ * @li the FluxObjective of the reaction in the active Objective is updated,
+ * or created if the coefficient is not zero.
+ *
+ * The view reflects the reactions of the model at the time it was created or
+ * last refreshed; after reactions, bounds or objectives have been changed
+ * through the model, refresh() has to be called.  A copy of a model keeps
+ * the changes not yet committed to the view of the original.
+ */
+
+#ifndef FluxBoundsView_h
+#define FluxBoundsView_h
+
+#include <sbml/common/extern.h>
+#include <sbml/common/operationReturnValues.h>
+
+#ifdef __cplusplus
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+class Model;
+class Parameter;
+class Reaction;
+
+
+class LIBSBML_EXTERN FluxBoundsView
+{
+public:
+
+  /**
+   * Creates a new FluxBoundsView of the given model.
+   *
+   * @param model the Model to view; it has to outlive the view.
+   */
+  FluxBoundsView(Model* model);
+
+
+  /**
+   * Copy constructor; creates a copy of this FluxBoundsView, which views
+   * the same model and has the same changes not yet committed.
+   *
+   * @param orig the object to copy.
+   */
+  FluxBoundsView(const FluxBoundsView& orig);
+
+
+  /**
+   * Assignment operator for FluxBoundsView.
+   *
+   * @param rhs the object whose values are used as the basis of the
+   * assignment.
+   */
+  FluxBoundsView& operator=(const FluxBoundsView& rhs);
+
+
+  /**
+   * Creates and returns a deep copy of this FluxBoundsView object.
+   *
+   * @return a (deep) copy of this FluxBoundsView object.
+   */
+  virtual FluxBoundsView* clone() const;
+
+
+  /**
+   * Destroys this FluxBoundsView, without committing changes.
+   */
+  virtual ~FluxBoundsView();
+
+
+  /**
+   * Returns the model of this view.
+   *
+   * @return the Model whose bounds this view holds.
+   */
+  Model* getModel() const;
+
+
+  /**
+   * Makes this view a view of another model, keeping the changes not yet
+   * committed for the reactions that model has as well.
+   *
+   * @param model the Model to view; it has to outlive the view.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBSBML_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBSBML_INVALID_OBJECT, OperationReturnValues_t}
+   */
+  int setModel(Model* model);
+
+
+  /**
+   * Reads the bounds and objective coefficients from the model again.
+   *
+   * Changes not yet committed are kept for the reactions still in the
+   * model, and replace the values read for them.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBSBML_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBSBML_INVALID_OBJECT, OperationReturnValues_t}
+   */
+  int refresh();
+
+
+  /**
+   * Returns the number of reactions of this view.
+   *
+   * @return the length of the arrays.
+   */
+  unsigned int getNumReactions() const;
+
+
+  /**
+   * Returns the id of the reaction with index @p n.
+   *
+   * @param n the index of the reaction.
+   *
+   * @return the id of the reaction, or the empty string if there is no such
+   * reaction.
+   */
+  const std::string& getReactionId(unsigned int n) const;
+
+
+  /**
+   * Returns the index of the reaction with the given id.
+   *
+   * @param sid the id of the reaction.
+   *
+   * @return the index of the reaction, or @c -1 if there is no such
+   * reaction.
+   */
+  int getReactionIndex(const std::string& sid) const;
+
+
+  /**
+   * Returns the lower bounds of the reactions, which can be changed in
+   * place.  Unbounded reactions have a bound of minus infinity.
+   *
+   * @return an array of getNumReactions() bounds.
+   */
+  double* getLowerBounds();
+
+
+  /**
+   * Returns the upper bounds of the reactions, which can be changed in
+   * place.  Unbounded reactions have a bound of infinity.
+   *
+   * @return an array of getNumReactions() bounds.
+   */
+  double* getUpperBounds();
+
+
+  /**
+   * Returns the coefficients of the reactions in the active objective,
+   * which can be changed in place.
+   *
+   * @return an array of getNumReactions() coefficients.
+   */
+  double* getObjectiveCoefficients();
+
+
+  /**
+   * Sets the bounds of the reaction with index @p n.
+   *
+   * @param n the index of the reaction.
+   * @param lower the new lower bound.
+   * @param upper the new upper bound.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBSBML_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBSBML_INDEX_EXCEEDS_SIZE, OperationReturnValues_t}
+   */
+  int setBounds(unsigned int n, double lower, double upper);
+
+
+  /**
+   * Sets the objective coefficient of the reaction with index @p n.
+   *
+   * @param n the index of the reaction.
+   * @param coefficient the new coefficient.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBSBML_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBSBML_INDEX_EXCEEDS_SIZE, OperationReturnValues_t}
+   */
+  int setObjectiveCoefficient(unsigned int n, double coefficient);
+
+
+  /**
+   * Returns the number of reactions whose bounds or objective coefficient
+   * differ from the model.
+   *
+   * @return the number of reactions still to be committed.
+   */
+  unsigned int getNumChangedReactions() const;
+
+
+  /**
+   * Writes the changed bounds and objective coefficients back to the
+   * model.
+   *
+   * Whether a Parameter is shared by several bounds is decided from the
+   * reactions of the model at the time of the commit.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBSBML_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBSBML_INVALID_OBJECT, OperationReturnValues_t}
+   */
+  int commit();
+
+
+protected:
+  /** @cond doxygenLibsbmlInternal */
+
+  void read();
+
+  bool isChanged(unsigned int n) const;
+
+  Reaction* getReaction(unsigned int n) const;
+
+  Parameter* getParameter(const std::string& sid) const;
+
+  void countParameterUses();
+
+  void writeBoundParameter(unsigned int n, bool lower);
+
+  void writeFluxBounds(const std::vector<bool>& changed);
+
+  void writeObjectiveCoefficient(unsigned int n);
+
+  std::string getUniqueId(const std::string& base);
+
+  Model* mModel;
+
+  std::vector<std::string> mReactionIds;
+  std::map<std::string, int> mReactionIndexes;
+
+  std::vector<double> mLowerBounds;
+  std::vector<double> mUpperBounds;
+  std::vector<double> mObjectiveCoefficients;
+
+  // the values as last read from or written to the model
+  std::vector<double> mModelLowerBounds;
+  std::vector<double> mModelUpperBounds;
+  std::vector<double> mModelObjectiveCoefficients;
+
+  // the positions of the parameters
+  std::map<std::string, unsigned int> mParameterIndexes;
+
+  // how many bounds reference each parameter, and the ids in use in the
+  // model, while committing
+  std::map<std::string, unsigned int> mParameterUses;
+  std::set<std::string> mUsedIds;
+
+  /** @endcond */
+};
+
+
+LIBSBML_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+#endif  /* FluxBoundsView_h */
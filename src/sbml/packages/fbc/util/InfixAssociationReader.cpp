@@ -0,0 +1,270 @@
+/**
+ * @file    InfixAssociationReader.cpp
+ * @brief   Implementation of InfixAssociationReader, the tokenizer and
+ *          grammar shared by the infix gene association parsers.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ */
+
+#include <sbml/packages/fbc/util/InfixAssociationReader.h>
+
+#include <cctype>
+#include <cstring>
+
+using namespace std;
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+#ifdef __cplusplus
+
+/** @cond doxygenLibsbmlInternal */
+InfixAssociationReader::InfixAssociationReader(const string& infix,
+                                               bool formulaNames)
+  : mInfix(infix)
+  , mFormulaNames(formulaNames)
+  , mPos(0)
+  , mStart(0)
+  , mToken(END_TOKEN)
+{
+}
+
+
+size_t
+InfixAssociationReader::read()
+{
+  mPos = 0;
+  mNodes.clear();
+  nextToken();
+  size_t root = readGroup(OR);
+  if (mToken != END_TOKEN)
+    return string::npos;
+  return root;
+}
+
+
+const InfixAssociationReader::Node&
+InfixAssociationReader::getNode(size_t n) const
+{
+  return mNodes[n];
+}
+
+
+string
+InfixAssociationReader::getName(const Node& node) const
+{
+  return mInfix.substr(node.start, node.length);
+}
+
+
+bool
+InfixAssociationReader::isNameCharacter(char c) const
+{
+  if (!mFormulaNames)
+    return c != '(' && c != ')' && !isspace((unsigned char)c);
+
+  return isalnum((unsigned char)c) || c == '_' || c == '.' ||
+         c == ':' || c == '-';
+}
+
+
+/*
+ * Returns whether the formula parser reads the current name as something
+ * else than a name (a constant), or as a different name.
+ */
+bool
+InfixAssociationReader::isSpecialName() const
+{
+  static const char* constants[] =
+    { "pi", "exponentiale", "true", "false", "inf", "nan" };
+
+  size_t length = mPos - mStart;
+  if (mInfix.substr(mStart, length).find("__") != string::npos)
+    return true;
+
+  for (size_t i = 0; i < sizeof(constants) / sizeof(constants[0]); ++i)
+  {
+    if (strlen(constants[i]) != length)
+      continue;
+
+    size_t c = 0;
+    while (c < length &&
+           tolower((unsigned char)mInfix[mStart + c]) == constants[i][c])
+    {
+      ++c;
+    }
+    if (c == length)
+      return true;
+  }
+  return false;
+}
+
+
+/*
+ * Returns whether the current name is the given operator.  For the formula
+ * parser, 'and' and 'or' are operators only between single spaces.
+ */
+bool
+InfixAssociationReader::isOperator(const char* op, size_t length) const
+{
+  if (mPos - mStart != length)
+    return false;
+
+  if (mFormulaNames &&
+      (mStart == 0 || mPos >= mInfix.size() ||
+       mInfix[mStart - 1] != ' ' || mInfix[mPos] != ' '))
+  {
+    return false;
+  }
+
+  return mInfix.compare(mStart, length, op) == 0;
+}
+
+
+void
+InfixAssociationReader::nextToken()
+{
+  while (mPos < mInfix.size() && isspace((unsigned char)mInfix[mPos]))
+    ++mPos;
+
+  mStart = mPos;
+  if (mPos == mInfix.size())
+  {
+    mToken = END_TOKEN;
+    return;
+  }
+
+  char c = mInfix[mPos];
+  if (c == '(' || c == ')')
+  {
+    mToken = (c == '(') ? OPEN_TOKEN : CLOSE_TOKEN;
+    ++mPos;
+    return;
+  }
+
+  while (mPos < mInfix.size() && isNameCharacter(mInfix[mPos]))
+    ++mPos;
+
+  if (mPos == mStart)
+  {
+    mToken = INVALID_TOKEN;
+  }
+  else if (isOperator("and", 3) || isOperator("AND", 3))
+  {
+    mToken = AND_TOKEN;
+  }
+  else if (isOperator("or", 2) || isOperator("OR", 2))
+  {
+    mToken = OR_TOKEN;
+  }
+  else if (mFormulaNames && isSpecialName())
+  {
+    mToken = INVALID_TOKEN;
+  }
+  else
+  {
+    mToken = NAME_TOKEN;
+  }
+}
+
+
+size_t
+InfixAssociationReader::addNode(NodeType type, size_t start, size_t length)
+{
+  mNodes.push_back(Node());
+  mNodes.back().type = type;
+  mNodes.back().start = start;
+  mNodes.back().length = length;
+  return mNodes.size() - 1;
+}
+
+
+/*
+ * Adds 'child' to 'group', or its operands if it combines them with the
+ * same operator.
+ */
+void
+InfixAssociationReader::addOperand(size_t group, size_t child)
+{
+  if (mNodes[child].type == mNodes[group].type)
+  {
+    vector<size_t> children;
+    children.swap(mNodes[child].children);
+    mNodes[group].children.insert(mNodes[group].children.end(),
+                                  children.begin(), children.end());
+  }
+  else
+  {
+    mNodes[group].children.push_back(child);
+  }
+}
+
+
+size_t
+InfixAssociationReader::readOperand(NodeType type)
+{
+  return (type == OR) ? readGroup(AND) : readPrimary();
+}
+
+
+size_t
+InfixAssociationReader::readGroup(NodeType type)
+{
+  TokenType op = (type == OR) ? OR_TOKEN : AND_TOKEN;
+  size_t first = readOperand(type);
+  if (first == string::npos || mToken != op)
+    return first;
+
+  size_t group = addNode(type, 0, 0);
+  addOperand(group, first);
+  while (mToken == op)
+  {
+    nextToken();
+    size_t operand = readOperand(type);
+    if (operand == string::npos)
+      return string::npos;
+    addOperand(group, operand);
+  }
+  return group;
+}
+
+
+size_t
+InfixAssociationReader::readPrimary()
+{
+  if (mToken == NAME_TOKEN)
+  {
+    size_t leaf = addNode(NAME, mStart, mPos - mStart);
+    nextToken();
+    return leaf;
+  }
+
+  if (mToken != OPEN_TOKEN)
+    return string::npos;
+
+  nextToken();
+  size_t inner = readGroup(OR);
+  if (inner == string::npos || mToken != CLOSE_TOKEN)
+    return string::npos;
+  nextToken();
+  return inner;
+}
+/** @endcond */
+
+#endif  /* __cplusplus */
+
+LIBSBML_CPP_NAMESPACE_END
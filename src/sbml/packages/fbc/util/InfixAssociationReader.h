@@ -0,0 +1,148 @@
+/**
+ * @file    InfixAssociationReader.h
+ * @brief   Definition of InfixAssociationReader, the tokenizer and grammar
+ *          shared by the infix gene association parsers.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class InfixAssociationReader
+ * @sbmlbrief{fbc} Reads infix gene associations into a tree of nodes.
+ *
+ * @htmlinclude not-sbml-warning.html
+ *
+ * Reads gene associations such as 'b0001 and (b0002 or b0003)' with the
+ * grammar
+ *
+ *   or      := and ( ('or' | 'OR') and )*
+ *   and     := primary ( ('and' | 'AND') primary )*
+ *   primary := '(' or ')' | name
+ *
+ * in a single pass, into a tree of nodes in which nested groups of the same
+ * operator are merged.  Association (for &ldquo;fbc&rdquo;
+ * Version&nbsp;1 annotations) and FbcAssociation (for
+ * &ldquo;fbc&rdquo; Version&nbsp;2) build their own elements from the
+ * nodes.
+ *
+ * The two differ in what they accept as a name.  FbcAssociation takes any
+ * run of characters other than whitespace and parentheses, and the
+ * operators between any whitespace.  Association falls back on the
+ * formula parser for anything but names made of letters, digits, '_', '.',
+ * ':' and '-' and operators between single spaces, so it reads only those
+ * names and rejects those that the formula parser reads as something else
+ * (constants, and names containing '__').
+ */
+
+#ifndef InfixAssociationReader_h
+#define InfixAssociationReader_h
+
+#include <sbml/common/extern.h>
+
+#ifdef __cplusplus
+
+#include <string>
+#include <vector>
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+/** @cond doxygenLibsbmlInternal */
+class LIBSBML_EXTERN InfixAssociationReader
+{
+public:
+
+  enum NodeType { NAME, AND, OR };
+
+  struct Node
+  {
+    NodeType                 type;
+    size_t                   start;
+    size_t                   length;
+    std::vector<size_t>      children;
+  };
+
+
+  /**
+   * Creates a new reader of the given string.
+   *
+   * @param infix the association; it has to outlive the reader.
+   * @param formulaNames @c true to accept only the names and operators the
+   * formula parser reads the same way, @c false to accept any name.
+   */
+  InfixAssociationReader(const std::string& infix, bool formulaNames);
+
+
+  /**
+   * Reads the association.
+   *
+   * @return the index of the root node, or @c std::string::npos if the
+   * string is not a valid association.
+   */
+  size_t read();
+
+
+  /**
+   * @return the node with index @p n.
+   */
+  const Node& getNode(size_t n) const;
+
+
+  /**
+   * @return the name of a node of type NAME.
+   */
+  std::string getName(const Node& node) const;
+
+
+private:
+
+  enum TokenType { NAME_TOKEN, AND_TOKEN, OR_TOKEN, OPEN_TOKEN,
+                   CLOSE_TOKEN, END_TOKEN, INVALID_TOKEN };
+
+  bool isNameCharacter(char c) const;
+
+  bool isSpecialName() const;
+
+  bool isOperator(const char* op, size_t length) const;
+
+  void nextToken();
+
+  size_t addNode(NodeType type, size_t start, size_t length);
+
+  void addOperand(size_t group, size_t child);
+
+  size_t readOperand(NodeType type);
+
+  size_t readGroup(NodeType type);
+
+  size_t readPrimary();
+
+  const std::string& mInfix;
+  bool               mFormulaNames;
+  size_t             mPos;
+  size_t             mStart;
+  TokenType          mToken;
+  std::vector<Node>  mNodes;
+
+  InfixAssociationReader(const InfixAssociationReader&);
+  InfixAssociationReader& operator=(const InfixAssociationReader&);
+};
+/** @endcond */
+
+LIBSBML_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+#endif  /* InfixAssociationReader_h */
@@ -358,6 +358,16 @@ Member::renameSIdRefs(const std::string& oldid, const std::string& newid)
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+Member::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mIdRef);
+}
+
+
 /*
  * Returns the XML element name of this Member object.
  */
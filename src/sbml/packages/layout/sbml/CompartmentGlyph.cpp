@@ -66,6 +66,14 @@ CompartmentGlyph::renameSIdRefs(const std::string& oldid, const std::string& new
   }
 }
 
+
+void
+CompartmentGlyph::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  GraphicalObject::renameSIdRefs(renames);
+  renameIdRef(mCompartment, renames);
+}
+
 /*
  * Default Constructor which creates a new CompartmentGlyph.  Id and
  * associated compartment id are unset.
@@ -83,6 +83,14 @@ GeneralGlyph::renameSIdRefs(const std::string& oldid, const std::string& newid)
   }
 }
 
+
+void
+GeneralGlyph::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  GraphicalObject::renameSIdRefs(renames);
+  renameIdRef(mReference, renames);
+}
+
 /*
  * Creates a new GeneralGlyph.  The list of reference and sub glyph is
  * empty and the id of the associated element is set to the empty string.
@@ -82,6 +82,14 @@ GraphicalObject::renameMetaIdRefs(const std::string& oldid, const std::string& n
   }
 }
 
+
+void
+GraphicalObject::renameMetaIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameMetaIdRefs(renames);
+  renameIdRef(mMetaIdRef, renames);
+}
+
 /*
  * Creates a new GraphicalObject.
  */
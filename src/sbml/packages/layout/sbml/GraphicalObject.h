@@ -218,6 +218,14 @@ public:
    */
   virtual void renameMetaIdRefs(const std::string& oldid, const std::string& newid);
 
+
+#ifndef SWIG
+  /**
+   * @copydoc SBase::renameMetaIdRefs(const std::map<std::string, std::string>& renames)
+   */
+  virtual void renameMetaIdRefs(const std::map<std::string, std::string>& renames);
+#endif
+
   /**
    * Returns the value of the "id" attribute of this GraphicalObject.
    *
@@ -80,6 +80,14 @@ ReactionGlyph::renameSIdRefs(const std::string& oldid, const std::string& newid)
 }
 
 
+void
+ReactionGlyph::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  GraphicalObject::renameSIdRefs(renames);
+  renameIdRef(mReaction, renames);
+}
+
+
 /*
  * Creates a new ReactionGlyph.  The list of species reference glyph is
  * empty and the id of the associated reaction is set to the empty string.
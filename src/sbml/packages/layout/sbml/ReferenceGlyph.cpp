@@ -79,6 +79,15 @@ ReferenceGlyph::renameSIdRefs(const std::string& oldid, const std::string& newid
   }
 }
 
+
+void
+ReferenceGlyph::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  GraphicalObject::renameSIdRefs(renames);
+  renameIdRef(mReference, renames);
+  renameIdRef(mGlyph, renames);
+}
+
 /*
  * Creates a new ReferenceGlyph.  The id if the associated 
  * reference and the id of the associated glyph are set to the
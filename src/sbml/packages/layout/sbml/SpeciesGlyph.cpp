@@ -60,6 +60,14 @@ SpeciesGlyph::renameSIdRefs(const std::string& oldid, const std::string& newid)
   }
 }
 
+
+void
+SpeciesGlyph::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  GraphicalObject::renameSIdRefs(renames);
+  renameIdRef(mSpecies, renames);
+}
+
 /*
  * Creates a new SpeciesGlyph with the given SBML level, version, and package version
  * and the id of the associated species set to the empty string.
@@ -93,6 +93,15 @@ SpeciesReferenceGlyph::renameSIdRefs(const std::string& oldid, const std::string
   }
 }
 
+
+void
+SpeciesReferenceGlyph::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  GraphicalObject::renameSIdRefs(renames);
+  renameIdRef(mSpeciesReference, renames);
+  renameIdRef(mSpeciesGlyph, renames);
+}
+
 /*
  * Creates a new SpeciesReferenceGlyph.  The id if the associated species
  * reference and the id of the associated species glyph are set to the
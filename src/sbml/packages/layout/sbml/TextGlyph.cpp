@@ -65,6 +65,15 @@ TextGlyph::renameSIdRefs(const std::string& oldid, const std::string& newid)
   }
 }
 
+
+void
+TextGlyph::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  GraphicalObject::renameSIdRefs(renames);
+  renameIdRef(mGraphicalObject, renames);
+  renameIdRef(mOriginOfText, renames);
+}
+
 /*
  * Creates a new TextGlyph the ids of the associated GraphicalObject and
  * the originOfText are set to the empty string. The actual text is set to
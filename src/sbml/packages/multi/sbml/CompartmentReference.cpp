@@ -293,6 +293,16 @@ CompartmentReference::renameSIdRefs(const std::string& oldid, const std::string&
 }
 
 
+/*
+ * rename attributes that are SIdRefs or instances in math
+ */
+void
+CompartmentReference::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mCompartment);
+}
+
+
 /*
  * Returns the XML element name of this object
  */
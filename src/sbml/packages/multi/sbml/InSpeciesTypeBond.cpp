@@ -359,6 +359,16 @@ InSpeciesTypeBond::renameSIdRefs(const std::string& oldid, const std::string& ne
 }
 
 
+/*
+ * rename attributes that are SIdRefs or instances in math
+ */
+void
+InSpeciesTypeBond::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mBindingSite1, mBindingSite2);
+}
+
+
 /*
  * Returns the XML element name of this object
  */
@@ -959,6 +959,16 @@ MultiSpeciesType::renameSIdRefs(const std::string& oldid, const std::string& new
 }
 
 
+/*
+ * rename attributes that are SIdRefs or instances in math
+ */
+void
+MultiSpeciesType::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mCompartment);
+}
+
+
 List*
 MultiSpeciesType::getAllElements(ElementFilter* filter)
 {
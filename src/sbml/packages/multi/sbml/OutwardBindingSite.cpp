@@ -365,6 +365,16 @@ OutwardBindingSite::renameSIdRefs(const std::string& oldid, const std::string& n
 }
 
 
+/*
+ * rename attributes that are SIdRefs or instances in math
+ */
+void
+OutwardBindingSite::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mComponent);
+}
+
+
 /*
  * Returns the XML element name of this object
  */
@@ -293,6 +293,16 @@ PossibleSpeciesFeatureValue::renameSIdRefs(const std::string& oldid, const std::
 }
 
 
+/*
+ * rename attributes that are SIdRefs or instances in math
+ */
+void
+PossibleSpeciesFeatureValue::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mNumericValue);
+}
+
+
 /*
  * Returns the XML element name of this object
  */
@@ -588,6 +588,16 @@ SpeciesFeature::renameSIdRefs(const std::string& oldid, const std::string& newid
 }
 
 
+/*
+ * rename attributes that are SIdRefs or instances in math
+ */
+void
+SpeciesFeature::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mSpeciesFeatureType, mComponent);
+}
+
+
 List*
 SpeciesFeature::getAllElements(ElementFilter* filter)
 {
@@ -186,6 +186,16 @@ SpeciesFeatureValue::renameSIdRefs(const std::string& oldid, const std::string&
 }
 
 
+/*
+ * rename attributes that are SIdRefs or instances in math
+ */
+void
+SpeciesFeatureValue::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mValue);
+}
+
+
 /*
  * Returns the XML element name of this object
  */
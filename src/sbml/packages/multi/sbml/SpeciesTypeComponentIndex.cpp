@@ -356,6 +356,16 @@ SpeciesTypeComponentIndex::renameSIdRefs(const std::string& oldid, const std::st
 }
 
 
+/*
+ * rename attributes that are SIdRefs or instances in math
+ */
+void
+SpeciesTypeComponentIndex::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mComponent, mIdentifyingParent);
+}
+
+
 /*
  * Returns the XML element name of this object
  */
@@ -419,6 +419,16 @@ SpeciesTypeComponentMapInProduct::renameSIdRefs(const std::string& oldid, const
 }
 
 
+/*
+ * rename attributes that are SIdRefs or instances in math
+ */
+void
+SpeciesTypeComponentMapInProduct::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mReactant, mReactantComponent, mProductComponent);
+}
+
+
 
 /*
  * Returns the XML element name of this object
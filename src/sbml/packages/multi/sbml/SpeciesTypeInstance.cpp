@@ -359,6 +359,16 @@ SpeciesTypeInstance::renameSIdRefs(const std::string& oldid, const std::string&
 }
 
 
+/*
+ * rename attributes that are SIdRefs or instances in math
+ */
+void
+SpeciesTypeInstance::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mSpeciesType, mCompartmentReference);
+}
+
+
 /*
  * Returns the XML element name of this object
  */
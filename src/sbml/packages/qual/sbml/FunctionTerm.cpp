@@ -281,6 +281,16 @@ FunctionTerm::renameSIdRefs(const std::string& oldid, const std::string& newid)
 }
 
 
+/*
+ * rename attributes that are SIdRefs or instances in math
+ */
+void
+FunctionTerm::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mMath);
+}
+
+
 /*
  * Returns the XML element name of this object
  */
@@ -469,6 +469,16 @@ Input::renameSIdRefs(const std::string& oldid, const std::string& newid)
 }
 
 
+/*
+ * rename attributes that are SIdRefs or instances in math
+ */
+void
+Input::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mQualitativeSpecies);
+}
+
+
 /*
  * Returns the XML element name of this object
  */
@@ -474,6 +474,16 @@ QualitativeSpecies::renameSIdRefs(const std::string& oldid, const std::string& n
 }
 
 
+/*
+ * rename attributes that are SIdRefs or instances in math
+ */
+void
+QualitativeSpecies::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mCompartment);
+}
+
+
 /*
  * Returns the XML element name of this object
  */
@@ -1996,6 +1996,16 @@ DefaultValues::renameSIdRefs(const std::string& oldid,
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+DefaultValues::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mStartHead, mEndHead);
+}
+
+
 /*
  * Returns the XML element name of this DefaultValues object.
  */
@@ -1517,7 +1517,9 @@ void GradientBase::addGradientAttributesAndChildren(const GradientBase& gradient
             att.add("spreadMethod","repeat");
             break;
     }
-    // add the notes and annotations
+    // add the notes and annotations, which may not have been parsed yet
+    gradient.loadDeferredNotes();
+    gradient.loadDeferredAnnotation();
     if(gradient.mNotes)
     {
         node.addChild(*gradient.mNotes);
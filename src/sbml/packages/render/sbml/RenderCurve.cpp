@@ -549,6 +549,16 @@ RenderCurve::renameSIdRefs(const std::string& oldid, const std::string& newid)
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+RenderCurve::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mStartHead, mEndHead);
+}
+
+
 /*
  * Returns the XML element name of this RenderCurve object.
  */
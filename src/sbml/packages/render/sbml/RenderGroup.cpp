@@ -1369,6 +1369,16 @@ RenderGroup::renameSIdRefs(const std::string& oldid, const std::string& newid)
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+RenderGroup::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mStartHead, mEndHead);
+}
+
+
 /*
  * Returns the XML element name of this RenderGroup object.
  */
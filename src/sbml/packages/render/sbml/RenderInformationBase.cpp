@@ -1163,6 +1163,16 @@ RenderInformationBase::renameSIdRefs(const std::string& oldid,
   }
 }
 
+
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+RenderInformationBase::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  SBase::renameSIdRefs(renames, mReferenceRenderInformation);
+}
+
 // render FIX ME
 /*
  * Returns the XML element name of this RenderInformationBase object.
@@ -1250,6 +1250,14 @@ public:
   virtual void renameSIdRefs(const std::string& oldid,
                              const std::string& newid);
 
+
+#ifndef SWIG
+  /**
+   * @copydoc SBase::renameSIdRefs(const std::map<std::string, std::string>& renames)
+   */
+  virtual void renameSIdRefs(const std::map<std::string, std::string>& renames);
+#endif
+
 // render FIX ME
   /**
    * Returns the XML element name of this RenderInformationBase object.
@@ -105,6 +105,7 @@ Suite *create_suite_GlobalRenderInformation (void);
 Suite *create_suite_LocalRenderInformation  (void);
 Suite *create_suite_RenderReading           (void);
 Suite *create_suite_RenderWriting           (void);
+Suite *create_suite_StyleResolver           (void);
 
 
 /*
@@ -170,6 +171,7 @@ main (void)
   srunner_add_suite( runner, create_suite_LocalRenderInformation  () );
   srunner_add_suite( runner, create_suite_RenderReading           () );
   srunner_add_suite( runner, create_suite_RenderWriting           () );
+  srunner_add_suite( runner, create_suite_StyleResolver           () );
 
   setTestDataDirectory();
 
@@ -0,0 +1,304 @@
+/**
+ * \file    TestStyleResolver.cpp
+ * \brief   Implementation of the Tests for the StyleResolver
+ * \author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sbml/common/common.h>
+#include <sbml/SBMLTypes.h>
+
+#include <sbml/packages/layout/common/LayoutExtensionTypes.h>
+#include <sbml/packages/render/common/RenderExtensionTypes.h>
+#include <sbml/packages/render/util/StyleResolver.h>
+
+#include <check.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+LIBSBML_CPP_NAMESPACE_USE
+
+BEGIN_C_DECLS
+
+static SBMLDocument* D;
+static Layout* L;
+static GlobalRenderInformation* G;
+static LocalRenderInformation* R;
+
+
+static void
+addColor(RenderInformationBase* info, const char* id, const char* value)
+{
+  ColorDefinition* color = info->createColorDefinition();
+  color->setId(id);
+  color->setValue(value);
+}
+
+
+/*
+ * Creates a layout with one glyph of each kind, global render information
+ * with styles by type and role, and local render information that refers
+ * to it with styles by id and type.
+ */
+void
+StyleResolverTest_setup (void)
+{
+  SBMLNamespaces sbmlns(3, 1, "layout", 1);
+  sbmlns.addPackageNamespace("render", 1);
+  D = new SBMLDocument(&sbmlns);
+  Model* model = D->createModel();
+
+  LayoutModelPlugin* plugin =
+    static_cast<LayoutModelPlugin*>(model->getPlugin("layout"));
+  L = plugin->createLayout();
+  L->setId("layout");
+
+  L->createCompartmentGlyph()->setId("cg");
+  L->createSpeciesGlyph()->setId("sg1");
+  SpeciesGlyph* sg2 = L->createSpeciesGlyph();
+  sg2->setId("sg2");
+  ReactionGlyph* rg = L->createReactionGlyph();
+  rg->setId("rg");
+  SpeciesReferenceGlyph* srg = rg->createSpeciesReferenceGlyph();
+  srg->setId("srg");
+  srg->setRole(SPECIES_ROLE_PRODUCT);
+  L->createTextGlyph()->setId("tg");
+  GeneralGlyph* gg = L->createGeneralGlyph();
+  gg->setId("gg");
+  ReferenceGlyph* ref = gg->createReferenceGlyph();
+  ref->setId("ref");
+  ref->setRole("activator");
+
+  static_cast<RenderGraphicalObjectPlugin*>(L->getSpeciesGlyph(1)
+    ->getPlugin("render"))->setObjectRole("highlight");
+
+  RenderListOfLayoutsPlugin* lolPlugin = static_cast<RenderListOfLayoutsPlugin*>(
+    plugin->getListOfLayouts()->getPlugin("render"));
+  G = lolPlugin->createGlobalRenderInformation();
+  G->setId("global");
+  addColor(G, "black", "#000000");
+  addColor(G, "white", "#ffffff");
+  addColor(G, "red", "#ff0000");
+
+  LinearGradient* gradient = G->createLinearGradientDefinition();
+  gradient->setId("grad");
+  gradient->createGradientStop()->setStopColor("black");
+  gradient->createGradientStop()->setStopColor("white");
+
+  LineEnding* arrow = G->createLineEnding();
+  arrow->setId("arrow");
+  arrow->getGroup()->setFill("red");
+
+  GlobalStyle* style = G->createGlobalStyle();
+  style->setId("gsSpecies");
+  style->addType("SPECIESGLYPH");
+  style->getGroup()->setFill("grad");
+
+  style = G->createGlobalStyle();
+  style->setId("gsAny");
+  style->addType("ANY");
+  style->addType("REACTIONGLYPH");
+  style->getGroup()->setStroke("black");
+
+  style = G->createGlobalStyle();
+  style->setId("gsProduct");
+  style->addRole("product");
+  style->addRole("highlight");
+  style->getGroup()->setEndHead("arrow");
+
+  RenderLayoutPlugin* layoutPlugin =
+    static_cast<RenderLayoutPlugin*>(L->getPlugin("render"));
+  R = layoutPlugin->createLocalRenderInformation();
+  R->setId("local");
+  R->setReferenceRenderInformation("global");
+  // overrides the global color
+  addColor(R, "black", "#101010");
+
+  LocalStyle* local = R->createLocalStyle();
+  local->setId("lsSg1");
+  local->addId("sg1");
+  local->getGroup()->setFill("white");
+
+  local = R->createLocalStyle();
+  local->setId("lsCompartment");
+  local->addType("COMPARTMENTGLYPH");
+  Rectangle* rect = local->getGroup()->createRectangle();
+  rect->setStroke("black");
+  rect->setFill("grad");
+}
+
+
+void
+StyleResolverTest_teardown (void)
+{
+  delete D;
+}
+
+
+START_TEST (test_StyleResolver_chain)
+{
+  StyleResolver resolver(R);
+  fail_unless(resolver.getNumRenderInformation() == 2);
+  fail_unless(resolver.getRenderInformation() == R);
+  fail_unless(resolver.getRenderInformation(1) == G);
+  fail_unless(resolver.getRenderInformation(2) == NULL);
+
+  // the first render information to define an id wins
+  fail_unless(resolver.getColorDefinition("black") == R->getColorDefinition(0));
+  fail_unless(resolver.getColorDefinition("white") == G->getColorDefinition(1));
+  fail_unless(resolver.getColorDefinition("blue") == NULL);
+  fail_unless(resolver.getGradientDefinition("grad") != NULL);
+  fail_unless(resolver.getLineEnding("arrow") != NULL);
+
+  // the layout uses its local render information
+  StyleResolver byLayout(L);
+  fail_unless(byLayout.getRenderInformation() == R);
+
+  StyleResolver global(G);
+  fail_unless(global.getNumRenderInformation() == 1);
+
+  // render information that refers to itself
+  G->setReferenceRenderInformation("global");
+  StyleResolver cycle(G);
+  fail_unless(cycle.getNumRenderInformation() == 1);
+
+  StyleResolver none((const RenderInformationBase*)(NULL));
+  fail_unless(none.getNumRenderInformation() == 0);
+  fail_unless(none.getStyle(L->getSpeciesGlyph(0)) == NULL);
+}
+END_TEST
+
+
+START_TEST (test_StyleResolver_getStyle)
+{
+  StyleResolver resolver(R);
+
+  // by id in the local render information
+  fail_unless(resolver.getStyle(L->getSpeciesGlyph(0)) == R->getStyle(0));
+  // by type in the local render information
+  fail_unless(resolver.getStyle(L->getCompartmentGlyph(0)) == R->getStyle(1));
+  // by role, before the type, in the global render information
+  fail_unless(resolver.getStyle(L->getSpeciesGlyph(1)) == G->getStyle(2));
+  fail_unless(resolver.getStyle(L->getReactionGlyph(0)
+    ->getSpeciesReferenceGlyph(0)) == G->getStyle(2));
+  // the first of the styles for the type and for any type
+  fail_unless(resolver.getStyle(L->getReactionGlyph(0)) == G->getStyle(1));
+  fail_unless(resolver.getStyle(L->getTextGlyph(0)) == G->getStyle(1));
+  fail_unless(resolver.getStyle(NULL) == NULL);
+
+  // without the local render information
+  StyleResolver global(G);
+  fail_unless(global.getStyle(L->getSpeciesGlyph(0)) == G->getStyle(0));
+  fail_unless(global.getStyle(L->getCompartmentGlyph(0)) == G->getStyle(1));
+
+  fail_unless(StyleResolver::getType(L->getSpeciesGlyph(0)) == "SPECIESGLYPH");
+  fail_unless(StyleResolver::getType(L->getAdditionalGraphicalObject(0))
+    == "GENERALGLYPH");
+  fail_unless(StyleResolver::getRole(L->getSpeciesGlyph(0)) == "");
+  fail_unless(StyleResolver::getRole(L->getSpeciesGlyph(1)) == "highlight");
+}
+END_TEST
+
+
+START_TEST (test_StyleResolver_resolve)
+{
+  StyleResolver resolver(R);
+
+  ResolvedStyle resolved = resolver.resolve(L->getCompartmentGlyph(0));
+  fail_unless(resolved.isValid());
+  fail_unless(resolved.getGraphicalObject() == L->getCompartmentGlyph(0));
+  fail_unless(resolved.getStyle() == R->getStyle(1));
+  fail_unless(resolved.getRenderInformation() == R);
+  // black from the rectangle, then white from the stops of the gradient
+  fail_unless(resolved.getNumColorDefinitions() == 2);
+  fail_unless(resolved.getColorDefinition(0) == R->getColorDefinition(0));
+  fail_unless(resolved.getColorDefinition("white") == G->getColorDefinition(1));
+  fail_unless(resolved.getColorDefinition(2) == NULL);
+  fail_unless(resolved.getNumGradientDefinitions() == 1);
+  fail_unless(resolved.getGradientDefinition("grad")
+    == G->getGradientDefinition(0));
+  fail_unless(resolved.getNumLineEndings() == 0);
+
+  // the line ending and the color of its group
+  resolved = resolver.resolve(L->getReactionGlyph(0)
+    ->getSpeciesReferenceGlyph(0));
+  fail_unless(resolved.getRenderInformation() == G);
+  fail_unless(resolved.getNumLineEndings() == 1);
+  fail_unless(resolved.getLineEnding(0) == G->getLineEnding(0));
+  fail_unless(resolved.getLineEnding("arrow") == G->getLineEnding(0));
+  fail_unless(resolved.getNumColorDefinitions() == 1);
+  fail_unless(resolved.getColorDefinition("red") == G->getColorDefinition(2));
+
+  resolved = resolver.resolve(NULL);
+  fail_unless(resolved.isValid() == false);
+  fail_unless(resolved.getStyle() == NULL);
+  fail_unless(resolved.getNumColorDefinitions() == 0);
+}
+END_TEST
+
+
+START_TEST (test_StyleResolver_resolveAll)
+{
+  StyleResolver resolver(L);
+
+  vector<ResolvedStyle> styles = resolver.resolveAll(L);
+  fail_unless(styles.size() == 8);
+
+  const char* ids[] = { "cg", "sg1", "sg2", "rg", "srg", "tg", "gg", "ref" };
+  for (unsigned int i = 0; i < styles.size(); ++i)
+  {
+    fail_unless(styles[i].getGraphicalObject()->getId() == ids[i]);
+    fail_unless(styles[i].isValid());
+    fail_unless(styles[i].getStyle()
+      == resolver.getStyle(styles[i].getGraphicalObject()));
+  }
+
+  // the role of a reference glyph
+  fail_unless(styles[7].getStyle() == G->getStyle(1));
+  G->getStyle(2)->addRole("activator");
+  StyleResolver updated(L);
+  fail_unless(updated.getStyle(styles[7].getGraphicalObject())
+    == G->getStyle(2));
+
+  fail_unless(resolver.resolveAll(NULL).empty());
+}
+END_TEST
+
+
+Suite *
+create_suite_StyleResolver (void)
+{
+  Suite *suite = suite_create("StyleResolver");
+  TCase *tcase = tcase_create("StyleResolver");
+
+  tcase_add_checked_fixture( tcase,
+                             StyleResolverTest_setup,
+                             StyleResolverTest_teardown );
+
+  tcase_add_test( tcase, test_StyleResolver_chain      );
+  tcase_add_test( tcase, test_StyleResolver_getStyle   );
+  tcase_add_test( tcase, test_StyleResolver_resolve    );
+  tcase_add_test( tcase, test_StyleResolver_resolveAll );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+END_C_DECLS
@@ -0,0 +1,776 @@
+/**
+ * @file    StyleResolver.cpp
+ * @brief   Implementation of StyleResolver and ResolvedStyle, which find the
+ *          style that render information gives each graphical object.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ */
+
+#include <sbml/packages/render/util/StyleResolver.h>
+
+#include <sbml/packages/render/common/RenderExtensionTypes.h>
+#include <sbml/packages/render/extension/RenderGraphicalObjectPlugin.h>
+#include <sbml/packages/render/extension/RenderLayoutPlugin.h>
+#include <sbml/packages/render/extension/RenderListOfLayoutsPlugin.h>
+#include <sbml/packages/layout/common/LayoutExtensionTypes.h>
+
+#ifdef __cplusplus
+
+#include <algorithm>
+#include <set>
+
+using namespace std;
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+/** @cond doxygenLibsbmlInternal */
+
+/*
+ * Returns the closest ancestor of the element of the given class.
+ */
+template <class T>
+static const T*
+getAncestor(const SBase* element)
+{
+  while (element != NULL)
+  {
+    const T* ancestor = dynamic_cast<const T*>(element);
+    if (ancestor != NULL)
+    {
+      return ancestor;
+    }
+    element = element->getParentSBMLObject();
+  }
+  return NULL;
+}
+
+
+static const RenderListOfLayoutsPlugin*
+getListOfLayoutsPlugin(const SBase* element)
+{
+  const ListOfLayouts* layouts = getAncestor<ListOfLayouts>(element);
+  if (layouts == NULL)
+  {
+    return NULL;
+  }
+  return dynamic_cast<const RenderListOfLayoutsPlugin*>(
+    layouts->getPlugin("render"));
+}
+
+
+static const RenderLayoutPlugin*
+getLayoutPlugin(const SBase* element)
+{
+  const Layout* layout = getAncestor<Layout>(element);
+  if (layout == NULL)
+  {
+    return NULL;
+  }
+  return dynamic_cast<const RenderLayoutPlugin*>(layout->getPlugin("render"));
+}
+
+
+/*
+ * Returns the render information that the given one refers to: a local
+ * one may refer to another of its layout or to a global one, a global one
+ * to another global one only.
+ */
+static const RenderInformationBase*
+getReferenced(const RenderInformationBase* info)
+{
+  if (!info->isSetReferenceRenderInformation())
+  {
+    return NULL;
+  }
+  const string& id = info->getReferenceRenderInformation();
+
+  if (dynamic_cast<const LocalRenderInformation*>(info) != NULL)
+  {
+    const RenderLayoutPlugin* plugin = getLayoutPlugin(info);
+    if (plugin != NULL && plugin->getRenderInformation(id) != NULL)
+    {
+      return plugin->getRenderInformation(id);
+    }
+  }
+
+  const RenderListOfLayoutsPlugin* plugin = getListOfLayoutsPlugin(info);
+  if (plugin != NULL)
+  {
+    return plugin->getRenderInformation(id);
+  }
+  return NULL;
+}
+
+
+/*
+ * The styles of a render information, local or global.
+ */
+static unsigned int
+getNumStyles(const RenderInformationBase* info)
+{
+  const LocalRenderInformation* local =
+    dynamic_cast<const LocalRenderInformation*>(info);
+  if (local != NULL)
+  {
+    return local->getNumStyles();
+  }
+  const GlobalRenderInformation* global =
+    dynamic_cast<const GlobalRenderInformation*>(info);
+  return (global != NULL) ? global->getNumStyles() : 0;
+}
+
+
+static const Style*
+getNthStyle(const RenderInformationBase* info, unsigned int n)
+{
+  const LocalRenderInformation* local =
+    dynamic_cast<const LocalRenderInformation*>(info);
+  if (local != NULL)
+  {
+    return local->getStyle(n);
+  }
+  return static_cast<const GlobalRenderInformation*>(info)->getStyle(n);
+}
+
+
+/*
+ * Adds the style to the index under the key, unless an earlier one is
+ * there already.
+ */
+static void
+addEntry(map<string, pair<unsigned int, const Style*> >& index,
+         const string& key, unsigned int position, const Style* style)
+{
+  index.insert(make_pair(key, make_pair(position, style)));
+}
+
+
+static const pair<unsigned int, const Style*>*
+findEntry(const map<string, pair<unsigned int, const Style*> >& index,
+          const string& key)
+{
+  map<string, pair<unsigned int, const Style*> >::const_iterator it =
+    index.find(key);
+  if (it == index.end())
+  {
+    return NULL;
+  }
+  return &(it->second);
+}
+
+
+template <class T>
+static void
+addUnique(vector<const T*>& items, const T* item)
+{
+  if (find(items.begin(), items.end(), item) == items.end())
+  {
+    items.push_back(item);
+  }
+}
+
+
+template <class T>
+static const T*
+findById(const vector<const T*>& items, const string& id)
+{
+  for (size_t i = 0; i < items.size(); ++i)
+  {
+    if (items[i]->getId() == id)
+    {
+      return items[i];
+    }
+  }
+  return NULL;
+}
+
+/** @endcond */
+
+
+ResolvedStyle::ResolvedStyle()
+  : mObject(NULL)
+  , mStyle(NULL)
+  , mRenderInformation(NULL)
+{
+}
+
+
+ResolvedStyle::~ResolvedStyle()
+{
+}
+
+
+bool
+ResolvedStyle::isValid() const
+{
+  return mStyle != NULL;
+}
+
+
+const GraphicalObject*
+ResolvedStyle::getGraphicalObject() const
+{
+  return mObject;
+}
+
+
+const Style*
+ResolvedStyle::getStyle() const
+{
+  return mStyle;
+}
+
+
+const RenderInformationBase*
+ResolvedStyle::getRenderInformation() const
+{
+  return mRenderInformation;
+}
+
+
+unsigned int
+ResolvedStyle::getNumColorDefinitions() const
+{
+  return (unsigned int)(mColors.size());
+}
+
+
+const ColorDefinition*
+ResolvedStyle::getColorDefinition(unsigned int n) const
+{
+  return (n < mColors.size()) ? mColors[n] : NULL;
+}
+
+
+const ColorDefinition*
+ResolvedStyle::getColorDefinition(const std::string& id) const
+{
+  return findById(mColors, id);
+}
+
+
+unsigned int
+ResolvedStyle::getNumGradientDefinitions() const
+{
+  return (unsigned int)(mGradients.size());
+}
+
+
+const GradientBase*
+ResolvedStyle::getGradientDefinition(unsigned int n) const
+{
+  return (n < mGradients.size()) ? mGradients[n] : NULL;
+}
+
+
+const GradientBase*
+ResolvedStyle::getGradientDefinition(const std::string& id) const
+{
+  return findById(mGradients, id);
+}
+
+
+unsigned int
+ResolvedStyle::getNumLineEndings() const
+{
+  return (unsigned int)(mLineEndings.size());
+}
+
+
+const LineEnding*
+ResolvedStyle::getLineEnding(unsigned int n) const
+{
+  return (n < mLineEndings.size()) ? mLineEndings[n] : NULL;
+}
+
+
+const LineEnding*
+ResolvedStyle::getLineEnding(const std::string& id) const
+{
+  return findById(mLineEndings, id);
+}
+
+
+StyleResolver::StyleResolver(const RenderInformationBase* renderInformation)
+{
+  addChain(renderInformation);
+}
+
+
+StyleResolver::StyleResolver(const Layout* layout)
+{
+  if (layout == NULL)
+  {
+    return;
+  }
+
+  const RenderLayoutPlugin* plugin =
+    dynamic_cast<const RenderLayoutPlugin*>(layout->getPlugin("render"));
+  if (plugin != NULL && plugin->getNumLocalRenderInformationObjects() > 0)
+  {
+    addChain(plugin->getRenderInformation(0));
+    return;
+  }
+
+  const RenderListOfLayoutsPlugin* global = getListOfLayoutsPlugin(layout);
+  if (global != NULL && global->getNumGlobalRenderInformationObjects() > 0)
+  {
+    addChain(global->getRenderInformation(0));
+  }
+}
+
+
+StyleResolver::~StyleResolver()
+{
+}
+
+
+unsigned int
+StyleResolver::getNumRenderInformation() const
+{
+  return (unsigned int)(mLevels.size());
+}
+
+
+const RenderInformationBase*
+StyleResolver::getRenderInformation(unsigned int n) const
+{
+  return (n < mLevels.size()) ? mLevels[n].info : NULL;
+}
+
+
+const Style*
+StyleResolver::getStyle(const GraphicalObject* object) const
+{
+  if (object == NULL)
+  {
+    return NULL;
+  }
+
+  const string& id = object->getId();
+  string role = getRole(object);
+  string type = getType(object);
+
+  for (size_t i = 0; i < mLevels.size(); ++i)
+  {
+    const Level& level = mLevels[i];
+
+    const Entry* entry = id.empty() ? NULL : findEntry(level.ids, id);
+    if (entry != NULL)
+    {
+      return entry->second;
+    }
+
+    entry = role.empty() ? NULL : findEntry(level.roles, role);
+    if (entry != NULL)
+    {
+      return entry->second;
+    }
+
+    // the first style for the type or for any type
+    entry = findEntry(level.types, type);
+    const Entry* any = findEntry(level.types, "ANY");
+    if (entry == NULL || (any != NULL && any->first < entry->first))
+    {
+      entry = any;
+    }
+    if (entry != NULL)
+    {
+      return entry->second;
+    }
+  }
+
+  return NULL;
+}
+
+
+ResolvedStyle
+StyleResolver::resolve(const GraphicalObject* object) const
+{
+  ResolvedStyle resolved;
+
+  const Style* style = getStyle(object);
+  if (style != NULL)
+  {
+    map<const Style*, ResolvedStyle>::const_iterator it =
+      mResolved.find(style);
+    if (it != mResolved.end())
+    {
+      resolved = it->second;
+    }
+  }
+
+  resolved.mObject = object;
+  return resolved;
+}
+
+
+std::vector<ResolvedStyle>
+StyleResolver::resolveAll(const Layout* layout) const
+{
+  vector<ResolvedStyle> styles;
+  if (layout == NULL)
+  {
+    return styles;
+  }
+
+  vector<const GraphicalObject*> objects;
+  for (unsigned int i = 0; i < layout->getNumCompartmentGlyphs(); ++i)
+  {
+    objects.push_back(layout->getCompartmentGlyph(i));
+  }
+  for (unsigned int i = 0; i < layout->getNumSpeciesGlyphs(); ++i)
+  {
+    objects.push_back(layout->getSpeciesGlyph(i));
+  }
+  for (unsigned int i = 0; i < layout->getNumReactionGlyphs(); ++i)
+  {
+    objects.push_back(layout->getReactionGlyph(i));
+  }
+  for (unsigned int i = 0; i < layout->getNumTextGlyphs(); ++i)
+  {
+    objects.push_back(layout->getTextGlyph(i));
+  }
+  for (unsigned int i = 0; i < layout->getNumAdditionalGraphicalObjects(); ++i)
+  {
+    objects.push_back(layout->getAdditionalGraphicalObject(i));
+  }
+
+  styles.reserve(objects.size());
+
+  // the glyphs within a glyph follow it; subglyphs may nest
+  vector<const GraphicalObject*> stack(objects.rbegin(), objects.rend());
+  while (!stack.empty())
+  {
+    const GraphicalObject* object = stack.back();
+    stack.pop_back();
+    styles.push_back(resolve(object));
+
+    const ReactionGlyph* reaction =
+      dynamic_cast<const ReactionGlyph*>(object);
+    if (reaction != NULL)
+    {
+      for (unsigned int i = reaction->getNumSpeciesReferenceGlyphs(); i > 0; --i)
+      {
+        stack.push_back(reaction->getSpeciesReferenceGlyph(i - 1));
+      }
+      continue;
+    }
+
+    const GeneralGlyph* general = dynamic_cast<const GeneralGlyph*>(object);
+    if (general != NULL)
+    {
+      for (unsigned int i = general->getNumSubGlyphs(); i > 0; --i)
+      {
+        stack.push_back(general->getSubGlyph(i - 1));
+      }
+      for (unsigned int i = general->getNumReferenceGlyphs(); i > 0; --i)
+      {
+        stack.push_back(general->getReferenceGlyph(i - 1));
+      }
+    }
+  }
+
+  return styles;
+}
+
+
+const ColorDefinition*
+StyleResolver::getColorDefinition(const std::string& id) const
+{
+  map<string, const ColorDefinition*>::const_iterator it = mColors.find(id);
+  return (it == mColors.end()) ? NULL : it->second;
+}
+
+
+const GradientBase*
+StyleResolver::getGradientDefinition(const std::string& id) const
+{
+  map<string, const GradientBase*>::const_iterator it = mGradients.find(id);
+  return (it == mGradients.end()) ? NULL : it->second;
+}
+
+
+const LineEnding*
+StyleResolver::getLineEnding(const std::string& id) const
+{
+  map<string, const LineEnding*>::const_iterator it = mLineEndings.find(id);
+  return (it == mLineEndings.end()) ? NULL : it->second;
+}
+
+
+std::string
+StyleResolver::getType(const GraphicalObject* object)
+{
+  if (object == NULL)
+  {
+    return "";
+  }
+
+  switch (object->getTypeCode())
+  {
+  case SBML_LAYOUT_COMPARTMENTGLYPH:
+    return "COMPARTMENTGLYPH";
+  case SBML_LAYOUT_SPECIESGLYPH:
+    return "SPECIESGLYPH";
+  case SBML_LAYOUT_REACTIONGLYPH:
+    return "REACTIONGLYPH";
+  case SBML_LAYOUT_SPECIESREFERENCEGLYPH:
+    return "SPECIESREFERENCEGLYPH";
+  case SBML_LAYOUT_TEXTGLYPH:
+    return "TEXTGLYPH";
+  case SBML_LAYOUT_GENERALGLYPH:
+    return "GENERALGLYPH";
+  case SBML_LAYOUT_REFERENCEGLYPH:
+    return "REFERENCEGLYPH";
+  default:
+    return "GRAPHICALOBJECT";
+  }
+}
+
+
+std::string
+StyleResolver::getRole(const GraphicalObject* object)
+{
+  if (object == NULL)
+  {
+    return "";
+  }
+
+  const RenderGraphicalObjectPlugin* plugin =
+    dynamic_cast<const RenderGraphicalObjectPlugin*>(
+      object->getPlugin("render"));
+  if (plugin != NULL && plugin->isSetObjectRole())
+  {
+    return plugin->getObjectRole();
+  }
+
+  const SpeciesReferenceGlyph* srg =
+    dynamic_cast<const SpeciesReferenceGlyph*>(object);
+  if (srg != NULL && srg->isSetRole())
+  {
+    return srg->getRoleString();
+  }
+
+  const ReferenceGlyph* rg = dynamic_cast<const ReferenceGlyph*>(object);
+  if (rg != NULL && rg->isSetRole())
+  {
+    return rg->getRole();
+  }
+
+  return "";
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+
+/*
+ * Indexes the render information and each one it refers to in turn, and
+ * resolves the definitions each of their styles uses.
+ */
+void
+StyleResolver::addChain(const RenderInformationBase* renderInformation)
+{
+  set<const RenderInformationBase*> visited;
+  const RenderInformationBase* info = renderInformation;
+  while (info != NULL && visited.insert(info).second)
+  {
+    mLevels.push_back(Level());
+    mLevels.back().info = info;
+    indexStyles(mLevels.back());
+
+    // the first in the chain to define an id wins
+    for (unsigned int i = 0; i < info->getNumColorDefinitions(); ++i)
+    {
+      const ColorDefinition* color = info->getColorDefinition(i);
+      mColors.insert(make_pair(color->getId(), color));
+    }
+    for (unsigned int i = 0; i < info->getNumGradientDefinitions(); ++i)
+    {
+      const GradientBase* gradient = info->getGradientDefinition(i);
+      mGradients.insert(make_pair(gradient->getId(), gradient));
+    }
+    for (unsigned int i = 0; i < info->getNumLineEndings(); ++i)
+    {
+      const LineEnding* ending = info->getLineEnding(i);
+      mLineEndings.insert(make_pair(ending->getId(), ending));
+    }
+
+    info = getReferenced(info);
+  }
+
+  for (size_t n = 0; n < mLevels.size(); ++n)
+  {
+    const RenderInformationBase* info = mLevels[n].info;
+    for (unsigned int i = 0; i < getNumStyles(info); ++i)
+    {
+      const Style* style = getNthStyle(info, i);
+      ResolvedStyle& resolved = mResolved[style];
+      resolved.mStyle = style;
+      resolved.mRenderInformation = info;
+      collectDefinitions(style, resolved);
+    }
+  }
+}
+
+
+void
+StyleResolver::indexStyles(Level& level)
+{
+  for (unsigned int i = 0; i < getNumStyles(level.info); ++i)
+  {
+    const Style* style = getNthStyle(level.info, i);
+
+    const LocalStyle* localStyle = dynamic_cast<const LocalStyle*>(style);
+    if (localStyle != NULL)
+    {
+      const set<string>& ids = localStyle->getIdList();
+      for (set<string>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+      {
+        addEntry(level.ids, *it, i, style);
+      }
+    }
+
+    const set<string>& roles = style->getRoleList();
+    for (set<string>::const_iterator it = roles.begin(); it != roles.end(); ++it)
+    {
+      addEntry(level.roles, *it, i, style);
+    }
+
+    const set<string>& types = style->getTypeList();
+    for (set<string>::const_iterator it = types.begin(); it != types.end(); ++it)
+    {
+      addEntry(level.types, *it, i, style);
+    }
+  }
+}
+
+
+/*
+ * Collects the definitions that the group of the style uses, and those
+ * its gradients and line endings use in turn.
+ */
+void
+StyleResolver::collectDefinitions(const Style* style,
+                                  ResolvedStyle& resolved) const
+{
+  vector<const RenderGroup*> groups;
+  groups.push_back(style->getGroup());
+
+  while (!groups.empty())
+  {
+    const RenderGroup* group = groups.back();
+    groups.pop_back();
+    if (group == NULL)
+    {
+      continue;
+    }
+
+    collectReference(group->getStroke(), resolved, groups);
+    collectReference(group->getFill(), resolved, groups);
+    collectReference(group->getStartHead(), resolved, groups);
+    collectReference(group->getEndHead(), resolved, groups);
+
+    for (unsigned int i = 0; i < group->getNumElements(); ++i)
+    {
+      const Transformation2D* element = group->getElement(i);
+
+      const RenderGroup* child = dynamic_cast<const RenderGroup*>(element);
+      if (child != NULL)
+      {
+        groups.push_back(child);
+        continue;
+      }
+
+      const GraphicalPrimitive1D* primitive =
+        dynamic_cast<const GraphicalPrimitive1D*>(element);
+      if (primitive != NULL)
+      {
+        collectReference(primitive->getStroke(), resolved, groups);
+      }
+
+      const GraphicalPrimitive2D* filled =
+        dynamic_cast<const GraphicalPrimitive2D*>(element);
+      if (filled != NULL)
+      {
+        collectReference(filled->getFill(), resolved, groups);
+      }
+
+      const RenderCurve* curve = dynamic_cast<const RenderCurve*>(element);
+      if (curve != NULL)
+      {
+        collectReference(curve->getStartHead(), resolved, groups);
+        collectReference(curve->getEndHead(), resolved, groups);
+      }
+    }
+  }
+}
+
+
+/*
+ * Adds the definition with the given id, which may be a color, a gradient
+ * or a line ending; the group of a line ending seen for the first time is
+ * added to the groups to visit.
+ */
+void
+StyleResolver::collectReference(const std::string& id,
+                                ResolvedStyle& resolved,
+                                std::vector<const RenderGroup*>& groups) const
+{
+  if (id.empty() || id == "none")
+  {
+    return;
+  }
+
+  const ColorDefinition* color = getColorDefinition(id);
+  if (color != NULL)
+  {
+    addUnique(resolved.mColors, color);
+  }
+
+  const GradientBase* gradient = getGradientDefinition(id);
+  if (gradient != NULL
+    && findById(resolved.mGradients, id) == NULL)
+  {
+    resolved.mGradients.push_back(gradient);
+    for (unsigned int i = 0; i < gradient->getNumGradientStops(); ++i)
+    {
+      const ColorDefinition* stop =
+        getColorDefinition(gradient->getGradientStop(i)->getStopColor());
+      if (stop != NULL)
+      {
+        addUnique(resolved.mColors, stop);
+      }
+    }
+  }
+
+  const LineEnding* ending = getLineEnding(id);
+  if (ending != NULL
+    && findById(resolved.mLineEndings, id) == NULL)
+  {
+    resolved.mLineEndings.push_back(ending);
+    groups.push_back(ending->getGroup());
+  }
+}
+
+/** @endcond */
+
+
+LIBSBML_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
@@ -0,0 +1,429 @@
+/**
+ * @file    StyleResolver.h
+ * @brief   Definition of StyleResolver and ResolvedStyle, which find the
+ *          style that render information gives each graphical object.
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class StyleResolver
+ * @sbmlbrief{render} Finds the style of each graphical object of a layout.
+ *
+ * @htmlinclude libsbml-facility-only-warning.html
+ *
+ * A StyleResolver answers "which style draws this glyph" for one
+ * LocalRenderInformation or GlobalRenderInformation, together with the
+ * render information it refers to through its referenceRenderInformation
+ * attribute, and the render information that one refers to in turn.  Each
+ * of these is searched in order, and within one render information a
+ * style is looked up:
+ *
+ * @li by the id of the object, in the idList of a LocalStyle;
+ * @li by the role of the object, in the roleList of a style;
+ * @li by the type of the object, such as SPECIESGLYPH, in the typeList of
+ * a style; ANY matches all types.
+ *
+ * Where several styles match in the same way, the first in the list wins.
+ * The role of an object is its render objectRole or, if it has none, the
+ * role of a SpeciesReferenceGlyph or ReferenceGlyph.
+ *
+ * The styles are indexed when the StyleResolver is created, so that a
+ * look-up does not depend on the number of styles.  The ColorDefinition,
+ * GradientBase and LineEnding objects that the styles refer to are
+ * resolved along the same chain at that time; the first render
+ * information in the chain to define an id wins.  The StyleResolver must
+ * be created anew if the render information changes.
+ */
+
+
+#ifndef StyleResolver_h
+#define StyleResolver_h
+
+#include <sbml/common/extern.h>
+
+#ifdef __cplusplus
+
+#include <map>
+#include <string>
+#include <vector>
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+class ColorDefinition;
+class GradientBase;
+class GraphicalObject;
+class Layout;
+class LineEnding;
+class RenderGroup;
+class RenderInformationBase;
+class Style;
+
+
+/**
+ * @class ResolvedStyle
+ * @sbmlbrief{render} The style of a graphical object, as returned by a
+ * StyleResolver.
+ *
+ * A ResolvedStyle holds the graphical object, the style that draws it,
+ * the render information the style belongs to, and the color definitions,
+ * gradient definitions and line endings that the style uses, directly or
+ * through its gradients and line endings.
+ */
+class LIBSBML_EXTERN ResolvedStyle
+{
+public:
+
+  /**
+   * Creates a new ResolvedStyle that is not valid.
+   */
+  ResolvedStyle();
+
+
+  /**
+   * Destroys this ResolvedStyle.
+   */
+  virtual ~ResolvedStyle();
+
+
+  /**
+   * Returns whether a style was found for the graphical object.
+   *
+   * @return @c true if there is a style, @c false otherwise.
+   */
+  bool isValid() const;
+
+
+  /**
+   * Returns the graphical object this ResolvedStyle is the style of.
+   *
+   * @return the graphical object.
+   */
+  const GraphicalObject* getGraphicalObject() const;
+
+
+  /**
+   * Returns the style that draws the graphical object.
+   *
+   * @return the style, or @c NULL if there is none.
+   */
+  const Style* getStyle() const;
+
+
+  /**
+   * Returns the render information the style belongs to.
+   *
+   * @return the render information, or @c NULL if there is no style.
+   */
+  const RenderInformationBase* getRenderInformation() const;
+
+
+  /**
+   * Returns the number of color definitions the style uses.
+   *
+   * @return the number of color definitions.
+   */
+  unsigned int getNumColorDefinitions() const;
+
+
+  /**
+   * Returns the @p n-th color definition the style uses.
+   *
+   * @param n the index of the color definition.
+   *
+   * @return the color definition, or @c NULL if there is no such one.
+   */
+  const ColorDefinition* getColorDefinition(unsigned int n) const;
+
+
+  /**
+   * Returns the color definition with the given id that the style uses.
+   *
+   * @param id the id of the color definition.
+   *
+   * @return the color definition, or @c NULL if the style uses none with
+   * this id.
+   */
+  const ColorDefinition* getColorDefinition(const std::string& id) const;
+
+
+  /**
+   * Returns the number of gradient definitions the style uses.
+   *
+   * @return the number of gradient definitions.
+   */
+  unsigned int getNumGradientDefinitions() const;
+
+
+  /**
+   * Returns the @p n-th gradient definition the style uses.
+   *
+   * @param n the index of the gradient definition.
+   *
+   * @return the gradient definition, or @c NULL if there is no such one.
+   */
+  const GradientBase* getGradientDefinition(unsigned int n) const;
+
+
+  /**
+   * Returns the gradient definition with the given id that the style uses.
+   *
+   * @param id the id of the gradient definition.
+   *
+   * @return the gradient definition, or @c NULL if the style uses none
+   * with this id.
+   */
+  const GradientBase* getGradientDefinition(const std::string& id) const;
+
+
+  /**
+   * Returns the number of line endings the style uses.
+   *
+   * @return the number of line endings.
+   */
+  unsigned int getNumLineEndings() const;
+
+
+  /**
+   * Returns the @p n-th line ending the style uses.
+   *
+   * @param n the index of the line ending.
+   *
+   * @return the line ending, or @c NULL if there is no such one.
+   */
+  const LineEnding* getLineEnding(unsigned int n) const;
+
+
+  /**
+   * Returns the line ending with the given id that the style uses.
+   *
+   * @param id the id of the line ending.
+   *
+   * @return the line ending, or @c NULL if the style uses none with this
+   * id.
+   */
+  const LineEnding* getLineEnding(const std::string& id) const;
+
+
+protected:
+  /** @cond doxygenLibsbmlInternal */
+
+  friend class StyleResolver;
+
+  const GraphicalObject* mObject;
+  const Style* mStyle;
+  const RenderInformationBase* mRenderInformation;
+
+  std::vector<const ColorDefinition*> mColors;
+  std::vector<const GradientBase*> mGradients;
+  std::vector<const LineEnding*> mLineEndings;
+
+  /** @endcond */
+};
+
+
+class LIBSBML_EXTERN StyleResolver
+{
+public:
+
+  /**
+   * Creates a new StyleResolver for the given render information.
+   *
+   * @param renderInformation the LocalRenderInformation or
+   * GlobalRenderInformation whose styles to use.
+   */
+  StyleResolver(const RenderInformationBase* renderInformation);
+
+
+  /**
+   * Creates a new StyleResolver for a Layout.
+   *
+   * @param layout the Layout whose first LocalRenderInformation to use,
+   * or, if it has none, the first GlobalRenderInformation of the layouts.
+   */
+  StyleResolver(const Layout* layout);
+
+
+  /**
+   * Destroys this StyleResolver.
+   */
+  virtual ~StyleResolver();
+
+
+  /**
+   * Returns the number of render information objects searched for styles,
+   * that is the render information given and those it refers to.
+   *
+   * @return the number of render information objects.
+   */
+  unsigned int getNumRenderInformation() const;
+
+
+  /**
+   * Returns the @p n-th render information searched for styles.
+   *
+   * @param n the index of the render information; 0 is the one given.
+   *
+   * @return the render information, or @c NULL if there is no such one.
+   */
+  const RenderInformationBase* getRenderInformation(unsigned int n = 0) const;
+
+
+  /**
+   * Returns the style that draws a graphical object.
+   *
+   * @param object the graphical object.
+   *
+   * @return the style, or @c NULL if there is none.
+   */
+  const Style* getStyle(const GraphicalObject* object) const;
+
+
+  /**
+   * Returns the style that draws a graphical object, with the definitions
+   * it uses.
+   *
+   * @param object the graphical object.
+   *
+   * @return the resolved style, which is not valid if there is no style.
+   */
+  ResolvedStyle resolve(const GraphicalObject* object) const;
+
+
+  /**
+   * Returns the styles of all graphical objects of a Layout.
+   *
+   * The objects are the compartment, species, reaction, text and
+   * additional glyphs of the layout, with the species reference glyphs of
+   * each reaction glyph and the reference glyphs and subglyphs of each
+   * general glyph after the glyph.
+   *
+   * @param layout the Layout.
+   *
+   * @return one resolved style per graphical object, in this order.
+   */
+  std::vector<ResolvedStyle> resolveAll(const Layout* layout) const;
+
+
+  /**
+   * Returns the color definition with the given id.
+   *
+   * @param id the id of the color definition.
+   *
+   * @return the color definition of the first render information in the
+   * chain to define it, or @c NULL if there is none.
+   */
+  const ColorDefinition* getColorDefinition(const std::string& id) const;
+
+
+  /**
+   * Returns the gradient definition with the given id.
+   *
+   * @param id the id of the gradient definition.
+   *
+   * @return the gradient definition of the first render information in
+   * the chain to define it, or @c NULL if there is none.
+   */
+  const GradientBase* getGradientDefinition(const std::string& id) const;
+
+
+  /**
+   * Returns the line ending with the given id.
+   *
+   * @param id the id of the line ending.
+   *
+   * @return the line ending of the first render information in the chain
+   * to define it, or @c NULL if there is none.
+   */
+  const LineEnding* getLineEnding(const std::string& id) const;
+
+
+  /**
+   * Returns the type of a graphical object, as used in the typeList of a
+   * style.
+   *
+   * @param object the graphical object.
+   *
+   * @return one of COMPARTMENTGLYPH, SPECIESGLYPH, REACTIONGLYPH,
+   * SPECIESREFERENCEGLYPH, TEXTGLYPH, GENERALGLYPH, REFERENCEGLYPH and
+   * GRAPHICALOBJECT; an empty string for @c NULL.
+   */
+  static std::string getType(const GraphicalObject* object);
+
+
+  /**
+   * Returns the role of a graphical object, as used in the roleList of a
+   * style.
+   *
+   * @param object the graphical object.
+   *
+   * @return the objectRole of the object, or else the role of a
+   * SpeciesReferenceGlyph or ReferenceGlyph; an empty string if it has
+   * none.
+   */
+  static std::string getRole(const GraphicalObject* object);
+
+
+protected:
+  /** @cond doxygenLibsbmlInternal */
+
+  // a style and its position in the list of styles
+  typedef std::pair<unsigned int, const Style*> Entry;
+  typedef std::map<std::string, Entry> Index;
+
+  struct Level
+  {
+    const RenderInformationBase* info;
+    Index ids;
+    Index roles;
+    Index types;
+  };
+
+  void addChain(const RenderInformationBase* renderInformation);
+
+  void indexStyles(Level& level);
+
+  void collectDefinitions(const Style* style, ResolvedStyle& resolved) const;
+
+  void collectReference(const std::string& id, ResolvedStyle& resolved,
+                        std::vector<const RenderGroup*>& groups) const;
+
+  std::vector<Level> mLevels;
+
+  std::map<std::string, const ColorDefinition*> mColors;
+  std::map<std::string, const GradientBase*> mGradients;
+  std::map<std::string, const LineEnding*> mLineEndings;
+
+  // the resolved style of each style, ready to be copied
+  std::map<const Style*, ResolvedStyle> mResolved;
+
+  /** @endcond */
+
+private:
+  /** @cond doxygenLibsbmlInternal */
+
+  StyleResolver(const StyleResolver&);
+  StyleResolver& operator=(const StyleResolver&);
+
+  /** @endcond */
+};
+
+
+LIBSBML_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+#endif  /* StyleResolver_h */
@@ -0,0 +1,645 @@
+/**
+ * @file CompiledCSGeometry.cpp
+ * @brief Implementation of the CompiledCSGeometry class.
+ * @author SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML. Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ * 3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ * Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation. A copy of the license agreement is provided in the
+ * file named "LICENSE.txt" included with this software distribution and also
+ * available online as http://sbml.org/software/libsbml/license.html
+ * ------------------------------------------------------------------------ -->
+ */
+#include <sbml/packages/spatial/common/CompiledCSGeometry.h>
+#include <sbml/packages/spatial/common/SpatialExtensionTypes.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+using namespace std;
+
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+/** @cond doxygenLibsbmlInternal */
+
+/* number of points evaluated together by each instruction */
+static const size_t CSG_BLOCK_SIZE = 256;
+
+/* levels of the evaluation stack kept on the C++ stack for a full block */
+static const size_t CSG_STACK_LEVELS = 16;
+
+/* returned for an object out of range; constructed when the library is
+ * loaded, as queries may come from several threads */
+static const std::string NO_DOMAIN_TYPE;
+
+static const double CSG_IDENTITY[12] =
+{
+  1, 0, 0, 0,
+  0, 1, 0, 0,
+  0, 0, 1, 0
+};
+
+/*
+ * result = a * b for 3x4 affine matrices (the implicit last row being
+ * 0 0 0 1); result may not alias a or b.
+ */
+static void
+multiplyAffine(const double a[12], const double b[12], double result[12])
+{
+  for (unsigned int r = 0; r < 3; ++r)
+  {
+    for (unsigned int c = 0; c < 4; ++c)
+    {
+      double value = a[4 * r] * b[c] + a[4 * r + 1] * b[4 + c]
+                   + a[4 * r + 2] * b[8 + c];
+      if (c == 3) value += a[4 * r + 3];
+      result[4 * r + c] = value;
+    }
+  }
+}
+
+/*
+ * Inverts the 3x4 affine matrix m; returns false if it is singular.
+ */
+static bool
+invertAffine(const double m[12], double result[12])
+{
+  double a = m[0], b = m[1], c = m[2];
+  double d = m[4], e = m[5], f = m[6];
+  double g = m[8], h = m[9], i = m[10];
+
+  double A = e * i - f * h;
+  double B = f * g - d * i;
+  double C = d * h - e * g;
+  double det = a * A + b * B + c * C;
+  if (!(fabs(det) > 1e-300)) return false;
+  double inv = 1.0 / det;
+
+  double lin[9] =
+  {
+    A * inv, (c * h - b * i) * inv, (b * f - c * e) * inv,
+    B * inv, (a * i - c * g) * inv, (c * d - a * f) * inv,
+    C * inv, (b * g - a * h) * inv, (a * e - b * d) * inv
+  };
+
+  for (unsigned int r = 0; r < 3; ++r)
+  {
+    result[4 * r] = lin[3 * r];
+    result[4 * r + 1] = lin[3 * r + 1];
+    result[4 * r + 2] = lin[3 * r + 2];
+    result[4 * r + 3] = -(lin[3 * r] * m[3] + lin[3 * r + 1] * m[7]
+                          + lin[3 * r + 2] * m[11]);
+  }
+  return true;
+}
+
+/*
+ * Returns the value of an attribute of a transformation, or the given
+ * default if it is unset.
+ */
+static double
+valueOr(bool isSet, double value, double defaultValue)
+{
+  return isSet ? value : defaultValue;
+}
+
+struct OrdinalLess
+{
+  const vector<int>* ordinals;
+  bool operator()(unsigned int a, unsigned int b) const
+  {
+    return (*ordinals)[a] < (*ordinals)[b];
+  }
+};
+
+/** @endcond */
+
+
+CompiledCSGeometry::CompiledCSGeometry()
+  : mPrograms()
+  , mPrecedence()
+{
+}
+
+
+CompiledCSGeometry::CompiledCSGeometry(const CSGeometry* geometry)
+  : mPrograms()
+  , mPrecedence()
+{
+  compile(geometry);
+}
+
+
+CompiledCSGeometry::~CompiledCSGeometry()
+{
+}
+
+
+void
+CompiledCSGeometry::clear()
+{
+  mPrograms.clear();
+  mPrecedence.clear();
+}
+
+
+int
+CompiledCSGeometry::compile(const CSGeometry* geometry)
+{
+  clear();
+
+  if (geometry == NULL)
+  {
+    return LIBSBML_INVALID_OBJECT;
+  }
+
+  mPrograms.resize(geometry->getNumCSGObjects());
+  for (unsigned int n = 0; n < geometry->getNumCSGObjects(); ++n)
+  {
+    const CSGObject* object = geometry->getCSGObject(n);
+    Program& program = mPrograms[n];
+    program.domainType = object->getDomainType();
+    program.ordinal = object->isSetOrdinal() ? object->getOrdinal() : 0;
+
+    int result = LIBSBML_INVALID_OBJECT;
+    if (object->isSetCSGNode())
+    {
+      result = compileNode(object->getCSGNode(), CSG_IDENTITY, program);
+    }
+    if (result != LIBSBML_OPERATION_SUCCESS)
+    {
+      clear();
+      return result;
+    }
+
+    // the evaluation stack never grows beyond the deepest push
+    unsigned int depth = 0;
+    program.maxDepth = 0;
+    for (size_t i = 0; i < program.instructions.size(); ++i)
+    {
+      const Instruction& instruction = program.instructions[i];
+      if (instruction.code < CSG_OP_UNION)
+      {
+        ++depth;
+      }
+      else
+      {
+        depth -= instruction.operands - 1;
+      }
+      program.maxDepth = std::max(program.maxDepth, depth);
+    }
+  }
+
+  // objects in increasing order of precedence; among equal ordinals the
+  // object listed first wins
+  vector<int> ordinals;
+  for (size_t n = 0; n < mPrograms.size(); ++n)
+  {
+    ordinals.push_back(mPrograms[n].ordinal);
+    mPrecedence.push_back((unsigned int)(mPrograms.size() - 1 - n));
+  }
+  OrdinalLess less;
+  less.ordinals = &ordinals;
+  std::stable_sort(mPrecedence.begin(), mPrecedence.end(), less);
+
+  return LIBSBML_OPERATION_SUCCESS;
+}
+
+
+unsigned int
+CompiledCSGeometry::getNumObjects() const
+{
+  return (unsigned int)mPrograms.size();
+}
+
+
+const std::string&
+CompiledCSGeometry::getDomainType(unsigned int n) const
+{
+  return (n < mPrograms.size()) ? mPrograms[n].domainType : NO_DOMAIN_TYPE;
+}
+
+
+unsigned int
+CompiledCSGeometry::getProgramLength(unsigned int n) const
+{
+  return (n < mPrograms.size())
+    ? (unsigned int)mPrograms[n].instructions.size() : 0;
+}
+
+
+bool
+CompiledCSGeometry::isInside(double x, double y, double z,
+                             unsigned int n) const
+{
+  if (n >= mPrograms.size()) return false;
+
+  const double coords[3] = { x, y, z };
+  unsigned char result = 0;
+  evaluate(mPrograms[n], coords, 1, &result);
+  return result != 0;
+}
+
+
+int
+CompiledCSGeometry::classify(double x, double y, double z) const
+{
+  const double coords[3] = { x, y, z };
+  int result = -1;
+  classifyAll(coords, 1, &result);
+  return result;
+}
+
+
+void
+CompiledCSGeometry::isInsideAll(const double* coords, size_t numPoints,
+                                unsigned int n, unsigned char* result) const
+{
+  if (coords == NULL || result == NULL) return;
+
+  if (n >= mPrograms.size())
+  {
+    std::fill(result, result + numPoints, (unsigned char)0);
+    return;
+  }
+
+  for (size_t begin = 0; begin < numPoints; begin += CSG_BLOCK_SIZE)
+  {
+    size_t count = std::min(CSG_BLOCK_SIZE, numPoints - begin);
+    evaluate(mPrograms[n], coords + 3 * begin, count, result + begin);
+  }
+}
+
+
+void
+CompiledCSGeometry::classifyAll(const double* coords, size_t numPoints,
+                                int* result) const
+{
+  if (coords == NULL || result == NULL) return;
+
+  unsigned char inside[CSG_BLOCK_SIZE];
+  for (size_t begin = 0; begin < numPoints; begin += CSG_BLOCK_SIZE)
+  {
+    size_t count = std::min(CSG_BLOCK_SIZE, numPoints - begin);
+    int* block = result + begin;
+    std::fill(block, block + count, -1);
+
+    // later objects in the precedence order overwrite earlier ones
+    for (size_t p = 0; p < mPrecedence.size(); ++p)
+    {
+      unsigned int n = mPrecedence[p];
+      evaluate(mPrograms[n], coords + 3 * begin, count, inside);
+      for (size_t i = 0; i < count; ++i)
+      {
+        if (inside[i]) block[i] = (int)n;
+      }
+    }
+  }
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+
+int
+CompiledCSGeometry::compileNode(const CSGNode* node, const double matrix[12],
+                                Program& program)
+{
+  if (node == NULL)
+  {
+    return LIBSBML_INVALID_OBJECT;
+  }
+
+  if (node->isCSGPrimitive())
+  {
+    Instruction instruction;
+    switch (static_cast<const CSGPrimitive*>(node)->getPrimitiveType())
+    {
+    case SPATIAL_PRIMITIVEKIND_SPHERE:   instruction.code = CSG_OP_SPHERE;   break;
+    case SPATIAL_PRIMITIVEKIND_CUBE:     instruction.code = CSG_OP_CUBE;     break;
+    case SPATIAL_PRIMITIVEKIND_CYLINDER: instruction.code = CSG_OP_CYLINDER; break;
+    case SPATIAL_PRIMITIVEKIND_CONE:     instruction.code = CSG_OP_CONE;     break;
+    case SPATIAL_PRIMITIVEKIND_CIRCLE:   instruction.code = CSG_OP_CIRCLE;   break;
+    case SPATIAL_PRIMITIVEKIND_SQUARE:   instruction.code = CSG_OP_SQUARE;   break;
+    default:
+      return LIBSBML_INVALID_OBJECT;
+    }
+    instruction.operands = 0;
+    std::copy(matrix, matrix + 12, instruction.matrix);
+    program.instructions.push_back(instruction);
+    return LIBSBML_OPERATION_SUCCESS;
+  }
+
+  if (node->isCSGSetOperator())
+  {
+    const CSGSetOperator* op = static_cast<const CSGSetOperator*>(node);
+    unsigned int numChildren = op->getNumCSGNodes();
+    Instruction instruction;
+    std::copy(CSG_IDENTITY, CSG_IDENTITY + 12, instruction.matrix);
+
+    if (op->getOperationType() == SPATIAL_SETOPERATION_DIFFERENCE)
+    {
+      if (numChildren != 2)
+      {
+        return LIBSBML_INVALID_OBJECT;
+      }
+
+      const CSGNode* a = op->getCSGNode(0u);
+      const CSGNode* b = op->getCSGNode(1u);
+      if (op->isSetComplementA() || op->isSetComplementB())
+      {
+        a = op->getCSGNode(op->getComplementA());
+        b = op->getCSGNode(op->getComplementB());
+        if (a == NULL || b == NULL || a == b)
+        {
+          return LIBSBML_INVALID_OBJECT;
+        }
+      }
+
+      int result = compileNode(a, matrix, program);
+      if (result != LIBSBML_OPERATION_SUCCESS) return result;
+      result = compileNode(b, matrix, program);
+      if (result != LIBSBML_OPERATION_SUCCESS) return result;
+
+      instruction.code = CSG_OP_DIFFERENCE;
+      instruction.operands = 2;
+      program.instructions.push_back(instruction);
+      return LIBSBML_OPERATION_SUCCESS;
+    }
+
+    if (op->getOperationType() == SPATIAL_SETOPERATION_UNION)
+    {
+      instruction.code = CSG_OP_UNION;
+    }
+    else if (op->getOperationType() == SPATIAL_SETOPERATION_INTERSECTION)
+    {
+      instruction.code = CSG_OP_INTERSECTION;
+    }
+    else
+    {
+      return LIBSBML_INVALID_OBJECT;
+    }
+
+    if (numChildren == 0)
+    {
+      instruction.code = CSG_OP_EMPTY;
+      instruction.operands = 0;
+      program.instructions.push_back(instruction);
+      return LIBSBML_OPERATION_SUCCESS;
+    }
+
+    for (unsigned int i = 0; i < numChildren; ++i)
+    {
+      int result = compileNode(op->getCSGNode(i), matrix, program);
+      if (result != LIBSBML_OPERATION_SUCCESS) return result;
+    }
+
+    // a single child needs no combining instruction
+    if (numChildren > 1)
+    {
+      instruction.operands = numChildren;
+      program.instructions.push_back(instruction);
+    }
+    return LIBSBML_OPERATION_SUCCESS;
+  }
+
+  // remaining nodes are transformations: compute the inverse of the local
+  // forward map and prepend it to the accumulated inverse
+  const CSGTransformation* transformation =
+    static_cast<const CSGTransformation*>(node);
+  double inverse[12];
+  std::copy(CSG_IDENTITY, CSG_IDENTITY + 12, inverse);
+
+  if (node->isCSGTranslation())
+  {
+    const CSGTranslation* t = static_cast<const CSGTranslation*>(node);
+    inverse[3] = -valueOr(t->isSetTranslateX(), t->getTranslateX(), 0.0);
+    inverse[7] = -valueOr(t->isSetTranslateY(), t->getTranslateY(), 0.0);
+    inverse[11] = -valueOr(t->isSetTranslateZ(), t->getTranslateZ(), 0.0);
+  }
+  else if (node->isCSGScale())
+  {
+    const CSGScale* s = static_cast<const CSGScale*>(node);
+    double sx = valueOr(s->isSetScaleX(), s->getScaleX(), 1.0);
+    double sy = valueOr(s->isSetScaleY(), s->getScaleY(), 1.0);
+    double sz = valueOr(s->isSetScaleZ(), s->getScaleZ(), 1.0);
+    if (sx == 0.0 || sy == 0.0 || sz == 0.0)
+    {
+      return LIBSBML_OPERATION_FAILED;
+    }
+    inverse[0] = 1.0 / sx;
+    inverse[5] = 1.0 / sy;
+    inverse[10] = 1.0 / sz;
+  }
+  else if (node->isCSGRotation())
+  {
+    const CSGRotation* r = static_cast<const CSGRotation*>(node);
+    double ax = valueOr(r->isSetRotateX(), r->getRotateX(), 0.0);
+    double ay = valueOr(r->isSetRotateY(), r->getRotateY(), 0.0);
+    double az = valueOr(r->isSetRotateZ(), r->getRotateZ(), 0.0);
+    double length = sqrt(ax * ax + ay * ay + az * az);
+    if (!(length > 0.0))
+    {
+      return LIBSBML_INVALID_OBJECT;
+    }
+    ax /= length; ay /= length; az /= length;
+
+    // the inverse of a rotation is the rotation by the opposite angle
+    double angle = -valueOr(r->isSetRotateAngleInRadians(),
+                            r->getRotateAngleInRadians(), 0.0);
+    double c = cos(angle);
+    double s = sin(angle);
+    double t = 1.0 - c;
+    inverse[0] = c + ax * ax * t;
+    inverse[1] = ax * ay * t - az * s;
+    inverse[2] = ax * az * t + ay * s;
+    inverse[4] = ay * ax * t + az * s;
+    inverse[5] = c + ay * ay * t;
+    inverse[6] = ay * az * t - ax * s;
+    inverse[8] = az * ax * t - ay * s;
+    inverse[9] = az * ay * t + ax * s;
+    inverse[10] = c + az * az * t;
+  }
+  else if (node->isCSGHomogeneousTransformation())
+  {
+    const TransformationComponent* forward =
+      static_cast<const CSGHomogeneousTransformation*>(node)
+        ->getForwardTransformation();
+    if (forward == NULL || forward->getActualComponentsLength() < 12)
+    {
+      return LIBSBML_INVALID_OBJECT;
+    }
+    double components[16];
+    std::fill(components, components + 16, 0.0);
+    forward->getComponents(components);
+    if (!invertAffine(components, inverse))
+    {
+      return LIBSBML_OPERATION_FAILED;
+    }
+  }
+  else
+  {
+    return LIBSBML_INVALID_OBJECT;
+  }
+
+  double combined[12];
+  multiplyAffine(inverse, matrix, combined);
+  return compileNode(transformation->getCSGNode(), combined, program);
+}
+
+
+void
+CompiledCSGeometry::evaluate(const Program& program, const double* coords,
+                             size_t count, unsigned char* result) const
+{
+  double xs[CSG_BLOCK_SIZE], ys[CSG_BLOCK_SIZE], zs[CSG_BLOCK_SIZE];
+  for (size_t i = 0; i < count; ++i)
+  {
+    xs[i] = coords[3 * i];
+    ys[i] = coords[3 * i + 1];
+    zs[i] = coords[3 * i + 2];
+  }
+
+  // the evaluation stack holds 'count' entries per level; it is local so
+  // that queries may run concurrently, and only unusually deep programs
+  // need it allocated
+  unsigned char local[CSG_STACK_LEVELS * CSG_BLOCK_SIZE];
+  vector<unsigned char> deep;
+  unsigned char* stack = local;
+  if (program.maxDepth * count > sizeof(local))
+  {
+    deep.resize(program.maxDepth * count);
+    stack = &deep[0];
+  }
+  unsigned int top = 0;
+
+  for (size_t n = 0; n < program.instructions.size(); ++n)
+  {
+    const Instruction& instruction = program.instructions[n];
+    const double* m = instruction.matrix;
+
+    if (instruction.code >= CSG_OP_UNION)
+    {
+      unsigned int first = top - instruction.operands;
+      unsigned char* target = &stack[first * count];
+      for (unsigned int k = first + 1; k < top; ++k)
+      {
+        const unsigned char* operand = &stack[k * count];
+        switch (instruction.code)
+        {
+        case CSG_OP_UNION:
+          for (size_t i = 0; i < count; ++i) target[i] |= operand[i];
+          break;
+        case CSG_OP_INTERSECTION:
+          for (size_t i = 0; i < count; ++i) target[i] &= operand[i];
+          break;
+        default:
+          for (size_t i = 0; i < count; ++i) target[i] &= !operand[i];
+          break;
+        }
+      }
+      top = first + 1;
+      continue;
+    }
+
+    unsigned char* target = &stack[top * count];
+    ++top;
+
+    switch (instruction.code)
+    {
+    case CSG_OP_SPHERE:
+      for (size_t i = 0; i < count; ++i)
+      {
+        double x = m[0] * xs[i] + m[1] * ys[i] + m[2] * zs[i] + m[3];
+        double y = m[4] * xs[i] + m[5] * ys[i] + m[6] * zs[i] + m[7];
+        double z = m[8] * xs[i] + m[9] * ys[i] + m[10] * zs[i] + m[11];
+        target[i] = (x * x + y * y + z * z <= 1.0);
+      }
+      break;
+    case CSG_OP_CUBE:
+      for (size_t i = 0; i < count; ++i)
+      {
+        double x = m[0] * xs[i] + m[1] * ys[i] + m[2] * zs[i] + m[3];
+        double y = m[4] * xs[i] + m[5] * ys[i] + m[6] * zs[i] + m[7];
+        double z = m[8] * xs[i] + m[9] * ys[i] + m[10] * zs[i] + m[11];
+        target[i] = (fabs(x) <= 1.0) & (fabs(y) <= 1.0) & (fabs(z) <= 1.0);
+      }
+      break;
+    case CSG_OP_CYLINDER:
+      for (size_t i = 0; i < count; ++i)
+      {
+        double x = m[0] * xs[i] + m[1] * ys[i] + m[2] * zs[i] + m[3];
+        double y = m[4] * xs[i] + m[5] * ys[i] + m[6] * zs[i] + m[7];
+        double z = m[8] * xs[i] + m[9] * ys[i] + m[10] * zs[i] + m[11];
+        target[i] = (x * x + y * y <= 1.0) & (fabs(z) <= 1.0);
+      }
+      break;
+    case CSG_OP_CONE:
+      for (size_t i = 0; i < count; ++i)
+      {
+        double x = m[0] * xs[i] + m[1] * ys[i] + m[2] * zs[i] + m[3];
+        double y = m[4] * xs[i] + m[5] * ys[i] + m[6] * zs[i] + m[7];
+        double z = m[8] * xs[i] + m[9] * ys[i] + m[10] * zs[i] + m[11];
+        double radius = 0.5 * (1.0 - z);
+        target[i] = (x * x + y * y <= radius * radius) & (fabs(z) <= 1.0);
+      }
+      break;
+    case CSG_OP_CIRCLE:
+      for (size_t i = 0; i < count; ++i)
+      {
+        double x = m[0] * xs[i] + m[1] * ys[i] + m[2] * zs[i] + m[3];
+        double y = m[4] * xs[i] + m[5] * ys[i] + m[6] * zs[i] + m[7];
+        target[i] = (x * x + y * y <= 1.0);
+      }
+      break;
+    case CSG_OP_SQUARE:
+      for (size_t i = 0; i < count; ++i)
+      {
+        double x = m[0] * xs[i] + m[1] * ys[i] + m[2] * zs[i] + m[3];
+        double y = m[4] * xs[i] + m[5] * ys[i] + m[6] * zs[i] + m[7];
+        target[i] = (fabs(x) <= 1.0) & (fabs(y) <= 1.0);
+      }
+      break;
+    default:
+      std::fill(target, target + count, (unsigned char)0);
+      break;
+    }
+  }
+
+  std::copy(stack, stack + count, result);
+}
+
+/** @endcond */
+
+
+LIBSBML_CPP_NAMESPACE_END
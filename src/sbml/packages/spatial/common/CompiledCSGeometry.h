@@ -0,0 +1,282 @@
+/**
+ * @file CompiledCSGeometry.h
+ * @brief Flattened, batch-evaluable form of a CSGeometry.
+ * @author SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML. Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ * 3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ * Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation. A copy of the license agreement is provided in the
+ * file named "LICENSE.txt" included with this software distribution and also
+ * available online as http://sbml.org/software/libsbml/license.html
+ * ------------------------------------------------------------------------ -->
+ *
+ * @class CompiledCSGeometry
+ * @sbmlbrief{spatial} Point classification for a CSGeometry.
+ *
+ * A CSGeometry describes each of its domains as a tree of CSGSetOperator,
+ * CSGPrimitive and CSGTransformation nodes.  Deciding whether a point lies
+ * inside such a tree by walking it means composing every transformation on
+ * the way down, for every point.  The CompiledCSGeometry instead compiles
+ * each CSGObject once into a linear postfix program: every primitive
+ * carries the inverse of the accumulated affine transformation above it,
+ * and every set operator becomes a single instruction combining the
+ * results on an evaluation stack.
+ *
+ * The program is evaluated over blocks of points at a time, one
+ * instruction for the whole block, so that the inner loops run over
+ * contiguous arrays that the compiler can vectorize.
+ *
+ * The primitives are those of the SBML Level&nbsp;3 Spatial specification,
+ * all centered on the origin: the sphere of radius 1, the cube spanning -1
+ * to 1 along each axis, the cylinder of radius 1 around the z axis
+ * spanning -1 to 1 along it, the cone with its base of radius 1 at z = -1
+ * and its apex at z = 1, and the two-dimensional circle of radius 1 and
+ * square spanning -1 to 1 in the x-y plane, which ignore the z coordinate.
+ *
+ * When several CSGObject elements contain a point, the one with the
+ * highest "ordinal" takes precedence.
+ *
+ * The CompiledCSGeometry does not keep a pointer to the CSGeometry it was
+ * compiled from; if the geometry is subsequently modified, compile() must
+ * be called again.
+ *
+ * The queries are const and keep no state between calls, so a compiled
+ * geometry may answer queries from several threads at once.
+ */
+
+
+#ifndef CompiledCSGeometry_H__
+#define CompiledCSGeometry_H__
+
+
+#include <sbml/common/extern.h>
+#include <sbml/packages/spatial/common/spatialfwd.h>
+
+
+#ifdef __cplusplus
+
+
+#include <string>
+#include <vector>
+
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+
+class LIBSBML_EXTERN CompiledCSGeometry
+{
+public:
+
+  /**
+   * Creates a new, empty CompiledCSGeometry.
+   */
+  CompiledCSGeometry();
+
+
+  /**
+   * Creates a new CompiledCSGeometry and compiles the given CSGeometry.
+   *
+   * @param geometry the CSGeometry to compile.
+   *
+   * @see compile(const CSGeometry* geometry)
+   */
+  CompiledCSGeometry(const CSGeometry* geometry);
+
+
+  /**
+   * Destructor for CompiledCSGeometry.
+   */
+  virtual ~CompiledCSGeometry();
+
+
+  /**
+   * (Re)compiles this object from the given CSGeometry.
+   *
+   * @param geometry the CSGeometry to compile.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBSBML_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBSBML_INVALID_OBJECT, OperationReturnValues_t}
+   * if @p geometry is @c NULL, or if one of its trees has a missing child,
+   * an invalid primitive or operation type, or a difference whose
+   * complements do not name its children.
+   * @li @sbmlconstant{LIBSBML_OPERATION_FAILED, OperationReturnValues_t}
+   * if a transformation cannot be inverted.
+   */
+  int compile(const CSGeometry* geometry);
+
+
+  /**
+   * Removes all content from this object.
+   */
+  void clear();
+
+
+  /**
+   * Returns the number of compiled CSGObject elements.
+   *
+   * @return the number of compiled CSGObject elements.
+   */
+  unsigned int getNumObjects() const;
+
+
+  /**
+   * Returns the domainType of the nth compiled CSGObject.
+   *
+   * Objects are numbered in the order of the ListOfCSGObjects.
+   *
+   * @param n the index of the CSGObject.
+   *
+   * @return the "domainType" of the nth CSGObject, or an empty string if
+   * @p n is out of range.
+   */
+  const std::string& getDomainType(unsigned int n) const;
+
+
+  /**
+   * Returns the number of instructions the nth CSGObject compiled to.
+   *
+   * @param n the index of the CSGObject.
+   *
+   * @return the length of the program of the nth CSGObject, or @c 0 if
+   * @p n is out of range.
+   */
+  unsigned int getProgramLength(unsigned int n) const;
+
+
+  /**
+   * Predicate returning @c true if the given point lies inside the nth
+   * compiled CSGObject.
+   *
+   * @param x the x coordinate of the point.
+   * @param y the y coordinate of the point.
+   * @param z the z coordinate of the point.
+   * @param n the index of the CSGObject.
+   *
+   * @return @c true if the point is inside, @c false otherwise or if @p n
+   * is out of range.
+   */
+  bool isInside(double x, double y, double z, unsigned int n) const;
+
+
+  /**
+   * Returns the index of the CSGObject a point belongs to.
+   *
+   * @param x the x coordinate of the point.
+   * @param y the y coordinate of the point.
+   * @param z the z coordinate of the point.
+   *
+   * @return the index of the containing CSGObject with the highest
+   * ordinal, or @c -1 if no object contains the point.
+   */
+  int classify(double x, double y, double z) const;
+
+
+  /**
+   * Tests a batch of points against the nth compiled CSGObject.
+   *
+   * @param coords the coordinates of the points as consecutive (x, y, z)
+   * triples; the array must hold @c 3 * @p numPoints values.
+   * @param numPoints the number of points.
+   * @param n the index of the CSGObject.
+   * @param result an array of @p numPoints values set to @c 1 for points
+   * inside the object and @c 0 otherwise.
+   */
+  void isInsideAll(const double* coords, size_t numPoints, unsigned int n,
+                   unsigned char* result) const;
+
+
+  /**
+   * Classifies a batch of points.
+   *
+   * @param coords the coordinates of the points as consecutive (x, y, z)
+   * triples; the array must hold @c 3 * @p numPoints values.
+   * @param numPoints the number of points.
+   * @param result an array of @p numPoints values set to the index of the
+   * containing CSGObject with the highest ordinal, or @c -1.
+   */
+  void classifyAll(const double* coords, size_t numPoints,
+                   int* result) const;
+
+
+protected:
+
+  /** @cond doxygenLibsbmlInternal */
+
+  enum OpCode
+  {
+    CSG_OP_SPHERE
+  , CSG_OP_CUBE
+  , CSG_OP_CYLINDER
+  , CSG_OP_CONE
+  , CSG_OP_CIRCLE
+  , CSG_OP_SQUARE
+  , CSG_OP_EMPTY
+  , CSG_OP_UNION
+  , CSG_OP_INTERSECTION
+  , CSG_OP_DIFFERENCE
+  };
+
+  struct Instruction
+  {
+    OpCode code;
+    unsigned int operands;   // stack entries consumed by set operations
+    double matrix[12];       // inverse affine map (3x4, row-major)
+  };
+
+  struct Program
+  {
+    std::string domainType;
+    int ordinal;
+    unsigned int maxDepth;
+    std::vector<Instruction> instructions;
+  };
+
+  int compileNode(const CSGNode* node, const double matrix[12],
+                  Program& program);
+
+  void evaluate(const Program& program, const double* coords, size_t count,
+                unsigned char* result) const;
+
+  std::vector<Program> mPrograms;
+  std::vector<unsigned int> mPrecedence;
+
+  /** @endcond */
+};
+
+
+
+LIBSBML_CPP_NAMESPACE_END
+
+#endif /* __cplusplus */
+
+#endif /* !CompiledCSGeometry_H__ */
@@ -0,0 +1,806 @@
+/**
+ * @file ParametricGeometryIndex.cpp
+ * @brief Implementation of the ParametricGeometryIndex class.
+ * @author SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML. Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ * 3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ * Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation. A copy of the license agreement is provided in the
+ * file named "LICENSE.txt" included with this software distribution and also
+ * available online as http://sbml.org/software/libsbml/license.html
+ * ------------------------------------------------------------------------ -->
+ */
+#include <sbml/packages/spatial/common/ParametricGeometryIndex.h>
+#include <sbml/packages/spatial/sbml/ParametricGeometry.h>
+#include <sbml/packages/spatial/sbml/Geometry.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+using namespace std;
+
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+/** @cond doxygenLibsbmlInternal */
+
+/* number of centroid bins used when evaluating the surface area heuristic */
+static const unsigned int SAH_BINS = 16;
+
+static const double HIT_EPSILON = 1e-12;
+
+/* returned for a domain type out of range; constructed when the library is
+ * loaded, rather than on the first query, as queries may come from several
+ * threads */
+static const std::string NO_DOMAIN_TYPE;
+
+static double
+surfaceArea(const double lower[3], const double upper[3])
+{
+  double dx = upper[0] - lower[0];
+  double dy = upper[1] - lower[1];
+  double dz = upper[2] - lower[2];
+  if (dx < 0 || dy < 0 || dz < 0) return 0.0;
+  return 2.0 * (dx * dy + dy * dz + dz * dx);
+}
+
+static void
+emptyBounds(double lower[3], double upper[3])
+{
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    lower[i] = HUGE_VAL;
+    upper[i] = -HUGE_VAL;
+  }
+}
+
+static void
+growBounds(double lower[3], double upper[3],
+           const double otherLower[3], const double otherUpper[3])
+{
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    if (otherLower[i] < lower[i]) lower[i] = otherLower[i];
+    if (otherUpper[i] > upper[i]) upper[i] = otherUpper[i];
+  }
+}
+
+/*
+ * Slab test of a ray against a box; on success the entry distance is
+ * returned in tNear.
+ */
+static bool
+intersectBox(const ParametricGeometryIndex::Node& node,
+             const double origin[3], const double invDir[3],
+             double tMax, double& tNear)
+{
+  double t0 = 0.0;
+  double t1 = tMax;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    double tA = (node.lower[i] - origin[i]) * invDir[i];
+    double tB = (node.upper[i] - origin[i]) * invDir[i];
+    if (tA > tB) std::swap(tA, tB);
+    // NaN arises from 0 * inf when the origin lies on a slab plane;
+    // the comparisons below then leave the interval unchanged.
+    if (tA > t0) t0 = tA;
+    if (tB < t1) t1 = tB;
+    if (t0 > t1) return false;
+  }
+  tNear = t0;
+  return true;
+}
+
+static double
+boxDistanceSquared(const ParametricGeometryIndex::Node& node,
+                   const double p[3])
+{
+  double d2 = 0.0;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    double d = 0.0;
+    if (p[i] < node.lower[i]) d = node.lower[i] - p[i];
+    else if (p[i] > node.upper[i]) d = p[i] - node.upper[i];
+    d2 += d * d;
+  }
+  return d2;
+}
+
+/*
+ * Moeller-Trumbore ray/triangle intersection on the precomputed edges.
+ */
+static bool
+intersectTriangle(const ParametricGeometryIndex::Triangle& tri,
+                  const double origin[3], const double dir[3], double& t)
+{
+  const double* e1 = tri.e1;
+  const double* e2 = tri.e2;
+  double p[3] = { dir[1] * e2[2] - dir[2] * e2[1],
+                  dir[2] * e2[0] - dir[0] * e2[2],
+                  dir[0] * e2[1] - dir[1] * e2[0] };
+  double det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+  if (fabs(det) < HIT_EPSILON) return false;
+  double invDet = 1.0 / det;
+  double s[3] = { origin[0] - tri.v0[0],
+                  origin[1] - tri.v0[1],
+                  origin[2] - tri.v0[2] };
+  double u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * invDet;
+  if (u < 0.0 || u > 1.0) return false;
+  double q[3] = { s[1] * e1[2] - s[2] * e1[1],
+                  s[2] * e1[0] - s[0] * e1[2],
+                  s[0] * e1[1] - s[1] * e1[0] };
+  double v = (dir[0] * q[0] + dir[1] * q[1] + dir[2] * q[2]) * invDet;
+  if (v < 0.0 || u + v > 1.0) return false;
+  t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * invDet;
+  return true;
+}
+
+/*
+ * Closest point on a triangle to p (Ericson, Real-Time Collision Detection,
+ * section 5.1.5).
+ */
+static void
+closestPointOnTriangle(const ParametricGeometryIndex::Triangle& tri,
+                       const double p[3], double result[3])
+{
+  const double* a = tri.v0;
+  const double* ab = tri.e1;
+  const double* ac = tri.e2;
+  double ap[3] = { p[0] - a[0], p[1] - a[1], p[2] - a[2] };
+
+  double d1 = ab[0] * ap[0] + ab[1] * ap[1] + ab[2] * ap[2];
+  double d2 = ac[0] * ap[0] + ac[1] * ap[1] + ac[2] * ap[2];
+  if (d1 <= 0.0 && d2 <= 0.0)
+  {
+    result[0] = a[0]; result[1] = a[1]; result[2] = a[2];
+    return;
+  }
+
+  double bp[3] = { ap[0] - ab[0], ap[1] - ab[1], ap[2] - ab[2] };
+  double d3 = ab[0] * bp[0] + ab[1] * bp[1] + ab[2] * bp[2];
+  double d4 = ac[0] * bp[0] + ac[1] * bp[1] + ac[2] * bp[2];
+  if (d3 >= 0.0 && d4 <= d3)
+  {
+    for (unsigned int i = 0; i < 3; ++i) result[i] = a[i] + ab[i];
+    return;
+  }
+
+  double vc = d1 * d4 - d3 * d2;
+  if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+  {
+    double v = d1 / (d1 - d3);
+    for (unsigned int i = 0; i < 3; ++i) result[i] = a[i] + v * ab[i];
+    return;
+  }
+
+  double cp[3] = { ap[0] - ac[0], ap[1] - ac[1], ap[2] - ac[2] };
+  double d5 = ab[0] * cp[0] + ab[1] * cp[1] + ab[2] * cp[2];
+  double d6 = ac[0] * cp[0] + ac[1] * cp[1] + ac[2] * cp[2];
+  if (d6 >= 0.0 && d5 <= d6)
+  {
+    for (unsigned int i = 0; i < 3; ++i) result[i] = a[i] + ac[i];
+    return;
+  }
+
+  double vb = d5 * d2 - d1 * d6;
+  if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+  {
+    double w = d2 / (d2 - d6);
+    for (unsigned int i = 0; i < 3; ++i) result[i] = a[i] + w * ac[i];
+    return;
+  }
+
+  double va = d3 * d6 - d5 * d4;
+  if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+  {
+    double w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+    for (unsigned int i = 0; i < 3; ++i)
+      result[i] = a[i] + ab[i] + w * (ac[i] - ab[i]);
+    return;
+  }
+
+  double denom = 1.0 / (va + vb + vc);
+  double v = vb * denom;
+  double w = vc * denom;
+  for (unsigned int i = 0; i < 3; ++i)
+    result[i] = a[i] + ab[i] * v + ac[i] * w;
+}
+
+/** @endcond */
+
+
+ParametricGeometryHit::ParametricGeometryHit()
+  : distance(0.0)
+  , x(0.0)
+  , y(0.0)
+  , z(0.0)
+  , objectIndex(0)
+  , polygonIndex(0)
+{
+}
+
+
+ParametricGeometryIndex::ParametricGeometryIndex(unsigned int maxLeafSize)
+  : mMaxLeafSize(maxLeafSize == 0 ? 1 : maxLeafSize)
+  , mNodes()
+  , mTriangles()
+  , mDomainTypes()
+{
+}
+
+
+ParametricGeometryIndex::ParametricGeometryIndex(
+                                         const ParametricGeometry* geometry,
+                                         unsigned int maxLeafSize)
+  : mMaxLeafSize(maxLeafSize == 0 ? 1 : maxLeafSize)
+  , mNodes()
+  , mTriangles()
+  , mDomainTypes()
+{
+  build(geometry);
+}
+
+
+ParametricGeometryIndex::~ParametricGeometryIndex()
+{
+}
+
+
+void
+ParametricGeometryIndex::clear()
+{
+  mNodes.clear();
+  mTriangles.clear();
+  mDomainTypes.clear();
+}
+
+
+int
+ParametricGeometryIndex::build(const ParametricGeometry* geometry)
+{
+  clear();
+
+  if (geometry == NULL || !geometry->isSetSpatialPoints())
+  {
+    return LIBSBML_INVALID_OBJECT;
+  }
+
+  unsigned int dimension = 3;
+  const Geometry* parent = static_cast<const Geometry*>
+    (geometry->getAncestorOfType(SBML_SPATIAL_GEOMETRY, "spatial"));
+  if (parent != NULL && parent->getNumCoordinateComponents() == 2)
+  {
+    dimension = 2;
+  }
+
+  vector<double> coords;
+  geometry->getSpatialPoints()->getArrayData(coords);
+  size_t numPoints = coords.size() / dimension;
+
+  vector<int> indices;
+  for (unsigned int n = 0; n < geometry->getNumParametricObjects(); ++n)
+  {
+    const ParametricObject* po = geometry->getParametricObject(n);
+    mDomainTypes.push_back(po->getDomainType());
+
+    unsigned int numVertices =
+      (po->getPolygonType() == SPATIAL_POLYGONKIND_QUADRILATERAL) ? 4 : 3;
+
+    indices.clear();
+    po->getUncompressed(indices);
+
+    for (size_t i = 0; i + numVertices <= indices.size(); i += numVertices)
+    {
+      for (unsigned int v = 0; v < numVertices; ++v)
+      {
+        if (indices[i + v] < 0 || (size_t)indices[i + v] >= numPoints)
+        {
+          clear();
+          return LIBSBML_INDEX_EXCEEDS_SIZE;
+        }
+      }
+      addPolygon(coords, dimension, &indices[i], numVertices, n,
+                 (unsigned int)(i / numVertices));
+    }
+  }
+
+  if (mTriangles.empty())
+  {
+    return LIBSBML_OPERATION_SUCCESS;
+  }
+
+  vector<BuildItem> items(mTriangles.size());
+  for (size_t i = 0; i < mTriangles.size(); ++i)
+  {
+    const Triangle& tri = mTriangles[i];
+    BuildItem& item = items[i];
+    for (unsigned int k = 0; k < 3; ++k)
+    {
+      double a = tri.v0[k];
+      double b = a + tri.e1[k];
+      double c = a + tri.e2[k];
+      item.lower[k] = std::min(a, std::min(b, c));
+      item.upper[k] = std::max(a, std::max(b, c));
+      item.centroid[k] = (a + b + c) / 3.0;
+    }
+    item.triangle = (unsigned int)i;
+  }
+
+  mNodes.reserve(2 * items.size() / mMaxLeafSize + 1);
+  buildNode(items, 0, items.size());
+
+  // store the triangles in leaf order so each leaf is a contiguous range
+  vector<Triangle> ordered(mTriangles.size());
+  for (size_t i = 0; i < items.size(); ++i)
+  {
+    ordered[i] = mTriangles[items[i].triangle];
+  }
+  mTriangles.swap(ordered);
+
+  return LIBSBML_OPERATION_SUCCESS;
+}
+
+
+unsigned int
+ParametricGeometryIndex::getNumTriangles() const
+{
+  return (unsigned int)mTriangles.size();
+}
+
+
+unsigned int
+ParametricGeometryIndex::getNumNodes() const
+{
+  return (unsigned int)mNodes.size();
+}
+
+
+unsigned int
+ParametricGeometryIndex::getNumObjects() const
+{
+  return (unsigned int)mDomainTypes.size();
+}
+
+
+const std::string&
+ParametricGeometryIndex::getDomainType(unsigned int n) const
+{
+  return (n < mDomainTypes.size()) ? mDomainTypes[n] : NO_DOMAIN_TYPE;
+}
+
+
+bool
+ParametricGeometryIndex::intersectRay(double ox, double oy, double oz,
+                                      double dx, double dy, double dz,
+                                      ParametricGeometryHit& hit,
+                                      double maxDistance) const
+{
+  if (mNodes.empty()) return false;
+
+  const double origin[3] = { ox, oy, oz };
+  const double dir[3] = { dx, dy, dz };
+  const double invDir[3] = { 1.0 / dx, 1.0 / dy, 1.0 / dz };
+
+  double best = maxDistance;
+  const Triangle* bestTriangle = NULL;
+
+  vector<unsigned int> stack;
+  stack.reserve(64);
+  stack.push_back(0);
+
+  while (!stack.empty())
+  {
+    unsigned int index = stack.back();
+    stack.pop_back();
+    const Node& node = mNodes[index];
+
+    double tNear;
+    if (!intersectBox(node, origin, invDir, best, tNear)) continue;
+
+    if (node.count > 0)
+    {
+      for (unsigned int i = node.start; i < node.start + node.count; ++i)
+      {
+        double t;
+        if (intersectTriangle(mTriangles[i], origin, dir, t)
+          && t >= 0.0 && t < best)
+        {
+          best = t;
+          bestTriangle = &mTriangles[i];
+        }
+      }
+    }
+    else if (dir[node.axis] < 0)
+    {
+      // visit the child nearer to the origin first
+      stack.push_back(index + 1);
+      stack.push_back(node.start);
+    }
+    else
+    {
+      stack.push_back(node.start);
+      stack.push_back(index + 1);
+    }
+  }
+
+  if (bestTriangle == NULL) return false;
+
+  hit.distance = best;
+  hit.x = ox + best * dx;
+  hit.y = oy + best * dy;
+  hit.z = oz + best * dz;
+  hit.objectIndex = bestTriangle->objectIndex;
+  hit.polygonIndex = bestTriangle->polygonIndex;
+  return true;
+}
+
+
+bool
+ParametricGeometryIndex::getClosestPoint(double x, double y, double z,
+                                         ParametricGeometryHit& hit) const
+{
+  if (mNodes.empty()) return false;
+
+  const double p[3] = { x, y, z };
+  double best = HUGE_VAL;
+  double bestPoint[3] = { 0.0, 0.0, 0.0 };
+  const Triangle* bestTriangle = NULL;
+
+  vector<unsigned int> stack;
+  stack.reserve(64);
+  stack.push_back(0);
+
+  while (!stack.empty())
+  {
+    unsigned int index = stack.back();
+    stack.pop_back();
+    const Node& node = mNodes[index];
+
+    if (boxDistanceSquared(node, p) >= best) continue;
+
+    if (node.count > 0)
+    {
+      for (unsigned int i = node.start; i < node.start + node.count; ++i)
+      {
+        double q[3];
+        closestPointOnTriangle(mTriangles[i], p, q);
+        double d2 = (q[0] - x) * (q[0] - x) + (q[1] - y) * (q[1] - y)
+                  + (q[2] - z) * (q[2] - z);
+        if (d2 < best)
+        {
+          best = d2;
+          bestPoint[0] = q[0]; bestPoint[1] = q[1]; bestPoint[2] = q[2];
+          bestTriangle = &mTriangles[i];
+        }
+      }
+    }
+    else
+    {
+      // push the further child first so the nearer one is searched first
+      unsigned int first = index + 1;
+      unsigned int second = node.start;
+      if (boxDistanceSquared(mNodes[first], p)
+        < boxDistanceSquared(mNodes[second], p))
+      {
+        std::swap(first, second);
+      }
+      stack.push_back(first);
+      stack.push_back(second);
+    }
+  }
+
+  if (bestTriangle == NULL) return false;
+
+  hit.distance = sqrt(best);
+  hit.x = bestPoint[0];
+  hit.y = bestPoint[1];
+  hit.z = bestPoint[2];
+  hit.objectIndex = bestTriangle->objectIndex;
+  hit.polygonIndex = bestTriangle->polygonIndex;
+  return true;
+}
+
+
+bool
+ParametricGeometryIndex::isInside(double x, double y, double z,
+                                  unsigned int objectIndex) const
+{
+  if (mNodes.empty() || objectIndex >= mDomainTypes.size()) return false;
+
+  // Rays that graze an edge or a vertex may count a crossing twice, so
+  // three rays in unrelated directions take a majority vote.
+  static const double directions[3][3] =
+  {
+    {  0.5773502691896258,  0.5773502691896257,  0.5773502691896259 },
+    { -0.3015113445777636,  0.9045340337332909, -0.3015113445777637 },
+    {  0.2672612419124244, -0.5345224838248488, -0.8017837257372732 }
+  };
+
+  const double origin[3] = { x, y, z };
+  unsigned int votes = 0;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    if (countCrossings(origin, directions[i], objectIndex) % 2 == 1)
+    {
+      ++votes;
+    }
+    if (votes == 2 || (i == 1 && votes == 0)) break;
+  }
+  return votes >= 2;
+}
+
+
+bool
+ParametricGeometryIndex::isInside(double x, double y, double z,
+                                  const std::string& domainType) const
+{
+  for (unsigned int n = 0; n < mDomainTypes.size(); ++n)
+  {
+    if (mDomainTypes[n] == domainType && isInside(x, y, z, n))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+
+void
+ParametricGeometryIndex::addPolygon(const std::vector<double>& coords,
+                                    unsigned int dimension,
+                                    const int* indices,
+                                    unsigned int numVertices,
+                                    unsigned int objectIndex,
+                                    unsigned int polygonIndex)
+{
+  double v[4][3];
+  for (unsigned int i = 0; i < numVertices; ++i)
+  {
+    const double* point = &coords[(size_t)indices[i] * dimension];
+    v[i][0] = point[0];
+    v[i][1] = point[1];
+    v[i][2] = (dimension == 3) ? point[2] : 0.0;
+  }
+
+  // quadrilaterals are split along the 0-2 diagonal
+  for (unsigned int fan = 1; fan + 1 < numVertices; ++fan)
+  {
+    Triangle tri;
+    for (unsigned int k = 0; k < 3; ++k)
+    {
+      tri.v0[k] = v[0][k];
+      tri.e1[k] = v[fan][k] - v[0][k];
+      tri.e2[k] = v[fan + 1][k] - v[0][k];
+    }
+    tri.objectIndex = objectIndex;
+    tri.polygonIndex = polygonIndex;
+    mTriangles.push_back(tri);
+  }
+}
+
+
+unsigned int
+ParametricGeometryIndex::buildNode(std::vector<BuildItem>& items,
+                                   size_t begin, size_t end)
+{
+  unsigned int index = (unsigned int)mNodes.size();
+  mNodes.push_back(Node());
+
+  double lower[3], upper[3], centroidLower[3], centroidUpper[3];
+  emptyBounds(lower, upper);
+  emptyBounds(centroidLower, centroidUpper);
+  for (size_t i = begin; i < end; ++i)
+  {
+    growBounds(lower, upper, items[i].lower, items[i].upper);
+    growBounds(centroidLower, centroidUpper,
+               items[i].centroid, items[i].centroid);
+  }
+
+  for (unsigned int k = 0; k < 3; ++k)
+  {
+    mNodes[index].lower[k] = lower[k];
+    mNodes[index].upper[k] = upper[k];
+  }
+  mNodes[index].axis = 0;
+
+  size_t count = end - begin;
+  size_t middle = end;
+  unsigned int axis = 0;
+  if (count > mMaxLeafSize)
+  {
+    middle = partition(items, begin, end, centroidLower, centroidUpper, axis);
+  }
+
+  if (middle == begin || middle == end)
+  {
+    mNodes[index].start = (unsigned int)begin;
+    mNodes[index].count = (unsigned int)count;
+    return index;
+  }
+
+  // the first child immediately follows its parent; the node vector may
+  // reallocate during recursion, so the parent is re-indexed afterwards
+  buildNode(items, begin, middle);
+  unsigned int second = buildNode(items, middle, end);
+  mNodes[index].start = second;
+  mNodes[index].count = 0;
+  mNodes[index].axis = axis;
+  return index;
+}
+
+
+size_t
+ParametricGeometryIndex::partition(std::vector<BuildItem>& items,
+                                   size_t begin, size_t end,
+                                   const double centroidLower[3],
+                                   const double centroidUpper[3],
+                                   unsigned int& axis) const
+{
+  size_t count = end - begin;
+
+  double bestCost = HUGE_VAL;
+  unsigned int bestAxis = 0;
+  unsigned int bestSplit = 0;
+
+  for (unsigned int k = 0; k < 3; ++k)
+  {
+    double extent = centroidUpper[k] - centroidLower[k];
+    if (!(extent > 0.0)) continue;
+    double scale = SAH_BINS / extent;
+
+    size_t binCount[SAH_BINS];
+    double binLower[SAH_BINS][3], binUpper[SAH_BINS][3];
+    for (unsigned int b = 0; b < SAH_BINS; ++b)
+    {
+      binCount[b] = 0;
+      emptyBounds(binLower[b], binUpper[b]);
+    }
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      unsigned int b = (unsigned int)((items[i].centroid[k] - centroidLower[k])
+                                      * scale);
+      if (b >= SAH_BINS) b = SAH_BINS - 1;
+      ++binCount[b];
+      growBounds(binLower[b], binUpper[b], items[i].lower, items[i].upper);
+    }
+
+    // sweep from the right, recording the cost of each right-hand side
+    double rightArea[SAH_BINS];
+    size_t rightCount[SAH_BINS];
+    double lower[3], upper[3];
+    emptyBounds(lower, upper);
+    size_t running = 0;
+    for (unsigned int b = SAH_BINS - 1; b > 0; --b)
+    {
+      growBounds(lower, upper, binLower[b], binUpper[b]);
+      running += binCount[b];
+      rightArea[b] = surfaceArea(lower, upper);
+      rightCount[b] = running;
+    }
+
+    emptyBounds(lower, upper);
+    running = 0;
+    for (unsigned int b = 0; b + 1 < SAH_BINS; ++b)
+    {
+      growBounds(lower, upper, binLower[b], binUpper[b]);
+      running += binCount[b];
+      if (running == 0 || rightCount[b + 1] == 0) continue;
+      double cost = surfaceArea(lower, upper) * running
+                  + rightArea[b + 1] * rightCount[b + 1];
+      if (cost < bestCost)
+      {
+        bestCost = cost;
+        bestAxis = k;
+        bestSplit = b + 1;
+      }
+    }
+  }
+
+  if (bestCost == HUGE_VAL)
+  {
+    // all centroids coincide: split in the middle of the list
+    axis = 0;
+    return begin + count / 2;
+  }
+
+  double extent = centroidUpper[bestAxis] - centroidLower[bestAxis];
+  double scale = SAH_BINS / extent;
+  size_t middle = begin;
+  for (size_t i = begin; i < end; ++i)
+  {
+    unsigned int b = (unsigned int)((items[i].centroid[bestAxis]
+                                     - centroidLower[bestAxis]) * scale);
+    if (b >= SAH_BINS) b = SAH_BINS - 1;
+    if (b < bestSplit)
+    {
+      std::swap(items[i], items[middle]);
+      ++middle;
+    }
+  }
+
+  axis = bestAxis;
+  return middle;
+}
+
+
+unsigned int
+ParametricGeometryIndex::countCrossings(const double origin[3],
+                                        const double dir[3],
+                                        unsigned int objectIndex) const
+{
+  const double invDir[3] = { 1.0 / dir[0], 1.0 / dir[1], 1.0 / dir[2] };
+  unsigned int crossings = 0;
+
+  vector<unsigned int> stack;
+  stack.reserve(64);
+  stack.push_back(0);
+
+  while (!stack.empty())
+  {
+    unsigned int index = stack.back();
+    stack.pop_back();
+    const Node& node = mNodes[index];
+
+    double tNear;
+    if (!intersectBox(node, origin, invDir, HUGE_VAL, tNear)) continue;
+
+    if (node.count > 0)
+    {
+      for (unsigned int i = node.start; i < node.start + node.count; ++i)
+      {
+        double t;
+        if (mTriangles[i].objectIndex == objectIndex
+          && intersectTriangle(mTriangles[i], origin, dir, t)
+          && t > HIT_EPSILON)
+        {
+          ++crossings;
+        }
+      }
+    }
+    else
+    {
+      stack.push_back(node.start);
+      stack.push_back(index + 1);
+    }
+  }
+
+  return crossings;
+}
+
+/** @endcond */
+
+
+LIBSBML_CPP_NAMESPACE_END
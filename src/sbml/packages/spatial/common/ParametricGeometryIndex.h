@@ -0,0 +1,371 @@
+/**
+ * @file ParametricGeometryIndex.h
+ * @brief Bounding volume hierarchy over the surfaces of a ParametricGeometry.
+ * @author SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML. Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ * 3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ * Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation. A copy of the license agreement is provided in the
+ * file named "LICENSE.txt" included with this software distribution and also
+ * available online as http://sbml.org/software/libsbml/license.html
+ * ------------------------------------------------------------------------ -->
+ *
+ * @class ParametricGeometryIndex
+ * @sbmlbrief{spatial} Spatial search structure for a ParametricGeometry.
+ *
+ * A ParametricGeometry describes the surfaces of its domains as triangles
+ * and quadrilaterals (ParametricObject) indexing into a shared set of
+ * coordinates (SpatialPoints).  The ParametricGeometryIndex reads that
+ * connectivity once, splits quadrilaterals into triangles, and builds a
+ * bounding volume hierarchy over the result, so that ray intersection,
+ * closest-surface and point-in-volume queries take logarithmic rather than
+ * linear time in the number of polygons.
+ *
+ * The hierarchy is built top-down using the surface area heuristic over a
+ * fixed number of centroid bins, and is stored as a single flat array of
+ * nodes in depth-first order (the first child of a node immediately follows
+ * it), with the triangle data reordered to match the leaves.
+ *
+ * The index does not keep a pointer to the ParametricGeometry it was built
+ * from; if the geometry is subsequently modified, build() must be called
+ * again.
+ *
+ * The queries are const and keep no state between calls, so a built index
+ * may answer queries from several threads at once.  build() runs on the
+ * calling thread: each split partitions the triangles of its node in
+ * place, in one array shared by the whole build, and the nodes are
+ * appended to the flat array in the order they are split.
+ *
+ * @note Coordinates are read as (x, y, z) triples.  If the parent Geometry
+ * defines only two coordinate components, the points are read as (x, y)
+ * pairs and placed in the plane z = 0.
+ */
+
+
+#ifndef ParametricGeometryIndex_H__
+#define ParametricGeometryIndex_H__
+
+
+#include <sbml/common/extern.h>
+#include <sbml/packages/spatial/common/spatialfwd.h>
+
+
+#ifdef __cplusplus
+
+
+#include <string>
+#include <vector>
+
+
+LIBSBML_CPP_NAMESPACE_BEGIN
+
+
+/**
+ * @class ParametricGeometryHit
+ * @sbmlbrief{spatial} Result of a query on a ParametricGeometryIndex.
+ *
+ * Describes a point on the surface of a ParametricGeometry: its
+ * coordinates, its distance from the query, the ParametricObject it lies
+ * on and the polygon within that object.
+ */
+class LIBSBML_EXTERN ParametricGeometryHit
+{
+public:
+
+  /**
+   * Creates an empty ParametricGeometryHit.
+   */
+  ParametricGeometryHit();
+
+
+  /**
+   * The distance between the query and the surface point: the ray
+   * parameter for ray queries, the Euclidean distance for closest-point
+   * queries.
+   */
+  double distance;
+
+  /** The x coordinate of the surface point. */
+  double x;
+
+  /** The y coordinate of the surface point. */
+  double y;
+
+  /** The z coordinate of the surface point. */
+  double z;
+
+  /**
+   * The index of the ParametricObject (within the ListOfParametricObjects)
+   * the surface point lies on.
+   */
+  unsigned int objectIndex;
+
+  /**
+   * The index of the polygon within the ParametricObject the surface point
+   * lies on.  For quadrilateral objects this is the index of the
+   * quadrilateral, not of the triangle it was split into.
+   */
+  unsigned int polygonIndex;
+};
+
+
+class LIBSBML_EXTERN ParametricGeometryIndex
+{
+public:
+
+  /**
+   * Creates a new, empty ParametricGeometryIndex.
+   *
+   * @param maxLeafSize the maximum number of triangles stored in a leaf of
+   * the hierarchy.
+   */
+  ParametricGeometryIndex(unsigned int maxLeafSize = 4);
+
+
+  /**
+   * Creates a new ParametricGeometryIndex and builds it from the given
+   * ParametricGeometry.
+   *
+   * @param geometry the ParametricGeometry to index.
+   *
+   * @param maxLeafSize the maximum number of triangles stored in a leaf of
+   * the hierarchy.
+   *
+   * @see build(const ParametricGeometry* geometry)
+   */
+  ParametricGeometryIndex(const ParametricGeometry* geometry,
+                          unsigned int maxLeafSize = 4);
+
+
+  /**
+   * Destructor for ParametricGeometryIndex.
+   */
+  virtual ~ParametricGeometryIndex();
+
+
+  /**
+   * (Re)builds this index from the given ParametricGeometry.
+   *
+   * Every ParametricObject of the geometry contributes its polygons;
+   * objects with compressed point indices are uncompressed on the fly.
+   *
+   * @param geometry the ParametricGeometry to index.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBSBML_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBSBML_INVALID_OBJECT, OperationReturnValues_t}
+   * if @p geometry is @c NULL or has no SpatialPoints.
+   * @li @sbmlconstant{LIBSBML_INDEX_EXCEEDS_SIZE, OperationReturnValues_t}
+   * if a polygon references a point that does not exist.
+   */
+  int build(const ParametricGeometry* geometry);
+
+
+  /**
+   * Removes all content from this index.
+   */
+  void clear();
+
+
+  /**
+   * Returns the number of triangles stored in this index.
+   *
+   * @return the number of triangles, with each quadrilateral counted twice.
+   */
+  unsigned int getNumTriangles() const;
+
+
+  /**
+   * Returns the number of nodes of the hierarchy.
+   *
+   * @return the number of nodes, or @c 0 if the index is empty.
+   */
+  unsigned int getNumNodes() const;
+
+
+  /**
+   * Returns the number of ParametricObject elements that were indexed.
+   *
+   * @return the number of indexed ParametricObject elements.
+   */
+  unsigned int getNumObjects() const;
+
+
+  /**
+   * Returns the domainType of the nth indexed ParametricObject.
+   *
+   * @param n the index of the ParametricObject.
+   *
+   * @return the "domainType" of the nth ParametricObject, or an empty string
+   * if @p n is out of range.
+   */
+  const std::string& getDomainType(unsigned int n) const;
+
+
+  /**
+   * Finds the first intersection of a ray with the indexed surfaces.
+   *
+   * @param ox the x coordinate of the ray origin.
+   * @param oy the y coordinate of the ray origin.
+   * @param oz the z coordinate of the ray origin.
+   * @param dx the x component of the ray direction.
+   * @param dy the y component of the ray direction.
+   * @param dz the z component of the ray direction.
+   * @param hit the ParametricGeometryHit to be filled in; its @c distance
+   * is the ray parameter of the hit, so it is a true distance only when the
+   * direction has unit length.
+   * @param maxDistance intersections further along the ray than this are
+   * ignored.
+   *
+   * @return @c true if the ray intersects any surface, @c false otherwise.
+   */
+  bool intersectRay(double ox, double oy, double oz,
+                    double dx, double dy, double dz,
+                    ParametricGeometryHit& hit,
+                    double maxDistance = 1e300) const;
+
+
+  /**
+   * Finds the point on the indexed surfaces closest to the given point.
+   *
+   * @param x the x coordinate of the query point.
+   * @param y the y coordinate of the query point.
+   * @param z the z coordinate of the query point.
+   * @param hit the ParametricGeometryHit to be filled in.
+   *
+   * @return @c true if the index contains any triangle, @c false otherwise.
+   */
+  bool getClosestPoint(double x, double y, double z,
+                       ParametricGeometryHit& hit) const;
+
+
+  /**
+   * Predicate returning @c true if the given point lies inside the closed
+   * surface described by the nth indexed ParametricObject.
+   *
+   * The test counts the crossings of a ray from the point with the
+   * triangles of that object, so the surface is expected to be closed.
+   *
+   * @param x the x coordinate of the query point.
+   * @param y the y coordinate of the query point.
+   * @param z the z coordinate of the query point.
+   * @param objectIndex the index of the ParametricObject.
+   *
+   * @return @c true if the point is inside the surface, @c false otherwise
+   * or if @p objectIndex is out of range.
+   */
+  bool isInside(double x, double y, double z, unsigned int objectIndex) const;
+
+
+  /**
+   * Predicate returning @c true if the given point lies inside the closed
+   * surface of any indexed ParametricObject with the given domainType.
+   *
+   * @param x the x coordinate of the query point.
+   * @param y the y coordinate of the query point.
+   * @param z the z coordinate of the query point.
+   * @param domainType the "domainType" of the ParametricObject elements.
+   *
+   * @return @c true if the point is inside such a surface, @c false
+   * otherwise.
+   */
+  bool isInside(double x, double y, double z,
+                const std::string& domainType) const;
+
+
+#ifndef SWIG
+
+  /** @cond doxygenLibsbmlInternal */
+
+  struct Node
+  {
+    double lower[3];
+    double upper[3];
+    unsigned int start;    // first triangle (leaf) or second child (inner)
+    unsigned int count;    // number of triangles; 0 for inner nodes
+    unsigned int axis;     // split axis of inner nodes
+  };
+
+  struct Triangle
+  {
+    double v0[3];
+    double e1[3];
+    double e2[3];
+    unsigned int objectIndex;
+    unsigned int polygonIndex;
+  };
+
+  /** @endcond */
+
+#endif /* !SWIG */
+
+protected:
+
+  /** @cond doxygenLibsbmlInternal */
+
+  struct BuildItem
+  {
+    double lower[3];
+    double upper[3];
+    double centroid[3];
+    unsigned int triangle;
+  };
+
+  void addPolygon(const std::vector<double>& coords, unsigned int dimension,
+                  const int* indices, unsigned int numVertices,
+                  unsigned int objectIndex, unsigned int polygonIndex);
+
+  unsigned int buildNode(std::vector<BuildItem>& items, size_t begin,
+                         size_t end);
+
+  size_t partition(std::vector<BuildItem>& items, size_t begin, size_t end,
+                   const double centroidLower[3],
+                   const double centroidUpper[3], unsigned int& axis) const;
+
+  unsigned int countCrossings(const double origin[3], const double dir[3],
+                              unsigned int objectIndex) const;
+
+  unsigned int mMaxLeafSize;
+  std::vector<Node> mNodes;
+  std::vector<Triangle> mTriangles;
+  std::vector<std::string> mDomainTypes;
+
+  /** @endcond */
+};
+
+
+
+LIBSBML_CPP_NAMESPACE_END
+
+#endif /* __cplusplus */
+
+#endif /* !ParametricGeometryIndex_H__ */
@@ -366,6 +366,17 @@ AdjacentDomains::renameSIdRefs(const std::string& oldid,
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+AdjacentDomains::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mDomain1, renames);
+  renameIdRef(mDomain2, renames);
+}
+
+
 /*
  * Returns the XML element name of this AdjacentDomains object.
  */
@@ -286,6 +286,16 @@ AdvectionCoefficient::renameSIdRefs(const std::string& oldid,
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+AdvectionCoefficient::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mVariable, renames);
+}
+
+
 /*
  * Returns the XML element name of this AdvectionCoefficient object.
  */
@@ -550,6 +550,20 @@ AnalyticVolume::renameSIdRefs(const std::string& oldid,
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+AnalyticVolume::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mDomainType, renames);
+  if (isSetMath())
+  {
+    mMath->renameSIdRefs(renames);
+  }
+}
+
+
 /*
  * Returns the XML element name of this AnalyticVolume object.
  */
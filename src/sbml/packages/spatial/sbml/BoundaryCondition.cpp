@@ -422,6 +422,18 @@ BoundaryCondition::renameSIdRefs(const std::string& oldid,
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+BoundaryCondition::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mVariable, renames);
+  renameIdRef(mCoordinateBoundary, renames);
+  renameIdRef(mBoundaryDomainType, renames);
+}
+
+
 /*
  * Returns the XML element name of this BoundaryCondition object.
  */
@@ -599,6 +599,16 @@ CSGObject::renameSIdRefs(const std::string& oldid, const std::string& newid)
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+CSGObject::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mDomainType, renames);
+}
+
+
 /*
  * Returns the XML element name of this CSGObject object.
  */
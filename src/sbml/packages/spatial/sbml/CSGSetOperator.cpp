@@ -662,6 +662,17 @@ CSGSetOperator::renameSIdRefs(const std::string& oldid,
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+CSGSetOperator::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mComplementA, renames);
+  renameIdRef(mComplementB, renames);
+}
+
+
 /*
  * Returns the XML element name of this CSGSetOperator object.
  */
@@ -361,6 +361,16 @@ CompartmentMapping::renameSIdRefs(const std::string& oldid,
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+CompartmentMapping::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mDomainType, renames);
+}
+
+
 /*
  * Returns the XML element name of this CompartmentMapping object.
  */
@@ -628,6 +628,16 @@ CoordinateComponent::renameSIdRefs(const std::string& oldid,
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+CoordinateComponent::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mUnit, renames);
+}
+
+
 /*
  * Returns the XML element name of this CoordinateComponent object.
  */
@@ -466,6 +466,16 @@ DiffusionCoefficient::renameSIdRefs(const std::string& oldid,
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+DiffusionCoefficient::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mVariable, renames);
+}
+
+
 /*
  * Returns the XML element name of this DiffusionCoefficient object.
  */
@@ -427,6 +427,16 @@ Domain::renameSIdRefs(const std::string& oldid, const std::string& newid)
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+Domain::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mDomainType, renames);
+}
+
+
 /*
  * Returns the XML element name of this Domain object.
  */
@@ -262,6 +262,16 @@ OrdinalMapping::renameSIdRefs(const std::string& oldid,
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+OrdinalMapping::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mGeometryDefinition, renames);
+}
+
+
 /*
  * Returns the XML element name of this OrdinalMapping object.
  */
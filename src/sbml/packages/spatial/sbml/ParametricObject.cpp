@@ -742,6 +742,16 @@ ParametricObject::renameSIdRefs(const std::string& oldid,
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+ParametricObject::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mDomainType, renames);
+}
+
+
 /*
  * Returns the XML element name of this ParametricObject object.
  */
@@ -391,6 +391,16 @@ SampledFieldGeometry::renameSIdRefs(const std::string& oldid,
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+SampledFieldGeometry::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mSampledField, renames);
+}
+
+
 /*
  * Returns the XML element name of this SampledFieldGeometry object.
  */
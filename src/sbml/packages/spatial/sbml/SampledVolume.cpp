@@ -481,6 +481,16 @@ SampledVolume::renameSIdRefs(const std::string& oldid,
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+SampledVolume::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mDomainType, renames);
+}
+
+
 /*
  * Returns the XML element name of this SampledVolume object.
  */
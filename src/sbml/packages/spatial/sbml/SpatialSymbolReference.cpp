@@ -202,6 +202,16 @@ SpatialSymbolReference::renameSIdRefs(const std::string& oldid,
 }
 
 
+/*
+ * @copydoc doc_renamesidref_common
+ */
+void
+SpatialSymbolReference::renameSIdRefs(const std::map<std::string, std::string>& renames)
+{
+  renameIdRef(mSpatialRef, renames);
+}
+
+
 /*
  * Returns the XML element name of this SpatialSymbolReference object.
  */
@@ -0,0 +1,354 @@
+/**
+ * @file    TestCompiledCSGeometry.cpp
+ * @brief   CompiledCSGeometry unit tests
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ * 
+ * Copyright (C) 2009-2011 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *  
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA 
+ *  
+ * Copyright (C) 2002-2005 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ * 
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <limits>
+#include <cmath>
+#include <cstdlib>
+
+#include <iostream>
+#include <check.h>
+#include <sbml/common/extern.h>
+#include <sbml/packages/spatial/common/SpatialExtensionTypes.h>
+#include <sbml/packages/spatial/common/CompiledCSGeometry.h>
+#include <string>
+#include <vector>
+
+/** @cond doxygenIgnored */
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+/** @endcond doxygenIgnored */
+
+
+CK_CPPSTART
+
+static CSGeometry* G;
+static SpatialPkgNamespaces* GNS;
+
+void
+CompiledCSGeometryTest_setup (void)
+{
+  GNS = new SpatialPkgNamespaces();
+  G = new CSGeometry(GNS);
+}
+
+
+void
+CompiledCSGeometryTest_teardown (void)
+{
+  delete G;
+  delete GNS;
+}
+
+
+static CSGObject*
+createObject(const string& domainType, int ordinal)
+{
+  CSGObject* object = G->createCSGObject();
+  object->setDomainType(domainType);
+  object->setOrdinal(ordinal);
+  return object;
+}
+
+
+START_TEST (test_CompiledCSGeometry_transformations)
+{
+  // an ellipsoid of half-axes (2, 1, 1) centered at (3, 0, 0)
+  CSGTranslation* translation = createObject("a", 1)->createCSGTranslation();
+  translation->setTranslateX(3);
+  translation->setTranslateY(0);
+  translation->setTranslateZ(0);
+  CSGScale* scale = translation->createCSGScale();
+  scale->setScaleX(2);
+  scale->setScaleY(1);
+  scale->setScaleZ(1);
+  scale->createCSGPrimitive()->setPrimitiveType("sphere");
+
+  // a box of half-lengths (2, 1, 1) turned by 45 degrees around z
+  CSGRotation* rotation = createObject("b", 2)->createCSGRotation();
+  rotation->setRotateX(0);
+  rotation->setRotateY(0);
+  rotation->setRotateZ(1);
+  rotation->setRotateAngleInRadians(atan(1.0));
+  scale = rotation->createCSGScale();
+  scale->setScaleX(2);
+  scale->setScaleY(1);
+  scale->setScaleZ(1);
+  scale->createCSGPrimitive()->setPrimitiveType("cube");
+
+  // a cylinder moved up by 5 through a homogeneous matrix
+  CSGHomogeneousTransformation* matrix =
+    createObject("c", 3)->createCSGHomogeneousTransformation();
+  double components[] = { 1, 0, 0, 0,  0, 1, 0, 0,  0, 0, 1, 5,  0, 0, 0, 1 };
+  matrix->createForwardTransformation()->setComponents(components, 16);
+  matrix->createCSGPrimitive()->setPrimitiveType("cylinder");
+
+  CompiledCSGeometry compiled;
+  fail_unless(compiled.compile(G) == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(compiled.getNumObjects() == 3);
+  fail_unless(compiled.getDomainType(0) == "a");
+  fail_unless(compiled.getDomainType(3) == "");
+  fail_unless(compiled.getProgramLength(0) == 1);
+
+  fail_unless(compiled.isInside(4.9, 0, 0, 0) == true);
+  fail_unless(compiled.isInside(5.1, 0, 0, 0) == false);
+  fail_unless(compiled.isInside(3, 0.9, 0, 0) == true);
+  fail_unless(compiled.isInside(3, 1.1, 0, 0) == false);
+
+  fail_unless(compiled.isInside(1.2, 1.2, 0, 1) == true);
+  fail_unless(compiled.isInside(1.2, -1.2, 0, 1) == false);
+  fail_unless(compiled.isInside(-1.2, -1.2, 0.9, 1) == true);
+
+  fail_unless(compiled.isInside(0, 0, 5.5, 2) == true);
+  fail_unless(compiled.isInside(0.9, 0, 4.1, 2) == true);
+  fail_unless(compiled.isInside(0, 0, 6.5, 2) == false);
+  fail_unless(compiled.isInside(0, 0, 0, 2) == false);
+
+  fail_unless(compiled.isInside(0, 0, 0, 3) == false);
+}
+END_TEST
+
+
+START_TEST (test_CompiledCSGeometry_setOperators)
+{
+  CSGSetOperator* difference = createObject("a", 1)->createCSGSetOperator();
+  difference->setOperationType("difference");
+  CSGPrimitive* sphere = difference->createCSGPrimitive();
+  sphere->setId("sphere");
+  sphere->setPrimitiveType("sphere");
+  CSGPrimitive* cube = difference->createCSGPrimitive();
+  cube->setId("cube");
+  cube->setPrimitiveType("cube");
+  difference->setComplementA("cube");
+  difference->setComplementB("sphere");
+
+  CSGSetOperator* intersection = createObject("b", 2)->createCSGSetOperator();
+  intersection->setOperationType("intersection");
+  intersection->createCSGPrimitive()->setPrimitiveType("cone");
+  CSGSetOperator* unite = intersection->createCSGSetOperator();
+  unite->setOperationType("union");
+  CSGTranslation* translation = unite->createCSGTranslation();
+  translation->setTranslateX(1.5);
+  translation->setTranslateY(0);
+  translation->setTranslateZ(0);
+  translation->createCSGPrimitive()->setPrimitiveType("circle");
+  translation = unite->createCSGTranslation();
+  translation->setTranslateX(-1.5);
+  translation->setTranslateY(0);
+  translation->setTranslateZ(0);
+  translation->createCSGPrimitive()->setPrimitiveType("square");
+
+  CompiledCSGeometry compiled(G);
+  fail_unless(compiled.getNumObjects() == 2);
+  fail_unless(compiled.getProgramLength(0) == 3);
+  fail_unless(compiled.getProgramLength(1) == 5);
+
+  fail_unless(compiled.isInside(0.9, 0.9, 0.9, 0) == true);
+  fail_unless(compiled.isInside(0, 0, 0, 0) == false);
+  fail_unless(compiled.isInside(1.1, 0, 0, 0) == false);
+
+  // cone of radius 0.95 at z = -0.9 and 0.05 at z = 0.9, cut down to
+  // a disk around x = 1.5 and a square around x = -1.5
+  fail_unless(compiled.isInside(0.9, 0, -0.9, 1) == true);
+  fail_unless(compiled.isInside(-0.9, 0, -0.9, 1) == true);
+  fail_unless(compiled.isInside(0, 0, -0.9, 1) == false);
+  fail_unless(compiled.isInside(0.45, 0, 0.05, 1) == false);
+  fail_unless(compiled.isInside(0.55, 0, 0.05, 1) == false);
+  fail_unless(compiled.isInside(0.45, 0, -0.5, 1) == false);
+  fail_unless(compiled.isInside(0.55, 0, -0.5, 1) == true);
+  fail_unless(compiled.isInside(0.2, 0, 0.9, 1) == false);
+  fail_unless(compiled.isInside(0.9, 0, -1.1, 1) == false);
+
+  // with the complements swapped the difference is empty
+  difference->setComplementA("sphere");
+  difference->setComplementB("cube");
+  fail_unless(compiled.compile(G) == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(compiled.isInside(0.9, 0.9, 0.9, 0) == false);
+  fail_unless(compiled.isInside(0, 0, 0, 0) == false);
+}
+END_TEST
+
+
+START_TEST (test_CompiledCSGeometry_classify)
+{
+  CSGScale* scale = createObject("background", 0)->createCSGScale();
+  scale->setScaleX(10);
+  scale->setScaleY(10);
+  scale->setScaleZ(10);
+  scale->createCSGPrimitive()->setPrimitiveType("cube");
+  createObject("cell", 2)->createCSGPrimitive()->setPrimitiveType("sphere");
+  CSGTranslation* translation = createObject("nucleus", 1)->createCSGTranslation();
+  translation->setTranslateX(0.5);
+  translation->setTranslateY(0);
+  translation->setTranslateZ(0);
+  translation->createCSGPrimitive()->setPrimitiveType("sphere");
+
+  CompiledCSGeometry compiled(G);
+
+  fail_unless(compiled.classify(0, 0, 0) == 1);
+  fail_unless(compiled.classify(1.4, 0, 0) == 2);
+  fail_unless(compiled.classify(5, 5, 5) == 0);
+  fail_unless(compiled.classify(20, 0, 0) == -1);
+
+  srand(7);
+  const size_t numPoints = 1000;
+  vector<double> coords(3 * numPoints);
+  for (size_t i = 0; i < coords.size(); ++i)
+  {
+    coords[i] = 24.0 * rand() / RAND_MAX - 12.0;
+  }
+  coords[0] = coords[1] = coords[2] = 0;
+
+  vector<int> classes(numPoints);
+  vector<unsigned char> inside(numPoints);
+  compiled.classifyAll(&coords[0], numPoints, &classes[0]);
+  compiled.isInsideAll(&coords[0], numPoints, 0, &inside[0]);
+
+  fail_unless(classes[0] == 1);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    const double* p = &coords[3 * i];
+    fail_unless(classes[i] == compiled.classify(p[0], p[1], p[2]));
+    fail_unless((inside[i] != 0) == compiled.isInside(p[0], p[1], p[2], 0));
+  }
+}
+END_TEST
+
+
+START_TEST (test_CompiledCSGeometry_deep)
+{
+  // spheres at x = 0, 3, 6, ... joined by nested unions, deep enough that
+  // the evaluation stack of a full block is allocated
+  const int numSpheres = 20;
+  CSGSetOperator* unite = createObject("a", 1)->createCSGSetOperator();
+  unite->setOperationType("union");
+  for (int k = 0; k < numSpheres; ++k)
+  {
+    CSGTranslation* translation = unite->createCSGTranslation();
+    translation->setTranslateX(3.0 * k);
+    translation->setTranslateY(0);
+    translation->setTranslateZ(0);
+    translation->createCSGPrimitive()->setPrimitiveType("sphere");
+    if (k + 1 < numSpheres)
+    {
+      unite = unite->createCSGSetOperator();
+      unite->setOperationType("union");
+    }
+  }
+
+  CompiledCSGeometry compiled(G);
+  fail_unless(compiled.getNumObjects() == 1);
+
+  const size_t numPoints = 600;
+  vector<double> coords(3 * numPoints, 0.0);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    coords[3 * i] = 0.1 * i;
+  }
+
+  vector<unsigned char> inside(numPoints);
+  compiled.isInsideAll(&coords[0], numPoints, 0, &inside[0]);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    double x = coords[3 * i];
+    double nearest = 3.0 * floor(x / 3.0 + 0.5);
+    bool expected = nearest < 3.0 * numSpheres && fabs(x - nearest) <= 1.0;
+    fail_unless((inside[i] != 0) == expected);
+    fail_unless(compiled.isInside(x, 0, 0, 0) == expected);
+  }
+}
+END_TEST
+
+
+START_TEST (test_CompiledCSGeometry_invalid)
+{
+  CompiledCSGeometry compiled;
+  fail_unless(compiled.compile(NULL) == LIBSBML_INVALID_OBJECT);
+
+  CSGObject* object = createObject("a", 1);
+  fail_unless(compiled.compile(G) == LIBSBML_INVALID_OBJECT);
+
+  CSGSetOperator* difference = object->createCSGSetOperator();
+  difference->setOperationType("difference");
+  difference->createCSGPrimitive()->setPrimitiveType("sphere");
+  fail_unless(compiled.compile(G) == LIBSBML_INVALID_OBJECT);
+  fail_unless(compiled.getNumObjects() == 0);
+
+  difference->createCSGPrimitive()->setPrimitiveType("cube");
+  fail_unless(compiled.compile(G) == LIBSBML_OPERATION_SUCCESS);
+
+  difference->setComplementA("nothing");
+  difference->setComplementB("nothing");
+  fail_unless(compiled.compile(G) == LIBSBML_INVALID_OBJECT);
+
+  CSGScale* scale = object->createCSGScale();
+  scale->setScaleX(1);
+  scale->setScaleY(0);
+  scale->setScaleZ(1);
+  scale->createCSGPrimitive()->setPrimitiveType("sphere");
+  fail_unless(compiled.compile(G) == LIBSBML_OPERATION_FAILED);
+}
+END_TEST
+
+
+Suite *
+create_suite_CompiledCSGeometry (void)
+{
+  Suite *suite = suite_create("CompiledCSGeometry");
+  TCase *tcase = tcase_create("CompiledCSGeometry");
+
+  tcase_add_checked_fixture(tcase, CompiledCSGeometryTest_setup,
+                            CompiledCSGeometryTest_teardown);
+
+  tcase_add_test( tcase, test_CompiledCSGeometry_transformations );
+  tcase_add_test( tcase, test_CompiledCSGeometry_setOperators    );
+  tcase_add_test( tcase, test_CompiledCSGeometry_classify        );
+  tcase_add_test( tcase, test_CompiledCSGeometry_deep            );
+  tcase_add_test( tcase, test_CompiledCSGeometry_invalid         );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+CK_CPPEND
@@ -0,0 +1,251 @@
+/**
+ * @file    TestParametricGeometryIndex.cpp
+ * @brief   ParametricGeometryIndex unit tests
+ * @author  SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *     3. University of Heidelberg, Heidelberg, Germany
+ * 
+ * Copyright (C) 2009-2011 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *  
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ *     Pasadena, CA, USA 
+ *  
+ * Copyright (C) 2002-2005 jointly by the following organizations: 
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. Japan Science and Technology Agency, Japan
+ * 
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <limits>
+#include <cmath>
+
+#include <iostream>
+#include <check.h>
+#include <sbml/common/extern.h>
+#include <sbml/packages/spatial/common/SpatialExtensionTypes.h>
+#include <sbml/packages/spatial/common/ParametricGeometryIndex.h>
+#include <string>
+#include <vector>
+
+/** @cond doxygenIgnored */
+
+using namespace std;
+LIBSBML_CPP_NAMESPACE_USE
+
+/** @endcond doxygenIgnored */
+
+
+CK_CPPSTART
+
+static ParametricGeometry* G;
+static SpatialPkgNamespaces* GNS;
+
+/*
+ * The unit cube [0,1]^3, described once as twelve triangles and once as
+ * six quadrilaterals shifted by 2 along the x axis.
+ */
+void
+ParametricGeometryIndexTest_setup (void)
+{
+  GNS = new SpatialPkgNamespaces();
+  G = new ParametricGeometry(GNS);
+
+  double coords[] = { 0, 0, 0,  1, 0, 0,  1, 1, 0,  0, 1, 0,
+                      0, 0, 1,  1, 0, 1,  1, 1, 1,  0, 1, 1,
+                      2, 0, 0,  3, 0, 0,  3, 1, 0,  2, 1, 0,
+                      2, 0, 1,  3, 0, 1,  3, 1, 1,  2, 1, 1 };
+  SpatialPoints* points = G->createSpatialPoints();
+  points->setCompression("uncompressed");
+  points->setArrayData(coords, 48);
+  points->setArrayDataLength(48);
+
+  int triangles[] = { 0, 2, 1,  0, 3, 2,  4, 5, 6,  4, 6, 7,
+                      0, 1, 5,  0, 5, 4,  3, 7, 6,  3, 6, 2,
+                      0, 4, 7,  0, 7, 3,  1, 2, 6,  1, 6, 5 };
+  ParametricObject* po = G->createParametricObject();
+  po->setId("triangles");
+  po->setPolygonType("triangle");
+  po->setDomainType("left");
+  po->setCompression("uncompressed");
+  po->setPointIndex(triangles, 36);
+  po->setPointIndexLength(36);
+
+  int quads[] = { 8, 11, 10, 9,  12, 13, 14, 15,  8, 9, 13, 12,
+                  11, 15, 14, 10,  8, 12, 15, 11,  9, 10, 14, 13 };
+  po = G->createParametricObject();
+  po->setId("quads");
+  po->setPolygonType("quadrilateral");
+  po->setDomainType("right");
+  po->setCompression("uncompressed");
+  po->setPointIndex(quads, 24);
+  po->setPointIndexLength(24);
+}
+
+
+void
+ParametricGeometryIndexTest_teardown (void)
+{
+  delete G;
+  delete GNS;
+}
+
+
+START_TEST (test_ParametricGeometryIndex_build)
+{
+  ParametricGeometryIndex index(1);
+
+  fail_unless(index.getNumTriangles() == 0);
+  fail_unless(index.getNumNodes() == 0);
+  fail_unless(index.build(NULL) == LIBSBML_INVALID_OBJECT);
+
+  fail_unless(index.build(G) == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(index.getNumTriangles() == 24);
+  // one triangle per leaf: 24 leaves and 23 inner nodes
+  fail_unless(index.getNumNodes() == 47);
+  fail_unless(index.getNumObjects() == 2);
+  fail_unless(index.getDomainType(0) == "left");
+  fail_unless(index.getDomainType(1) == "right");
+  fail_unless(index.getDomainType(2) == "");
+
+  index.clear();
+  fail_unless(index.getNumTriangles() == 0);
+  fail_unless(index.getNumNodes() == 0);
+}
+END_TEST
+
+
+START_TEST (test_ParametricGeometryIndex_badIndex)
+{
+  int triangles[] = { 0, 1, 16 };
+  ParametricObject* po = G->createParametricObject();
+  po->setPolygonType("triangle");
+  po->setCompression("uncompressed");
+  po->setPointIndex(triangles, 3);
+
+  ParametricGeometryIndex index;
+  fail_unless(index.build(G) == LIBSBML_INDEX_EXCEEDS_SIZE);
+  fail_unless(index.getNumTriangles() == 0);
+}
+END_TEST
+
+
+START_TEST (test_ParametricGeometryIndex_ray)
+{
+  ParametricGeometryIndex index(G, 2);
+  ParametricGeometryHit hit;
+
+  fail_unless(index.intersectRay(-1, 0.5, 0.5, 1, 0, 0, hit) == true);
+  fail_unless(fabs(hit.distance - 1.0) < 1e-12);
+  fail_unless(fabs(hit.x) < 1e-12);
+  fail_unless(hit.objectIndex == 0);
+  fail_unless(hit.polygonIndex == 8 || hit.polygonIndex == 9);
+
+  // from inside the first cube the ray leaves it before reaching the second
+  fail_unless(index.intersectRay(0.5, 0.5, 0.5, 1, 0, 0, hit) == true);
+  fail_unless(fabs(hit.distance - 0.5) < 1e-12);
+  fail_unless(hit.objectIndex == 0);
+
+  fail_unless(index.intersectRay(1.5, 0.5, 0.5, 1, 0, 0, hit) == true);
+  fail_unless(fabs(hit.x - 2.0) < 1e-12);
+  fail_unless(hit.objectIndex == 1);
+  fail_unless(hit.polygonIndex == 4);
+
+  fail_unless(index.intersectRay(1.5, 0.5, 0.5, 1, 0, 0, hit, 0.25) == false);
+  fail_unless(index.intersectRay(-1, 5, 0.5, 1, 0, 0, hit) == false);
+}
+END_TEST
+
+
+START_TEST (test_ParametricGeometryIndex_closestPoint)
+{
+  ParametricGeometryIndex index(G, 2);
+  ParametricGeometryHit hit;
+
+  fail_unless(index.getClosestPoint(0.5, 0.5, 3, hit) == true);
+  fail_unless(fabs(hit.distance - 2.0) < 1e-12);
+  fail_unless(fabs(hit.z - 1.0) < 1e-12);
+  fail_unless(hit.objectIndex == 0);
+
+  fail_unless(index.getClosestPoint(2.5, 0.5, 0.4, hit) == true);
+  fail_unless(fabs(hit.distance - 0.4) < 1e-12);
+  fail_unless(fabs(hit.z) < 1e-12);
+  fail_unless(hit.objectIndex == 1);
+  fail_unless(hit.polygonIndex == 0);
+
+  fail_unless(index.getClosestPoint(4, 2, 2, hit) == true);
+  fail_unless(fabs(hit.distance - sqrt(3.0)) < 1e-12);
+  fail_unless(fabs(hit.x - 3.0) < 1e-12);
+  fail_unless(fabs(hit.y - 1.0) < 1e-12);
+  fail_unless(fabs(hit.z - 1.0) < 1e-12);
+
+  ParametricGeometryIndex empty;
+  fail_unless(empty.getClosestPoint(0, 0, 0, hit) == false);
+}
+END_TEST
+
+
+START_TEST (test_ParametricGeometryIndex_inside)
+{
+  ParametricGeometryIndex index(G, 2);
+
+  fail_unless(index.isInside(0.5, 0.5, 0.5, 0) == true);
+  fail_unless(index.isInside(0.5, 0.5, 0.5, 1) == false);
+  fail_unless(index.isInside(2.5, 0.5, 0.5, 1) == true);
+  fail_unless(index.isInside(2.5, 0.5, 0.5, 0) == false);
+  fail_unless(index.isInside(0.5, 0.5, 0.5, 2) == false);
+
+  fail_unless(index.isInside(0.5, 0.5, 0.5, "left") == true);
+  fail_unless(index.isInside(0.5, 0.5, 0.5, "right") == false);
+  fail_unless(index.isInside(2.9, 0.1, 0.9, "right") == true);
+  fail_unless(index.isInside(1.5, 0.5, 0.5, "left") == false);
+  fail_unless(index.isInside(1.5, 0.5, 0.5, "right") == false);
+  fail_unless(index.isInside(-0.5, 0.5, 0.5, "left") == false);
+}
+END_TEST
+
+
+Suite *
+create_suite_ParametricGeometryIndex (void)
+{
+  Suite *suite = suite_create("ParametricGeometryIndex");
+  TCase *tcase = tcase_create("ParametricGeometryIndex");
+
+  tcase_add_checked_fixture(tcase, ParametricGeometryIndexTest_setup,
+                            ParametricGeometryIndexTest_teardown);
+
+  tcase_add_test( tcase, test_ParametricGeometryIndex_build        );
+  tcase_add_test( tcase, test_ParametricGeometryIndex_badIndex     );
+  tcase_add_test( tcase, test_ParametricGeometryIndex_ray          );
+  tcase_add_test( tcase, test_ParametricGeometryIndex_closestPoint );
+  tcase_add_test( tcase, test_ParametricGeometryIndex_inside       );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+CK_CPPEND
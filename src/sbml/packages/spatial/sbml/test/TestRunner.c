@@ -60,6 +60,8 @@ LIBSBML_CPP_NAMESPACE_USE
 BEGIN_C_DECLS
 
 Suite *create_suite_ParametricObject (void);
+Suite *create_suite_ParametricGeometryIndex (void);
+Suite *create_suite_CompiledCSGeometry (void);
 Suite *create_suite_SpatialPoints (void);
 Suite *create_suite_SampledField(void);
 Suite *create_suite_TransformationComponent (void);
@@ -105,6 +107,8 @@ main (int argc, char* argv[])
   setTestDataDirectory();
 
   SRunner *runner = srunner_create(create_suite_ParametricObject());
+  srunner_add_suite(runner, create_suite_ParametricGeometryIndex());
+  srunner_add_suite(runner, create_suite_CompiledCSGeometry());
   srunner_add_suite(runner, create_suite_Compression());
   srunner_add_suite(runner, create_suite_SpatialPoints());
   srunner_add_suite(runner, create_suite_SampledField());
@@ -48,54 +48,50 @@
 #include <check.h>
 
 #include <iostream>
+#include <map>
+#include <string>
 
 LIBSBML_CPP_NAMESPACE_USE
 
-BEGIN_C_DECLS
 
-extern char *TestDataDirectory;
+/*
+ * An element of a package that is not part of libSBML, which only
+ * overrides the single identifier variant of renameSIdRefs.
+ */
+class ExternalElement : public SBase
+{
+public:
+  ExternalElement(const std::string& ref)
+    : SBase(3, 1)
+    , mRef(ref)
+  {
+    setElementNamespace("http://www.example.org/external/version1");
+  }
 
+  virtual void renameSIdRefs(const std::string& oldid, const std::string& newid)
+  {
+    SBase::renameSIdRefs(oldid, newid);
+    if (mRef == oldid) mRef = newid;
+  }
 
+  virtual bool accept(SBMLVisitor&) const { return false; }
+  virtual SBase* clone() const { return new ExternalElement(*this); }
 
-START_TEST (test_RenameIDs)
-{
-  SBMLReader        reader;
-  SBMLDocument*     d;
+  std::string mRef;
+};
 
-  std::string filename(TestDataDirectory);
-  filename += "multiple-ids.xml";
 
+BEGIN_C_DECLS
 
-  d = reader.readSBML(filename);
+extern char *TestDataDirectory;
 
-  if (d == NULL || d->getModel() == NULL)
-  {
-    fail("readSBML(\"multiple-ids.xml\") returned a NULL pointer.");
-  }
+
+
+static void
+checkRenamed(SBMLDocument* d)
+{
   SBase* obj;
 
-  //Loop through every element in the model and rename everything.
-  List* allElements = d->getAllElements();
-  for (ListIterator iter = allElements->begin(); iter != allElements->end(); ++iter)
-  {
-    SBase* obj = static_cast<SBase*>(*iter);
-    fail_unless(obj != NULL);
-    obj->renameSIdRefs("comp", "comp_new");
-    obj->renameSIdRefs("C", "C_new");
-    obj->renameSIdRefs("conv", "conv_new");
-    obj->renameSIdRefs("b", "b_new");
-    obj->renameSIdRefs("b2", "b2_new");
-    obj->renameSIdRefs("x", "x_new");
-    obj->renameSIdRefs("y", "y_new"); //The 'y' here in the function definition not actually an SId, so this should have no effect.
-    obj->renameUnitSIdRefs("volume", "volume_new");
-    obj->renameUnitSIdRefs("substance", "substance_new");
-    obj->renameUnitSIdRefs("item", "item_new");
-    obj->renameUnitSIdRefs("second", "second_new");
-    obj->renameUnitSIdRefs("litre", "litre_new");
-    obj->renameUnitSIdRefs("candela", "candela_new");
-    obj->renameUnitSIdRefs("farad", "farad_new");
-    obj->renameUnitSIdRefs("coulomb", "coulomb_new");
-  }
   //Function definition
   obj = d->getElementByMetaId("meta21");
   fail_unless(obj != NULL);
@@ -242,6 +238,47 @@ START_TEST (test_RenameIDs)
   fail_unless(mod->getAreaUnits() == "candela_new");
   fail_unless(mod->getLengthUnits() == "farad_new");
   fail_unless(mod->getExtentUnits() == "coulomb_new");
+}
+
+
+START_TEST (test_RenameIDs)
+{
+  SBMLReader        reader;
+  SBMLDocument*     d;
+
+  std::string filename(TestDataDirectory);
+  filename += "multiple-ids.xml";
+
+
+  d = reader.readSBML(filename);
+
+  if (d == NULL || d->getModel() == NULL)
+  {
+    fail("readSBML(\"multiple-ids.xml\") returned a NULL pointer.");
+  }
+  //Loop through every element in the model and rename everything.
+  List* allElements = d->getAllElements();
+  for (ListIterator iter = allElements->begin(); iter != allElements->end(); ++iter)
+  {
+    SBase* obj = static_cast<SBase*>(*iter);
+    fail_unless(obj != NULL);
+    obj->renameSIdRefs("comp", "comp_new");
+    obj->renameSIdRefs("C", "C_new");
+    obj->renameSIdRefs("conv", "conv_new");
+    obj->renameSIdRefs("b", "b_new");
+    obj->renameSIdRefs("b2", "b2_new");
+    obj->renameSIdRefs("x", "x_new");
+    obj->renameSIdRefs("y", "y_new"); //The 'y' here in the function definition not actually an SId, so this should have no effect.
+    obj->renameUnitSIdRefs("volume", "volume_new");
+    obj->renameUnitSIdRefs("substance", "substance_new");
+    obj->renameUnitSIdRefs("item", "item_new");
+    obj->renameUnitSIdRefs("second", "second_new");
+    obj->renameUnitSIdRefs("litre", "litre_new");
+    obj->renameUnitSIdRefs("candela", "candela_new");
+    obj->renameUnitSIdRefs("farad", "farad_new");
+    obj->renameUnitSIdRefs("coulomb", "coulomb_new");
+  }
+  checkRenamed(d);
 
   delete d;
   delete allElements;
@@ -249,6 +286,138 @@ START_TEST (test_RenameIDs)
 END_TEST
 
 
+START_TEST (test_RenameIDs_bulk)
+{
+  SBMLReader        reader;
+  SBMLDocument*     d;
+
+  std::string filename(TestDataDirectory);
+  filename += "multiple-ids.xml";
+
+  d = reader.readSBML(filename);
+
+  if (d == NULL || d->getModel() == NULL)
+  {
+    fail("readSBML(\"multiple-ids.xml\") returned a NULL pointer.");
+  }
+
+  std::map<std::string, std::string> sids;
+  sids["comp"] = "comp_new";
+  sids["C"]    = "C_new";
+  sids["conv"] = "conv_new";
+  sids["b"]    = "b_new";
+  sids["b2"]   = "b2_new";
+  sids["x"]    = "x_new";
+  sids["y"]    = "y_new";
+
+  std::map<std::string, std::string> unitSIds;
+  unitSIds["volume"]    = "volume_new";
+  unitSIds["substance"] = "substance_new";
+  unitSIds["item"]      = "item_new";
+  unitSIds["second"]    = "second_new";
+  unitSIds["litre"]     = "litre_new";
+  unitSIds["candela"]   = "candela_new";
+  unitSIds["farad"]     = "farad_new";
+  unitSIds["coulomb"]   = "coulomb_new";
+
+  std::map<std::string, std::string> metaIds;
+
+  List* allElements = d->getAllElements();
+  for (ListIterator iter = allElements->begin(); iter != allElements->end(); ++iter)
+  {
+    SBase* obj = static_cast<SBase*>(*iter);
+    fail_unless(obj != NULL);
+    obj->renameIdRefs(sids, unitSIds, metaIds);
+  }
+
+  checkRenamed(d);
+
+  delete d;
+  delete allElements;
+}
+END_TEST
+
+
+START_TEST (test_RenameIDs_bulk_simultaneous)
+{
+  SBMLDocument d(3, 1);
+  Model* m = d.createModel();
+
+  Parameter* p = m->createParameter();
+  p->setId("a");
+  p = m->createParameter();
+  p->setId("b");
+
+  AssignmentRule* ar = m->createAssignmentRule();
+  ar->setVariable("a");
+  ar->setMath(SBML_parseL3Formula("b + 1"));
+
+  std::map<std::string, std::string> sids;
+  sids["a"] = "b";
+  sids["b"] = "c";
+  std::map<std::string, std::string> none;
+
+  ar->renameIdRefs(sids, none, none);
+
+  fail_unless(ar->getVariable() == "b");
+
+  char* formula = SBML_formulaToL3String(ar->getMath());
+  fail_unless(!strcmp(formula, "c + 1"));
+  safe_free(formula);
+
+  /* nothing to rename */
+  sids.clear();
+  sids["z"] = "y";
+  ar->renameIdRefs(sids, none, none);
+  fail_unless(ar->getVariable() == "b");
+}
+END_TEST
+
+
+START_TEST (test_RenameIDs_bulk_local_parameters)
+{
+  SBMLDocument d(3, 1);
+  Model* m = d.createModel();
+
+  Reaction* r = m->createReaction();
+  r->setId("r");
+  KineticLaw* kl = r->createKineticLaw();
+  LocalParameter* lp = kl->createLocalParameter();
+  lp->setId("k");
+  kl->setMath(SBML_parseL3Formula("k * S"));
+
+  std::map<std::string, std::string> sids;
+  sids["k"] = "k_new";
+  sids["S"] = "S_new";
+  std::map<std::string, std::string> none;
+
+  kl->renameIdRefs(sids, none, none);
+
+  /* the local parameter hides the global k */
+  char* formula = SBML_formulaToL3String(kl->getMath());
+  fail_unless(!strcmp(formula, "k * S_new"));
+  safe_free(formula);
+}
+END_TEST
+
+
+START_TEST (test_RenameIDs_bulk_single_id_overrides)
+{
+  ExternalElement first("a");
+  ExternalElement second("b");
+
+  std::map<std::string, std::string> sids;
+  sids["a"] = "b";
+  sids["b"] = "c";
+  std::map<std::string, std::string> none;
+
+  /* renamed through renameSIdRefs(oldid, newid), still simultaneously */
+  first.renameIdRefs(sids, none, none);
+  second.renameIdRefs(sids, none, none);
+  fail_unless(first.mRef == "b");
+  fail_unless(second.mRef == "c");
+}
+END_TEST
 
 
 Suite *
@@ -259,6 +428,10 @@ create_suite_RenameIDs (void)
 
 
   tcase_add_test(tcase, test_RenameIDs);
+  tcase_add_test(tcase, test_RenameIDs_bulk);
+  tcase_add_test(tcase, test_RenameIDs_bulk_simultaneous);
+  tcase_add_test(tcase, test_RenameIDs_bulk_local_parameters);
+  tcase_add_test(tcase, test_RenameIDs_bulk_single_id_overrides);
 
 
   suite_add_tcase(suite, tcase);
@@ -157,6 +157,8 @@ Suite *create_suite_TestReadFromFileL3V2_3          (void);
 Suite *create_suite_TestReadFromFileL3V2_4          (void);
 Suite *create_suite_TestReadFromFileL3V2_5          (void);
 Suite *create_suite_TestReadFromFileL3V2_6          (void);
+Suite *create_suite_SelectiveRead                 (void);
+Suite *create_suite_StreamingRead                (void);
 
 Suite *create_suite_TestConsistencyChecks         (void);
 Suite *create_suite_ParentObject                  (void);
@@ -315,6 +317,8 @@ main (int argc, char* argv[])
   srunner_add_suite( runner, create_suite_TestReadFromFileL3V2_4        () );
   srunner_add_suite( runner, create_suite_TestReadFromFileL3V2_5        () );
   srunner_add_suite( runner, create_suite_TestReadFromFileL3V2_6        () );
+  srunner_add_suite( runner, create_suite_SelectiveRead                 () );
+  srunner_add_suite( runner, create_suite_StreamingRead                () );
   srunner_add_suite( runner, create_suite_TestConsistencyChecks         () );
   srunner_add_suite( runner, create_suite_ParentObject                  () );
   srunner_add_suite( runner, create_suite_AncestorObject                () );
@@ -46,10 +46,13 @@
 
 #include <sbml/SBMLTransforms.h>
 #include <sbml/conversion/ConversionProperties.h>
+#include <sbml/util/IdList.h>
 
 #include <check.h>
 
 #include <iostream>
+#include <sstream>
+#include <vector>
 
 LIBSBML_CPP_NAMESPACE_USE
 
@@ -954,6 +957,98 @@ START_TEST(test_SBMLTransforms_evaluateAST_L2SpeciesReference)
 }
 END_TEST
 
+START_TEST(test_SBMLTransforms_replaceFD_chain)
+{
+  SBMLDocument doc(3, 1);
+  Model* m = doc.createModel();
+  const unsigned int depth = 100;
+
+  /* f0(x, y) = x + 1 and fk(x, y) = 2 * f(k-1)(x, y) - y */
+  for (unsigned int k = 0; k <= depth; ++k)
+  {
+    std::ostringstream id;
+    std::ostringstream formula;
+    id << "f" << k;
+    if (k == 0)
+      formula << "lambda(x, y, x + 1)";
+    else
+      formula << "lambda(x, y, 2 * f" << k - 1 << "(x, y) - y)";
+
+    FunctionDefinition* fd = m->createFunctionDefinition();
+    fd->setId(id.str());
+    ASTNode* math = SBML_parseL3Formula(formula.str().c_str());
+    fd->setMath(math);
+    delete math;
+  }
+
+  std::ostringstream call;
+  call << "f" << depth << "(f" << depth << "(1, 2) - 1, 2) + f1(y, x)";
+  ASTNode* math = SBML_parseL3Formula(call.str().c_str());
+  ASTNode* copy = math->deepCopy();
+
+  SBMLTransforms::replaceFD(math, m->getListOfFunctionDefinitions());
+
+  /* each fk(1, 2) is 2, and the arguments of f1 are not swapped twice */
+  char* formula = SBML_formulaToL3String(math->getChild(1));
+  fail_unless(!strcmp(formula, "2 * (y + 1) - x"));
+  safe_free(formula);
+  fail_unless(SBMLTransforms::evaluateASTNode(math->getChild(0)) == 2);
+
+  /* expanding several at once gives the same */
+  std::vector<ASTNode*> maths;
+  maths.push_back(copy);
+  maths.push_back(NULL);
+  SBMLTransforms::replaceFD(maths, m->getListOfFunctionDefinitions());
+  formula = SBML_formulaToL3String(math);
+  char* other = SBML_formulaToL3String(copy);
+  fail_unless(!strcmp(formula, other));
+  safe_free(formula);
+  safe_free(other);
+
+  delete math;
+  delete copy;
+}
+END_TEST
+
+START_TEST(test_SBMLTransforms_replaceFD_recursive)
+{
+  SBMLDocument doc(3, 1);
+  Model* m = doc.createModel();
+
+  FunctionDefinition* fd = m->createFunctionDefinition();
+  fd->setId("f");
+  ASTNode* math = SBML_parseL3Formula("lambda(x, g(x) + 1)");
+  fd->setMath(math);
+  delete math;
+
+  fd = m->createFunctionDefinition();
+  fd->setId("g");
+  math = SBML_parseL3Formula("lambda(y, y * f(y))");
+  fd->setMath(math);
+  delete math;
+
+  /* the call that would expand f within itself is left in place */
+  math = SBML_parseL3Formula("f(2)");
+  SBMLTransforms::replaceFD(math, m->getListOfFunctionDefinitions());
+
+  char* formula = SBML_formulaToL3String(math);
+  fail_unless(!strcmp(formula, "2 * f(2) + 1"));
+  safe_free(formula);
+  delete math;
+
+  /* and so is a call of an excluded function */
+  IdList excluded("g");
+  math = SBML_parseL3Formula("f(2)");
+  SBMLTransforms::replaceFD(math, m->getListOfFunctionDefinitions(), 
+                            &excluded);
+
+  formula = SBML_formulaToL3String(math);
+  fail_unless(!strcmp(formula, "g(2) + 1"));
+  safe_free(formula);
+  delete math;
+}
+END_TEST
+
 Suite *
 create_suite_SBMLTransforms (void)
 {
@@ -963,6 +1058,8 @@ create_suite_SBMLTransforms (void)
 
   tcase_add_test(tcase, test_SBMLTransforms_expandFD);
   tcase_add_test(tcase, test_SBMLTransforms_replaceFD);
+  tcase_add_test(tcase, test_SBMLTransforms_replaceFD_chain);
+  tcase_add_test(tcase, test_SBMLTransforms_replaceFD_recursive);
   tcase_add_test(tcase, test_SBMLTransforms_evaluateAST);
   tcase_add_test(tcase, test_SBMLTransforms_evaluateCustomAST);
   tcase_add_test(tcase, test_SBMLTransforms_evaluateAST_L2SpeciesReference);
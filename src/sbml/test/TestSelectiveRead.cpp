@@ -0,0 +1,345 @@
+/**
+ * @file TestSelectiveRead.cpp
+ * @brief Tests for reading documents with elements filtered out
+ * @author SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML. Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ * 3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ * Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation. A copy of the license agreement is provided in the
+ * file named "LICENSE.txt" included with this software distribution and also
+ * available online as http://sbml.org/software/libsbml/license.html
+ * ------------------------------------------------------------------------ -->
+ */
+
+#include <sbml/common/common.h>
+
+#include <sbml/SBMLReader.h>
+#include <sbml/SBMLWriter.h>
+#include <sbml/SBMLTypes.h>
+
+#include <string>
+
+#include <check.h>
+
+LIBSBML_CPP_NAMESPACE_USE
+
+BEGIN_C_DECLS
+
+
+extern char *TestDataDirectory;
+
+
+static std::string
+toString (SBMLDocument* doc)
+{
+  char* str = writeSBMLToString(doc);
+  std::string result(str);
+  safe_free(str);
+  return result;
+}
+
+
+static const char* unknownPackage =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<sbml xmlns=\"http://www.sbml.org/sbml/level3/version1/core\" "
+  "xmlns:foo=\"http://www.sbml.org/sbml/level3/version1/foo/version1\" level=\"3\" "
+  "version=\"1\" foo:required=\"false\">\n"
+  "  <model id=\"m\">\n"
+  "    <listOfParameters>\n"
+  "      <parameter id=\"p\" value=\"1\" constant=\"true\"/>\n"
+  "    </listOfParameters>\n"
+  "    <foo:listOfBars>\n"
+  "      <foo:bar foo:id=\"b\"/>\n"
+  "    </foo:listOfBars>\n"
+  "  </model>\n"
+  "</sbml>\n";
+
+
+START_TEST (test_SelectiveRead_options)
+{
+  SBMLReader reader;
+
+  fail_unless(reader.isSkippedType(SBML_REACTION) == false);
+  fail_unless(reader.addSkippedType(SBML_REACTION) 
+    == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(reader.isSkippedType(SBML_REACTION) == true);
+  fail_unless(reader.isSkippedType(SBML_REACTION, "fbc") == false);
+  reader.clearSkippedTypes();
+  fail_unless(reader.isSkippedType(SBML_REACTION) == false);
+
+  fail_unless(reader.addSkippedPackage("") 
+    == LIBSBML_INVALID_ATTRIBUTE_VALUE);
+  fail_unless(reader.addSkippedPackage("http://www.sbml.org/sbml/level3/version1/foo/version1") 
+    == LIBSBML_OPERATION_SUCCESS);
+  fail_unless(reader.isSkippedPackage("http://www.sbml.org/sbml/level3/version1/foo/version1")
+    == true);
+  reader.clearSkippedPackages();
+  fail_unless(reader.isSkippedPackage("http://www.sbml.org/sbml/level3/version1/foo/version1")
+    == false);
+
+  fail_unless(reader.getSkipNotes() == false);
+  fail_unless(reader.getSkipAnnotations() == false);
+  fail_unless(reader.getSkipMath() == false);
+  fail_unless(reader.getPreserveSkippedElements() == false);
+
+  reader.setSkipNotes(true);
+  reader.setSkipAnnotations(true);
+  reader.setSkipMath(true);
+  reader.setPreserveSkippedElements(true);
+
+  fail_unless(reader.getSkipNotes() == true);
+  fail_unless(reader.getSkipAnnotations() == true);
+  fail_unless(reader.getSkipMath() == true);
+  fail_unless(reader.getPreserveSkippedElements() == true);
+}
+END_TEST
+
+
+START_TEST (test_SelectiveRead_skipTypes)
+{
+  std::string filename(TestDataDirectory);
+  filename += "l2v1-branch.xml";
+
+  SBMLReader reader;
+  reader.addSkippedType(SBML_REACTION);
+
+  SBMLDocument* d = reader.readSBML(filename);
+  Model* m = d->getModel();
+
+  fail_unless(d->getNumErrors() == 0);
+  fail_unless(m->getNumCompartments() == 1);
+  fail_unless(m->getNumSpecies() == 4);
+  fail_unless(m->getNumReactions() == 0);
+  fail_unless(m->isSetNotes() == true);
+
+  delete d;
+
+  reader.clearSkippedTypes();
+  reader.addSkippedType(SBML_SPECIES_REFERENCE);
+
+  d = reader.readSBML(filename);
+  m = d->getModel();
+
+  fail_unless(m->getNumSpecies() == 4);
+  fail_unless(m->getNumReactions() == 3);
+  fail_unless(m->getReaction(0)->getNumReactants() == 0);
+  fail_unless(m->getReaction(0)->getNumProducts() == 0);
+  fail_unless(m->getReaction(0)->getKineticLaw()->isSetMath() == true);
+  fail_unless(m->getReaction(0)->getKineticLaw()->getNumParameters() == 1);
+
+  delete d;
+}
+END_TEST
+
+
+START_TEST (test_SelectiveRead_skipNotesAndMath)
+{
+  std::string filename(TestDataDirectory);
+  filename += "l2v1-branch.xml";
+
+  SBMLReader reader;
+  reader.setSkipNotes(true);
+  reader.setSkipMath(true);
+
+  SBMLDocument* d = reader.readSBML(filename);
+  Model* m = d->getModel();
+
+  fail_unless(m->isSetNotes() == false);
+  fail_unless(m->getNumReactions() == 3);
+  fail_unless(m->getReaction(0)->isSetKineticLaw() == true);
+  fail_unless(m->getReaction(0)->getKineticLaw()->isSetMath() == false);
+  fail_unless(m->getReaction(0)->getKineticLaw()->getNumParameters() == 1);
+  fail_unless(m->getReaction(0)->getNumReactants() == 1);
+
+  delete d;
+}
+END_TEST
+
+
+START_TEST (test_SelectiveRead_preserve)
+{
+  std::string filename(TestDataDirectory);
+  filename += "l3v2-all.xml";
+
+  SBMLReader reader;
+  SBMLDocument* original = reader.readSBML(filename);
+
+  reader.addSkippedType(SBML_REACTION);
+  reader.setSkipMath(true);
+  reader.setPreserveSkippedElements(true);
+
+  SBMLDocument* d = reader.readSBML(filename);
+  Model* m = d->getModel();
+
+  fail_unless(m->getNumReactions() == 0);
+  fail_unless(m->getFunctionDefinition(0)->isSetMath() == false);
+
+  // the skipped elements are written back
+  std::string written = toString(d);
+  fail_unless(written == toString(original));
+
+  SBMLDocument* reread = readSBMLFromString(written.c_str());
+  fail_unless(reread->getModel()->getNumReactions() == 1);
+  fail_unless(reread->getModel()->getFunctionDefinition(0)->isSetMath());
+
+  delete reread;
+  delete d;
+  delete original;
+}
+END_TEST
+
+
+/*
+ * Before L3V2 a container may not be empty, so one whose members were all
+ * skipped is written out with the preserved members; skipped math is
+ * written back in its place, before the local parameters.
+ */
+static void
+checkPreserveBeforeL3V2 (const char* name)
+{
+  std::string filename(TestDataDirectory);
+  filename += name;
+
+  SBMLReader reader;
+  SBMLDocument* original = reader.readSBML(filename);
+  unsigned int numReactions = original->getModel()->getNumReactions();
+  fail_unless(numReactions > 0);
+  unsigned int numReactants =
+    original->getModel()->getReaction(0)->getNumReactants();
+  fail_unless(numReactants > 0);
+
+  reader.addSkippedType(SBML_REACTION);
+  reader.setSkipMath(true);
+  reader.setPreserveSkippedElements(true);
+
+  SBMLDocument* d = reader.readSBML(filename);
+  Model* m = d->getModel();
+
+  fail_unless(m->getNumReactions() == 0);
+
+  // preserved elements keep their attributes in the order they were read
+  // in, so compare the documents once the written one is read back
+  std::string written = toString(d);
+  SBMLDocument* reread = readSBMLFromString(written.c_str());
+  fail_unless(toString(reread) == toString(original));
+  fail_unless(reread->getModel()->getNumReactions() == numReactions);
+  fail_unless(reread->getModel()->getReaction(0)->getKineticLaw()
+    ->isSetMath() == true);
+  fail_unless(reread->getNumErrors(LIBSBML_SEV_ERROR) == 0);
+
+  delete reread;
+  delete d;
+
+  reader.clearSkippedTypes();
+  reader.addSkippedType(SBML_SPECIES_REFERENCE);
+
+  d = reader.readSBML(filename);
+  m = d->getModel();
+
+  fail_unless(m->getNumReactions() == numReactions);
+  fail_unless(m->getReaction(0)->getNumReactants() == 0);
+  fail_unless(m->getReaction(0)->getKineticLaw()->isSetMath() == false);
+  fail_unless(m->getReaction(0)->getKineticLaw()->getNumParameters() > 0);
+
+  written = toString(d);
+  reread = readSBMLFromString(written.c_str());
+  fail_unless(toString(reread) == toString(original));
+  fail_unless(reread->getModel()->getReaction(0)->getNumReactants()
+    == numReactants);
+  fail_unless(reread->getNumErrors(LIBSBML_SEV_ERROR) == 0);
+
+  delete reread;
+  delete d;
+  delete original;
+}
+
+
+START_TEST (test_SelectiveRead_preserve_l2)
+{
+  checkPreserveBeforeL3V2("l2v3-all.xml");
+}
+END_TEST
+
+
+START_TEST (test_SelectiveRead_preserve_l3v1)
+{
+  checkPreserveBeforeL3V2("multiple-ids.xml");
+}
+END_TEST
+
+
+START_TEST (test_SelectiveRead_skipPackage)
+{
+  SBMLReader reader;
+
+  SBMLDocument* d = reader.readSBMLFromString(unknownPackage);
+  fail_unless(toString(d).find("foo:bar") != std::string::npos);
+  delete d;
+
+  reader.addSkippedPackage("http://www.sbml.org/sbml/level3/version1/foo/version1");
+
+  d = reader.readSBMLFromString(unknownPackage);
+  fail_unless(d->getModel()->getNumParameters() == 1);
+  fail_unless(toString(d).find("foo:bar") == std::string::npos);
+  delete d;
+
+  reader.setPreserveSkippedElements(true);
+
+  d = reader.readSBMLFromString(unknownPackage);
+  fail_unless(d->getModel()->getNumParameters() == 1);
+  fail_unless(toString(d).find("foo:bar") != std::string::npos);
+  delete d;
+}
+END_TEST
+
+
+Suite *
+create_suite_SelectiveRead (void)
+{ 
+  Suite *suite = suite_create("SelectiveRead");
+  TCase *tcase = tcase_create("SelectiveRead");
+
+  tcase_add_test(tcase, test_SelectiveRead_options         );
+  tcase_add_test(tcase, test_SelectiveRead_skipTypes       );
+  tcase_add_test(tcase, test_SelectiveRead_skipNotesAndMath);
+  tcase_add_test(tcase, test_SelectiveRead_preserve        );
+  tcase_add_test(tcase, test_SelectiveRead_preserve_l2     );
+  tcase_add_test(tcase, test_SelectiveRead_preserve_l3v1   );
+  tcase_add_test(tcase, test_SelectiveRead_skipPackage     );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+END_C_DECLS
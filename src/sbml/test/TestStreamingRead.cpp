@@ -0,0 +1,300 @@
+/**
+ * @file TestStreamingRead.cpp
+ * @brief Tests for reading documents with a streaming visitor
+ * @author SBMLTeam
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libSBML. Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libSBML.
+ *
+ * Copyright (C) 2020 jointly by the following organizations:
+ *     1. California Institute of Technology, Pasadena, CA, USA
+ *     2. University of Heidelberg, Heidelberg, Germany
+ *     3. University College London, London, UK
+ *
+ * Copyright (C) 2019 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2013-2018 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ * 3. University of Heidelberg, Heidelberg, Germany
+ *
+ * Copyright (C) 2009-2013 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. EMBL European Bioinformatics Institute (EMBL-EBI), Hinxton, UK
+ *
+ * Copyright (C) 2006-2008 by the California Institute of Technology,
+ * Pasadena, CA, USA
+ *
+ * Copyright (C) 2002-2005 jointly by the following organizations:
+ * 1. California Institute of Technology, Pasadena, CA, USA
+ * 2. Japan Science and Technology Agency, Japan
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by the
+ * Free Software Foundation. A copy of the license agreement is provided in the
+ * file named "LICENSE.txt" included with this software distribution and also
+ * available online as http://sbml.org/software/libsbml/license.html
+ * ------------------------------------------------------------------------ -->
+ */
+
+#include <sbml/common/common.h>
+
+#include <sbml/SBMLReader.h>
+#include <sbml/SBMLTypes.h>
+#include <sbml/SBMLVisitor.h>
+
+#include <string>
+#include <vector>
+
+#include <check.h>
+
+LIBSBML_CPP_NAMESPACE_USE
+
+
+/*
+ * Records the components handed to it by a streaming read.
+ */
+class StreamRecorder : public SBMLVisitor
+{
+public:
+  StreamRecorder (SBMLReader* reader = NULL, unsigned int stopAfter = 0) :
+      mReader (reader)
+    , mStopAfter (stopAfter)
+    , mNumSpecies (0)
+    , mNumReactions (0)
+    , mNumParameters (0)
+    , mNumSpeciesReferences (0)
+    , mNumDetached (0)
+  {
+  }
+
+  virtual bool visit (const Species& x)
+  {
+    ++mNumSpecies;
+    mIds.push_back(x.getId());
+    check(x);
+    return true;
+  }
+
+  virtual bool visit (const Reaction& x)
+  {
+    ++mNumReactions;
+    mIds.push_back(x.getId());
+    check(x);
+    return true;
+  }
+
+  virtual bool visit (const Parameter& x)
+  {
+    // local parameters of kinetic laws are visited as part of their reaction
+    if (x.getParentSBMLObject()->getParentSBMLObject() != x.getModel())
+    {
+      return true;
+    }
+
+    ++mNumParameters;
+    mIds.push_back(x.getId());
+    check(x);
+    return true;
+  }
+
+  virtual bool visit (const SpeciesReference&)
+  {
+    ++mNumSpeciesReferences;
+    return true;
+  }
+
+  virtual bool visit (const SBase& x)
+  {
+    const SBase* list = x.getParentSBMLObject();
+    if (list != NULL && list->getParentSBMLObject() == x.getModel())
+    {
+      mIds.push_back(x.getIdAttribute());
+    }
+    return true;
+  }
+
+  void check (const SBase& x)
+  {
+    if (x.getModel() == NULL)
+    {
+      ++mNumDetached;
+    }
+
+    if (mReader != NULL && mIds.size() == mStopAfter)
+    {
+      mReader->stopStreaming();
+    }
+  }
+
+  SBMLReader* mReader;
+  unsigned int mStopAfter;
+  unsigned int mNumSpecies;
+  unsigned int mNumReactions;
+  unsigned int mNumParameters;
+  unsigned int mNumSpeciesReferences;
+  unsigned int mNumDetached;
+  std::vector<std::string> mIds;
+};
+
+
+BEGIN_C_DECLS
+
+
+extern char *TestDataDirectory;
+
+
+START_TEST (test_StreamingRead_counts)
+{
+  std::string filename(TestDataDirectory);
+  filename += "l3v2-all.xml";
+
+  SBMLReader reader;
+  SBMLDocument* full = reader.readSBML(filename);
+  Model* m = full->getModel();
+
+  StreamRecorder recorder;
+  SBMLDocument* d = reader.readSBMLStreaming(filename, recorder);
+
+  fail_unless(d->getNumErrors() == full->getNumErrors());
+  fail_unless(d->getModel() != NULL);
+  fail_unless(d->getModel()->getId() == m->getId());
+
+  fail_unless(recorder.mNumSpecies == m->getNumSpecies());
+  fail_unless(recorder.mNumReactions == m->getNumReactions());
+  fail_unless(recorder.mNumParameters == m->getNumParameters());
+  fail_unless(recorder.mNumDetached == 0);
+
+  unsigned int numSpeciesReferences = 0;
+  for (unsigned int i = 0; i < m->getNumReactions(); ++i)
+  {
+    numSpeciesReferences += m->getReaction(i)->getNumReactants()
+                          + m->getReaction(i)->getNumProducts();
+  }
+  fail_unless(recorder.mNumSpeciesReferences == numSpeciesReferences);
+
+  fail_unless(d->getModel()->getNumSpecies() == 0);
+  fail_unless(d->getModel()->getNumReactions() == 0);
+  fail_unless(d->getModel()->getNumParameters() == 0);
+  fail_unless(d->getModel()->getNumCompartments() == 0);
+
+  /* the components arrive in document order */
+  std::vector<std::string> ids;
+  List* all = m->getAllElements();
+  for (ListIterator it = all->begin(); it != all->end(); ++it)
+  {
+    SBase* obj = static_cast<SBase*>(*it);
+    if (obj->getParentSBMLObject() != NULL 
+      && obj->getParentSBMLObject()->getParentSBMLObject() == m)
+    {
+      ids.push_back(obj->getIdAttribute());
+    }
+  }
+  delete all;
+  fail_unless(recorder.mIds == ids);
+
+  delete d;
+  delete full;
+}
+END_TEST
+
+
+START_TEST (test_StreamingRead_stop)
+{
+  std::string filename(TestDataDirectory);
+  filename += "l2v1-branch.xml";
+
+  SBMLReader reader;
+  StreamRecorder recorder(&reader, 2);
+  SBMLDocument* d = reader.readSBMLStreaming(filename, recorder);
+
+  fail_unless(recorder.mIds.size() == 2);
+  fail_unless(recorder.mNumReactions == 0);
+  fail_unless(d->getModel() != NULL);
+  fail_unless(d->getNumErrors() == 0);
+
+  delete d;
+
+  /* the reader can be used again, and stopStreaming() is reset */
+  StreamRecorder all;
+  d = reader.readSBMLStreaming(filename, all);
+  fail_unless(all.mNumReactions == 3);
+  fail_unless(all.mNumSpecies == 4);
+  delete d;
+
+  /* an ordinary read is unaffected */
+  d = reader.readSBML(filename);
+  fail_unless(d->getModel()->getNumReactions() == 3);
+  delete d;
+}
+END_TEST
+
+
+START_TEST (test_StreamingRead_level1)
+{
+  std::string filename(TestDataDirectory);
+  filename += "l1v1-branch.xml";
+
+  SBMLReader reader;
+  StreamRecorder recorder;
+  SBMLDocument* d = reader.readSBMLStreaming(filename, recorder);
+
+  fail_unless(recorder.mNumSpecies == 4);
+  fail_unless(recorder.mNumReactions == 3);
+  fail_unless(d->getNumErrors() == 0);
+
+  delete d;
+}
+END_TEST
+
+
+START_TEST (test_StreamingRead_string)
+{
+  const char* xml =
+    "<sbml xmlns=\"http://www.sbml.org/sbml/level3/version1/core\" "
+    "level=\"3\" version=\"1\">"
+    "  <model id=\"m\">"
+    "    <listOfParameters>"
+    "      <parameter id=\"p1\" value=\"1\" constant=\"true\"/>"
+    "      <parameter id=\"p2\" value=\"2\" constant=\"true\"/>"
+    "    </listOfParameters>"
+    "  </model>"
+    "</sbml>";
+
+  SBMLReader reader;
+  StreamRecorder recorder;
+  SBMLDocument* d = reader.readSBMLFromStringStreaming(xml, recorder);
+
+  fail_unless(recorder.mNumParameters == 2);
+  fail_unless(recorder.mIds.size() == 2);
+  fail_unless(recorder.mIds[0] == "p1");
+  fail_unless(recorder.mIds[1] == "p2");
+  fail_unless(d->getNumErrors() == 0);
+  fail_unless(d->getModel()->getNumParameters() == 0);
+
+  delete d;
+}
+END_TEST
+
+
+Suite *
+create_suite_StreamingRead (void)
+{ 
+  Suite *suite = suite_create("StreamingRead");
+  TCase *tcase = tcase_create("StreamingRead");
+
+  tcase_add_test(tcase, test_StreamingRead_counts );
+  tcase_add_test(tcase, test_StreamingRead_stop   );
+  tcase_add_test(tcase, test_StreamingRead_level1 );
+  tcase_add_test(tcase, test_StreamingRead_string );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+
+END_C_DECLS
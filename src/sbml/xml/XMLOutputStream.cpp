@@ -327,6 +327,17 @@ XMLOutputStream::setAutoIndent (bool indent)
 }
 
 
+/*
+ * Returns whether automatic indentation is turned on for this
+ * XMLOutputStream.
+ */
+bool
+XMLOutputStream::getAutoIndent () const
+{
+  return mDoIndent;
+}
+
+
 /*
  * Writes the given XML start element name to this XMLOutputStream.
  */
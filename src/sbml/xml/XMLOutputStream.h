@@ -318,6 +318,16 @@ public:
   void setAutoIndent (bool indent);
 
 
+  /**
+   * Returns whether automatic indentation is turned on for this
+   * XMLOutputStream.
+   *
+   * @return @c true if automatic indentation is turned on, @c false
+   * otherwise.
+   */
+  bool getAutoIndent () const;
+
+
   /**
    * Writes the given XML start element name to this XMLOutputStream.
    *